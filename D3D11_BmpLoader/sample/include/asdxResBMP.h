@@ -223,6 +223,16 @@ public:
     //---------------------------------------------------------------------------------------------
     bool Load( const wchar_t* filename ) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ǂݍ݂܂.
+    //!
+    //! @param[in]      pBuffer         BMPt@C̃oCił.
+    //! @param[in]      bufferSize      obt@TCYł.
+    //! @retval true    ǂݍ݂ɐ.
+    //! @retval false   ǂݍ݂Ɏs.
+    //---------------------------------------------------------------------------------------------
+    bool LoadFromMemory( const u8* pBuffer, const u32 bufferSize );
+
     //---------------------------------------------------------------------------------------------
     //! @brief      ܂.
     //---------------------------------------------------------------------------------------------
@@ -10,239 +10,300 @@
 #include <asdxResBMP.h>
 #include <asdxLogger.h>
 #include <asdxHash.h>
+#include <asdxPixelKernel.h>
 #include <cstdio>
+#include <cstring>
 #include <cassert>
 #include <new>
 #include <cmath>
+#include <algorithm>
 
 
 namespace /* anonymous */ {
 
 //-------------------------------------------------------------------------------------------------
-//      1-Bit モノクロビットマップを解析します.
+// Constant Values.
 //-------------------------------------------------------------------------------------------------
-void Parse1Bits( FILE* pFile, u8* pColorMap, s32 size, bool isWin, u8* pResult )
+static const u32 BMP_MAX_COLORMAP_ENTRY = 256;     //!< カラーマップの最大エントリー数です.
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BITFIELD_CHANNEL structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BITFIELD_CHANNEL
 {
-    auto pixSize = ( isWin ) ? 4 : 3;
+    u32     Mask;           //!< カラーマスクです.
+    u32     Shift;          //!< マスクの最下位ビット位置です.
+    u32     Drop;           //!< 8bitに収めるために捨てる下位ビット数です.
+    u8      Table[ 256 ];   //!< 8bitへの変換テーブルです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DECODE_CONTEXT structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct DECODE_CONTEXT
+{
+    u32                         Width;          //!< 画像の横幅です.
+    u32                         BitCount;       //!< 1ピクセルあたりのビット数です.
+    u32                         DstBytes;       //!< 出力の1ピクセルあたりのバイト数です.
+    const u32*                  pPalette;       //!< RGBA形式(メモリ順)のカラーマップです.
+    const BITFIELD_CHANNEL*     pChannels;      //!< RGBAのビットフィールドです. nullptrの場合はBGRA固定です.
+    u8*                         pIndices;       //!< インデックス展開用の作業領域(横幅分)です.
+};
 
-    for( auto i=0; i<size; )
-    {
-        auto color = (u8)fgetc( pFile );
-        for( auto j=7; j>=0; --j, ++i )
-        {
-            // 各ビットを見て 0 か 1 を判定する.
-            u8 idx = (u8)(( color & ( 0x1 << j ) ) > 0);
-            auto idxR = ( i * 3 );
-            auto idxC = ( idx * pixSize );
-
-            pResult[ idxR + 2 ] = pColorMap[ idxC + 0 ];
-            pResult[ idxR + 1 ] = pColorMap[ idxC + 1 ];
-            pResult[ idxR + 0 ] = pColorMap[ idxC + 2 ];
-        }
-    }
-}
 
 //-------------------------------------------------------------------------------------------------
-//      4-Bit 16色ビットマップを解析します.
+//      ビットフィールドのチャンネルを設定します.
 //-------------------------------------------------------------------------------------------------
-void Parse4Bits( FILE* pFile, u8* pColorMap, s32 size, bool isWin, u8* pResult )
+void SetupBitField( u32 mask, u8 defaultValue, BITFIELD_CHANNEL& channel )
 {
-    auto pixSize = ( isWin ) ? 4 : 3;
+    channel.Mask  = mask;
+    channel.Shift = 0;
+    channel.Drop  = 0;
 
-    for( auto i=0; i<size; i+=2 )
+    // マスクが無いチャンネルは常に既定値になる.
+    if ( mask == 0 )
     {
-        auto color = (u8)fgetc( pFile );
-        auto idx = ( color >> 4 );
-        auto idxR = ( i * 3 );
-        auto idxC = ( idx * pixSize );
+        memset( channel.Table, defaultValue, sizeof(channel.Table) );
+        return;
+    }
 
-        pResult[ idxR + 2 ] = pColorMap[ idxC + 0 ];
-        pResult[ idxR + 1 ] = pColorMap[ idxC + 1 ];
-        pResult[ idxR + 0 ] = pColorMap[ idxC + 2 ];
+    while( ( ( mask >> channel.Shift ) & 0x1 ) == 0 )
+    { channel.Shift++; }
 
-        idx = ( color & 0x0f );
-        idxC = ( idx * pixSize );
+    u32 bits = 0;
+    while( channel.Shift + bits < 32 && ( ( mask >> ( channel.Shift + bits ) ) & 0x1 ) )
+    { bits++; }
 
-        pResult[ idxR + 5 ] = pColorMap[ idxC + 0 ];
-        pResult[ idxR + 4 ] = pColorMap[ idxC + 1 ];
-        pResult[ idxR + 3 ] = pColorMap[ idxC + 2 ];
+    if ( bits > 8 )
+    {
+        channel.Drop = bits - 8;
+        bits = 8;
     }
+
+    // 5bitや6bitの値を0～255に引き伸ばしておく.
+    auto maxValue = ( 1u << bits ) - 1;
+    for( u32 i=0; i<256; ++i )
+    { channel.Table[ i ] = ( i <= maxValue ) ? u8( ( i * 255 + maxValue / 2 ) / maxValue ) : 255; }
 }
 
 //-------------------------------------------------------------------------------------------------
-//      8-Bit 256色ビットマップを解析します.
+//      ビットフィールド形式のピクセルを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse8Bits( FILE* pFile, u8* pColorMap, s32 size, bool isWin, u8* pResult )
+template<u32 SrcBytes>
+void DecodeBitFields( const u8* pSrc, const BITFIELD_CHANNEL* pChannels, u8* pDst, u32 dstBytes, u32 count )
 {
-    auto pixSize = ( isWin ) ? 4 : 3;
-
-    for( auto i=0; i<size; ++i )
+    for( u32 i=0; i<count; ++i, pSrc+=SrcBytes, pDst+=dstBytes )
     {
-        auto color = (u8)fgetc( pFile );
-        auto idxR = ( i * 3 );
-        auto idxC = ( color * pixSize );
+        u32 pixel = 0;
+        memcpy( &pixel, pSrc, SrcBytes );
 
-        pResult[ idxR + 2 ] = pColorMap[ idxC + 0 ];
-        pResult[ idxR + 1 ] = pColorMap[ idxC + 1 ];
-        pResult[ idxR + 0 ] = pColorMap[ idxC + 2 ];
+        for( u32 c=0; c<dstBytes; ++c )
+        {
+            auto& ch = pChannels[ c ];
+            pDst[ c ] = ch.Table[ ( ( ( pixel & ch.Mask ) >> ch.Shift ) >> ch.Drop ) & 0xff ];
+        }
     }
 }
 
 //-------------------------------------------------------------------------------------------------
-//      24-Bit フルカラービットマップを解析します.
+//      1行分のピクセルを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse24Bits( FILE* pFile, s32 size, u8* pResult )
+void DecodeRow( const DECODE_CONTEXT& context, const u8* pSrc, u8* pDst )
 {
-    for( auto i=0; i<size; ++i )
+    auto width = context.Width;
+
+    switch( context.BitCount )
     {
-        auto idxR = ( i * 3 );
-        pResult[ idxR + 2 ] = (u8)fgetc( pFile );
-        pResult[ idxR + 1 ] = (u8)fgetc( pFile );
-        pResult[ idxR + 0 ] = (u8)fgetc( pFile );
+    case 1:
+        {
+            asdx::UnpackBits1( pSrc, context.pIndices, width );
+            asdx::ExpandPaletteRGB( context.pIndices, context.pPalette, pDst, width );
+        }
+        break;
+
+    case 4:
+        {
+            asdx::UnpackBits4( pSrc, context.pIndices, width );
+            asdx::ExpandPaletteRGB( context.pIndices, context.pPalette, pDst, width );
+        }
+        break;
+
+    case 8:
+        { asdx::ExpandPaletteRGB( pSrc, context.pPalette, pDst, width ); }
+        break;
+
+    case 16:
+        { DecodeBitFields<2>( pSrc, context.pChannels, pDst, context.DstBytes, width ); }
+        break;
+
+    case 24:
+        { asdx::SwizzleBGRToRGB( pSrc, pDst, width ); }
+        break;
+
+    case 32:
+        {
+            if ( context.pChannels == nullptr )
+            { asdx::SwizzleBGRAToRGBA( pSrc, pDst, width ); }
+            else
+            { DecodeBitFields<4>( pSrc, context.pChannels, pDst, context.DstBytes, width ); }
+        }
+        break;
     }
 }
 
 //-------------------------------------------------------------------------------------------------
-//      32-Bit フルカラービットマップを解析します.
+//      非圧縮ピクセルデータを解析します.
 //-------------------------------------------------------------------------------------------------
-void Parse32Bits( FILE* pFile, s32 size, u8* pResult )
+bool ParseRaw
+(
+    const u8*               pSrc,
+    const u8*               pEnd,
+    u32                     height,
+    bool                    topDown,
+    const DECODE_CONTEXT&   context,
+    u8*                     pDst
+)
 {
-    for( auto i=0; i<size; ++i )
+    // 各行は4byte境界に揃えられている.
+    auto srcPitch = size_t( ( context.Width * context.BitCount + 31 ) / 32 ) * 4;
+    auto dstPitch = size_t( context.Width ) * context.DstBytes;
+
+    // 最終行はパディングが省略されていることがあるので，実データ分だけあれば良しとする.
+    auto lastSize = ( size_t( context.Width ) * context.BitCount + 7 ) / 8;
+    if ( pSrc > pEnd || size_t( pEnd - pSrc ) < srcPitch * ( height - 1 ) + lastSize )
+    { return false; }
+
+    // ボトムアップの場合は出力側を逆順に書き込んで，上下反転の処理を省く.
+    for( u32 y=0; y<height; ++y, pSrc+=srcPitch )
     {
-        auto idxR = ( i * 4 );
-        pResult[ idxR + 2 ] = (u8)fgetc( pFile );
-        pResult[ idxR + 1 ] = (u8)fgetc( pFile );
-        pResult[ idxR + 0 ] = (u8)fgetc( pFile );
-        pResult[ idxR + 3 ] = (u8)fgetc( pFile );
+        auto row = ( topDown ) ? y : ( height - 1 - y );
+        DecodeRow( context, pSrc, pDst + dstPitch * row );
     }
+
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-//      8-Bit ランレングス圧縮ビットマップを解析します.
+//      ランレングス圧縮ピクセルデータを解析します.
 //-------------------------------------------------------------------------------------------------
-void Parse8BitsRLE( FILE* pFile, u8* pColorMap, s32 width, s32 height, u8* pResult )
+void ParseRLE
+(
+    const u8*               pSrc,
+    const u8*               pEnd,
+    u32                     height,
+    const DECODE_CONTEXT&   context,
+    u8*                     pDst
+)
 {
-    auto ptr = pResult;
-    auto escape = false;
-    auto size = width * height;
+    auto width    = context.Width;
+    auto isRLE4   = ( context.BitCount == 4 );
+    auto dstPitch = size_t( width ) * 3;
 
-    while( ptr < pResult + size * 3 )
+    u32 x = 0;
+    u32 y = 0;
+
+    // ランレングス圧縮はボトムアップのみなので，行を逆順に書き込む.
+    while( y < height && pEnd - pSrc >= 2 )
     {
-        auto byte1 = (u8)fgetc( pFile );
-        auto byte2 = (u8)fgetc( pFile );
+        auto byte1 = pSrc[ 0 ];
+        auto byte2 = pSrc[ 1 ];
+        pSrc += 2;
+
+        auto pRow  = pDst + dstPitch * ( height - 1 - y );
+        auto space = ( x < width ) ? width - x : 0;
 
         // RLE_COMMAND ?
         if ( byte1 == 0 )
         {
-            if ( byte2 > 2 )
+            if ( byte2 == 0 )
+            {
+                // 行末.
+                x = 0;
+                y++;
+            }
+            else if ( byte2 == 1 )
+            {
+                // 画像の終わり.
+                break;
+            }
+            else if ( byte2 == 2 )
             {
-                for( auto i=0; i<byte2; ++i, ptr+=3 )
+                // 位置移動.
+                if ( pEnd - pSrc < 2 )
+                { break; }
+
+                x += pSrc[ 0 ];
+                y += pSrc[ 1 ];
+                pSrc += 2;
+            }
+            else
+            {
+                // 非圧縮の並び. データは2byte境界に揃えられている.
+                size_t dataSize = ( isRLE4 ) ? ( byte2 + 1 ) / 2 : byte2;
+                size_t padSize  = ( dataSize + 1 ) & ~size_t( 1 );
+                if ( size_t( pEnd - pSrc ) < dataSize )
+                { break; }
+
+                auto count = std::min<u32>( byte2, space );
+                if ( isRLE4 )
                 {
-                    auto color = (u8)fgetc( pFile );
-                    auto idxC = color * 4;
-                    ptr[ 0 ] = pColorMap[ idxC + 2 ];
-                    ptr[ 1 ] = pColorMap[ idxC + 1 ];
-                    ptr[ 2 ] = pColorMap[ idxC + 0 ];
+                    asdx::UnpackBits4( pSrc, context.pIndices, count );
+                    asdx::ExpandPaletteRGB( context.pIndices, context.pPalette, pRow + x * 3, count );
                 }
-
-                if ( byte2 % 2 )
+                else
                 {
-                    auto skip = (u8)fgetc( pFile );
-                    ASDX_UNUSED_VAR( skip );
+                    asdx::ExpandPaletteRGB( pSrc, context.pPalette, pRow + x * 3, count );
                 }
-            }
-            else if ( byte2 == 2 )
-            {
-                auto x = (u8)fgetc( pFile );
-                auto y = (u8)fgetc( pFile );
-                ptr += ( y * width * 3 ) + ( x * 3 );
+
+                x    += byte2;
+                pSrc += std::min<size_t>( padSize, pEnd - pSrc );
             }
         }
         else
         {
-            auto idxC = byte2 * 4;
-
-            for ( auto i=0; i<byte1; ++i, ptr+=3 )
+            auto count = std::min<u32>( byte1, space );
+            if ( isRLE4 )
             {
-                ptr[ 0 ] = pColorMap[ idxC + 2 ];
-                ptr[ 1 ] = pColorMap[ idxC + 1 ];
-                ptr[ 2 ] = pColorMap[ idxC + 0 ];
+                // 上位4bitと下位4bitの色を交互に並べた2ピクセル分をパターンとして埋める.
+                u8 pattern[ 8 ];
+                memcpy( &pattern[ 0 ], &context.pPalette[ byte2 >> 4   ], 4 );
+                memcpy( &pattern[ 3 ], &context.pPalette[ byte2 & 0x0f ], 4 );
+
+                auto ptr = pRow + x * 3;
+                asdx::FillPixels( ptr, pattern, 6, count / 2 );
+                if ( count % 2 )
+                { memcpy( ptr + ( count - 1 ) * 3, pattern, 3 ); }
             }
+            else
+            {
+                asdx::FillPixels( pRow + x * 3, reinterpret_cast<const u8*>( &context.pPalette[ byte2 ] ), 3, count );
+            }
+
+            x += byte1;
         }
     }
 }
 
 //-------------------------------------------------------------------------------------------------
-//      4-Bit ランレングス圧縮ビットマップを解析します.
+//      ガンマ補正を行います.
 //-------------------------------------------------------------------------------------------------
-void Parse4BitsRLE( FILE* pFile, u8* pColorMap, s32 width, s32 height, u8* pResult )
+void DeGamma( u8* pPixels, u32 count, u32 bytePerPixel, u32 gammaR, u32 gammaG, u32 gammaB )
 {
-    auto ptr = pResult;
-    auto byteRead = 0;
-    auto dataByte = 0;
-    u8 color = 0;
-    auto size = width * height;
-
-    while( ptr < pResult + size * 3 )
+    // ピクセル毎に pow() を呼ぶと遅いので，チャンネル毎にテーブルを作っておく.
+    u8 table[ 3 ][ 256 ];
+    const u32 gamma[ 3 ] = { gammaR, gammaG, gammaB };
+    for( auto c=0; c<3; ++c )
     {
-        auto byte1 = (u8)fgetc( pFile );
-        auto byte2 = (u8)fgetc( pFile );
-        byteRead += 2;
-
-        if ( byte1 == 0 )
-        {
-            dataByte = 0;
-            if ( byte2 > 2 )
-            {
-                for( auto i=0; i<byte2; ++i, ptr+=3 )
-                {
-                    if ( i % 2 )
-                    {
-                        color = ( dataByte & 0x0f );
-                    }
-                    else
-                    {
-                        dataByte = (u8)fgetc( pFile );
-                        byteRead++;
-                        color = (dataByte >> 4);
-                    }
-
-                    auto idxC = color * 4;
-                    ptr[ 0 ] = pColorMap[ idxC + 2 ];
-                    ptr[ 1 ] = pColorMap[ idxC + 1 ];
-                    ptr[ 2 ] = pColorMap[ idxC + 0 ];
-                }
-
-                if ( byteRead % 2 )
-                {
-                    auto skip = (u8)fgetc( pFile );
-                    ASDX_UNUSED_VAR( skip );
-                    byteRead++;
-                }
-            }
-            else if ( byte2 == 2 )
-            {
-                 auto x = (u8)fgetc( pFile );
-                 auto y = (u8)fgetc( pFile );
-
-                 ptr += ( y * height * 3 ) + ( x * 3 );
-            }
-        }
-        else
-        {
-            for( auto i=0; i<byte1; ++i, ptr+=3 )
-            {
-                if ( i % 2 )
-                { color = ( byte2 & 0x0f ); }
-                else
-                { color = ( byte2 >> 4 ); }
+        for( auto i=0; i<256; ++i )
+        { table[ c ][ i ] = u8( pow( f64( i ) / 255.0, 1.0 / gamma[ c ] ) * 255.0 ); }
+    }
 
-                auto idxC = color * 4;
-                ptr[ 0 ] = pColorMap[ idxC + 2 ];
-                ptr[ 1 ] = pColorMap[ idxC + 1 ];
-                ptr[ 2 ] = pColorMap[ idxC + 0 ];
-            }
-        }
+    for( u32 i=0; i<count; ++i, pPixels+=bytePerPixel )
+    {
+        pPixels[ 0 ] = table[ 0 ][ pPixels[ 0 ] ];
+        pPixels[ 1 ] = table[ 1 ][ pPixels[ 1 ] ];
+        pPixels[ 2 ] = table[ 2 ][ pPixels[ 2 ] ];
     }
 }
 
@@ -275,7 +336,7 @@ ResBMP::ResBMP( const ResBMP& value )
 , m_pPixels ( nullptr )
 , m_HashKey ( value.m_HashKey )
 {
-    auto size = m_Width * m_Height * ( ( m_Format == Format_RGB ) ? 3 : 4 );
+    auto size = m_Width * m_Height * ( ( m_Format == Format_RGB || m_Format == Format_RGB_SRGB ) ? 3 : 4 );
     m_pPixels = new (std::nothrow) u8 [ size ];
     assert( m_pPixels != nullptr );
 
@@ -312,206 +373,314 @@ bool ResBMP::Load( const wchar_t* filename )
         return false;
     }
 
+    // ファイルサイズを取得.
+    fseek( pFile, 0, SEEK_END );
+    auto fileSize = ftell( pFile );
+    fseek( pFile, 0, SEEK_SET );
+
+    if ( fileSize <= 0 )
+    {
+        ELOG( "Error : Invalid File Size. filename = %s", filename );
+        fclose( pFile );
+        return false;
+    }
+
+    // 1byteずつ読むと遅いので，ファイル全体をまとめて読み込む.
+    auto pBuffer = new (std::nothrow) u8 [ fileSize ];
+    if ( pBuffer == nullptr )
+    {
+        ELOG( "Error : Out of Memory." );
+        fclose( pFile );
+        return false;
+    }
+
+    auto readSize = fread( pBuffer, sizeof(u8), fileSize, pFile );
+
+    fclose( pFile );
+
+    if ( readSize != size_t( fileSize ) )
+    {
+        ELOG( "Error : File Read Failed. filename = %s", filename );
+        ASDX_DELETE_ARRAY( pBuffer );
+        return false;
+    }
+
+    auto ret = LoadFromMemory( pBuffer, u32( fileSize ) );
+
+    ASDX_DELETE_ARRAY( pBuffer );
+
+    if ( !ret )
+    { return false; }
+
+    // ハッシュキーはファイル名から作成する.
+    m_HashKey = CRC32( filename ).GetHash();
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリから読み込みを行います.
+//-------------------------------------------------------------------------------------------------
+bool ResBMP::LoadFromMemory( const u8* pBuffer, const u32 bufferSize )
+{
+    if ( pBuffer == nullptr || bufferSize < sizeof(BMP_FILE_HEADER) + sizeof(u32) )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    // 既存のデータは破棄しておく.
+    Release();
+
+    const u8* pEnd = pBuffer + bufferSize;
+
     BMP_FILE_HEADER fh;
-    fread( &fh, sizeof(fh), 1, pFile );
+    memcpy( &fh, pBuffer, sizeof(fh) );
 
     if ( fh.Type != 'MB' )
     {
         ELOG( "Error : Invalid File." );
-        fclose( pFile );
         return false;
     }
 
-    auto currPos = ftell( pFile );
+    const u8* pSrc = pBuffer + sizeof(fh);
+
+    u32 headerSize;
+    memcpy( &headerSize, pSrc, sizeof(headerSize) );
 
-    BMP_INFO_HEADER ih;
-    fread( &ih, sizeof(ih), 1, pFile );
+    if ( size_t( pEnd - pSrc ) < headerSize )
+    {
+        ELOG( "Error : Invalid File." );
+        return false;
+    }
 
-    bool isWin = ( ih.Size != 12 );
-    bool isSRGB = false;
-    bool isDeGamma = false;
-    auto bitPerCount = 0;
-    u32 compression;
-    u32 gammaR = 0;
-    u32 gammaG = 0;
-    u32 gammaB = 0;
+    bool isWin       = ( headerSize != sizeof(BMP_CORE_HEADER) );
+    bool isSRGB      = false;
+    bool isDeGamma   = false;
+    s32  width       = 0;
+    s32  height      = 0;
+    u32  bitPerCount = 0;
+    u32  compression = BMP_COMPRESSION_RGB;
+    u32  colorCount  = 0;
+    u32  maskR       = 0;
+    u32  maskG       = 0;
+    u32  maskB       = 0;
+    u32  maskA       = 0;
+    u32  gammaR      = 0;
+    u32  gammaG      = 0;
+    u32  gammaB      = 0;
 
     if ( isWin )
     {
-        if ( ih.Size != 40 )
+        if ( headerSize < sizeof(BMP_INFO_HEADER) )
         {
-            if ( ih.Size == 108 )
-            {
-                BMP_HEADER_V4 header;
-                fseek( pFile, currPos, SEEK_SET );
-                fread( &header, sizeof(header), 1, pFile );
-
-                m_Width     = header.Width;
-                m_Height    = header.Height;
-                bitPerCount = header.BitCount;
-                compression = header.Compression;
-                isSRGB      = ( header.ColorSpaceType == BMP_COLOR_SPACE_SRGB || header.ColorSpaceType == BMP_COLOR_SPACE_WIN_COLOR_SPACE );
-                isDeGamma   = ( header.ColorSpaceType == BMP_COLOR_SPACE_CALIBRATED_RGB ) && ( header.GammaR > 0 && header.GammaG > 0 && header.GammaB > 0 );
-                gammaR      = header.GammaR;
-                gammaG      = header.GammaG;
-                gammaB      = header.GammaB;
-            }
-            else if ( ih.Size == 124 )
+            ELOG( "Error : Invalid Header Size. size = %u", headerSize );
+            return false;
+        }
+
+        // V4, V5 ヘッダは先頭がINFOヘッダと同じ並びなので，足りない部分をゼロにして読む.
+        BMP_HEADER_V5 header = {};
+        memcpy( &header, pSrc, std::min<size_t>( headerSize, sizeof(header) ) );
+
+        width       = header.Width;
+        height      = header.Height;
+        bitPerCount = header.BitCount;
+        compression = header.Compression;
+        colorCount  = header.ClrUsed;
+
+        if ( headerSize >= sizeof(BMP_HEADER_V4) )
+        {
+            isSRGB    = ( header.ColorSpaceType == BMP_COLOR_SPACE_SRGB || header.ColorSpaceType == BMP_COLOR_SPACE_WIN_COLOR_SPACE );
+            isDeGamma = ( header.ColorSpaceType == BMP_COLOR_SPACE_CALIBRATED_RGB ) && ( header.GammaR > 0 && header.GammaG > 0 && header.GammaB > 0 );
+            gammaR    = header.GammaR;
+            gammaG    = header.GammaG;
+            gammaB    = header.GammaB;
+        }
+
+        pSrc += headerSize;
+
+        if ( compression == BMP_COMPRESSION_BITFIELDS )
+        {
+            // INFOヘッダの場合はヘッダの直後にRGBのマスクが並ぶ.
+            if ( headerSize == sizeof(BMP_INFO_HEADER) )
             {
-                BMP_HEADER_V5 header;
-                fseek( pFile, currPos, SEEK_SET );
-                fread( &header, sizeof(header), 1, pFile );
-
-                m_Width     = header.Width;
-                m_Height    = header.Height;
-                bitPerCount = header.BitCount;
-                compression = header.Compression;
-                isSRGB      = ( header.ColorSpaceType == BMP_COLOR_SPACE_SRGB || header.ColorSpaceType == BMP_COLOR_SPACE_WIN_COLOR_SPACE );
-                isDeGamma   = ( header.ColorSpaceType == BMP_COLOR_SPACE_CALIBRATED_RGB ) && ( header.GammaR > 0 && header.GammaG > 0 && header.GammaB > 0 );
-                gammaR      = header.GammaR;
-                gammaG      = header.GammaG;
-                gammaB      = header.GammaB;
+                if ( pEnd - pSrc < 12 )
+                {
+                    ELOG( "Error : Invalid File." );
+                    return false;
+                }
+
+                memcpy( &header.MaskR, pSrc, 12 );
+                pSrc += 12;
             }
+
+            maskR = header.MaskR;
+            maskG = header.MaskG;
+            maskB = header.MaskB;
+            maskA = header.MaskA;
         }
-        else
+        else if ( compression == BMP_COMPRESSION_RGB && bitPerCount == 16 )
         {
-            m_Width     = ih.Width;
-            m_Height    = ih.Height;
-            bitPerCount = ih.BitCount;
-            compression = ih.Compression;
+            // 16bit の無圧縮は X1R5G5B5 固定.
+            maskR = 0x7c00;
+            maskG = 0x03e0;
+            maskB = 0x001f;
         }
     }
     else
     {
-        fseek( pFile, sizeof(fh), SEEK_SET );
-
         BMP_CORE_HEADER ch;
-        fread( &ch, sizeof(ch), 1, pFile );
-        m_Width     = ch.Width;
-        m_Height    = ch.Height;
+        memcpy( &ch, pSrc, sizeof(ch) );
+        pSrc += sizeof(ch);
+
+        width       = ch.Width;
+        height      = ch.Height;
         bitPerCount = ch.BitCount;
-        compression = 0;
     }
 
-    auto colorMapSize = 0;
-    u8* pColorMap = nullptr;
+    // 対応している組み合わせかチェック.
+    bool isValid = false;
+    switch( compression )
+    {
+    case BMP_COMPRESSION_RGB:
+        { isValid = ( bitPerCount == 1 || bitPerCount == 4 || bitPerCount == 8 || bitPerCount == 16 || bitPerCount == 24 || bitPerCount == 32 ); }
+        break;
+
+    case BMP_COMPRESSION_RLE8:
+        { isValid = ( bitPerCount == 8 ) && ( height > 0 ); }
+        break;
+
+    case BMP_COMPRESSION_RLE4:
+        { isValid = ( bitPerCount == 4 ) && ( height > 0 ); }
+        break;
+
+    case BMP_COMPRESSION_BITFIELDS:
+        { isValid = ( bitPerCount == 16 || bitPerCount == 32 ); }
+        break;
+    }
+
+    if ( !isValid || width <= 0 || height == 0 )
+    {
+        ELOG( "Error : Unsupported Format. compression = %u, bitCount = %u", compression, bitPerCount );
+        return false;
+    }
+
+    // 高さが負の場合はトップダウン.
+    bool topDown = ( height < 0 );
+    m_Width  = u32( width );
+    m_Height = ( topDown ) ? u32( -height ) : u32( height );
+
+    // カラーマップをRGBA形式のテーブルにしておく.
+    u32 palette[ BMP_MAX_COLORMAP_ENTRY ] = {};
     if ( bitPerCount <= 8 )
     {
-        colorMapSize = ( 1 << bitPerCount ) * ( isWin ? 4 : 3 );
-        pColorMap = new (std::nothrow) u8 [ colorMapSize ];
-        assert( pColorMap != nullptr );
+        auto maxCount = 1u << bitPerCount;
+        if ( colorCount == 0 || colorCount > maxCount )
+        { colorCount = maxCount; }
 
-        if ( pColorMap == nullptr )
+        size_t entrySize = ( isWin ) ? 4 : 3;
+        if ( size_t( pEnd - pSrc ) < colorCount * entrySize )
         {
-            ELOG( "Error : Out of Memory." );
-            fclose( pFile );
-            Release();
+            ELOG( "Error : Invalid File." );
             return false;
         }
 
-        fread( pColorMap, sizeof(u8), colorMapSize, pFile );
+        for( u32 i=0; i<colorCount; ++i, pSrc+=entrySize )
+        {
+            u8 rgba[ 4 ] = { pSrc[ 2 ], pSrc[ 1 ], pSrc[ 0 ], 255 };
+            memcpy( &palette[ i ], rgba, sizeof(rgba) );
+        }
     }
 
-    auto size = m_Width * m_Height;
-    if ( bitPerCount == 32 )
+    // ビットフィールドを設定.
+    BITFIELD_CHANNEL channels[ 4 ];
+    bool useChannels = ( bitPerCount == 16 ) || ( compression == BMP_COMPRESSION_BITFIELDS );
+    if ( bitPerCount == 32 && maskR == 0x00ff0000 && maskG == 0x0000ff00 && maskB == 0x000000ff && maskA == 0xff000000 )
     {
-        m_Format = ( isSRGB ) ? Format_RGBA_SRGB : Format_RGBA;
-        m_pPixels = new (std::nothrow) u8 [ size * 4 ];
-        memset( m_pPixels, 0, sizeof(u8) * size * 4 );
+        // BGRA並びはスウィズルで済ませる.
+        useChannels = false;
     }
-    else
+
+    if ( useChannels )
     {
-        m_Format  = ( isSRGB ) ? Format_RGB_SRGB : Format_RGB;
-        m_pPixels = new (std::nothrow) u8 [ size * 3 ];
-        memset( m_pPixels, 0, sizeof(u8) * size * 3 );
+        SetupBitField( maskR, 0,   channels[ 0 ] );
+        SetupBitField( maskG, 0,   channels[ 1 ] );
+        SetupBitField( maskB, 0,   channels[ 2 ] );
+        SetupBitField( maskA, 255, channels[ 3 ] );
     }
 
+    bool hasAlpha = ( bitPerCount == 32 ) || ( bitPerCount == 16 && maskA != 0 );
+    u32  dstBytes = ( hasAlpha ) ? 4 : 3;
+
+    if ( fh.OffBits >= bufferSize )
+    {
+        ELOG( "Error : Invalid File." );
+        Release();
+        return false;
+    }
+
+    auto size = size_t( m_Width ) * m_Height * dstBytes;
+    m_pPixels = new (std::nothrow) u8 [ size ];
     assert( m_pPixels != nullptr );
-    if ( m_pPixels == nullptr )
+
+    // インデックス展開用の作業領域.
+    u8* pIndices = nullptr;
+    if ( bitPerCount <= 4 )
+    { pIndices = new (std::nothrow) u8 [ m_Width ]; }
+
+    if ( m_pPixels == nullptr || ( bitPerCount <= 4 && pIndices == nullptr ) )
     {
         ELOG( "Error : Out of Memory." );
-        ASDX_DELETE_ARRAY( pColorMap );
-        fclose( pFile );
+        ASDX_DELETE_ARRAY( pIndices );
         Release();
         return false;
     }
 
-    m_HashKey = CRC32( filename ).GetHash();
+    m_Format = ( hasAlpha ) ? ( ( isSRGB ) ? Format_RGBA_SRGB : Format_RGBA )
+                            : ( ( isSRGB ) ? Format_RGB_SRGB  : Format_RGB  );
+
+    DECODE_CONTEXT context;
+    context.Width     = m_Width;
+    context.BitCount  = bitPerCount;
+    context.DstBytes  = dstBytes;
+    context.pPalette  = palette;
+    context.pChannels = ( useChannels ) ? channels : nullptr;
+    context.pIndices  = pIndices;
 
-    fseek( pFile, fh.OffBits, SEEK_SET );
+    pSrc = pBuffer + fh.OffBits;
 
+    bool ret = true;
     switch( compression )
     {
     case BMP_COMPRESSION_RGB:
-        {
-            switch( bitPerCount )
-            {
-                case 1:  { Parse1Bits( pFile, pColorMap, size, isWin, m_pPixels ); }  break;
-                case 4:  { Parse4Bits( pFile, pColorMap, size, isWin, m_pPixels ); }  break;
-                case 8:  { Parse8Bits( pFile, pColorMap, size, isWin, m_pPixels ); }  break;
-                case 24: { Parse24Bits( pFile, size, m_pPixels ); } break;
-                case 32: { Parse32Bits( pFile, size, m_pPixels ); } break;
-            }
-        }
+    case BMP_COMPRESSION_BITFIELDS:
+        { ret = ParseRaw( pSrc, pEnd, m_Height, topDown, context, m_pPixels ); }
         break;
 
     case BMP_COMPRESSION_RLE8:
-        { Parse8BitsRLE( pFile, pColorMap, m_Width, m_Height, m_pPixels ); }
-        break;
-
     case BMP_COMPRESSION_RLE4:
-        { Parse4BitsRLE( pFile, pColorMap, m_Width, m_Height, m_pPixels ); }
-        break;
-
-    case BMP_COMPRESSION_BITFIELDS:
-        { /* DO_NOTHING */ }
-        break;
-
-    default:
-        { assert( false ); }
+        {
+            // 位置移動で飛ばされたピクセルは黒のままにする.
+            memset( m_pPixels, 0, size );
+            ParseRLE( pSrc, pEnd, m_Height, context, m_pPixels );
+        }
         break;
     }
 
-    ASDX_DELETE_ARRAY( pColorMap );
+    ASDX_DELETE_ARRAY( pIndices );
 
-    fclose( pFile );
+    if ( !ret )
+    {
+        ELOG( "Error : Unexpected End Of Data." );
+        Release();
+        return false;
+    }
 
     // ガンマ補正
     if ( isDeGamma )
-    {
-        if ( bitPerCount == 32 )
-        {
-            for( u32 i=0; i<m_Width * m_Height; ++i )
-            {
-                auto r = f64( m_pPixels[ i * 4 + 0 ] ) / 255.0;
-                auto g = f64( m_pPixels[ i * 4 + 1 ] ) / 255.0;
-                auto b = f64( m_pPixels[ i * 4 + 2 ] ) / 255.0;
-                r = pow( r, 1.0 / gammaR );
-                g = pow( g, 1.0 / gammaG );
-                b = pow( b, 1.0 / gammaB );
-
-                m_pPixels[ i * 4 + 0 ] = (u32)( r * 255.0 );
-                m_pPixels[ i * 4 + 1 ] = (u32)( g * 255.0 );
-                m_pPixels[ i * 4 + 2 ] = (u32)( b * 255.0 );
-            }
-        }
-        else
-        {
-            for( u32 i=0; i<m_Width * m_Height; ++i )
-            {
-                auto r = f64( m_pPixels[ i * 3 + 0 ] ) / 255.0;
-                auto g = f64( m_pPixels[ i * 3 + 1 ] ) / 255.0;
-                auto b = f64( m_pPixels[ i * 3 + 2 ] ) / 255.0;
-                r = pow( r, 1.0 / gammaR );
-                g = pow( g, 1.0 / gammaG );
-                b = pow( b, 1.0 / gammaB );
-
-                m_pPixels[ i * 3 + 0 ] = (u32)( r * 255.0 );
-                m_pPixels[ i * 3 + 1 ] = (u32)( g * 255.0 );
-                m_pPixels[ i * 3 + 2 ] = (u32)( b * 255.0 );
-            }
-        }
-    }
+    { DeGamma( m_pPixels, m_Width * m_Height, dstBytes, gammaR, gammaG, gammaB ); }
+
+    m_HashKey = CRC32( bufferSize, pBuffer ).GetHash();
 
     return true;
 }
@@ -562,7 +731,7 @@ ResBMP& ResBMP::operator = ( const ResBMP& value )
     m_HashKey = value.m_HashKey;
 
     ASDX_DELETE_ARRAY( m_pPixels );
-    auto size = m_Width * m_Height * ( ( m_Format == Format_RGB ) ? 3 : 4 );
+    auto size = m_Width * m_Height * ( ( m_Format == Format_RGB || m_Format == Format_RGB_SRGB ) ? 3 : 4 );
     m_pPixels = new (std::nothrow) u8 [ size ];
     assert( m_pPixels != nullptr );
 
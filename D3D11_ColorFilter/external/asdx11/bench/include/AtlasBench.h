@@ -0,0 +1,47 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : AtlasBench.h
+// Desc : Texture Atlas Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ATLAS_BENCH_RESULT structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ATLAS_BENCH_RESULT
+{
+    const char*     Packer;             //!< 配置アルゴリズムの名前です("maxrects", "skyline").
+    bool            Rotation;           //!< 回転を許可したかどうかです.
+    uint32_t        InputCount;         //!< 入力数です.
+    uint32_t        Width;              //!< 一括構築したアトラスの横幅です.
+    uint32_t        Height;             //!< 一括構築したアトラスの縦幅です.
+    double          Occupancy;          //!< 一括構築したアトラスの充填率です.
+    double          BuildSec;           //!< 一括構築にかかった平均時間(秒)です.
+    uint32_t        MinSize;            //!< 一括構築できる最小の正方形の1辺(64ピクセル単位)です.
+    double          MinOccupancy;       //!< 最小の正方形に一括構築した場合の充填率です.
+    uint32_t        InsertWidth;        //!< 追加で構築したアトラスの横幅です.
+    uint32_t        InsertHeight;       //!< 追加で構築したアトラスの縦幅です.
+    double          InsertOccupancy;    //!< 追加で構築したアトラスの充填率です.
+    double          InsertSec;          //!< 追加1回あたりの平均時間(秒)です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      テクスチャアトラスの充填率と速度を計測します.
+//!             グリフ程度の小さい画像とスプライト程度の画像を混ぜた10000個の入力を，
+//!             配置アルゴリズムと回転の有無の組み合わせごとに一括構築します.
+//!             アトラスは2のべき乗で拡張されて充填率に差が出にくいので，一括構築できる最小の正方形も求めます.
+//!             追加の計測では半分を一括構築した後，残りを1つずつ追加します.
+//!
+//! @param[in]      iterations      計測回数です.
+//! @param[out]     result          組み合わせごとの計測結果です.
+//! @retval true    計測に成功.
+//! @retval false   構築に失敗したか，領域の重なりや書き込み内容の誤りを検出しました(内容はログに出力します).
+//-------------------------------------------------------------------------------------------------
+bool RunAtlasBenchmark(uint32_t iterations, std::vector<ATLAS_BENCH_RESULT>& result);
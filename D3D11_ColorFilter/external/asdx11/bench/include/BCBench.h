@@ -0,0 +1,39 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : BCBench.h
+// Desc : Block Compression Decode Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BC_BENCH_RESULT structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BC_BENCH_RESULT
+{
+    const char*     Format;         //!< フォーマットの名前です("bc1", "bc4_snorm", "bc6h_uf16" など).
+    const char*     Source;         //!< ブロックの生成方法です("encoder", "fixture").
+    uint32_t        Width;          //!< 展開した横幅です.
+    uint32_t        Height;         //!< 展開した縦幅です.
+    double          Seconds;        //!< 1回あたりの展開時間(秒)です.
+    double          MPixelsPerSec;  //!< 1秒あたりに展開したピクセル数(百万単位)です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      BC1～BC7の展開速度をフォーマットごとに計測します.
+//!             BC1, BC3, BC4, BC5(UNORM), BC7 はグラデーションにノイズを加えた画像を EncodeBlocks() で圧縮し，
+//!             エンコーダのない BC2, BC4, BC5(SNORM), BC6H は固定の種の乱数ビット列をブロックとして使います.
+//!             展開は DecodeBlocks() で呼び出しスレッドのみで行います.
+//!
+//! @param[in]      iterations      計測回数です.
+//! @param[out]     result          フォーマットごとの計測結果です.
+//! @retval true    計測に成功.
+//! @retval false   圧縮か展開に失敗したか，圧縮した画像の展開結果が元の画像から離れすぎています(内容はログに出力します).
+//-------------------------------------------------------------------------------------------------
+bool RunBCDecodeBenchmark(uint32_t iterations, std::vector<BC_BENCH_RESULT>& result);
@@ -0,0 +1,46 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : CacheBench.h
+// Desc : Cache Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CACHE_BENCH_RESULT structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CACHE_BENCH_RESULT
+{
+    const char*     Name;           //!< 実装の名前です("lru", "lru_list", "lfu", "lfu_map").
+    uint32_t        Entries;        //!< 最大収容可能数です.
+    uint64_t        Operations;     //!< 計測した操作数です.
+    double          OpsPerSec;      //!< 1秒あたりの操作数です.
+    double          HitRatio;       //!< ヒット率です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      キャッシュを以前の実装や素朴な実装と照合して検証します.
+//!             固定の種による乱数で追加, 検索, 削除を繰り返し，含まれる要素と追い出す順序が一致することと，
+//!             LRUのバイト数による制限と追い出し時の関数，LFUの統計情報と減衰が正しいことを確認します.
+//!
+//! @retval true    全て一致しました.
+//! @retval false   一致しない結果がありました(内容はログに出力します).
+//-------------------------------------------------------------------------------------------------
+bool VerifyCache();
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      キャッシュの速度とヒット率を，収容数 1k/100k/1M で計測します.
+//!             収容数の2倍の範囲の一様乱数のキーで，検索してなければ追加する操作を繰り返します.
+//!             std::list, std::map による以前の実装は1操作ごとに全要素を走査するので，
+//!             操作数を収容数に反比例して減らし，計測も1回だけ行います.
+//!
+//! @param[in]      iterations      計測回数です.
+//! @param[out]     result          実装と収容数の組み合わせごとの計測結果です.
+//-------------------------------------------------------------------------------------------------
+void RunCacheBenchmark(uint32_t iterations, std::vector<CACHE_BENCH_RESULT>& result);
@@ -0,0 +1,48 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : ConcurrentCacheBench.h
+// Desc : Concurrent Cache Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CONCURRENT_CACHE_BENCH_RESULT structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CONCURRENT_CACHE_BENCH_RESULT
+{
+    const char*     Workload;       //!< 負荷の名前です("hit", "mixed").
+    uint32_t        ShardCount;     //!< シャード数です.
+    uint32_t        ThreadCount;    //!< スレッド数です.
+    uint64_t        Operations;     //!< 計測した操作数です.
+    double          OpsPerSec;      //!< 1秒あたりの操作数です.
+    double          HitRatio;       //!< ヒット率です.
+    double          Scaling;        //!< 同じ負荷とシャード数の1スレッドに対する速度比です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      並行キャッシュを検証します.
+//!             単一スレッドでの追加, 検索, 削除と，割り切れない最大収容可能数やシャードの等分を超える要素の扱い，
+//!             複数スレッドから同じキーを要求したときに計算が1回だけ行われること，計算が例外を投げても
+//!             待っているスレッドが止まらないこと，複数スレッドから追加しても上限を超えないことを確認します.
+//!
+//! @retval true    全て正しい結果でした.
+//! @retval false   正しくない結果がありました(内容はログに出力します).
+//-------------------------------------------------------------------------------------------------
+bool VerifyConcurrentCache();
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      並行キャッシュの速度を，1～64スレッドとシャード数 1/64 の組み合わせで計測します.
+//!             収容数分のキーを追加してから，各スレッドが一様乱数のキーで GetOrCompute() を繰り返します.
+//!             "hit" は追加済みのキーだけを，"mixed" は収容数の2倍の範囲のキーを使います.
+//!
+//! @param[in]      iterations      計測回数です.
+//! @param[out]     result          負荷, シャード数, スレッド数の組み合わせごとの計測結果です.
+//-------------------------------------------------------------------------------------------------
+void RunConcurrentCacheBenchmark(uint32_t iterations, std::vector<CONCURRENT_CACHE_BENCH_RESULT>& result);
@@ -0,0 +1,39 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : Corpus.h
+// Desc : Benchmark Corpus Generator.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CORPUS_FILE structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CORPUS_FILE
+{
+    std::string     Name;       //!< ファイル名です(JSONの出力に使います).
+    std::string     Format;     //!< ファイル形式です("tga", "bmp", "hdr", "dds").
+    std::wstring    Path;       //!< ファイルパスです.
+    uint64_t        Size;       //!< ファイルサイズです.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ベンチマーク用の画像ファイル群を生成します.
+//!             乱数の種は固定なので，同じ引数からは常に同じバイト列が生成されます.
+//!
+//! @param[in]      directory       出力先ディレクトリです(末尾は区切り文字). 存在しない場合は作成します.
+//! @param[in]      size            基準となる画像サイズです. 配列やボリュームテクスチャはこれより小さくなります.
+//! @param[out]     result          生成したファイルの一覧です.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//! @note       TGA(全ビット深度, 非圧縮とRLE), BMP(1/4/8/24/32bit, RLE4/RLE8),
+//!             HDR(非圧縮, 旧RLE, 新RLE), DDS(2D, 配列, キューブ, ボリューム, ミップマップ付き)を生成します.
+//-------------------------------------------------------------------------------------------------
+bool GenerateCorpus(const std::wstring& directory, uint32_t size, std::vector<CORPUS_FILE>& result);
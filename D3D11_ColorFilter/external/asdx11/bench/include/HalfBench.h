@@ -0,0 +1,42 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : HalfBench.h
+// Desc : Half Conversion Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// HALF_BENCH_RESULT structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct HALF_BENCH_RESULT
+{
+    const char*     Level;          //!< SIMDレベルの名前です("scalar", "sse2", "f16c").
+    double          ToHalfPerSec;   //!< float から half への1秒あたりの変換要素数です.
+    double          ToFloatPerSec;  //!< half から float への1秒あたりの変換要素数です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      配列版の半精度浮動小数変換を全てのSIMDレベルで検証します.
+//!             65536通りの全てのhalf値と，その中間値(偶数丸めの境界)，固定の種による乱数ビット列について，
+//!             スカラー版とビット単位で一致することを確認します.
+//!
+//! @retval true    全て一致しました.
+//! @retval false   一致しない値がありました(内容はログに出力します).
+//-------------------------------------------------------------------------------------------------
+bool VerifyHalfConversion();
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      配列版の半精度浮動小数変換の速度を，対応する全てのSIMDレベルで計測します.
+//!
+//! @param[in]      iterations      計測回数です.
+//! @param[out]     result          SIMDレベルごとの計測結果です.
+//! @note       計測後のSIMDレベルは呼び出し前の値に戻します.
+//-------------------------------------------------------------------------------------------------
+void RunHalfBenchmark(uint32_t iterations, std::vector<HALF_BENCH_RESULT>& result);
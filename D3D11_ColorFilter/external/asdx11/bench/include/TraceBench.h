@@ -0,0 +1,80 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : TraceBench.h
+// Desc : Cache Trace Replay Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TRACE structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TRACE
+{
+    std::string             Name;       //!< トレースの名前です(JSONの出力に使います).
+    std::vector<uint32_t>   Keys;       //!< アクセス順のキーです. キーごとに0から振った番号です.
+    uint32_t                KeyCount;   //!< キーの種類数です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TRACE_BENCH_RESULT structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TRACE_BENCH_RESULT
+{
+    const char*     Policy;         //!< 追い出し方針の名前です("lru", "lfu", "tinylfu").
+    uint32_t        Capacity;       //!< 最大収容可能数です.
+    uint64_t        Operations;     //!< 1回の再生の操作数です.
+    double          HitRatio;       //!< ヒット率です.
+    double          OpsPerSec;      //!< 1秒あたりの操作数です.
+    uint64_t        MemoryBytes;    //!< キャッシュが確保したメモリサイズです.
+    double          BytesPerEntry;  //!< 1要素あたりのメモリサイズです.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      記録したアクセス列をテキストファイルから読み込みます.
+//!             1行に1つのキー(アセットのパスなど)を書きます. 空行と '#' で始まる行は無視します.
+//!
+//! @param[in]      path        ファイルパスです.
+//! @param[out]     result      読み込んだトレースです.
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//-------------------------------------------------------------------------------------------------
+bool LoadTrace(const std::wstring& path, TRACE& result);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      アセットブラウザを模したアクセス列を生成します.
+//!             よく使うアセットへの偏ったアクセスの合間に，一度しか開かないフォルダの走査を挟みます.
+//!
+//! @param[out]     result      生成したトレースです.
+//-------------------------------------------------------------------------------------------------
+void MakeBrowserTrace(TRACE& result);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      キーの種類数に対する割合(1%, 5%, 10%, 25%)から最大収容可能数を決めます.
+//!
+//! @param[in]      trace       トレースです.
+//! @param[out]     result      最大収容可能数です.
+//-------------------------------------------------------------------------------------------------
+void GetTraceCapacities(const TRACE& trace, std::vector<uint32_t>& result);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      トレースを LruCache, LfuCache, TinyLfuCache で再生し，ヒット率, 速度, メモリサイズを計測します.
+//!             キーごとに検索し，なければ追加します. 再生ごとに空のキャッシュから始めます.
+//!
+//! @param[in]      trace           トレースです.
+//! @param[in]      capacities      計測する最大収容可能数です.
+//! @param[in]      iterations      再生回数です.
+//! @param[out]     result          追い出し方針と最大収容可能数の組み合わせごとの計測結果です.
+//-------------------------------------------------------------------------------------------------
+void RunTraceBenchmark(
+    const TRACE&                        trace,
+    const std::vector<uint32_t>&        capacities,
+    uint32_t                            iterations,
+    std::vector<TRACE_BENCH_RESULT>&    result);
@@ -0,0 +1,306 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : AtlasBench.cpp
+// Desc : Texture Atlas Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <AtlasBench.h>
+#include <asdxTextureAtlas.h>
+#include <asdxResTexture.h>
+#include <asdxStopWatch.h>
+#include <asdxLogger.h>
+#include <dxgiformat.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kInputCount     = 10000;    // 入力数です.
+static const uint32_t   kGlyphPercent   = 70;       // グリフ程度の入力の割合(%)です.
+static const uint32_t   kGutter         = 1;        // ガターのピクセル数です.
+static const uint32_t   kRandomSeed     = 12345;    // 乱数の種です.
+static const uint32_t   kSizeStep       = 64;       // 最小サイズを探す刻み幅です.
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PACKER_ENTRY structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct PACKER_ENTRY
+{
+    asdx::ATLAS_PACKER  Packer;     //!< 配置アルゴリズムです.
+    bool                Rotation;   //!< 回転を許可するかどうかです.
+    const char*         Name;       //!< 名前です.
+};
+
+static const PACKER_ENTRY kPackers[] = {
+    { asdx::ATLAS_PACKER_MAXRECTS,  false,  "maxrects" },
+    { asdx::ATLAS_PACKER_MAXRECTS,  true,   "maxrects" },
+    { asdx::ATLAS_PACKER_SKYLINE,   false,  "skyline"  },
+    { asdx::ATLAS_PACKER_SKYLINE,   true,   "skyline"  },
+};
+
+//-------------------------------------------------------------------------------------------------
+//      入力テクスチャを生成します.
+//      R, G に画像内の座標を，B, A に入力番号を格納して，書き込み先を検証できるようにします.
+//-------------------------------------------------------------------------------------------------
+bool MakeInput(uint32_t index, uint32_t width, uint32_t height, asdx::ResTexture& result)
+{
+    result.Width        = width;
+    result.Height       = height;
+    result.Depth        = 1;
+    result.Format       = DXGI_FORMAT_R8G8B8A8_UNORM;
+    result.MipMapCount  = 1;
+    result.SurfaceCount = 1;
+
+    result.pResources = new (std::nothrow) asdx::SubResource[1];
+    result.pBlock     = new (std::nothrow) uint8_t[size_t(width) * height * 4];
+    if (result.pResources == nullptr || result.pBlock == nullptr)
+    {
+        ELOG("Error : Out of memory.");
+        result.Release();
+        return false;
+    }
+
+    auto& res = result.pResources[0];
+    res.Width      = width;
+    res.Height     = height;
+    res.Pitch      = width * 4;
+    res.SlicePitch = res.Pitch * height;
+    res.pPixels    = result.pBlock;
+
+    for(auto y=0u; y<height; ++y)
+    {
+        for(auto x=0u; x<width; ++x)
+        {
+            auto pPixel = result.pBlock + (size_t(y) * width + x) * 4;
+            pPixel[0] = uint8_t(x);
+            pPixel[1] = uint8_t(y);
+            pPixel[2] = uint8_t(index & 0xFF);
+            pPixel[3] = uint8_t(index >> 8);
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      配置結果を検証します.
+//-------------------------------------------------------------------------------------------------
+bool Verify
+(
+    const asdx::TextureAtlas&               atlas,
+    const std::vector<asdx::ResTexture>&    inputs,
+    const std::vector<std::string>&         names
+)
+{
+    asdx::ResTexture texture;
+    if (!atlas.GetTexture(texture))
+    { return false; }
+
+    auto width  = texture.Width;
+    auto height = texture.Height;
+    std::vector<uint8_t> owned(size_t(width) * height, 0);
+
+    auto success = true;
+    for(size_t i=0; i<inputs.size() && success; ++i)
+    {
+        asdx::TextureAtlas::Region region;
+        if (!atlas.Find(names[i].c_str(), region))
+        {
+            ELOGA("Error : Region Not Found. name = %s", names[i].c_str());
+            success = false;
+            break;
+        }
+
+        // ガターを含めて範囲内で，他の領域と重ならないこと.
+        if (region.X < kGutter || region.Y < kGutter
+         || region.X + region.Width  + kGutter > width
+         || region.Y + region.Height + kGutter > height)
+        {
+            ELOGA("Error : Region Out Of Range. name = %s", names[i].c_str());
+            success = false;
+            break;
+        }
+
+        for(auto y=region.Y - kGutter; y<region.Y + region.Height + kGutter && success; ++y)
+        {
+            for(auto x=region.X - kGutter; x<region.X + region.Width + kGutter; ++x)
+            {
+                auto& flag = owned[size_t(y) * width + x];
+                if (flag != 0)
+                {
+                    ELOGA("Error : Region Overlapped. name = %s", names[i].c_str());
+                    success = false;
+                    break;
+                }
+                flag = 1;
+            }
+        }
+
+        // 四隅のピクセルが元画像の対応する位置から書き込まれていること.
+        auto srcW = inputs[i].Width;
+        auto srcH = inputs[i].Height;
+        for(auto corner=0u; corner<4 && success; ++corner)
+        {
+            auto dx = (corner & 1) ? region.Width  - 1 : 0;
+            auto dy = (corner & 2) ? region.Height - 1 : 0;
+            auto sx = region.Rotated ? dy : dx;
+            auto sy = region.Rotated ? srcH - 1 - dx : dy;
+
+            auto pPixel = texture.pBlock + (size_t(region.Y + dy) * width + region.X + dx) * 4;
+            if (pPixel[0] != uint8_t(sx) || pPixel[1] != uint8_t(sy)
+             || pPixel[2] != uint8_t(i & 0xFF) || pPixel[3] != uint8_t(i >> 8)
+             || sx >= srcW || sy >= srcH)
+            {
+                ELOGA("Error : Pixel Mismatch. name = %s", names[i].c_str());
+                success = false;
+            }
+        }
+    }
+
+    texture.Release();
+    return success;
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャアトラスの充填率と速度を計測します.
+//-------------------------------------------------------------------------------------------------
+bool RunAtlasBenchmark(uint32_t iterations, std::vector<ATLAS_BENCH_RESULT>& result)
+{
+    result.clear();
+
+    if (iterations == 0)
+    { iterations = 1; }
+
+    std::vector<asdx::ResTexture>               textures(kInputCount);
+    std::vector<std::string>                    names   (kInputCount);
+    std::vector<asdx::TextureAtlas::Input>      inputs  (kInputCount);
+
+    std::mt19937 rng(kRandomSeed);
+    std::uniform_int_distribution<uint32_t> percent(0, 99);
+    std::uniform_int_distribution<uint32_t> glyph  (6, 32);
+    std::uniform_int_distribution<uint32_t> sprite (16, 128);
+
+    auto success = true;
+    for(auto i=0u; i<kInputCount && success; ++i)
+    {
+        auto isGlyph = percent(rng) < kGlyphPercent;
+        auto w = isGlyph ? glyph(rng) : sprite(rng);
+        auto h = isGlyph ? glyph(rng) : sprite(rng);
+
+        char name[32];
+        sprintf_s(name, "input_%05u", i);
+        names[i]  = name;
+        success   = MakeInput(i, w, h, textures[i]);
+        inputs[i] = { names[i].c_str(), &textures[i] };
+    }
+
+    for(auto& entry : kPackers)
+    {
+        if (!success)
+        { break; }
+
+        asdx::TextureAtlas::Desc desc = {};
+        desc.Format         = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.Packer         = entry.Packer;
+        desc.Gutter         = kGutter;
+        desc.MipCount       = 1;
+        desc.AllowRotation  = entry.Rotation;
+
+        ATLAS_BENCH_RESULT item = {};
+        item.Packer     = entry.Name;
+        item.Rotation   = entry.Rotation;
+        item.InputCount = kInputCount;
+
+        asdx::TextureAtlas atlas;
+        asdx::StopWatch    watch;
+        double buildSec  = 0.0;
+        double insertSec = 0.0;
+
+        for(auto i=0u; i<iterations && success; ++i)
+        {
+            // 一括構築.
+            success = atlas.Init(desc);
+            watch.Start();
+            success = success && atlas.Build(inputs.data(), kInputCount);
+            watch.End();
+            buildSec += watch.GetElapsedSec();
+
+            if (i == 0 && success)
+            {
+                success = Verify(atlas, textures, names);
+                item.Width     = atlas.GetWidth();
+                item.Height    = atlas.GetHeight();
+                item.Occupancy = atlas.GetStats().Occupancy;
+            }
+
+            // 半分を構築してから残りを1つずつ追加.
+            success = success && atlas.Init(desc) && atlas.Build(inputs.data(), kInputCount / 2);
+            watch.Start();
+            for(auto j=kInputCount / 2; j<kInputCount && success; ++j)
+            { success = atlas.Insert(inputs[j].Name, textures[j]); }
+            watch.End();
+            insertSec += watch.GetElapsedSec();
+
+            if (i == 0 && success)
+            {
+                success = Verify(atlas, textures, names);
+                item.InsertWidth     = atlas.GetWidth();
+                item.InsertHeight    = atlas.GetHeight();
+                item.InsertOccupancy = atlas.GetStats().Occupancy;
+            }
+        }
+
+        // 2のべき乗のサイズから，収まる最小の正方形を二分探索する.
+        auto lo = uint32_t(std::sqrt(double(atlas.GetStats().SlotPixels))) / kSizeStep;
+        auto hi = (std::max(item.Width, item.Height) + kSizeStep - 1) / kSizeStep;
+        while(success && lo + 1 < hi)
+        {
+            auto mid = (lo + hi) / 2;
+            auto fixedDesc = desc;
+            fixedDesc.Width     = mid * kSizeStep;
+            fixedDesc.Height    = mid * kSizeStep;
+            fixedDesc.MaxWidth  = mid * kSizeStep;
+            fixedDesc.MaxHeight = mid * kSizeStep;
+
+            asdx::TextureAtlas fixedAtlas;
+            success = fixedAtlas.Init(fixedDesc);
+            if (success && fixedAtlas.Build(inputs.data(), kInputCount))
+            { hi = mid; }
+            else
+            { lo = mid; }
+        }
+
+        item.MinSize      = hi * kSizeStep;
+        item.MinOccupancy = double(atlas.GetStats().UsedPixels) / (double(item.MinSize) * item.MinSize);
+
+        if (!success)
+        {
+            ELOGA("Error : Atlas Benchmark Failed. packer = %s, rotation = %d", entry.Name, entry.Rotation ? 1 : 0);
+            break;
+        }
+
+        item.BuildSec  = buildSec  / iterations;
+        item.InsertSec = insertSec / (double(iterations) * (kInputCount - kInputCount / 2));
+        result.push_back(item);
+    }
+
+    for(auto& texture : textures)
+    { texture.Release(); }
+
+    return success;
+}
@@ -0,0 +1,196 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : BCBench.cpp
+// Desc : Block Compression Decode Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <BCBench.h>
+#include <asdxBCDecoder.h>
+#include <asdxBCEncoder.h>
+#include <asdxStopWatch.h>
+#include <asdxLogger.h>
+#include <dxgiformat.h>
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kImageSize      = 1024;     // 展開する画像の1辺のピクセル数です.
+static const uint32_t   kNoiseRange     = 8;        // グラデーションに加えるノイズの幅です.
+static const double     kMaxMeanError   = 16.0;     // 圧縮した画像の展開結果として許容するチャンネルあたりの平均誤差です.
+static const uint32_t   kRandomSeed     = 12345;    // 乱数の種です.
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FORMAT_ENTRY structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FORMAT_ENTRY
+{
+    uint32_t        Format;         //!< DXGIフォーマットです.
+    const char*     Name;           //!< 名前です.
+    uint32_t        BlockSize;      //!< 1ブロックのバイト数です.
+    uint32_t        PixelSize;      //!< 展開後の1ピクセルのバイト数です.
+    uint32_t        Channels;       //!< 圧縮した画像と比較するチャンネル数です(0の場合は乱数ビット列から生成します).
+};
+
+static const FORMAT_ENTRY kFormats[] = {
+    { DXGI_FORMAT_BC1_UNORM,    "bc1",          8,  4, 3 },
+    { DXGI_FORMAT_BC2_UNORM,    "bc2",          16, 4, 0 },
+    { DXGI_FORMAT_BC3_UNORM,    "bc3",          16, 4, 4 },
+    { DXGI_FORMAT_BC4_UNORM,    "bc4_unorm",    8,  4, 1 },
+    { DXGI_FORMAT_BC4_SNORM,    "bc4_snorm",    8,  8, 0 },
+    { DXGI_FORMAT_BC5_UNORM,    "bc5_unorm",    16, 4, 2 },
+    { DXGI_FORMAT_BC5_SNORM,    "bc5_snorm",    16, 8, 0 },
+    { DXGI_FORMAT_BC6H_UF16,    "bc6h_uf16",    16, 8, 0 },
+    { DXGI_FORMAT_BC6H_SF16,    "bc6h_sf16",    16, 8, 0 },
+    { DXGI_FORMAT_BC7_UNORM,    "bc7",          16, 4, 4 },
+};
+
+//-------------------------------------------------------------------------------------------------
+//      圧縮元の画像を生成します.
+//      チャンネルごとに向きの異なるグラデーションにノイズを加えて，端点が一様にならないようにします.
+//      BC1 の透明ピクセルにならないように，アルファは128以上の範囲で変化させます.
+//-------------------------------------------------------------------------------------------------
+void MakeSourceImage(std::vector<uint8_t>& result)
+{
+    result.resize(size_t(kImageSize) * kImageSize * 4);
+
+    std::mt19937 rng(kRandomSeed);
+    std::uniform_int_distribution<int> noise(-int(kNoiseRange), int(kNoiseRange));
+
+    for(auto y=0u; y<kImageSize; ++y)
+    {
+        for(auto x=0u; x<kImageSize; ++x)
+        {
+            int base[4] = {
+                int(x * 255 / (kImageSize - 1)),
+                int(y * 255 / (kImageSize - 1)),
+                int((x + y) * 255 / (2 * (kImageSize - 1))),
+                int(255 - y * 127 / (kImageSize - 1)) - int(kNoiseRange),
+            };
+
+            auto pDst = &result[(size_t(y) * kImageSize + x) * 4];
+            for(auto c=0; c<4; ++c)
+            { pDst[c] = uint8_t(std::min(std::max(base[c] + noise(rng), 0), 255)); }
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乱数ビット列からブロックを生成します.
+//      BC2, BC4, BC5 は全てのビット列が有効なブロックです. BC6H は予約済みのモードを引き直します.
+//-------------------------------------------------------------------------------------------------
+void MakeFixtureBlocks(const FORMAT_ENTRY& entry, std::vector<uint8_t>& result)
+{
+    std::mt19937 rng(kRandomSeed ^ entry.Format);
+    std::uniform_int_distribution<uint32_t> dist(0, 255);
+
+    for(auto& value : result)
+    { value = uint8_t(dist(rng)); }
+
+    if (entry.Format != DXGI_FORMAT_BC6H_UF16 && entry.Format != DXGI_FORMAT_BC6H_SF16)
+    { return; }
+
+    // 下位2bitが 0 か 1 のモードは2bit，それ以外は5bitで，10011, 10111, 11011, 11111 が予約済み.
+    for(size_t i=0; i<result.size(); i+=entry.BlockSize)
+    {
+        auto& mode = result[i];
+        while((mode & 0x13) == 0x13)
+        { mode = uint8_t(dist(rng)); }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      圧縮した画像の展開結果と元の画像のチャンネルあたりの平均誤差を求めます.
+//-------------------------------------------------------------------------------------------------
+double GetMeanError(const std::vector<uint8_t>& source, const std::vector<uint8_t>& decoded, uint32_t channels)
+{
+    uint64_t sum = 0;
+    for(size_t i=0; i<source.size(); i+=4)
+    {
+        for(auto c=0u; c<channels; ++c)
+        { sum += uint64_t(std::abs(int(source[i + c]) - int(decoded[i + c]))); }
+    }
+
+    return double(sum) / (double(source.size() / 4) * channels);
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      BC1～BC7の展開速度をフォーマットごとに計測します.
+//-------------------------------------------------------------------------------------------------
+bool RunBCDecodeBenchmark(uint32_t iterations, std::vector<BC_BENCH_RESULT>& result)
+{
+    result.clear();
+
+    std::vector<uint8_t> source;
+    MakeSourceImage(source);
+
+    auto blockCount = kImageSize / 4;
+
+    for(auto& entry : kFormats)
+    {
+        auto srcPitch = blockCount * entry.BlockSize;
+        auto dstPitch = kImageSize * entry.PixelSize;
+
+        std::vector<uint8_t> blocks (size_t(srcPitch) * blockCount);
+        std::vector<uint8_t> decoded(size_t(dstPitch) * kImageSize);
+
+        if (entry.Channels > 0)
+        {
+            if (!asdx::EncodeBlocks(entry.Format, source.data(), kImageSize * 4, kImageSize, kImageSize, blocks.data(), srcPitch))
+            {
+                ELOGA("Error : EncodeBlocks() Failed. format = %s", entry.Name);
+                return false;
+            }
+        }
+        else
+        { MakeFixtureBlocks(entry, blocks); }
+
+        // 1回目は結果を確認し，計測には含めない.
+        if (!asdx::DecodeBlocks(entry.Format, blocks.data(), srcPitch, kImageSize, kImageSize, decoded.data(), dstPitch))
+        {
+            ELOGA("Error : DecodeBlocks() Failed. format = %s", entry.Name);
+            return false;
+        }
+
+        if (entry.Channels > 0)
+        {
+            auto error = GetMeanError(source, decoded, entry.Channels);
+            if (error > kMaxMeanError)
+            {
+                ELOGA("Error : Decoded Image Mismatch. format = %s, meanError = %f", entry.Name, error);
+                return false;
+            }
+        }
+
+        asdx::StopWatch watch;
+        watch.Start();
+        for(auto i=0u; i<iterations; ++i)
+        { asdx::DecodeBlocks(entry.Format, blocks.data(), srcPitch, kImageSize, kImageSize, decoded.data(), dstPitch); }
+        watch.End();
+
+        BC_BENCH_RESULT item = {};
+        item.Format  = entry.Name;
+        item.Source  = (entry.Channels > 0) ? "encoder" : "fixture";
+        item.Width   = kImageSize;
+        item.Height  = kImageSize;
+        item.Seconds = watch.GetElapsedSec() / iterations;
+
+        if (item.Seconds > 0.0)
+        { item.MPixelsPerSec = double(kImageSize) * kImageSize / item.Seconds / 1e6; }
+
+        result.push_back(item);
+    }
+
+    return true;
+}
@@ -0,0 +1,601 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : CacheBench.cpp
+// Desc : Cache Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <CacheBench.h>
+#include <asdxLfuCache.h>
+#include <asdxLruCache.h>
+#include <asdxTinyLfuCache.h>
+#include <asdxStopWatch.h>
+#include <asdxLogger.h>
+#include <algorithm>
+#include <list>
+#include <map>
+#include <random>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kVerifyCapacity = 64;           // 検証に使う最大収容可能数です.
+static const uint32_t   kVerifyKeyCount = 160;          // 検証に使うキーの種類です.
+static const uint32_t   kVerifyCount    = 200000;       // 検証で行う操作数です.
+static const uint32_t   kBenchCount     = 1 << 20;      // 速度計測で1回に行う操作数です.
+static const uint64_t   kLegacyBudget   = 1ull << 26;   // 以前の実装で走査する要素数の目安です.
+static const uint32_t   kRandomSeed     = 12345;        // 乱数の種です.
+
+// 計測する最大収容可能数.
+static const uint32_t kEntries[] = { 1000, 100000, 1000000 };
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ListLruCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// 比較用に残した std::list による以前の実装です.
+template<typename T>
+class ListLruCache
+{
+public:
+    ListLruCache(size_t capacity)
+    : m_Capacity(capacity)
+    , m_Cache()
+    { /* DO_NOTHING */ }
+
+    void Add(const T& item)
+    {
+        if ( Contains(item) )
+        {
+            m_Cache.remove(item);
+            m_Cache.push_back(item);
+        }
+        else if ( m_Cache.size() < m_Capacity )
+        {
+            m_Cache.push_back(item);
+        }
+        else
+        {
+            m_Cache.pop_front();
+            m_Cache.push_back(item);
+        }
+    }
+
+    void Remove(const T& item)
+    { m_Cache.remove(item); }
+
+    bool Contains(const T& item) const
+    { return std::find(m_Cache.cbegin(), m_Cache.cend(), item) != m_Cache.cend(); }
+
+    void Copy(T* pArray, size_t offset) const
+    {
+        for( auto itr = m_Cache.cbegin(); itr != m_Cache.cend(); itr++ )
+        {
+            pArray[offset] = *itr;
+            offset++;
+        }
+    }
+
+    size_t GetCount() const
+    { return m_Cache.size(); }
+
+    // Add() で満たすと収容数の2乗の時間がかかるので，計測の準備では直接並べる.
+    void Assign(const T* pItems, size_t count)
+    { m_Cache.assign(pItems, pItems + count); }
+
+private:
+    size_t          m_Capacity;
+    std::list<T>    m_Cache;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MapLfuCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// 比較用に残した std::map による以前の実装です.
+template<typename T>
+class MapLfuCache
+{
+public:
+    MapLfuCache(size_t capacity)
+    : m_Capacity(capacity)
+    , m_Cache()
+    { /* DO_NOTHING */ }
+
+    void Add(const T& item)
+    {
+        if ( Contains(item) )
+        {
+            m_Cache[item]++;
+        }
+        else if ( m_Cache.size() < m_Capacity )
+        {
+            m_Cache[item] = 1;
+        }
+        else
+        {
+            auto iter = m_Cache.begin();
+            auto mini = (*iter).second;
+
+            for(auto it = m_Cache.begin(); it != m_Cache.end(); ++it )
+            {
+                if ((*it).second < mini )
+                {
+                    mini = (*it).second;
+                    iter = it;
+                }
+            }
+
+            m_Cache.erase(iter);
+            m_Cache[item] = 1;
+        }
+    }
+
+    bool Contains(const T& item) const
+    { return m_Cache.find(item) != m_Cache.cend(); }
+
+    void Assign(const T* pItems, size_t count)
+    {
+        for(size_t i=0; i<count; ++i)
+        { m_Cache[pItems[i]] = 1; }
+    }
+
+private:
+    size_t              m_Capacity;
+    std::map<T, size_t> m_Cache;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// LfuModel class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// 頻度と最後に使った時刻を全要素から探す，検証用の素朴な実装です.
+class LfuModel
+{
+public:
+    LfuModel(size_t capacity)
+    : m_Capacity(capacity)
+    , m_Time    (0)
+    , m_Items   ()
+    , m_Stats   ()
+    { /* DO_NOTHING */ }
+
+    void Add(uint32_t item)
+    {
+        m_Time++;
+
+        auto itr = m_Items.find(item);
+        if (itr != m_Items.end())
+        {
+            itr->second.first++;
+            itr->second.second = m_Time;
+            m_Stats.Hits++;
+            return;
+        }
+
+        m_Stats.Misses++;
+        if (m_Items.size() >= m_Capacity)
+        {
+            auto victim = m_Items.begin();
+            for(auto it = m_Items.begin(); it != m_Items.end(); ++it)
+            {
+                if (it->second < victim->second)
+                { victim = it; }
+            }
+
+            m_Items.erase(victim);
+            m_Stats.Evictions++;
+        }
+
+        m_Items[item] = std::make_pair(uint64_t(1), m_Time);
+    }
+
+    void Remove(uint32_t item)
+    { m_Items.erase(item); }
+
+    bool Contains(uint32_t item) const
+    { return m_Items.find(item) != m_Items.end(); }
+
+    void Copy(uint32_t* pArray, size_t offset) const
+    {
+        std::vector<std::pair<std::pair<uint64_t, uint64_t>, uint32_t>> order;
+        for(auto& it : m_Items)
+        { order.push_back(std::make_pair(it.second, it.first)); }
+
+        std::sort(order.begin(), order.end());
+        for(auto& it : order)
+        { pArray[offset++] = it.second; }
+    }
+
+    size_t GetCount() const
+    { return m_Items.size(); }
+
+    asdx::CacheStats GetStats() const
+    { return m_Stats; }
+
+private:
+    size_t                                              m_Capacity;
+    uint64_t                                            m_Time;
+    std::map<uint32_t, std::pair<uint64_t, uint64_t>>   m_Items;    // 頻度と時刻です.
+    asdx::CacheStats                                    m_Stats;
+};
+
+//-------------------------------------------------------------------------------------------------
+//      キャッシュの使用順序が一致するか判定します.
+//-------------------------------------------------------------------------------------------------
+template<typename Cache, typename Expect>
+bool IsSameOrder(const Cache& cache, const Expect& expect)
+{
+    if (cache.GetCount() != expect.GetCount())
+    { return false; }
+
+    std::vector<uint32_t> a(kVerifyCapacity + 1);
+    std::vector<uint32_t> b(kVerifyCapacity + 1);
+    cache .Copy(a.data(), 0);
+    expect.Copy(b.data(), 0);
+    return std::equal(a.begin(), a.begin() + cache.GetCount(), b.begin());
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バイト数による制限と追い出し時の関数を検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyLruBytes()
+{
+    asdx::LruCache<uint32_t, uint32_t> cache(8, 100);
+
+    std::vector<uint32_t> evicted;
+    cache.SetEvictFunc([&evicted](const uint32_t& key, uint32_t& value)
+    {
+        if (key * 10 == value)
+        { evicted.push_back(key); }
+    });
+
+    // 40 + 40 + 20 で満杯にしてから，1を使って 2, 3 の順に追い出させる.
+    cache.Add(1, 10, 40);
+    cache.Add(2, 20, 40);
+    cache.Add(3, 30, 20);
+    cache.Find(1);
+    cache.Add(4, 40, 50);
+
+    auto success = (cache.GetBytes() == 90 && cache.GetCount() == 2)
+                && (evicted.size() == 2 && evicted[0] == 2 && evicted[1] == 3)
+                && (cache.GetFront() == 4 && cache.GetBack() == 1);
+
+    // 1要素で超える場合は追加しない.
+    success &= !cache.Add(5, 50, 101);
+    success &= (cache.GetCount() == 2);
+
+    // 更新で大きくなった要素は追い出さずに他を追い出す.
+    cache.Add(1, 10, 60);
+    success &= (cache.GetCount() == 1 && cache.GetBytes() == 60 && !cache.Contains(4));
+
+    cache.SetCapacityBytes(50);
+    success &= (cache.GetCount() == 0 && cache.GetBytes() == 0);
+
+    // Remove() と Clear() では呼び出さない.
+    cache.Add(6, 60, 10);
+    cache.Add(7, 70, 10);
+    cache.Remove(6);
+    cache.Clear();
+    success &= (evicted.size() == 4 && cache.GetCount() == 0 && cache.Peek(7) == nullptr);
+
+    if (!success)
+    { ELOG("Error : LruCache Byte Capacity Mismatch."); }
+
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      LRUキャッシュを以前の実装と照合して検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyLruCache()
+{
+    asdx::LruCache<uint32_t>    cache (kVerifyCapacity);
+    ListLruCache<uint32_t>      expect(kVerifyCapacity);
+
+    std::mt19937 rng(kRandomSeed);
+    for(uint32_t i=0; i<kVerifyCount; ++i)
+    {
+        auto key = uint32_t(rng() % kVerifyKeyCount);
+        auto op  = uint32_t(rng() % 8);
+
+        if (op == 0)
+        {
+            cache .Remove(key);
+            expect.Remove(key);
+        }
+        else if (op == 1)
+        {
+            if (cache.Contains(key) != expect.Contains(key))
+            {
+                ELOG("Error : LruCache::Contains() Mismatch. op = %u, key = %u", i, key);
+                return false;
+            }
+        }
+        else
+        {
+            cache .Add(key);
+            expect.Add(key);
+        }
+
+        if (!IsSameOrder(cache, expect))
+        {
+            ELOG("Error : LruCache Order Mismatch. op = %u, key = %u", i, key);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      LFUキャッシュを素朴な実装と照合して検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyLfuCache()
+{
+    asdx::LfuCache<uint32_t>    cache (kVerifyCapacity);
+    LfuModel                    expect(kVerifyCapacity);
+
+    std::mt19937 rng(kRandomSeed);
+    for(uint32_t i=0; i<kVerifyCount; ++i)
+    {
+        // 頻度に差が付くように，キーの半分は狭い範囲から選ぶ.
+        auto key = uint32_t(rng() % kVerifyKeyCount);
+        if (rng() & 1)
+        { key %= kVerifyCapacity / 2; }
+
+        auto op = uint32_t(rng() % 16);
+        if (op == 0)
+        {
+            cache .Remove(key);
+            expect.Remove(key);
+        }
+        else if (op == 1)
+        {
+            if (cache.Contains(key) != expect.Contains(key))
+            {
+                ELOG("Error : LfuCache::Contains() Mismatch. op = %u, key = %u", i, key);
+                return false;
+            }
+        }
+        else
+        {
+            cache .Add(key);
+            expect.Add(key);
+        }
+
+        if (!IsSameOrder(cache, expect))
+        {
+            ELOG("Error : LfuCache Order Mismatch. op = %u, key = %u", i, key);
+            return false;
+        }
+    }
+
+    auto stats = cache.GetStats();
+    auto ref   = expect.GetStats();
+    if (stats.Hits != ref.Hits || stats.Misses != ref.Misses || stats.Evictions != ref.Evictions)
+    {
+        ELOG("Error : LfuCache Stats Mismatch.");
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      LFUキャッシュの減衰を検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyLfuDecay()
+{
+    asdx::LfuCache<uint32_t, uint32_t> cache(4);
+
+    // 頻度 8, 3, 2, 1 から半分にすると 4, 1, 1, 1 になり，元の頻度が低い順に追い出す.
+    const uint32_t counts[] = { 8, 3, 2, 1 };
+    for(uint32_t key=0; key<4; ++key)
+    {
+        for(uint32_t i=0; i<counts[key]; ++i)
+        { cache.Add(key); }
+    }
+
+    cache.Decay();
+
+    uint32_t order[4] = {};
+    cache.Copy(order, 0);
+
+    auto success = (order[0] == 3 && order[1] == 2 && order[2] == 1 && order[3] == 0)
+                && (cache.GetFrequency(0) == 4 && cache.GetFrequency(1) == 1);
+
+    cache.Add(4, 40);
+    cache.Add(5, 50);
+    success &= (!cache.Contains(3) && !cache.Contains(2) && cache.Contains(1));
+    success &= (*cache.Peek(4) == 40 && cache.GetStats().Evictions == 2);
+
+    // 減衰させなければ高頻度だった要素は残り続け，減衰させればいずれ追い出される.
+    for(auto interval : { 0u, 2u })
+    {
+        asdx::LfuCache<uint32_t> hot(2);
+        hot.SetDecayInterval(interval);
+        for(auto i=0; i<16; ++i)
+        { hot.Add(0); }
+
+        for(uint32_t key=1; key<64; ++key)
+        { hot.Add(key); }
+
+        success &= (hot.Contains(0) == (interval == 0));
+    }
+
+    if (!success)
+    { ELOG("Error : LfuCache Decay Mismatch."); }
+
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      O(1) のキャッシュの速度を計測します.
+//-------------------------------------------------------------------------------------------------
+template<typename Cache>
+CACHE_BENCH_RESULT MeasureCache
+(
+    const char*                     name,
+    uint32_t                        entries,
+    const std::vector<uint32_t>&    fill,
+    const std::vector<uint32_t>&    keys,
+    uint32_t                        iterations
+)
+{
+    Cache cache(entries);
+    for(auto key : fill)
+    { cache.Add(key, key); }
+
+    uint64_t hits = 0;
+
+    asdx::StopWatch watch;
+    watch.Start();
+    for(auto i=0u; i<iterations; ++i)
+    {
+        for(auto key : keys)
+        {
+            if (cache.Find(key) != nullptr)
+            { hits++; }
+            else
+            { cache.Add(key, key); }
+        }
+    }
+    watch.End();
+
+    CACHE_BENCH_RESULT item = {};
+    item.Name       = name;
+    item.Entries    = entries;
+    item.Operations = uint64_t(keys.size()) * iterations;
+    item.HitRatio   = double(hits) / double(item.Operations);
+
+    auto sec = watch.GetElapsedSec();
+    if (sec > 0.0)
+    { item.OpsPerSec = double(item.Operations) / sec; }
+
+    return item;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      以前の実装の速度を計測します.
+//-------------------------------------------------------------------------------------------------
+template<typename Cache>
+CACHE_BENCH_RESULT MeasureLegacyCache
+(
+    const char*                     name,
+    uint32_t                        entries,
+    const std::vector<uint32_t>&    fill,
+    const std::vector<uint32_t>&    keys
+)
+{
+    Cache cache(entries);
+    cache.Assign(fill.data(), fill.size());
+
+    auto count = uint32_t(std::max<uint64_t>(kLegacyBudget / entries, 64));
+    count = std::min(count, uint32_t(keys.size()));
+
+    uint64_t hits = 0;
+
+    asdx::StopWatch watch;
+    watch.Start();
+    for(auto i=0u; i<count; ++i)
+    {
+        if (cache.Contains(keys[i]))
+        { hits++; }
+        cache.Add(keys[i]);
+    }
+    watch.End();
+
+    CACHE_BENCH_RESULT item = {};
+    item.Name       = name;
+    item.Entries    = entries;
+    item.Operations = count;
+    item.HitRatio   = double(hits) / double(item.Operations);
+
+    auto sec = watch.GetElapsedSec();
+    if (sec > 0.0)
+    { item.OpsPerSec = double(item.Operations) / sec; }
+
+    return item;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      W-TinyLFUキャッシュの本体に入れる判定を検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyTinyLfuAdmission()
+{
+    // 最大収容可能数 100 では窓が1要素, 本体が99要素になる.
+    asdx::TinyLfuCache<uint32_t, uint32_t> cache(100);
+
+    // 1回だけ追加した要素で一杯にする.
+    for(uint32_t key=0; key<100; ++key)
+    { cache.Add(key, key); }
+
+    // 検索せずに追加だけを繰り返した要素も頻度が数えられ，窓から押し出されたときに本体の追い出し候補と入れ替わる.
+    const uint32_t hot = 1000;
+    for(auto i=0; i<5; ++i)
+    { cache.Add(hot, i); }
+
+    auto evictions = cache.GetStats().Evictions;
+    cache.Add(2000, 2000);
+
+    auto success = cache.Contains(hot) && *cache.Peek(hot) == 4
+                && cache.GetStats().Evictions == evictions + 1
+                && cache.GetCount() == 100;
+
+    // 1回だけ追加した要素は追い出し候補より頻度が高くないので捨てられる.
+    cache.Add(3000, 3000);
+    success &= (!cache.Contains(2000) && cache.Contains(3000) && cache.Contains(hot));
+
+    if (!success)
+    {
+        ELOG("Error : TinyLfuCache Admission Mismatch.");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      キャッシュを検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyCache()
+{
+    return VerifyLruCache()
+        && VerifyLruBytes()
+        && VerifyLfuCache()
+        && VerifyLfuDecay()
+        && VerifyTinyLfuAdmission();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キャッシュの速度とヒット率を計測します.
+//-------------------------------------------------------------------------------------------------
+void RunCacheBenchmark(uint32_t iterations, std::vector<CACHE_BENCH_RESULT>& result)
+{
+    result.clear();
+
+    std::vector<uint32_t> keys(kBenchCount);
+
+    for(auto entries : kEntries)
+    {
+        std::mt19937 rng(kRandomSeed);
+        for(auto& key : keys)
+        { key = rng() % (entries * 2); }
+
+        // 同じキーで満たしてから計測する.
+        std::vector<uint32_t> fill(entries);
+        for(auto i=0u; i<entries; ++i)
+        { fill[i] = i * 2; }
+
+        result.push_back(MeasureCache<asdx::LruCache<uint32_t, uint32_t>>("lru", entries, fill, keys, iterations));
+        result.push_back(MeasureLegacyCache<ListLruCache<uint32_t>>("lru_list", entries, fill, keys));
+        result.push_back(MeasureCache<asdx::LfuCache<uint32_t, uint32_t>>("lfu", entries, fill, keys, iterations));
+        result.push_back(MeasureLegacyCache<MapLfuCache<uint32_t>>("lfu_map", entries, fill, keys));
+    }
+}
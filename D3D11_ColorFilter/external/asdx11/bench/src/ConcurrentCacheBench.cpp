@@ -0,0 +1,484 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : ConcurrentCacheBench.cpp
+// Desc : Concurrent Cache Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <ConcurrentCacheBench.h>
+#include <asdxConcurrentCache.h>
+#include <asdxStopWatch.h>
+#include <asdxLogger.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kVerifyThreadCount  = 32;       // 検証に使うスレッド数です.
+static const uint32_t   kVerifyKeyCount     = 256;      // 計算が1回だけ行われることの検証に使うキーの種類です.
+static const uint32_t   kVerifyBytesCount   = 20000;    // バイト数の上限の検証で1スレッドが行う追加数です.
+static const uint32_t   kBenchCapacity      = 65536;    // 速度計測に使う最大収容可能数です.
+static const uint32_t   kBenchValueBytes    = 64;       // 速度計測で1要素に設定するバイト数です.
+static const uint32_t   kBenchCount         = 1 << 16;  // 速度計測で1スレッドが行う操作数です.
+static const uint32_t   kRandomSeed         = 12345;    // 乱数の種です.
+
+// 計測するスレッド数とシャード数.
+static const uint32_t kThreadCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+static const uint32_t kShardCounts [] = { 1, 64 };
+
+using Cache = asdx::ConcurrentCache<uint32_t, uint32_t>;
+
+//-------------------------------------------------------------------------------------------------
+//      スレッドを一斉に開始して，全て終わるまでの時間を計測します.
+//-------------------------------------------------------------------------------------------------
+template<typename Func>
+double RunThreads(uint32_t threadCount, Func func)
+{
+    std::atomic<uint32_t>   ready(0);
+    std::atomic<bool>       start(false);
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for(auto i=0u; i<threadCount; ++i)
+    {
+        threads.emplace_back([&, i]()
+        {
+            ready++;
+            while(!start.load())
+            { std::this_thread::yield(); }
+
+            func(i);
+        });
+    }
+
+    // スレッドの生成は計測に含めない.
+    while(ready.load() < threadCount)
+    { std::this_thread::yield(); }
+
+    asdx::StopWatch watch;
+    watch.Start();
+    start = true;
+
+    for(auto& thread : threads)
+    { thread.join(); }
+    watch.End();
+
+    return watch.GetElapsedSec();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      単一スレッドでの基本的な操作を検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyBasic()
+{
+    Cache cache(64, 1000, 4);
+
+    auto success = (cache.GetShardCount() == 4 && cache.GetCapacity() == 64);
+
+    // 最大収容可能バイト数を超える要素は追加しない.
+    success &= cache.Add(1, 10, 100);
+    success &= cache.Add(2, 20, 100);
+    success &= !cache.Add(3, 30, 1001);
+    success &= (cache.GetCount() == 2 && cache.GetBytes() == 200 && !cache.Contains(3));
+
+    uint32_t value = 0;
+    success &= (cache.Find(1, value) && value == 10);
+    success &= !cache.Find(3, value);
+
+    // 計算に失敗した値は追加しない.
+    auto fail = [](const uint32_t&, uint32_t&, size_t&) { return false; };
+    success &= !cache.GetOrCompute(4, value, fail);
+    success &= !cache.Contains(4);
+
+    auto compute = [](const uint32_t& key, uint32_t& value, size_t& bytes)
+    {
+        value = key * 10;
+        bytes = 10;
+        return true;
+    };
+    success &= (cache.GetOrCompute(4, value, compute) && value == 40);
+    success &= (cache.GetOrCompute(2, value, compute) && value == 20);
+    success &= (cache.GetCount() == 3 && cache.GetBytes() == 210);
+
+    auto stats = cache.GetStats();
+    success &= (stats.Hits == 2 && stats.Misses == 3 && stats.Evictions == 0);
+
+    success &= cache.Remove(1);
+    success &= !cache.Remove(1);
+    cache.Clear();
+    success &= (cache.GetCount() == 0 && cache.GetBytes() == 0);
+
+    if (!success)
+    { ELOG("Error : ConcurrentCache Basic Operation Mismatch."); }
+
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      同じキーを複数スレッドから要求しても計算が1回だけ行われることを検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifySingleCompute()
+{
+    Cache cache(kVerifyKeyCount * 16, 0, 16);
+
+    std::vector<std::atomic<uint32_t>> counts(kVerifyKeyCount);
+    for(auto& count : counts)
+    { count = 0; }
+
+    std::atomic<uint32_t> mismatch(0);
+
+    RunThreads(kVerifyThreadCount, [&](uint32_t index)
+    {
+        // スレッドごとに開始位置をずらし，計算中のキーに他のスレッドが当たるようにする.
+        for(auto i=0u; i<kVerifyKeyCount; ++i)
+        {
+            auto key = (i + index * 7) % kVerifyKeyCount;
+
+            uint32_t value = 0;
+            auto success = cache.GetOrCompute(key, value, [&](const uint32_t& item, uint32_t& result, size_t& bytes)
+            {
+                counts[item]++;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                result = item + 1;
+                bytes  = 0;
+                return true;
+            });
+
+            if (!success || value != key + 1)
+            { mismatch++; }
+        }
+    });
+
+    auto success = (mismatch.load() == 0 && cache.GetCount() == kVerifyKeyCount);
+    for(auto i=0u; i<kVerifyKeyCount; ++i)
+    { success &= (counts[i].load() == 1); }
+
+    auto stats = cache.GetStats();
+    success &= (stats.Misses == kVerifyKeyCount);
+    success &= (stats.Hits == uint64_t(kVerifyKeyCount) * (kVerifyThreadCount - 1));
+
+    if (!success)
+    { ELOG("Error : ConcurrentCache Compute Count Mismatch."); }
+
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      複数スレッドから追加しても最大収容可能数とバイト数の上限を超えないことを検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyBytes()
+{
+    // 最大収容可能数はシャード数で割り切れない値にする.
+    const size_t capacity      = 333;
+    const size_t capacityBytes = 64 * 1024;
+    Cache cache(capacity, capacityBytes, 16);
+
+    std::atomic<bool>     running(true);
+    std::atomic<uint32_t> overCount(0);
+
+    // 追加中も上限を超えていないか調べる.
+    std::thread monitor([&]()
+    {
+        while(running.load())
+        {
+            if (cache.GetBytes() > capacityBytes || cache.GetCount() > capacity)
+            { overCount++; }
+            std::this_thread::yield();
+        }
+    });
+
+    RunThreads(8, [&](uint32_t index)
+    {
+        std::mt19937 rng(kRandomSeed + index);
+        for(auto i=0u; i<kVerifyBytesCount; ++i)
+        {
+            auto key   = uint32_t(rng() % 10000);
+            auto bytes = size_t(rng() % 256 + 1);
+            cache.Add(key, key, bytes);
+        }
+    });
+
+    running = false;
+    monitor.join();
+
+    auto success = (overCount.load() == 0 && cache.GetBytes() <= capacityBytes);
+    success &= (cache.GetCount() <= capacity && cache.GetStats().Evictions > 0);
+
+    // 追い出しや更新で戻したバイト数が合っていれば，全て削除すると0になる.
+    cache.Clear();
+    success &= (cache.GetBytes() == 0 && cache.GetCount() == 0);
+
+    if (!success)
+    { ELOG("Error : ConcurrentCache Byte Capacity Exceeded."); }
+
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      割り切れない最大収容可能数と，シャードの等分を超える要素の追加を検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyCapacity()
+{
+    auto success = true;
+
+    // 100 は 64 シャードで割り切れないが，合計は 100 を超えない.
+    {
+        Cache cache(100, 1000, 64);
+        for(auto key=0u; key<1000; ++key)
+        {
+            cache.Add(key, key, 7);
+            success &= (cache.GetCount() <= 100 && cache.GetBytes() <= 1000);
+        }
+
+        success &= (cache.GetCapacity() == 100 && cache.GetCount() == 100 && cache.GetBytes() == 700);
+    }
+
+    // シャード数より小さい最大収容可能数では，空のシャードができないようにシャード数を減らす.
+    {
+        Cache cache(5, 0, 64);
+        for(auto key=0u; key<100; ++key)
+        { success &= cache.Add(key, key); }
+
+        success &= (cache.GetShardCount() == 4 && cache.GetCount() == 5);
+    }
+
+    // 最大収容可能バイト数をシャード数で等分した値より大きい要素も追加でき，
+    // 他のシャードから追い出して全体の上限に収める.
+    {
+        Cache cache(1000, 1000, 16);
+        for(auto key=0u; key<16; ++key)
+        { success &= cache.Add(key, key, 60); }
+
+        auto compute = [](const uint32_t& key, uint32_t& value, size_t& bytes)
+        {
+            value = key;
+            bytes = 100;
+            return true;
+        };
+
+        uint32_t value  = 0;
+        bool     cached = false;
+        success &= (cache.GetOrCompute(100, value, compute, &cached) && cached && cache.Contains(100));
+        success &= (cache.GetBytes() <= 1000 && cache.GetStats().Evictions > 0);
+
+        // 全体の上限を超える要素は計算結果を返すが，追加できなかったことを通知する.
+        auto huge = [](const uint32_t& key, uint32_t& value, size_t& bytes)
+        {
+            value = key;
+            bytes = 1001;
+            return true;
+        };
+        success &= (cache.GetOrCompute(200, value, huge, &cached) && value == 200 && !cached);
+        success &= !cache.Contains(200);
+    }
+
+    // 上限まで入っている状態での更新は置き換える値の分を差し引くので，同じサイズなら追い出さない.
+    // 大きくする場合も更新する要素自身は追い出さず，足りない分だけ他の要素を追い出す.
+    {
+        Cache cache(100, 100, 4);
+        for(auto key=0u; key<10; ++key)
+        { success &= cache.Add(key, key, 10); }
+
+        for(auto i=0u; i<100; ++i)
+        { success &= cache.Add(i % 10, i, 10); }
+
+        success &= (cache.GetStats().Evictions == 0 && cache.GetCount() == 10 && cache.GetBytes() == 100);
+
+        for(auto key=0u; key<10; ++key)
+        { success &= (cache.Add(key, key, 15) && cache.Contains(key) && cache.GetBytes() <= 100); }
+
+        success &= (cache.GetStats().Evictions > 0 && cache.GetBytes() <= 100);
+    }
+
+    if (!success)
+    { ELOG("Error : ConcurrentCache Capacity Mismatch."); }
+
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      計算が例外を投げても待っているスレッドが止まらないことを検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyComputeException()
+{
+    Cache cache(64, 0, 4);
+
+    std::atomic<bool> started(false);
+    std::atomic<bool> thrown (false);
+    std::atomic<bool> waited (true);
+
+    std::thread owner([&]()
+    {
+        try
+        {
+            uint32_t value = 0;
+            cache.GetOrCompute(1, value, [&](const uint32_t&, uint32_t&, size_t&) -> bool
+            {
+                started = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                throw std::runtime_error("compute failed");
+            });
+        }
+        catch(const std::runtime_error&)
+        { thrown = true; }
+    });
+
+    while(!started.load())
+    { std::this_thread::yield(); }
+
+    // 計算中のキーを要求したスレッドは失敗として受け取る.
+    std::thread waiter([&]()
+    {
+        uint32_t value = 0;
+        waited = cache.GetOrCompute(1, value, [](const uint32_t&, uint32_t& result, size_t&)
+        {
+            result = 1;
+            return true;
+        });
+    });
+
+    owner .join();
+    waiter.join();
+
+    // 計算中の記録は残らないので，次の要求で計算し直せる.
+    uint32_t value = 0;
+    auto success = thrown.load() && (!waited.load() || cache.Contains(1));
+    success &= cache.GetOrCompute(1, value, [](const uint32_t&, uint32_t& result, size_t&)
+    {
+        result = 2;
+        return true;
+    });
+    success &= (value == 1 || value == 2) && cache.Contains(1);
+
+    if (!success)
+    { ELOG("Error : ConcurrentCache Compute Exception Mismatch."); }
+
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1つの組み合わせの速度を計測します.
+//-------------------------------------------------------------------------------------------------
+CONCURRENT_CACHE_BENCH_RESULT Measure
+(
+    const char*                     workload,
+    uint32_t                        shardCount,
+    uint32_t                        threadCount,
+    const std::vector<uint32_t>&    keys,
+    uint32_t                        iterations
+)
+{
+    auto compute = [](const uint32_t& key, uint32_t& value, size_t& bytes)
+    {
+        value = key;
+        bytes = kBenchValueBytes;
+        return true;
+    };
+
+    uint64_t hits   = 0;
+    uint64_t misses = 0;
+    double   sec    = 0.0;
+
+    for(auto i=0u; i<iterations; ++i)
+    {
+        // 同じキーで満たしてから計測する.
+        Cache cache(kBenchCapacity, size_t(kBenchCapacity) * kBenchValueBytes, shardCount);
+        for(auto key=0u; key<kBenchCapacity; ++key)
+        { cache.Add(key, key, kBenchValueBytes); }
+        cache.ResetStats();
+
+        sec += RunThreads(threadCount, [&](uint32_t index)
+        {
+            auto pKeys = keys.data() + size_t(index) * kBenchCount;
+            for(auto j=0u; j<kBenchCount; ++j)
+            {
+                uint32_t value;
+                cache.GetOrCompute(pKeys[j], value, compute);
+            }
+        });
+
+        auto stats = cache.GetStats();
+        hits   += stats.Hits;
+        misses += stats.Misses;
+    }
+
+    CONCURRENT_CACHE_BENCH_RESULT item = {};
+    item.Workload    = workload;
+    item.ShardCount  = shardCount;
+    item.ThreadCount = threadCount;
+    item.Operations  = uint64_t(kBenchCount) * threadCount;
+
+    if (hits + misses > 0)
+    { item.HitRatio = double(hits) / double(hits + misses); }
+
+    if (sec > 0.0)
+    { item.OpsPerSec = double(item.Operations) * iterations / sec; }
+
+    return item;
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      並行キャッシュを検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyConcurrentCache()
+{
+    return VerifyBasic()
+        && VerifyCapacity()
+        && VerifySingleCompute()
+        && VerifyComputeException()
+        && VerifyBytes();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      並行キャッシュの速度を計測します.
+//-------------------------------------------------------------------------------------------------
+void RunConcurrentCacheBenchmark(uint32_t iterations, std::vector<CONCURRENT_CACHE_BENCH_RESULT>& result)
+{
+    result.clear();
+
+    auto maxThreadCount = kThreadCounts[_countof(kThreadCounts) - 1];
+
+    // 全スレッド分のキーを先に作っておき，乱数の生成を計測に含めない.
+    std::vector<uint32_t> hitKeys  (size_t(kBenchCount) * maxThreadCount);
+    std::vector<uint32_t> mixedKeys(size_t(kBenchCount) * maxThreadCount);
+    {
+        std::mt19937 rng(kRandomSeed);
+        for(size_t i=0; i<hitKeys.size(); ++i)
+        {
+            hitKeys  [i] = uint32_t(rng() % kBenchCapacity);
+            mixedKeys[i] = uint32_t(rng() % (kBenchCapacity * 2));
+        }
+    }
+
+    for(auto shardCount : kShardCounts)
+    {
+        for(auto threadCount : kThreadCounts)
+        { result.push_back(Measure("hit", shardCount, threadCount, hitKeys, iterations)); }
+
+        for(auto threadCount : kThreadCounts)
+        { result.push_back(Measure("mixed", shardCount, threadCount, mixedKeys, iterations)); }
+    }
+
+    // 1スレッドの結果は各組み合わせの先頭にある.
+    for(size_t i=0; i<result.size(); i += _countof(kThreadCounts))
+    {
+        for(size_t j=0; j<_countof(kThreadCounts); ++j)
+        {
+            auto& item = result[i + j];
+            if (result[i].OpsPerSec > 0.0)
+            { item.Scaling = item.OpsPerSec / result[i].OpsPerSec; }
+        }
+    }
+}
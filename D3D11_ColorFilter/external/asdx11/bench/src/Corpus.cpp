@@ -0,0 +1,821 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : Corpus.cpp
+// Desc : Benchmark Corpus Generator.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <Corpus.h>
+#include <asdxLogger.h>
+#include <Windows.h>
+#include <dxgiformat.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t DDS_MAGIC                 = 0x20534444;   // 'DDS '
+static const uint32_t DDSD_CAPS                 = 0x00000001;
+static const uint32_t DDSD_HEIGHT               = 0x00000002;
+static const uint32_t DDSD_WIDTH                = 0x00000004;
+static const uint32_t DDSD_PIXELFORMAT          = 0x00001000;
+static const uint32_t DDSD_MIPMAPCOUNT          = 0x00020000;
+static const uint32_t DDSD_DEPTH                = 0x00800000;
+static const uint32_t DDPF_FOURCC               = 0x00000004;
+static const uint32_t DDSCAPS_COMPLEX           = 0x00000008;
+static const uint32_t DDSCAPS_TEXTURE           = 0x00001000;
+static const uint32_t DDSCAPS_MIPMAP            = 0x00400000;
+static const uint32_t DDSCAPS2_CUBEMAP_ALL      = 0x0000FE00;
+static const uint32_t DDSCAPS2_VOLUME           = 0x00400000;
+static const uint32_t DDS_DIMENSION_TEXTURE2D   = 3;
+static const uint32_t DDS_DIMENSION_TEXTURE3D   = 4;
+static const uint32_t DDS_MISC_TEXTURECUBE      = 0x4;
+static const uint32_t FOURCC_DXT1               = 0x31545844;   // 'DXT1'
+static const uint32_t FOURCC_DX10               = 0x30315844;   // 'DX10'
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DDS_HEADER structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct DDS_HEADER
+{
+    uint32_t    Size;
+    uint32_t    Flags;
+    uint32_t    Height;
+    uint32_t    Width;
+    uint32_t    PitchOrLinearSize;
+    uint32_t    Depth;
+    uint32_t    MipMapCount;
+    uint32_t    Reserved1[11];
+    uint32_t    PixelFormatSize;
+    uint32_t    PixelFormatFlags;
+    uint32_t    FourCC;
+    uint32_t    BitCount;
+    uint32_t    Mask[4];
+    uint32_t    Caps;
+    uint32_t    Caps2;
+    uint32_t    Caps3;
+    uint32_t    Caps4;
+    uint32_t    Reserved2;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DDS_HEADER_DX10 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct DDS_HEADER_DX10
+{
+    uint32_t    DxgiFormat;
+    uint32_t    ResourceDimension;
+    uint32_t    MiscFlag;
+    uint32_t    ArraySize;
+    uint32_t    MiscFlags2;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Random class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class Random
+{
+public:
+    explicit Random(uint32_t seed)
+    : m_State((seed != 0) ? seed : 0x9E3779B9)
+    { /* DO_NOTHING */ }
+
+    uint32_t Next()
+    {
+        m_State ^= m_State << 13;
+        m_State ^= m_State >> 17;
+        m_State ^= m_State << 5;
+        return m_State;
+    }
+
+private:
+    uint32_t m_State;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Writer class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class Writer
+{
+public:
+    std::vector<uint8_t> Data;
+
+    void U8(uint32_t value)
+    { Data.push_back(uint8_t(value)); }
+
+    void U16(uint32_t value)
+    {
+        U8(value & 0xFF);
+        U8(value >> 8);
+    }
+
+    void U32(uint32_t value)
+    {
+        U16(value & 0xFFFF);
+        U16(value >> 16);
+    }
+
+    void Bytes(const void* pData, size_t size)
+    {
+        auto ptr = static_cast<const uint8_t*>(pData);
+        Data.insert(Data.end(), ptr, ptr + size);
+    }
+
+    void Text(const char* text)
+    { Bytes(text, strlen(text)); }
+};
+
+//-------------------------------------------------------------------------------------------------
+//      テスト画像(RGBA8)を生成します.
+//      ランレングス圧縮が効く単色ブロックと，効かないノイズの領域を混ぜています.
+//-------------------------------------------------------------------------------------------------
+std::vector<uint8_t> MakeImage(uint32_t width, uint32_t height, uint32_t seed)
+{
+    std::vector<uint8_t> result(size_t(width) * height * 4);
+    Random random(seed);
+
+    auto ptr = result.data();
+    for(auto y=0u; y<height; ++y)
+    {
+        for(auto x=0u; x<width; ++x, ptr+=4)
+        {
+            auto block = ((x >> 4) + (y >> 3) * 131u + seed) * 2654435761u;
+            block ^= block >> 15;
+
+            if ((block & 3) != 0)
+            {
+                ptr[0] = uint8_t(block >>  4);
+                ptr[1] = uint8_t(block >> 12);
+                ptr[2] = uint8_t(block >> 20);
+                ptr[3] = uint8_t((block & 1) ? 255 : 128);
+            }
+            else
+            {
+                auto noise = random.Next();
+                ptr[0] = uint8_t((x * 255) / width  + (noise & 0x1F));
+                ptr[1] = uint8_t((y * 255) / height + ((noise >> 8) & 0x1F));
+                ptr[2] = uint8_t(noise >> 16);
+                ptr[3] = uint8_t(noise >> 24);
+            }
+        }
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      輝度を求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint8_t ToLuminance(const uint8_t* pRGBA)
+{ return uint8_t((pRGBA[0] * 77 + pRGBA[1] * 150 + pRGBA[2] * 29) >> 8); }
+
+//-------------------------------------------------------------------------------------------------
+//      RGB332 のパレットインデックスを求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint8_t ToIndex332(const uint8_t* pRGBA)
+{ return uint8_t((pRGBA[0] & 0xE0) | ((pRGBA[1] >> 3) & 0x1C) | (pRGBA[2] >> 6)); }
+
+//-------------------------------------------------------------------------------------------------
+//      RGB332 のパレット色を求めます.
+//-------------------------------------------------------------------------------------------------
+inline void FromIndex332(uint32_t index, uint8_t& r, uint8_t& g, uint8_t& b)
+{
+    r = uint8_t(((index >> 5) & 7) * 255 / 7);
+    g = uint8_t(((index >> 2) & 7) * 255 / 7);
+    b = uint8_t(( index       & 3) * 255 / 3);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルに書き出します.
+//-------------------------------------------------------------------------------------------------
+bool SaveFile
+(
+    const std::wstring&         directory,
+    const char*                 name,
+    const char*                 format,
+    const std::vector<uint8_t>& data,
+    std::vector<CORPUS_FILE>&   result
+)
+{
+    CORPUS_FILE file;
+    file.Name   = name;
+    file.Format = format;
+    file.Path   = directory + std::wstring(file.Name.begin(), file.Name.end());
+    file.Size   = data.size();
+
+    FILE* pFile = nullptr;
+    auto err = _wfopen_s(&pFile, file.Path.c_str(), L"wb");
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOGW("Error : File Open Failed. path = %s", file.Path.c_str());
+        return false;
+    }
+
+    auto written = fwrite(data.data(), 1, data.size(), pFile);
+    fclose(pFile);
+
+    if (written != data.size())
+    {
+        ELOGW("Error : File Write Failed. path = %s", file.Path.c_str());
+        return false;
+    }
+
+    result.push_back(file);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      TGAファイルを生成します.
+//
+//      format  : 1(インデックスカラー), 2(フルカラー), 3(グレースケール). +8 でRLE圧縮になります.
+//      bpp     : 8, 16, 24, 32.
+//-------------------------------------------------------------------------------------------------
+std::vector<uint8_t> MakeTGA(uint32_t size, uint32_t seed, uint32_t format, uint32_t bpp)
+{
+    auto image      = MakeImage(size, size, seed);
+    auto isRLE      = (format & 0x8) != 0;
+    auto type       = format & 0x7;
+    auto pixelBytes = bpp / 8;
+    auto alphaBits  = (bpp == 32) ? 8u : (bpp == 16 && type == 2) ? 1u : 0u;
+
+    Writer w;
+    w.U8(0);                                // IdFieldLength
+    w.U8((type == 1) ? 1 : 0);              // HasColorMap
+    w.U8(format);
+    w.U16(0);                               // ColorMapEntry
+    w.U16((type == 1) ? 256 : 0);           // ColorMapLength
+    w.U8((type == 1) ? 24 : 0);             // ColorMapEntrySize
+    w.U16(0);
+    w.U16(0);
+    w.U16(size);
+    w.U16(size);
+    w.U8(bpp);
+    w.U8(0x20 | alphaBits);                 // 上から下へ格納.
+
+    if (type == 1)
+    {
+        for(auto i=0u; i<256; ++i)
+        {
+            uint8_t r, g, b;
+            FromIndex332(i, r, g, b);
+            w.U8(b);
+            w.U8(g);
+            w.U8(r);
+        }
+    }
+
+    // ピクセルを格納形式に変換する.
+    std::vector<uint8_t> pixels(size_t(size) * size * pixelBytes);
+    for(size_t i=0; i<size_t(size) * size; ++i)
+    {
+        auto src = &image[i * 4];
+        auto dst = &pixels[i * pixelBytes];
+        if (type == 1)
+        { dst[0] = ToIndex332(src); }
+        else if (type == 3)
+        {
+            dst[0] = ToLuminance(src);
+            if (bpp == 16)
+            { dst[1] = src[3]; }
+        }
+        else if (bpp == 16)
+        {
+            auto value = ((src[0] >> 3) << 10) | ((src[1] >> 3) << 5) | (src[2] >> 3) | ((src[3] & 0x80) << 8);
+            dst[0] = uint8_t(value & 0xFF);
+            dst[1] = uint8_t(value >> 8);
+        }
+        else
+        {
+            dst[0] = src[2];
+            dst[1] = src[1];
+            dst[2] = src[0];
+            if (bpp == 32)
+            { dst[3] = src[3]; }
+        }
+    }
+
+    if (!isRLE)
+    { w.Bytes(pixels.data(), pixels.size()); }
+    else
+    {
+        // 行をまたがないようにパケットを作る.
+        for(auto y=0u; y<size; ++y)
+        {
+            auto row = &pixels[size_t(y) * size * pixelBytes];
+            auto x   = 0u;
+            while(x < size)
+            {
+                auto run = 1u;
+                while(x + run < size && run < 128 && memcmp(row + (x + run) * pixelBytes, row + x * pixelBytes, pixelBytes) == 0)
+                { run++; }
+
+                if (run >= 2)
+                {
+                    w.U8(0x80 | (run - 1));
+                    w.Bytes(row + x * pixelBytes, pixelBytes);
+                    x += run;
+                    continue;
+                }
+
+                // 次のランが始まるまでを生パケットにする.
+                auto count = 1u;
+                while(x + count < size && count < 128)
+                {
+                    auto next = row + (x + count) * pixelBytes;
+                    if (x + count + 1 < size && memcmp(next, next + pixelBytes, pixelBytes) == 0)
+                    { break; }
+                    count++;
+                }
+
+                w.U8(count - 1);
+                w.Bytes(row + x * pixelBytes, count * pixelBytes);
+                x += count;
+            }
+        }
+    }
+
+    // フッター.
+    w.U32(0);
+    w.U32(0);
+    w.Bytes("TRUEVISION-XFILE.", 18);
+
+    return w.Data;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BMPのRLE圧縮行を書き出します.
+//-------------------------------------------------------------------------------------------------
+void WriteBmpRLERow(Writer& w, const uint8_t* pIndices, uint32_t width, bool isRLE4)
+{
+    auto x = 0u;
+    while(x < width)
+    {
+        auto run = 1u;
+        while(x + run < width && run < 255 && pIndices[x + run] == pIndices[x])
+        { run++; }
+
+        // 次のランが始まるまでの長さ.
+        auto count = 1u;
+        while(x + count < width && count < 255)
+        {
+            if (x + count + 1 < width && pIndices[x + count] == pIndices[x + count + 1])
+            { break; }
+            count++;
+        }
+
+        if (run >= 2 || count < 3)
+        {
+            // 符号化モード. RLE4は2つのインデックスを交互に並べる形式だが，同色のみ使う.
+            w.U8(run);
+            w.U8(isRLE4 ? (pIndices[x] << 4) | pIndices[x] : pIndices[x]);
+            x += run;
+            continue;
+        }
+
+        // 絶対モード. データは2byte境界に揃える.
+        w.U8(0);
+        w.U8(count);
+        auto bytes = 0u;
+        if (isRLE4)
+        {
+            for(auto i=0u; i<count; i+=2, bytes++)
+            {
+                auto hi = pIndices[x + i];
+                auto lo = (i + 1 < count) ? pIndices[x + i + 1] : 0;
+                w.U8((hi << 4) | lo);
+            }
+        }
+        else
+        {
+            w.Bytes(pIndices + x, count);
+            bytes = count;
+        }
+
+        if (bytes & 1)
+        { w.U8(0); }
+
+        x += count;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BMPファイルを生成します.
+//
+//      bpp         : 1, 4, 8, 24, 32.
+//      compression : 0(BI_RGB), 1(BI_RLE8), 2(BI_RLE4).
+//-------------------------------------------------------------------------------------------------
+std::vector<uint8_t> MakeBMP(uint32_t size, uint32_t seed, uint32_t bpp, uint32_t compression)
+{
+    auto image      = MakeImage(size, size, seed);
+    auto colorCount = (bpp <= 8) ? (1u << bpp) : 0u;
+    auto stride     = ((size * bpp + 31) / 32) * 4;
+    auto offset     = 14u + 40u + colorCount * 4;
+
+    Writer body;
+    std::vector<uint8_t> indices(size);
+
+    // 下から上へ格納する.
+    for(auto y=size; y-- > 0;)
+    {
+        auto src = &image[size_t(y) * size * 4];
+        if (bpp > 8)
+        {
+            auto start = body.Data.size();
+            for(auto x=0u; x<size; ++x, src+=4)
+            {
+                body.U8(src[2]);
+                body.U8(src[1]);
+                body.U8(src[0]);
+                if (bpp == 32)
+                { body.U8(src[3]); }
+            }
+            while(body.Data.size() - start < stride)
+            { body.U8(0); }
+            continue;
+        }
+
+        for(auto x=0u; x<size; ++x, src+=4)
+        {
+            switch(bpp)
+            {
+            case 1:  indices[x] = (ToLuminance(src) >= 128) ? 1 : 0; break;
+            case 4:  indices[x] = ToLuminance(src) >> 4; break;
+            default: indices[x] = ToIndex332(src); break;
+            }
+        }
+
+        if (compression != 0)
+        {
+            WriteBmpRLERow(body, indices.data(), size, compression == 2);
+            body.U8(0);
+            body.U8(0);     // 行末.
+            continue;
+        }
+
+        std::vector<uint8_t> row(stride, 0);
+        auto perByte = 8 / bpp;
+        for(auto x=0u; x<size; ++x)
+        {
+            auto shift = 8 - bpp * (x % perByte + 1);
+            row[x / perByte] |= uint8_t(indices[x] << shift);
+        }
+        body.Bytes(row.data(), row.size());
+    }
+
+    if (compression != 0)
+    {
+        // 最後の行末をビットマップの終端に置き換える.
+        body.Data.back() = 1;
+    }
+
+    Writer w;
+    w.Text("BM");
+    w.U32(offset + uint32_t(body.Data.size()));
+    w.U32(0);
+    w.U32(offset);
+
+    w.U32(40);
+    w.U32(size);
+    w.U32(size);
+    w.U16(1);
+    w.U16(bpp);
+    w.U32(compression);
+    w.U32(uint32_t(body.Data.size()));
+    w.U32(2835);
+    w.U32(2835);
+    w.U32(colorCount);
+    w.U32(0);
+
+    for(auto i=0u; i<colorCount; ++i)
+    {
+        uint8_t r, g, b;
+        if (bpp == 8)
+        { FromIndex332(i, r, g, b); }
+        else
+        { r = g = b = uint8_t(i * 255 / (colorCount - 1)); }
+
+        w.U8(b);
+        w.U8(g);
+        w.U8(r);
+        w.U8(0);
+    }
+
+    w.Bytes(body.Data.data(), body.Data.size());
+    return w.Data;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      HDRファイルを生成します.
+//
+//      mode : 0(非圧縮), 1(旧RLE), 2(新RLE).
+//-------------------------------------------------------------------------------------------------
+std::vector<uint8_t> MakeHDR(uint32_t size, uint32_t seed, uint32_t mode)
+{
+    auto image = MakeImage(size, size, seed);
+
+    // 適当なダイナミックレンジを持たせて RGBE にする.
+    std::vector<uint8_t> rgbe(image.size());
+    for(size_t i=0; i<image.size(); i+=4)
+    {
+        float color[3];
+        for(auto c=0; c<3; ++c)
+        { color[c] = powf(image[i + c] / 255.0f, 2.2f) * (1.0f + image[i + 3] / 16.0f); }
+
+        auto m = color[0];
+        if (color[1] > m) { m = color[1]; }
+        if (color[2] > m) { m = color[2]; }
+
+        if (m < 1e-32f)
+        {
+            rgbe[i + 0] = rgbe[i + 1] = rgbe[i + 2] = rgbe[i + 3] = 0;
+            continue;
+        }
+
+        int e;
+        auto scale = frexpf(m, &e) * 256.0f / m;
+        rgbe[i + 0] = uint8_t(color[0] * scale);
+        rgbe[i + 1] = uint8_t(color[1] * scale);
+        rgbe[i + 2] = uint8_t(color[2] * scale);
+        rgbe[i + 3] = uint8_t(e + 128);
+    }
+
+    Writer w;
+    w.Text("#?RADIANCE\n");
+    w.Text("FORMAT=32-bit_rle_rgbe\n");
+    w.Text("\n");
+
+    char resolution[64];
+    sprintf_s(resolution, "-Y %u +X %u\n", size, size);
+    w.Text(resolution);
+
+    for(auto y=0u; y<size; ++y)
+    {
+        auto row = &rgbe[size_t(y) * size * 4];
+
+        if (mode == 0)
+        {
+            w.Bytes(row, size * 4);
+        }
+        else if (mode == 1)
+        {
+            // 旧形式は (1, 1, 1, n) で直前のピクセルの繰り返しを表す.
+            auto x = 0u;
+            while(x < size)
+            {
+                w.Bytes(row + x * 4, 4);
+
+                auto run = 0u;
+                while(x + 1 + run < size && run < 255 && memcmp(row + (x + 1 + run) * 4, row + x * 4, 4) == 0)
+                { run++; }
+
+                if (run > 0)
+                {
+                    w.U8(1);
+                    w.U8(1);
+                    w.U8(1);
+                    w.U8(run);
+                }
+
+                x += 1 + run;
+            }
+        }
+        else
+        {
+            // 新形式はチャンネルごとにランレングス圧縮する.
+            w.U8(2);
+            w.U8(2);
+            w.U8(size >> 8);
+            w.U8(size & 0xFF);
+
+            for(auto c=0u; c<4; ++c)
+            {
+                auto x = 0u;
+                while(x < size)
+                {
+                    auto run = 1u;
+                    while(x + run < size && run < 127 && row[(x + run) * 4 + c] == row[x * 4 + c])
+                    { run++; }
+
+                    if (run >= 4)
+                    {
+                        w.U8(128 + run);
+                        w.U8(row[x * 4 + c]);
+                        x += run;
+                        continue;
+                    }
+
+                    auto count = 0u;
+                    while(x + count < size && count < 128)
+                    {
+                        auto value = row[(x + count) * 4 + c];
+                        auto next  = 1u;
+                        while(x + count + next < size && next < 4 && row[(x + count + next) * 4 + c] == value)
+                        { next++; }
+
+                        if (next >= 4)
+                        { break; }
+
+                        count++;
+                    }
+
+                    w.U8(count);
+                    for(auto i=0u; i<count; ++i)
+                    { w.U8(row[(x + i) * 4 + c]); }
+                    x += count;
+                }
+            }
+        }
+    }
+
+    return w.Data;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルを生成します.
+//
+//      surfaceCount 枚(キューブマップは面ごと)のサーフェイスに，それぞれミップマップを最後まで格納します.
+//-------------------------------------------------------------------------------------------------
+std::vector<uint8_t> MakeDDS
+(
+    uint32_t    width,
+    uint32_t    height,
+    uint32_t    depth,
+    uint32_t    arraySize,
+    bool        isCube,
+    bool        isBC1,
+    uint32_t    seed
+)
+{
+    auto mipCount = 1u;
+    {
+        auto extent = (width > height) ? width : height;
+        if (depth > extent)
+        { extent = depth; }
+        while((extent >> mipCount) > 0)
+        { mipCount++; }
+    }
+
+    DDS_HEADER header = {};
+    header.Size             = sizeof(DDS_HEADER);
+    header.Flags            = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT;
+    header.Height           = height;
+    header.Width            = width;
+    header.MipMapCount      = mipCount;
+    header.PixelFormatSize  = 32;
+    header.PixelFormatFlags = DDPF_FOURCC;
+    header.FourCC           = isBC1 ? FOURCC_DXT1 : FOURCC_DX10;
+    header.Caps             = DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX;
+
+    DDS_HEADER_DX10 ext = {};
+    ext.DxgiFormat        = DXGI_FORMAT_R8G8B8A8_UNORM;
+    ext.ResourceDimension = DDS_DIMENSION_TEXTURE2D;
+    ext.ArraySize         = arraySize;
+
+    if (depth > 1)
+    {
+        header.Flags |= DDSD_DEPTH;
+        header.Depth  = depth;
+        header.Caps2  = DDSCAPS2_VOLUME;
+        ext.ResourceDimension = DDS_DIMENSION_TEXTURE3D;
+    }
+    else if (isCube)
+    {
+        header.Caps2 = DDSCAPS2_CUBEMAP_ALL;
+        ext.MiscFlag = DDS_MISC_TEXTURECUBE;
+    }
+
+    Writer w;
+    w.U32(DDS_MAGIC);
+    w.Bytes(&header, sizeof(header));
+    if (!isBC1)
+    { w.Bytes(&ext, sizeof(ext)); }
+
+    auto surfaceCount = arraySize * (isCube ? 6 : 1);
+    Random random(seed);
+
+    for(auto s=0u; s<surfaceCount; ++s)
+    {
+        for(auto m=0u; m<mipCount; ++m)
+        {
+            auto w0 = (width  >> m) ? (width  >> m) : 1;
+            auto h0 = (height >> m) ? (height >> m) : 1;
+            auto d0 = (depth  >> m) ? (depth  >> m) : 1;
+
+            size_t bytes = 0;
+            if (isBC1)
+            { bytes = size_t((w0 + 3) / 4) * ((h0 + 3) / 4) * 8; }
+            else
+            { bytes = size_t(w0) * h0 * d0 * 4; }
+
+            if (isBC1)
+            {
+                for(size_t i=0; i<bytes; i+=4)
+                { w.U32(random.Next()); }
+            }
+            else
+            {
+                // ボリュームテクスチャはスライスを縦に並べた画像として扱う.
+                auto image = MakeImage(w0, h0 * d0, seed + s * 16 + m);
+                w.Bytes(image.data(), bytes);
+            }
+        }
+    }
+
+    return w.Data;
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      ベンチマーク用の画像ファイル群を生成します.
+//-------------------------------------------------------------------------------------------------
+bool GenerateCorpus(const std::wstring& directory, uint32_t size, std::vector<CORPUS_FILE>& result)
+{
+    if (directory.empty() || size < 8 || size > 0x7FFF)
+    {
+        ELOG("Error : Invalid Argument. size = %u", size);
+        return false;
+    }
+
+    if (!CreateDirectoryW(directory.c_str(), nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)
+    {
+        ELOGW("Error : CreateDirectory() Failed. path = %s", directory.c_str());
+        return false;
+    }
+
+    result.clear();
+
+    struct TGA_ENTRY { const char* Name; uint32_t Format; uint32_t Bpp; };
+    static const TGA_ENTRY kTGA[] = {
+        { "tga_index8.tga",         1,  8 },
+        { "tga_rgb16.tga",          2, 16 },
+        { "tga_rgb24.tga",          2, 24 },
+        { "tga_rgba32.tga",         2, 32 },
+        { "tga_gray8.tga",          3,  8 },
+        { "tga_gray16.tga",         3, 16 },
+        { "tga_rle_index8.tga",     9,  8 },
+        { "tga_rle_rgb16.tga",     10, 16 },
+        { "tga_rle_rgb24.tga",     10, 24 },
+        { "tga_rle_rgba32.tga",    10, 32 },
+        { "tga_rle_gray8.tga",     11,  8 },
+        { "tga_rle_gray16.tga",    11, 16 },
+    };
+
+    struct BMP_ENTRY { const char* Name; uint32_t Bpp; uint32_t Compression; };
+    static const BMP_ENTRY kBMP[] = {
+        { "bmp_index1.bmp",     1, 0 },
+        { "bmp_index4.bmp",     4, 0 },
+        { "bmp_index8.bmp",     8, 0 },
+        { "bmp_rgb24.bmp",     24, 0 },
+        { "bmp_rgb32.bmp",     32, 0 },
+        { "bmp_rle4.bmp",       4, 2 },
+        { "bmp_rle8.bmp",       8, 1 },
+    };
+
+    struct HDR_ENTRY { const char* Name; uint32_t Mode; };
+    static const HDR_ENTRY kHDR[] = {
+        { "hdr_flat.hdr",       0 },
+        { "hdr_old_rle.hdr",    1 },
+        { "hdr_new_rle.hdr",    2 },
+    };
+
+    auto seed = 1u;
+    for(auto& entry : kTGA)
+    {
+        if (!SaveFile(directory, entry.Name, "tga", MakeTGA(size, seed++, entry.Format, entry.Bpp), result))
+        { return false; }
+    }
+
+    for(auto& entry : kBMP)
+    {
+        if (!SaveFile(directory, entry.Name, "bmp", MakeBMP(size, seed++, entry.Bpp, entry.Compression), result))
+        { return false; }
+    }
+
+    for(auto& entry : kHDR)
+    {
+        if (!SaveFile(directory, entry.Name, "hdr", MakeHDR(size, seed++, entry.Mode), result))
+        { return false; }
+    }
+
+    auto half   = size / 2;
+    auto volume = (size / 8 > 0) ? size / 8 : 1;
+
+    if (!SaveFile(directory, "dds_2d_mips.dds",     "dds", MakeDDS(size, size,   1,      1, false, false, seed++), result)
+     || !SaveFile(directory, "dds_2d_bc1_mips.dds", "dds", MakeDDS(size, size,   1,      1, false, true,  seed++), result)
+     || !SaveFile(directory, "dds_array.dds",       "dds", MakeDDS(half, half,   1,      4, false, false, seed++), result)
+     || !SaveFile(directory, "dds_cube.dds",        "dds", MakeDDS(half, half,   1,      1, true,  false, seed++), result)
+     || !SaveFile(directory, "dds_volume.dds",      "dds", MakeDDS(volume, volume, volume, 1, false, false, seed++), result))
+    { return false; }
+
+    return true;
+}
@@ -0,0 +1,216 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : HalfBench.cpp
+// Desc : Half Conversion Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <HalfBench.h>
+#include <asdxMath.h>
+#include <asdxPixelKernel.h>
+#include <asdxStopWatch.h>
+#include <asdxLogger.h>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kHalfCount      = 65536;        // half型で表現できる値の数です.
+static const uint32_t   kRandomCount    = 1 << 20;      // 検証に使う乱数ビット列の数です.
+static const uint32_t   kBenchCount     = 1 << 20;      // 速度計測で1回に変換する要素数です.
+static const uint32_t   kRandomSeed     = 12345;        // 乱数の種です.
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// LEVEL_ENTRY structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct LEVEL_ENTRY
+{
+    asdx::SIMD_LEVEL    Level;  //!< SIMDレベルです.
+    const char*         Name;   //!< 名前です.
+};
+
+// AVX2が使える環境ではF16C命令で変換する.
+static const LEVEL_ENTRY kLevels[] = {
+    { asdx::SIMD_LEVEL_SCALAR,  "scalar" },
+    { asdx::SIMD_LEVEL_SSE2,    "sse2"   },
+    { asdx::SIMD_LEVEL_AVX2,    "f16c"   },
+};
+
+//-------------------------------------------------------------------------------------------------
+//      floatのビット列を取得します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t ToBits(float value)
+{
+    uint32_t result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ビット列からfloatを生成します.
+//-------------------------------------------------------------------------------------------------
+inline float FromBits(uint32_t bits)
+{
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      検証に使うfloat値を生成します.
+//-------------------------------------------------------------------------------------------------
+void MakeFloatInputs(std::vector<float>& result)
+{
+    result.clear();
+    result.reserve(kHalfCount * 4 + kRandomCount);
+
+    // 全てのhalf値と，隣の値との中間値(偶数丸めの境界)，中間値の前後1ulp.
+    for(uint32_t i=0; i<kHalfCount; ++i)
+    {
+        auto value = asdx::halfTofloat(asdx::half(i));
+        result.push_back(value);
+
+        if ((i & 0x7FFF) >= 0x7BFF)
+        { continue; }
+
+        auto next = asdx::halfTofloat(asdx::half(i + 1));
+        auto mid  = ToBits((value + next) * 0.5f);
+        result.push_back(FromBits(mid));
+        result.push_back(FromBits(mid - 1));
+        result.push_back(FromBits(mid + 1));
+    }
+
+    // 固定の種による乱数ビット列(NaN, 非正規化数を含む).
+    std::mt19937 rng(kRandomSeed);
+    for(uint32_t i=0; i<kRandomCount; ++i)
+    { result.push_back(FromBits(rng())); }
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      配列版の半精度浮動小数変換を検証します.
+//-------------------------------------------------------------------------------------------------
+bool VerifyHalfConversion()
+{
+    std::vector<asdx::half> halfs(kHalfCount);
+    for(uint32_t i=0; i<kHalfCount; ++i)
+    { halfs[i] = asdx::half(i); }
+
+    std::vector<float> floats;
+    MakeFloatInputs(floats);
+
+    auto prevLevel = asdx::GetSimdLevel();
+    auto success   = true;
+
+    // スカラー版自体が最近接偶数丸めになっていることを確認する.
+    for(uint32_t i=0; i<0x7BFF; ++i)
+    {
+        auto mid    = (asdx::halfTofloat(asdx::half(i)) + asdx::halfTofloat(asdx::half(i + 1))) * 0.5f;
+        auto expect = asdx::half((i & 1) ? i + 1 : i);
+        if (asdx::floatTohalf(mid) != expect)
+        {
+            ELOGA("Error : Round To Nearest Even Failed. half = 0x%04x", i);
+            success = false;
+            break;
+        }
+    }
+
+    std::vector<float>      resultF(kHalfCount);
+    std::vector<asdx::half> resultH(floats.size());
+
+    for(auto& entry : kLevels)
+    {
+        asdx::SetSimdLevel(entry.Level);
+        if (asdx::GetSimdLevel() != entry.Level)
+        { continue; }
+
+        asdx::halfTofloat(halfs.data(), resultF.data(), halfs.size());
+        for(uint32_t i=0; i<kHalfCount; ++i)
+        {
+            if (ToBits(resultF[i]) != ToBits(asdx::halfTofloat(halfs[i])))
+            {
+                ELOGA("Error : halfTofloat() Mismatch. level = %s, half = 0x%04x", entry.Name, i);
+                success = false;
+                break;
+            }
+        }
+
+        asdx::floatTohalf(floats.data(), resultH.data(), floats.size());
+        for(size_t i=0; i<floats.size(); ++i)
+        {
+            if (resultH[i] != asdx::floatTohalf(floats[i]))
+            {
+                ELOGA("Error : floatTohalf() Mismatch. level = %s, float = 0x%08x", entry.Name, ToBits(floats[i]));
+                success = false;
+                break;
+            }
+        }
+    }
+
+    asdx::SetSimdLevel(prevLevel);
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      配列版の半精度浮動小数変換の速度を計測します.
+//-------------------------------------------------------------------------------------------------
+void RunHalfBenchmark(uint32_t iterations, std::vector<HALF_BENCH_RESULT>& result)
+{
+    result.clear();
+
+    // HDRの画素値程度の範囲で値を用意する.
+    std::vector<float>      floats(kBenchCount);
+    std::vector<asdx::half> halfs (kBenchCount);
+    std::mt19937 rng(kRandomSeed);
+    std::uniform_real_distribution<float> dist(-16.0f, 16.0f);
+    for(auto& value : floats)
+    { value = std::exp2(dist(rng)); }
+
+    auto prevLevel = asdx::GetSimdLevel();
+
+    for(auto& entry : kLevels)
+    {
+        asdx::SetSimdLevel(entry.Level);
+        if (asdx::GetSimdLevel() != entry.Level)
+        { continue; }
+
+        // 1回目はキャッシュを温めるために計測しない.
+        asdx::floatTohalf(floats.data(), halfs.data(), kBenchCount);
+        asdx::halfTofloat(halfs.data(), floats.data(), kBenchCount);
+
+        HALF_BENCH_RESULT item = {};
+        item.Level = entry.Name;
+
+        asdx::StopWatch watch;
+        watch.Start();
+        for(auto i=0u; i<iterations; ++i)
+        { asdx::floatTohalf(floats.data(), halfs.data(), kBenchCount); }
+        watch.End();
+
+        auto sec = watch.GetElapsedSec();
+        if (sec > 0.0)
+        { item.ToHalfPerSec = double(kBenchCount) * iterations / sec; }
+
+        watch.Start();
+        for(auto i=0u; i<iterations; ++i)
+        { asdx::halfTofloat(halfs.data(), floats.data(), kBenchCount); }
+        watch.End();
+
+        sec = watch.GetElapsedSec();
+        if (sec > 0.0)
+        { item.ToFloatPerSec = double(kBenchCount) * iterations / sec; }
+
+        result.push_back(item);
+    }
+
+    asdx::SetSimdLevel(prevLevel);
+}
@@ -0,0 +1,233 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : TraceBench.cpp
+// Desc : Cache Trace Replay Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <TraceBench.h>
+#include <asdxLfuCache.h>
+#include <asdxLruCache.h>
+#include <asdxTinyLfuCache.h>
+#include <asdxStopWatch.h>
+#include <asdxLogger.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kHotCount       = 4096;     // よく使うアセットの数です.
+static const double     kZipfExponent   = 0.8;      // よく使うアセットへのアクセスの偏り(Zipf分布の指数)です.
+static const uint32_t   kRoundCount     = 32;       // フォルダを走査する回数です.
+static const uint32_t   kHotAccessCount = 16384;    // 走査の合間のアクセス数です.
+static const uint32_t   kScanLength     = 4096;     // 1回の走査で開くアセットの数です.
+static const uint32_t   kRandomSeed     = 12345;    // 乱数の種です.
+
+// キーの種類数に対する最大収容可能数の割合(%).
+static const uint32_t kCapacityPercents[] = { 1, 5, 10, 25 };
+
+//-------------------------------------------------------------------------------------------------
+//      トレースを1つの追い出し方針で再生します.
+//-------------------------------------------------------------------------------------------------
+template<typename Cache>
+TRACE_BENCH_RESULT Replay
+(
+    const char*     policy,
+    const TRACE&    trace,
+    uint32_t        capacity,
+    uint32_t        iterations
+)
+{
+    TRACE_BENCH_RESULT item = {};
+    item.Policy     = policy;
+    item.Capacity   = capacity;
+    item.Operations = trace.Keys.size();
+
+    uint64_t hits = 0;
+    double   sec  = 0.0;
+
+    for(auto i=0u; i<iterations; ++i)
+    {
+        // キャッシュの確保は計測に含めない.
+        Cache cache(capacity);
+        hits = 0;
+
+        asdx::StopWatch watch;
+        watch.Start();
+        for(auto key : trace.Keys)
+        {
+            if (cache.Find(key) != nullptr)
+            { hits++; }
+            else
+            { cache.Add(key, key); }
+        }
+        watch.End();
+
+        sec += watch.GetElapsedSec();
+        item.MemoryBytes = cache.GetMemorySize();
+    }
+
+    if (item.Operations > 0)
+    { item.HitRatio = double(hits) / double(item.Operations); }
+
+    if (sec > 0.0)
+    { item.OpsPerSec = double(item.Operations) * iterations / sec; }
+
+    if (capacity > 0)
+    { item.BytesPerEntry = double(item.MemoryBytes) / capacity; }
+
+    return item;
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      記録したアクセス列を読み込みます.
+//-------------------------------------------------------------------------------------------------
+bool LoadTrace(const std::wstring& path, TRACE& result)
+{
+    FILE* pFile = nullptr;
+    auto err = _wfopen_s(&pFile, path.c_str(), L"rb");
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOGW("Error : File Open Failed. path = %s", path.c_str());
+        return false;
+    }
+
+    result.Name     = "file";
+    result.KeyCount = 0;
+    result.Keys.clear();
+
+    // キーの文字列は出現順の番号に置き換えて，再生時の比較を軽くする.
+    std::unordered_map<std::string, uint32_t> ids;
+    std::string line;
+
+    auto append = [&]()
+    {
+        while(!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t'))
+        { line.pop_back(); }
+
+        if (!line.empty() && line[0] != '#')
+        {
+            auto itr = ids.find(line);
+            if (itr == ids.end())
+            { itr = ids.insert(std::make_pair(line, uint32_t(ids.size()))).first; }
+
+            result.Keys.push_back(itr->second);
+        }
+
+        line.clear();
+    };
+
+    char buffer[4096];
+    size_t size;
+    while((size = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+    {
+        for(size_t i=0; i<size; ++i)
+        {
+            if (buffer[i] == '\n')
+            { append(); }
+            else
+            { line.push_back(buffer[i]); }
+        }
+    }
+    append();
+
+    fclose(pFile);
+
+    result.KeyCount = uint32_t(ids.size());
+    if (result.Keys.empty())
+    {
+        ELOGW("Error : Trace is Empty. path = %s", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アセットブラウザを模したアクセス列を生成します.
+//-------------------------------------------------------------------------------------------------
+void MakeBrowserTrace(TRACE& result)
+{
+    result.Name = "browser";
+    result.Keys.clear();
+    result.Keys.reserve(kRoundCount * (kHotAccessCount + kScanLength));
+
+    // よく使うアセットはZipf分布で選ぶ.
+    std::vector<double> cdf(kHotCount);
+    auto sum = 0.0;
+    for(auto i=0u; i<kHotCount; ++i)
+    {
+        sum += 1.0 / std::pow(double(i + 1), kZipfExponent);
+        cdf[i] = sum;
+    }
+
+    std::mt19937 rng(kRandomSeed);
+    std::uniform_real_distribution<double> dist(0.0, sum);
+
+    // 走査するアセットは毎回新しいキーにする.
+    auto scanKey = kHotCount;
+
+    for(auto round=0u; round<kRoundCount; ++round)
+    {
+        for(auto i=0u; i<kHotAccessCount; ++i)
+        {
+            auto itr = std::lower_bound(cdf.begin(), cdf.end(), dist(rng));
+            auto key = uint32_t(std::min<ptrdiff_t>(itr - cdf.begin(), kHotCount - 1));
+            result.Keys.push_back(key);
+        }
+
+        for(auto i=0u; i<kScanLength; ++i)
+        { result.Keys.push_back(scanKey++); }
+    }
+
+    result.KeyCount = scanKey;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キーの種類数に対する割合から最大収容可能数を決めます.
+//-------------------------------------------------------------------------------------------------
+void GetTraceCapacities(const TRACE& trace, std::vector<uint32_t>& result)
+{
+    result.clear();
+    for(auto percent : kCapacityPercents)
+    {
+        auto capacity = std::max(uint32_t(uint64_t(trace.KeyCount) * percent / 100), 1u);
+
+        // キーの種類が少ない場合は同じ値が続くので1つにまとめる.
+        if (result.empty() || result.back() != capacity)
+        { result.push_back(capacity); }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      トレースを3つの追い出し方針で再生します.
+//-------------------------------------------------------------------------------------------------
+void RunTraceBenchmark
+(
+    const TRACE&                        trace,
+    const std::vector<uint32_t>&        capacities,
+    uint32_t                            iterations,
+    std::vector<TRACE_BENCH_RESULT>&    result
+)
+{
+    result.clear();
+
+    for(auto capacity : capacities)
+    {
+        result.push_back(Replay<asdx::LruCache    <uint32_t, uint32_t>>("lru",     trace, capacity, iterations));
+        result.push_back(Replay<asdx::LfuCache    <uint32_t, uint32_t>>("lfu",     trace, capacity, iterations));
+        result.push_back(Replay<asdx::TinyLfuCache<uint32_t, uint32_t>>("tinylfu", trace, capacity, iterations));
+    }
+}
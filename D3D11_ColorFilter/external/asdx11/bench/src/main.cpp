@@ -0,0 +1,745 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Texture Loader Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <AtlasBench.h>
+#include <BCBench.h>
+#include <CacheBench.h>
+#include <ConcurrentCacheBench.h>
+#include <Corpus.h>
+#include <HalfBench.h>
+#include <TraceBench.h>
+#include <asdxResTexture.h>
+#include <asdxResTextureAllocator.h>
+#include <asdxBCDecoder.h>
+#include <asdxStopWatch.h>
+#include <asdxLogger.h>
+#include <Windows.h>
+#include <Psapi.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+//-------------------------------------------------------------------------------------------------
+// Linker
+//-------------------------------------------------------------------------------------------------
+#pragma comment(lib, "psapi.lib")
+#pragma comment(lib, "ole32.lib")
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const size_t     kAllocHeaderSize    = 16;       // 確保サイズを記録するヘッダです(アライメントを保つため16byte).
+static const uint32_t   kDefaultSize        = 512;      // 既定の画像サイズです.
+static const uint32_t   kDefaultIterations  = 8;        // 既定の計測回数です.
+
+//-------------------------------------------------------------------------------------------------
+// Global Variables.
+//-------------------------------------------------------------------------------------------------
+std::atomic<uint64_t>   g_AllocCount(0);    // operator new の呼び出し回数です.
+std::atomic<uint64_t>   g_AllocBytes(0);    // operator new で確保した総バイト数です.
+std::atomic<uint64_t>   g_LiveBytes(0);     // 確保中のバイト数です.
+std::atomic<uint64_t>   g_PeakBytes(0);     // 確保中のバイト数の最大値です.
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TIMING structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TIMING
+{
+    double  Seconds;        //!< 1回あたりの読み込み時間(秒)です.
+    double  MBPerSec;       //!< ファイルサイズ基準のスループットです.
+    double  PixelsPerSec;   //!< 1秒あたりに生成したピクセル数です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RESULT structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct RESULT
+{
+    bool        Success;            //!< 読み込みに成功したかどうか.
+    uint32_t    Width;              //!< 横幅です.
+    uint32_t    Height;             //!< 縦幅です.
+    uint32_t    Depth;              //!< 奥行です.
+    uint32_t    SurfaceCount;       //!< サーフェイス数です.
+    uint32_t    MipMapCount;        //!< ミップマップ数です.
+    uint64_t    Pixels;             //!< 全サブリソースのピクセル数です.
+    TIMING      File;               //!< ファイルからの読み込み時間です.
+    TIMING      Memory;             //!< メモリからの読み込み時間です.
+    TIMING      MemoryArena;        //!< アリーナアロケータを使ったメモリからの読み込み時間です.
+    TIMING      Stream;             //!< ファイルから帯ごとに展開する時間です.
+    bool        CookSuccess;        //!< クックドテクスチャへの変換に成功したかどうか.
+    uint64_t    CookedBytes;        //!< クックドテクスチャのファイルサイズです.
+    TIMING      CookedFile;         //!< クックドテクスチャのファイルからの読み込み時間です.
+    TIMING      CookedMap;          //!< クックドテクスチャのファイルをマップする時間です.
+    double      AllocsPerLoad;      //!< 1回あたりの確保回数です.
+    double      AllocBytesPerLoad;  //!< 1回あたりの確保バイト数です.
+    uint64_t    PeakHeapBytes;      //!< 読み込み中に増えたヒープの最大値です.
+    bool        StreamSuccess;      //!< 帯ごとの展開に成功したかどうか.
+    bool        StreamMatch;        //!< 帯ごとの展開結果が読み込み結果の最上位ミップレベルと一致したかどうか.
+    uint64_t    StreamPeakHeapBytes;//!< 帯ごとの展開中に増えたヒープの最大値です.
+    uint64_t    PeakWorkingSet;     //!< この時点でのプロセスの最大ワーキングセットです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// NullSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class NullSink : public asdx::IImageSink
+{
+public:
+    bool OnBegin(const asdx::ImageStreamInfo&) override
+    { return true; }
+
+    bool OnBand(uint32_t, uint32_t, const uint8_t*, uint32_t) override
+    { return true; }
+
+    bool OnEnd() override
+    { return true; }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CompareSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class CompareSink : public asdx::IImageSink
+{
+public:
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!
+    //! @param[in]      texture     比較対象です. 最初のサーフェイスの最上位ミップレベルと比較します.
+    //---------------------------------------------------------------------------------------------
+    explicit CompareSink(const asdx::ResTexture& texture)
+    : m_Texture     (texture)
+    , m_RowsPerBlock(1)
+    , m_NextY       (0)
+    , m_Matched     (false)
+    { /* DO_NOTHING */ }
+
+    bool OnBegin(const asdx::ImageStreamInfo& info) override
+    {
+        auto& res = m_Texture.pResources[0];
+        if (info.Width != res.Width || info.Height != res.Height || info.Format != m_Texture.Format)
+        { return false; }
+
+        m_RowsPerBlock = (asdx::IsBlockCompressedFormat(info.Format)) ? 4 : 1;
+        m_NextY        = 0;
+        return true;
+    }
+
+    bool OnBand(uint32_t y, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch) override
+    {
+        auto& res = m_Texture.pResources[0];
+        if (y != m_NextY || pitch < res.Pitch)
+        { return false; }
+
+        auto rows = (rowCount + m_RowsPerBlock - 1) / m_RowsPerBlock;
+        auto pRef = res.pPixels + size_t(y / m_RowsPerBlock) * res.Pitch;
+        for(auto i=0u; i<rows; ++i)
+        {
+            if (memcmp(pRef + size_t(i) * res.Pitch, pPixels + size_t(i) * pitch, res.Pitch) != 0)
+            { return false; }
+        }
+
+        m_NextY += rowCount;
+        return true;
+    }
+
+    bool OnEnd() override
+    {
+        m_Matched = (m_NextY == m_Texture.pResources[0].Height);
+        return m_Matched;
+    }
+
+    bool IsMatched() const
+    { return m_Matched; }
+
+private:
+    const asdx::ResTexture&     m_Texture;      //!< 比較対象です.
+    uint32_t                    m_RowsPerBlock; //!< 1データ行あたりの行数です.
+    uint32_t                    m_NextY;        //!< 次に受け取る行です.
+    bool                        m_Matched;      //!< 一致したかどうか.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      確保を記録します.
+//-------------------------------------------------------------------------------------------------
+void* CountedAlloc(size_t size)
+{
+    auto ptr = static_cast<uint8_t*>(malloc(size + kAllocHeaderSize));
+    if (ptr == nullptr)
+    { throw std::bad_alloc(); }
+
+    *reinterpret_cast<size_t*>(ptr) = size;
+
+    g_AllocCount++;
+    g_AllocBytes += size;
+
+    auto live = (g_LiveBytes += size);
+    auto peak = g_PeakBytes.load();
+    while(live > peak && !g_PeakBytes.compare_exchange_weak(peak, live))
+    { /* DO_NOTHING */ }
+
+    return ptr + kAllocHeaderSize;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      解放を記録します.
+//-------------------------------------------------------------------------------------------------
+void CountedFree(void* ptr)
+{
+    if (ptr == nullptr)
+    { return; }
+
+    auto head = static_cast<uint8_t*>(ptr) - kAllocHeaderSize;
+    g_LiveBytes -= *reinterpret_cast<size_t*>(head);
+    free(head);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全サブリソースのピクセル数を求めます.
+//-------------------------------------------------------------------------------------------------
+uint64_t CountPixels(const asdx::ResTexture& texture)
+{
+    auto isVolume = (texture.Option & asdx::SUBRESOURCE_OPTION_VOLUME) != 0;
+    auto count    = texture.SurfaceCount * texture.MipMapCount;
+
+    uint64_t result = 0;
+    for(auto i=0u; i<count; ++i)
+    {
+        auto& res   = texture.pResources[i];
+        auto  mip   = i % texture.MipMapCount;
+        auto  depth = (isVolume && (texture.Depth >> mip) > 0) ? (texture.Depth >> mip) : 1u;
+        result += uint64_t(res.Width) * res.Height * depth;
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      プロセスの最大ワーキングセットを取得します.
+//-------------------------------------------------------------------------------------------------
+uint64_t GetPeakWorkingSet()
+{
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    { return 0; }
+
+    return counters.PeakWorkingSetSize;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      読み込み時間を計測します.
+//-------------------------------------------------------------------------------------------------
+template<typename Func>
+TIMING Measure(uint32_t iterations, uint64_t bytes, uint64_t pixels, Func func)
+{
+    asdx::StopWatch watch;
+    watch.Start();
+    for(auto i=0u; i<iterations; ++i)
+    { func(); }
+    watch.End();
+
+    TIMING result = {};
+    result.Seconds = watch.GetElapsedSec() / iterations;
+    if (result.Seconds > 0.0)
+    {
+        result.MBPerSec     = bytes / (1024.0 * 1024.0) / result.Seconds;
+        result.PixelsPerSec = pixels / result.Seconds;
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルを読み込みます.
+//-------------------------------------------------------------------------------------------------
+bool LoadBinary(const std::wstring& path, std::vector<uint8_t>& result)
+{
+    FILE* pFile = nullptr;
+    auto err = _wfopen_s(&pFile, path.c_str(), L"rb");
+    if (err != 0 || pFile == nullptr)
+    { return false; }
+
+    fseek(pFile, 0, SEEK_END);
+    auto size = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    result.resize(size_t(size));
+    auto count = fread(result.data(), 1, result.size(), pFile);
+    fclose(pFile);
+
+    return count == result.size();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1ファイル分のベンチマークを実行します.
+//-------------------------------------------------------------------------------------------------
+RESULT Run(const CORPUS_FILE& file, uint32_t iterations)
+{
+    RESULT result = {};
+
+    std::vector<uint8_t> binary;
+    if (!LoadBinary(file.Path, binary))
+    { return result; }
+
+    auto cookedPath = file.Path + L".atex";
+
+    // 1回目はキャッシュを温めつつ，確保回数とヒープの増分を調べる.
+    {
+        auto count = g_AllocCount.load();
+        auto bytes = g_AllocBytes.load();
+        auto base  = g_LiveBytes.load();
+        g_PeakBytes = base;
+
+        asdx::ResTexture texture;
+        result.Success = texture.LoadFromFileW(file.Path.c_str());
+
+        result.AllocsPerLoad     = double(g_AllocCount.load() - count);
+        result.AllocBytesPerLoad = double(g_AllocBytes.load() - bytes);
+        result.PeakHeapBytes     = g_PeakBytes.load() - base;
+
+        if (!result.Success)
+        { return result; }
+
+        result.Width        = texture.Width;
+        result.Height       = texture.Height;
+        result.Depth        = texture.Depth;
+        result.SurfaceCount = texture.SurfaceCount;
+        result.MipMapCount  = texture.MipMapCount;
+        result.Pixels       = CountPixels(texture);
+
+        // 帯ごとの展開は出力を保持しないので，ヒープの増分は帯のバッファ程度になる.
+        // ボリュームテクスチャは帯ごとの展開に対応しないので streamSuccess は false になる.
+        {
+            CompareSink sink(texture);
+
+            auto live = g_LiveBytes.load();
+            g_PeakBytes = live;
+
+            result.StreamSuccess       = asdx::StreamImageFromFileW(file.Path.c_str(), &sink);
+            result.StreamMatch         = result.StreamSuccess && sink.IsMatched();
+            result.StreamPeakHeapBytes = g_PeakBytes.load() - live;
+        }
+
+        // 読み込んだ結果をそのままクックドテクスチャに変換して，デコードを省いた読み込みと比べる.
+        std::vector<uint8_t> cooked;
+        result.CookSuccess = texture.SaveToCookedW(cookedPath.c_str()) && LoadBinary(cookedPath, cooked);
+        result.CookedBytes = cooked.size();
+
+        texture.Release();
+    }
+
+    result.File = Measure(iterations, file.Size, result.Pixels, [&]()
+    {
+        asdx::ResTexture texture;
+        texture.LoadFromFileW(file.Path.c_str());
+        texture.Release();
+    });
+
+    result.Memory = Measure(iterations, file.Size, result.Pixels, [&]()
+    {
+        asdx::ResTexture texture;
+        texture.LoadFromMemory(binary.data(), uint32_t(binary.size()));
+        texture.Release();
+    });
+
+    // テクスチャの確保をアリーナから切り出すだけにした場合.
+    {
+        asdx::ArenaResTextureAllocator arena;
+        asdx::SetResTextureAllocator(&arena);
+
+        result.MemoryArena = Measure(iterations, file.Size, result.Pixels, [&]()
+        {
+            asdx::ResTexture texture;
+            texture.LoadFromMemory(binary.data(), uint32_t(binary.size()));
+            texture.Release();
+            arena.Reset();
+        });
+
+        asdx::SetResTextureAllocator(nullptr);
+    }
+
+    if (result.StreamSuccess)
+    {
+        result.Stream = Measure(iterations, file.Size, result.Pixels, [&]()
+        {
+            NullSink sink;
+            asdx::StreamImageFromFileW(file.Path.c_str(), &sink);
+        });
+    }
+
+    if (result.CookSuccess)
+    {
+        result.CookedFile = Measure(iterations, result.CookedBytes, result.Pixels, [&]()
+        {
+            asdx::ResTexture texture;
+            texture.LoadFromFileW(cookedPath.c_str());
+            texture.Release();
+        });
+
+        // サブリソースはマップしたファイルを直接指すので，ピクセルデータはコピーしない.
+        result.CookedMap = Measure(iterations, result.CookedBytes, result.Pixels, [&]()
+        {
+            asdx::ResTexture texture;
+            texture.MapFromFileW(cookedPath.c_str());
+            texture.Release();
+        });
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      計測時間をJSONで出力します.
+//-------------------------------------------------------------------------------------------------
+void WriteTiming(FILE* pFile, const char* tag, const TIMING& timing)
+{
+    fprintf_s(pFile, "      \"%s\": { \"seconds\": %.9f, \"mbPerSec\": %.3f, \"pixelsPerSec\": %.1f },\n",
+        tag, timing.Seconds, timing.MBPerSec, timing.PixelsPerSec);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      トレースの再生結果をJSONで出力します.
+//-------------------------------------------------------------------------------------------------
+void WriteTraceReplay(FILE* pFile, const TRACE& trace, const std::vector<TRACE_BENCH_RESULT>& results)
+{
+    fprintf_s(pFile, "  \"traceReplay\": {\n");
+    fprintf_s(pFile, "    \"trace\": \"%s\",\n", trace.Name.c_str());
+    fprintf_s(pFile, "    \"operations\": %llu,\n", uint64_t(trace.Keys.size()));
+    fprintf_s(pFile, "    \"keyCount\": %u,\n", trace.KeyCount);
+    fprintf_s(pFile, "    \"results\": [\n");
+    for(size_t i=0; i<results.size(); ++i)
+    {
+        auto& item = results[i];
+        fprintf_s(pFile, "      { \"policy\": \"%s\", \"capacity\": %u, \"hitRatio\": %.4f, \"opsPerSec\": %.1f, \"memoryBytes\": %llu, \"bytesPerEntry\": %.1f }%s\n",
+            item.Policy, item.Capacity, item.HitRatio, item.OpsPerSec, item.MemoryBytes, item.BytesPerEntry, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf_s(pFile, "    ]\n");
+    fprintf_s(pFile, "  }");
+}
+
+//-------------------------------------------------------------------------------------------------
+//      出力ファイルを開きます. パスが空の場合は標準出力に出力します.
+//-------------------------------------------------------------------------------------------------
+bool OpenOutput(const std::wstring& output, FILE** ppFile)
+{
+    *ppFile = stdout;
+    if (output.empty())
+    { return true; }
+
+    auto err = _wfopen_s(ppFile, output.c_str(), L"w");
+    if (err != 0 || *ppFile == nullptr)
+    {
+        ELOGW("Error : File Open Failed. path = %s", output.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使用方法を表示します.
+//-------------------------------------------------------------------------------------------------
+void PrintUsage()
+{
+    fprintf_s(stderr,
+        "usage : asdx_bench [-dir <corpus directory>] [-size <pixels>] [-iter <count>] [-out <json file>]\n"
+        "        asdx_bench -trace <trace file> [-capacity <entries>] [-iter <count>] [-out <json file>]\n");
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      確保回数を数えるためにグローバルな new/delete を置き換えます.
+//      WIC など COM 内部の確保は数えられません.
+//-------------------------------------------------------------------------------------------------
+void* operator new   (size_t size)              { return CountedAlloc(size); }
+void* operator new[] (size_t size)              { return CountedAlloc(size); }
+void  operator delete  (void* ptr) noexcept     { CountedFree(ptr); }
+void  operator delete[](void* ptr) noexcept     { CountedFree(ptr); }
+
+
+//-------------------------------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-------------------------------------------------------------------------------------------------
+int wmain(int argc, wchar_t** argv)
+{
+    std::wstring directory;
+    std::wstring output;
+    std::wstring tracePath;
+    uint32_t     size       = kDefaultSize;
+    uint32_t     iterations = kDefaultIterations;
+    uint32_t     capacity   = 0;
+
+    for(auto i=1; i<argc; ++i)
+    {
+        std::wstring arg = argv[i];
+        auto hasValue = (i + 1 < argc);
+
+        if (arg == L"-dir" && hasValue)
+        { directory = argv[++i]; }
+        else if (arg == L"-size" && hasValue)
+        { size = uint32_t(_wtoi(argv[++i])); }
+        else if (arg == L"-iter" && hasValue)
+        { iterations = uint32_t(_wtoi(argv[++i])); }
+        else if (arg == L"-out" && hasValue)
+        { output = argv[++i]; }
+        else if (arg == L"-trace" && hasValue)
+        { tracePath = argv[++i]; }
+        else if (arg == L"-capacity" && hasValue)
+        { capacity = uint32_t(_wtoi(argv[++i])); }
+        else
+        {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    if (iterations == 0)
+    { iterations = 1; }
+
+    // 記録したトレースが指定された場合は，再生結果だけを出力する.
+    if (!tracePath.empty())
+    {
+        TRACE trace;
+        if (!LoadTrace(tracePath, trace))
+        {
+            ELOG("Error : LoadTrace() Failed.");
+            return -1;
+        }
+
+        std::vector<uint32_t> capacities;
+        if (capacity > 0)
+        { capacities.push_back(capacity); }
+        else
+        { GetTraceCapacities(trace, capacities); }
+
+        std::vector<TRACE_BENCH_RESULT> traceResults;
+        RunTraceBenchmark(trace, capacities, iterations, traceResults);
+
+        FILE* pFile = nullptr;
+        if (!OpenOutput(output, &pFile))
+        { return -1; }
+
+        fprintf_s(pFile, "{\n");
+        fprintf_s(pFile, "  \"iterations\": %u,\n", iterations);
+        WriteTraceReplay(pFile, trace, traceResults);
+        fprintf_s(pFile, "\n}\n");
+
+        if (pFile != stdout)
+        { fclose(pFile); }
+
+        return 0;
+    }
+
+    if (directory.empty())
+    {
+        wchar_t temp[MAX_PATH] = {};
+        GetTempPathW(MAX_PATH, temp);
+        directory = temp;
+        directory += L"asdx_bench";
+    }
+
+    if (directory.back() != L'\\' && directory.back() != L'/')
+    { directory += L'\\'; }
+
+    // WICを使う読み込みがあるので初期化しておく.
+    auto hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    if (FAILED(hr))
+    {
+        ELOG("Error : CoInitializeEx() Failed. errcode = 0x%x", hr);
+        return -1;
+    }
+
+    std::vector<CORPUS_FILE> corpus;
+    if (!GenerateCorpus(directory, size, corpus))
+    {
+        ELOG("Error : GenerateCorpus() Failed.");
+        CoUninitialize();
+        return -1;
+    }
+
+    std::vector<RESULT> results;
+    results.reserve(corpus.size());
+    for(auto& file : corpus)
+    {
+        results.push_back(Run(file, iterations));
+        results.back().PeakWorkingSet = GetPeakWorkingSet();
+    }
+
+    // ファイルごとの最大ワーキングセットに影響しないように，読み込みの計測後に行う.
+    // 半精度浮動小数変換は全ての値で検証してから計測する.
+    if (!VerifyHalfConversion())
+    {
+        ELOG("Error : VerifyHalfConversion() Failed.");
+        CoUninitialize();
+        return -1;
+    }
+
+    std::vector<HALF_BENCH_RESULT> halfResults;
+    RunHalfBenchmark(iterations, halfResults);
+
+    std::vector<BC_BENCH_RESULT> bcResults;
+    if (!RunBCDecodeBenchmark(iterations, bcResults))
+    {
+        ELOG("Error : RunBCDecodeBenchmark() Failed.");
+        CoUninitialize();
+        return -1;
+    }
+
+    std::vector<ATLAS_BENCH_RESULT> atlasResults;
+    if (!RunAtlasBenchmark(iterations, atlasResults))
+    {
+        ELOG("Error : RunAtlasBenchmark() Failed.");
+        CoUninitialize();
+        return -1;
+    }
+
+    if (!VerifyCache())
+    {
+        ELOG("Error : VerifyCache() Failed.");
+        CoUninitialize();
+        return -1;
+    }
+
+    std::vector<CACHE_BENCH_RESULT> cacheResults;
+    RunCacheBenchmark(iterations, cacheResults);
+
+    // スキャンを含むアクセス列で追い出し方針ごとのヒット率を比べる.
+    TRACE browserTrace;
+    MakeBrowserTrace(browserTrace);
+
+    std::vector<uint32_t> browserCapacities;
+    GetTraceCapacities(browserTrace, browserCapacities);
+
+    std::vector<TRACE_BENCH_RESULT> traceResults;
+    RunTraceBenchmark(browserTrace, browserCapacities, iterations, traceResults);
+
+    if (!VerifyConcurrentCache())
+    {
+        ELOG("Error : VerifyConcurrentCache() Failed.");
+        CoUninitialize();
+        return -1;
+    }
+
+    std::vector<CONCURRENT_CACHE_BENCH_RESULT> concurrentResults;
+    RunConcurrentCacheBenchmark(iterations, concurrentResults);
+
+    FILE* pFile = nullptr;
+    if (!OpenOutput(output, &pFile))
+    {
+        CoUninitialize();
+        return -1;
+    }
+
+    fprintf_s(pFile, "{\n");
+    fprintf_s(pFile, "  \"size\": %u,\n", size);
+    fprintf_s(pFile, "  \"iterations\": %u,\n", iterations);
+    fprintf_s(pFile, "  \"results\": [\n");
+
+    for(size_t i=0; i<corpus.size(); ++i)
+    {
+        auto& file   = corpus[i];
+        auto& result = results[i];
+
+        fprintf_s(pFile, "    {\n");
+        fprintf_s(pFile, "      \"name\": \"%s\",\n", file.Name.c_str());
+        fprintf_s(pFile, "      \"format\": \"%s\",\n", file.Format.c_str());
+        fprintf_s(pFile, "      \"bytes\": %llu,\n", file.Size);
+        fprintf_s(pFile, "      \"success\": %s,\n", result.Success ? "true" : "false");
+        fprintf_s(pFile, "      \"width\": %u,\n", result.Width);
+        fprintf_s(pFile, "      \"height\": %u,\n", result.Height);
+        fprintf_s(pFile, "      \"depth\": %u,\n", result.Depth);
+        fprintf_s(pFile, "      \"surfaceCount\": %u,\n", result.SurfaceCount);
+        fprintf_s(pFile, "      \"mipMapCount\": %u,\n", result.MipMapCount);
+        fprintf_s(pFile, "      \"pixels\": %llu,\n", result.Pixels);
+        WriteTiming(pFile, "file",        result.File);
+        WriteTiming(pFile, "memory",      result.Memory);
+        WriteTiming(pFile, "memoryArena", result.MemoryArena);
+        WriteTiming(pFile, "stream",      result.Stream);
+        fprintf_s(pFile, "      \"cookSuccess\": %s,\n", result.CookSuccess ? "true" : "false");
+        fprintf_s(pFile, "      \"cookedBytes\": %llu,\n", result.CookedBytes);
+        WriteTiming(pFile, "cookedFile",  result.CookedFile);
+        WriteTiming(pFile, "cookedMap",   result.CookedMap);
+        fprintf_s(pFile, "      \"allocsPerLoad\": %.1f,\n", result.AllocsPerLoad);
+        fprintf_s(pFile, "      \"allocBytesPerLoad\": %.1f,\n", result.AllocBytesPerLoad);
+        fprintf_s(pFile, "      \"peakHeapBytes\": %llu,\n", result.PeakHeapBytes);
+        fprintf_s(pFile, "      \"streamSuccess\": %s,\n", result.StreamSuccess ? "true" : "false");
+        fprintf_s(pFile, "      \"streamMatch\": %s,\n", result.StreamMatch ? "true" : "false");
+        fprintf_s(pFile, "      \"streamPeakHeapBytes\": %llu,\n", result.StreamPeakHeapBytes);
+        fprintf_s(pFile, "      \"peakWorkingSetBytes\": %llu\n", result.PeakWorkingSet);
+        fprintf_s(pFile, "    }%s\n", (i + 1 < corpus.size()) ? "," : "");
+    }
+
+    fprintf_s(pFile, "  ],\n");
+    fprintf_s(pFile, "  \"halfConversion\": [\n");
+    for(size_t i=0; i<halfResults.size(); ++i)
+    {
+        auto& item = halfResults[i];
+        fprintf_s(pFile, "    { \"level\": \"%s\", \"toHalfPerSec\": %.1f, \"toFloatPerSec\": %.1f }%s\n",
+            item.Level, item.ToHalfPerSec, item.ToFloatPerSec, (i + 1 < halfResults.size()) ? "," : "");
+    }
+    fprintf_s(pFile, "  ],\n");
+    fprintf_s(pFile, "  \"bcDecode\": [\n");
+    for(size_t i=0; i<bcResults.size(); ++i)
+    {
+        auto& item = bcResults[i];
+        fprintf_s(pFile, "    { \"format\": \"%s\", \"source\": \"%s\", \"width\": %u, \"height\": %u, \"seconds\": %.9f, \"mpixelsPerSec\": %.3f }%s\n",
+            item.Format, item.Source, item.Width, item.Height, item.Seconds, item.MPixelsPerSec, (i + 1 < bcResults.size()) ? "," : "");
+    }
+    fprintf_s(pFile, "  ],\n");
+    fprintf_s(pFile, "  \"atlas\": [\n");
+    for(size_t i=0; i<atlasResults.size(); ++i)
+    {
+        auto& item = atlasResults[i];
+        fprintf_s(pFile, "    {\n");
+        fprintf_s(pFile, "      \"packer\": \"%s\",\n", item.Packer);
+        fprintf_s(pFile, "      \"rotation\": %s,\n", item.Rotation ? "true" : "false");
+        fprintf_s(pFile, "      \"inputs\": %u,\n", item.InputCount);
+        fprintf_s(pFile, "      \"build\": { \"width\": %u, \"height\": %u, \"occupancy\": %.4f, \"seconds\": %.6f },\n",
+            item.Width, item.Height, item.Occupancy, item.BuildSec);
+        fprintf_s(pFile, "      \"minSquare\": { \"size\": %u, \"occupancy\": %.4f },\n",
+            item.MinSize, item.MinOccupancy);
+        fprintf_s(pFile, "      \"insert\": { \"width\": %u, \"height\": %u, \"occupancy\": %.4f, \"secondsPerInsert\": %.9f }\n",
+            item.InsertWidth, item.InsertHeight, item.InsertOccupancy, item.InsertSec);
+        fprintf_s(pFile, "    }%s\n", (i + 1 < atlasResults.size()) ? "," : "");
+    }
+    fprintf_s(pFile, "  ],\n");
+    fprintf_s(pFile, "  \"cache\": [\n");
+    for(size_t i=0; i<cacheResults.size(); ++i)
+    {
+        auto& item = cacheResults[i];
+        fprintf_s(pFile, "    { \"name\": \"%s\", \"entries\": %u, \"operations\": %llu, \"opsPerSec\": %.1f, \"hitRatio\": %.4f }%s\n",
+            item.Name, item.Entries, item.Operations, item.OpsPerSec, item.HitRatio, (i + 1 < cacheResults.size()) ? "," : "");
+    }
+    fprintf_s(pFile, "  ],\n");
+    WriteTraceReplay(pFile, browserTrace, traceResults);
+    fprintf_s(pFile, ",\n");
+    fprintf_s(pFile, "  \"concurrentCache\": [\n");
+    for(size_t i=0; i<concurrentResults.size(); ++i)
+    {
+        auto& item = concurrentResults[i];
+        fprintf_s(pFile, "    { \"workload\": \"%s\", \"shards\": %u, \"threads\": %u, \"operations\": %llu, \"opsPerSec\": %.1f, \"hitRatio\": %.4f, \"scaling\": %.3f }%s\n",
+            item.Workload, item.ShardCount, item.ThreadCount, item.Operations, item.OpsPerSec, item.HitRatio, item.Scaling, (i + 1 < concurrentResults.size()) ? "," : "");
+    }
+    fprintf_s(pFile, "  ],\n");
+    fprintf_s(pFile, "  \"peakWorkingSetBytes\": %llu\n", GetPeakWorkingSet());
+    fprintf_s(pFile, "}\n");
+
+    if (pFile != stdout)
+    { fclose(pFile); }
+
+    CoUninitialize();
+    return 0;
+}
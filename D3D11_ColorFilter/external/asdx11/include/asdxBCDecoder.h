@@ -0,0 +1,75 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxBCDecoder.h
+// Desc : Block Compression Decoder Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+struct ResTexture;
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ブロック圧縮フォーマットかどうかチェックします.
+//!
+//! @param[in]      format      DXGIフォーマットです.
+//! @retval true    BC1～BC7のいずれかです.
+//! @retval false   ブロック圧縮フォーマットではありません.
+//-------------------------------------------------------------------------------------------------
+bool IsBlockCompressedFormat(uint32_t format);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ブロック圧縮フォーマットの展開後のフォーマットを取得します.
+//!
+//! @param[in]      format      DXGIフォーマットです.
+//! @return     BC1～BC5(UNORM), BC7 は DXGI_FORMAT_R8G8B8A8_UNORM(SRGBの場合は DXGI_FORMAT_R8G8B8A8_UNORM_SRGB),
+//!             BC4, BC5(SNORM), BC6H は DXGI_FORMAT_R16G16B16A16_FLOAT を返却します.
+//!             ブロック圧縮フォーマットでない場合は DXGI_FORMAT_UNKNOWN を返却します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GetDecodedFormat(uint32_t format);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ブロック圧縮されたピクセルデータを展開します.
+//!
+//! @param[in]      format      DXGIフォーマットです.
+//! @param[in]      pSrc        ブロック圧縮されたピクセルデータです.
+//! @param[in]      srcPitch    ブロック1行あたりのバイト数です.
+//! @param[in]      width       展開する横幅(ピクセル数)です.
+//! @param[in]      height      展開する縦幅(ピクセル数)です.
+//! @param[out]     pDst        出力先です. GetDecodedFormat() の形式で書き込みます.
+//! @param[in]      dstPitch    出力先の1行あたりのバイト数です.
+//! @retval true    展開に成功.
+//! @retval false   未対応のフォーマットです.
+//! @note       4の倍数でないサイズは端のブロックを切り取って書き込みます. 呼び出しスレッドのみで処理します.
+//-------------------------------------------------------------------------------------------------
+bool DecodeBlocks(
+    uint32_t        format,
+    const uint8_t*  pSrc,
+    uint32_t        srcPitch,
+    uint32_t        width,
+    uint32_t        height,
+    uint8_t*        pDst,
+    uint32_t        dstPitch);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ブロック圧縮されたリソーステクスチャを展開します.
+//!
+//! @param[in]      src         ブロック圧縮されたリソーステクスチャです.
+//! @param[out]     dst         展開結果の格納先です. 全サーフェイス・全ミップレベルを1つのブロックに格納します.
+//!                             格納先が保持していたデータは解放しないので，事前に Release() を呼び出してください.
+//! @retval true    展開に成功.
+//! @retval false   展開に失敗.
+//! @note       ブロック行単位で複数スレッドに分割して展開します.
+//-------------------------------------------------------------------------------------------------
+bool DecodeResTexture(const ResTexture& src, ResTexture& dst);
+
+} // namespace asdx
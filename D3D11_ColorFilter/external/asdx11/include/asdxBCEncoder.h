@@ -0,0 +1,83 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxBCEncoder.h
+// Desc : Block Compression Encoder Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+struct ResTexture;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BC_ENCODE_QUALITY enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum BC_ENCODE_QUALITY
+{
+    BC_ENCODE_QUALITY_FAST = 0,     //!< 速度優先です. 端点は主軸上の範囲から求めます.
+    BC_ENCODE_QUALITY_HIGH,         //!< 品質優先です. 端点を最小二乗法で調整し，複数の候補から誤差が最小のものを選びます.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ブロック圧縮できるフォーマットかどうかチェックします.
+//!
+//! @param[in]      format      圧縮先のDXGIフォーマットです.
+//! @retval true    BC1, BC3, BC4(UNORM), BC5(UNORM), BC7 のいずれかです.
+//! @retval false   圧縮できないフォーマットです.
+//-------------------------------------------------------------------------------------------------
+bool IsEncodableFormat(uint32_t format);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      RGBA8形式のピクセルデータをブロック圧縮します.
+//!
+//! @param[in]      format      圧縮先のDXGIフォーマットです.
+//! @param[in]      pSrc        RGBA8形式のピクセルデータです.
+//! @param[in]      srcPitch    入力の1行あたりのバイト数です.
+//! @param[in]      width       横幅(ピクセル数)です.
+//! @param[in]      height      縦幅(ピクセル数)です.
+//! @param[out]     pDst        出力先です.
+//! @param[in]      dstPitch    出力先のブロック1行あたりのバイト数です.
+//! @param[in]      quality     圧縮品質です.
+//! @retval true    圧縮に成功.
+//! @retval false   未対応のフォーマットです.
+//! @note       4の倍数でないサイズは端のピクセルを複製してブロックを埋めます. 呼び出しスレッドのみで処理します.
+//!             BC4 は赤成分を, BC5 は赤と緑成分を圧縮します.
+//-------------------------------------------------------------------------------------------------
+bool EncodeBlocks(
+    uint32_t            format,
+    const uint8_t*      pSrc,
+    uint32_t            srcPitch,
+    uint32_t            width,
+    uint32_t            height,
+    uint8_t*            pDst,
+    uint32_t            dstPitch,
+    BC_ENCODE_QUALITY   quality = BC_ENCODE_QUALITY_FAST);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      RGBA8形式のリソーステクスチャをブロック圧縮します.
+//!
+//! @param[in]      src         DXGI_FORMAT_R8G8B8A8_UNORM(_SRGB)形式のリソーステクスチャです.
+//! @param[in]      format      圧縮先のDXGIフォーマットです. SRGBかどうかは指定した値をそのまま使います.
+//! @param[out]     dst         圧縮結果の格納先です. 全サーフェイス・全ミップレベルを1つのブロックに格納します.
+//!                             格納先が保持していたデータは解放しないので，事前に Release() を呼び出してください.
+//! @param[in]      quality     圧縮品質です.
+//! @retval true    圧縮に成功.
+//! @retval false   圧縮に失敗.
+//! @note       ブロック行単位で複数スレッドに分割して圧縮します.
+//-------------------------------------------------------------------------------------------------
+bool EncodeResTexture(
+    const ResTexture&   src,
+    uint32_t            format,
+    ResTexture&         dst,
+    BC_ENCODE_QUALITY   quality = BC_ENCODE_QUALITY_FAST);
+
+} // namespace asdx
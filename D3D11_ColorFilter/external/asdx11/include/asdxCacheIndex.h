@@ -0,0 +1,144 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxCacheIndex.h
+// Desc : Cache Hash Index Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CacheNoValue structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CacheNoValue
+{
+    /* NOTHING */
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CacheStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CacheStats
+{
+    uint64_t    Hits;       //!< ヒット数です.
+    uint64_t    Misses;     //!< ミス数です.
+    uint64_t    Evictions;  //!< 容量を超えて追い出した数です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CacheIndex class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename K, typename H = std::hash<K>>
+class CacheIndex
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static const uint32_t kInvalid = UINT32_MAX;    //!< 無効なノード番号です.
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    CacheIndex();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!             登録数の2倍以上の2のべき乗個のスロットを確保し，以降は確保を行いません.
+    //!
+    //! @param[in]      capacity        最大登録数です.
+    //---------------------------------------------------------------------------------------------
+    void Init(size_t capacity);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全ての登録を削除します.
+    //---------------------------------------------------------------------------------------------
+    void Clear();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      キーからノード番号を検索します.
+    //!
+    //! @param[in]      key         検索するキーです.
+    //! @param[in]      keyOf       ノード番号からキーを取得する関数です.
+    //! @return     ノード番号を返却します. 見つからない場合は kInvalid を返却します.
+    //---------------------------------------------------------------------------------------------
+    template<typename F>
+    uint32_t Find(const K& key, F keyOf) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      キーとノード番号を登録します.
+    //!
+    //! @param[in]      key         登録するキーです. 登録済みであってはいけません.
+    //! @param[in]      node        ノード番号です.
+    //---------------------------------------------------------------------------------------------
+    void Insert(const K& key, uint32_t node);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      キーの登録を削除します.
+    //!
+    //! @param[in]      key         削除するキーです.
+    //! @param[in]      keyOf       ノード番号からキーを取得する関数です.
+    //! @return     削除したノード番号を返却します. 見つからない場合は kInvalid を返却します.
+    //---------------------------------------------------------------------------------------------
+    template<typename F>
+    uint32_t Erase(const K& key, F keyOf);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      確保しているメモリサイズを取得します.
+    //!
+    //! @return     スロットのバイト数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetMemorySize() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Slot structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Slot
+    {
+        uint32_t    Hash;       //!< キーのハッシュ値です.
+        uint32_t    Node;       //!< ノード番号です. 空きスロットは kInvalid です.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::vector<Slot>   m_Slots;    //!< 線形探索法のスロットです.
+    uint32_t            m_Mask;     //!< スロット数 - 1 です.
+    H                   m_Hasher;   //!< ハッシュ関数です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    uint32_t GetHash(const K& key) const;
+};
+
+} // namespace asdx
+
+
+//-------------------------------------------------------------------------------------------------
+// Inline Files.
+//-------------------------------------------------------------------------------------------------
+#include <asdxCacheIndex.inl>
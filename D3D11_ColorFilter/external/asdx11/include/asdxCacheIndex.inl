@@ -0,0 +1,160 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxCacheIndex.inl
+// Desc : Cache Hash Index Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CacheIndex class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename H> inline
+CacheIndex<K, H>::CacheIndex()
+: m_Slots ()
+, m_Mask  (0)
+, m_Hasher()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename H> inline
+void CacheIndex<K, H>::Init(size_t capacity)
+{
+    // 負荷率を0.5以下に抑えて探索長を短くする.
+    size_t count = 8;
+    while(count < capacity * 2)
+    { count <<= 1; }
+
+    Slot empty = { 0, kInvalid };
+    m_Slots.assign(count, empty);
+    m_Mask = uint32_t(count - 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename H> inline
+void CacheIndex<K, H>::Term()
+{
+    m_Slots.clear();
+    m_Slots.shrink_to_fit();
+    m_Mask = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全ての登録を削除します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename H> inline
+void CacheIndex<K, H>::Clear()
+{
+    for(auto& slot : m_Slots)
+    { slot.Node = kInvalid; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キーからノード番号を検索します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename H>
+template<typename F> inline
+uint32_t CacheIndex<K, H>::Find(const K& key, F keyOf) const
+{
+    if (m_Slots.empty())
+    { return kInvalid; }
+
+    auto hash = GetHash(key);
+    for(auto i = hash & m_Mask; m_Slots[i].Node != kInvalid; i = (i + 1) & m_Mask)
+    {
+        auto& slot = m_Slots[i];
+        if (slot.Hash == hash && keyOf(slot.Node) == key)
+        { return slot.Node; }
+    }
+
+    return kInvalid;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キーとノード番号を登録します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename H> inline
+void CacheIndex<K, H>::Insert(const K& key, uint32_t node)
+{
+    auto hash = GetHash(key);
+    auto i    = hash & m_Mask;
+    while(m_Slots[i].Node != kInvalid)
+    { i = (i + 1) & m_Mask; }
+
+    m_Slots[i].Hash = hash;
+    m_Slots[i].Node = node;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キーの登録を削除します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename H>
+template<typename F> inline
+uint32_t CacheIndex<K, H>::Erase(const K& key, F keyOf)
+{
+    if (m_Slots.empty())
+    { return kInvalid; }
+
+    auto hash = GetHash(key);
+    auto i    = hash & m_Mask;
+    for(; m_Slots[i].Node != kInvalid; i = (i + 1) & m_Mask)
+    {
+        if (m_Slots[i].Hash == hash && keyOf(m_Slots[i].Node) == key)
+        { break; }
+    }
+
+    auto node = m_Slots[i].Node;
+    if (node == kInvalid)
+    { return kInvalid; }
+
+    // 墓標を残さないように，後続のスロットを本来の位置に近づける(後方シフト削除).
+    auto j = i;
+    for(;;)
+    {
+        j = (j + 1) & m_Mask;
+        if (m_Slots[j].Node == kInvalid)
+        { break; }
+
+        // 本来の位置が (i, j] の範囲にあれば動かせない.
+        auto home = m_Slots[j].Hash & m_Mask;
+        auto stay = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (stay)
+        { continue; }
+
+        m_Slots[i] = m_Slots[j];
+        i = j;
+    }
+
+    m_Slots[i].Node = kInvalid;
+    return node;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      確保しているメモリサイズを取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename H> inline
+size_t CacheIndex<K, H>::GetMemorySize() const
+{ return m_Slots.capacity() * sizeof(Slot); }
+
+//-------------------------------------------------------------------------------------------------
+//      キーのハッシュ値を求めます.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename H> inline
+uint32_t CacheIndex<K, H>::GetHash(const K& key) const
+{
+    // 整数をそのまま返すハッシュ関数でも偏らないように，黄金比の乗算で上位ビットに拡散する.
+    auto hash = uint64_t(m_Hasher(key)) * 0x9E3779B97F4A7C15ull;
+    return uint32_t(hash >> 32);
+}
+
+} // namespace asdx
@@ -0,0 +1,241 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxConcurrentCache.h
+// Desc : Sharded Concurrent Cache Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <asdxLruCache.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ConcurrentCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// 複数スレッドから使えるLRUキャッシュです. キーのハッシュ値でシャードを選び，シャードごとの
+// ミューテックスで保護した LruCache に格納します. 最大収容可能数はシャードに分配し，
+// 最大収容可能バイト数は全シャードで共有します. バイト数が足りない場合は追加先のシャードから，
+// 空になれば順に他のシャードから最も古く使った要素を追い出します. ロックは同時に1つしか持ちません.
+// 値は取り出すときにコピーするので，大きなデータは std::shared_ptr などで保持してください.
+template<typename K, typename V, typename H = std::hash<K>>
+class ConcurrentCache
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static const uint32_t kDefaultShardCount = 16;      //!< 既定のシャード数です.
+    static const uint32_t kMaxShardCount     = 256;     //!< 最大シャード数です.
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!             シャードごとのノードとハッシュテーブルをここで確保します.
+    //!
+    //! @param[in]      capacity        最大収容可能数です. 余りは先頭のシャードから1つずつ分配し，合計は capacity に一致します.
+    //! @param[in]      capacityBytes   全シャードで共有する最大収容可能バイト数です. 0の場合はバイト数で制限しません.
+    //! @param[in]      shardCount      シャード数です. 2のべき乗に切り上げ，最大 kMaxShardCount にします.
+    //!                                 最大収容可能数を超える場合は，収容できないシャードができないように減らします.
+    //---------------------------------------------------------------------------------------------
+    ConcurrentCache(size_t capacity, size_t capacityBytes = 0, uint32_t shardCount = kDefaultShardCount);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //!             GetOrCompute() の計算中に呼び出してはいけません.
+    //---------------------------------------------------------------------------------------------
+    ~ConcurrentCache();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      値を追加します.
+    //!             追加済みの場合は値とバイト数を更新します.
+    //!             収まらない場合は追加先のシャードから，足りなければ他のシャードから最も古く使った要素を追い出します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[in]      value       値です.
+    //! @param[in]      bytes       要素のバイト数です.
+    //! @retval true    追加に成功.
+    //! @retval false   追加できませんでした. 1要素で最大収容可能バイト数を超えているか，
+    //!                 他のスレッドが追加中のバイト数のために追い出しても収まりませんでした.
+    //---------------------------------------------------------------------------------------------
+    bool Add(const K& key, const V& value, size_t bytes = 0);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      値を検索し，最も新しく使った要素にします.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[out]     result      見つかった値のコピーです.
+    //! @retval true    見つかりました.
+    //! @retval false   見つかりませんでした.
+    //---------------------------------------------------------------------------------------------
+    bool Find(const K& key, V& result);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      値を検索し，なければ計算して追加します.
+    //!             同じキーを複数スレッドが同時に要求した場合は1つのスレッドだけが計算し，
+    //!             他のスレッドは計算の完了を待って同じ値を受け取ります.
+    //!             計算はロックを外して行うので，他のキーの操作を妨げません.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[out]     result      値のコピーです.
+    //! @param[in]      func        bool func(const K& key, V& value, size_t& bytes) の形式の計算関数です.
+    //!                             失敗した場合は false を返却します. 例外を投げた場合は待っていたスレッドには
+    //!                             失敗として通知し，呼び出し元には例外をそのまま投げ直します.
+    //! @param[out]     pCached     値がキャッシュに含まれているかどうかを受け取ります. nullptr の場合は受け取りません.
+    //!                             計算した値が Add() と同じ理由で追加できなかった場合は false になります.
+    //! @retval true    値を取得しました.
+    //! @retval false   計算に失敗しました. 失敗した結果は追加しません.
+    //---------------------------------------------------------------------------------------------
+    template<typename Func>
+    bool GetOrCompute(const K& key, V& result, Func func, bool* pCached = nullptr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を削除します.
+    //!
+    //! @param[in]      key         削除する要素のキーです.
+    //! @retval true    削除しました.
+    //! @retval false   要素が含まれていません.
+    //---------------------------------------------------------------------------------------------
+    bool Remove(const K& key);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全要素を削除します. 計算中の要素は計算後に追加されます.
+    //---------------------------------------------------------------------------------------------
+    void Clear();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素が含まれているか判定します. 使用順序は変えません.
+    //!
+    //! @return     指定要素が含まれている場合には true を返却します.
+    //---------------------------------------------------------------------------------------------
+    bool Contains(const K& key) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全シャードの統計情報の合計を取得します.
+    //!             計算の完了を待って受け取った場合もヒットとして数えます.
+    //!
+    //! @return     統計情報を返却します.
+    //---------------------------------------------------------------------------------------------
+    CacheStats GetStats() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヒット数, ミス数, 追い出し数を0に戻します.
+    //---------------------------------------------------------------------------------------------
+    void ResetStats();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      シャード数を取得します.
+    //!
+    //! @return     シャード数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetShardCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最大収容可能数を取得します.
+    //!
+    //! @return     最大収容可能数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetCapacity() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最大収容可能バイト数を取得します.
+    //!
+    //! @return     最大収容可能バイト数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetCapacityBytes() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在の収容数を取得します.
+    //!
+    //! @return     全シャードの収容数の合計を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在の収容バイト数を取得します.
+    //!
+    //! @return     全シャードの収容バイト数の合計を返却します. 他のスレッドが追加中のバイト数を含みます.
+    //---------------------------------------------------------------------------------------------
+    size_t GetBytes() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      確保しているメモリサイズを取得します.
+    //!
+    //! @return     オブジェクト, シャード, ノード, ハッシュテーブルのバイト数を返却します.
+    //!             キーや値が内部で確保するメモリは含みません.
+    //---------------------------------------------------------------------------------------------
+    size_t GetMemorySize() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Pending structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Pending
+    {
+        bool    Done;       //!< 計算が完了したかどうか.
+        bool    Success;    //!< 計算に成功したかどうか.
+        bool    Cached;     //!< 計算した値を追加したかどうか.
+        V       Value;      //!< 計算した値です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Shard structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Shard
+    {
+        std::mutex                                          Mutex;      //!< シャードの排他制御です.
+        std::condition_variable                             Cond;       //!< 計算の完了通知です.
+        LruCache<K, V, H>                                   Cache;      //!< 要素です.
+        std::unordered_map<K, std::shared_ptr<Pending>, H>  Pendings;   //!< 計算中の要素です.
+        CacheStats                                          Stats;      //!< 統計情報です.
+
+        Shard(size_t capacity);
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::vector<std::unique_ptr<Shard>>     m_Shards;           //!< シャードです. 互いのキャッシュラインを共有しないように個別に確保します.
+    uint32_t                                m_ShardShift;       //!< シャード番号を求めるシフト量です.
+    size_t                                  m_Capacity;         //!< 最大収容可能数.
+    size_t                                  m_CapacityBytes;    //!< 最大収容可能バイト数.
+    std::atomic<size_t>                     m_Bytes;            //!< 全シャードの収容バイト数と追加中のバイト数の合計です.
+    H                                       m_Hasher;           //!< シャードの選択に使うハッシュ関数です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    uint32_t GetShardIndex(const K& key) const;
+    bool     Reserve      (uint32_t home, size_t bytes, const K* pKeep);
+    bool     EvictOne     (uint32_t index, const K* pKeep);
+    void     Complete     (Shard& shard, const K& key, Pending& pending, bool success, bool cached, const V* pValue);
+
+    ConcurrentCache             (const ConcurrentCache&) = delete;
+    ConcurrentCache& operator = (const ConcurrentCache&) = delete;
+};
+
+} // namespace asdx
+
+
+//-------------------------------------------------------------------------------------------------
+// Inline Files.
+//-------------------------------------------------------------------------------------------------
+#include <asdxConcurrentCache.inl>
@@ -0,0 +1,461 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxConcurrentCache.inl
+// Desc : Sharded Concurrent Cache Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ConcurrentCache::Shard structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+ConcurrentCache<K, V, H>::Shard::Shard(size_t capacity)
+: Mutex     ()
+, Cond      ()
+, Cache     (capacity)
+, Pendings  ()
+, Stats     ()
+{
+    // 追い出しはロック中に呼び出される.
+    Cache.SetEvictFunc([this](const K&, V&) { Stats.Evictions++; });
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ConcurrentCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+ConcurrentCache<K, V, H>::ConcurrentCache(size_t capacity, size_t capacityBytes, uint32_t shardCount)
+: m_Shards       ()
+, m_ShardShift   (64)
+, m_Capacity     (capacity)
+, m_CapacityBytes(capacityBytes)
+, m_Bytes        (0)
+, m_Hasher       ()
+{
+    // 全てのシャードに1つ以上収容できるようにする.
+    auto count = 1u;
+    while(count < shardCount && count < kMaxShardCount && count * 2 <= capacity)
+    {
+        count <<= 1;
+        m_ShardShift--;
+    }
+
+    // 合計が最大収容可能数を超えないように，余りは先頭のシャードから1つずつ分配する.
+    auto base      = capacity / count;
+    auto remainder = capacity % count;
+
+    m_Shards.reserve(count);
+    for(auto i=0u; i<count; ++i)
+    { m_Shards.emplace_back(new Shard(base + ((i < remainder) ? 1 : 0))); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+ConcurrentCache<K, V, H>::~ConcurrentCache()
+{ m_Shards.clear(); }
+
+//-------------------------------------------------------------------------------------------------
+//      値を追加します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool ConcurrentCache<K, V, H>::Add(const K& key, const V& value, size_t bytes)
+{
+    auto  index = GetShardIndex(key);
+    auto& shard = *m_Shards[index];
+
+    // 更新の場合は置き換える値の分を差し引いて予約し，予約中の追い出しでは更新する要素を残す.
+    size_t oldBytes = 0;
+    {
+        std::lock_guard<std::mutex> locker(shard.Mutex);
+        oldBytes = shard.Cache.GetItemBytes(key);
+    }
+
+    auto reserved = (bytes > oldBytes) ? bytes - oldBytes : 0;
+    if (!Reserve(index, reserved, (oldBytes > 0) ? &key : nullptr))
+    { return false; }
+
+    std::lock_guard<std::mutex> locker(shard.Mutex);
+
+    auto before  = shard.Cache.GetBytes();
+    auto success = shard.Cache.Add(key, value, bytes);
+    auto after   = shard.Cache.GetBytes();
+
+    // 予約したバイト数を実際の増減に置き換える.
+    // 値が小さくなった分や，収容数を超えて追い出した要素の分はここで戻る.
+    m_Bytes -= reserved + before - after;
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      値を検索し，最も新しく使った要素にします.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool ConcurrentCache<K, V, H>::Find(const K& key, V& result)
+{
+    auto& shard = *m_Shards[GetShardIndex(key)];
+    std::lock_guard<std::mutex> locker(shard.Mutex);
+
+    auto pValue = shard.Cache.Find(key);
+    if (pValue == nullptr)
+    {
+        shard.Stats.Misses++;
+        return false;
+    }
+
+    shard.Stats.Hits++;
+    result = *pValue;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      値を検索し，なければ計算して追加します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H>
+template<typename Func> inline
+bool ConcurrentCache<K, V, H>::GetOrCompute(const K& key, V& result, Func func, bool* pCached)
+{
+    auto& shard = *m_Shards[GetShardIndex(key)];
+    std::shared_ptr<Pending> pending;
+
+    {
+        std::unique_lock<std::mutex> locker(shard.Mutex);
+
+        auto pValue = shard.Cache.Find(key);
+        if (pValue != nullptr)
+        {
+            shard.Stats.Hits++;
+            result = *pValue;
+
+            if (pCached != nullptr)
+            { *pCached = true; }
+
+            return true;
+        }
+
+        // 他のスレッドが計算中なら完了を待つ.
+        auto itr = shard.Pendings.find(key);
+        if (itr != shard.Pendings.end())
+        {
+            pending = itr->second;
+            shard.Cond.wait(locker, [&]() { return pending->Done; });
+
+            if (!pending->Success)
+            { return false; }
+
+            shard.Stats.Hits++;
+            result = pending->Value;
+
+            if (pCached != nullptr)
+            { *pCached = pending->Cached; }
+
+            return true;
+        }
+
+        shard.Stats.Misses++;
+        pending = std::make_shared<Pending>();
+        pending->Done    = false;
+        pending->Success = false;
+        pending->Cached  = false;
+        shard.Pendings.insert(std::make_pair(key, pending));
+    }
+
+    // 計算中は他のキーの操作を妨げないようにロックを外しておく.
+    // 計算や値のコピーが例外を投げても，待っているスレッドが止まったままにならないように完了させる.
+    auto completed = false;
+    try
+    {
+        V      value = V();
+        size_t bytes = 0;
+
+        auto success = func(key, value, bytes);
+        auto cached  = success && Add(key, value, bytes);
+
+        Complete(shard, key, *pending, success, cached, &value);
+        completed = true;
+
+        if (success)
+        { result = value; }
+
+        if (pCached != nullptr)
+        { *pCached = cached; }
+
+        return success;
+    }
+    catch(...)
+    {
+        if (!completed)
+        { Complete(shard, key, *pending, false, false, nullptr); }
+
+        throw;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要素を削除します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool ConcurrentCache<K, V, H>::Remove(const K& key)
+{
+    auto& shard = *m_Shards[GetShardIndex(key)];
+    std::lock_guard<std::mutex> locker(shard.Mutex);
+
+    auto before = shard.Cache.GetBytes();
+    if (!shard.Cache.Remove(key))
+    { return false; }
+
+    m_Bytes -= before - shard.Cache.GetBytes();
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全要素を削除します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void ConcurrentCache<K, V, H>::Clear()
+{
+    for(auto& shard : m_Shards)
+    {
+        std::lock_guard<std::mutex> locker(shard->Mutex);
+        m_Bytes -= shard->Cache.GetBytes();
+        shard->Cache.Clear();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要素が含まれているか判定します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool ConcurrentCache<K, V, H>::Contains(const K& key) const
+{
+    auto& shard = *m_Shards[GetShardIndex(key)];
+    std::lock_guard<std::mutex> locker(shard.Mutex);
+    return shard.Cache.Contains(key);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+CacheStats ConcurrentCache<K, V, H>::GetStats() const
+{
+    CacheStats result = {};
+    for(auto& shard : m_Shards)
+    {
+        std::lock_guard<std::mutex> locker(shard->Mutex);
+        result.Hits      += shard->Stats.Hits;
+        result.Misses    += shard->Stats.Misses;
+        result.Evictions += shard->Stats.Evictions;
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を0に戻します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void ConcurrentCache<K, V, H>::ResetStats()
+{
+    for(auto& shard : m_Shards)
+    {
+        std::lock_guard<std::mutex> locker(shard->Mutex);
+        shard->Stats = CacheStats();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      シャード数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+uint32_t ConcurrentCache<K, V, H>::GetShardCount() const
+{ return uint32_t(m_Shards.size()); }
+
+//-------------------------------------------------------------------------------------------------
+//      最大収容可能数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t ConcurrentCache<K, V, H>::GetCapacity() const
+{ return m_Capacity; }
+
+//-------------------------------------------------------------------------------------------------
+//      最大収容可能バイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t ConcurrentCache<K, V, H>::GetCapacityBytes() const
+{ return m_CapacityBytes; }
+
+//-------------------------------------------------------------------------------------------------
+//      現在の収容数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t ConcurrentCache<K, V, H>::GetCount() const
+{
+    size_t result = 0;
+    for(auto& shard : m_Shards)
+    {
+        std::lock_guard<std::mutex> locker(shard->Mutex);
+        result += shard->Cache.GetCount();
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      現在の収容バイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t ConcurrentCache<K, V, H>::GetBytes() const
+{ return m_Bytes.load(); }
+
+//-------------------------------------------------------------------------------------------------
+//      確保しているメモリサイズを取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t ConcurrentCache<K, V, H>::GetMemorySize() const
+{
+    auto result = sizeof(*this) + m_Shards.capacity() * sizeof(std::unique_ptr<Shard>);
+    for(auto& shard : m_Shards)
+    {
+        // LruCache 自身のサイズは Shard に含まれている.
+        result += sizeof(Shard) - sizeof(shard->Cache);
+        result += shard->Cache.GetMemorySize();
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キーに対応するシャード番号を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+uint32_t ConcurrentCache<K, V, H>::GetShardIndex(const K& key) const
+{
+    if (m_Shards.size() == 1)
+    { return 0; }
+
+    // CacheIndex はハッシュ値の下位側を使うので，シャードは上位ビットで選ぶ.
+    auto hash = uint64_t(m_Hasher(key)) * 0x9E3779B97F4A7C15ull;
+    return uint32_t(hash >> m_ShardShift);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      追加するバイト数を確保します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool ConcurrentCache<K, V, H>::Reserve(uint32_t home, size_t bytes, const K* pKeep)
+{
+    if (m_CapacityBytes == 0)
+    {
+        m_Bytes += bytes;
+        return true;
+    }
+
+    if (bytes > m_CapacityBytes)
+    { return false; }
+
+    // 予約を含めた合計が上限を超えないように，収まるまで追加先のシャードから追い出し，
+    // 空になったら次のシャードに移る. 全シャードが空でも収まらないのは他のスレッドが予約中の場合だけ.
+    auto mask    = uint32_t(m_Shards.size() - 1);
+    auto victim  = home;
+    auto empty   = 0u;
+    auto current = m_Bytes.load();
+
+    for(;;)
+    {
+        if (current + bytes <= m_CapacityBytes)
+        {
+            if (m_Bytes.compare_exchange_weak(current, current + bytes))
+            { return true; }
+
+            continue;
+        }
+
+        if (!EvictOne(victim, pKeep))
+        {
+            if (++empty > mask)
+            { return false; }
+
+            victim = (victim + 1) & mask;
+        }
+
+        current = m_Bytes.load();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      シャードの最も古く使った要素を1つ追い出します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool ConcurrentCache<K, V, H>::EvictOne(uint32_t index, const K* pKeep)
+{
+    auto& shard = *m_Shards[index];
+    std::lock_guard<std::mutex> locker(shard.Mutex);
+
+    if (shard.Cache.GetCount() == 0)
+    { return false; }
+
+    // 更新中の要素が最も古い場合は最も新しく使った要素にして，次に古い要素を追い出す.
+    // 他に要素がなければ追い出せる要素がないものとして次のシャードに移る.
+    auto victim = shard.Cache.GetBack();
+    if (pKeep != nullptr && victim == *pKeep)
+    {
+        if (shard.Cache.GetCount() == 1)
+        { return false; }
+
+        shard.Cache.Find(victim);
+        victim = shard.Cache.GetBack();
+    }
+
+    auto before = shard.Cache.GetBytes();
+    shard.Cache.Remove(victim);
+    m_Bytes -= before - shard.Cache.GetBytes();
+
+    shard.Stats.Evictions++;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      計算を完了し，待っているスレッドに通知します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void ConcurrentCache<K, V, H>::Complete
+(
+    Shard&      shard,
+    const K&    key,
+    Pending&    pending,
+    bool        success,
+    bool        cached,
+    const V*    pValue
+)
+{
+    {
+        std::lock_guard<std::mutex> locker(shard.Mutex);
+
+        // 値のコピーが例外を投げた場合は完了扱いにしない.
+        if (success)
+        { pending.Value = *pValue; }
+
+        pending.Success = success;
+        pending.Cached  = cached;
+        pending.Done    = true;
+        shard.Pendings.erase(key);
+    }
+
+    shard.Cond.notify_all();
+}
+
+} // namespace asdx
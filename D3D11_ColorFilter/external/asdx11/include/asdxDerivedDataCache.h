@@ -0,0 +1,285 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxDerivedDataCache.h
+// Desc : Derived Data Cache Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+struct ResTexture;
+struct TextureLoadOptions;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DerivedDataKey structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct DerivedDataKey
+{
+    uint64_t    Lo;     //!< 下位64bitです.
+    uint64_t    Hi;     //!< 上位64bitです.
+
+    bool operator == (const DerivedDataKey& value) const
+    { return Lo == value.Lo && Hi == value.Hi; }
+
+    bool operator != (const DerivedDataKey& value) const
+    { return Lo != value.Lo || Hi != value.Hi; }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DerivedDataKeyBuilder class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class DerivedDataKeyBuilder
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!
+    //! @param[in]      kind        データの種類を表す文字列です(例: "ResTexture"). 種類ごとにキー空間を分けます.
+    //! @param[in]      version     処理のバージョンです. 処理内容を変えたら値を上げてキャッシュを無効化します.
+    //---------------------------------------------------------------------------------------------
+    DerivedDataKeyBuilder(const char* kind, uint32_t version);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      データを追加します.
+    //!
+    //! @param[in]      pData       データです.
+    //! @param[in]      size        データサイズです.
+    //! @return     自身を返却します.
+    //---------------------------------------------------------------------------------------------
+    DerivedDataKeyBuilder& Append(const void* pData, size_t size);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      値を追加します.
+    //!
+    //! @param[in]      value       追加する値です. 処理設定などの POD 型を想定しています.
+    //! @return     自身を返却します.
+    //---------------------------------------------------------------------------------------------
+    template<typename T>
+    DerivedDataKeyBuilder& AppendValue(const T& value)
+    { return Append(&value, sizeof(value)); }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      キーを取得します.
+    //!
+    //! @return     これまでに追加したデータから求めた128bitのキーを返却します.
+    //---------------------------------------------------------------------------------------------
+    DerivedDataKey GetKey() const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    uint64_t    m_Lane[2];      //!< ハッシュの途中結果です.
+    uint64_t    m_Tail;         //!< 8byteに満たない端数です.
+    uint32_t    m_TailSize;     //!< 端数のバイト数です.
+    uint64_t    m_TotalSize;    //!< 追加したデータの総バイト数です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    void Mix(uint64_t value);
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DerivedDataCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class DerivedDataCache
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Desc structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Desc
+    {
+        const wchar_t*  DirectoryPath;  //!< キャッシュを格納するディレクトリです. 複数のプロセスで共有できます.
+        uint64_t        BudgetSize;     //!< キャッシュの上限サイズ(byte)です. 0の場合は制限しません.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Stats structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Stats
+    {
+        uint64_t    HitCount;       //!< ヒット数です.
+        uint64_t    MissCount;      //!< ミス数です.
+        uint64_t    WriteCount;     //!< 書き込み数です.
+        uint64_t    EvictCount;     //!< 追い出したエントリー数です.
+    };
+
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    DerivedDataCache();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~DerivedDataCache();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!             ディレクトリが存在しない場合は作成し，上限サイズを超えている場合は古いエントリーを追い出します.
+    //!
+    //! @param[in]      desc        設定です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(const Desc& desc);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バイナリデータを取得します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[out]     result      データの格納先です.
+    //! @retval true    キャッシュにヒットしました.
+    //! @retval false   キャッシュにありません.
+    //! @note       コンパイル済みシェーダや加工済みメッシュなどの格納に使用します.
+    //---------------------------------------------------------------------------------------------
+    bool Get(const DerivedDataKey& key, std::vector<uint8_t>& result);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バイナリデータを格納します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[in]      pData       データです.
+    //! @param[in]      size        データサイズです.
+    //! @retval true    格納に成功.
+    //! @retval false   格納に失敗.
+    //! @note       一時ファイルに書き込んでから名前を変更するので，他のプロセスが書きかけのデータを読むことはありません.
+    //---------------------------------------------------------------------------------------------
+    bool Put(const DerivedDataKey& key, const void* pData, size_t size);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      テクスチャを取得します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[out]     result      テクスチャの格納先です.
+    //! @retval true    キャッシュにヒットしました.
+    //! @retval false   キャッシュにありません.
+    //! @note       クックドテクスチャ(ATEX)として格納されているので，デコードせずに読み込みます.
+    //!             ファイルは開いたままにしないので，読み込み中も他のプロセスが追い出しや置き換えを行えます.
+    //---------------------------------------------------------------------------------------------
+    bool GetTexture(const DerivedDataKey& key, ResTexture& result);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      テクスチャを格納します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[in]      texture     格納するテクスチャです.
+    //! @retval true    格納に成功.
+    //! @retval false   格納に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool PutTexture(const DerivedDataKey& key, const ResTexture& texture);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      キャッシュを経由してテクスチャファイルを読み込みます.
+    //!             ファイルの内容と読み込み設定からキーを求め，ヒットした場合はデコードを省略します.
+    //!             ミスした場合はデコードしてキャッシュに格納します.
+    //!
+    //! @param[in]      filename    ファイル名です.
+    //! @param[out]     result      テクスチャの格納先です.
+    //! @param[in]      pOptions    読み込み設定です. nullptrの場合は既定値を使います.
+    //! @retval true    読み込みに成功.
+    //! @retval false   読み込みに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool LoadTextureA(const char* filename, ResTexture& result, const TextureLoadOptions* pOptions = nullptr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      キャッシュを経由してテクスチャファイルを読み込みます.
+    //!             ファイルの内容と読み込み設定からキーを求め，ヒットした場合はデコードを省略します.
+    //!             ミスした場合はデコードしてキャッシュに格納します.
+    //!
+    //! @param[in]      filename    ファイル名です.
+    //! @param[out]     result      テクスチャの格納先です.
+    //! @param[in]      pOptions    読み込み設定です. nullptrの場合は既定値を使います.
+    //! @retval true    読み込みに成功.
+    //! @retval false   読み込みに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool LoadTextureW(const wchar_t* filename, ResTexture& result, const TextureLoadOptions* pOptions = nullptr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      上限サイズを超えている場合に，最近使われていないエントリーから削除します.
+    //!             他のプロセスが使用中で削除できないエントリーは飛ばします.
+    //---------------------------------------------------------------------------------------------
+    void Trim();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報を取得します.
+    //!
+    //! @return     統計情報を返却します.
+    //---------------------------------------------------------------------------------------------
+    Stats GetStats() const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::wstring            m_Directory;        //!< キャッシュディレクトリです(末尾は区切り文字).
+    uint64_t                m_BudgetSize;       //!< 上限サイズです.
+    std::atomic<uint64_t>   m_WrittenSize;      //!< 前回の Trim() 以降に書き込んだサイズです.
+    std::atomic<uint64_t>   m_HitCount;         //!< ヒット数です.
+    std::atomic<uint64_t>   m_MissCount;        //!< ミス数です.
+    std::atomic<uint64_t>   m_WriteCount;       //!< 書き込み数です.
+    std::atomic<uint64_t>   m_EvictCount;       //!< 追い出したエントリー数です.
+    std::mutex              m_TrimMutex;        //!< Trim() の排他制御です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    std::wstring GetEntryPath(const DerivedDataKey& key, const wchar_t* ext, bool createDirectory) const;
+    std::wstring GetTempFilePath(const std::wstring& entryPath) const;
+    bool Commit(const std::wstring& tempPath, const std::wstring& entryPath, uint64_t size);
+
+    DerivedDataCache(const DerivedDataCache&) = delete;
+    void operator = (const DerivedDataCache&) = delete;
+};
+
+} // namespace asdx
@@ -0,0 +1,373 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxImageSink.h
+// Desc : Image Stream Sink Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include <asdxResTexture.h>
+#include <asdxPixelConvert.h>
+#include <asdxBCEncoder.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageConvertSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class ImageConvertSink : public IImageSink
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ImageConvertSink();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~ImageConvertSink();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      format      変換先のDXGIフォーマットです. ConvertPixels() で扱える非圧縮フォーマットである必要があります.
+    //! @param[in]      pNext       変換結果を渡すシンクです.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(uint32_t format, IImageSink* pNext);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画像の受け取りを開始します.
+    //!             入力がブロック圧縮フォーマットの場合は展開してから変換します.
+    //---------------------------------------------------------------------------------------------
+    bool OnBegin(const ImageStreamInfo& info) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      帯を変換して次のシンクに渡します.
+    //---------------------------------------------------------------------------------------------
+    bool OnBand(uint32_t y, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画像の受け取りを終了します.
+    //---------------------------------------------------------------------------------------------
+    bool OnEnd() override;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    uint32_t                m_Format;       //!< 変換先のDXGIフォーマットです.
+    IImageSink*             m_pNext;        //!< 変換結果を渡すシンクです.
+    ImageStreamInfo         m_Info;         //!< 入力画像の情報です.
+    PIXEL_FORMAT            m_SrcFormat;    //!< 変換元のピクセルフォーマットです(ブロック圧縮の場合は展開後).
+    PIXEL_FORMAT            m_DstFormat;    //!< 変換先のピクセルフォーマットです.
+    bool                    m_Decode;       //!< ブロック圧縮を展開するかどうか.
+    std::vector<uint8_t>    m_Decoded;      //!< 展開した帯です.
+    std::vector<uint8_t>    m_Pixels;       //!< 変換した帯です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    ImageConvertSink                (const ImageConvertSink&) = delete;
+    ImageConvertSink& operator =    (const ImageConvertSink&) = delete;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageMipChainSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class ImageMipChainSink : public IImageSink
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ImageMipChainSink();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~ImageMipChainSink();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      ppSinks     ミップレベルごとに結果を渡すシンクの配列です. ppSinks[0] には入力をそのまま渡します.
+    //!                             nullptr の要素は生成のみ行って渡しません. 同じシンクを複数のレベルに指定してはいけません.
+    //! @param[in]      count       配列の要素数です. 生成するミップレベル数の上限になります.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(IImageSink* const* ppSinks, uint32_t count);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画像の受け取りを開始します.
+    //!             ミップレベル数は入力サイズの完全なミップレベル数と配列の要素数の小さい方になります.
+    //---------------------------------------------------------------------------------------------
+    bool OnBegin(const ImageStreamInfo& info) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      帯を縮小して各ミップレベルのシンクに渡します.
+    //!             下位のミップレベルは1行ずつ，行が揃った時点で渡します.
+    //---------------------------------------------------------------------------------------------
+    bool OnBand(uint32_t y, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画像の受け取りを終了します.
+    //---------------------------------------------------------------------------------------------
+    bool OnEnd() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      生成するミップレベル数を取得します.
+    //!
+    //! @return     OnBegin() で決定したミップレベル数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetMipCount() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Level structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Level
+    {
+        IImageSink*             pSink;          //!< 結果を渡すシンクです.
+        uint32_t                Width;          //!< 横幅です.
+        uint32_t                Height;         //!< 縦幅です.
+        uint32_t                Row;            //!< 次に出力する行です.
+        uint32_t                Count;          //!< 出力中の行に加算した上位レベルの行数です.
+        std::vector<float>      Sum;            //!< 出力中の行の合計値です(RGBA).
+        std::vector<uint8_t>    Pixels;         //!< 出力フォーマットに変換した行です.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::vector<IImageSink*>    m_Sinks;        //!< ミップレベルごとのシンクです.
+    std::vector<Level>          m_Levels;       //!< ミップレベルごとの縮小状態です(先頭は最上位ミップレベル).
+    PIXEL_FORMAT                m_Format;       //!< 入出力のピクセルフォーマットです.
+    uint32_t                    m_DxgiFormat;   //!< 入出力のDXGIフォーマットです.
+    std::vector<float>          m_Row;          //!< 浮動小数に変換した入力の1行です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    bool PushRow(uint32_t index, const float* pRow);
+
+    ImageMipChainSink               (const ImageMipChainSink&) = delete;
+    ImageMipChainSink& operator =   (const ImageMipChainSink&) = delete;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageEncodeSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class ImageEncodeSink : public IImageSink
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ImageEncodeSink();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~ImageEncodeSink();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      format      圧縮先のDXGIフォーマットです. IsEncodableFormat() が true を返す必要があります.
+    //! @param[in]      pNext       圧縮結果を渡すシンクです.
+    //! @param[in]      quality     圧縮品質です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(uint32_t format, IImageSink* pNext, BC_ENCODE_QUALITY quality = BC_ENCODE_QUALITY_FAST);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画像の受け取りを開始します.
+    //!             入力は ConvertPixels() で扱える非圧縮フォーマットである必要があります.
+    //---------------------------------------------------------------------------------------------
+    bool OnBegin(const ImageStreamInfo& info) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      帯をRGBA8形式で溜めて，一定の行数ごとに圧縮して次のシンクに渡します.
+    //!             ブロック行単位で複数スレッドに分割して圧縮します.
+    //---------------------------------------------------------------------------------------------
+    bool OnBand(uint32_t y, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      残りの行を圧縮して，画像の受け取りを終了します.
+    //---------------------------------------------------------------------------------------------
+    bool OnEnd() override;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    uint32_t                m_Format;       //!< 圧縮先のDXGIフォーマットです.
+    IImageSink*             m_pNext;        //!< 圧縮結果を渡すシンクです.
+    BC_ENCODE_QUALITY       m_Quality;      //!< 圧縮品質です.
+    ImageStreamInfo         m_Info;         //!< 入力画像の情報です.
+    PIXEL_FORMAT            m_SrcFormat;    //!< 入力のピクセルフォーマットです.
+    PIXEL_FORMAT            m_StageFormat;  //!< 圧縮前のピクセルフォーマットです(RGBA8).
+    uint32_t                m_BlockPitch;   //!< 圧縮結果のブロック1行あたりのバイト数です.
+    uint32_t                m_Y;            //!< 溜めている先頭の行です.
+    uint32_t                m_Count;        //!< 溜めている行数です.
+    std::vector<uint8_t>    m_Stage;        //!< 圧縮前の行です.
+    std::vector<uint8_t>    m_Blocks;       //!< 圧縮結果です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    bool Flush();
+
+    ImageEncodeSink                 (const ImageEncodeSink&) = delete;
+    ImageEncodeSink& operator =     (const ImageEncodeSink&) = delete;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageCollectSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class ImageCollectSink : public IImageSink
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ImageCollectSink();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~ImageCollectSink();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      受け取ったデータを破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画像の受け取りを開始します. 受け取り済みのデータは破棄します.
+    //---------------------------------------------------------------------------------------------
+    bool OnBegin(const ImageStreamInfo& info) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      帯をコピーします. 最初の帯の行ピッチで全体を確保します.
+    //---------------------------------------------------------------------------------------------
+    bool OnBand(uint32_t y, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画像の受け取りを終了します.
+    //---------------------------------------------------------------------------------------------
+    bool OnEnd() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      受け取った画像の所有権をリソーステクスチャとして移します.
+    //!
+    //! @param[out]     result      格納先です. ミップレベル1つのテクスチャになります.
+    //!                             格納先が保持していたデータは解放しないので，事前に Release() を呼び出してください.
+    //! @retval true    所有権の移動に成功.
+    //! @retval false   受け取りが完了していません.
+    //---------------------------------------------------------------------------------------------
+    bool Detach(ResTexture& result);
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    ImageStreamInfo     m_Info;         //!< 画像の情報です.
+    uint8_t*            m_pPixels;      //!< ピクセルデータです.
+    uint32_t            m_Pitch;        //!< 1行(ブロック圧縮の場合はブロック1行)あたりのバイト数です.
+    uint32_t            m_RowsPerBlock; //!< データ1行あたりの画像の行数です(ブロック圧縮の場合は4).
+    uint32_t            m_NextY;        //!< 次に受け取る行です.
+    bool                m_Completed;    //!< 受け取りが完了したかどうか.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    ImageCollectSink                (const ImageCollectSink&) = delete;
+    ImageCollectSink& operator =    (const ImageCollectSink&) = delete;
+};
+
+} // namespace asdx
@@ -8,7 +8,10 @@
 //-------------------------------------------------------------------------------------------------
 // Includes
 //-------------------------------------------------------------------------------------------------
-#include <map>
+#include <cassert>
+#include <functional>
+#include <vector>
+#include <asdxCacheIndex.h>
 
 
 namespace asdx {
@@ -16,7 +19,7 @@ namespace asdx {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // LfuCache class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-template<typename T>
+template<typename K, typename V = CacheNoValue, typename H = std::hash<K>>
 class LfuCache
 {
     //=============================================================================================
@@ -28,7 +31,7 @@ public:
     //=============================================================================================
     // public variables.
     //=============================================================================================
-    /* NOTHING */
+    using EvictFunc = std::function<void(const K& key, V& value)>;
 
     //=============================================================================================
     // public methods.
@@ -36,6 +39,10 @@ public:
 
     //---------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
+    //!             最大収容可能数分のノードと頻度バケット，ハッシュテーブルをここで確保し，
+    //!             以降の操作では確保を行いません.
+    //!
+    //! @param[in]      capacity        最大収容可能数です.
     //---------------------------------------------------------------------------------------------
     LfuCache(size_t capacity);
 
@@ -46,57 +53,194 @@ public:
 
     //---------------------------------------------------------------------------------------------
     //! @brief      要素を追加します.
+    //!             追加済みの場合は使用頻度を1増やしてヒット，そうでなければミスとして数えます.
+    //!
+    //! @param[in]      item        追加する要素.
+    //! @retval true    追加に成功.
+    //! @retval false   最大収容可能数が0です.
     //---------------------------------------------------------------------------------------------
-    void Add(const T& item);
+    bool Add(const K& item);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      要素の削除します.
+    //! @brief      値を追加します.
+    //!             追加済みの場合は値を更新して使用頻度を1増やします. ヒット数とミス数は数えません.
+    //!             収まらない場合は使用頻度が最も低い要素のうち，最も古く使った要素を追い出します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[in]      value       値です.
+    //! @retval true    追加に成功.
+    //! @retval false   最大収容可能数が0です.
     //---------------------------------------------------------------------------------------------
-    void Remove(const T& item);
+    bool Add(const K& key, const V& value);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      全要素を削除します.
+    //! @brief      値を検索し，見つかった場合は使用頻度を1増やします.
+    //!
+    //! @param[in]      key         キーです.
+    //! @return     値へのポインタを返却します. 見つからない場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    V* Find(const K& key);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      使用頻度を変えずに値を検索します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @return     値へのポインタを返却します. 見つからない場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    const V* Peek(const K& key) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を削除します. 追い出し時の関数は呼び出しません.
+    //!
+    //! @param[in]      item        削除する要素.
+    //! @retval true    削除しました.
+    //! @retval false   要素が含まれていません.
+    //---------------------------------------------------------------------------------------------
+    bool Remove(const K& item);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全要素を削除します. 追い出し時の関数は呼び出しません.
     //---------------------------------------------------------------------------------------------
     void Clear();
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      要素が含まれているか判定します.
+    //! @brief      要素が含まれているか判定します. 使用頻度は変えません.
+    //!
+    //! @return     指定要素が含まれている場合には true を返却します.
+    //---------------------------------------------------------------------------------------------
+    bool Contains(const K& item) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief     追い出す順(使用頻度が低く，古く使った順)に配列にコピーします.
+    //---------------------------------------------------------------------------------------------
+    void Copy(K* pArray, size_t offset) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      使用頻度を半分(最低1)に減衰させます.
+    //!             かつて頻繁に使われた要素も，使われなくなれば追い出せるようになります.
+    //!             同じ頻度になったバケットを統合するため，要素数に比例した時間がかかります.
+    //---------------------------------------------------------------------------------------------
+    void Decay();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      自動で減衰させる間隔を設定します.
+    //!             Add(), Find() による使用がこの回数に達するごとに Decay() を呼び出します.
+    //!             最大収容可能数以上にすると，減衰の時間は1操作あたり定数時間に収まります.
+    //!
+    //! @param[in]      interval    減衰させる間隔です. 0の場合は自動で減衰させません.
+    //---------------------------------------------------------------------------------------------
+    void SetDecayInterval(uint64_t interval);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を追い出したときに呼び出す関数を設定します.
+    //!             容量を超えて追い出す場合にのみ呼び出します.
+    //!
+    //! @param[in]      func        呼び出す関数です.
     //---------------------------------------------------------------------------------------------
-    bool Contains(const T& item) const;
+    void SetEvictFunc(const EvictFunc& func);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      配列にコピーします.
+    //! @brief      要素の使用頻度を取得します.
+    //!
+    //! @param[in]      item        要素です.
+    //! @return     使用頻度を返却します. 含まれていない場合は0を返却します.
     //---------------------------------------------------------------------------------------------
-    void Copy(T* pArray, size_t offset) const;
+    uint64_t GetFrequency(const K& item) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヒット数, ミス数, 追い出し数を取得します.
+    //!
+    //! @return     統計情報を返却します.
+    //---------------------------------------------------------------------------------------------
+    CacheStats GetStats() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヒット数, ミス数, 追い出し数を0に戻します.
+    //---------------------------------------------------------------------------------------------
+    void ResetStats();
 
     //---------------------------------------------------------------------------------------------
     //! @brief      最大収容可能数を取得します.
+    //!
+    //! @return     最大収容可能数を返却します.
     //---------------------------------------------------------------------------------------------
     size_t GetCapacity() const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      現在の収容数を取得します.
+    //!
+    //! @return     現在の収容数を返却します.
     //---------------------------------------------------------------------------------------------
     size_t GetCount() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      確保しているメモリサイズを取得します.
+    //!
+    //! @return     オブジェクト, ノード, ハッシュテーブル, 頻度バケットのバイト数を返却します.
+    //!             キーや値が内部で確保するメモリは含みません.
+    //---------------------------------------------------------------------------------------------
+    size_t GetMemorySize() const;
+
 private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Node structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Node
+    {
+        K           Key;        //!< キーです.
+        V           Value;      //!< 値です.
+        uint32_t    Bucket;     //!< 所属する頻度バケットです.
+        uint32_t    Prev;       //!< バケット内で1つ新しいノードです.
+        uint32_t    Next;       //!< バケット内で1つ古いノードです. 空きノードでは次の空きノードです.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Bucket structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Bucket
+    {
+        uint64_t    Frequency;  //!< 使用頻度です.
+        uint32_t    Head;       //!< 最も新しく使ったノードです.
+        uint32_t    Tail;       //!< 最も古く使ったノードです.
+        uint32_t    Prev;       //!< 1つ低い頻度のバケットです.
+        uint32_t    Next;       //!< 1つ高い頻度のバケットです. 空きバケットでは次の空きバケットです.
+    };
+
+    static const uint32_t kInvalid = CacheIndex<K, H>::kInvalid;
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    size_t                 m_Capacity;
-    std::map<T, size_t>    m_Cache;
+    size_t              m_Capacity;         //!< 最大収容可能数.
+    size_t              m_Count;            //!< 現在の収容数.
+    std::vector<Node>   m_Nodes;            //!< ノードプールです.
+    std::vector<Bucket> m_Buckets;          //!< 頻度バケットのプールです.
+    CacheIndex<K, H>    m_Index;            //!< キーからノード番号へのハッシュテーブルです.
+    uint32_t            m_MinBucket;        //!< 最も低い頻度のバケットです.
+    uint32_t            m_FreeNode;         //!< 空きノードリストの先頭です.
+    uint32_t            m_FreeBucket;       //!< 空きバケットリストの先頭です.
+    uint64_t            m_DecayInterval;    //!< 自動で減衰させる間隔です.
+    uint64_t            m_DecayCounter;     //!< 前回の減衰からの使用回数です.
+    CacheStats          m_Stats;            //!< 統計情報です.
+    EvictFunc           m_EvictFunc;        //!< 追い出し時に呼び出す関数です.
 
     //=============================================================================================
     // private methods.
     //=============================================================================================
-    /* NOTHING */
+    uint32_t AllocBucket(uint64_t frequency, uint32_t prev, uint32_t next);
+    void     FreeBucket (uint32_t bucket);
+    void     PushNode   (uint32_t bucket, uint32_t node);
+    void     PopNode    (uint32_t node);
+    void     Touch      (uint32_t node);
+    void     Evict      ();
+    void     FreeNode   (uint32_t node);
+    void     CountUse   ();
 };
 
 } // namespace asdx
 
 
 //-------------------------------------------------------------------------------------------------
-// Inline Files
+// Inline Files.
 //-------------------------------------------------------------------------------------------------
 #include <asdxLfuCache.inl>
-
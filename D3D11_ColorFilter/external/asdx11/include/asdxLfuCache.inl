@@ -15,103 +15,498 @@ namespace asdx {
 //-------------------------------------------------------------------------------------------------
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-LfuCache<T>::LfuCache(size_t capacity)
-: m_Capacity(capacity)
-, m_Cache()
-{ /* DO_NOTHING */ }
+template<typename K, typename V, typename H> inline
+LfuCache<K, V, H>::LfuCache(size_t capacity)
+: m_Capacity     (capacity)
+, m_Count        (0)
+, m_Nodes        ()
+, m_Buckets      ()
+, m_Index        ()
+, m_MinBucket    (kInvalid)
+, m_FreeNode     (kInvalid)
+, m_FreeBucket   (kInvalid)
+, m_DecayInterval(0)
+, m_DecayCounter (0)
+, m_Stats        ()
+, m_EvictFunc    ()
+{
+    // ノード番号は32bitで管理する.
+    assert(capacity < kInvalid);
+
+    // 空でないバケットは1つ以上のノードを持つので，バケット数はノード数を超えない.
+    m_Nodes  .resize(capacity);
+    m_Buckets.resize(capacity);
+    m_Index.Init(capacity);
+    Clear();
+}
 
 //-------------------------------------------------------------------------------------------------
 //      デストラクタです.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-LfuCache<T>::~LfuCache()
+template<typename K, typename V, typename H> inline
+LfuCache<K, V, H>::~LfuCache()
 { Clear(); }
 
 //-------------------------------------------------------------------------------------------------
 //      要素を追加します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-void LfuCache<T>::Add(const T& item)
+template<typename K, typename V, typename H> inline
+bool LfuCache<K, V, H>::Add(const K& item)
 {
-    if ( Contains(item) )
+    if (m_Capacity == 0)
+    { return false; }
+
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(item, keyOf);
+    if (node != kInvalid)
     {
-        m_Cache[item]++;
+        m_Stats.Hits++;
+        Touch(node);
+        CountUse();
+        return true;
     }
-    else if ( m_Cache.size() < m_Capacity )
+
+    m_Stats.Misses++;
+    return Add(item, V());
+}
+
+//-------------------------------------------------------------------------------------------------
+//      値を追加します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool LfuCache<K, V, H>::Add(const K& key, const V& value)
+{
+    if (m_Capacity == 0)
+    { return false; }
+
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(key, keyOf);
+    if (node != kInvalid)
     {
-        m_Cache[item] = 1;
+        m_Nodes[node].Value = value;
+        Touch(node);
+        CountUse();
+        return true;
     }
-    else
-    {
-        auto iter = m_Cache.begin();
-        auto mini = (*iter).second;
 
-        for(auto& it = m_Cache.begin(); it != m_Cache.end(); ++it )
-        {
-            if ((*it).second < mini )
-            {
-                mini = (*it).second;
-                iter = it;
-            }
-        }
+    if (m_Count >= m_Capacity)
+    { Evict(); }
+
+    node       = m_FreeNode;
+    m_FreeNode = m_Nodes[node].Next;
+    m_Nodes[node].Key   = key;
+    m_Nodes[node].Value = value;
+    m_Index.Insert(key, node);
+    m_Count++;
+
+    // 新しい要素は頻度1のバケットに入れる.
+    auto bucket = m_MinBucket;
+    if (bucket == kInvalid || m_Buckets[bucket].Frequency != 1)
+    { bucket = AllocBucket(1, kInvalid, m_MinBucket); }
+
+    PushNode(bucket, node);
+    CountUse();
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      値を検索し，見つかった場合は使用頻度を1増やします.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+V* LfuCache<K, V, H>::Find(const K& key)
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
 
-        m_Cache.erase(iter);
-        m_Cache[item] = 1;
+    auto node = m_Index.Find(key, keyOf);
+    if (node == kInvalid)
+    {
+        m_Stats.Misses++;
+        return nullptr;
     }
+
+    m_Stats.Hits++;
+    Touch(node);
+
+    // 減衰でノードは移動しないので，値へのポインタはそのまま使える.
+    CountUse();
+    return &m_Nodes[node].Value;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使用頻度を変えずに値を検索します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+const V* LfuCache<K, V, H>::Peek(const K& key) const
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(key, keyOf);
+    if (node == kInvalid)
+    { return nullptr; }
+
+    return &m_Nodes[node].Value;
 }
 
 //-------------------------------------------------------------------------------------------------
 //      要素を削除します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-void LfuCache<T>::Remove(const T& item)
+template<typename K, typename V, typename H> inline
+bool LfuCache<K, V, H>::Remove(const K& item)
 {
-    auto iter = m_Cache.find(item);
-    if (iter != m_Cache.end())
-    { m_Cache.erase(iter); }
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Erase(item, keyOf);
+    if (node == kInvalid)
+    { return false; }
+
+    auto bucket = m_Nodes[node].Bucket;
+    PopNode(node);
+    if (m_Buckets[bucket].Head == kInvalid)
+    { FreeBucket(bucket); }
+
+    FreeNode(node);
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
 //      全要素を削除します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-void LfuCache<T>::Clear()
-{ m_Cache.clear(); }
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::Clear()
+{
+    // 値が保持しているリソースをここで解放する.
+    for(auto b = m_MinBucket; b != kInvalid; b = m_Buckets[b].Next)
+    {
+        for(auto i = m_Buckets[b].Head; i != kInvalid; i = m_Nodes[i].Next)
+        {
+            m_Nodes[i].Key   = K();
+            m_Nodes[i].Value = V();
+        }
+    }
+
+    auto count = uint32_t(m_Nodes.size());
+    for(auto i=0u; i<count; ++i)
+    {
+        m_Nodes  [i].Next = (i + 1 < count) ? i + 1 : kInvalid;
+        m_Buckets[i].Next = (i + 1 < count) ? i + 1 : kInvalid;
+    }
+
+    m_Index.Clear();
+    m_MinBucket    = kInvalid;
+    m_FreeNode     = (count > 0) ? 0 : kInvalid;
+    m_FreeBucket   = (count > 0) ? 0 : kInvalid;
+    m_Count        = 0;
+    m_DecayCounter = 0;
+}
 
 //-------------------------------------------------------------------------------------------------
 //      要素が含まれているか判定します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-bool LfuCache<T>::Contains(const T& item) const
-{ return m_Cache.find(item) != m_Cache.cend(); }
+template<typename K, typename V, typename H> inline
+bool LfuCache<K, V, H>::Contains(const K& item) const
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+    return m_Index.Find(item, keyOf) != kInvalid;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      追い出す順に配列にコピーします.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::Copy(K* pArray, size_t offset) const
+{
+    for(auto b = m_MinBucket; b != kInvalid; b = m_Buckets[b].Next)
+    {
+        for(auto i = m_Buckets[b].Tail; i != kInvalid; i = m_Nodes[i].Prev)
+        {
+            pArray[offset] = m_Nodes[i].Key;
+            offset++;
+        }
+    }
+}
 
 //-------------------------------------------------------------------------------------------------
-//      配列にコピーします.
+//      使用頻度を半分に減衰させます.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-void LfuCache<T>::Copy(T* pArray, size_t offset) const
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::Decay()
 {
-    for( auto& itr = m_Cache.cbegin(); itr != m_Cache.cend(); ++itr )
+    // 半分にしても頻度の順序は崩れないので，同じ頻度になるのは隣り合うバケットだけ.
+    auto prev = kInvalid;
+    for(auto b = m_MinBucket; b != kInvalid;)
     {
-        pArray[offset] = (*itr).first;
-        offset++;
+        auto next      = m_Buckets[b].Next;
+        auto frequency = m_Buckets[b].Frequency >> 1;
+        if (frequency == 0)
+        { frequency = 1; }
+
+        if (prev == kInvalid || m_Buckets[prev].Frequency != frequency)
+        {
+            m_Buckets[b].Frequency = frequency;
+            prev = b;
+            b    = next;
+            continue;
+        }
+
+        // 元の頻度が高かったノードを新しい側につなげて，先に追い出されないようにする.
+        auto& src = m_Buckets[b];
+        auto& dst = m_Buckets[prev];
+        for(auto i = src.Head; i != kInvalid; i = m_Nodes[i].Next)
+        { m_Nodes[i].Bucket = prev; }
+
+        m_Nodes[src.Tail].Next = dst.Head;
+        m_Nodes[dst.Head].Prev = src.Tail;
+        dst.Head = src.Head;
+        src.Head = kInvalid;
+        src.Tail = kInvalid;
+
+        FreeBucket(b);
+        b = next;
     }
+
+    m_DecayCounter = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      自動で減衰させる間隔を設定します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::SetDecayInterval(uint64_t interval)
+{
+    m_DecayInterval = interval;
+    m_DecayCounter  = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要素を追い出したときに呼び出す関数を設定します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::SetEvictFunc(const EvictFunc& func)
+{ m_EvictFunc = func; }
+
+//-------------------------------------------------------------------------------------------------
+//      要素の使用頻度を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+uint64_t LfuCache<K, V, H>::GetFrequency(const K& item) const
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(item, keyOf);
+    if (node == kInvalid)
+    { return 0; }
+
+    return m_Buckets[m_Nodes[node].Bucket].Frequency;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+CacheStats LfuCache<K, V, H>::GetStats() const
+{ return m_Stats; }
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を0に戻します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::ResetStats()
+{ m_Stats = CacheStats(); }
+
 //-------------------------------------------------------------------------------------------------
 //      最大収容可能数を取得します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-size_t LfuCache<T>::GetCapacity() const
+template<typename K, typename V, typename H> inline
+size_t LfuCache<K, V, H>::GetCapacity() const
 { return m_Capacity; }
 
 //-------------------------------------------------------------------------------------------------
 //      現在の収容数を取得します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-size_t LfuCache<T>::GetCount() const
-{ return m_Cache.size(); }
+template<typename K, typename V, typename H> inline
+size_t LfuCache<K, V, H>::GetCount() const
+{ return m_Count; }
+
+//-------------------------------------------------------------------------------------------------
+//      確保しているメモリサイズを取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t LfuCache<K, V, H>::GetMemorySize() const
+{
+    return sizeof(*this)
+         + m_Nodes.capacity() * sizeof(Node)
+         + m_Buckets.capacity() * sizeof(Bucket)
+         + m_Index.GetMemorySize();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      頻度バケットを確保して prev と next の間につなげます.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+uint32_t LfuCache<K, V, H>::AllocBucket(uint64_t frequency, uint32_t prev, uint32_t next)
+{
+    auto bucket  = m_FreeBucket;
+    auto& item   = m_Buckets[bucket];
+    m_FreeBucket = item.Next;
+
+    item.Frequency = frequency;
+    item.Head      = kInvalid;
+    item.Tail      = kInvalid;
+    item.Prev      = prev;
+    item.Next      = next;
+
+    if (prev != kInvalid)
+    { m_Buckets[prev].Next = bucket; }
+    else
+    { m_MinBucket = bucket; }
+
+    if (next != kInvalid)
+    { m_Buckets[next].Prev = bucket; }
+
+    return bucket;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      空になった頻度バケットを外して空きバケットリストに戻します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::FreeBucket(uint32_t bucket)
+{
+    auto& item = m_Buckets[bucket];
+
+    if (item.Prev != kInvalid)
+    { m_Buckets[item.Prev].Next = item.Next; }
+    else
+    { m_MinBucket = item.Next; }
+
+    if (item.Next != kInvalid)
+    { m_Buckets[item.Next].Prev = item.Prev; }
+
+    item.Next    = m_FreeBucket;
+    m_FreeBucket = bucket;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードを頻度バケットの先頭につなげます.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::PushNode(uint32_t bucket, uint32_t node)
+{
+    auto& owner = m_Buckets[bucket];
+    auto& item  = m_Nodes[node];
+
+    item.Bucket = bucket;
+    item.Prev   = kInvalid;
+    item.Next   = owner.Head;
+
+    if (owner.Head != kInvalid)
+    { m_Nodes[owner.Head].Prev = node; }
+    else
+    { owner.Tail = node; }
+
+    owner.Head = node;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードを頻度バケットから外します. 空になったバケットは呼び出し側で解放します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::PopNode(uint32_t node)
+{
+    auto& item  = m_Nodes[node];
+    auto& owner = m_Buckets[item.Bucket];
+
+    if (item.Prev != kInvalid)
+    { m_Nodes[item.Prev].Next = item.Next; }
+    else
+    { owner.Head = item.Next; }
+
+    if (item.Next != kInvalid)
+    { m_Nodes[item.Next].Prev = item.Prev; }
+    else
+    { owner.Tail = item.Prev; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードを1つ高い頻度のバケットに移します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::Touch(uint32_t node)
+{
+    auto bucket    = m_Nodes[node].Bucket;
+    auto frequency = m_Buckets[bucket].Frequency + 1;
+    auto next      = m_Buckets[bucket].Next;
+    auto hasNext   = (next != kInvalid && m_Buckets[next].Frequency == frequency);
+
+    // 1つだけのノードならバケットごと頻度を上げれば済む.
+    if (!hasNext && m_Buckets[bucket].Head == m_Buckets[bucket].Tail)
+    {
+        m_Buckets[bucket].Frequency = frequency;
+        return;
+    }
+
+    if (!hasNext)
+    { next = AllocBucket(frequency, bucket, next); }
+
+    PopNode(node);
+    if (m_Buckets[bucket].Head == kInvalid)
+    { FreeBucket(bucket); }
+
+    PushNode(next, node);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使用頻度が最も低く，最も古く使った要素を追い出します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::Evict()
+{
+    auto bucket = m_MinBucket;
+    auto node   = m_Buckets[bucket].Tail;
+    auto keyOf  = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    PopNode(node);
+    if (m_Buckets[bucket].Head == kInvalid)
+    { FreeBucket(bucket); }
+
+    m_Index.Erase(m_Nodes[node].Key, keyOf);
+    m_Stats.Evictions++;
+
+    if (m_EvictFunc)
+    { m_EvictFunc(m_Nodes[node].Key, m_Nodes[node].Value); }
+
+    FreeNode(node);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードを空きノードリストに戻します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::FreeNode(uint32_t node)
+{
+    auto& item = m_Nodes[node];
+    m_Count--;
+
+    item.Key   = K();
+    item.Value = V();
+    item.Next  = m_FreeNode;
+    m_FreeNode = node;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使用回数を数え，間隔に達したら減衰させます.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LfuCache<K, V, H>::CountUse()
+{
+    if (m_DecayInterval == 0)
+    { return; }
 
+    m_DecayCounter++;
+    if (m_DecayCounter >= m_DecayInterval)
+    { Decay(); }
+}
 
 } // namespace asdx
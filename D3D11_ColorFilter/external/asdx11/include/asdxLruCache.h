@@ -8,8 +8,10 @@
 //-------------------------------------------------------------------------------------------------
 // Includes
 //-------------------------------------------------------------------------------------------------
-#include <list>
-#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <vector>
+#include <asdxCacheIndex.h>
 
 
 namespace asdx {
@@ -17,7 +19,7 @@ namespace asdx {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // LruCache class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-template<typename T>
+template<typename K, typename V = CacheNoValue, typename H = std::hash<K>>
 class LruCache
 {
     //=============================================================================================
@@ -29,7 +31,7 @@ public:
     //=============================================================================================
     // public variables.
     //=============================================================================================
-    /* NOTHING */
+    using EvictFunc = std::function<void(const K& key, V& value)>;
 
     //=============================================================================================
     // public methods.
@@ -37,8 +39,12 @@ public:
 
     //---------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
+    //!             最大収容可能数分のノードとハッシュテーブルをここで確保し，以降の操作では確保を行いません.
+    //!
+    //! @param[in]      capacity        最大収容可能数です.
+    //! @param[in]      capacityBytes   最大収容可能バイト数です. 0の場合はバイト数で制限しません.
     //---------------------------------------------------------------------------------------------
-    LruCache(size_t capacity);
+    LruCache(size_t capacity, size_t capacityBytes = 0);
 
     //---------------------------------------------------------------------------------------------
     //! @brief      デストラクタです.
@@ -47,34 +53,84 @@ public:
 
     //---------------------------------------------------------------------------------------------
     //! @brief      要素を追加します.
+    //!             追加済みの場合は最も新しく使った要素にします.
     //!
     //! @param[in]      item        追加する要素.
+    //! @retval true    追加に成功.
+    //! @retval false   最大収容可能数が0です.
+    //---------------------------------------------------------------------------------------------
+    bool Add(const K& item);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      値を追加します.
+    //!             追加済みの場合は値とバイト数を更新し，最も新しく使った要素にします.
+    //!             収まらない場合は最も古く使った要素から追い出します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[in]      value       値です.
+    //! @param[in]      bytes       要素のバイト数です.
+    //! @retval true    追加に成功.
+    //! @retval false   最大収容可能数が0か，1要素で最大収容可能バイト数を超えています.
+    //---------------------------------------------------------------------------------------------
+    bool Add(const K& key, const V& value, size_t bytes = 0);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      値を検索し，最も新しく使った要素にします.
+    //!
+    //! @param[in]      key         キーです.
+    //! @return     値へのポインタを返却します. 見つからない場合は nullptr を返却します.
     //---------------------------------------------------------------------------------------------
-    void Add(const T& item);
+    V* Find(const K& key);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      要素を削除します.
+    //! @brief      使用順序を変えずに値を検索します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @return     値へのポインタを返却します. 見つからない場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    const V* Peek(const K& key) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を削除します. 追い出し時の関数は呼び出しません.
     //!
     //! @param[in]      item        削除する要素.
+    //! @retval true    削除しました.
+    //! @retval false   要素が含まれていません.
     //---------------------------------------------------------------------------------------------
-    void Remove(const T& item);
+    bool Remove(const K& item);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      全要素を削除します.
+    //! @brief      全要素を削除します. 追い出し時の関数は呼び出しません.
     //---------------------------------------------------------------------------------------------
     void Clear();
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      要素が含まれているか判定します.
+    //! @brief      要素が含まれているか判定します. 使用順序は変えません.
     //!
     //! @return     指定要素が含まれている場合には true を返却します.
     //---------------------------------------------------------------------------------------------
-    bool Contains(const T& item) const;
+    bool Contains(const K& item) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief     古く使った順に配列にコピーします.
+    //---------------------------------------------------------------------------------------------
+    void Copy(K* pArray, size_t offset) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を追い出したときに呼び出す関数を設定します.
+    //!             容量を超えて追い出す場合にのみ呼び出します.
+    //!
+    //! @param[in]      func        呼び出す関数です.
+    //---------------------------------------------------------------------------------------------
+    void SetEvictFunc(const EvictFunc& func);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief     配列にコピーします.
+    //! @brief      最大収容可能バイト数を設定します.
+    //!             超えている場合は最も古く使った要素から追い出します.
+    //!
+    //! @param[in]      capacityBytes   最大収容可能バイト数です. 0の場合はバイト数で制限しません.
     //---------------------------------------------------------------------------------------------
-    void Copy(T* pArray, size_t offset) const;
+    void SetCapacityBytes(size_t capacityBytes);
 
     //---------------------------------------------------------------------------------------------
     //! @brief      最大収容可能数を取得します.
@@ -83,6 +139,13 @@ public:
     //---------------------------------------------------------------------------------------------
     size_t GetCapacity() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最大収容可能バイト数を取得します.
+    //!
+    //! @return     最大収容可能バイト数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetCapacityBytes() const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      現在の収容数を取得します.
     //!
@@ -91,30 +154,78 @@ public:
     size_t GetCount() const;
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      先頭要素を取得します.
+    //! @brief      現在の収容バイト数を取得します.
+    //!
+    //! @return     現在の収容バイト数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetBytes() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素のバイト数を取得します. 使用順序は変えません.
     //!
-    //! @return     先頭要素を返却します.
+    //! @param[in]      item        要素です.
+    //! @return     追加時に指定したバイト数を返却します. 含まれていない場合は0を返却します.
     //---------------------------------------------------------------------------------------------
-    T GetFront() const;
+    size_t GetItemBytes(const K& item) const;
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      末尾要素を取得します.
+    //! @brief      確保しているメモリサイズを取得します.
     //!
-    //! @return     末尾要素を取得します.
+    //! @return     オブジェクト, ノード, ハッシュテーブルのバイト数を返却します.
+    //!             キーや値が内部で確保するメモリは含みません.
     //---------------------------------------------------------------------------------------------
-    T GetBack() const;
+    size_t GetMemorySize() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      先頭要素(最も新しく使った要素)を取得します.
+    //!
+    //! @return     先頭要素を返却します. 空の場合は呼び出してはいけません.
+    //---------------------------------------------------------------------------------------------
+    K GetFront() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      末尾要素(次に追い出す要素)を取得します.
+    //!
+    //! @return     末尾要素を返却します. 空の場合は呼び出してはいけません.
+    //---------------------------------------------------------------------------------------------
+    K GetBack() const;
 
 private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Node structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Node
+    {
+        K           Key;        //!< キーです.
+        V           Value;      //!< 値です.
+        size_t      Bytes;      //!< バイト数です.
+        uint32_t    Prev;       //!< 1つ新しいノードです. 空きノードでは使いません.
+        uint32_t    Next;       //!< 1つ古いノードです. 空きノードでは次の空きノードです.
+    };
+
+    static const uint32_t kInvalid = CacheIndex<K, H>::kInvalid;
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    size_t          m_Capacity;     //!< 最大収容可能数.
-    std::list<T>    m_Cache;        //!< キャッシュです.
+    size_t              m_Capacity;         //!< 最大収容可能数.
+    size_t              m_CapacityBytes;    //!< 最大収容可能バイト数.
+    size_t              m_Count;            //!< 現在の収容数.
+    size_t              m_Bytes;            //!< 現在の収容バイト数.
+    std::vector<Node>   m_Nodes;            //!< ノードプールです.
+    CacheIndex<K, H>    m_Index;            //!< キーからノード番号へのハッシュテーブルです.
+    uint32_t            m_Head;             //!< 最も新しく使ったノードです.
+    uint32_t            m_Tail;             //!< 最も古く使ったノードです.
+    uint32_t            m_Free;             //!< 空きノードリストの先頭です.
+    EvictFunc           m_EvictFunc;        //!< 追い出し時に呼び出す関数です.
 
     //=============================================================================================
     // private methods.
     //=============================================================================================
-    /* NOTHING */
+    void Link  (uint32_t node);
+    void Unlink(uint32_t node);
+    void Evict ();
+    void Free  (uint32_t node);
 };
 
 } // namespace asdx
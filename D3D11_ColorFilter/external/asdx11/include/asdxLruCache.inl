@@ -15,95 +15,368 @@ namespace asdx {
 //-------------------------------------------------------------------------------------------------
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-LruCache<T>::LruCache(size_t capacity)
-: m_Cache()
-, m_Capacity(capacity)
-{ /* DO_NOTHING */ }
+template<typename K, typename V, typename H> inline
+LruCache<K, V, H>::LruCache(size_t capacity, size_t capacityBytes)
+: m_Capacity     (capacity)
+, m_CapacityBytes(capacityBytes)
+, m_Count        (0)
+, m_Bytes        (0)
+, m_Nodes        ()
+, m_Index        ()
+, m_Head         (kInvalid)
+, m_Tail         (kInvalid)
+, m_Free         (kInvalid)
+, m_EvictFunc    ()
+{
+    // ノード番号は32bitで管理する.
+    assert(capacity < kInvalid);
+
+    m_Nodes.resize(capacity);
+    m_Index.Init(capacity);
+    Clear();
+}
 
 //-------------------------------------------------------------------------------------------------
 //      デストラクタです.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-LruCache<T>::~LruCache()
+template<typename K, typename V, typename H> inline
+LruCache<K, V, H>::~LruCache()
 { Clear(); }
 
 //-------------------------------------------------------------------------------------------------
 //      要素を追加します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-void LruCache<T>::Add(const T& item)
+template<typename K, typename V, typename H> inline
+bool LruCache<K, V, H>::Add(const K& item)
 {
-    if ( Contains(item) )
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(item, keyOf);
+    if (node != kInvalid)
     {
-        m_Cache.remove(item);
-        m_Cache.push_back(item);
+        Unlink(node);
+        Link(node);
+        return true;
     }
-    else if ( m_Cache.size() < m_Capacity )
+
+    return Add(item, V(), 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      値を追加します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool LruCache<K, V, H>::Add(const K& key, const V& value, size_t bytes)
+{
+    if (m_Capacity == 0)
+    { return false; }
+
+    if (m_CapacityBytes != 0 && bytes > m_CapacityBytes)
+    { return false; }
+
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    // 追加済みのノードは追い出されないようにリストから外しておく.
+    auto node = m_Index.Find(key, keyOf);
+    if (node != kInvalid)
     {
-        m_Cache.push_back(item);
+        Unlink(node);
+        m_Bytes -= m_Nodes[node].Bytes;
     }
-    else
+
+    while(m_Tail != kInvalid)
+    {
+        auto overCount = (node == kInvalid && m_Count >= m_Capacity);
+        auto overBytes = (m_CapacityBytes != 0 && m_Bytes + bytes > m_CapacityBytes);
+        if (!overCount && !overBytes)
+        { break; }
+
+        Evict();
+    }
+
+    if (node == kInvalid)
+    {
+        node   = m_Free;
+        m_Free = m_Nodes[node].Next;
+        m_Nodes[node].Key = key;
+        m_Index.Insert(key, node);
+        m_Count++;
+    }
+
+    m_Nodes[node].Value = value;
+    m_Nodes[node].Bytes = bytes;
+    m_Bytes += bytes;
+    Link(node);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      値を検索し，最も新しく使った要素にします.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+V* LruCache<K, V, H>::Find(const K& key)
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(key, keyOf);
+    if (node == kInvalid)
+    { return nullptr; }
+
+    if (node != m_Head)
     {
-        m_Cache.pop_front();
-        m_Cache.push_back(item);
+        Unlink(node);
+        Link(node);
     }
+
+    return &m_Nodes[node].Value;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使用順序を変えずに値を検索します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+const V* LruCache<K, V, H>::Peek(const K& key) const
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(key, keyOf);
+    if (node == kInvalid)
+    { return nullptr; }
+
+    return &m_Nodes[node].Value;
 }
 
 //-------------------------------------------------------------------------------------------------
 //      要素を削除します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-void LruCache<T>::Remove(const T& item)
-{ m_Cache.remove(item); }
+template<typename K, typename V, typename H> inline
+bool LruCache<K, V, H>::Remove(const K& item)
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Erase(item, keyOf);
+    if (node == kInvalid)
+    { return false; }
+
+    Unlink(node);
+    Free(node);
+    return true;
+}
 
 //-------------------------------------------------------------------------------------------------
 //      全要素を削除します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-void LruCache<T>::Clear()
-{ m_Cache.clear(); }
+template<typename K, typename V, typename H> inline
+void LruCache<K, V, H>::Clear()
+{
+    // 値が保持しているリソースをここで解放する.
+    for(auto i = m_Head; i != kInvalid; i = m_Nodes[i].Next)
+    {
+        m_Nodes[i].Key   = K();
+        m_Nodes[i].Value = V();
+    }
+
+    auto count = uint32_t(m_Nodes.size());
+    for(auto i=0u; i<count; ++i)
+    { m_Nodes[i].Next = (i + 1 < count) ? i + 1 : kInvalid; }
+
+    m_Index.Clear();
+    m_Head  = kInvalid;
+    m_Tail  = kInvalid;
+    m_Free  = (count > 0) ? 0 : kInvalid;
+    m_Count = 0;
+    m_Bytes = 0;
+}
 
 //-------------------------------------------------------------------------------------------------
 //      要素が含まれているか判定します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-bool LruCache<T>::Contains(const T& item) const
-{ return std::find(m_Cache.cbegin(), m_Cache.cend(), item) != m_Cache.cend(); }
+template<typename K, typename V, typename H> inline
+bool LruCache<K, V, H>::Contains(const K& item) const
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+    return m_Index.Find(item, keyOf) != kInvalid;
+}
 
 //-------------------------------------------------------------------------------------------------
-//      配列にコピーします.
+//      古く使った順に配列にコピーします.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-void LruCache<T>::Copy(T* pArray, size_t offset) const
+template<typename K, typename V, typename H> inline
+void LruCache<K, V, H>::Copy(K* pArray, size_t offset) const
 {
-    for( auto& itr = m_Cache.cbegin(); itr != m_Cache.cend(); itr++ )
+    for(auto i = m_Tail; i != kInvalid; i = m_Nodes[i].Prev)
     {
-        pArray[offset] = *itr;
+        pArray[offset] = m_Nodes[i].Key;
         offset++;
     }
 }
 
+//-------------------------------------------------------------------------------------------------
+//      要素を追い出したときに呼び出す関数を設定します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LruCache<K, V, H>::SetEvictFunc(const EvictFunc& func)
+{ m_EvictFunc = func; }
+
+//-------------------------------------------------------------------------------------------------
+//      最大収容可能バイト数を設定します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LruCache<K, V, H>::SetCapacityBytes(size_t capacityBytes)
+{
+    m_CapacityBytes = capacityBytes;
+    if (m_CapacityBytes == 0)
+    { return; }
+
+    while(m_Tail != kInvalid && m_Bytes > m_CapacityBytes)
+    { Evict(); }
+}
+
 //-------------------------------------------------------------------------------------------------
 //      最大収容可能数を取得します.
 //-------------------------------------------------------------------------------------------------
-template<typename T> inline
-size_t LruCache<T>::GetCapacity() const
+template<typename K, typename V, typename H> inline
+size_t LruCache<K, V, H>::GetCapacity() const
 { return m_Capacity; }
 
+//-------------------------------------------------------------------------------------------------
+//      最大収容可能バイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t LruCache<K, V, H>::GetCapacityBytes() const
+{ return m_CapacityBytes; }
+
 //-------------------------------------------------------------------------------------------------
 //      現在の収容数を取得します.
-//--------------------------------------------------------------------------------------------------
-template<typename T> inline
-size_t LruCache<T>::GetCount() const
-{ return m_Cache.size(); }
-
-template<typename T> inline
-T LruCache<T>::GetFront() const
-{ return *m_Cache.cend(); }
-
-template<typename T> inline
-T LruCache<T>::GetBack() const
-{ return *m_Cache.cbegin();}
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t LruCache<K, V, H>::GetCount() const
+{ return m_Count; }
+
+//-------------------------------------------------------------------------------------------------
+//      現在の収容バイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t LruCache<K, V, H>::GetBytes() const
+{ return m_Bytes; }
+
+//-------------------------------------------------------------------------------------------------
+//      要素のバイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t LruCache<K, V, H>::GetItemBytes(const K& item) const
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(item, keyOf);
+    if (node == kInvalid)
+    { return 0; }
+
+    return m_Nodes[node].Bytes;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      確保しているメモリサイズを取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t LruCache<K, V, H>::GetMemorySize() const
+{
+    return sizeof(*this)
+         + m_Nodes.capacity() * sizeof(Node)
+         + m_Index.GetMemorySize();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      先頭要素を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+K LruCache<K, V, H>::GetFront() const
+{
+    assert(m_Head != kInvalid);
+    return m_Nodes[m_Head].Key;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      末尾要素を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+K LruCache<K, V, H>::GetBack() const
+{
+    assert(m_Tail != kInvalid);
+    return m_Nodes[m_Tail].Key;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードを先頭につなげます.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LruCache<K, V, H>::Link(uint32_t node)
+{
+    auto& item = m_Nodes[node];
+    item.Prev = kInvalid;
+    item.Next = m_Head;
+
+    if (m_Head != kInvalid)
+    { m_Nodes[m_Head].Prev = node; }
+    else
+    { m_Tail = node; }
+
+    m_Head = node;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードをリストから外します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LruCache<K, V, H>::Unlink(uint32_t node)
+{
+    auto& item = m_Nodes[node];
+
+    if (item.Prev != kInvalid)
+    { m_Nodes[item.Prev].Next = item.Next; }
+    else
+    { m_Head = item.Next; }
+
+    if (item.Next != kInvalid)
+    { m_Nodes[item.Next].Prev = item.Prev; }
+    else
+    { m_Tail = item.Prev; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最も古く使った要素を追い出します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LruCache<K, V, H>::Evict()
+{
+    auto node = m_Tail;
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    Unlink(node);
+    m_Index.Erase(m_Nodes[node].Key, keyOf);
+
+    if (m_EvictFunc)
+    { m_EvictFunc(m_Nodes[node].Key, m_Nodes[node].Value); }
+
+    Free(node);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードを空きノードリストに戻します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void LruCache<K, V, H>::Free(uint32_t node)
+{
+    auto& item = m_Nodes[node];
+    m_Count--;
+    m_Bytes -= item.Bytes;
+
+    item.Key   = K();
+    item.Value = V();
+    item.Bytes = 0;
+    item.Next  = m_Free;
+    m_Free     = node;
+}
 
 } // namespace asdx
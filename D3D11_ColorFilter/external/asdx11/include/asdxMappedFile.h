@@ -0,0 +1,109 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxMappedFile.h
+// Desc : Memory Mapped File Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MappedFile class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class MappedFile
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    MappedFile();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~MappedFile();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルをメモリにマップします.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @param[in]      copyOnWrite     true の場合は書き込み時コピーでマップします.
+    //!                                 書き込んだページだけがプロセス専用に複製され，ファイルには反映されません.
+    //! @retval true    マップに成功.
+    //! @retval false   マップに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Open(const wchar_t* filename, bool copyOnWrite = false);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      マップを解除し，ファイルを閉じます.
+    //---------------------------------------------------------------------------------------------
+    void Close();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      マップされているかどうかチェックします.
+    //!
+    //! @retval true    マップ済みです.
+    //! @retval false   マップされていません.
+    //---------------------------------------------------------------------------------------------
+    bool IsOpen() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイル先頭へのポインタを取得します.
+    //!
+    //! @return     ファイル先頭へのポインタを返却します.
+    //---------------------------------------------------------------------------------------------
+    const uint8_t* GetData() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      書き込み可能なファイル先頭へのポインタを取得します.
+    //!
+    //! @return     書き込み時コピーでマップしている場合はファイル先頭へのポインタ，それ以外は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint8_t* GetWritableData() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルサイズを取得します.
+    //!
+    //! @return     ファイルサイズを返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetSize() const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    void*           m_hFile;        //!< ファイルハンドルです.
+    void*           m_hMapping;     //!< ファイルマッピングハンドルです.
+    uint8_t*        m_pData;        //!< マップされた先頭アドレスです.
+    size_t          m_Size;         //!< ファイルサイズです.
+    bool            m_Writable;     //!< 書き込み時コピーでマップしているかどうか.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    MappedFile      (const MappedFile&) = delete;
+    void operator = (const MappedFile&) = delete;
+};
+
+} // namespace asdx
@@ -258,7 +258,8 @@ uint32_t     Comb( uint32_t n, uint32_t r );
 //! @brief      float型からhalf型に変換します.
 //!
 //! @param [in]     value       half型に変換する値.
-//! @return     半精度浮動小数表現に変換した結果を返却します.
+//! @return     半精度浮動小数表現に最近接偶数丸めで変換した結果を返却します.
+//! @note       範囲外の値は無限大に，NaNはクワイエットNaNになります(F16C命令と同じ結果です).
 //--------------------------------------------------------------------------------------------------
 half     floatTohalf( float value );
 
@@ -267,9 +268,32 @@ half     floatTohalf( float value );
 //!
 //! @param [in]     value       float型に変換する値.
 //! @return     単精度浮動小数表現に変換した結果を返却します.
+//! @note       NaNはクワイエットNaNになります(F16C命令と同じ結果です).
 //--------------------------------------------------------------------------------------------------
 float     halfTofloat( half value );
 
+//--------------------------------------------------------------------------------------------------
+//! @brief      float型の配列をhalf型の配列に変換します.
+//!
+//! @param [in]     pSrc        変換元の配列.
+//! @param [out]    pDst        変換先の配列.
+//! @param [in]     count       要素数.
+//! @note       F16C命令が使える場合はF16C命令で，それ以外はSSE2で分岐なしに変換します.
+//!             結果は floatTohalf( float ) を1要素ずつ呼び出した場合とビット単位で一致します.
+//--------------------------------------------------------------------------------------------------
+void     floatTohalf( const float* pSrc, half* pDst, size_t count );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      half型の配列をfloat型の配列に変換します.
+//!
+//! @param [in]     pSrc        変換元の配列.
+//! @param [out]    pDst        変換先の配列.
+//! @param [in]     count       要素数.
+//! @note       F16C命令が使える場合はF16C命令で，それ以外はSSE2で分岐なしに変換します.
+//!             結果は halfTofloat( half ) を1要素ずつ呼び出した場合とビット単位で一致します.
+//--------------------------------------------------------------------------------------------------
+void     halfTofloat( const half* pSrc, float* pDst, size_t count );
+
 //--------------------------------------------------------------------------------------------------
 //! @brief      線形補間を行います.
 //!
@@ -193,88 +193,87 @@ uint32_t Comb( uint32_t n, uint32_t r )
 //-------------------------------------------------------------------------------------------------
 //      32bit 浮動小数から 16bit 浮動小数に変換します.
 //-------------------------------------------------------------------------------------------------
-inline 
-half floatToF16( float value )
+inline
+half floatTohalf( float value )
 {
-    half result;
-
-    // ビット列を崩さないままuint32_t型に変換.
-    uint32_t bit = *reinterpret_cast<uint32_t*>( &value );
+    uint32_t bit;
+    memcpy( &bit, &value, sizeof(bit) );
 
     // float表現の符号bitを取り出し.
-    uint32_t sign   = ( bit & 0x80000000U) >> 16U;
+    auto sign = static_cast<half>( ( bit >> 16U ) & 0x8000U );
 
     // 符号部を削ぎ落す.
-    bit     = bit & 0x7FFFFFFFU;
+    bit &= 0x7FFFFFFFU;
 
-    // halfとして表現する際に値がデカ過ぎる場合は，無限大にクランプ.
-    if ( bit > 0x47FFEFFFU)
-    { result = 0x7FFFU; }
-    else
+    // NaNはF16C命令と同じく，仮数部の上位10bitを残してクワイエットNaNにする.
+    if ( bit > 0x7F800000U )
+    { return sign | static_cast<half>( 0x7E00U | ( ( bit >> 13U ) & 0x3FFU ) ); }
+
+    // halfとして表現する際に値がデカ過ぎる場合は，無限大にする.
+    if ( bit >= 0x477FF000U )
+    { return sign | 0x7C00U; }
+
+    // 正規化されたhalfとして表現するには小さすぎる値は，正規化されていない値に変換.
+    if ( bit < 0x38800000U )
     {
-        // 正規化されたhalfとして表現するために小さすぎる値は正規化されていない値に変換.
-        if ( bit < 0x38800000U)
-        {
-            uint32_t shift = 113U - ( bit >> 23U);
-            bit    = (0x800000U | ( bit & 0x7FFFFFU)) >> shift;
-        }
-        else
-        {
-            // 正規化されたhalfとして表現するために指数部に再度バイアスをかける
-            bit += 0xC8000000U;
-        }
-
-        // half型表現にする.
-        result = (( bit + 0x0FFFU + (( bit >> 13U) & 1U)) >> 13U) & 0x7FFFU; 
+        // 2^-25 以下は0に丸まる.
+        if ( bit <= 0x33000000U )
+        { return sign; }
+
+        uint32_t shift    = 126U - ( bit >> 23U );
+        uint32_t mantissa = 0x800000U | ( bit & 0x7FFFFFU );
+        uint32_t result   = mantissa >> shift;
+        uint32_t rest     = mantissa & ( ( 1U << shift ) - 1U );
+        uint32_t halfway  = 1U << ( shift - 1U );
+
+        // 最近接偶数丸め.
+        if ( rest > halfway || ( rest == halfway && ( result & 1U ) ) )
+        { result++; }
+
+        return sign | static_cast<half>( result );
     }
 
-    // 符号部を付け足して返却.
-    return static_cast<half>( result | sign );
+    // 指数部に再度バイアスをかけて，最近接偶数丸めでhalf型表現にする.
+    return sign | static_cast<half>( ( bit - 0x38000000U + 0x0FFFU + ( ( bit >> 13U ) & 1U ) ) >> 13U );
 }
 
 //-------------------------------------------------------------------------------------------------
 //      16bit 浮動小数から　32bit 浮動小数に変換します.
 //-------------------------------------------------------------------------------------------------
-inline 
-float F16Tofloat( half value )
+inline
+float halfTofloat( half value )
 {
-    uint32_t exponent;
-    uint32_t result;
-
-    // 仮数
+    uint32_t sign     = static_cast<uint32_t>( value & 0x8000 ) << 16;
+    uint32_t exponent = static_cast<uint32_t>( ( value >> 10 ) & 0x1F );
     uint32_t mantissa = static_cast<uint32_t>( value & 0x03FF );
+    uint32_t result;
 
+    // 無限大とNaN. NaNはF16C命令と同じくクワイエットNaNにする.
+    if ( exponent == 0x1F )
+    { result = sign | 0x7F800000U | ( ( mantissa != 0 ) ? 0x400000U : 0 ) | ( mantissa << 13 ); }
     // 正規化済みの場合.
-    if ( ( value & 0x7C00 ) != 0 )
-    {
-        // 指数部を計算.
-        exponent = static_cast<uint32_t>( ( value >> 10 ) & 0x1F );
-    }
+    else if ( exponent != 0 )
+    { result = sign | ( ( exponent + 112 ) << 23 ) | ( mantissa << 13 ); }
     // 正規化されていない場合.
     else if ( mantissa != 0 )
     {
         // 結果となるfloatで値を正規化する.
-        exponent = 1;
+        exponent = 113;
 
         do {
             exponent--;
             mantissa <<= 1;
-        } while ( ( mantissa & 0x0400 ) == 0);
+        } while ( ( mantissa & 0x0400 ) == 0 );
 
-        mantissa &= 0x03FF;
+        result = sign | ( exponent << 23 ) | ( ( mantissa & 0x03FF ) << 13 );
     }
     // 値がゼロの場合.
     else
-    {
-        // 指数部を計算.
-        exponent = (uint32_t)-112;
-    }
-
-    result = ( ( value & 0x8000 ) << 16) | // 符号部.
-             ( ( exponent + 112 ) << 23) | // 指数部.
-             ( mantissa << 13 );           // 仮数部.
+    { result = sign; }
 
-    return *reinterpret_cast<float*>( &result );
+    float output;
+    memcpy( &output, &result, sizeof(output) );
+    return output;
 }
 
 //-------------------------------------------------------------------------------------------------
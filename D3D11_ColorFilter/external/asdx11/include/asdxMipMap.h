@@ -0,0 +1,72 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxMipMap.h
+// Desc : MipMap Generator Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+struct ResTexture;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MIP_FILTER enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum MIP_FILTER
+{
+    MIP_FILTER_BOX = 0,     //!< ボックスフィルタです. 2のべき乗サイズでは2x2の平均になります.
+    MIP_FILTER_KAISER,      //!< カイザー窓付きsincフィルタです(半径3).
+    MIP_FILTER_LANCZOS,     //!< ランチョスフィルタです(半径3).
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ミップマップを生成できるフォーマットかどうかチェックします.
+//!
+//! @param[in]      format      DXGIフォーマットです.
+//! @retval true    8bit/16bit UNORM(SRGBを含む), 16bit/32bit FLOAT のいずれかです.
+//! @retval false   ミップマップを生成できないフォーマットです.
+//-------------------------------------------------------------------------------------------------
+bool IsMipMapGeneratable(uint32_t format);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      最上位ミップレベルのサイズから完全なミップレベル数を求めます.
+//!
+//! @param[in]      width       横幅です.
+//! @param[in]      height      縦幅です.
+//! @return     1x1になるまでのミップレベル数を返却します.
+//-------------------------------------------------------------------------------------------------
+uint32_t CalcMipMapCount(uint32_t width, uint32_t height);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      リソーステクスチャのミップマップを生成します.
+//!
+//! @param[in]      src             入力テクスチャです. 各サーフェイスの最上位ミップレベルのみを使用します.
+//! @param[out]     dst             生成結果の格納先です. 全サーフェイス・全ミップレベルを1つのブロックに格納します.
+//!                                 格納先が保持していたデータは解放しないので，事前に Release() を呼び出してください.
+//! @param[in]      filter          縮小フィルタです.
+//! @param[in]      mipCount        生成するミップレベル数です. 0の場合は1x1まで生成します.
+//! @param[in]      alphaCutoff     アルファテストの閾値です. 0より大きい場合は各ミップレベルで閾値を超える割合が
+//!                                 最上位ミップレベルと同じになるようにアルファをスケールします.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//! @note       各ミップレベルは最上位ミップレベルから直接縮小するので，2のべき乗でないサイズでも誤差が蓄積しません.
+//!             SRGBフォーマットは線形空間でフィルタリングします. キューブマップと配列テクスチャは面ごとに処理します.
+//!             ミップレベルと行ブロックの単位で複数スレッドに分割して処理します. ボリュームテクスチャには対応していません.
+//-------------------------------------------------------------------------------------------------
+bool GenerateMipMaps(
+    const ResTexture&   src,
+    ResTexture&         dst,
+    MIP_FILTER          filter      = MIP_FILTER_BOX,
+    uint32_t            mipCount    = 0,
+    float               alphaCutoff = 0.0f);
+
+} // namespace asdx
@@ -0,0 +1,61 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxParallelFor.h
+// Desc : Parallel For Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      範囲を分割して並列に処理します.
+//!
+//! @param[in]      count       処理する要素数です.
+//! @param[in]      minCount    1スレッドあたりの最小要素数です. 小さな範囲でスレッドを起こさないようにします.
+//! @param[in]      func        処理関数です. func(begin, end) の形式で [begin, end) の範囲を処理します.
+//! @note       先頭の範囲は呼び出しスレッドで処理し，全ての範囲の処理が終わるまで戻りません.
+//-------------------------------------------------------------------------------------------------
+template<typename Func>
+void ParallelFor(uint32_t count, uint32_t minCount, Func func)
+{
+    if (minCount == 0)
+    { minCount = 1; }
+
+    auto threadCount = uint32_t(std::thread::hardware_concurrency());
+    auto maxCount    = (count + minCount - 1) / minCount;
+    if (threadCount > maxCount)
+    { threadCount = maxCount; }
+
+    if (threadCount <= 1)
+    {
+        func(0u, count);
+        return;
+    }
+
+    auto chunk = (count + threadCount - 1) / threadCount;
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+
+    for(uint32_t begin = chunk; begin < count; begin += chunk)
+    {
+        auto end = (begin + chunk < count) ? begin + chunk : count;
+        threads.emplace_back(func, begin, end);
+    }
+
+    // 先頭の範囲は呼び出しスレッドで処理する.
+    func(0u, (chunk < count) ? chunk : count);
+
+    for(auto& thread : threads)
+    { thread.join(); }
+}
+
+} // namespace asdx
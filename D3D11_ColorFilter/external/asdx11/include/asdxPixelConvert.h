@@ -0,0 +1,128 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxPixelConvert.h
+// Desc : Pixel Format Conversion Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PIXEL_FORMAT enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum PIXEL_FORMAT
+{
+    PIXEL_FORMAT_UNKNOWN = 0,           //!< 不明なフォーマットです.
+    PIXEL_FORMAT_R8_UNORM,              //!< グレースケール 8bit です. 書き込み時はRチャンネルを格納します.
+    PIXEL_FORMAT_R8G8_UNORM,            //!< グレースケール + アルファ 8bit です.
+    PIXEL_FORMAT_R16_UNORM,             //!< グレースケール 16bit です. 書き込み時はRチャンネルを格納します.
+    PIXEL_FORMAT_R8G8B8_UNORM,          //!< RGB 24bit です.
+    PIXEL_FORMAT_B8G8R8_UNORM,          //!< BGR 24bit です(TGA, BMP のフルカラー).
+    PIXEL_FORMAT_R8G8B8A8_UNORM,        //!< RGBA 32bit です.
+    PIXEL_FORMAT_R8G8B8A8_UNORM_SRGB,   //!< RGBA 32bit(sRGB) です.
+    PIXEL_FORMAT_B8G8R8A8_UNORM,        //!< BGRA 32bit です.
+    PIXEL_FORMAT_B8G8R8A8_UNORM_SRGB,   //!< BGRA 32bit(sRGB) です.
+    PIXEL_FORMAT_B8G8R8X8_UNORM,        //!< BGRX 32bit です. 読み込み時のアルファは1になります.
+    PIXEL_FORMAT_R16G16B16A16_UNORM,    //!< RGBA 64bit です.
+    PIXEL_FORMAT_B5G6R5_UNORM,          //!< 16bit(R:5, G:6, B:5) です.
+    PIXEL_FORMAT_B5G5R5A1_UNORM,        //!< 16bit(A:1, R:5, G:5, B:5) です.
+    PIXEL_FORMAT_B5G5R5X1_UNORM,        //!< 16bit(X:1, R:5, G:5, B:5) です. 最上位ビットは無視します.
+    PIXEL_FORMAT_B4G4R4A4_UNORM,        //!< 16bit(A:4, R:4, G:4, B:4) です.
+    PIXEL_FORMAT_R16G16B16A16_FLOAT,    //!< RGBA 半精度浮動小数です.
+    PIXEL_FORMAT_R32G32B32_FLOAT,       //!< RGB 単精度浮動小数です.
+    PIXEL_FORMAT_R32G32B32A32_FLOAT,    //!< RGBA 単精度浮動小数です.
+    PIXEL_FORMAT_R8G8B8E8_SHAREDEXP,    //!< Radiance HDR の RGBE です.
+    PIXEL_FORMAT_R9G9B9E5_SHAREDEXP,    //!< 9bit仮数 x 3 + 5bit共有指数です. 負の値は0に，65408を超える値は65408になります.
+
+    PIXEL_FORMAT_COUNT
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CONVERSION_ERROR structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CONVERSION_ERROR
+{
+    float   MaxAbsError;    //!< RGB成分の最大絶対誤差です.
+    float   MaxRelError;    //!< ピクセルごとの相対誤差(最大絶対誤差 / 基準の最大成分)の最大値です.
+    float   MeanRelError;   //!< ピクセルごとの相対誤差の平均値です.
+    float   RMSError;       //!< RGB成分の二乗平均平方根誤差です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      1ピクセルあたりのバイト数を取得します.
+//!
+//! @param[in]      format      ピクセルフォーマットです.
+//! @return     1ピクセルあたりのバイト数を返却します. 不明なフォーマットの場合は0を返却します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GetPixelFormatSize(PIXEL_FORMAT format);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      DXGIフォーマットに対応するピクセルフォーマットを取得します.
+//!
+//! @param[in]      dxgiFormat      DXGIフォーマットです.
+//! @return     対応するピクセルフォーマットを返却します. 対応しない場合は PIXEL_FORMAT_UNKNOWN を返却します.
+//-------------------------------------------------------------------------------------------------
+PIXEL_FORMAT GetPixelFormatFromDXGI(uint32_t dxgiFormat);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ピクセルフォーマットを変換します.
+//!
+//! @param[in]      pSrc        変換元ピクセルです.
+//! @param[in]      srcFormat   変換元フォーマットです.
+//! @param[out]     pDst        変換先ピクセルです. 同じフォーマット同士の場合を除き，入力と重なってはいけません.
+//! @param[in]      dstFormat   変換先フォーマットです.
+//! @param[in]      width       横幅です.
+//! @param[in]      height      縦幅です.
+//! @param[in]      srcPitch    変換元の行ピッチです. 0の場合は詰めて並んでいるものとします.
+//! @param[in]      dstPitch    変換先の行ピッチです. 0の場合は詰めて並べます.
+//! @retval true    変換に成功.
+//! @retval false   変換に失敗.
+//! @note       sRGBフォーマットとそれ以外の間ではテーブルで色空間を変換します. 浮動小数と16bitフォーマットはリニアとして扱います.
+//!             アルファを持たないフォーマットから変換した場合，アルファは1になります.
+//!             大きな画像は行単位で分割して並列に変換します.
+//-------------------------------------------------------------------------------------------------
+bool ConvertPixels(
+    const void*     pSrc,
+    PIXEL_FORMAT    srcFormat,
+    void*           pDst,
+    PIXEL_FORMAT    dstFormat,
+    uint32_t        width,
+    uint32_t        height,
+    uint32_t        srcPitch = 0,
+    uint32_t        dstPitch = 0);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      変換による誤差を計測します.
+//!
+//! @param[in]      pReference      基準となるピクセルです.
+//! @param[in]      referenceFormat 基準となるピクセルのフォーマットです.
+//! @param[in]      pResult         変換後のピクセルです.
+//! @param[in]      resultFormat    変換後のピクセルのフォーマットです.
+//! @param[in]      width           横幅です.
+//! @param[in]      height          縦幅です.
+//! @param[out]     result          計測結果です.
+//! @param[in]      referencePitch  基準となるピクセルの行ピッチです. 0の場合は詰めて並んでいるものとします.
+//! @param[in]      resultPitch     変換後のピクセルの行ピッチです. 0の場合は詰めて並んでいるものとします.
+//! @retval true    計測に成功.
+//! @retval false   計測に失敗.
+//! @note       両方を浮動小数に戻して，RGB成分のみを比較します. アルファは比較しません.
+//!             HDRソースを R9G9B9E5 や半精度浮動小数に詰めた際の精度確認に使います.
+//-------------------------------------------------------------------------------------------------
+bool MeasureConversionError(
+    const void*         pReference,
+    PIXEL_FORMAT        referenceFormat,
+    const void*         pResult,
+    PIXEL_FORMAT        resultFormat,
+    uint32_t            width,
+    uint32_t            height,
+    CONVERSION_ERROR&   result,
+    uint32_t            referencePitch = 0,
+    uint32_t            resultPitch    = 0);
+
+} // namespace asdx
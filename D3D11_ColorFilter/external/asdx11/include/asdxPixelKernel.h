@@ -0,0 +1,98 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxPixelKernel.h
+// Desc : Pixel Kernel Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SIMD_LEVEL enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum SIMD_LEVEL
+{
+    SIMD_LEVEL_SCALAR = 0,      //!< スカラー演算.
+    SIMD_LEVEL_SSE2,            //!< SSE2.
+    SIMD_LEVEL_AVX2,            //!< AVX2.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ピクセルカーネルで使用するSIMDレベルを取得します.
+//!
+//! @return     初回呼び出し時にCPUIDから判定したSIMDレベルを返却します.
+//-------------------------------------------------------------------------------------------------
+SIMD_LEVEL GetSimdLevel();
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ピクセルカーネルで使用するSIMDレベルを設定します.
+//!
+//! @param[in]      level       設定するSIMDレベルです. CPUが対応していない場合は対応レベルに丸めます.
+//! @note       性能比較用です. 通常は呼び出す必要はありません.
+//-------------------------------------------------------------------------------------------------
+void SetSimdLevel(SIMD_LEVEL level);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      同じピクセル値で埋めます(ランレングスの展開に使用します).
+//!
+//! @param[out]     pDst            出力先です.
+//! @param[in]      pValue          埋めるピクセル値です.
+//! @param[in]      bytePerPixel    1ピクセルあたりのバイト数です.
+//! @param[in]      count           ピクセル数です.
+//-------------------------------------------------------------------------------------------------
+void FillPixels(uint8_t* pDst, const uint8_t* pValue, uint32_t bytePerPixel, uint32_t count);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      BGR形式をRGB形式に変換します.
+//!
+//! @param[in]      pSrc        入力(3byte/pixel)です.
+//! @param[out]     pDst        出力(3byte/pixel)です. 入力と重なってはいけません.
+//! @param[in]      count       ピクセル数です.
+//-------------------------------------------------------------------------------------------------
+void SwizzleBGRToRGB(const uint8_t* pSrc, uint8_t* pDst, uint32_t count);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      BGR形式をRGBA形式に変換します. アルファは255になります.
+//!
+//! @param[in]      pSrc        入力(3byte/pixel)です.
+//! @param[out]     pDst        出力(4byte/pixel)です. 入力と重なってはいけません.
+//! @param[in]      count       ピクセル数です.
+//-------------------------------------------------------------------------------------------------
+void SwizzleBGRToRGBA(const uint8_t* pSrc, uint8_t* pDst, uint32_t count);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      BGRA形式をRGBA形式に変換します.
+//!
+//! @param[in]      pSrc        入力(4byte/pixel)です.
+//! @param[out]     pDst        出力(4byte/pixel)です. 入力と同じアドレスでも構いません.
+//! @param[in]      count       ピクセル数です.
+//-------------------------------------------------------------------------------------------------
+void SwizzleBGRAToRGBA(const uint8_t* pSrc, uint8_t* pDst, uint32_t count);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      8bitインデックスをカラーマップでRGBA形式に展開します.
+//!
+//! @param[in]      pIndices    インデックスです.
+//! @param[in]      pPalette    RGBA形式(メモリ順)のカラーマップ(256エントリー)です.
+//! @param[out]     pDst        出力(4byte/pixel)です.
+//! @param[in]      count       ピクセル数です.
+//-------------------------------------------------------------------------------------------------
+void ExpandPaletteRGBA(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, uint32_t count);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      8bitインデックスをカラーマップでRGB形式に展開します.
+//!
+//! @param[in]      pIndices    インデックスです.
+//! @param[in]      pPalette    RGBA形式(メモリ順)のカラーマップ(256エントリー)です. アルファは無視されます.
+//! @param[out]     pDst        出力(3byte/pixel)です.
+//! @param[in]      count       ピクセル数です.
+//-------------------------------------------------------------------------------------------------
+void ExpandPaletteRGB(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, uint32_t count);
+
+} // namespace asdx
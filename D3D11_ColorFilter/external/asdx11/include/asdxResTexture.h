@@ -9,10 +9,16 @@
 // Includes
 //-------------------------------------------------------------------------------------------------
 #include <cstdint>
+#include <cstddef>
 
 
 namespace asdx {
 
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+class MappedFile;
+
 template<typename T>
 void SafeDeleteArray(T*&ptr)
 {
@@ -63,6 +69,54 @@ struct SubResource
 };
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IResTextureAllocator interface
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct IResTextureAllocator
+{
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    virtual ~IResTextureAllocator()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリを確保します. 複数のスレッドから呼び出される場合があります.
+    //!
+    //! @param[in]      size        確保するバイト数です.
+    //! @param[in]      alignment   アラインメントです(2のべき乗).
+    //! @return     確保したメモリを返却します. 確保できない場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    virtual void* Allocate( size_t size, size_t alignment ) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      Allocate() で確保したメモリを解放します.
+    //!
+    //! @param[in]      ptr         解放するメモリです.
+    //---------------------------------------------------------------------------------------------
+    virtual void Free( void* ptr ) = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureLoadOptions structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// 読み込み1回ごとの設定です. 呼び出し元が指定し，デコード中は変わりません.
+//
+// HdrFormat は DXGI_FORMAT_R9G9B9E5_SHAREDEXP, DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT,
+// DXGI_FORMAT_R32G32B32A32_FLOAT のいずれかです. 既定値の R9G9B9E5_SHAREDEXP は R32G32B32A32_FLOAT の
+// 1/4のメモリで済みますが，負の値を扱えず，相対誤差は最大で 1/512 程度になります.
+// 値はファイルに格納されたリニアな放射輝度のままで，露出やガンマは適用しません.
+struct TextureLoadOptions
+{
+    uint32_t    HdrFormat;      //!< Radiance HDRファイルから生成するテクスチャのDXGIフォーマットです.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです. 既定値で初期化します.
+    //---------------------------------------------------------------------------------------------
+    TextureLoadOptions();
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // ResTexture structure
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -76,6 +130,16 @@ struct ResTexture
     uint32_t             SurfaceCount;   //!< サーフェイス数です(1次元配列テクスチャ, 2次元配列テクスチャ, キューブマップの場合のみ1以上の数が入ります).
     uint32_t             Option;         //!< オプションフラグです.
     SubResource*         pResources;     //!< サブリソースです.
+    uint8_t*             pBlock;         //!< サブリソースが共有するピクセルデータを new[] で確保したブロックです. Release() で delete[] します.
+    MappedFile*          pMappedFile;    //!< サブリソースが参照するマップ済みファイルです. Release() で閉じます.
+    IResTextureAllocator* pAllocator;    //!< サブリソースの配列とピクセルデータを1つのブロックで確保したアロケータです. Release() で pResources を返却します.
+
+    // ピクセルデータの所有者は次のいずれか1つです.
+    //  - pAllocator が有効: pResources から始まるアロケータのブロック(pBlock, pMappedFile は nullptr).
+    //  - pMappedFile が有効: マップ済みファイル(pBlock は nullptr).
+    //  - pBlock が有効: new[] で確保したブロック.
+    //  - いずれも nullptr: サブリソースごとに new[] で確保したピクセルデータ.
+    // pAllocator 以外の場合，pResources は new[] で確保しています.
 
     //---------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
@@ -89,51 +153,467 @@ struct ResTexture
     , SurfaceCount  ( 0 )
     , Option        ( 0 )
     , pResources    ( nullptr )
+    , pBlock        ( nullptr )
+    , pMappedFile   ( nullptr )
+    , pAllocator    ( nullptr )
     { /* DO_NOTHING */ }
 
     //---------------------------------------------------------------------------------------------
     //! @brief      解放処理を行います.
     //---------------------------------------------------------------------------------------------
-    void Release()
-    {
-        uint32_t mipCount = ( MipMapCount > 0 ) ? MipMapCount : 1;
-
-        for( uint32_t i=0; i<SurfaceCount * mipCount; ++i )
-        { pResources[i].Release(); }
-
-        SafeDeleteArray( pResources );
-    }
+    void Release();
 
     //---------------------------------------------------------------------------------------------
     //! @brief      ファイルからテクスチャリソースを生成します.
-    //!             読み込み可能なファイルはDDS, BMP, JPG, PNG, TIFF, GIF, HDP, TGAです.
+    //!             読み込み可能なファイルはDDS, BMP, JPG, PNG, TIFF, GIF, HDP, TGA, HDR(Radiance), ATEX(クックドテクスチャ)と，
+    //!             RegisterTextureCodec() で登録した形式です. 形式は拡張子ではなくファイルの内容から判定します.
     //!
     //! @param[in]      filename        ファイル名です.
+    //! @param[in]      pOptions        読み込み設定です. nullptrの場合は既定値を使います.
     //! @retval true    リソース生成に成功.
     //! @retval false   リソース生成に失敗.
     //---------------------------------------------------------------------------------------------
-    bool LoadFromFileA( const char* filename );
+    bool LoadFromFileA( const char* filename, const TextureLoadOptions* pOptions = nullptr );
 
     //---------------------------------------------------------------------------------------------
     //! @brief      ファイルからテクスチャリソースを生成します.
-    //!             読み込み可能なファイルはDDS, BMP, JPG, PNG, TIFF, GIF, HDP, TGAです.
+    //!             読み込み可能なファイルはDDS, BMP, JPG, PNG, TIFF, GIF, HDP, TGA, HDR(Radiance), ATEX(クックドテクスチャ)と，
+    //!             RegisterTextureCodec() で登録した形式です. 形式は拡張子ではなくファイルの内容から判定します.
     //!
     //! @param[in]      filename        ファイル名です.
+    //! @param[in]      pOptions        読み込み設定です. nullptrの場合は既定値を使います.
     //! @retval true    リソース生成に成功.
     //! @retval false   リソース生成に失敗.
     //---------------------------------------------------------------------------------------------
-    bool LoadFromFileW( const wchar_t* filename );
+    bool LoadFromFileW( const wchar_t* filename, const TextureLoadOptions* pOptions = nullptr );
 
     //---------------------------------------------------------------------------------------------
     //! @brief      メモリストリームからテクスチャリソースを生成します.
-    //!             メモリストリームの形式は DDS, BMP, JPG, PNG, TIFF, GIF, HDP, である必要があります.
+    //!             メモリストリームの形式は DDS, ATEX, TGA, HDR, BMP, JPG, PNG, TIFF, GIF, HDP か，登録したコーデックの形式である必要があります.
     //!
     //! @param[in]      pBuffer         バッファです.
     //! @param[in]      bufferSize      バッファサイズです.
+    //! @param[in]      pOptions        読み込み設定です. nullptrの場合は既定値を使います.
+    //! @retval true    リソース生成に成功.
+    //! @retval false   リソース生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool LoadFromMemory( const uint8_t* pBuffer, const uint32_t bufferSize, const TextureLoadOptions* pOptions = nullptr );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルをマップしてテクスチャリソースを生成します.
+    //!             DDSとATEXの場合はサブリソースがマップしたファイルを直接指すため，ピクセルデータのコピーを行いません.
+    //!             それ以外の場合は同じマップからデコードするので，LoadFromFileA() と同じ結果になります.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @param[in]      pOptions        読み込み設定です. nullptrの場合は既定値を使います.
     //! @retval true    リソース生成に成功.
     //! @retval false   リソース生成に失敗.
     //---------------------------------------------------------------------------------------------
-    bool LoadFromMemory( const uint8_t* pBuffer, const uint32_t bufferSize );
+    bool MapFromFileA( const char* filename, const TextureLoadOptions* pOptions = nullptr );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルをマップしてテクスチャリソースを生成します.
+    //!             DDSとATEXの場合はサブリソースがマップしたファイルを直接指すため，ピクセルデータのコピーを行いません.
+    //!             それ以外の場合は同じマップからデコードするので，LoadFromFileW() と同じ結果になります.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @param[in]      pOptions        読み込み設定です. nullptrの場合は既定値を使います.
+    //! @retval true    リソース生成に成功.
+    //! @retval false   リソース生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool MapFromFileW( const wchar_t* filename, const TextureLoadOptions* pOptions = nullptr );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      DDSファイルに保存します.
+    //!             配列テクスチャとキューブマップを表現できるように，常にDX10拡張ヘッダを付けて書き出します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool SaveToDDSA( const char* filename ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      DDSファイルに保存します.
+    //!             配列テクスチャとキューブマップを表現できるように，常にDX10拡張ヘッダを付けて書き出します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool SaveToDDSW( const wchar_t* filename ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      クックドテクスチャ(ATEX)ファイルに保存します.
+    //!             ピクセルデータは現在のフォーマットと行ピッチのまま，サブリソースごとに256byte境界に揃えて書き出します.
+    //!             読み込み時は1回の読み込み(またはマップ)とポインタの設定のみで済みます.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool SaveToCookedA( const char* filename ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      クックドテクスチャ(ATEX)ファイルに保存します.
+    //!             ピクセルデータは現在のフォーマットと行ピッチのまま，サブリソースごとに256byte境界に揃えて書き出します.
+    //!             読み込み時は1回の読み込み(またはマップ)とポインタの設定のみで済みます.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool SaveToCookedW( const wchar_t* filename ) const;
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      テクスチャファイルをクックドテクスチャ(ATEX)ファイルに変換します.
+//!             入力は ResTexture::LoadFromFileA() で読み込めるファイルです.
+//!
+//! @param[in]      srcFilename     入力ファイル名です.
+//! @param[in]      dstFilename     出力ファイル名です.
+//! @retval true    変換に成功.
+//! @retval false   変換に失敗.
+//-------------------------------------------------------------------------------------------------
+bool CookTextureA( const char* srcFilename, const char* dstFilename );
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      テクスチャファイルをクックドテクスチャ(ATEX)ファイルに変換します.
+//!             入力は ResTexture::LoadFromFileW() で読み込めるファイルです.
+//!
+//! @param[in]      srcFilename     入力ファイル名です.
+//! @param[in]      dstFilename     出力ファイル名です.
+//! @retval true    変換に成功.
+//! @retval false   変換に失敗.
+//-------------------------------------------------------------------------------------------------
+bool CookTextureW( const wchar_t* srcFilename, const wchar_t* dstFilename );
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SubResourceLayout structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct SubResourceLayout
+{
+    size_t      Offset;         //!< 確保したブロックの先頭からのオフセットです.
+    uint32_t    Width;          //!< 横幅です.
+    uint32_t    Height;         //!< 縦幅です.
+    uint32_t    Depth;          //!< スライス数です(ボリュームテクスチャ以外は1です).
+    uint32_t    Pitch;          //!< 1行(ブロック圧縮フォーマットの場合はブロック1行)当たりのバイト数です.
+    uint32_t    SlicePitch;     //!< 1スライス当たりのバイト数です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      リソーステクスチャを1回の確保で格納するための配置を求めます.
+//!             ブロックの先頭にサブリソースの配列を置き，続けて各サブリソースのピクセルデータを16byte境界に揃えて並べます.
+//!             サブリソースの並びは (サーフェイス番号 * ミップマップ数 + ミップレベル) の順です.
+//!
+//! @param[in]      desc        Width, Height, Depth, Format, MipMapCount, SurfaceCount, Option を設定したリソーステクスチャです.
+//! @param[out]     pLayouts    サブリソースごとの配置の格納先です(MipMapCount * SurfaceCount 個). nullptrの場合はサイズのみ求めます.
+//! @param[out]     blockSize   ブロック全体のバイト数です.
+//! @retval true    配置の計算に成功.
+//! @retval false   対応しないフォーマットか，サイズが大きすぎます.
+//-------------------------------------------------------------------------------------------------
+bool PlanResTextureLayout( const ResTexture& desc, SubResourceLayout* pLayouts, size_t& blockSize );
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      サブリソースの配列と全てのピクセルデータを1つのブロックとして確保します.
+//!             配置は PlanResTextureLayout() と同じで，確保後は pResources[i].pPixels に直接書き込めます.
+//!
+//! @param[in,out]  texture     Width, Height, Depth, Format, MipMapCount, SurfaceCount, Option を設定したリソーステクスチャです.
+//!                             格納先が保持していたデータは解放しないので，事前に Release() を呼び出してください.
+//! @param[in]      pAllocator  アロケータです. nullptrの場合は GetResTextureAllocator() のアロケータを使います.
+//! @retval true    確保に成功.
+//! @retval false   確保に失敗.
+//! @note       ピクセルデータは初期化しません. 解放は Release() で，確保したアロケータに返却されます.
+//-------------------------------------------------------------------------------------------------
+bool AllocateResTexture( ResTexture& texture, IResTextureAllocator* pAllocator = nullptr );
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      読み込みやミップマップ生成などでリソーステクスチャの確保に使うアロケータを設定します.
+//!
+//! @param[in]      pAllocator  アロケータです. nullptrの場合は既定のヒープアロケータに戻します.
+//! @note       設定はプロセス全体で共有され，以降の確保から反映されます. 確保済みのテクスチャは
+//!             確保したアロケータに返却されるので，アロケータはそれらを全て解放するまで破棄しないでください.
+//-------------------------------------------------------------------------------------------------
+void SetResTextureAllocator( IResTextureAllocator* pAllocator );
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      リソーステクスチャの確保に使うアロケータを取得します.
+//!
+//! @return     設定されたアロケータを返却します. 未設定の場合は既定のヒープアロケータを返却します.
+//-------------------------------------------------------------------------------------------------
+IResTextureAllocator* GetResTextureAllocator();
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureCodec structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TextureCodec
+{
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイル形式を判定する関数です.
+    //!             pBinary はファイル全体を指しますが，マップしたファイルでは参照したページだけが読み込まれます.
+    //---------------------------------------------------------------------------------------------
+    typedef bool (*SniffFunc)( const uint8_t* pBinary, size_t bufferSize );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バイナリからリソーステクスチャを生成する関数です.
+    //!             pBinary は呼び出しの間だけ有効なので，必要なデータはコピーしてください.
+    //!             options は読み込みを要求した呼び出し元の設定で，形式に関係しない項目は無視して構いません.
+    //---------------------------------------------------------------------------------------------
+    typedef bool (*DecodeFunc)( const uint8_t* pBinary, size_t bufferSize, const TextureLoadOptions& options, ResTexture& result );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      マップしたファイルを直接参照してリソーステクスチャを生成する関数です.
+    //!             ファイルは書き込み時コピーでマップされています. 所有権は成否に関わらず関数に移るので，
+    //!             result.pMappedFile に設定するか，失敗時は関数内で解放してください.
+    //---------------------------------------------------------------------------------------------
+    typedef bool (*MapFunc)( MappedFile* pFile, const TextureLoadOptions& options, ResTexture& result );
+
+    const char*     Name;       //!< コーデック名です. 登録済みのものと重複してはいけません.
+    SniffFunc       pSniff;     //!< ファイル形式の判定関数です.
+    DecodeFunc      pDecode;    //!< デコード関数です.
+    MapFunc         pMap;       //!< マップ用の生成関数です. nullptrの場合はマップ時も pDecode で生成します.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      テクスチャコーデックを登録します.
+//!             ファイルやメモリからの読み込み時は，登録されたコーデックを登録順に判定し，
+//!             該当しない場合は組み込みのDDS, ATEX, TGA, HDR，最後にWICの順で判定します.
+//!
+//! @param[in]      codec           登録するコーデックです. Name, pSniff, pDecode は必須です.
+//! @retval true    登録に成功.
+//! @retval false   登録に失敗.
+//-------------------------------------------------------------------------------------------------
+bool RegisterTextureCodec( const TextureCodec& codec );
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageStreamInfo structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ImageStreamInfo
+{
+    uint32_t    Width;      //!< 画像の横幅です.
+    uint32_t    Height;     //!< 画像の縦幅です.
+    uint32_t    Format;     //!< 帯で渡すピクセルのDXGIフォーマットです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IImageSink interface
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct IImageSink
+{
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    virtual ~IImageSink()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画像の受け取りを開始します.
+    //!
+    //! @param[in]      info        画像の情報です.
+    //! @retval true    受け取りを続けます.
+    //! @retval false   受け取りを中断します. 以降のメソッドは呼び出されません.
+    //---------------------------------------------------------------------------------------------
+    virtual bool OnBegin( const ImageStreamInfo& info ) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      帯(横幅全体の連続した行)を受け取ります.
+    //!             帯は上の行から順に隙間なく渡されます. ブロック圧縮フォーマットの場合は y と rowCount が
+    //!             4の倍数(最後の帯の rowCount を除く)になり，pPixels はブロック行を指します.
+    //!
+    //! @param[in]      y           帯の先頭の行です.
+    //! @param[in]      rowCount    帯の行数です.
+    //! @param[in]      pPixels     帯のピクセルデータです. 呼び出しの間だけ有効です.
+    //! @param[in]      pitch       1行(ブロック圧縮フォーマットの場合はブロック1行)あたりのバイト数です.
+    //! @retval true    受け取りを続けます.
+    //! @retval false   受け取りを中断します. 以降のメソッドは呼び出されません.
+    //---------------------------------------------------------------------------------------------
+    virtual bool OnBand( uint32_t y, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch ) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画像の受け取りを終了します. 全ての帯を渡し終えた場合のみ呼び出されます.
+    //!
+    //! @retval true    処理に成功.
+    //! @retval false   処理に失敗.
+    //---------------------------------------------------------------------------------------------
+    virtual bool OnEnd() = 0;
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ファイルを帯ごとにデコードしてシンクに渡します.
+//!             画像全体を展開せずに帯の分だけのバッファでデコードするので，非常に大きな画像も扱えます.
+//!             ファイルは読み込み専用でマップするため，読み終えたページはOSが再利用できます.
+//!             DDSは最初のサーフェイスの最上位ミップレベルを渡します(ボリュームテクスチャは未対応です).
+//!             TGA, HDR, WICで読める形式は LoadFromFileW() と同じフォーマット・同じ行の並びで渡します.
+//!             ATEXと登録したコーデックは全体をデコードしてから帯に分けて渡すため，メモリは削減されません.
+//!
+//! @param[in]      filename        ファイル名です.
+//! @param[in]      pSink           デコード結果を受け取るシンクです.
+//! @param[in]      bandHeight      1つの帯の最大行数です. 0の場合は既定値(64行)を使います.
+//!                                 ブロック圧縮フォーマットでは4の倍数に切り上げます.
+//! @param[in]      pOptions        読み込み設定です. nullptrの場合は既定値を使います.
+//! @retval true    全ての帯を渡し終えました.
+//! @retval false   デコードに失敗したか，シンクが中断しました.
+//-------------------------------------------------------------------------------------------------
+bool StreamImageFromFileW( const wchar_t* filename, IImageSink* pSink, uint32_t bandHeight = 0, const TextureLoadOptions* pOptions = nullptr );
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ファイルを帯ごとにデコードしてシンクに渡します.
+//!             詳細は StreamImageFromFileW() を参照してください.
+//!
+//! @param[in]      filename        ファイル名です.
+//! @param[in]      pSink           デコード結果を受け取るシンクです.
+//! @param[in]      bandHeight      1つの帯の最大行数です. 0の場合は既定値(64行)を使います.
+//! @param[in]      pOptions        読み込み設定です. nullptrの場合は既定値を使います.
+//! @retval true    全ての帯を渡し終えました.
+//! @retval false   デコードに失敗したか，シンクが中断しました.
+//-------------------------------------------------------------------------------------------------
+bool StreamImageFromFileA( const char* filename, IImageSink* pSink, uint32_t bandHeight = 0, const TextureLoadOptions* pOptions = nullptr );
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      メモリ上のファイルイメージを帯ごとにデコードしてシンクに渡します.
+//!             詳細は StreamImageFromFileW() を参照してください.
+//!
+//! @param[in]      pBinary         ファイルイメージです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @param[in]      pSink           デコード結果を受け取るシンクです.
+//! @param[in]      bandHeight      1つの帯の最大行数です. 0の場合は既定値(64行)を使います.
+//! @param[in]      pOptions        読み込み設定です. nullptrの場合は既定値を使います.
+//! @retval true    全ての帯を渡し終えました.
+//! @retval false   デコードに失敗したか，シンクが中断しました.
+//-------------------------------------------------------------------------------------------------
+bool StreamImageFromMemory( const uint8_t* pBinary, size_t bufferSize, IImageSink* pSink, uint32_t bandHeight = 0, const TextureLoadOptions* pOptions = nullptr );
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ResTextureStream class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class ResTextureStream
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ResTextureStream();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~ResTextureStream();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルを開いて段階的な読み込みを開始します.
+    //!             DDSはヘッダのみを解析し，ピクセルデータは LoadNext() で小さいミップレベルから読み込みます.
+    //!             DDS以外は段階的に読み込めないため，この時点で全て読み込みます.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @param[in]      maxSize         読み込む最大解像度です. 横幅か縦幅がこれを超えるミップレベルは読み込みません.
+    //!                                 0の場合は制限しません.
+    //! @param[in]      pOptions        DDS以外を読み込むときの読み込み設定です. nullptrの場合は既定値を使います.
+    //! @retval true    オープンに成功.
+    //! @retval false   オープンに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool OpenA( const char* filename, uint32_t maxSize = 0, const TextureLoadOptions* pOptions = nullptr );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルを開いて段階的な読み込みを開始します.
+    //!             DDSはヘッダのみを解析し，ピクセルデータは LoadNext() で小さいミップレベルから読み込みます.
+    //!             DDS以外は段階的に読み込めないため，この時点で全て読み込みます.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @param[in]      maxSize         読み込む最大解像度です. 横幅か縦幅がこれを超えるミップレベルは読み込みません.
+    //!                                 0の場合は制限しません.
+    //! @param[in]      pOptions        DDS以外を読み込むときの読み込み設定です. nullptrの場合は既定値を使います.
+    //! @retval true    オープンに成功.
+    //! @retval false   オープンに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool OpenW( const wchar_t* filename, uint32_t maxSize = 0, const TextureLoadOptions* pOptions = nullptr );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルを閉じて，読み込んだデータを解放します.
+    //---------------------------------------------------------------------------------------------
+    void Close();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      まだ読み込んでいないミップレベルのうち，最も小さいものを全サーフェイス分読み込みます.
+    //!
+    //! @retval true    1レベル読み込みました.
+    //! @retval false   全て読み込み済みか，オープンされていません.
+    //---------------------------------------------------------------------------------------------
+    bool LoadNext();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全てのミップレベルを読み込んだかどうかチェックします.
+    //!
+    //! @retval true    読み込み完了です.
+    //! @retval false   未読み込みのミップレベルがあります.
+    //---------------------------------------------------------------------------------------------
+    bool IsCompleted() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み込み済みの最も詳細なミップレベルを取得します.
+    //!
+    //! @return     読み込み済みの最も詳細なミップレベルを返却します. 何も読み込んでいない場合はミップマップ数を返却します.
+    //! @note       このレベルからミップマップ数-1 までのサブリソースが読み込み済みです.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetMostDetailedMip() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み込み済みのミップレベル数を取得します.
+    //!
+    //! @return     読み込み済みのミップレベル数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetResidentMipCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み込み先のリソーステクスチャを取得します.
+    //!
+    //! @return     リソーステクスチャを返却します. 最大解像度を超えるミップレベルは含まれません.
+    //!             未読み込みのサブリソースの pPixels は nullptr になります.
+    //---------------------------------------------------------------------------------------------
+    const ResTexture& GetResource() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み込みが完了したリソーステクスチャの所有権を移します.
+    //!
+    //! @param[out]     result          リソーステクスチャの格納先です. 不要になったら Release() を呼び出してください.
+    //! @retval true    所有権の移動に成功.
+    //! @retval false   読み込みが完了していません.
+    //---------------------------------------------------------------------------------------------
+    bool Detach( ResTexture& result );
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    ResTexture      m_Source;           //!< 読み込み元です(サブリソースはマップしたファイルを指します).
+    ResTexture      m_Resource;         //!< 読み込み先です.
+    size_t*         m_pOffsets;         //!< 読み込み先のサブリソースごとのオフセットです.
+    uint32_t        m_SkipMipCount;     //!< 最大解像度を超えるため読み込まないミップレベル数です.
+    uint32_t        m_MostDetailedMip;  //!< 読み込み済みの最も詳細なミップレベルです.
+    bool            m_Swizzle;          //!< ピクセルの並びの補正が必要かどうか.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    ResTextureStream(const ResTextureStream&) = delete;
+    void operator = (const ResTextureStream&) = delete;
 };
 
 
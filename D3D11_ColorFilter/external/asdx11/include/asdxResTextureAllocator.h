@@ -0,0 +1,207 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxResTextureAllocator.h
+// Desc : Resource Texture Allocator Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <mutex>
+#include <asdxResTexture.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ArenaResTextureAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class ArenaResTextureAllocator : public IResTextureAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static const size_t kDefaultChunkSize = 4 * 1024 * 1024;    //!< 既定のチャンクサイズです.
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ArenaResTextureAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~ArenaResTextureAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      chunkSize   1回にまとめて確保するバイト数です. これより大きな要求は個別のチャンクになります.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(size_t chunkSize = kDefaultChunkSize);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います. 確保した全てのメモリを解放します.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      チャンクの末尾から切り出してメモリを確保します.
+    //---------------------------------------------------------------------------------------------
+    void* Allocate(size_t size, size_t alignment) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      何もしません. メモリは Reset() か Term() でまとめて解放します.
+    //---------------------------------------------------------------------------------------------
+    void Free(void* ptr) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      確保したメモリをまとめて破棄します.
+    //!             最初のチャンクだけ残して再利用し，それ以外のチャンクは解放します.
+    //! @note       このアロケータで確保したテクスチャは，呼び出し後に使用してはいけません.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      切り出したバイト数の合計を取得します.
+    //!
+    //! @return     Reset() してから切り出したバイト数の合計を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetUsedSize() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      確保しているチャンクの合計サイズを取得します.
+    //!
+    //! @return     確保しているチャンクの合計バイト数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetReservedSize() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Chunk structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Chunk
+    {
+        Chunk*      pNext;      //!< 次のチャンクです.
+        size_t      Size;       //!< データ部のバイト数です.
+        size_t      Offset;     //!< 次に切り出すデータ部の位置です.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    mutable std::mutex  m_Mutex;        //!< 複数スレッドからの確保を保護します.
+    Chunk*              m_pHead;        //!< 現在切り出しているチャンクです(先頭が最新).
+    size_t              m_ChunkSize;    //!< 1回にまとめて確保するバイト数です.
+    size_t              m_UsedSize;     //!< 切り出したバイト数の合計です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    Chunk* CreateChunk(size_t size);
+    void   DestroyChunks(Chunk* pChunk);
+
+    ArenaResTextureAllocator                (const ArenaResTextureAllocator&) = delete;
+    ArenaResTextureAllocator& operator =    (const ArenaResTextureAllocator&) = delete;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BufferResTextureAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class BufferResTextureAllocator : public IResTextureAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    BufferResTextureAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~BufferResTextureAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pBuffer     呼び出し側が用意したバッファです. 解放は呼び出し側で行います.
+    //! @param[in]      size        バッファのバイト数です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(void* pBuffer, size_t size);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファの先頭から順に切り出してメモリを確保します. 空きが足りない場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    void* Allocate(size_t size, size_t alignment) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      何もしません. メモリは Reset() でまとめて破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Free(void* ptr) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      切り出したメモリをまとめて破棄し，バッファの先頭から使い直します.
+    //! @note       このアロケータで確保したテクスチャは，呼び出し後に使用してはいけません.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      切り出したバイト数を取得します.
+    //!
+    //! @return     アラインメントの余白を含めて切り出したバイト数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetUsedSize() const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    mutable std::mutex  m_Mutex;        //!< 複数スレッドからの確保を保護します.
+    uint8_t*            m_pBuffer;      //!< バッファです.
+    size_t              m_Size;         //!< バッファのバイト数です.
+    size_t              m_Offset;       //!< 次に切り出す位置です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    BufferResTextureAllocator                (const BufferResTextureAllocator&) = delete;
+    BufferResTextureAllocator& operator =    (const BufferResTextureAllocator&) = delete;
+};
+
+} // namespace asdx
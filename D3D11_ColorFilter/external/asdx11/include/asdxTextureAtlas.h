@@ -0,0 +1,241 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxTextureAtlas.h
+// Desc : Texture Atlas Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <asdxMath.h>
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+struct ResTexture;
+class  AtlasPacker;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ATLAS_PACKER enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum ATLAS_PACKER
+{
+    ATLAS_PACKER_MAXRECTS = 0,      //!< MaxRects(Best Short Side Fit)です. 充填率が高くなります.
+    ATLAS_PACKER_SKYLINE,           //!< スカイライン(Bottom Left)です. 充填率は下がりますが高速です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureAtlas class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class TextureAtlas
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Desc structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Desc
+    {
+        uint32_t        Format;         //!< アトラスのDXGIフォーマットです. ConvertPixels() で扱える非圧縮フォーマットである必要があります.
+        uint32_t        Width;          //!< 初期の横幅です. 0の場合は Build() で入力から見積もります.
+        uint32_t        Height;         //!< 初期の縦幅です. 0の場合は Build() で入力から見積もります.
+        uint32_t        MaxWidth;       //!< 拡張できる最大の横幅です.
+        uint32_t        MaxHeight;      //!< 拡張できる最大の縦幅です.
+        ATLAS_PACKER    Packer;         //!< 配置アルゴリズムです.
+        uint32_t        Padding;        //!< 領域間に空けるピクセル数です.
+        uint32_t        Gutter;         //!< 画像の縁を外側に複製するピクセル数です. バイリニアフィルタの滲みを防ぎます.
+        uint32_t        MipCount;       //!< 滲まずに使うミップレベル数です. 2以上の場合は領域を 2^(MipCount-1) ピクセル境界に揃えます.
+        bool            AllowRotation;  //!< 90度回転して配置することを許可するかどうかです.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Region structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Region
+    {
+        uint32_t        X;              //!< 左上のX座標(ピクセル)です. ガターは含みません.
+        uint32_t        Y;              //!< 左上のY座標(ピクセル)です. ガターは含みません.
+        uint32_t        Width;          //!< アトラス上の横幅です. 回転した場合は元画像の縦幅になります.
+        uint32_t        Height;         //!< アトラス上の縦幅です. 回転した場合は元画像の横幅になります.
+        bool            Rotated;        //!< 時計回りに90度回転して配置したかどうかです.
+        Vector2         UV0;            //!< アトラス上の左上のテクスチャ座標です.
+        Vector2         UV1;            //!< アトラス上の右下のテクスチャ座標です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Input structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Input
+    {
+        const char*         Name;       //!< 領域の名前です.
+        const ResTexture*   pTexture;   //!< 入力テクスチャです. 最初のサーフェイスの最上位ミップレベルのみを使用します.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Stats structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Stats
+    {
+        uint32_t        RegionCount;    //!< 配置した領域数です.
+        uint64_t        UsedPixels;     //!< 入力画像の総ピクセル数です(ガター, 余白を含みません).
+        uint64_t        SlotPixels;     //!< 配置に使ったピクセル数です(ガター, 余白, 境界揃えを含みます).
+        float           Occupancy;      //!< 充填率(UsedPixels / アトラスのピクセル数)です.
+    };
+
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    TextureAtlas();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~TextureAtlas();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      desc        構成設定です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(const Desc& desc);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      入力をまとめて配置し直してアトラスを構築します.
+    //!             配置済みの領域は破棄します. 入力は大きい順に並べ替えてから配置し，
+    //!             収まらない場合は最大サイズまで短い辺を2倍ずつ拡張します.
+    //!
+    //! @param[in]      pInputs     入力の配列です.
+    //! @param[in]      count       入力数です.
+    //! @retval true    構築に成功.
+    //! @retval false   最大サイズに収まらないか，変換できない入力があります. アトラスは空になります.
+    //---------------------------------------------------------------------------------------------
+    bool Build(const Input* pInputs, uint32_t count);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      配置済みの領域を動かさずに1つ追加します.
+    //!             空きがない場合はアトラスを拡張します. 拡張してもピクセル座標は変わりませんが，
+    //!             テクスチャ座標は変わるので Find() で取得し直してください.
+    //!
+    //! @param[in]      name        領域の名前です. 配置済みの名前と重複してはいけません.
+    //! @param[in]      texture     入力テクスチャです.
+    //! @retval true    追加に成功.
+    //! @retval false   追加に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Insert(const char* name, const ResTexture& texture);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      名前から領域を検索します.
+    //!
+    //! @param[in]      name        領域の名前です.
+    //! @param[out]     result      領域の格納先です.
+    //! @retval true    見つかりました.
+    //! @retval false   見つかりませんでした.
+    //---------------------------------------------------------------------------------------------
+    bool Find(const char* name, Region& result) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      名前から領域へのテーブルを取得します.
+    //!
+    //! @return     テーブルを返却します. 配置やアトラスの拡張で更新されます.
+    //---------------------------------------------------------------------------------------------
+    const std::unordered_map<std::string, Region>& GetRegions() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アトラスをリソーステクスチャとして取得します.
+    //!
+    //! @param[out]     result      格納先です. ミップレベル1つのテクスチャになります.
+    //!                             格納先が保持していたデータは解放しないので，事前に Release() を呼び出してください.
+    //! @retval true    取得に成功.
+    //! @retval false   取得に失敗.
+    //! @note       ミップマップが必要な場合は GenerateMipMaps() で生成してください.
+    //---------------------------------------------------------------------------------------------
+    bool GetTexture(ResTexture& result) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アトラスの横幅を取得します.
+    //!
+    //! @return     アトラスの横幅を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetWidth() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アトラスの縦幅を取得します.
+    //!
+    //! @return     アトラスの縦幅を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetHeight() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報を取得します.
+    //!
+    //! @return     統計情報を返却します.
+    //---------------------------------------------------------------------------------------------
+    Stats GetStats() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Slot structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Slot
+    {
+        uint32_t        Width;          //!< ガター, 余白, 境界揃えを含めた横幅です.
+        uint32_t        Height;         //!< ガター, 余白, 境界揃えを含めた縦幅です.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    Desc                                        m_Desc;         //!< 構成設定です.
+    AtlasPacker*                                m_pPacker;      //!< 配置アルゴリズムです.
+    uint32_t                                    m_Width;        //!< 横幅です.
+    uint32_t                                    m_Height;       //!< 縦幅です.
+    uint32_t                                    m_PixelSize;    //!< 1ピクセルあたりのバイト数です.
+    std::vector<uint8_t>                        m_Pixels;       //!< ピクセルデータです.
+    std::unordered_map<std::string, Region>     m_Regions;      //!< 名前から領域へのテーブルです.
+    uint64_t                                    m_UsedPixels;   //!< 入力画像の総ピクセル数です.
+    uint64_t                                    m_SlotPixels;   //!< 配置に使ったピクセル数です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    Slot CalcSlot(uint32_t width, uint32_t height) const;
+    bool Place(const Slot& slot, uint32_t& x, uint32_t& y, bool& rotated);
+    bool Grow();
+    void Resize(uint32_t width, uint32_t height);
+    bool Blit(const ResTexture& texture, const Region& region);
+    void UpdateUV();
+    void Clear();
+
+    TextureAtlas                (const TextureAtlas&) = delete;
+    TextureAtlas& operator =    (const TextureAtlas&) = delete;
+};
+
+} // namespace asdx
@@ -0,0 +1,295 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxTextureLoadQueue.h
+// Desc : Asynchronous Texture Load Queue Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxResTexture.h>
+#include <cstdint>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+// Type Definitions.
+//-------------------------------------------------------------------------------------------------
+using TextureLoadHandle = uint64_t;     //!< 読み込み要求のハンドルです(0は無効値).
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TEXTURE_LOAD_STATE enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum TEXTURE_LOAD_STATE
+{
+    TEXTURE_LOAD_STATE_INVALID = 0,     //!< 無効なハンドルか，結果を受け取り済みです.
+    TEXTURE_LOAD_STATE_PENDING,         //!< 待機中です.
+    TEXTURE_LOAD_STATE_RUNNING,         //!< 読み込み中です.
+    TEXTURE_LOAD_STATE_COMPLETED,       //!< 読み込みが完了し，Poll() での受け取り待ちです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureLoadResult structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TextureLoadResult
+{
+    TextureLoadHandle   Handle;         //!< 読み込み要求のハンドルです.
+    bool                Success;        //!< 読み込みに成功したかどうか.
+    ResTexture          Texture;        //!< 読み込んだテクスチャです. 受け取った側で Release() を呼び出してください.
+    void*               pUser;          //!< 要求時に指定したユーザーデータです.
+    double              WaitMsec;       //!< 要求してから読み込みを開始するまでの時間(ミリ秒)です.
+    double              DecodeMsec;     //!< 読み込みにかかった時間(ミリ秒)です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      読み込み完了時に呼び出されるコールバックです.
+//!
+//! @param[in]      result      読み込み結果です. テクスチャの所有権はコールバックに移ります.
+//! @note       ワーカースレッドから呼び出されます.
+//-------------------------------------------------------------------------------------------------
+typedef void (*TextureLoadCallback)(TextureLoadResult& result);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureLoadStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TextureLoadStats
+{
+    uint32_t    PendingCount;       //!< 待機中の要求数(キューの深さ)です.
+    uint32_t    RunningCount;       //!< 読み込み中の要求数です.
+    uint32_t    ReadyCount;         //!< Poll() での受け取り待ちの数です.
+    uint64_t    CompletedCount;     //!< 読み込みに成功した総数です.
+    uint64_t    FailedCount;        //!< 読み込みに失敗した総数です.
+    uint64_t    CanceledCount;      //!< キャンセルされた総数です.
+    double      AverageWaitMsec;    //!< 待機時間の平均(ミリ秒)です.
+    double      MaxWaitMsec;        //!< 待機時間の最大(ミリ秒)です.
+    double      AverageDecodeMsec;  //!< 読み込み時間の平均(ミリ秒)です.
+    double      MaxDecodeMsec;      //!< 読み込み時間の最大(ミリ秒)です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureLoadQueue class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class TextureLoadQueue
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Desc structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Desc
+    {
+        uint32_t    WorkerCount;    //!< ワーカースレッド数です. 0の場合はハードウェアスレッド数-1(最低1)になります.
+    };
+
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    TextureLoadQueue();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~TextureLoadQueue();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      desc        設定です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(const Desc& desc);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //!             待機中の要求はキャンセルし，読み込み中の要求の完了を待ちます. 受け取られていない結果は解放します.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルの読み込みを要求します.
+    //!
+    //! @param[in]      filename    ファイル名です.
+    //! @param[in]      priority    優先度です. 大きいほど先に読み込みます. 同じ優先度の場合は要求順です.
+    //! @param[in]      callback    完了時のコールバックです. nullptrの場合は Poll() で結果を受け取ります.
+    //! @param[in]      pUser       ユーザーデータです.
+    //! @param[in]      pOptions    読み込み設定です. 要求時にコピーします. nullptrの場合は既定値を使います.
+    //! @return     読み込み要求のハンドルを返却します. 失敗した場合は0を返却します.
+    //---------------------------------------------------------------------------------------------
+    TextureLoadHandle RequestA(
+        const char*                 filename,
+        int                         priority = 0,
+        TextureLoadCallback         callback = nullptr,
+        void*                       pUser    = nullptr,
+        const TextureLoadOptions*   pOptions = nullptr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルの読み込みを要求します.
+    //!
+    //! @param[in]      filename    ファイル名です.
+    //! @param[in]      priority    優先度です. 大きいほど先に読み込みます. 同じ優先度の場合は要求順です.
+    //! @param[in]      callback    完了時のコールバックです. nullptrの場合は Poll() で結果を受け取ります.
+    //! @param[in]      pUser       ユーザーデータです.
+    //! @param[in]      pOptions    読み込み設定です. 要求時にコピーします. nullptrの場合は既定値を使います.
+    //! @return     読み込み要求のハンドルを返却します. 失敗した場合は0を返却します.
+    //---------------------------------------------------------------------------------------------
+    TextureLoadHandle RequestW(
+        const wchar_t*              filename,
+        int                         priority = 0,
+        TextureLoadCallback         callback = nullptr,
+        void*                       pUser    = nullptr,
+        const TextureLoadOptions*   pOptions = nullptr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリストリームの読み込みを要求します.
+    //!
+    //! @param[in]      pBuffer     バッファです. 要求時にコピーするので，呼び出し後に解放できます.
+    //! @param[in]      bufferSize  バッファサイズです.
+    //! @param[in]      priority    優先度です. 大きいほど先に読み込みます. 同じ優先度の場合は要求順です.
+    //! @param[in]      callback    完了時のコールバックです. nullptrの場合は Poll() で結果を受け取ります.
+    //! @param[in]      pUser       ユーザーデータです.
+    //! @param[in]      pOptions    読み込み設定です. 要求時にコピーします. nullptrの場合は既定値を使います.
+    //! @return     読み込み要求のハンドルを返却します. 失敗した場合は0を返却します.
+    //---------------------------------------------------------------------------------------------
+    TextureLoadHandle RequestMemory(
+        const uint8_t*              pBuffer,
+        uint32_t                    bufferSize,
+        int                         priority = 0,
+        TextureLoadCallback         callback = nullptr,
+        void*                       pUser    = nullptr,
+        const TextureLoadOptions*   pOptions = nullptr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み込み要求をキャンセルします.
+    //!
+    //! @param[in]      handle      読み込み要求のハンドルです.
+    //! @retval true    キャンセルしました. コールバックは呼び出されず，Poll() でも返却されません.
+    //! @retval false   無効なハンドルか，既に完了しています.
+    //! @note       読み込み中の要求は中断できないため，完了後に結果を破棄します.
+    //---------------------------------------------------------------------------------------------
+    bool Cancel(TextureLoadHandle handle);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      待機中の要求の優先度を変更します.
+    //!
+    //! @param[in]      handle      読み込み要求のハンドルです.
+    //! @param[in]      priority    新しい優先度です.
+    //! @retval true    変更しました.
+    //! @retval false   無効なハンドルか，既に読み込みを開始しています.
+    //---------------------------------------------------------------------------------------------
+    bool SetPriority(TextureLoadHandle handle, int priority);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み込み要求の状態を取得します.
+    //!
+    //! @param[in]      handle      読み込み要求のハンドルです.
+    //! @return     読み込み要求の状態を返却します.
+    //---------------------------------------------------------------------------------------------
+    TEXTURE_LOAD_STATE GetState(TextureLoadHandle handle) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了した読み込み結果を受け取ります.
+    //!
+    //! @param[out]     pResults    結果の格納先です.
+    //! @param[in]      maxCount    格納先の要素数です.
+    //! @return     格納した結果の数を返却します.
+    //! @note       コールバックを指定しなかった要求の結果のみを完了順に返却します. メインスレッドから呼び出してください.
+    //---------------------------------------------------------------------------------------------
+    uint32_t Poll(TextureLoadResult* pResults, uint32_t maxCount);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      待機中と読み込み中の要求が全て完了するまで待ちます.
+    //---------------------------------------------------------------------------------------------
+    void WaitIdle();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      待機中の要求数(キューの深さ)を取得します.
+    //!
+    //! @return     待機中の要求数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetQueueDepth() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報を取得します.
+    //!
+    //! @return     統計情報を返却します.
+    //---------------------------------------------------------------------------------------------
+    TextureLoadStats GetStats() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Request structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Request;
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // OrderKey structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct OrderKey
+    {
+        int                 Priority;   //!< 優先度です.
+        TextureLoadHandle   Handle;     //!< ハンドルです(要求順に増加します).
+
+        bool operator < (const OrderKey& value) const
+        {
+            if (Priority != value.Priority)
+            { return Priority > value.Priority; }
+            return Handle < value.Handle;
+        }
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    mutable std::mutex                                  m_Mutex;            //!< ミューテックスです.
+    std::condition_variable                             m_WorkCond;         //!< ワーカーへの通知です.
+    std::condition_variable                             m_IdleCond;         //!< 完了待ちへの通知です.
+    std::vector<std::thread>                            m_Workers;          //!< ワーカースレッドです.
+    std::set<OrderKey>                                  m_Pending;          //!< 待機中の要求です(優先度順).
+    std::unordered_map<TextureLoadHandle, Request*>     m_Requests;         //!< 完了していない要求です.
+    std::vector<TextureLoadResult>                      m_Ready;            //!< Poll() での受け取り待ちの結果です.
+    TextureLoadHandle                                   m_NextHandle;       //!< 次に発行するハンドルです.
+    uint32_t                                            m_RunningCount;     //!< 読み込み中の要求数です.
+    bool                                                m_Finish;           //!< 終了フラグです.
+    uint64_t                                            m_CompletedCount;   //!< 読み込みに成功した総数です.
+    uint64_t                                            m_FailedCount;      //!< 読み込みに失敗した総数です.
+    uint64_t                                            m_CanceledCount;    //!< キャンセルされた総数です.
+    double                                              m_TotalWaitMsec;    //!< 待機時間の合計です.
+    double                                              m_MaxWaitMsec;      //!< 待機時間の最大です.
+    double                                              m_TotalDecodeMsec;  //!< 読み込み時間の合計です.
+    double                                              m_MaxDecodeMsec;    //!< 読み込み時間の最大です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    TextureLoadHandle Push(Request* pRequest, int priority);
+    void WorkerMain();
+    void ProcessRequests();
+
+    TextureLoadQueue(const TextureLoadQueue&) = delete;
+    void operator = (const TextureLoadQueue&) = delete;
+};
+
+} // namespace asdx
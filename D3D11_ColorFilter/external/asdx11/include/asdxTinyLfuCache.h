@@ -0,0 +1,313 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxTinyLfuCache.h
+// Desc : Window Tiny Least Frequency Used Cache Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cassert>
+#include <functional>
+#include <vector>
+#include <asdxCacheIndex.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CountMinSketch class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class CountMinSketch
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    CountMinSketch();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!             収容数以上の2のべき乗個の4bitカウンタを4行分確保します.
+    //!             記録回数が収容数の10倍に達するごとに全てのカウンタを半分にして，古い頻度を忘れます.
+    //!
+    //! @param[in]      capacity        キャッシュの最大収容可能数です.
+    //---------------------------------------------------------------------------------------------
+    void Init(size_t capacity);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全てのカウンタを0にします.
+    //---------------------------------------------------------------------------------------------
+    void Clear();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      使用を1回記録します.
+    //!
+    //! @param[in]      hash        キーのハッシュ値です.
+    //---------------------------------------------------------------------------------------------
+    void Increment(uint64_t hash);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      使用頻度を推定します.
+    //!
+    //! @param[in]      hash        キーのハッシュ値です.
+    //! @return     使用頻度の推定値(0～15)を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t Estimate(uint64_t hash) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      確保しているメモリサイズを取得します.
+    //!
+    //! @return     カウンタのバイト数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetMemorySize() const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::vector<uint64_t>   m_Table;        //!< 1要素に16個の4bitカウンタを詰めたテーブルです.
+    uint32_t                m_Mask;         //!< 1行のカウンタ数 - 1 です.
+    uint64_t                m_Additions;    //!< 前回半分にしてからの記録回数です.
+    uint64_t                m_SampleSize;   //!< カウンタを半分にする記録回数です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    uint32_t GetCounter(uint64_t hash, uint32_t row) const;
+    void     Halve();
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TinyLfuCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// W-TinyLFU です. 収容数の1%の窓(LRU)で新しい要素を受け，窓から溢れた要素は
+// 本体(試用20%, 保護80%のセグメント化LRU)の追い出し候補と使用頻度の推定値を比べて，
+// 高い方だけを残します. 一度しか使われない要素が大量に流れても本体の要素は追い出されません.
+template<typename K, typename V = CacheNoValue, typename H = std::hash<K>>
+class TinyLfuCache
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    using EvictFunc = std::function<void(const K& key, V& value)>;
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!             最大収容可能数分のノードとハッシュテーブル，頻度の推定に使うカウンタをここで確保し，
+    //!             以降の操作では確保を行いません.
+    //!
+    //! @param[in]      capacity        最大収容可能数です.
+    //---------------------------------------------------------------------------------------------
+    TinyLfuCache(size_t capacity);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~TinyLfuCache();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を追加します.
+    //!             使用を記録し，追加済みの場合はヒット，そうでなければミスとして数えます.
+    //!
+    //! @param[in]      item        追加する要素.
+    //! @retval true    追加に成功.
+    //! @retval false   最大収容可能数が0です.
+    //---------------------------------------------------------------------------------------------
+    bool Add(const K& item);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      値を追加します.
+    //!             追加済みの場合は値を更新して最も新しく使った要素にします.
+    //!             使用を記録するので，追加を繰り返す要素も本体に入れる判定で頻度が数えられます.
+    //!
+    //! @param[in]      key         キーです.
+    //! @param[in]      value       値です.
+    //! @retval true    追加に成功.
+    //! @retval false   最大収容可能数が0です.
+    //---------------------------------------------------------------------------------------------
+    bool Add(const K& key, const V& value);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      値を検索し，見つかった場合は使用を記録します.
+    //!             見つからなかった場合は続けて Add() で追加したときに記録するので，1回の使用は1回だけ数えられます.
+    //!
+    //! @param[in]      key         キーです.
+    //! @return     値へのポインタを返却します. 見つからない場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    V* Find(const K& key);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      使用を記録せずに値を検索します.
+    //!
+    //! @param[in]      key         キーです.
+    //! @return     値へのポインタを返却します. 見つからない場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    const V* Peek(const K& key) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を削除します. 追い出し時の関数は呼び出しません.
+    //!
+    //! @param[in]      item        削除する要素.
+    //! @retval true    削除しました.
+    //! @retval false   要素が含まれていません.
+    //---------------------------------------------------------------------------------------------
+    bool Remove(const K& item);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全要素を削除し，使用の記録を消去します. 追い出し時の関数は呼び出しません.
+    //---------------------------------------------------------------------------------------------
+    void Clear();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素が含まれているか判定します. 使用は記録しません.
+    //!
+    //! @return     指定要素が含まれている場合には true を返却します.
+    //---------------------------------------------------------------------------------------------
+    bool Contains(const K& item) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief     窓, 試用, 保護の順に，それぞれ古く使った順で配列にコピーします.
+    //---------------------------------------------------------------------------------------------
+    void Copy(K* pArray, size_t offset) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を追い出したときに呼び出す関数を設定します.
+    //!             本体に入れずに捨てた要素も含め，容量を超えて追い出す場合にのみ呼び出します.
+    //!
+    //! @param[in]      func        呼び出す関数です.
+    //---------------------------------------------------------------------------------------------
+    void SetEvictFunc(const EvictFunc& func);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヒット数, ミス数, 追い出し数を取得します.
+    //!
+    //! @return     統計情報を返却します.
+    //---------------------------------------------------------------------------------------------
+    CacheStats GetStats() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヒット数, ミス数, 追い出し数を0に戻します.
+    //---------------------------------------------------------------------------------------------
+    void ResetStats();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最大収容可能数を取得します.
+    //!
+    //! @return     最大収容可能数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetCapacity() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在の収容数を取得します.
+    //!
+    //! @return     現在の収容数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      確保しているメモリサイズを取得します.
+    //!
+    //! @return     オブジェクト, ノード, ハッシュテーブル, カウンタのバイト数を返却します.
+    //!             キーや値が内部で確保するメモリは含みません.
+    //---------------------------------------------------------------------------------------------
+    size_t GetMemorySize() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // SEGMENT enum
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    enum SEGMENT
+    {
+        SEGMENT_WINDOW = 0,     //!< 新しい要素を受ける窓です.
+        SEGMENT_PROBATION,      //!< 本体に入ったばかりの要素です.
+        SEGMENT_PROTECTED,      //!< 本体で再度使われた要素です.
+        SEGMENT_COUNT,
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Node structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Node
+    {
+        K           Key;        //!< キーです.
+        V           Value;      //!< 値です.
+        uint32_t    Segment;    //!< 所属するセグメントです.
+        uint32_t    Prev;       //!< セグメント内で1つ新しいノードです.
+        uint32_t    Next;       //!< セグメント内で1つ古いノードです. 空きノードでは次の空きノードです.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // List structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct List
+    {
+        uint32_t    Head;       //!< 最も新しく使ったノードです.
+        uint32_t    Tail;       //!< 最も古く使ったノードです.
+        size_t      Count;      //!< ノード数です.
+        size_t      Capacity;   //!< 最大ノード数です. 試用セグメントでは本体全体の最大ノード数です.
+    };
+
+    static const uint32_t kInvalid = CacheIndex<K, H>::kInvalid;
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    size_t              m_Capacity;                 //!< 最大収容可能数.
+    size_t              m_Count;                    //!< 現在の収容数.
+    std::vector<Node>   m_Nodes;                    //!< ノードプールです.
+    CacheIndex<K, H>    m_Index;                    //!< キーからノード番号へのハッシュテーブルです.
+    CountMinSketch      m_Sketch;                   //!< 使用頻度の推定に使うカウンタです.
+    List                m_Lists[SEGMENT_COUNT];     //!< セグメントごとのLRUリストです.
+    uint32_t            m_Free;                     //!< 空きノードリストの先頭です.
+    CacheStats          m_Stats;                    //!< 統計情報です.
+    EvictFunc           m_EvictFunc;                //!< 追い出し時に呼び出す関数です.
+    H                   m_Hasher;                   //!< 頻度の推定に使うハッシュ関数です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    void PushNode(uint32_t segment, uint32_t node);
+    void PopNode (uint32_t node);
+    void Touch   (uint32_t node);
+    void Admit   ();
+    void Evict   (uint32_t node);
+};
+
+} // namespace asdx
+
+
+//-------------------------------------------------------------------------------------------------
+// Inline Files.
+//-------------------------------------------------------------------------------------------------
+#include <asdxTinyLfuCache.inl>
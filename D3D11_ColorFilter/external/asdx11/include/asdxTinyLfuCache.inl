@@ -0,0 +1,561 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxTinyLfuCache.inl
+// Desc : Window Tiny Least Frequency Used Cache Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CountMinSketch class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+inline
+CountMinSketch::CountMinSketch()
+: m_Table     ()
+, m_Mask      (0)
+, m_Additions (0)
+, m_SampleSize(0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+inline
+void CountMinSketch::Init(size_t capacity)
+{
+    // 1行に16個以上，収容数以上の2のべき乗個のカウンタを持つ.
+    size_t width = 16;
+    while(width < capacity)
+    { width <<= 1; }
+
+    m_Table.assign(width / 16 * 4, 0);
+    m_Mask       = uint32_t(width - 1);
+    m_Additions  = 0;
+    m_SampleSize = uint64_t(capacity) * 10;
+    if (m_SampleSize < 16)
+    { m_SampleSize = 16; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+inline
+void CountMinSketch::Term()
+{
+    m_Table.clear();
+    m_Table.shrink_to_fit();
+    m_Mask       = 0;
+    m_Additions  = 0;
+    m_SampleSize = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全てのカウンタを0にします.
+//-------------------------------------------------------------------------------------------------
+inline
+void CountMinSketch::Clear()
+{
+    for(auto& word : m_Table)
+    { word = 0; }
+
+    m_Additions = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使用を1回記録します.
+//-------------------------------------------------------------------------------------------------
+inline
+void CountMinSketch::Increment(uint64_t hash)
+{
+    if (m_Table.empty())
+    { return; }
+
+    auto rowWords = (m_Mask + 1) / 16;
+    for(auto row=0u; row<4; ++row)
+    {
+        auto  counter = GetCounter(hash, row);
+        auto& word    = m_Table[row * rowWords + (counter >> 4)];
+        auto  shift   = (counter & 0xF) * 4;
+
+        // 4bitで飽和させる.
+        if (((word >> shift) & 0xF) < 0xF)
+        { word += uint64_t(1) << shift; }
+    }
+
+    m_Additions++;
+    if (m_Additions >= m_SampleSize)
+    { Halve(); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使用頻度を推定します.
+//-------------------------------------------------------------------------------------------------
+inline
+uint32_t CountMinSketch::Estimate(uint64_t hash) const
+{
+    if (m_Table.empty())
+    { return 0; }
+
+    auto rowWords = (m_Mask + 1) / 16;
+    auto result   = 0xFu;
+    for(auto row=0u; row<4; ++row)
+    {
+        auto counter = GetCounter(hash, row);
+        auto word    = m_Table[row * rowWords + (counter >> 4)];
+        auto value   = uint32_t(word >> ((counter & 0xF) * 4)) & 0xF;
+        if (value < result)
+        { result = value; }
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      確保しているメモリサイズを取得します.
+//-------------------------------------------------------------------------------------------------
+inline
+size_t CountMinSketch::GetMemorySize() const
+{ return m_Table.capacity() * sizeof(uint64_t); }
+
+//-------------------------------------------------------------------------------------------------
+//      行ごとのカウンタ番号を求めます.
+//-------------------------------------------------------------------------------------------------
+inline
+uint32_t CountMinSketch::GetCounter(uint64_t hash, uint32_t row) const
+{
+    static const uint64_t kSeeds[4] = {
+        0xC3A5C85C97CB3127ull,
+        0xB492B66FBE98F273ull,
+        0x9AE16A3B2F90404Full,
+        0xCBF29CE484222325ull,
+    };
+
+    // 整数をそのまま返すハッシュ関数でも行ごとに異なる位置になるように，攪拌してから乗算する.
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= kSeeds[row];
+    return uint32_t(hash >> 32) & m_Mask;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全てのカウンタを半分にします.
+//-------------------------------------------------------------------------------------------------
+inline
+void CountMinSketch::Halve()
+{
+    for(auto& word : m_Table)
+    { word = (word >> 1) & 0x7777777777777777ull; }
+
+    m_Additions /= 2;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TinyLfuCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+TinyLfuCache<K, V, H>::TinyLfuCache(size_t capacity)
+: m_Capacity (capacity)
+, m_Count    (0)
+, m_Nodes    ()
+, m_Index    ()
+, m_Sketch   ()
+, m_Free     (kInvalid)
+, m_Stats    ()
+, m_EvictFunc()
+, m_Hasher   ()
+{
+    // ノード番号は32bitで管理する.
+    assert(capacity < kInvalid);
+
+    // 窓を1%, 本体の80%を保護セグメントにする.
+    auto window = capacity / 100;
+    if (window == 0 && capacity > 0)
+    { window = 1; }
+
+    for(auto& list : m_Lists)
+    {
+        list.Head  = kInvalid;
+        list.Tail  = kInvalid;
+        list.Count = 0;
+    }
+
+    m_Lists[SEGMENT_WINDOW   ].Capacity = window;
+    m_Lists[SEGMENT_PROBATION].Capacity = capacity - window;
+    m_Lists[SEGMENT_PROTECTED].Capacity = (capacity - window) * 8 / 10;
+
+    m_Nodes.resize(capacity);
+    m_Index .Init(capacity);
+    m_Sketch.Init(capacity);
+    Clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+TinyLfuCache<K, V, H>::~TinyLfuCache()
+{ Clear(); }
+
+//-------------------------------------------------------------------------------------------------
+//      要素を追加します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool TinyLfuCache<K, V, H>::Add(const K& item)
+{
+    if (m_Capacity == 0)
+    { return false; }
+
+    if (Find(item) != nullptr)
+    { return true; }
+
+    return Add(item, V());
+}
+
+//-------------------------------------------------------------------------------------------------
+//      値を追加します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool TinyLfuCache<K, V, H>::Add(const K& key, const V& value)
+{
+    if (m_Capacity == 0)
+    { return false; }
+
+    // 窓から本体に入れる判定で追い出し候補と比べられるように，追加も使用として記録する.
+    m_Sketch.Increment(uint64_t(m_Hasher(key)));
+
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(key, keyOf);
+    if (node != kInvalid)
+    {
+        m_Nodes[node].Value = value;
+        Touch(node);
+        return true;
+    }
+
+    // 窓が一杯なら最も古い要素を本体に入れるか捨てる.
+    auto& window = m_Lists[SEGMENT_WINDOW];
+    if (window.Count >= window.Capacity)
+    { Admit(); }
+
+    node   = m_Free;
+    m_Free = m_Nodes[node].Next;
+    m_Nodes[node].Key   = key;
+    m_Nodes[node].Value = value;
+    m_Index.Insert(key, node);
+    m_Count++;
+
+    PushNode(SEGMENT_WINDOW, node);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      値を検索し，見つかった場合は使用を記録します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+V* TinyLfuCache<K, V, H>::Find(const K& key)
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(key, keyOf);
+    if (node == kInvalid)
+    {
+        m_Stats.Misses++;
+        return nullptr;
+    }
+
+    m_Sketch.Increment(uint64_t(m_Hasher(key)));
+    m_Stats.Hits++;
+    Touch(node);
+    return &m_Nodes[node].Value;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使用を記録せずに値を検索します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+const V* TinyLfuCache<K, V, H>::Peek(const K& key) const
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Find(key, keyOf);
+    if (node == kInvalid)
+    { return nullptr; }
+
+    return &m_Nodes[node].Value;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要素を削除します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool TinyLfuCache<K, V, H>::Remove(const K& item)
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    auto node = m_Index.Erase(item, keyOf);
+    if (node == kInvalid)
+    { return false; }
+
+    PopNode(node);
+
+    auto& entry = m_Nodes[node];
+    entry.Key   = K();
+    entry.Value = V();
+    entry.Next  = m_Free;
+    m_Free      = node;
+    m_Count--;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全要素を削除します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void TinyLfuCache<K, V, H>::Clear()
+{
+    // 値が保持しているリソースをここで解放する.
+    for(auto& list : m_Lists)
+    {
+        for(auto i = list.Head; i != kInvalid; i = m_Nodes[i].Next)
+        {
+            m_Nodes[i].Key   = K();
+            m_Nodes[i].Value = V();
+        }
+
+        list.Head  = kInvalid;
+        list.Tail  = kInvalid;
+        list.Count = 0;
+    }
+
+    auto count = uint32_t(m_Nodes.size());
+    for(auto i=0u; i<count; ++i)
+    { m_Nodes[i].Next = (i + 1 < count) ? i + 1 : kInvalid; }
+
+    m_Index .Clear();
+    m_Sketch.Clear();
+    m_Free  = (count > 0) ? 0 : kInvalid;
+    m_Count = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要素が含まれているか判定します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+bool TinyLfuCache<K, V, H>::Contains(const K& item) const
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+    return m_Index.Find(item, keyOf) != kInvalid;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      配列にコピーします.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void TinyLfuCache<K, V, H>::Copy(K* pArray, size_t offset) const
+{
+    for(auto& list : m_Lists)
+    {
+        for(auto i = list.Tail; i != kInvalid; i = m_Nodes[i].Prev)
+        {
+            pArray[offset] = m_Nodes[i].Key;
+            offset++;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要素を追い出したときに呼び出す関数を設定します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void TinyLfuCache<K, V, H>::SetEvictFunc(const EvictFunc& func)
+{ m_EvictFunc = func; }
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+CacheStats TinyLfuCache<K, V, H>::GetStats() const
+{ return m_Stats; }
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を0に戻します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void TinyLfuCache<K, V, H>::ResetStats()
+{ m_Stats = CacheStats(); }
+
+//-------------------------------------------------------------------------------------------------
+//      最大収容可能数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t TinyLfuCache<K, V, H>::GetCapacity() const
+{ return m_Capacity; }
+
+//-------------------------------------------------------------------------------------------------
+//      現在の収容数を取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t TinyLfuCache<K, V, H>::GetCount() const
+{ return m_Count; }
+
+//-------------------------------------------------------------------------------------------------
+//      確保しているメモリサイズを取得します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+size_t TinyLfuCache<K, V, H>::GetMemorySize() const
+{
+    return sizeof(*this)
+         + m_Nodes.capacity() * sizeof(Node)
+         + m_Index .GetMemorySize()
+         + m_Sketch.GetMemorySize();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードをセグメントの先頭につなげます.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void TinyLfuCache<K, V, H>::PushNode(uint32_t segment, uint32_t node)
+{
+    auto& list = m_Lists[segment];
+    auto& item = m_Nodes[node];
+
+    item.Segment = segment;
+    item.Prev    = kInvalid;
+    item.Next    = list.Head;
+
+    if (list.Head != kInvalid)
+    { m_Nodes[list.Head].Prev = node; }
+    else
+    { list.Tail = node; }
+
+    list.Head = node;
+    list.Count++;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードをセグメントから外します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void TinyLfuCache<K, V, H>::PopNode(uint32_t node)
+{
+    auto& item = m_Nodes[node];
+    auto& list = m_Lists[item.Segment];
+
+    if (item.Prev != kInvalid)
+    { m_Nodes[item.Prev].Next = item.Next; }
+    else
+    { list.Head = item.Next; }
+
+    if (item.Next != kInvalid)
+    { m_Nodes[item.Next].Prev = item.Prev; }
+    else
+    { list.Tail = item.Prev; }
+
+    list.Count--;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使われたノードを移動します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void TinyLfuCache<K, V, H>::Touch(uint32_t node)
+{
+    auto segment = m_Nodes[node].Segment;
+    PopNode(node);
+
+    if (segment != SEGMENT_PROBATION)
+    {
+        PushNode(segment, node);
+        return;
+    }
+
+    // 試用中に再度使われたら保護し，溢れた保護要素を試用に戻す.
+    PushNode(SEGMENT_PROTECTED, node);
+
+    auto& protect = m_Lists[SEGMENT_PROTECTED];
+    if (protect.Count > protect.Capacity)
+    {
+        auto demote = protect.Tail;
+        PopNode(demote);
+        PushNode(SEGMENT_PROBATION, demote);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      窓の最も古い要素を本体に入れるか捨てます.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void TinyLfuCache<K, V, H>::Admit()
+{
+    auto& probation = m_Lists[SEGMENT_PROBATION];
+    auto& protect   = m_Lists[SEGMENT_PROTECTED];
+    auto  candidate = m_Lists[SEGMENT_WINDOW].Tail;
+
+    // 本体に空きがあればそのまま入れる.
+    if (probation.Count + protect.Count < probation.Capacity)
+    {
+        PopNode(candidate);
+        PushNode(SEGMENT_PROBATION, candidate);
+        return;
+    }
+
+    if (probation.Capacity == 0)
+    {
+        Evict(candidate);
+        return;
+    }
+
+    // 本体の追い出し候補より使用頻度が高いときだけ入れ替える.
+    auto victim = (probation.Tail != kInvalid) ? probation.Tail : protect.Tail;
+    auto candidateFreq = m_Sketch.Estimate(uint64_t(m_Hasher(m_Nodes[candidate].Key)));
+    auto victimFreq    = m_Sketch.Estimate(uint64_t(m_Hasher(m_Nodes[victim   ].Key)));
+
+    if (candidateFreq > victimFreq)
+    {
+        Evict(victim);
+        PopNode(candidate);
+        PushNode(SEGMENT_PROBATION, candidate);
+    }
+    else
+    {
+        Evict(candidate);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要素を追い出します.
+//-------------------------------------------------------------------------------------------------
+template<typename K, typename V, typename H> inline
+void TinyLfuCache<K, V, H>::Evict(uint32_t node)
+{
+    auto keyOf = [this](uint32_t i) -> const K& { return m_Nodes[i].Key; };
+
+    PopNode(node);
+    m_Index.Erase(m_Nodes[node].Key, keyOf);
+    m_Stats.Evictions++;
+
+    auto& item = m_Nodes[node];
+    if (m_EvictFunc)
+    { m_EvictFunc(item.Key, item.Value); }
+
+    item.Key   = K();
+    item.Value = V();
+    item.Next  = m_Free;
+    m_Free     = node;
+    m_Count--;
+}
+
+} // namespace asdx
@@ -0,0 +1,1317 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxBCDecoder.cpp
+// Desc : Block Compression Decoder Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxBCDecoder.h>
+#include <asdxResTexture.h>
+#include <asdxPixelKernel.h>
+#include <asdxMath.h>
+#include <asdxLogger.h>
+#include <asdxParallelFor.h>
+#include <dxgiformat.h>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define ASDX_KERNEL_X86     (1)
+    #include <emmintrin.h>
+#else
+    #define ASDX_KERNEL_X86     (0)
+#endif
+
+// MSVCは命令セットの指定なしでイントリンジックを使用できるが，GCC/Clangは関数単位で指定が必要.
+#if defined(__GNUC__) || defined(__clang__)
+    #define ASDX_TARGET_SSE2    __attribute__((target("sse2")))
+#else
+    #define ASDX_TARGET_SSE2
+#endif
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+
+// 2分割パーティションです(ビットiがピクセルiのサブセット番号).
+static const uint16_t g_Partition2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+// 3分割パーティションです.
+static const uint8_t g_Partition3[64][16] = {
+    { 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+    { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 },
+    { 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+    { 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 },
+    { 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+    { 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+    { 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+    { 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 },
+    { 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+    { 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+    { 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 },
+    { 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+    { 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 },
+    { 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+    { 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 },
+    { 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+    { 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+    { 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 },
+    { 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+    { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+    { 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 },
+    { 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 },
+    { 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+    { 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 },
+    { 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+    { 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 },
+    { 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 },
+    { 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 },
+    { 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+    { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 },
+    { 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+    { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 },
+    { 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+    { 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 },
+    { 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+    { 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 },
+    { 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+    { 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+    { 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 },
+    { 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+    { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 },
+};
+
+// 2分割パーティションのサブセット1のアンカーピクセルです.
+static const uint8_t g_Anchor2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,
+     2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,
+     2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2,
+    15, 15, 15, 15, 15,  2,  2, 15,
+};
+
+// 3分割パーティションのサブセット1のアンカーピクセルです.
+static const uint8_t g_Anchor3a[64] = {
+     3,  3, 15, 15,  8,  3, 15, 15,
+     8,  8,  6,  6,  6,  5,  3,  3,
+     3,  3,  8, 15,  3,  3,  6, 10,
+     5,  8,  8,  6,  8,  5, 15, 15,
+     8, 15,  3,  5,  6, 10,  8, 15,
+    15,  3, 15,  5, 15, 15, 15, 15,
+     3, 15,  5,  5,  5,  8,  5, 10,
+     5, 10,  8, 13, 15, 12,  3,  3,
+};
+
+// 3分割パーティションのサブセット2のアンカーピクセルです.
+static const uint8_t g_Anchor3b[64] = {
+    15,  8,  8,  3, 15, 15,  3,  8,
+    15, 15, 15, 15, 15, 15, 15,  8,
+    15,  8, 15,  3, 15,  8, 15,  8,
+     3, 15,  6, 10, 15, 15, 10,  8,
+    15,  3, 15, 10, 10,  8,  9, 10,
+     6, 15,  8, 15,  3,  6,  6,  8,
+    15,  3, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15,  3, 15, 15,  8,
+};
+
+// 補間の重みです(64で正規化).
+static const uint8_t g_Weight2[4]  = { 0, 21, 43, 64 };
+static const uint8_t g_Weight3[8]  = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const uint8_t g_Weight4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BC7_MODE_INFO structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BC7_MODE_INFO
+{
+    uint8_t     SubsetCount;        //!< サブセット数です.
+    uint8_t     PartitionBits;      //!< パーティション番号のビット数です.
+    uint8_t     RotationBits;       //!< 回転指定のビット数です.
+    uint8_t     SelectorBits;       //!< インデックス選択のビット数です.
+    uint8_t     ColorBits;          //!< カラー端点のビット数です.
+    uint8_t     AlphaBits;          //!< アルファ端点のビット数です.
+    uint8_t     EndpointPBits;      //!< 端点ごとのPビットの有無です.
+    uint8_t     SharedPBits;        //!< サブセットごとのPビットの有無です.
+    uint8_t     IndexBits;          //!< 1次インデックスのビット数です.
+    uint8_t     IndexBits2;         //!< 2次インデックスのビット数です.
+};
+
+static const BC7_MODE_INFO g_BC7Modes[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BC6H_FIELD enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum BC6H_FIELD
+{
+    RW = 0, GW, BW,     // サブセット0の端点0.
+    RX, GX, BX,         // サブセット0の端点1.
+    RY, GY, BY,         // サブセット1の端点0.
+    RZ, GZ, BZ,         // サブセット1の端点1.
+    D,                  // パーティション番号.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BC6H_SEGMENT structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BC6H_SEGMENT
+{
+    uint8_t     Field;      //!< 格納先のフィールドです.
+    uint8_t     First;      //!< 最初に格納されているビット位置です.
+    uint8_t     Last;       //!< 最後に格納されているビット位置です(First より小さい場合は逆順に格納されています).
+};
+
+// モードごとのヘッダのビット配置です(モードビットを除く).
+static const BC6H_SEGMENT g_BC6HMode1[] = {
+    { GY, 4, 4 }, { BY, 4, 4 }, { BZ, 4, 4 }, { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 },
+    { RX, 0, 4 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 }, { BZ, 0, 0 }, { GZ, 0, 3 },
+    { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 },
+    { BZ, 3, 3 }, { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode2[] = {
+    { GY, 5, 5 }, { GZ, 4, 5 }, { RW, 0, 6 }, { BZ, 0, 1 }, { BY, 4, 4 }, { GW, 0, 6 },
+    { BY, 5, 5 }, { BZ, 2, 2 }, { GY, 4, 4 }, { BW, 0, 6 }, { BZ, 3, 3 }, { BZ, 5, 5 },
+    { BZ, 4, 4 }, { RX, 0, 5 }, { GY, 0, 3 }, { GX, 0, 5 }, { GZ, 0, 3 }, { BX, 0, 5 },
+    { BY, 0, 3 }, { RY, 0, 5 }, { RZ, 0, 5 }, { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode3[] = {
+    { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 4 }, { RW, 10, 10 }, { GY, 0, 3 },
+    { GX, 0, 3 }, { GW, 10, 10 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 3 }, { BW, 10, 10 },
+    { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 },
+    { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode4[] = {
+    { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 3 }, { RW, 10, 10 }, { GZ, 4, 4 },
+    { GY, 0, 3 }, { GX, 0, 4 }, { GW, 10, 10 }, { GZ, 0, 3 }, { BX, 0, 3 }, { BW, 10, 10 },
+    { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 3 }, { BZ, 0, 0 }, { BZ, 2, 2 }, { RZ, 0, 3 },
+    { GY, 4, 4 }, { BZ, 3, 3 }, { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode5[] = {
+    { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 3 }, { RW, 10, 10 }, { BY, 4, 4 },
+    { GY, 0, 3 }, { GX, 0, 3 }, { GW, 10, 10 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 4 },
+    { BW, 10, 10 }, { BY, 0, 3 }, { RY, 0, 3 }, { BZ, 1, 2 }, { RZ, 0, 3 }, { BZ, 4, 4 },
+    { BZ, 3, 3 }, { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode6[] = {
+    { RW, 0, 8 }, { BY, 4, 4 }, { GW, 0, 8 }, { GY, 4, 4 }, { BW, 0, 8 }, { BZ, 4, 4 },
+    { RX, 0, 4 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 }, { BZ, 0, 0 }, { GZ, 0, 3 },
+    { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 },
+    { BZ, 3, 3 }, { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode7[] = {
+    { RW, 0, 7 }, { GZ, 4, 4 }, { BY, 4, 4 }, { GW, 0, 7 }, { BZ, 2, 2 }, { GY, 4, 4 },
+    { BW, 0, 7 }, { BZ, 3, 4 }, { RX, 0, 5 }, { GY, 0, 3 }, { GX, 0, 4 }, { BZ, 0, 0 },
+    { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 5 }, { RZ, 0, 5 },
+    { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode8[] = {
+    { RW, 0, 7 }, { BZ, 0, 0 }, { BY, 4, 4 }, { GW, 0, 7 }, { GY, 5, 5 }, { GY, 4, 4 },
+    { BW, 0, 7 }, { GZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 4 }, { GZ, 4, 4 }, { GY, 0, 3 },
+    { GX, 0, 5 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 },
+    { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode9[] = {
+    { RW, 0, 7 }, { BZ, 1, 1 }, { BY, 4, 4 }, { GW, 0, 7 }, { BY, 5, 5 }, { GY, 4, 4 },
+    { BW, 0, 7 }, { BZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 4 }, { GY, 0, 3 }, { GX, 0, 4 },
+    { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 5 }, { GZ, 4, 4 }, { BY, 0, 3 }, { RY, 0, 4 },
+    { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode10[] = {
+    { RW, 0, 5 }, { GZ, 4, 4 }, { BZ, 0, 1 }, { BY, 4, 4 }, { GW, 0, 5 }, { GY, 5, 5 },
+    { BY, 5, 5 }, { BZ, 2, 2 }, { GY, 4, 4 }, { BW, 0, 5 }, { GZ, 5, 5 }, { BZ, 3, 3 },
+    { BZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 5 }, { GY, 0, 3 }, { GX, 0, 5 }, { GZ, 0, 3 },
+    { BX, 0, 5 }, { BY, 0, 3 }, { RY, 0, 5 }, { RZ, 0, 5 }, { D,  0, 4 },
+};
+static const BC6H_SEGMENT g_BC6HMode11[] = {
+    { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 9 }, { GX, 0, 9 }, { BX, 0, 9 },
+};
+static const BC6H_SEGMENT g_BC6HMode12[] = {
+    { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 8 }, { RW, 10, 10 }, { GX, 0, 8 },
+    { GW, 10, 10 }, { BX, 0, 8 }, { BW, 10, 10 },
+};
+static const BC6H_SEGMENT g_BC6HMode13[] = {
+    { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 7 }, { RW, 11, 10 }, { GX, 0, 7 },
+    { GW, 11, 10 }, { BX, 0, 7 }, { BW, 11, 10 },
+};
+static const BC6H_SEGMENT g_BC6HMode14[] = {
+    { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 3 }, { RW, 15, 10 }, { GX, 0, 3 },
+    { GW, 15, 10 }, { BX, 0, 3 }, { BW, 15, 10 },
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BC6H_MODE_INFO structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BC6H_MODE_INFO
+{
+    uint8_t                 Code;           //!< モード番号です.
+    uint8_t                 ModeBits;       //!< モード番号のビット数です.
+    uint8_t                 SubsetCount;    //!< サブセット数です.
+    uint8_t                 Transformed;    //!< 端点を差分で格納しているかどうか.
+    uint8_t                 BaseBits;       //!< サブセット0の端点0のビット数です.
+    uint8_t                 DeltaBits[3];   //!< それ以外の端点のRGBごとのビット数です.
+    const BC6H_SEGMENT*     pSegments;      //!< ヘッダのビット配置です.
+    uint32_t                SegmentCount;   //!< ヘッダのビット配置の数です.
+};
+
+#define BC6H_MODE(code, bits, subset, transformed, base, dr, dg, db, segments) \
+    { code, bits, subset, transformed, base, { dr, dg, db }, segments, sizeof(segments) / sizeof(segments[0]) }
+
+static const BC6H_MODE_INFO g_BC6HModes[14] = {
+    BC6H_MODE( 0x00, 2, 2, 1, 10,  5,  5,  5, g_BC6HMode1  ),
+    BC6H_MODE( 0x01, 2, 2, 1,  7,  6,  6,  6, g_BC6HMode2  ),
+    BC6H_MODE( 0x02, 5, 2, 1, 11,  5,  4,  4, g_BC6HMode3  ),
+    BC6H_MODE( 0x06, 5, 2, 1, 11,  4,  5,  4, g_BC6HMode4  ),
+    BC6H_MODE( 0x0A, 5, 2, 1, 11,  4,  4,  5, g_BC6HMode5  ),
+    BC6H_MODE( 0x0E, 5, 2, 1,  9,  5,  5,  5, g_BC6HMode6  ),
+    BC6H_MODE( 0x12, 5, 2, 1,  8,  6,  5,  5, g_BC6HMode7  ),
+    BC6H_MODE( 0x16, 5, 2, 1,  8,  5,  6,  5, g_BC6HMode8  ),
+    BC6H_MODE( 0x1A, 5, 2, 1,  8,  5,  5,  6, g_BC6HMode9  ),
+    BC6H_MODE( 0x1E, 5, 2, 0,  6,  6,  6,  6, g_BC6HMode10 ),
+    BC6H_MODE( 0x03, 5, 1, 0, 10, 10, 10, 10, g_BC6HMode11 ),
+    BC6H_MODE( 0x07, 5, 1, 1, 11,  9,  9,  9, g_BC6HMode12 ),
+    BC6H_MODE( 0x0B, 5, 1, 1, 12,  8,  8,  8, g_BC6HMode13 ),
+    BC6H_MODE( 0x0F, 5, 1, 1, 16,  4,  4,  4, g_BC6HMode14 ),
+};
+
+#undef BC6H_MODE
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BitReader class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class BitReader
+{
+public:
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!
+    //! @param[in]      pBlock      16byteのブロックです.
+    //---------------------------------------------------------------------------------------------
+    explicit BitReader(const uint8_t* pBlock)
+    : m_Pos(0)
+    {
+        memcpy(&m_Lo, pBlock + 0, sizeof(m_Lo));
+        memcpy(&m_Hi, pBlock + 8, sizeof(m_Hi));
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      下位ビットから順に指定ビット数を読み取ります.
+    //!
+    //! @param[in]      count       ビット数です(0～32).
+    //! @return     読み取った値を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetBits(uint32_t count)
+    {
+        if (count == 0)
+        { return 0; }
+
+        uint64_t value;
+        if (m_Pos >= 128)
+        { value = 0; }
+        else if (m_Pos >= 64)
+        { value = m_Hi >> (m_Pos - 64); }
+        else if (m_Pos == 0)
+        { value = m_Lo; }
+        else
+        { value = (m_Lo >> m_Pos) | (m_Hi << (64 - m_Pos)); }
+
+        m_Pos += count;
+        return uint32_t(value & ((uint64_t(1) << count) - 1));
+    }
+
+private:
+    uint64_t    m_Lo;       //!< 下位64bitです.
+    uint64_t    m_Hi;       //!< 上位64bitです.
+    uint32_t    m_Pos;      //!< 読み取り位置です.
+};
+
+
+//-------------------------------------------------------------------------------------------------
+//      R5G6B5形式をRGBA8形式に展開します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t Expand565(uint32_t color)
+{
+    auto r = (color >> 11) & 0x1F;
+    auto g = (color >>  5) & 0x3F;
+    auto b = (color >>  0) & 0x1F;
+
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+
+    return r | (g << 8) | (b << 16) | 0xFF000000;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2色を補間します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t LerpColor(uint32_t c0, uint32_t c1, uint32_t w0, uint32_t w1, uint32_t div)
+{
+    uint32_t result = 0;
+    for(auto shift=0u; shift<24; shift+=8)
+    {
+        auto a = (c0 >> shift) & 0xFF;
+        auto b = (c1 >> shift) & 0xFF;
+        result |= ((a * w0 + b * w1 + div / 2) / div) << shift;
+    }
+    return result | 0xFF000000;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2bitインデックスで4色パレットを展開します(スカラー版).
+//-------------------------------------------------------------------------------------------------
+void ExpandIndices2Scalar(const uint32_t* pPalette, uint32_t indices, uint32_t* pOut)
+{
+    for(auto i=0; i<16; ++i, indices >>= 2)
+    { pOut[i] = pPalette[indices & 0x3]; }
+}
+
+#if ASDX_KERNEL_X86
+//-------------------------------------------------------------------------------------------------
+//      2bitインデックスで4色パレットを展開します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+void ExpandIndices2SSE2(const uint32_t* pPalette, uint32_t indices, uint32_t* pOut)
+{
+    // 各レーンに1行分のインデックスを複製し，レーンごとのマスクで自分の2bitだけ取り出して比較する.
+    const auto mask  = _mm_setr_epi32(0x03, 0x0C, 0x30, 0xC0);
+    const auto key1  = _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+    const auto key2  = _mm_add_epi32(key1, key1);
+    const auto key3  = _mm_add_epi32(key2, key1);
+    const auto zero  = _mm_setzero_si128();
+
+    const auto p0 = _mm_set1_epi32(int(pPalette[0]));
+    const auto p1 = _mm_set1_epi32(int(pPalette[1]));
+    const auto p2 = _mm_set1_epi32(int(pPalette[2]));
+    const auto p3 = _mm_set1_epi32(int(pPalette[3]));
+
+    for(auto row=0; row<4; ++row, indices >>= 8)
+    {
+        auto v = _mm_and_si128(_mm_set1_epi32(int(indices & 0xFF)), mask);
+        auto r = _mm_and_si128(_mm_cmpeq_epi32(v, zero), p0);
+        r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi32(v, key1), p1));
+        r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi32(v, key2), p2));
+        r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi32(v, key3), p3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + row * 4), r);
+    }
+}
+#endif
+
+//-------------------------------------------------------------------------------------------------
+//      2bitインデックスで4色パレットを展開します.
+//-------------------------------------------------------------------------------------------------
+inline void ExpandIndices2(const uint32_t* pPalette, uint32_t indices, uint32_t* pOut)
+{
+#if ASDX_KERNEL_X86
+    if (asdx::GetSimdLevel() != asdx::SIMD_LEVEL_SCALAR)
+    {
+        ExpandIndices2SSE2(pPalette, indices, pOut);
+        return;
+    }
+#endif
+    ExpandIndices2Scalar(pPalette, indices, pOut);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      カラーブロック(BC1形式)を展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeColorBlock(const uint8_t* pBlock, uint32_t* pOut, bool allowTransparent)
+{
+    auto c0 = uint32_t(pBlock[0] | (pBlock[1] << 8));
+    auto c1 = uint32_t(pBlock[2] | (pBlock[3] << 8));
+
+    uint32_t indices;
+    memcpy(&indices, pBlock + 4, sizeof(indices));
+
+    uint32_t palette[4];
+    palette[0] = Expand565(c0);
+    palette[1] = Expand565(c1);
+
+    if (c0 > c1 || !allowTransparent)
+    {
+        palette[2] = LerpColor(palette[0], palette[1], 2, 1, 3);
+        palette[3] = LerpColor(palette[0], palette[1], 1, 2, 3);
+    }
+    else
+    {
+        palette[2] = LerpColor(palette[0], palette[1], 1, 1, 2);
+        palette[3] = 0;
+    }
+
+    ExpandIndices2(palette, indices, pOut);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8bitの補間テーブルを生成します(BC3, BC4, BC5形式).
+//-------------------------------------------------------------------------------------------------
+void MakeAlphaPaletteUNorm(const uint8_t* pBlock, uint8_t* pPalette)
+{
+    uint32_t a0 = pBlock[0];
+    uint32_t a1 = pBlock[1];
+
+    pPalette[0] = uint8_t(a0);
+    pPalette[1] = uint8_t(a1);
+
+    if (a0 > a1)
+    {
+        for(auto i=1u; i<7; ++i)
+        { pPalette[i + 1] = uint8_t(((7 - i) * a0 + i * a1 + 3) / 7); }
+    }
+    else
+    {
+        for(auto i=1u; i<5; ++i)
+        { pPalette[i + 1] = uint8_t(((5 - i) * a0 + i * a1 + 2) / 5); }
+        pPalette[6] = 0;
+        pPalette[7] = 255;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      符号付きの補間テーブルを生成します(BC4, BC5形式).
+//-------------------------------------------------------------------------------------------------
+void MakeAlphaPaletteSNorm(const uint8_t* pBlock, float* pPalette)
+{
+    auto a0 = int8_t(pBlock[0]);
+    auto a1 = int8_t(pBlock[1]);
+
+    // -128 と -127 はどちらも -1.0 として扱う.
+    auto f0 = (a0 == -128) ? -1.0f : float(a0) / 127.0f;
+    auto f1 = (a1 == -128) ? -1.0f : float(a1) / 127.0f;
+
+    pPalette[0] = f0;
+    pPalette[1] = f1;
+
+    if (a0 > a1)
+    {
+        for(auto i=1; i<7; ++i)
+        { pPalette[i + 1] = (float(7 - i) * f0 + float(i) * f1) / 7.0f; }
+    }
+    else
+    {
+        for(auto i=1; i<5; ++i)
+        { pPalette[i + 1] = (float(5 - i) * f0 + float(i) * f1) / 5.0f; }
+        pPalette[6] = -1.0f;
+        pPalette[7] =  1.0f;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      3bitインデックス(48bit)を取得します.
+//-------------------------------------------------------------------------------------------------
+inline uint64_t GetAlphaIndices(const uint8_t* pBlock)
+{
+    uint64_t result = 0;
+    for(auto i=0; i<6; ++i)
+    { result |= uint64_t(pBlock[2 + i]) << (8 * i); }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC1形式のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC1(const uint8_t* pBlock, uint8_t* pOut)
+{ DecodeColorBlock(pBlock, reinterpret_cast<uint32_t*>(pOut), true); }
+
+//-------------------------------------------------------------------------------------------------
+//      BC2形式のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC2(const uint8_t* pBlock, uint8_t* pOut)
+{
+    DecodeColorBlock(pBlock + 8, reinterpret_cast<uint32_t*>(pOut), false);
+
+    for(auto i=0; i<16; ++i)
+    {
+        auto alpha = (pBlock[i / 2] >> ((i & 1) * 4)) & 0xF;
+        pOut[i * 4 + 3] = uint8_t(alpha * 17);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC3形式のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC3(const uint8_t* pBlock, uint8_t* pOut)
+{
+    DecodeColorBlock(pBlock + 8, reinterpret_cast<uint32_t*>(pOut), false);
+
+    uint8_t palette[8];
+    MakeAlphaPaletteUNorm(pBlock, palette);
+
+    auto indices = GetAlphaIndices(pBlock);
+    for(auto i=0; i<16; ++i, indices >>= 3)
+    { pOut[i * 4 + 3] = palette[indices & 0x7]; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC4形式(UNORM)のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC4U(const uint8_t* pBlock, uint8_t* pOut)
+{
+    uint8_t palette[8];
+    MakeAlphaPaletteUNorm(pBlock, palette);
+
+    auto indices = GetAlphaIndices(pBlock);
+    auto pColors = reinterpret_cast<uint32_t*>(pOut);
+    for(auto i=0; i<16; ++i, indices >>= 3)
+    { pColors[i] = palette[indices & 0x7] | 0xFF000000; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC5形式(UNORM)のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC5U(const uint8_t* pBlock, uint8_t* pOut)
+{
+    uint8_t paletteR[8];
+    uint8_t paletteG[8];
+    MakeAlphaPaletteUNorm(pBlock + 0, paletteR);
+    MakeAlphaPaletteUNorm(pBlock + 8, paletteG);
+
+    auto indicesR = GetAlphaIndices(pBlock + 0);
+    auto indicesG = GetAlphaIndices(pBlock + 8);
+    auto pColors  = reinterpret_cast<uint32_t*>(pOut);
+    for(auto i=0; i<16; ++i, indicesR >>= 3, indicesG >>= 3)
+    { pColors[i] = paletteR[indicesR & 0x7] | (paletteG[indicesG & 0x7] << 8) | 0xFF000000; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC4形式(SNORM)のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC4S(const uint8_t* pBlock, uint8_t* pOut)
+{
+    float palette[8];
+    MakeAlphaPaletteSNorm(pBlock, palette);
+
+    uint16_t halfs[8];
+    asdx::floatTohalf(palette, halfs, 8);
+
+    auto indices = GetAlphaIndices(pBlock);
+    auto pColors = reinterpret_cast<uint16_t*>(pOut);
+    for(auto i=0; i<16; ++i, indices >>= 3, pColors += 4)
+    {
+        pColors[0] = halfs[indices & 0x7];
+        pColors[1] = 0;
+        pColors[2] = 0;
+        pColors[3] = 0x3C00;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC5形式(SNORM)のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC5S(const uint8_t* pBlock, uint8_t* pOut)
+{
+    float paletteR[8];
+    float paletteG[8];
+    MakeAlphaPaletteSNorm(pBlock + 0, paletteR);
+    MakeAlphaPaletteSNorm(pBlock + 8, paletteG);
+
+    uint16_t halfsR[8];
+    uint16_t halfsG[8];
+    asdx::floatTohalf(paletteR, halfsR, 8);
+    asdx::floatTohalf(paletteG, halfsG, 8);
+
+    auto indicesR = GetAlphaIndices(pBlock + 0);
+    auto indicesG = GetAlphaIndices(pBlock + 8);
+    auto pColors  = reinterpret_cast<uint16_t*>(pOut);
+    for(auto i=0; i<16; ++i, indicesR >>= 3, indicesG >>= 3, pColors += 4)
+    {
+        pColors[0] = halfsR[indicesR & 0x7];
+        pColors[1] = halfsG[indicesG & 0x7];
+        pColors[2] = 0;
+        pColors[3] = 0x3C00;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      インデックスのビット数に対応する重みテーブルを取得します.
+//-------------------------------------------------------------------------------------------------
+inline const uint8_t* GetWeights(uint32_t indexBits)
+{
+    switch(indexBits)
+    {
+    case 2: return g_Weight2;
+    case 3: return g_Weight3;
+    default: return g_Weight4;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC7形式のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC7(const uint8_t* pBlock, uint8_t* pOut)
+{
+    // モード番号は先頭から最初に1が立っているビット位置.
+    uint32_t mode = 0;
+    while(mode < 8 && (pBlock[0] & (1 << mode)) == 0)
+    { mode++; }
+
+    // 予約済みのモードは透明な黒にする.
+    if (mode >= 8)
+    {
+        memset(pOut, 0, 64);
+        return;
+    }
+
+    const auto& info = g_BC7Modes[mode];
+
+    BitReader reader(pBlock);
+    reader.GetBits(mode + 1);
+
+    auto partition = reader.GetBits(info.PartitionBits);
+    auto rotation  = reader.GetBits(info.RotationBits);
+    auto selector  = reader.GetBits(info.SelectorBits);
+
+    // 端点はチャンネルごとにサブセット・端点の順で並んでいる.
+    uint32_t endpoints[3][2][4] = {};
+    for(auto ch=0; ch<3; ++ch)
+    {
+        for(auto s=0u; s<info.SubsetCount; ++s)
+        {
+            endpoints[s][0][ch] = reader.GetBits(info.ColorBits);
+            endpoints[s][1][ch] = reader.GetBits(info.ColorBits);
+        }
+    }
+
+    if (info.AlphaBits > 0)
+    {
+        for(auto s=0u; s<info.SubsetCount; ++s)
+        {
+            endpoints[s][0][3] = reader.GetBits(info.AlphaBits);
+            endpoints[s][1][3] = reader.GetBits(info.AlphaBits);
+        }
+    }
+
+    uint32_t pbits[3][2] = {};
+    if (info.EndpointPBits)
+    {
+        for(auto s=0u; s<info.SubsetCount; ++s)
+        {
+            pbits[s][0] = reader.GetBits(1);
+            pbits[s][1] = reader.GetBits(1);
+        }
+    }
+    else if (info.SharedPBits)
+    {
+        for(auto s=0u; s<info.SubsetCount; ++s)
+        { pbits[s][0] = pbits[s][1] = reader.GetBits(1); }
+    }
+
+    // Pビットを付加して8bitに展開する.
+    auto hasPBit = uint32_t(info.EndpointPBits | info.SharedPBits);
+    for(auto s=0u; s<info.SubsetCount; ++s)
+    {
+        for(auto e=0; e<2; ++e)
+        {
+            for(auto ch=0; ch<4; ++ch)
+            {
+                auto bits = (ch < 3) ? info.ColorBits : info.AlphaBits;
+                if (bits == 0)
+                {
+                    endpoints[s][e][ch] = 255;
+                    continue;
+                }
+
+                auto value = (endpoints[s][e][ch] << hasPBit) | (pbits[s][e] & hasPBit);
+                auto count = bits + hasPBit;
+                endpoints[s][e][ch] = ((value << (8 - count)) | (value >> (2 * count - 8))) & 0xFF;
+            }
+        }
+    }
+
+    uint32_t anchor1 = 0;
+    uint32_t anchor2 = 0;
+    if (info.SubsetCount == 2)
+    { anchor1 = g_Anchor2[partition]; }
+    else if (info.SubsetCount == 3)
+    {
+        anchor1 = g_Anchor3a[partition];
+        anchor2 = g_Anchor3b[partition];
+    }
+
+    uint32_t subsets[16];
+    for(auto i=0; i<16; ++i)
+    {
+        switch(info.SubsetCount)
+        {
+        case 1:  { subsets[i] = 0; } break;
+        case 2:  { subsets[i] = (g_Partition2[partition] >> i) & 0x1; } break;
+        default: { subsets[i] = g_Partition3[partition][i]; } break;
+        }
+    }
+
+    // アンカーピクセルは最上位ビットが省略されている.
+    uint32_t indices[16];
+    for(auto i=0u; i<16; ++i)
+    {
+        auto isAnchor = (i == 0)
+            || (info.SubsetCount >= 2 && i == anchor1)
+            || (info.SubsetCount == 3 && i == anchor2);
+        indices[i] = reader.GetBits(info.IndexBits - (isAnchor ? 1 : 0));
+    }
+
+    uint32_t indices2[16] = {};
+    if (info.IndexBits2 > 0)
+    {
+        for(auto i=0u; i<16; ++i)
+        { indices2[i] = reader.GetBits(info.IndexBits2 - ((i == 0) ? 1 : 0)); }
+    }
+
+    // 2次インデックスがある場合はカラーとアルファで別のインデックスを使う.
+    auto pColorIndices = indices;
+    auto pAlphaIndices = indices;
+    auto colorBits     = uint32_t(info.IndexBits);
+    auto alphaBits     = uint32_t(info.IndexBits);
+    if (info.IndexBits2 > 0)
+    {
+        if (selector == 0)
+        {
+            pAlphaIndices = indices2;
+            alphaBits     = info.IndexBits2;
+        }
+        else
+        {
+            pColorIndices = indices2;
+            colorBits     = info.IndexBits2;
+        }
+    }
+
+    auto pColorWeights = GetWeights(colorBits);
+    auto pAlphaWeights = GetWeights(alphaBits);
+
+    for(auto i=0; i<16; ++i, pOut += 4)
+    {
+        const auto& e0 = endpoints[subsets[i]][0];
+        const auto& e1 = endpoints[subsets[i]][1];
+
+        auto wc = uint32_t(pColorWeights[pColorIndices[i]]);
+        auto wa = uint32_t(pAlphaWeights[pAlphaIndices[i]]);
+
+        uint8_t color[4];
+        for(auto ch=0; ch<3; ++ch)
+        { color[ch] = uint8_t(((64 - wc) * e0[ch] + wc * e1[ch] + 32) >> 6); }
+        color[3] = uint8_t(((64 - wa) * e0[3] + wa * e1[3] + 32) >> 6);
+
+        // 回転指定がある場合はアルファとカラーチャンネルを入れ替える.
+        if (rotation > 0)
+        {
+            auto temp = color[3];
+            color[3] = color[rotation - 1];
+            color[rotation - 1] = temp;
+        }
+
+        pOut[0] = color[0];
+        pOut[1] = color[1];
+        pOut[2] = color[2];
+        pOut[3] = color[3];
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      符号拡張します.
+//-------------------------------------------------------------------------------------------------
+inline int SignExtend(int value, uint32_t bits)
+{
+    auto sign = 1 << (bits - 1);
+    value &= (1 << bits) - 1;
+    return (value ^ sign) - sign;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      量子化された端点を16bitに復元します.
+//-------------------------------------------------------------------------------------------------
+int Unquantize(int value, uint32_t bits, bool isSigned)
+{
+    if (isSigned)
+    {
+        if (bits >= 16)
+        { return value; }
+
+        auto negative = (value < 0);
+        if (negative)
+        { value = -value; }
+
+        int result;
+        if (value == 0)
+        { result = 0; }
+        else if (value >= ((1 << (bits - 1)) - 1))
+        { result = 0x7FFF; }
+        else
+        { result = ((value << 15) + 0x4000) >> (bits - 1); }
+
+        return negative ? -result : result;
+    }
+
+    if (bits >= 15)
+    { return value; }
+    if (value == 0)
+    { return 0; }
+    if (value == ((1 << bits) - 1))
+    { return 0xFFFF; }
+
+    return ((value << 16) + 0x8000) >> bits;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      補間した値を半精度浮動小数のビット列に変換します.
+//-------------------------------------------------------------------------------------------------
+inline uint16_t FinishUnquantize(int value, bool isSigned)
+{
+    if (isSigned)
+    {
+        return (value < 0)
+            ? uint16_t(0x8000 | (((-value) * 31) >> 5))
+            : uint16_t((value * 31) >> 5);
+    }
+
+    return uint16_t((value * 31) >> 6);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC6H形式のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC6H(const uint8_t* pBlock, uint8_t* pOut, bool isSigned)
+{
+    auto pColors = reinterpret_cast<uint16_t*>(pOut);
+
+    // モード番号は下位2bitが 00, 01 の場合は2bit, それ以外は5bit.
+    auto code = uint32_t(pBlock[0] & 0x3);
+    if (code >= 2)
+    { code = pBlock[0] & 0x1F; }
+
+    const BC6H_MODE_INFO* pInfo = nullptr;
+    for(auto& info : g_BC6HModes)
+    {
+        if (info.Code == code)
+        {
+            pInfo = &info;
+            break;
+        }
+    }
+
+    // 予約済みのモードは黒にする.
+    if (pInfo == nullptr)
+    {
+        for(auto i=0; i<16; ++i, pColors += 4)
+        {
+            pColors[0] = 0;
+            pColors[1] = 0;
+            pColors[2] = 0;
+            pColors[3] = 0x3C00;
+        }
+        return;
+    }
+
+    BitReader reader(pBlock);
+    reader.GetBits(pInfo->ModeBits);
+
+    int fields[D + 1] = {};
+    for(auto i=0u; i<pInfo->SegmentCount; ++i)
+    {
+        const auto& segment = pInfo->pSegments[i];
+        if (segment.First <= segment.Last)
+        {
+            auto count = segment.Last - segment.First + 1;
+            fields[segment.Field] |= int(reader.GetBits(count)) << segment.First;
+        }
+        else
+        {
+            for(int bit=segment.First; bit>=segment.Last; --bit)
+            { fields[segment.Field] |= int(reader.GetBits(1)) << bit; }
+        }
+    }
+
+    // endpoints[サブセット][端点][チャンネル].
+    int endpoints[2][2][3];
+    for(auto ch=0; ch<3; ++ch)
+    {
+        endpoints[0][0][ch] = fields[RW + ch];
+        endpoints[0][1][ch] = fields[RX + ch];
+        endpoints[1][0][ch] = fields[RY + ch];
+        endpoints[1][1][ch] = fields[RZ + ch];
+    }
+
+    auto baseBits = uint32_t(pInfo->BaseBits);
+    for(auto ch=0; ch<3; ++ch)
+    {
+        if (isSigned)
+        { endpoints[0][0][ch] = SignExtend(endpoints[0][0][ch], baseBits); }
+
+        if (isSigned || pInfo->Transformed)
+        {
+            for(auto s=0u; s<pInfo->SubsetCount; ++s)
+            {
+                for(auto e=0; e<2; ++e)
+                {
+                    if (s == 0 && e == 0)
+                    { continue; }
+                    endpoints[s][e][ch] = SignExtend(endpoints[s][e][ch], pInfo->DeltaBits[ch]);
+                }
+            }
+        }
+
+        // 差分を絶対値に戻す.
+        if (pInfo->Transformed)
+        {
+            auto mask = (1 << baseBits) - 1;
+            for(auto s=0u; s<pInfo->SubsetCount; ++s)
+            {
+                for(auto e=0; e<2; ++e)
+                {
+                    if (s == 0 && e == 0)
+                    { continue; }
+
+                    auto value = (endpoints[0][0][ch] + endpoints[s][e][ch]) & mask;
+                    endpoints[s][e][ch] = isSigned ? SignExtend(value, baseBits) : value;
+                }
+            }
+        }
+
+        for(auto s=0u; s<pInfo->SubsetCount; ++s)
+        {
+            endpoints[s][0][ch] = Unquantize(endpoints[s][0][ch], baseBits, isSigned);
+            endpoints[s][1][ch] = Unquantize(endpoints[s][1][ch], baseBits, isSigned);
+        }
+    }
+
+    auto partition  = uint32_t(fields[D]);
+    auto indexBits  = (pInfo->SubsetCount == 2) ? 3u : 4u;
+    auto anchor1    = (pInfo->SubsetCount == 2) ? uint32_t(g_Anchor2[partition]) : 0u;
+    auto pWeights   = GetWeights(indexBits);
+
+    for(auto i=0u; i<16; ++i, pColors += 4)
+    {
+        auto isAnchor = (i == 0) || (pInfo->SubsetCount == 2 && i == anchor1);
+        auto index    = reader.GetBits(indexBits - (isAnchor ? 1 : 0));
+        auto subset   = (pInfo->SubsetCount == 2) ? ((g_Partition2[partition] >> i) & 0x1) : 0;
+        auto w        = int(pWeights[index]);
+
+        for(auto ch=0; ch<3; ++ch)
+        {
+            auto value = ((64 - w) * endpoints[subset][0][ch] + w * endpoints[subset][1][ch] + 32) >> 6;
+            pColors[ch] = FinishUnquantize(value, isSigned);
+        }
+        pColors[3] = 0x3C00;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC6H形式(UF16)のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC6HU(const uint8_t* pBlock, uint8_t* pOut)
+{ DecodeBC6H(pBlock, pOut, false); }
+
+//-------------------------------------------------------------------------------------------------
+//      BC6H形式(SF16)のブロックを展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBC6HS(const uint8_t* pBlock, uint8_t* pOut)
+{ DecodeBC6H(pBlock, pOut, true); }
+
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ブロック展開関数です.
+//!
+//! @param[in]      pBlock      ブロックです.
+//! @param[out]     pOut        4x4ピクセルの出力先です(1行あたり4ピクセルで詰めて書き込みます).
+//-------------------------------------------------------------------------------------------------
+typedef void (*DecodeBlockFunc)(const uint8_t* pBlock, uint8_t* pOut);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DECODER_INFO structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct DECODER_INFO
+{
+    uint32_t            BlockSize;      //!< 1ブロックあたりのバイト数です.
+    uint32_t            PixelSize;      //!< 展開後の1ピクセルあたりのバイト数です.
+    uint32_t            Format;         //!< 展開後のフォーマットです.
+    DecodeBlockFunc     Decode;         //!< ブロック展開関数です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      フォーマットに対応するデコーダ情報を取得します.
+//-------------------------------------------------------------------------------------------------
+bool GetDecoderInfo(uint32_t format, DECODER_INFO& info)
+{
+    switch(format)
+    {
+    case DXGI_FORMAT_BC1_TYPELESS:
+    case DXGI_FORMAT_BC1_UNORM:         { info = { 8,  4, DXGI_FORMAT_R8G8B8A8_UNORM,      DecodeBC1 }; } break;
+    case DXGI_FORMAT_BC1_UNORM_SRGB:    { info = { 8,  4, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DecodeBC1 }; } break;
+    case DXGI_FORMAT_BC2_TYPELESS:
+    case DXGI_FORMAT_BC2_UNORM:         { info = { 16, 4, DXGI_FORMAT_R8G8B8A8_UNORM,      DecodeBC2 }; } break;
+    case DXGI_FORMAT_BC2_UNORM_SRGB:    { info = { 16, 4, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DecodeBC2 }; } break;
+    case DXGI_FORMAT_BC3_TYPELESS:
+    case DXGI_FORMAT_BC3_UNORM:         { info = { 16, 4, DXGI_FORMAT_R8G8B8A8_UNORM,      DecodeBC3 }; } break;
+    case DXGI_FORMAT_BC3_UNORM_SRGB:    { info = { 16, 4, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DecodeBC3 }; } break;
+    case DXGI_FORMAT_BC4_TYPELESS:
+    case DXGI_FORMAT_BC4_UNORM:         { info = { 8,  4, DXGI_FORMAT_R8G8B8A8_UNORM,      DecodeBC4U }; } break;
+    case DXGI_FORMAT_BC4_SNORM:         { info = { 8,  8, DXGI_FORMAT_R16G16B16A16_FLOAT,  DecodeBC4S }; } break;
+    case DXGI_FORMAT_BC5_TYPELESS:
+    case DXGI_FORMAT_BC5_UNORM:         { info = { 16, 4, DXGI_FORMAT_R8G8B8A8_UNORM,      DecodeBC5U }; } break;
+    case DXGI_FORMAT_BC5_SNORM:         { info = { 16, 8, DXGI_FORMAT_R16G16B16A16_FLOAT,  DecodeBC5S }; } break;
+    case DXGI_FORMAT_BC6H_TYPELESS:
+    case DXGI_FORMAT_BC6H_UF16:         { info = { 16, 8, DXGI_FORMAT_R16G16B16A16_FLOAT,  DecodeBC6HU }; } break;
+    case DXGI_FORMAT_BC6H_SF16:         { info = { 16, 8, DXGI_FORMAT_R16G16B16A16_FLOAT,  DecodeBC6HS }; } break;
+    case DXGI_FORMAT_BC7_TYPELESS:
+    case DXGI_FORMAT_BC7_UNORM:         { info = { 16, 4, DXGI_FORMAT_R8G8B8A8_UNORM,      DecodeBC7 }; } break;
+    case DXGI_FORMAT_BC7_UNORM_SRGB:    { info = { 16, 4, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DecodeBC7 }; } break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1ブロック行を展開します.
+//-------------------------------------------------------------------------------------------------
+void DecodeBlockRow
+(
+    const DECODER_INFO& info,
+    const uint8_t*      pSrc,
+    uint32_t            width,
+    uint32_t            rows,
+    uint8_t*            pDst,
+    uint32_t            dstPitch
+)
+{
+    uint8_t block[16 * 8];
+    auto blockPitch = info.PixelSize * 4;
+
+    for(auto x=0u; x<width; x+=4, pSrc+=info.BlockSize)
+    {
+        info.Decode(pSrc, block);
+
+        auto columns = (width - x < 4) ? width - x : 4;
+        auto pOut    = pDst + size_t(x) * info.PixelSize;
+        for(auto y=0u; y<rows; ++y)
+        { memcpy(pOut + size_t(y) * dstPitch, block + y * blockPitch, columns * info.PixelSize); }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BLOCK_ROW structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BLOCK_ROW
+{
+    const uint8_t*  pSrc;       //!< 入力ブロック行です.
+    uint8_t*        pDst;       //!< 出力先です.
+    uint32_t        Width;      //!< 横幅です.
+    uint32_t        Rows;       //!< 出力する行数です(1～4).
+    uint32_t        DstPitch;   //!< 出力先の1行あたりのバイト数です.
+};
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//      ブロック圧縮フォーマットかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsBlockCompressedFormat(uint32_t format)
+{
+    DECODER_INFO info;
+    return GetDecoderInfo(format, info);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ブロック圧縮フォーマットの展開後のフォーマットを取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GetDecodedFormat(uint32_t format)
+{
+    DECODER_INFO info;
+    if (!GetDecoderInfo(format, info))
+    { return DXGI_FORMAT_UNKNOWN; }
+
+    return info.Format;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ブロック圧縮されたピクセルデータを展開します.
+//-------------------------------------------------------------------------------------------------
+bool DecodeBlocks
+(
+    uint32_t        format,
+    const uint8_t*  pSrc,
+    uint32_t        srcPitch,
+    uint32_t        width,
+    uint32_t        height,
+    uint8_t*        pDst,
+    uint32_t        dstPitch
+)
+{
+    DECODER_INFO info;
+    if (!GetDecoderInfo(format, info))
+    { return false; }
+
+    if (pSrc == nullptr || pDst == nullptr)
+    { return false; }
+
+    for(auto y=0u; y<height; y+=4)
+    {
+        auto rows = (height - y < 4) ? height - y : 4;
+        DecodeBlockRow(info, pSrc, width, rows, pDst, dstPitch);
+        pSrc += srcPitch;
+        pDst += size_t(dstPitch) * 4;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ブロック圧縮されたリソーステクスチャを展開します.
+//-------------------------------------------------------------------------------------------------
+bool DecodeResTexture(const ResTexture& src, ResTexture& dst)
+{
+    DECODER_INFO info;
+    if (!GetDecoderInfo(src.Format, info))
+    {
+        ELOG("Error : Unsupported Format. format = %u", src.Format);
+        return false;
+    }
+
+    if (src.pResources == nullptr || &src == &dst)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto isVolume = (src.Option & SUBRESOURCE_OPTION_VOLUME) != 0;
+    auto count    = src.MipMapCount * src.SurfaceCount;
+
+    // ブロック行数を求める.
+    uint32_t rowCount = 0;
+    for(auto i=0u; i<count; ++i)
+    {
+        const auto& res = src.pResources[i];
+        if (res.pPixels == nullptr)
+        {
+            ELOG("Error : SubResource is not resident. index = %u", i);
+            return false;
+        }
+
+        auto mip   = i % src.MipMapCount;
+        auto depth = (isVolume && mip < 32) ? (src.Depth >> mip) : 1;
+        if (depth == 0)
+        { depth = 1; }
+
+        rowCount += ((res.Height + 3) / 4) * depth;
+    }
+
+    ResTexture result;
+    result.Width        = src.Width;
+    result.Height       = src.Height;
+    result.Depth        = src.Depth;
+    result.Format       = info.Format;
+    result.MipMapCount  = src.MipMapCount;
+    result.SurfaceCount = src.SurfaceCount;
+    result.Option       = src.Option;
+
+    // サブリソースとピクセルデータをまとめて確保する.
+    if (!AllocateResTexture(result))
+    { return false; }
+
+    std::vector<BLOCK_ROW> blockRows;
+    blockRows.reserve(rowCount);
+
+    for(auto i=0u; i<count; ++i)
+    {
+        const auto& res = src.pResources[i];
+
+        auto mip   = i % src.MipMapCount;
+        auto depth = (isVolume && mip < 32) ? (src.Depth >> mip) : 1;
+        if (depth == 0)
+        { depth = 1; }
+
+        const auto& dstRes = result.pResources[i];
+        if (dstRes.Width != res.Width || dstRes.Height != res.Height)
+        {
+            ELOG("Error : Invalid SubResource Size. index = %u", i);
+            result.Release();
+            return false;
+        }
+
+        for(auto z=0u; z<depth; ++z)
+        {
+            auto pSrc = res.pPixels + size_t(res.SlicePitch) * z;
+            auto pDst = dstRes.pPixels + size_t(dstRes.SlicePitch) * z;
+
+            for(auto y=0u; y<res.Height; y+=4)
+            {
+                BLOCK_ROW row;
+                row.pSrc     = pSrc + size_t(res.Pitch) * (y / 4);
+                row.pDst     = pDst + size_t(dstRes.Pitch) * y;
+                row.Width    = res.Width;
+                row.Rows     = (res.Height - y < 4) ? res.Height - y : 4;
+                row.DstPitch = dstRes.Pitch;
+                blockRows.push_back(row);
+            }
+        }
+    }
+
+    // 小さいミップレベルもまとめてブロック行単位で分割する.
+    const auto pRows = blockRows.data();
+    ParallelFor(uint32_t(blockRows.size()), 16, [=](uint32_t begin, uint32_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            const auto& row = pRows[i];
+            DecodeBlockRow(info, row.pSrc, row.Width, row.Rows, row.pDst, row.DstPitch);
+        }
+    });
+
+    dst = result;
+    return true;
+}
+
+} // namespace asdx
@@ -0,0 +1,1056 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxBCEncoder.cpp
+// Desc : Block Compression Encoder Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxBCEncoder.h>
+#include <asdxResTexture.h>
+#include <asdxLogger.h>
+#include <asdxParallelFor.h>
+#include <dxgiformat.h>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <vector>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint8_t g_Weight4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BitWriter class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class BitWriter
+{
+public:
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    BitWriter()
+    : m_Lo  (0)
+    , m_Hi  (0)
+    , m_Pos (0)
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      下位ビットから順に指定ビット数を書き込みます.
+    //!
+    //! @param[in]      value       書き込む値です.
+    //! @param[in]      count       ビット数です(1～32).
+    //---------------------------------------------------------------------------------------------
+    void PutBits(uint32_t value, uint32_t count)
+    {
+        auto bits = uint64_t(value) & ((uint64_t(1) << count) - 1);
+        if (m_Pos >= 64)
+        { m_Hi |= bits << (m_Pos - 64); }
+        else
+        {
+            m_Lo |= bits << m_Pos;
+            if (m_Pos + count > 64)
+            { m_Hi |= bits >> (64 - m_Pos); }
+        }
+        m_Pos += count;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      16byteのブロックとして書き出します.
+    //!
+    //! @param[out]     pBlock      出力先です.
+    //---------------------------------------------------------------------------------------------
+    void Store(uint8_t* pBlock) const
+    {
+        memcpy(pBlock + 0, &m_Lo, sizeof(m_Lo));
+        memcpy(pBlock + 8, &m_Hi, sizeof(m_Hi));
+    }
+
+private:
+    uint64_t    m_Lo;       //!< 下位64bitです.
+    uint64_t    m_Hi;       //!< 上位64bitです.
+    uint32_t    m_Pos;      //!< 書き込み位置です.
+};
+
+
+//-------------------------------------------------------------------------------------------------
+//      値を範囲内に収めます.
+//-------------------------------------------------------------------------------------------------
+inline float Saturate255(float value)
+{ return (value < 0.0f) ? 0.0f : (value > 255.0f) ? 255.0f : value; }
+
+//-------------------------------------------------------------------------------------------------
+//      点群の主軸を求めます.
+//-------------------------------------------------------------------------------------------------
+void ComputePrincipalAxis
+(
+    const float (*pPoints)[4],
+    uint32_t    count,
+    uint32_t    channels,
+    uint32_t    iterations,
+    float*      pMean,
+    float*      pAxis
+)
+{
+    for(auto c=0u; c<4; ++c)
+    {
+        pMean[c] = 0.0f;
+        pAxis[c] = 0.0f;
+    }
+
+    for(auto i=0u; i<count; ++i)
+    {
+        for(auto c=0u; c<channels; ++c)
+        { pMean[c] += pPoints[i][c]; }
+    }
+    for(auto c=0u; c<channels; ++c)
+    { pMean[c] /= float(count); }
+
+    float cov[4][4] = {};
+    float minValue[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+    float maxValue[4] = {};
+    for(auto i=0u; i<count; ++i)
+    {
+        float d[4];
+        for(auto c=0u; c<channels; ++c)
+        {
+            d[c] = pPoints[i][c] - pMean[c];
+            if (pPoints[i][c] < minValue[c]) { minValue[c] = pPoints[i][c]; }
+            if (pPoints[i][c] > maxValue[c]) { maxValue[c] = pPoints[i][c]; }
+        }
+
+        for(auto r=0u; r<channels; ++r)
+        {
+            for(auto c=0u; c<channels; ++c)
+            { cov[r][c] += d[r] * d[c]; }
+        }
+    }
+
+    // 範囲の対角を初期値にしてべき乗法で最大固有ベクトルを求める.
+    float axis[4] = {};
+    for(auto c=0u; c<channels; ++c)
+    { axis[c] = maxValue[c] - minValue[c]; }
+
+    for(auto iter=0u; iter<iterations; ++iter)
+    {
+        float next[4] = {};
+        auto  length  = 0.0f;
+        for(auto r=0u; r<channels; ++r)
+        {
+            for(auto c=0u; c<channels; ++c)
+            { next[r] += cov[r][c] * axis[c]; }
+            length = (fabsf(next[r]) > length) ? fabsf(next[r]) : length;
+        }
+
+        if (length <= 0.0f)
+        { break; }
+
+        for(auto c=0u; c<channels; ++c)
+        { axis[c] = next[c] / length; }
+    }
+
+    auto length = 0.0f;
+    for(auto c=0u; c<channels; ++c)
+    { length += axis[c] * axis[c]; }
+
+    if (length <= 1e-12f)
+    {
+        // 全ての点が同じ場合.
+        for(auto c=0u; c<channels; ++c)
+        { pAxis[c] = 0.0f; }
+        return;
+    }
+
+    length = sqrtf(length);
+    for(auto c=0u; c<channels; ++c)
+    { pAxis[c] = axis[c] / length; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      主軸上の範囲から端点を求めます.
+//-------------------------------------------------------------------------------------------------
+void ComputeEndpoints
+(
+    const float (*pPoints)[4],
+    uint32_t    count,
+    uint32_t    channels,
+    uint32_t    iterations,
+    float*      pEndpoint0,
+    float*      pEndpoint1
+)
+{
+    float mean[4];
+    float axis[4];
+    ComputePrincipalAxis(pPoints, count, channels, iterations, mean, axis);
+
+    auto minT = 0.0f;
+    auto maxT = 0.0f;
+    for(auto i=0u; i<count; ++i)
+    {
+        auto t = 0.0f;
+        for(auto c=0u; c<channels; ++c)
+        { t += (pPoints[i][c] - mean[c]) * axis[c]; }
+
+        if (t < minT) { minT = t; }
+        if (t > maxT) { maxT = t; }
+    }
+
+    for(auto c=0u; c<4; ++c)
+    {
+        pEndpoint0[c] = (c < channels) ? Saturate255(mean[c] + axis[c] * maxT) : 255.0f;
+        pEndpoint1[c] = (c < channels) ? Saturate255(mean[c] + axis[c] * minT) : 255.0f;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      インデックスを固定して端点を最小二乗法で求め直します.
+//-------------------------------------------------------------------------------------------------
+bool RefineEndpoints
+(
+    const float (*pPoints)[4],
+    const float* pWeights,
+    uint32_t    count,
+    uint32_t    channels,
+    float*      pEndpoint0,
+    float*      pEndpoint1
+)
+{
+    auto aa = 0.0f;
+    auto ab = 0.0f;
+    auto bb = 0.0f;
+    float ax[4] = {};
+    float bx[4] = {};
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto b = pWeights[i];
+        auto a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+
+        for(auto c=0u; c<channels; ++c)
+        {
+            ax[c] += a * pPoints[i][c];
+            bx[c] += b * pPoints[i][c];
+        }
+    }
+
+    auto det = aa * bb - ab * ab;
+    if (fabsf(det) < 1e-6f)
+    { return false; }
+
+    auto invDet = 1.0f / det;
+    for(auto c=0u; c<channels; ++c)
+    {
+        pEndpoint0[c] = Saturate255((bb * ax[c] - ab * bx[c]) * invDet);
+        pEndpoint1[c] = Saturate255((aa * bx[c] - ab * ax[c]) * invDet);
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      RGBA8形式をR5G6B5形式に量子化します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t Quantize565(const float* pColor)
+{
+    auto r = uint32_t(Saturate255(pColor[0]) * 31.0f / 255.0f + 0.5f);
+    auto g = uint32_t(Saturate255(pColor[1]) * 63.0f / 255.0f + 0.5f);
+    auto b = uint32_t(Saturate255(pColor[2]) * 31.0f / 255.0f + 0.5f);
+    return (r << 11) | (g << 5) | b;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      R5G6B5形式をRGBA8形式に展開します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t Expand565(uint32_t color)
+{
+    auto r = (color >> 11) & 0x1F;
+    auto g = (color >>  5) & 0x3F;
+    auto b = (color >>  0) & 0x1F;
+
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+
+    return r | (g << 8) | (b << 16) | 0xFF000000;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2色を補間します(デコーダと同じ丸めで計算します).
+//-------------------------------------------------------------------------------------------------
+inline uint32_t LerpColor(uint32_t c0, uint32_t c1, uint32_t w0, uint32_t w1, uint32_t div)
+{
+    uint32_t result = 0;
+    for(auto shift=0u; shift<24; shift+=8)
+    {
+        auto a = (c0 >> shift) & 0xFF;
+        auto b = (c1 >> shift) & 0xFF;
+        result |= ((a * w0 + b * w1 + div / 2) / div) << shift;
+    }
+    return result | 0xFF000000;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// COLOR_BLOCK structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct COLOR_BLOCK
+{
+    uint32_t    Color0;     //!< 端点0(R5G6B5形式)です.
+    uint32_t    Color1;     //!< 端点1(R5G6B5形式)です.
+    uint32_t    Indices;    //!< 2bitインデックスです.
+    uint32_t    Error;      //!< 二乗誤差です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      端点を量子化してインデックスを求めます.
+//-------------------------------------------------------------------------------------------------
+COLOR_BLOCK FitColorBlock
+(
+    const uint8_t*  pPixels,
+    const bool*     pTransparent,
+    bool            hasTransparent,
+    bool            allowTransparent,
+    const float*    pEndpoint0,
+    const float*    pEndpoint1
+)
+{
+    COLOR_BLOCK result;
+    result.Color0 = Quantize565(pEndpoint0);
+    result.Color1 = Quantize565(pEndpoint1);
+
+    // 透明ピクセルがある場合は3色モード(c0 <= c1), それ以外は4色モード(c0 > c1)に並べる.
+    if (hasTransparent == (result.Color0 > result.Color1))
+    {
+        auto temp     = result.Color0;
+        result.Color0 = result.Color1;
+        result.Color1 = temp;
+    }
+
+    uint32_t palette[4];
+    palette[0] = Expand565(result.Color0);
+    palette[1] = Expand565(result.Color1);
+
+    // デコーダと同じ条件でパレットを作る(端点が等しい場合はBC1では3色モードになる).
+    auto fourColor = (result.Color0 > result.Color1) || !allowTransparent;
+    if (fourColor)
+    {
+        palette[2] = LerpColor(palette[0], palette[1], 2, 1, 3);
+        palette[3] = LerpColor(palette[0], palette[1], 1, 2, 3);
+    }
+    else
+    {
+        palette[2] = LerpColor(palette[0], palette[1], 1, 1, 2);
+        palette[3] = 0;
+    }
+
+    auto paletteCount = fourColor ? 4u : 3u;
+
+    result.Indices = 0;
+    result.Error   = 0;
+    for(auto i=0u; i<16; ++i)
+    {
+        if (pTransparent[i])
+        {
+            result.Indices |= 3u << (i * 2);
+            continue;
+        }
+
+        auto pPixel    = pPixels + i * 4;
+        auto bestIndex = 0u;
+        auto bestError = UINT32_MAX;
+        for(auto j=0u; j<paletteCount; ++j)
+        {
+            auto dr = int(pPixel[0]) - int((palette[j] >>  0) & 0xFF);
+            auto dg = int(pPixel[1]) - int((palette[j] >>  8) & 0xFF);
+            auto db = int(pPixel[2]) - int((palette[j] >> 16) & 0xFF);
+            auto error = uint32_t(dr * dr + dg * dg + db * db);
+            if (error < bestError)
+            {
+                bestError = error;
+                bestIndex = j;
+            }
+        }
+
+        result.Indices |= bestIndex << (i * 2);
+        result.Error   += bestError;
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      カラーブロック(BC1形式)を圧縮します.
+//-------------------------------------------------------------------------------------------------
+void EncodeColorBlock(const uint8_t* pPixels, uint8_t* pBlock, bool allowTransparent, bool highQuality)
+{
+    float    points[16][4];
+    bool     transparent[16];
+    uint32_t pixelIndices[16];
+    uint32_t count = 0;
+
+    for(auto i=0u; i<16; ++i)
+    {
+        auto pPixel = pPixels + i * 4;
+        transparent[i] = allowTransparent && (pPixel[3] < 128);
+        if (transparent[i])
+        { continue; }
+
+        points[count][0] = pPixel[0];
+        points[count][1] = pPixel[1];
+        points[count][2] = pPixel[2];
+        points[count][3] = 255.0f;
+        pixelIndices[count] = i;
+        count++;
+    }
+
+    COLOR_BLOCK best;
+    if (count == 0)
+    {
+        // 全て透明な場合.
+        best.Color0  = 0;
+        best.Color1  = 0;
+        best.Indices = 0xFFFFFFFF;
+    }
+    else
+    {
+        auto hasTransparent = (count < 16);
+
+        float e0[4];
+        float e1[4];
+        ComputeEndpoints(points, count, 3, highQuality ? 8 : 3, e0, e1);
+        best = FitColorBlock(pPixels, transparent, hasTransparent, allowTransparent, e0, e1);
+
+        // インデックスを固定して端点を調整し，誤差が減らなくなったら終了.
+        for(auto iter=0; highQuality && iter<2 && best.Error > 0; ++iter)
+        {
+            auto fourColor = (best.Color0 > best.Color1) || !allowTransparent;
+
+            float weights[16];
+            for(auto i=0u; i<count; ++i)
+            {
+                auto index = (best.Indices >> (pixelIndices[i] * 2)) & 0x3;
+                static const float kFour [4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+                static const float kThree[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+                weights[i] = fourColor ? kFour[index] : kThree[index];
+            }
+
+            if (!RefineEndpoints(points, weights, count, 3, e0, e1))
+            { break; }
+
+            auto candidate = FitColorBlock(pPixels, transparent, hasTransparent, allowTransparent, e0, e1);
+            if (candidate.Error >= best.Error)
+            { break; }
+
+            best = candidate;
+        }
+    }
+
+    pBlock[0] = uint8_t(best.Color0 & 0xFF);
+    pBlock[1] = uint8_t(best.Color0 >> 8);
+    pBlock[2] = uint8_t(best.Color1 & 0xFF);
+    pBlock[3] = uint8_t(best.Color1 >> 8);
+    memcpy(pBlock + 4, &best.Indices, sizeof(best.Indices));
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8bitの補間テーブルを生成します(デコーダと同じ丸めで計算します).
+//-------------------------------------------------------------------------------------------------
+void MakeAlphaPalette(uint32_t a0, uint32_t a1, uint8_t* pPalette)
+{
+    pPalette[0] = uint8_t(a0);
+    pPalette[1] = uint8_t(a1);
+
+    if (a0 > a1)
+    {
+        for(auto i=1u; i<7; ++i)
+        { pPalette[i + 1] = uint8_t(((7 - i) * a0 + i * a1 + 3) / 7); }
+    }
+    else
+    {
+        for(auto i=1u; i<5; ++i)
+        { pPalette[i + 1] = uint8_t(((5 - i) * a0 + i * a1 + 2) / 5); }
+        pPalette[6] = 0;
+        pPalette[7] = 255;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アルファブロックのインデックスを求めます.
+//-------------------------------------------------------------------------------------------------
+uint32_t FitAlphaIndices(const uint8_t* pValues, uint32_t a0, uint32_t a1, uint64_t& indices)
+{
+    uint8_t palette[8];
+    MakeAlphaPalette(a0, a1, palette);
+
+    uint32_t error = 0;
+    indices = 0;
+    for(auto i=0u; i<16; ++i)
+    {
+        auto bestIndex = 0u;
+        auto bestError = UINT32_MAX;
+        for(auto j=0u; j<8; ++j)
+        {
+            auto d = int(pValues[i * 4]) - int(palette[j]);
+            auto e = uint32_t(d * d);
+            if (e < bestError)
+            {
+                bestError = e;
+                bestIndex = j;
+            }
+        }
+
+        indices |= uint64_t(bestIndex) << (i * 3);
+        error   += bestError;
+    }
+
+    return error;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アルファブロック(BC3, BC4, BC5形式)を圧縮します.
+//
+//      pValues は4byte間隔で16個の値を参照します.
+//-------------------------------------------------------------------------------------------------
+void EncodeAlphaBlock(const uint8_t* pValues, uint8_t* pBlock, bool highQuality)
+{
+    uint32_t minValue = 255;
+    uint32_t maxValue = 0;
+    uint32_t minInner = 255;
+    uint32_t maxInner = 0;
+    for(auto i=0u; i<16; ++i)
+    {
+        uint32_t value = pValues[i * 4];
+        if (value < minValue) { minValue = value; }
+        if (value > maxValue) { maxValue = value; }
+
+        // 6値モードでは 0 と 255 を直接表現できるので，範囲から除外する.
+        if (value != 0 && value != 255)
+        {
+            if (value < minInner) { minInner = value; }
+            if (value > maxInner) { maxInner = value; }
+        }
+    }
+
+    uint32_t a0 = maxValue;
+    uint32_t a1 = minValue;
+    uint64_t indices = 0;
+
+    if (minValue == maxValue)
+    {
+        // 単色は6値モードの端点0で表現する.
+        a0 = a1 = minValue;
+    }
+    else
+    {
+        // 8値モード(a0 > a1).
+        auto error = FitAlphaIndices(pValues, a0, a1, indices);
+
+        // 6値モード(a0 <= a1)も試して誤差が小さい方を選ぶ.
+        if (highQuality && error > 0)
+        {
+            auto lo = (minInner <= maxInner) ? minInner : 0;
+            auto hi = (minInner <= maxInner) ? maxInner : 0;
+
+            uint64_t candidate;
+            if (FitAlphaIndices(pValues, lo, hi, candidate) < error)
+            {
+                a0      = lo;
+                a1      = hi;
+                indices = candidate;
+            }
+        }
+    }
+
+    pBlock[0] = uint8_t(a0);
+    pBlock[1] = uint8_t(a1);
+    for(auto i=0; i<6; ++i)
+    { pBlock[2 + i] = uint8_t(indices >> (i * 8)); }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BC7_BLOCK structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BC7_BLOCK
+{
+    uint32_t    Endpoints[2][4];    //!< 7bitの端点です.
+    uint32_t    PBits[2];           //!< Pビットです.
+    uint32_t    Indices[16];        //!< 4bitインデックスです.
+    uint32_t    Error;              //!< 二乗誤差です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      端点を量子化してインデックスを求めます(BC7 モード6).
+//-------------------------------------------------------------------------------------------------
+BC7_BLOCK FitBC7Mode6(const uint8_t* pPixels, const float* pEndpoint0, const float* pEndpoint1, bool highQuality)
+{
+    BC7_BLOCK result;
+    const float* pEndpoints[2] = { pEndpoint0, pEndpoint1 };
+
+    // Pビットは端点ごとに誤差が小さくなる方を選ぶ.
+    int decoded[2][4];
+    for(auto e=0; e<2; ++e)
+    {
+        auto bestError = 0.0f;
+        for(auto p=0u; p<2; ++p)
+        {
+            auto error = 0.0f;
+            uint32_t q[4];
+            for(auto c=0; c<4; ++c)
+            {
+                auto v = (pEndpoints[e][c] - float(p)) * 0.5f + 0.5f;
+                q[c] = (v <= 0.0f) ? 0 : (v >= 127.0f) ? 127 : uint32_t(v);
+                auto d = float(q[c] * 2 + p) - pEndpoints[e][c];
+                error += d * d;
+            }
+
+            if (p == 0 || error < bestError)
+            {
+                bestError = error;
+                result.PBits[e] = p;
+                for(auto c=0; c<4; ++c)
+                {
+                    result.Endpoints[e][c] = q[c];
+                    decoded[e][c] = int(q[c] * 2 + p);
+                }
+            }
+        }
+    }
+
+    int palette[16][4];
+    for(auto i=0; i<16; ++i)
+    {
+        auto w = int(g_Weight4[i]);
+        for(auto c=0; c<4; ++c)
+        { palette[i][c] = ((64 - w) * decoded[0][c] + w * decoded[1][c] + 32) >> 6; }
+    }
+
+    int dir[4];
+    auto length = 0;
+    for(auto c=0; c<4; ++c)
+    {
+        dir[c] = decoded[1][c] - decoded[0][c];
+        length += dir[c] * dir[c];
+    }
+
+    result.Error = 0;
+    for(auto i=0; i<16; ++i)
+    {
+        auto pPixel = pPixels + i * 4;
+
+        uint32_t index = 0;
+        if (highQuality)
+        {
+            // 全候補から最も近いものを選ぶ.
+            auto bestError = UINT32_MAX;
+            for(auto j=0u; j<16; ++j)
+            {
+                auto error = 0u;
+                for(auto c=0; c<4; ++c)
+                {
+                    auto d = int(pPixel[c]) - palette[j][c];
+                    error += uint32_t(d * d);
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    index     = j;
+                }
+            }
+        }
+        else if (length > 0)
+        {
+            // 端点を結ぶ線分に射影する.
+            auto dot = 0;
+            for(auto c=0; c<4; ++c)
+            { dot += (int(pPixel[c]) - decoded[0][c]) * dir[c]; }
+
+            auto t = (float(dot) / float(length)) * 15.0f + 0.5f;
+            index = (t <= 0.0f) ? 0 : (t >= 15.0f) ? 15 : uint32_t(t);
+        }
+
+        for(auto c=0; c<4; ++c)
+        {
+            auto d = int(pPixel[c]) - palette[index][c];
+            result.Error += uint32_t(d * d);
+        }
+
+        result.Indices[i] = index;
+    }
+
+    // アンカーピクセル(先頭)のインデックスの最上位ビットは0でなければならないので，端点を入れ替える.
+    if (result.Indices[0] & 0x8)
+    {
+        for(auto c=0; c<4; ++c)
+        {
+            auto temp = result.Endpoints[0][c];
+            result.Endpoints[0][c] = result.Endpoints[1][c];
+            result.Endpoints[1][c] = temp;
+        }
+
+        auto temp = result.PBits[0];
+        result.PBits[0] = result.PBits[1];
+        result.PBits[1] = temp;
+
+        for(auto i=0; i<16; ++i)
+        { result.Indices[i] = 15 - result.Indices[i]; }
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC7形式のブロックを圧縮します.
+//
+//      全ピクセルを1サブセットで表現するモード6のみを使用します.
+//-------------------------------------------------------------------------------------------------
+void EncodeBC7(const uint8_t* pPixels, uint8_t* pBlock, bool highQuality)
+{
+    float points[16][4];
+    for(auto i=0; i<16; ++i)
+    {
+        for(auto c=0; c<4; ++c)
+        { points[i][c] = pPixels[i * 4 + c]; }
+    }
+
+    float e0[4];
+    float e1[4];
+    ComputeEndpoints(points, 16, 4, highQuality ? 8 : 3, e0, e1);
+
+    auto best = FitBC7Mode6(pPixels, e0, e1, highQuality);
+
+    for(auto iter=0; highQuality && iter<2 && best.Error > 0; ++iter)
+    {
+        // 入れ替え後のインデックスでも端点との対応は保たれているので，そのまま使う.
+        float weights[16];
+        for(auto i=0; i<16; ++i)
+        { weights[i] = float(g_Weight4[best.Indices[i]]) / 64.0f; }
+
+        if (!RefineEndpoints(points, weights, 16, 4, e0, e1))
+        { break; }
+
+        auto candidate = FitBC7Mode6(pPixels, e0, e1, highQuality);
+        if (candidate.Error >= best.Error)
+        { break; }
+
+        best = candidate;
+    }
+
+    BitWriter writer;
+    writer.PutBits(1 << 6, 7);
+
+    for(auto c=0; c<4; ++c)
+    {
+        writer.PutBits(best.Endpoints[0][c], 7);
+        writer.PutBits(best.Endpoints[1][c], 7);
+    }
+
+    writer.PutBits(best.PBits[0], 1);
+    writer.PutBits(best.PBits[1], 1);
+
+    writer.PutBits(best.Indices[0], 3);
+    for(auto i=1; i<16; ++i)
+    { writer.PutBits(best.Indices[i], 4); }
+
+    writer.Store(pBlock);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC1形式のブロックを圧縮します.
+//-------------------------------------------------------------------------------------------------
+void EncodeBC1(const uint8_t* pPixels, uint8_t* pBlock, bool highQuality)
+{ EncodeColorBlock(pPixels, pBlock, true, highQuality); }
+
+//-------------------------------------------------------------------------------------------------
+//      BC3形式のブロックを圧縮します.
+//-------------------------------------------------------------------------------------------------
+void EncodeBC3(const uint8_t* pPixels, uint8_t* pBlock, bool highQuality)
+{
+    EncodeAlphaBlock(pPixels + 3, pBlock, highQuality);
+    EncodeColorBlock(pPixels, pBlock + 8, false, highQuality);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BC4形式のブロックを圧縮します.
+//-------------------------------------------------------------------------------------------------
+void EncodeBC4(const uint8_t* pPixels, uint8_t* pBlock, bool highQuality)
+{ EncodeAlphaBlock(pPixels + 0, pBlock, highQuality); }
+
+//-------------------------------------------------------------------------------------------------
+//      BC5形式のブロックを圧縮します.
+//-------------------------------------------------------------------------------------------------
+void EncodeBC5(const uint8_t* pPixels, uint8_t* pBlock, bool highQuality)
+{
+    EncodeAlphaBlock(pPixels + 0, pBlock + 0, highQuality);
+    EncodeAlphaBlock(pPixels + 1, pBlock + 8, highQuality);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ブロック圧縮関数です.
+//!
+//! @param[in]      pPixels         4x4ピクセル(RGBA8形式)です.
+//! @param[out]     pBlock          出力先です.
+//! @param[in]      highQuality     品質優先で圧縮する場合は true です.
+//-------------------------------------------------------------------------------------------------
+typedef void (*EncodeBlockFunc)(const uint8_t* pPixels, uint8_t* pBlock, bool highQuality);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ENCODER_INFO structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ENCODER_INFO
+{
+    uint32_t            BlockSize;      //!< 1ブロックあたりのバイト数です.
+    EncodeBlockFunc     Encode;         //!< ブロック圧縮関数です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      フォーマットに対応するエンコーダ情報を取得します.
+//-------------------------------------------------------------------------------------------------
+bool GetEncoderInfo(uint32_t format, ENCODER_INFO& info)
+{
+    switch(format)
+    {
+    case DXGI_FORMAT_BC1_TYPELESS:
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:    { info = { 8,  EncodeBC1 }; } break;
+    case DXGI_FORMAT_BC3_TYPELESS:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:    { info = { 16, EncodeBC3 }; } break;
+    case DXGI_FORMAT_BC4_TYPELESS:
+    case DXGI_FORMAT_BC4_UNORM:         { info = { 8,  EncodeBC4 }; } break;
+    case DXGI_FORMAT_BC5_TYPELESS:
+    case DXGI_FORMAT_BC5_UNORM:         { info = { 16, EncodeBC5 }; } break;
+    case DXGI_FORMAT_BC7_TYPELESS:
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:    { info = { 16, EncodeBC7 }; } break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1ブロック行を圧縮します.
+//-------------------------------------------------------------------------------------------------
+void EncodeBlockRow
+(
+    const ENCODER_INFO& info,
+    const uint8_t*      pSrc,
+    uint32_t            srcPitch,
+    uint32_t            width,
+    uint32_t            rows,
+    uint8_t*            pDst,
+    bool                highQuality
+)
+{
+    uint8_t pixels[16 * 4];
+
+    for(auto x=0u; x<width; x+=4, pDst+=info.BlockSize)
+    {
+        // 画像の外側は端のピクセルで埋める.
+        for(auto y=0u; y<4; ++y)
+        {
+            auto sy   = (y < rows) ? y : rows - 1;
+            auto pRow = pSrc + size_t(sy) * srcPitch;
+            for(auto i=0u; i<4; ++i)
+            {
+                auto sx = (x + i < width) ? x + i : width - 1;
+                memcpy(pixels + (y * 4 + i) * 4, pRow + size_t(sx) * 4, 4);
+            }
+        }
+
+        info.Encode(pixels, pDst, highQuality);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BLOCK_ROW structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BLOCK_ROW
+{
+    const uint8_t*  pSrc;       //!< 入力の先頭行です.
+    uint8_t*        pDst;       //!< 出力先のブロック行です.
+    uint32_t        SrcPitch;   //!< 入力の1行あたりのバイト数です.
+    uint32_t        Width;      //!< 横幅です.
+    uint32_t        Rows;       //!< 入力の行数です(1～4).
+};
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//      ブロック圧縮できるフォーマットかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsEncodableFormat(uint32_t format)
+{
+    ENCODER_INFO info;
+    return GetEncoderInfo(format, info);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      RGBA8形式のピクセルデータをブロック圧縮します.
+//-------------------------------------------------------------------------------------------------
+bool EncodeBlocks
+(
+    uint32_t            format,
+    const uint8_t*      pSrc,
+    uint32_t            srcPitch,
+    uint32_t            width,
+    uint32_t            height,
+    uint8_t*            pDst,
+    uint32_t            dstPitch,
+    BC_ENCODE_QUALITY   quality
+)
+{
+    ENCODER_INFO info;
+    if (!GetEncoderInfo(format, info))
+    { return false; }
+
+    if (pSrc == nullptr || pDst == nullptr)
+    { return false; }
+
+    auto highQuality = (quality == BC_ENCODE_QUALITY_HIGH);
+    for(auto y=0u; y<height; y+=4)
+    {
+        auto rows = (height - y < 4) ? height - y : 4;
+        EncodeBlockRow(info, pSrc, srcPitch, width, rows, pDst, highQuality);
+        pSrc += size_t(srcPitch) * 4;
+        pDst += dstPitch;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      RGBA8形式のリソーステクスチャをブロック圧縮します.
+//-------------------------------------------------------------------------------------------------
+bool EncodeResTexture
+(
+    const ResTexture&   src,
+    uint32_t            format,
+    ResTexture&         dst,
+    BC_ENCODE_QUALITY   quality
+)
+{
+    ENCODER_INFO info;
+    if (!GetEncoderInfo(format, info))
+    {
+        ELOG("Error : Unsupported Format. format = %u", format);
+        return false;
+    }
+
+    if (src.Format != DXGI_FORMAT_R8G8B8A8_TYPELESS
+     && src.Format != DXGI_FORMAT_R8G8B8A8_UNORM
+     && src.Format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+    {
+        ELOG("Error : Source Format must be R8G8B8A8. format = %u", src.Format);
+        return false;
+    }
+
+    if (src.pResources == nullptr || &src == &dst)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto isVolume = (src.Option & SUBRESOURCE_OPTION_VOLUME) != 0;
+    auto count    = src.MipMapCount * src.SurfaceCount;
+
+    // ブロック行数を求める.
+    uint32_t rowCount = 0;
+    for(auto i=0u; i<count; ++i)
+    {
+        const auto& res = src.pResources[i];
+        if (res.pPixels == nullptr || res.Width == 0 || res.Height == 0)
+        {
+            ELOG("Error : Invalid SubResource. index = %u", i);
+            return false;
+        }
+
+        auto mip   = i % src.MipMapCount;
+        auto depth = (isVolume && mip < 32) ? (src.Depth >> mip) : 1;
+        if (depth == 0)
+        { depth = 1; }
+
+        rowCount += ((res.Height + 3) / 4) * depth;
+    }
+
+    ResTexture result;
+    result.Width        = src.Width;
+    result.Height       = src.Height;
+    result.Depth        = src.Depth;
+    result.Format       = format;
+    result.MipMapCount  = src.MipMapCount;
+    result.SurfaceCount = src.SurfaceCount;
+    result.Option       = src.Option;
+
+    // サブリソースとピクセルデータをまとめて確保する.
+    if (!AllocateResTexture(result))
+    { return false; }
+
+    std::vector<BLOCK_ROW> blockRows;
+    blockRows.reserve(rowCount);
+
+    for(auto i=0u; i<count; ++i)
+    {
+        const auto& res = src.pResources[i];
+
+        auto mip   = i % src.MipMapCount;
+        auto depth = (isVolume && mip < 32) ? (src.Depth >> mip) : 1;
+        if (depth == 0)
+        { depth = 1; }
+
+        const auto& dstRes = result.pResources[i];
+        if (dstRes.Width != res.Width || dstRes.Height != res.Height)
+        {
+            ELOG("Error : Invalid SubResource Size. index = %u", i);
+            result.Release();
+            return false;
+        }
+
+        for(auto z=0u; z<depth; ++z)
+        {
+            auto pSrc = res.pPixels + size_t(res.SlicePitch) * z;
+            auto pDst = dstRes.pPixels + size_t(dstRes.SlicePitch) * z;
+
+            for(auto y=0u; y<res.Height; y+=4)
+            {
+                BLOCK_ROW row;
+                row.pSrc     = pSrc + size_t(res.Pitch) * y;
+                row.pDst     = pDst + size_t(dstRes.Pitch) * (y / 4);
+                row.SrcPitch = res.Pitch;
+                row.Width    = res.Width;
+                row.Rows     = (res.Height - y < 4) ? res.Height - y : 4;
+                blockRows.push_back(row);
+            }
+        }
+    }
+
+    // 圧縮はデコードより重いので，少ないブロック行からスレッドに分割する.
+    const auto pRows       = blockRows.data();
+    const auto highQuality = (quality == BC_ENCODE_QUALITY_HIGH);
+    ParallelFor(uint32_t(blockRows.size()), 4, [=](uint32_t begin, uint32_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            const auto& row = pRows[i];
+            EncodeBlockRow(info, row.pSrc, row.SrcPitch, row.Width, row.Rows, row.pDst, highQuality);
+        }
+    });
+
+    dst = result;
+    return true;
+}
+
+} // namespace asdx
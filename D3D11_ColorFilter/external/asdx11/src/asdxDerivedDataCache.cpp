@@ -0,0 +1,687 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxDerivedDataCache.cpp
+// Desc : Derived Data Cache Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxDerivedDataCache.h>
+#include <asdxResTexture.h>
+#include <asdxMisc.h>
+#include <asdxLogger.h>
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+#include <Windows.h>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kEntryVersion           = 1;                    // バイナリエントリーのバージョンです.
+static const uint32_t   kTextureCacheVersion    = 2;                    // テクスチャキャッシュのバージョンです.
+static const uint64_t   kStaleTempTime          = 60ull * 60 * 10000000; // 残留した一時ファイルを削除するまでの時間(100ns単位)です.
+static const uint64_t   kPrime0                 = 0x9E3779B185EBCA87ull;
+static const uint64_t   kPrime1                 = 0xC2B2AE3D27D4EB4Full;
+static const uint64_t   kPrime2                 = 0x165667B19E3779F9ull;
+static const uint64_t   kPrime3                 = 0x85EBCA77C2B2AE63ull;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ENTRY_HEADER structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ENTRY_HEADER
+{
+    uint8_t     Magic[4];   //!< 'ADDC' です.
+    uint32_t    Version;    //!< バージョンです.
+    uint64_t    KeyLo;      //!< キーの下位64bitです.
+    uint64_t    KeyHi;      //!< キーの上位64bitです.
+    uint64_t    Size;       //!< データサイズです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CACHE_FILE structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CACHE_FILE
+{
+    std::wstring    Path;       //!< ファイルパスです.
+    uint64_t        Size;       //!< ファイルサイズです.
+    uint64_t        Time;       //!< 最終使用時刻です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      64bit値を左回転します.
+//-------------------------------------------------------------------------------------------------
+inline uint64_t Rotl64(uint64_t value, int shift)
+{ return (value << shift) | (value >> (64 - shift)); }
+
+//-------------------------------------------------------------------------------------------------
+//      64bit値を攪拌します.
+//-------------------------------------------------------------------------------------------------
+inline uint64_t Avalanche(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      FILETIME を64bit値に変換します.
+//-------------------------------------------------------------------------------------------------
+inline uint64_t ToUInt64(const FILETIME& time)
+{ return (uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime; }
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルを全て読み込みます.
+//-------------------------------------------------------------------------------------------------
+bool ReadAll(const wchar_t* filename, std::vector<uint8_t>& result)
+{
+    // 他のプロセスが追い出しや置き換えを行えるように削除も共有する.
+    auto hFile = CreateFileW(
+        filename,
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    { return false; }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(hFile, &size))
+    {
+        CloseHandle(hFile);
+        return false;
+    }
+
+    result.resize(size_t(size.QuadPart));
+
+    size_t offset = 0;
+    while(offset < result.size())
+    {
+        auto  rest = result.size() - offset;
+        DWORD chunk = (rest > 0x40000000) ? 0x40000000 : DWORD(rest);
+        DWORD read  = 0;
+        if (!ReadFile(hFile, result.data() + offset, chunk, &read, nullptr) || read == 0)
+        {
+            CloseHandle(hFile);
+            return false;
+        }
+        offset += read;
+    }
+
+    CloseHandle(hFile);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルに書き込みます.
+//-------------------------------------------------------------------------------------------------
+bool WriteAll(const wchar_t* filename, const void* pHeader, size_t headerSize, const void* pData, size_t size)
+{
+    auto hFile = CreateFileW(
+        filename,
+        GENERIC_WRITE,
+        0,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    { return false; }
+
+    const void*  pBuffers[2] = { pHeader, pData };
+    const size_t sizes   [2] = { headerSize, size };
+
+    for(auto i=0; i<2; ++i)
+    {
+        auto   pSrc   = static_cast<const uint8_t*>(pBuffers[i]);
+        size_t offset = 0;
+        while(offset < sizes[i])
+        {
+            auto  rest    = sizes[i] - offset;
+            DWORD chunk   = (rest > 0x40000000) ? 0x40000000 : DWORD(rest);
+            DWORD written = 0;
+            if (!WriteFile(hFile, pSrc + offset, chunk, &written, nullptr) || written == 0)
+            {
+                CloseHandle(hFile);
+                DeleteFileW(filename);
+                return false;
+            }
+            offset += written;
+        }
+    }
+
+    CloseHandle(hFile);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最終使用時刻を更新します.
+//-------------------------------------------------------------------------------------------------
+void Touch(const wchar_t* filename)
+{
+    // LRUの順序付けに最終書き込み時刻を使用する. 内容は変更しない.
+    auto hFile = CreateFileW(
+        filename,
+        FILE_WRITE_ATTRIBUTES,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    { return; }
+
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    SetFileTime(hFile, nullptr, nullptr, &now);
+    CloseHandle(hFile);
+}
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DerivedDataKeyBuilder class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+DerivedDataKeyBuilder::DerivedDataKeyBuilder(const char* kind, uint32_t version)
+: m_Tail        (0)
+, m_TailSize    (0)
+, m_TotalSize   (0)
+{
+    m_Lane[0] = kPrime0 ^ version;
+    m_Lane[1] = kPrime1 + version;
+
+    if (kind != nullptr)
+    { Append(kind, strlen(kind) + 1); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      データを追加します.
+//-------------------------------------------------------------------------------------------------
+DerivedDataKeyBuilder& DerivedDataKeyBuilder::Append(const void* pData, size_t size)
+{
+    auto pSrc = static_cast<const uint8_t*>(pData);
+    m_TotalSize += size;
+
+    // 端数を先に埋める.
+    while(m_TailSize != 0 && size > 0)
+    {
+        m_Tail |= uint64_t(*pSrc) << (m_TailSize * 8);
+        m_TailSize++;
+        pSrc++;
+        size--;
+
+        if (m_TailSize == 8)
+        {
+            Mix(m_Tail);
+            m_Tail     = 0;
+            m_TailSize = 0;
+        }
+    }
+
+    while(size >= 8)
+    {
+        uint64_t value;
+        memcpy(&value, pSrc, sizeof(value));
+        Mix(value);
+        pSrc += 8;
+        size -= 8;
+    }
+
+    while(size > 0)
+    {
+        m_Tail |= uint64_t(*pSrc) << (m_TailSize * 8);
+        m_TailSize++;
+        pSrc++;
+        size--;
+    }
+
+    return *this;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キーを取得します.
+//-------------------------------------------------------------------------------------------------
+DerivedDataKey DerivedDataKeyBuilder::GetKey() const
+{
+    auto lane0 = m_Lane[0];
+    auto lane1 = m_Lane[1];
+
+    // 端数と総バイト数を混ぜて，区切り位置の違いでキーが衝突しないようにする.
+    lane0 = Rotl64(lane0 ^ (m_Tail * kPrime2), 31) * kPrime0;
+    lane1 = Rotl64(lane1 + (m_TotalSize * kPrime3), 29) * kPrime1;
+
+    DerivedDataKey key;
+    key.Lo = Avalanche(lane0 ^ Rotl64(lane1, 17));
+    key.Hi = Avalanche(lane1 + Rotl64(lane0, 41));
+    return key;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8byteを混ぜ込みます.
+//-------------------------------------------------------------------------------------------------
+void DerivedDataKeyBuilder::Mix(uint64_t value)
+{
+    m_Lane[0] = Rotl64(m_Lane[0] ^ (value * kPrime2), 31) * kPrime0;
+    m_Lane[1] = Rotl64(m_Lane[1] + (value * kPrime3), 27) * kPrime1 + m_Lane[0];
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DerivedDataCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+DerivedDataCache::DerivedDataCache()
+: m_Directory   ()
+, m_BudgetSize  (0)
+, m_WrittenSize (0)
+, m_HitCount    (0)
+, m_MissCount   (0)
+, m_WriteCount  (0)
+, m_EvictCount  (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+DerivedDataCache::~DerivedDataCache()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool DerivedDataCache::Init(const Desc& desc)
+{
+    if (desc.DirectoryPath == nullptr || desc.DirectoryPath[0] == L'\0')
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    m_Directory = desc.DirectoryPath;
+    if (m_Directory.back() != L'\\' && m_Directory.back() != L'/')
+    { m_Directory += L'\\'; }
+
+    if (!IsExistFolderPathW(m_Directory.c_str()))
+    {
+        if (!CreateDirectoryW(m_Directory.c_str(), nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)
+        {
+            ELOGW("Error : CreateDirectory() Failed. path = %s", m_Directory.c_str());
+            m_Directory.clear();
+            return false;
+        }
+    }
+
+    m_BudgetSize  = desc.BudgetSize;
+    m_WrittenSize = 0;
+
+    Trim();
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void DerivedDataCache::Term()
+{
+    m_Directory.clear();
+    m_BudgetSize = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バイナリデータを取得します.
+//-------------------------------------------------------------------------------------------------
+bool DerivedDataCache::Get(const DerivedDataKey& key, std::vector<uint8_t>& result)
+{
+    if (m_Directory.empty())
+    { return false; }
+
+    auto path = GetEntryPath(key, L".bin", false);
+
+    std::vector<uint8_t> buffer;
+    if (!ReadAll(path.c_str(), buffer) || buffer.size() < sizeof(ENTRY_HEADER))
+    {
+        m_MissCount++;
+        return false;
+    }
+
+    ENTRY_HEADER header;
+    memcpy(&header, buffer.data(), sizeof(header));
+
+    if (memcmp(header.Magic, "ADDC", 4) != 0
+     || header.Version != kEntryVersion
+     || header.KeyLo   != key.Lo
+     || header.KeyHi   != key.Hi
+     || header.Size    != buffer.size() - sizeof(header))
+    {
+        WLOGW("Warning : Broken cache entry. path = %s", path.c_str());
+        m_MissCount++;
+        return false;
+    }
+
+    buffer.erase(buffer.begin(), buffer.begin() + sizeof(header));
+    result.swap(buffer);
+
+    Touch(path.c_str());
+    m_HitCount++;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バイナリデータを格納します.
+//-------------------------------------------------------------------------------------------------
+bool DerivedDataCache::Put(const DerivedDataKey& key, const void* pData, size_t size)
+{
+    if (m_Directory.empty() || (pData == nullptr && size > 0))
+    { return false; }
+
+    ENTRY_HEADER header;
+    memcpy(header.Magic, "ADDC", 4);
+    header.Version = kEntryVersion;
+    header.KeyLo   = key.Lo;
+    header.KeyHi   = key.Hi;
+    header.Size    = size;
+
+    auto path = GetEntryPath(key, L".bin", true);
+    auto temp = GetTempFilePath(path);
+
+    if (!WriteAll(temp.c_str(), &header, sizeof(header), pData, size))
+    {
+        ELOGW("Error : File Write Failed. path = %s", temp.c_str());
+        return false;
+    }
+
+    return Commit(temp, path, sizeof(header) + size);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャを取得します.
+//-------------------------------------------------------------------------------------------------
+bool DerivedDataCache::GetTexture(const DerivedDataKey& key, ResTexture& result)
+{
+    if (m_Directory.empty())
+    { return false; }
+
+    auto path = GetEntryPath(key, L".atex", false);
+
+    // マップすると他のプロセスが追い出しや置き換えを行えないので，削除を共有して読み込んでから展開する.
+    std::vector<uint8_t> buffer;
+    if (!ReadAll(path.c_str(), buffer) || buffer.empty() || buffer.size() > UINT32_MAX
+     || !result.LoadFromMemory(buffer.data(), uint32_t(buffer.size())))
+    {
+        m_MissCount++;
+        return false;
+    }
+
+    Touch(path.c_str());
+    m_HitCount++;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャを格納します.
+//-------------------------------------------------------------------------------------------------
+bool DerivedDataCache::PutTexture(const DerivedDataKey& key, const ResTexture& texture)
+{
+    if (m_Directory.empty())
+    { return false; }
+
+    auto path = GetEntryPath(key, L".atex", true);
+    auto temp = GetTempFilePath(path);
+
+    if (!texture.SaveToCookedW(temp.c_str()))
+    {
+        DeleteFileW(temp.c_str());
+        return false;
+    }
+
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    uint64_t size = 0;
+    if (GetFileAttributesExW(temp.c_str(), GetFileExInfoStandard, &attr))
+    { size = (uint64_t(attr.nFileSizeHigh) << 32) | attr.nFileSizeLow; }
+
+    return Commit(temp, path, size);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キャッシュを経由してテクスチャファイルを読み込みます.
+//-------------------------------------------------------------------------------------------------
+bool DerivedDataCache::LoadTextureA(const char* filename, ResTexture& result, const TextureLoadOptions* pOptions)
+{
+    if (filename == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto path = ToStringW(filename);
+    return LoadTextureW(path.c_str(), result, pOptions);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キャッシュを経由してテクスチャファイルを読み込みます.
+//-------------------------------------------------------------------------------------------------
+bool DerivedDataCache::LoadTextureW(const wchar_t* filename, ResTexture& result, const TextureLoadOptions* pOptions)
+{
+    if (filename == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    // キャッシュが無効な場合は直接読み込む.
+    if (m_Directory.empty())
+    { return result.LoadFromFileW(filename, pOptions); }
+
+    std::vector<uint8_t> source;
+    if (!ReadAll(filename, source) || source.empty() || source.size() > UINT32_MAX)
+    {
+        ELOGW("Error : File Read Failed. filename = %s", filename);
+        return false;
+    }
+
+    // 読み込み設定でデコード結果が変わるので，設定の各項目もキーに含める.
+    TextureLoadOptions options;
+    if (pOptions != nullptr)
+    { options = *pOptions; }
+
+    auto key = DerivedDataKeyBuilder("ResTexture", kTextureCacheVersion)
+        .AppendValue(options.HdrFormat)
+        .Append(source.data(), source.size())
+        .GetKey();
+
+    if (GetTexture(key, result))
+    { return true; }
+
+    if (!result.LoadFromMemory(source.data(), uint32_t(source.size()), &options))
+    {
+        ELOGW("Error : Texture Load Failed. filename = %s", filename);
+        return false;
+    }
+
+    // 格納に失敗しても読み込み自体は成功している.
+    PutTexture(key, result);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      上限サイズを超えている場合に古いエントリーから削除します.
+//-------------------------------------------------------------------------------------------------
+void DerivedDataCache::Trim()
+{
+    if (m_Directory.empty())
+    { return; }
+
+    std::lock_guard<std::mutex> locker(m_TrimMutex);
+    m_WrittenSize = 0;
+
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+
+    std::vector<CACHE_FILE> files;
+    uint64_t totalSize = 0;
+
+    WIN32_FIND_DATAW dirData;
+    auto hDir = FindFirstFileW((m_Directory + L"*").c_str(), &dirData);
+    if (hDir == INVALID_HANDLE_VALUE)
+    { return; }
+
+    do
+    {
+        if ((dirData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0
+          || dirData.cFileName[0] == L'.')
+        { continue; }
+
+        auto subDir = m_Directory + dirData.cFileName + L"\\";
+
+        WIN32_FIND_DATAW fileData;
+        auto hFile = FindFirstFileW((subDir + L"*").c_str(), &fileData);
+        if (hFile == INVALID_HANDLE_VALUE)
+        { continue; }
+
+        do
+        {
+            if (fileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            { continue; }
+
+            CACHE_FILE file;
+            file.Path = subDir + fileData.cFileName;
+            file.Size = (uint64_t(fileData.nFileSizeHigh) << 32) | fileData.nFileSizeLow;
+            file.Time = ToUInt64(fileData.ftLastWriteTime);
+
+            // 異常終了したプロセスの一時ファイルを削除する.
+            auto length = wcslen(fileData.cFileName);
+            if (length > 4 && _wcsicmp(fileData.cFileName + length - 4, L".tmp") == 0)
+            {
+                if (ToUInt64(now) > file.Time + kStaleTempTime)
+                { DeleteFileW(file.Path.c_str()); }
+                continue;
+            }
+
+            totalSize += file.Size;
+            files.push_back(file);
+        }
+        while(FindNextFileW(hFile, &fileData));
+
+        FindClose(hFile);
+    }
+    while(FindNextFileW(hDir, &dirData));
+
+    FindClose(hDir);
+
+    if (m_BudgetSize == 0 || totalSize <= m_BudgetSize)
+    { return; }
+
+    std::sort(files.begin(), files.end(), [](const CACHE_FILE& lhs, const CACHE_FILE& rhs)
+    { return lhs.Time < rhs.Time; });
+
+    // すぐに再度あふれないように上限の9割まで削除する.
+    auto target = m_BudgetSize - m_BudgetSize / 10;
+    for(auto& file : files)
+    {
+        if (totalSize <= target)
+        { break; }
+
+        // 他のプロセスが使用中の場合は失敗するので飛ばす.
+        if (DeleteFileW(file.Path.c_str()))
+        {
+            totalSize -= file.Size;
+            m_EvictCount++;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+DerivedDataCache::Stats DerivedDataCache::GetStats() const
+{
+    Stats stats;
+    stats.HitCount   = m_HitCount;
+    stats.MissCount  = m_MissCount;
+    stats.WriteCount = m_WriteCount;
+    stats.EvictCount = m_EvictCount;
+    return stats;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      エントリーのファイルパスを取得します.
+//-------------------------------------------------------------------------------------------------
+std::wstring DerivedDataCache::GetEntryPath(const DerivedDataKey& key, const wchar_t* ext, bool createDirectory) const
+{
+    // 1ディレクトリのファイル数を抑えるため，キーの先頭1byteでディレクトリを分ける.
+    wchar_t subDir[4];
+    swprintf_s(subDir, L"%02x", uint32_t(key.Hi >> 56));
+
+    wchar_t name[40];
+    swprintf_s(name, L"%016llx%016llx", key.Hi, key.Lo);
+
+    auto dir = m_Directory + subDir + L"\\";
+    if (createDirectory)
+    { CreateDirectoryW(dir.c_str(), nullptr); }
+
+    return dir + name + ext;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      一時ファイルのパスを取得します.
+//-------------------------------------------------------------------------------------------------
+std::wstring DerivedDataCache::GetTempFilePath(const std::wstring& entryPath) const
+{
+    static std::atomic<uint32_t> s_Counter(0);
+
+    // プロセス, スレッド間で重複しない名前にする.
+    wchar_t suffix[64];
+    swprintf_s(suffix, L".%lu.%lu.%u.tmp",
+        GetCurrentProcessId(),
+        GetCurrentThreadId(),
+        s_Counter.fetch_add(1));
+
+    return entryPath + suffix;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      一時ファイルをエントリーとして確定します.
+//-------------------------------------------------------------------------------------------------
+bool DerivedDataCache::Commit(const std::wstring& tempPath, const std::wstring& entryPath, uint64_t size)
+{
+    // 同一ボリューム内の名前変更は不可分なので，読み込み側は完全なファイルか何もないかのどちらかを見る.
+    if (!MoveFileExW(tempPath.c_str(), entryPath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        DeleteFileW(tempPath.c_str());
+
+        // 内容はキーで決まるので，他のプロセスが先に格納していれば成功とみなす.
+        return IsExistFilePathW(entryPath.c_str());
+    }
+
+    m_WriteCount++;
+
+    if (m_BudgetSize > 0)
+    {
+        auto written = m_WrittenSize.fetch_add(size) + size;
+        if (written > m_BudgetSize / 16)
+        { Trim(); }
+    }
+
+    return true;
+}
+
+} // namespace asdx
@@ -0,0 +1,724 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxImageSink.cpp
+// Desc : Image Stream Sink Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxImageSink.h>
+#include <asdxBCDecoder.h>
+#include <asdxMipMap.h>
+#include <asdxParallelFor.h>
+#include <asdxLogger.h>
+#include <dxgiformat.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kEncodeRows     = 64;       // まとめて圧縮する行数です(4の倍数).
+
+//-------------------------------------------------------------------------------------------------
+//      圧縮フォーマットの1ブロックあたりのバイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GetBlockSize(uint32_t format)
+{
+    switch(format)
+    {
+    case DXGI_FORMAT_BC1_TYPELESS:
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC4_TYPELESS:
+    case DXGI_FORMAT_BC4_UNORM:
+    case DXGI_FORMAT_BC4_SNORM:
+        return 8;
+
+    default:
+        return 16;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      sRGBフォーマットかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsSRGB(uint32_t format)
+{
+    return (format == DXGI_FORMAT_BC1_UNORM_SRGB)
+        || (format == DXGI_FORMAT_BC2_UNORM_SRGB)
+        || (format == DXGI_FORMAT_BC3_UNORM_SRGB)
+        || (format == DXGI_FORMAT_BC7_UNORM_SRGB);
+}
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageConvertSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ImageConvertSink::ImageConvertSink()
+: m_Format      (0)
+, m_pNext       (nullptr)
+, m_Info        ()
+, m_SrcFormat   (PIXEL_FORMAT_UNKNOWN)
+, m_DstFormat   (PIXEL_FORMAT_UNKNOWN)
+, m_Decode      (false)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+ImageConvertSink::~ImageConvertSink()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool ImageConvertSink::Init(uint32_t format, IImageSink* pNext)
+{
+    if (pNext == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto dstFormat = GetPixelFormatFromDXGI(format);
+    if (dstFormat == PIXEL_FORMAT_UNKNOWN)
+    {
+        ELOG("Error : Unsupported Format. format = %u", format);
+        return false;
+    }
+
+    m_Format    = format;
+    m_pNext     = pNext;
+    m_DstFormat = dstFormat;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void ImageConvertSink::Term()
+{
+    m_Decoded.clear();
+    m_Decoded.shrink_to_fit();
+    m_Pixels.clear();
+    m_Pixels.shrink_to_fit();
+
+    m_pNext     = nullptr;
+    m_DstFormat = PIXEL_FORMAT_UNKNOWN;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      画像の受け取りを開始します.
+//-------------------------------------------------------------------------------------------------
+bool ImageConvertSink::OnBegin(const ImageStreamInfo& info)
+{
+    if (m_pNext == nullptr)
+    {
+        ELOG("Error : Not Initialized.");
+        return false;
+    }
+
+    m_Info      = info;
+    m_Decode    = IsBlockCompressedFormat(info.Format);
+    m_SrcFormat = GetPixelFormatFromDXGI((m_Decode) ? GetDecodedFormat(info.Format) : info.Format);
+    if (m_SrcFormat == PIXEL_FORMAT_UNKNOWN)
+    {
+        ELOG("Error : Unsupported Format. format = %u", info.Format);
+        return false;
+    }
+
+    ImageStreamInfo next = { info.Width, info.Height, m_Format };
+    return m_pNext->OnBegin(next);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      帯を変換して次のシンクに渡します.
+//-------------------------------------------------------------------------------------------------
+bool ImageConvertSink::OnBand(uint32_t y, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch)
+{
+    auto pSrc     = pPixels;
+    auto srcPitch = pitch;
+
+    if (m_Decode)
+    {
+        srcPitch = m_Info.Width * GetPixelFormatSize(m_SrcFormat);
+        m_Decoded.resize(size_t(srcPitch) * rowCount);
+
+        if (!DecodeBlocks(m_Info.Format, pPixels, pitch, m_Info.Width, rowCount, m_Decoded.data(), srcPitch))
+        { return false; }
+
+        pSrc = m_Decoded.data();
+    }
+
+    if (m_SrcFormat == m_DstFormat)
+    { return m_pNext->OnBand(y, rowCount, pSrc, srcPitch); }
+
+    auto dstPitch = m_Info.Width * GetPixelFormatSize(m_DstFormat);
+    m_Pixels.resize(size_t(dstPitch) * rowCount);
+
+    if (!ConvertPixels(pSrc, m_SrcFormat, m_Pixels.data(), m_DstFormat, m_Info.Width, rowCount, srcPitch, dstPitch))
+    { return false; }
+
+    return m_pNext->OnBand(y, rowCount, m_Pixels.data(), dstPitch);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      画像の受け取りを終了します.
+//-------------------------------------------------------------------------------------------------
+bool ImageConvertSink::OnEnd()
+{ return m_pNext->OnEnd(); }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageMipChainSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ImageMipChainSink::ImageMipChainSink()
+: m_Format      (PIXEL_FORMAT_UNKNOWN)
+, m_DxgiFormat  (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+ImageMipChainSink::~ImageMipChainSink()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool ImageMipChainSink::Init(IImageSink* const* ppSinks, uint32_t count)
+{
+    if (ppSinks == nullptr || count == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    m_Sinks.assign(ppSinks, ppSinks + count);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void ImageMipChainSink::Term()
+{
+    m_Sinks .clear();
+    m_Levels.clear();
+    m_Row   .clear();
+    m_Row   .shrink_to_fit();
+
+    m_Format     = PIXEL_FORMAT_UNKNOWN;
+    m_DxgiFormat = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      画像の受け取りを開始します.
+//-------------------------------------------------------------------------------------------------
+bool ImageMipChainSink::OnBegin(const ImageStreamInfo& info)
+{
+    if (m_Sinks.empty())
+    {
+        ELOG("Error : Not Initialized.");
+        return false;
+    }
+
+    // 縮小は浮動小数で行うので，ConvertPixels() で扱えるフォーマットに限る.
+    m_Format     = GetPixelFormatFromDXGI(info.Format);
+    m_DxgiFormat = info.Format;
+    if (m_Format == PIXEL_FORMAT_UNKNOWN)
+    {
+        ELOG("Error : Unsupported Format. format = %u", info.Format);
+        return false;
+    }
+
+    auto count = CalcMipMapCount(info.Width, info.Height);
+    if (count > uint32_t(m_Sinks.size()))
+    { count = uint32_t(m_Sinks.size()); }
+
+    auto pixelSize = GetPixelFormatSize(m_Format);
+
+    m_Levels.clear();
+    m_Levels.resize(count);
+
+    auto w = info.Width;
+    auto h = info.Height;
+    for(auto i=0u; i<count; ++i)
+    {
+        auto& level = m_Levels[i];
+        level.pSink  = m_Sinks[i];
+        level.Width  = w;
+        level.Height = h;
+        level.Row    = 0;
+        level.Count  = 0;
+
+        // 最上位ミップレベルは入力をそのまま渡すので，縮小用のバッファは要らない.
+        if (i > 0)
+        {
+            level.Sum   .assign(size_t(w) * 4, 0.0f);
+            level.Pixels.resize(size_t(w) * pixelSize);
+        }
+
+        w = (w > 1) ? w >> 1 : 1;
+        h = (h > 1) ? h >> 1 : 1;
+    }
+
+    m_Row.resize(size_t(info.Width) * 4);
+
+    for(auto& level : m_Levels)
+    {
+        if (level.pSink == nullptr)
+        { continue; }
+
+        ImageStreamInfo levelInfo = { level.Width, level.Height, info.Format };
+        if (!level.pSink->OnBegin(levelInfo))
+        { return false; }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      帯を縮小して各ミップレベルのシンクに渡します.
+//-------------------------------------------------------------------------------------------------
+bool ImageMipChainSink::OnBand(uint32_t y, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch)
+{
+    auto& top = m_Levels[0];
+    if (top.pSink != nullptr && !top.pSink->OnBand(y, rowCount, pPixels, pitch))
+    { return false; }
+
+    top.Row += rowCount;
+
+    if (m_Levels.size() < 2)
+    { return true; }
+
+    for(auto i=0u; i<rowCount; ++i)
+    {
+        if (!ConvertPixels(pPixels + size_t(i) * pitch, m_Format, m_Row.data(), PIXEL_FORMAT_R32G32B32A32_FLOAT, top.Width, 1))
+        { return false; }
+
+        if (!PushRow(1, m_Row.data()))
+        { return false; }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      画像の受け取りを終了します.
+//-------------------------------------------------------------------------------------------------
+bool ImageMipChainSink::OnEnd()
+{
+    for(auto& level : m_Levels)
+    {
+        if (level.Row != level.Height)
+        {
+            ELOG("Error : Incomplete Image. row = %u, height = %u", level.Row, level.Height);
+            return false;
+        }
+    }
+
+    for(auto& level : m_Levels)
+    {
+        if (level.pSink != nullptr && !level.pSink->OnEnd())
+        { return false; }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      生成するミップレベル数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t ImageMipChainSink::GetMipCount() const
+{ return uint32_t(m_Levels.size()); }
+
+//-------------------------------------------------------------------------------------------------
+//      上位レベルの1行を加算し，行が揃ったら出力して下位レベルに渡します.
+//-------------------------------------------------------------------------------------------------
+bool ImageMipChainSink::PushRow(uint32_t index, const float* pRow)
+{
+    const auto& parent = m_Levels[index - 1];
+    auto&       level  = m_Levels[index];
+    auto        pSum   = level.Sum.data();
+
+    // 出力の各ピクセルは上位レベルの2ピクセルの平均とし，奇数サイズの端の1ピクセルは最後の出力に含める.
+    // 2のべき乗サイズでは GenerateMipMaps() のボックスフィルタと同じく2x2の平均になる.
+    for(auto x=0u; x<level.Width; ++x)
+    {
+        auto begin = x * 2;
+        auto end   = (x + 1 == level.Width) ? parent.Width : begin + 2;
+        for(auto sx=begin; sx<end; ++sx)
+        {
+            pSum[x * 4 + 0] += pRow[sx * 4 + 0];
+            pSum[x * 4 + 1] += pRow[sx * 4 + 1];
+            pSum[x * 4 + 2] += pRow[sx * 4 + 2];
+            pSum[x * 4 + 3] += pRow[sx * 4 + 3];
+        }
+    }
+
+    level.Count++;
+
+    auto rowBegin = level.Row * 2;
+    auto rowEnd   = (level.Row + 1 == level.Height) ? parent.Height : rowBegin + 2;
+    if (level.Count < rowEnd - rowBegin)
+    { return true; }
+
+    // 加算したピクセル数で割って平均にする.
+    for(auto x=0u; x<level.Width; ++x)
+    {
+        auto begin = x * 2;
+        auto end   = (x + 1 == level.Width) ? parent.Width : begin + 2;
+        auto scale = 1.0f / float((end - begin) * level.Count);
+
+        pSum[x * 4 + 0] *= scale;
+        pSum[x * 4 + 1] *= scale;
+        pSum[x * 4 + 2] *= scale;
+        pSum[x * 4 + 3] *= scale;
+    }
+
+    if (level.pSink != nullptr)
+    {
+        if (!ConvertPixels(pSum, PIXEL_FORMAT_R32G32B32A32_FLOAT, level.Pixels.data(), m_Format, level.Width, 1))
+        { return false; }
+
+        if (!level.pSink->OnBand(level.Row, 1, level.Pixels.data(), uint32_t(level.Pixels.size())))
+        { return false; }
+    }
+
+    // 量子化せずに浮動小数のまま下位レベルに渡して，誤差が蓄積しないようにする.
+    if (index + 1 < uint32_t(m_Levels.size()) && !PushRow(index + 1, pSum))
+    { return false; }
+
+    std::fill(level.Sum.begin(), level.Sum.end(), 0.0f);
+    level.Count = 0;
+    level.Row++;
+
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageEncodeSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ImageEncodeSink::ImageEncodeSink()
+: m_Format      (0)
+, m_pNext       (nullptr)
+, m_Quality     (BC_ENCODE_QUALITY_FAST)
+, m_Info        ()
+, m_SrcFormat   (PIXEL_FORMAT_UNKNOWN)
+, m_StageFormat (PIXEL_FORMAT_UNKNOWN)
+, m_BlockPitch  (0)
+, m_Y           (0)
+, m_Count       (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+ImageEncodeSink::~ImageEncodeSink()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool ImageEncodeSink::Init(uint32_t format, IImageSink* pNext, BC_ENCODE_QUALITY quality)
+{
+    if (pNext == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    if (!IsEncodableFormat(format))
+    {
+        ELOG("Error : Unsupported Format. format = %u", format);
+        return false;
+    }
+
+    m_Format      = format;
+    m_pNext       = pNext;
+    m_Quality     = quality;
+    m_StageFormat = (IsSRGB(format)) ? PIXEL_FORMAT_R8G8B8A8_UNORM_SRGB : PIXEL_FORMAT_R8G8B8A8_UNORM;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void ImageEncodeSink::Term()
+{
+    m_Stage.clear();
+    m_Stage.shrink_to_fit();
+    m_Blocks.clear();
+    m_Blocks.shrink_to_fit();
+
+    m_pNext = nullptr;
+    m_Count = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      画像の受け取りを開始します.
+//-------------------------------------------------------------------------------------------------
+bool ImageEncodeSink::OnBegin(const ImageStreamInfo& info)
+{
+    if (m_pNext == nullptr)
+    {
+        ELOG("Error : Not Initialized.");
+        return false;
+    }
+
+    m_Info      = info;
+    m_SrcFormat = GetPixelFormatFromDXGI(info.Format);
+    if (m_SrcFormat == PIXEL_FORMAT_UNKNOWN)
+    {
+        ELOG("Error : Unsupported Format. format = %u", info.Format);
+        return false;
+    }
+
+    m_BlockPitch = (info.Width + 3) / 4 * GetBlockSize(m_Format);
+    m_Y          = 0;
+    m_Count      = 0;
+
+    m_Stage .resize(size_t(info.Width) * 4 * kEncodeRows);
+    m_Blocks.resize(size_t(m_BlockPitch) * (kEncodeRows / 4));
+
+    ImageStreamInfo next = { info.Width, info.Height, m_Format };
+    return m_pNext->OnBegin(next);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      帯をRGBA8形式で溜めて，一定の行数ごとに圧縮して次のシンクに渡します.
+//-------------------------------------------------------------------------------------------------
+bool ImageEncodeSink::OnBand(uint32_t, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch)
+{
+    auto stagePitch = m_Info.Width * 4;
+
+    for(auto i=0u; i<rowCount;)
+    {
+        auto rows = std::min(rowCount - i, kEncodeRows - m_Count);
+        auto pDst = m_Stage.data() + size_t(m_Count) * stagePitch;
+
+        if (!ConvertPixels(pPixels + size_t(i) * pitch, m_SrcFormat, pDst, m_StageFormat, m_Info.Width, rows, pitch, stagePitch))
+        { return false; }
+
+        m_Count += rows;
+        i       += rows;
+
+        if (m_Count == kEncodeRows && !Flush())
+        { return false; }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      残りの行を圧縮して，画像の受け取りを終了します.
+//-------------------------------------------------------------------------------------------------
+bool ImageEncodeSink::OnEnd()
+{
+    if (!Flush())
+    { return false; }
+
+    return m_pNext->OnEnd();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      溜めた行を圧縮して次のシンクに渡します.
+//-------------------------------------------------------------------------------------------------
+bool ImageEncodeSink::Flush()
+{
+    if (m_Count == 0)
+    { return true; }
+
+    const auto format     = m_Format;
+    const auto quality    = m_Quality;
+    const auto width      = m_Info.Width;
+    const auto count      = m_Count;
+    const auto stagePitch = width * 4;
+    const auto blockPitch = m_BlockPitch;
+    const auto pStage     = m_Stage.data();
+    const auto pBlocks    = m_Blocks.data();
+
+    // ブロック行単位で分割する. 最後のブロック行は端の行を複製して埋める.
+    ParallelFor((count + 3) / 4, 1, [=](uint32_t begin, uint32_t end)
+    {
+        auto rows = std::min(count - begin * 4, (end - begin) * 4);
+        EncodeBlocks(
+            format,
+            pStage + size_t(begin) * 4 * stagePitch,
+            stagePitch,
+            width,
+            rows,
+            pBlocks + size_t(begin) * blockPitch,
+            blockPitch,
+            quality);
+    });
+
+    auto result = m_pNext->OnBand(m_Y, count, pBlocks, blockPitch);
+
+    m_Y    += count;
+    m_Count = 0;
+
+    return result;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageCollectSink class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ImageCollectSink::ImageCollectSink()
+: m_Info            ()
+, m_pPixels         (nullptr)
+, m_Pitch           (0)
+, m_RowsPerBlock    (1)
+, m_NextY           (0)
+, m_Completed       (false)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+ImageCollectSink::~ImageCollectSink()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      受け取ったデータを破棄します.
+//-------------------------------------------------------------------------------------------------
+void ImageCollectSink::Term()
+{
+    SafeDeleteArray(m_pPixels);
+
+    m_Pitch     = 0;
+    m_NextY     = 0;
+    m_Completed = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      画像の受け取りを開始します.
+//-------------------------------------------------------------------------------------------------
+bool ImageCollectSink::OnBegin(const ImageStreamInfo& info)
+{
+    Term();
+
+    m_Info         = info;
+    m_RowsPerBlock = (IsBlockCompressedFormat(info.Format)) ? 4 : 1;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      帯をコピーします.
+//-------------------------------------------------------------------------------------------------
+bool ImageCollectSink::OnBand(uint32_t y, uint32_t rowCount, const uint8_t* pPixels, uint32_t pitch)
+{
+    if (y != m_NextY || rowCount > m_Info.Height - y)
+    {
+        ELOG("Error : Invalid Band. y = %u, rowCount = %u", y, rowCount);
+        return false;
+    }
+
+    if (m_pPixels == nullptr)
+    {
+        auto totalRows = (m_Info.Height + m_RowsPerBlock - 1) / m_RowsPerBlock;
+
+        m_Pitch   = pitch;
+        m_pPixels = new (std::nothrow) uint8_t [size_t(pitch) * totalRows];
+        if (m_pPixels == nullptr)
+        {
+            ELOG("Error : Out Of Memory.");
+            return false;
+        }
+    }
+    else if (pitch < m_Pitch)
+    {
+        ELOG("Error : Invalid Pitch. pitch = %u", pitch);
+        return false;
+    }
+
+    auto dataRows = (rowCount + m_RowsPerBlock - 1) / m_RowsPerBlock;
+    auto pDst     = m_pPixels + size_t(y / m_RowsPerBlock) * m_Pitch;
+    for(auto i=0u; i<dataRows; ++i)
+    { memcpy(pDst + size_t(i) * m_Pitch, pPixels + size_t(i) * pitch, m_Pitch); }
+
+    m_NextY += rowCount;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      画像の受け取りを終了します.
+//-------------------------------------------------------------------------------------------------
+bool ImageCollectSink::OnEnd()
+{
+    m_Completed = (m_pPixels != nullptr && m_NextY == m_Info.Height);
+    return m_Completed;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      受け取った画像の所有権をリソーステクスチャとして移します.
+//-------------------------------------------------------------------------------------------------
+bool ImageCollectSink::Detach(ResTexture& result)
+{
+    if (!m_Completed)
+    { return false; }
+
+    auto pResources = new (std::nothrow) SubResource[1];
+    if (pResources == nullptr)
+    {
+        ELOG("Error : Out Of Memory.");
+        return false;
+    }
+
+    auto totalRows = (m_Info.Height + m_RowsPerBlock - 1) / m_RowsPerBlock;
+
+    pResources[0].Width      = m_Info.Width;
+    pResources[0].Height     = m_Info.Height;
+    pResources[0].Pitch      = m_Pitch;
+    pResources[0].SlicePitch = m_Pitch * totalRows;
+    pResources[0].pPixels    = m_pPixels;
+
+    result.Width        = m_Info.Width;
+    result.Height       = m_Info.Height;
+    result.Depth        = 1;
+    result.Format       = m_Info.Format;
+    result.MipMapCount  = 1;
+    result.SurfaceCount = 1;
+    result.Option       = 0;
+    result.pResources   = pResources;
+    result.pBlock       = m_pPixels;
+    result.pMappedFile  = nullptr;
+    result.pAllocator   = nullptr;
+
+    // ピクセルデータの所有権はリソーステクスチャに移る.
+    m_pPixels   = nullptr;
+    m_Completed = false;
+
+    return true;
+}
+
+} // namespace asdx
@@ -0,0 +1,148 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxMappedFile.cpp
+// Desc : Memory Mapped File Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxMappedFile.h>
+#include <asdxLogger.h>
+#include <Windows.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MappedFile class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+MappedFile::MappedFile()
+: m_hFile   (INVALID_HANDLE_VALUE)
+, m_hMapping(nullptr)
+, m_pData   (nullptr)
+, m_Size    (0)
+, m_Writable(false)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{ Close(); }
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルをメモリにマップします.
+//-------------------------------------------------------------------------------------------------
+bool MappedFile::Open(const wchar_t* filename, bool copyOnWrite)
+{
+    Close();
+
+    if (filename == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    m_hFile = CreateFileW(
+        filename,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (m_hFile == INVALID_HANDLE_VALUE)
+    {
+        ELOGW("Error : File Open Failed. filename = %s", filename);
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_hFile, &size) || size.QuadPart == 0)
+    {
+        ELOGW("Error : Invalid File Size. filename = %s", filename);
+        Close();
+        return false;
+    }
+
+    // 空ファイルはマップできないので，上でサイズ0を弾いておく.
+    auto protect = (copyOnWrite) ? PAGE_WRITECOPY : PAGE_READONLY;
+    m_hMapping = CreateFileMappingW(m_hFile, nullptr, protect, 0, 0, nullptr);
+    if (m_hMapping == nullptr)
+    {
+        ELOGW("Error : CreateFileMapping() Failed. filename = %s", filename);
+        Close();
+        return false;
+    }
+
+    auto access = (copyOnWrite) ? FILE_MAP_COPY : FILE_MAP_READ;
+    m_pData = static_cast<uint8_t*>(MapViewOfFile(m_hMapping, access, 0, 0, 0));
+    if (m_pData == nullptr)
+    {
+        ELOGW("Error : MapViewOfFile() Failed. filename = %s", filename);
+        Close();
+        return false;
+    }
+
+    m_Size     = size_t(size.QuadPart);
+    m_Writable = copyOnWrite;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      マップを解除し，ファイルを閉じます.
+//-------------------------------------------------------------------------------------------------
+void MappedFile::Close()
+{
+    if (m_pData != nullptr)
+    {
+        UnmapViewOfFile(m_pData);
+        m_pData = nullptr;
+    }
+
+    if (m_hMapping != nullptr)
+    {
+        CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+
+    m_Size     = 0;
+    m_Writable = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      マップされているかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool MappedFile::IsOpen() const
+{ return m_pData != nullptr; }
+
+//-------------------------------------------------------------------------------------------------
+//      ファイル先頭へのポインタを取得します.
+//-------------------------------------------------------------------------------------------------
+const uint8_t* MappedFile::GetData() const
+{ return m_pData; }
+
+//-------------------------------------------------------------------------------------------------
+//      書き込み可能なファイル先頭へのポインタを取得します.
+//-------------------------------------------------------------------------------------------------
+uint8_t* MappedFile::GetWritableData() const
+{ return (m_Writable) ? m_pData : nullptr; }
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルサイズを取得します.
+//-------------------------------------------------------------------------------------------------
+size_t MappedFile::GetSize() const
+{ return m_Size; }
+
+} // namespace asdx
@@ -0,0 +1,270 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxMath.cpp
+// Desc : Math Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxMath.h>
+#include <asdxPixelKernel.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define ASDX_KERNEL_X86     (1)
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#else
+    #define ASDX_KERNEL_X86     (0)
+#endif
+
+// MSVCは命令セットの指定なしでイントリンジックを使用できるが，GCC/Clangは関数単位で指定が必要.
+#if defined(__GNUC__) || defined(__clang__)
+    #define ASDX_TARGET_SSE2    __attribute__((target("sse2")))
+    #define ASDX_TARGET_F16C    __attribute__((target("avx,f16c")))
+#else
+    #define ASDX_TARGET_SSE2
+    #define ASDX_TARGET_F16C
+#endif
+
+
+namespace /* anonymous */ {
+
+#if ASDX_KERNEL_X86
+//-------------------------------------------------------------------------------------------------
+//      CPUIDからF16C命令に対応しているかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool DetectF16C()
+{
+    int info[4] = {};
+    #if defined(_MSC_VER)
+        __cpuid(info, 1);
+    #else
+        __cpuid(1, info[0], info[1], info[2], info[3]);
+    #endif
+
+    return (info[2] & (1 << 29)) != 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Global Variables.
+//-------------------------------------------------------------------------------------------------
+static const bool g_F16C = DetectF16C();
+
+//-------------------------------------------------------------------------------------------------
+//      F16C命令が使えるかどうかチェックします.
+//      YMMレジスタを使うので，OSの対応も含めて判定済みのSIMDレベルがAVX2以上の場合のみ使います.
+//-------------------------------------------------------------------------------------------------
+inline bool UseF16C()
+{ return g_F16C && asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_AVX2; }
+
+//-------------------------------------------------------------------------------------------------
+//      半精度浮動小数を単精度浮動小数に変換します(SSE2版).
+//      指数部のバイアスは整数加算で付け替えます. 乗算で正規化すると非正規化数の入力で極端に遅くなるので，
+//      非正規化数は 2^-14 を足した値から 2^-14 を引いて求めます.
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+__m128 ToFloatSSE2(__m128i value)
+{
+    const __m128i maskNoSign    = _mm_set1_epi32(0x7FFF);
+    const __m128i smallest      = _mm_set1_epi32(0x0400);
+    const __m128i wasInfNaN     = _mm_set1_epi32(0x7BFF);
+    const __m128i infinity      = _mm_set1_epi32(0x7C00);
+    const __m128i expAdjust     = _mm_set1_epi32((127 - 15) << 23);
+    const __m128i infNaNAdjust  = _mm_set1_epi32((128 - 16) << 23);
+    const __m128i denormMagic   = _mm_set1_epi32((127 - 14) << 23);
+    const __m128i quietBit      = _mm_set1_epi32(0x400000);
+
+    auto expMant  = _mm_and_si128(value, maskNoSign);
+    auto sign     = _mm_slli_epi32(_mm_xor_si128(value, expMant), 16);
+    auto shifted  = _mm_slli_epi32(expMant, 13);
+    auto isDenorm = _mm_cmpgt_epi32(smallest, expMant);
+    auto isInfNaN = _mm_cmpgt_epi32(expMant, wasInfNaN);
+    auto isNaN    = _mm_cmpgt_epi32(expMant, infinity);
+
+    // 正規化数, 無限大, NaN.
+    auto normal = _mm_add_epi32(_mm_add_epi32(shifted, expAdjust), _mm_and_si128(isInfNaN, infNaNAdjust));
+    normal = _mm_or_si128(normal, _mm_and_si128(isNaN, quietBit));
+
+    // 非正規化数とゼロ.
+    auto denorm = _mm_castps_si128(_mm_sub_ps(
+        _mm_castsi128_ps(_mm_add_epi32(shifted, denormMagic)),
+        _mm_castsi128_ps(denormMagic)));
+
+    auto result = _mm_or_si128(_mm_and_si128(isDenorm, denorm), _mm_andnot_si128(isDenorm, normal));
+    return _mm_castsi128_ps(_mm_or_si128(result, sign));
+}
+
+//-------------------------------------------------------------------------------------------------
+//      単精度浮動小数を半精度浮動小数に変換します(SSE2版, 最近接偶数丸め).
+//      戻り値は符号拡張された32bit整数なので，_mm_packs_epi32 でそのまま16bitに詰められます.
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+__m128i ToHalfSSE2(__m128 value)
+{
+    const __m128i maskSign      = _mm_set1_epi32(int(0x80000000));
+    const __m128i f16Max        = _mm_set1_epi32((127 + 16) << 23);
+    const __m128i infinity      = _mm_set1_epi32(0x7F800000);
+    const __m128i nanBit        = _mm_set1_epi32(0x200);
+    const __m128i nanPayload    = _mm_set1_epi32(0x3FF);
+    const __m128i infAsHalf     = _mm_set1_epi32(0x7C00);
+    const __m128i minNormal     = _mm_set1_epi32((127 - 14) << 23);
+    const __m128i subnormMagic  = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i normalBias    = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+    auto bits     = _mm_castps_si128(value);
+    auto justSign = _mm_and_si128(bits, maskSign);
+    auto absBits  = _mm_xor_si128(bits, justSign);
+
+    // NaNは仮数部の上位10bitを残してクワイエットNaNにする.
+    auto isNaN     = _mm_cmpgt_epi32(absBits, infinity);
+    auto isRegular = _mm_cmpgt_epi32(f16Max, absBits);
+    auto isSubnorm = _mm_cmpgt_epi32(minNormal, absBits);
+    auto payload   = _mm_or_si128(nanBit, _mm_and_si128(_mm_srli_epi32(absBits, 13), nanPayload));
+    auto infOrNaN  = _mm_or_si128(_mm_and_si128(isNaN, payload), infAsHalf);
+
+    // 非正規化数は浮動小数の加算で丸めてから仮数部を取り出す.
+    auto subnorm = _mm_sub_epi32(
+        _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(absBits), _mm_castsi128_ps(subnormMagic))),
+        subnormMagic);
+
+    // 正規化数は指数のバイアスを付け替えて，仮数部の切り捨てビットで偶数丸めする.
+    auto mantOdd = _mm_srai_epi32(_mm_slli_epi32(absBits, 31 - 13), 31);
+    auto normal  = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absBits, normalBias), mantOdd), 13);
+
+    auto finite = _mm_or_si128(_mm_and_si128(isSubnorm, subnorm), _mm_andnot_si128(isSubnorm, normal));
+    auto joined = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, infOrNaN));
+
+    return _mm_or_si128(joined, _mm_srai_epi32(justSign, 16));
+}
+
+//-------------------------------------------------------------------------------------------------
+//      単精度浮動小数の配列を半精度浮動小数に変換します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+size_t FloatToHalfSSE2(const float* pSrc, asdx::half* pDst, size_t count)
+{
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        auto lo = ToHalfSSE2(_mm_loadu_ps(pSrc + i + 0));
+        auto hi = ToHalfSSE2(_mm_loadu_ps(pSrc + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_packs_epi32(lo, hi));
+    }
+
+    return i;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      半精度浮動小数の配列を単精度浮動小数に変換します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+size_t HalfToFloatSSE2(const asdx::half* pSrc, float* pDst, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        _mm_storeu_ps(pDst + i + 0, ToFloatSSE2(_mm_unpacklo_epi16(v, zero)));
+        _mm_storeu_ps(pDst + i + 4, ToFloatSSE2(_mm_unpackhi_epi16(v, zero)));
+    }
+
+    return i;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      単精度浮動小数の配列を半精度浮動小数に変換します(F16C版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_F16C
+size_t FloatToHalfF16C(const float* pSrc, asdx::half* pDst, size_t count)
+{
+    // MXCSRの丸めモードに依存しないように，丸め方法は即値で指定する.
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        auto lo = _mm256_cvtps_ph(_mm256_loadu_ps(pSrc + i + 0), _MM_FROUND_TO_NEAREST_INT);
+        auto hi = _mm256_cvtps_ph(_mm256_loadu_ps(pSrc + i + 8), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 0), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 8), hi);
+    }
+
+    for(; i + 8 <= count; i += 8)
+    {
+        auto v = _mm256_cvtps_ph(_mm256_loadu_ps(pSrc + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), v);
+    }
+
+    return i;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      半精度浮動小数の配列を単精度浮動小数に変換します(F16C版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_F16C
+size_t HalfToFloatF16C(const asdx::half* pSrc, float* pDst, size_t count)
+{
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        auto lo = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i + 0)));
+        auto hi = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i + 8)));
+        _mm256_storeu_ps(pDst + i + 0, lo);
+        _mm256_storeu_ps(pDst + i + 8, hi);
+    }
+
+    for(; i + 8 <= count; i += 8)
+    {
+        auto v = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i)));
+        _mm256_storeu_ps(pDst + i, v);
+    }
+
+    return i;
+}
+#endif//ASDX_KERNEL_X86
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//      float型の配列をhalf型の配列に変換します.
+//-------------------------------------------------------------------------------------------------
+void floatTohalf( const float* pSrc, half* pDst, size_t count )
+{
+    size_t i = 0;
+#if ASDX_KERNEL_X86
+    if ( UseF16C() )
+    { i = FloatToHalfF16C( pSrc, pDst, count ); }
+    else if ( GetSimdLevel() >= SIMD_LEVEL_SSE2 )
+    { i = FloatToHalfSSE2( pSrc, pDst, count ); }
+#endif
+
+    for( ; i<count; ++i )
+    { pDst[i] = floatTohalf( pSrc[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      half型の配列をfloat型の配列に変換します.
+//-------------------------------------------------------------------------------------------------
+void halfTofloat( const half* pSrc, float* pDst, size_t count )
+{
+    size_t i = 0;
+#if ASDX_KERNEL_X86
+    if ( UseF16C() )
+    { i = HalfToFloatF16C( pSrc, pDst, count ); }
+    else if ( GetSimdLevel() >= SIMD_LEVEL_SSE2 )
+    { i = HalfToFloatSSE2( pSrc, pDst, count ); }
+#endif
+
+    for( ; i<count; ++i )
+    { pDst[i] = halfTofloat( pSrc[i] ); }
+}
+
+} // namespace asdx
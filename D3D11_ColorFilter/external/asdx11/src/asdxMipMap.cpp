@@ -0,0 +1,807 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxMipMap.cpp
+// Desc : MipMap Generator Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxMipMap.h>
+#include <asdxResTexture.h>
+#include <asdxLogger.h>
+#include <asdxParallelFor.h>
+#include <asdxMath.h>
+#include <dxgiformat.h>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <vector>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const float      kFilterRadius   = 3.0f;     // Kaiser, Lanczos の半径です(出力ピクセル単位).
+static const float      kKaiserAlpha    = 4.0f;     // Kaiser窓の形状パラメータです.
+static const float      kPI             = 3.14159265358979323846f;
+static const uint32_t   kJobPixelCount  = 16384;    // 1ジョブあたりの目安ピクセル数です.
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CHANNEL_TYPE enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum CHANNEL_TYPE
+{
+    CHANNEL_TYPE_UNORM8 = 0,
+    CHANNEL_TYPE_UNORM16,
+    CHANNEL_TYPE_FLOAT16,
+    CHANNEL_TYPE_FLOAT32,
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FORMAT_INFO structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FORMAT_INFO
+{
+    CHANNEL_TYPE    Type;           //!< チャンネルの型です.
+    uint32_t        ChannelCount;   //!< チャンネル数です.
+    bool            HasAlpha;       //!< 4番目のチャンネルがアルファかどうか.
+    bool            IsSRGB;         //!< SRGBフォーマットかどうか.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FILTER_TABLE structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FILTER_TABLE
+{
+    std::vector<uint32_t>   Begin;      //!< 出力ピクセルごとの参照開始位置です.
+    std::vector<uint32_t>   Count;      //!< 出力ピクセルごとの参照数です.
+    std::vector<uint32_t>   Offset;     //!< 出力ピクセルごとの重みの格納位置です.
+    std::vector<float>      Weights;    //!< 正規化済みの重みです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// LEVEL_WORK structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct LEVEL_WORK
+{
+    uint32_t                Surface;        //!< サーフェイス番号です.
+    uint32_t                Mip;            //!< ミップレベルです.
+    uint32_t                Width;          //!< 横幅です.
+    uint32_t                Height;         //!< 縦幅です.
+    const FILTER_TABLE*     pFilterX;       //!< 横方向のフィルタです.
+    const FILTER_TABLE*     pFilterY;       //!< 縦方向のフィルタです.
+    std::vector<float>      Temp;           //!< 横方向に縮小した結果です(Width x 最上位レベルの縦幅).
+    std::vector<float>      Pixels;         //!< 縮小結果です(Width x Height, RGBA).
+    float                   AlphaScale;     //!< アルファに掛けるスケールです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ROW_JOB structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ROW_JOB
+{
+    uint32_t    Index;      //!< 処理対象の番号です.
+    uint32_t    Begin;      //!< 開始行です.
+    uint32_t    End;        //!< 終了行です.
+};
+
+
+//-------------------------------------------------------------------------------------------------
+//      フォーマット情報を取得します.
+//-------------------------------------------------------------------------------------------------
+bool GetFormatInfo(uint32_t format, FORMAT_INFO& info)
+{
+    switch(format)
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:        { info = { CHANNEL_TYPE_UNORM8,  4, true,  false }; } break;
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:   { info = { CHANNEL_TYPE_UNORM8,  4, true,  true  }; } break;
+    case DXGI_FORMAT_B8G8R8A8_UNORM:        { info = { CHANNEL_TYPE_UNORM8,  4, true,  false }; } break;
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:   { info = { CHANNEL_TYPE_UNORM8,  4, true,  true  }; } break;
+    case DXGI_FORMAT_B8G8R8X8_UNORM:        { info = { CHANNEL_TYPE_UNORM8,  4, false, false }; } break;
+    case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:   { info = { CHANNEL_TYPE_UNORM8,  4, false, true  }; } break;
+    case DXGI_FORMAT_R8G8_UNORM:            { info = { CHANNEL_TYPE_UNORM8,  2, false, false }; } break;
+    case DXGI_FORMAT_R8_UNORM:              { info = { CHANNEL_TYPE_UNORM8,  1, false, false }; } break;
+    case DXGI_FORMAT_R16G16B16A16_UNORM:    { info = { CHANNEL_TYPE_UNORM16, 4, true,  false }; } break;
+    case DXGI_FORMAT_R16G16_UNORM:          { info = { CHANNEL_TYPE_UNORM16, 2, false, false }; } break;
+    case DXGI_FORMAT_R16_UNORM:             { info = { CHANNEL_TYPE_UNORM16, 1, false, false }; } break;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:    { info = { CHANNEL_TYPE_FLOAT16, 4, true,  false }; } break;
+    case DXGI_FORMAT_R16G16_FLOAT:          { info = { CHANNEL_TYPE_FLOAT16, 2, false, false }; } break;
+    case DXGI_FORMAT_R16_FLOAT:             { info = { CHANNEL_TYPE_FLOAT16, 1, false, false }; } break;
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:    { info = { CHANNEL_TYPE_FLOAT32, 4, true,  false }; } break;
+    case DXGI_FORMAT_R32G32B32_FLOAT:       { info = { CHANNEL_TYPE_FLOAT32, 3, false, false }; } break;
+    case DXGI_FORMAT_R32G32_FLOAT:          { info = { CHANNEL_TYPE_FLOAT32, 2, false, false }; } break;
+    case DXGI_FORMAT_R32_FLOAT:             { info = { CHANNEL_TYPE_FLOAT32, 1, false, false }; } break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1ピクセルあたりのバイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t GetPixelSize(const FORMAT_INFO& info)
+{
+    switch(info.Type)
+    {
+    case CHANNEL_TYPE_UNORM8:   return info.ChannelCount;
+    case CHANNEL_TYPE_UNORM16:  return info.ChannelCount * 2;
+    case CHANNEL_TYPE_FLOAT16:  return info.ChannelCount * 2;
+    case CHANNEL_TYPE_FLOAT32:  return info.ChannelCount * 4;
+    }
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SRGBから線形に変換します.
+//-------------------------------------------------------------------------------------------------
+inline float SRGBToLinear(float value)
+{
+    return (value <= 0.04045f)
+        ? value / 12.92f
+        : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      線形からSRGBに変換します.
+//-------------------------------------------------------------------------------------------------
+inline float LinearToSRGB(float value)
+{
+    if (value <= 0.0f)
+    { return 0.0f; }
+
+    return (value <= 0.0031308f)
+        ? value * 12.92f
+        : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      [0, 1] に飽和させます.
+//-------------------------------------------------------------------------------------------------
+inline float Saturate(float value)
+{ return (value < 0.0f) ? 0.0f : ((value > 1.0f) ? 1.0f : value); }
+
+//-------------------------------------------------------------------------------------------------
+//      8bit SRGB値から線形値への変換テーブルを取得します.
+//-------------------------------------------------------------------------------------------------
+const float* GetSRGBTable()
+{
+    struct Table
+    {
+        float Values[256];
+
+        Table()
+        {
+            for(auto i=0; i<256; ++i)
+            { Values[i] = SRGBToLinear(float(i) / 255.0f); }
+        }
+    };
+
+    static const Table table;
+    return table.Values;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1行分のピクセルを線形空間のRGBAに展開します.
+//-------------------------------------------------------------------------------------------------
+void LoadRow(const FORMAT_INFO& info, const uint8_t* pSrc, uint32_t width, float* pDst)
+{
+    const auto count = info.ChannelCount;
+    const auto table = GetSRGBTable();
+
+    // RGBAの半精度浮動小数は並びが同じなので，1行まとめて変換する.
+    if (info.Type == CHANNEL_TYPE_FLOAT16 && count == 4)
+    {
+        asdx::halfTofloat(reinterpret_cast<const asdx::half*>(pSrc), pDst, size_t(width) * 4);
+        return;
+    }
+
+    for(auto x=0u; x<width; ++x)
+    {
+        float* pPixel = pDst + x * 4;
+        pPixel[0] = 0.0f;
+        pPixel[1] = 0.0f;
+        pPixel[2] = 0.0f;
+        pPixel[3] = 1.0f;
+
+        switch(info.Type)
+        {
+        case CHANNEL_TYPE_UNORM8:
+            {
+                auto p = pSrc + x * count;
+                if (info.IsSRGB)
+                {
+                    for(auto c=0u; c<count && c<3; ++c)
+                    { pPixel[c] = table[p[c]]; }
+                    if (count == 4)
+                    { pPixel[3] = float(p[3]) / 255.0f; }
+                }
+                else
+                {
+                    for(auto c=0u; c<count; ++c)
+                    { pPixel[c] = float(p[c]) / 255.0f; }
+                }
+            }
+            break;
+
+        case CHANNEL_TYPE_UNORM16:
+            {
+                for(auto c=0u; c<count; ++c)
+                {
+                    uint16_t value;
+                    memcpy(&value, pSrc + (x * count + c) * 2, sizeof(value));
+                    pPixel[c] = float(value) / 65535.0f;
+                }
+            }
+            break;
+
+        case CHANNEL_TYPE_FLOAT16:
+            {
+                for(auto c=0u; c<count; ++c)
+                {
+                    uint16_t value;
+                    memcpy(&value, pSrc + (x * count + c) * 2, sizeof(value));
+                    pPixel[c] = asdx::halfTofloat(value);
+                }
+            }
+            break;
+
+        case CHANNEL_TYPE_FLOAT32:
+            { memcpy(pPixel, pSrc + x * count * 4, sizeof(float) * count); }
+            break;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      線形空間のRGBAを1行分のピクセルに変換します.
+//-------------------------------------------------------------------------------------------------
+void StoreRow(const FORMAT_INFO& info, const float* pSrc, uint32_t width, float alphaScale, uint8_t* pDst)
+{
+    const auto count = info.ChannelCount;
+
+    // アルファを補正しないRGBAの半精度浮動小数は，1行まとめて変換する.
+    if (info.Type == CHANNEL_TYPE_FLOAT16 && count == 4 && (!info.HasAlpha || alphaScale == 1.0f))
+    {
+        asdx::floatTohalf(pSrc, reinterpret_cast<asdx::half*>(pDst), size_t(width) * 4);
+        return;
+    }
+
+    for(auto x=0u; x<width; ++x)
+    {
+        float pixel[4] = { pSrc[x * 4 + 0], pSrc[x * 4 + 1], pSrc[x * 4 + 2], pSrc[x * 4 + 3] };
+        if (info.HasAlpha)
+        { pixel[3] *= alphaScale; }
+
+        switch(info.Type)
+        {
+        case CHANNEL_TYPE_UNORM8:
+            {
+                auto p = pDst + x * count;
+                for(auto c=0u; c<count; ++c)
+                {
+                    auto value = (info.IsSRGB && c < 3) ? LinearToSRGB(pixel[c]) : pixel[c];
+                    p[c] = uint8_t(Saturate(value) * 255.0f + 0.5f);
+                }
+            }
+            break;
+
+        case CHANNEL_TYPE_UNORM16:
+            {
+                for(auto c=0u; c<count; ++c)
+                {
+                    auto value = uint16_t(Saturate(pixel[c]) * 65535.0f + 0.5f);
+                    memcpy(pDst + (x * count + c) * 2, &value, sizeof(value));
+                }
+            }
+            break;
+
+        case CHANNEL_TYPE_FLOAT16:
+            {
+                for(auto c=0u; c<count; ++c)
+                {
+                    auto value = asdx::floatTohalf(pixel[c]);
+                    memcpy(pDst + (x * count + c) * 2, &value, sizeof(value));
+                }
+            }
+            break;
+
+        case CHANNEL_TYPE_FLOAT32:
+            { memcpy(pDst + x * count * 4, pixel, sizeof(float) * count); }
+            break;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      sinc関数です.
+//-------------------------------------------------------------------------------------------------
+inline float Sinc(float x)
+{
+    if (std::fabs(x) < 1e-6f)
+    { return 1.0f; }
+
+    auto px = kPI * x;
+    return std::sin(px) / px;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      第1種0次変形ベッセル関数です.
+//-------------------------------------------------------------------------------------------------
+float BesselI0(float x)
+{
+    auto sum  = 1.0f;
+    auto term = 1.0f;
+    auto half = x * 0.5f;
+    for(auto k=1; k<32; ++k)
+    {
+        auto t = half / float(k);
+        term *= t * t;
+        sum  += term;
+        if (term < sum * 1e-8f)
+        { break; }
+    }
+    return sum;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フィルタの重みを求めます.
+//-------------------------------------------------------------------------------------------------
+float EvalFilter(asdx::MIP_FILTER filter, float x)
+{
+    auto ax = std::fabs(x);
+    if (ax >= kFilterRadius)
+    { return 0.0f; }
+
+    switch(filter)
+    {
+    case asdx::MIP_FILTER_KAISER:
+        {
+            auto t = x / kFilterRadius;
+            return Sinc(x) * BesselI0(kKaiserAlpha * std::sqrt(1.0f - t * t)) / BesselI0(kKaiserAlpha);
+        }
+
+    case asdx::MIP_FILTER_LANCZOS:
+        { return Sinc(x) * Sinc(x / kFilterRadius); }
+
+    default:
+        break;
+    }
+
+    return 0.0f;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1次元の縮小フィルタテーブルを構築します.
+//-------------------------------------------------------------------------------------------------
+void BuildFilterTable(asdx::MIP_FILTER filter, uint32_t srcSize, uint32_t dstSize, FILTER_TABLE& table)
+{
+    table.Begin .resize(dstSize);
+    table.Count .resize(dstSize);
+    table.Offset.resize(dstSize);
+    table.Weights.clear();
+
+    auto scale = float(srcSize) / float(dstSize);
+    if (scale < 1.0f)
+    { scale = 1.0f; }
+
+    auto support = (filter == asdx::MIP_FILTER_BOX) ? scale * 0.5f : kFilterRadius * scale;
+
+    for(auto i=0u; i<dstSize; ++i)
+    {
+        auto center = (float(i) + 0.5f) * scale;
+
+        auto first = int(std::floor(center - support));
+        auto last  = int(std::ceil (center + support));
+        if (first < 0)
+        { first = 0; }
+        if (last > int(srcSize))
+        { last = int(srcSize); }
+
+        auto offset = uint32_t(table.Weights.size());
+        auto sum    = 0.0f;
+
+        // 範囲外の参照は除外して正規化する.
+        for(auto j=first; j<last; ++j)
+        {
+            float w;
+            if (filter == asdx::MIP_FILTER_BOX)
+            {
+                auto lo = std::fmax(float(j),     center - support);
+                auto hi = std::fmin(float(j + 1), center + support);
+                w = (hi > lo) ? hi - lo : 0.0f;
+            }
+            else
+            { w = EvalFilter(filter, (float(j) + 0.5f - center) / scale); }
+
+            table.Weights.push_back(w);
+            sum += w;
+        }
+
+        auto count = uint32_t(last - first);
+        if (sum != 0.0f)
+        {
+            for(auto j=0u; j<count; ++j)
+            { table.Weights[offset + j] /= sum; }
+        }
+
+        table.Begin [i] = uint32_t(first);
+        table.Count [i] = count;
+        table.Offset[i] = offset;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      閾値を超えるアルファの割合を求めます.
+//-------------------------------------------------------------------------------------------------
+float CalcAlphaCoverage(const float* pPixels, size_t pixelCount, float alphaCutoff, float scale)
+{
+    if (pixelCount == 0)
+    { return 0.0f; }
+
+    size_t count = 0;
+    for(size_t i=0; i<pixelCount; ++i)
+    {
+        if (Saturate(pPixels[i * 4 + 3] * scale) > alphaCutoff)
+        { count++; }
+    }
+
+    return float(count) / float(pixelCount);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アルファカバレッジが目標値に近づくスケールを二分探索で求めます.
+//-------------------------------------------------------------------------------------------------
+float FindAlphaScale(const float* pPixels, size_t pixelCount, float alphaCutoff, float coverage)
+{
+    auto minScale = 0.0f;
+    auto maxScale = 4.0f;
+    auto scale    = 1.0f;
+
+    for(auto i=0; i<10; ++i)
+    {
+        auto current = CalcAlphaCoverage(pPixels, pixelCount, alphaCutoff, scale);
+        if (current < coverage)
+        { minScale = scale; }
+        else if (current > coverage)
+        { maxScale = scale; }
+        else
+        { break; }
+
+        scale = (minScale + maxScale) * 0.5f;
+    }
+
+    return scale;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1ジョブあたりの行数を求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t GetRowsPerJob(uint32_t width)
+{
+    auto rows = kJobPixelCount / ((width > 0) ? width : 1);
+    return (rows > 0) ? rows : 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行単位のジョブを追加します.
+//-------------------------------------------------------------------------------------------------
+void AddRowJobs(std::vector<ROW_JOB>& jobs, uint32_t index, uint32_t rowCount, uint32_t width)
+{
+    auto step = GetRowsPerJob(width);
+    for(auto y=0u; y<rowCount; y+=step)
+    {
+        ROW_JOB job;
+        job.Index = index;
+        job.Begin = y;
+        job.End   = (y + step < rowCount) ? y + step : rowCount;
+        jobs.push_back(job);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ジョブを並列に処理します.
+//-------------------------------------------------------------------------------------------------
+template<typename Func>
+void RunJobs(const std::vector<ROW_JOB>& jobs, Func func)
+{
+    const auto pJobs = jobs.data();
+    asdx::ParallelFor(uint32_t(jobs.size()), 1, [=](uint32_t begin, uint32_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        { func(pJobs[i]); }
+    });
+}
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//      ミップマップを生成できるフォーマットかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsMipMapGeneratable(uint32_t format)
+{
+    FORMAT_INFO info;
+    return GetFormatInfo(format, info);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最上位ミップレベルのサイズから完全なミップレベル数を求めます.
+//-------------------------------------------------------------------------------------------------
+uint32_t CalcMipMapCount(uint32_t width, uint32_t height)
+{
+    auto size  = (width > height) ? width : height;
+    auto count = 1u;
+    while(size > 1)
+    {
+        size >>= 1;
+        count++;
+    }
+    return count;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      リソーステクスチャのミップマップを生成します.
+//-------------------------------------------------------------------------------------------------
+bool GenerateMipMaps
+(
+    const ResTexture&   src,
+    ResTexture&         dst,
+    MIP_FILTER          filter,
+    uint32_t            mipCount,
+    float               alphaCutoff
+)
+{
+    FORMAT_INFO info;
+    if (!GetFormatInfo(src.Format, info))
+    {
+        ELOG("Error : Unsupported Format. format = %u", src.Format);
+        return false;
+    }
+
+    if (src.pResources == nullptr || src.MipMapCount == 0 || &src == &dst)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    if (src.Option & SUBRESOURCE_OPTION_VOLUME)
+    {
+        ELOG("Error : Volume texture is not supported.");
+        return false;
+    }
+
+    const auto width        = src.Width;
+    const auto height       = src.Height;
+    const auto surfaceCount = (src.SurfaceCount > 0) ? src.SurfaceCount : 1;
+    const auto pixelSize    = GetPixelSize(info);
+
+    for(auto i=0u; i<surfaceCount; ++i)
+    {
+        const auto& res = src.pResources[i * src.MipMapCount];
+        if (res.pPixels == nullptr || res.Width != width || res.Height != height)
+        {
+            ELOG("Error : Invalid SubResource. surface = %u", i);
+            return false;
+        }
+    }
+
+    auto maxMipCount = CalcMipMapCount(width, height);
+    if (mipCount == 0 || mipCount > maxMipCount)
+    { mipCount = maxMipCount; }
+
+    // 横縦のフィルタはサーフェイス間で共有する.
+    std::vector<FILTER_TABLE> filterX(mipCount);
+    std::vector<FILTER_TABLE> filterY(mipCount);
+    for(auto m=1u; m<mipCount; ++m)
+    {
+        auto w = (width  >> m) ? (width  >> m) : 1;
+        auto h = (height >> m) ? (height >> m) : 1;
+        BuildFilterTable(filter, width,  w, filterX[m]);
+        BuildFilterTable(filter, height, h, filterY[m]);
+    }
+
+    // 最上位ミップレベルを線形空間に展開する.
+    std::vector<std::vector<float>> tops(surfaceCount);
+    std::vector<ROW_JOB> jobs;
+    for(auto i=0u; i<surfaceCount; ++i)
+    {
+        tops[i].resize(size_t(width) * height * 4);
+        AddRowJobs(jobs, i, height, width);
+    }
+
+    RunJobs(jobs, [&](const ROW_JOB& job)
+    {
+        const auto& res = src.pResources[job.Index * src.MipMapCount];
+        for(auto y=job.Begin; y<job.End; ++y)
+        {
+            LoadRow(info,
+                res.pPixels + size_t(res.Pitch) * y,
+                width,
+                tops[job.Index].data() + size_t(width) * y * 4);
+        }
+    });
+
+    // 縮小するレベルを列挙する.
+    std::vector<LEVEL_WORK> levels;
+    levels.reserve(size_t(surfaceCount) * mipCount);
+    for(auto i=0u; i<surfaceCount; ++i)
+    {
+        for(auto m=1u; m<mipCount; ++m)
+        {
+            LEVEL_WORK level;
+            level.Surface    = i;
+            level.Mip        = m;
+            level.Width      = (width  >> m) ? (width  >> m) : 1;
+            level.Height     = (height >> m) ? (height >> m) : 1;
+            level.pFilterX   = &filterX[m];
+            level.pFilterY   = &filterY[m];
+            level.AlphaScale = 1.0f;
+            levels.push_back(std::move(level));
+        }
+    }
+
+    // 横方向の縮小. 各レベルは最上位レベルから直接縮小する.
+    jobs.clear();
+    for(auto i=0u; i<uint32_t(levels.size()); ++i)
+    {
+        auto& level = levels[i];
+        level.Temp.resize(size_t(level.Width) * height * 4);
+        AddRowJobs(jobs, i, height, width);
+    }
+
+    RunJobs(jobs, [&](const ROW_JOB& job)
+    {
+        auto& level = levels[job.Index];
+        const auto& table = *level.pFilterX;
+        const auto& top   = tops[level.Surface];
+
+        for(auto y=job.Begin; y<job.End; ++y)
+        {
+            auto pSrc = top.data() + size_t(width) * y * 4;
+            auto pDst = level.Temp.data() + size_t(level.Width) * y * 4;
+
+            for(auto x=0u; x<level.Width; ++x)
+            {
+                float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                auto pWeights = table.Weights.data() + table.Offset[x];
+                auto pPixel   = pSrc + size_t(table.Begin[x]) * 4;
+                for(auto k=0u; k<table.Count[x]; ++k)
+                {
+                    auto w = pWeights[k];
+                    sum[0] += pPixel[k * 4 + 0] * w;
+                    sum[1] += pPixel[k * 4 + 1] * w;
+                    sum[2] += pPixel[k * 4 + 2] * w;
+                    sum[3] += pPixel[k * 4 + 3] * w;
+                }
+                memcpy(pDst + x * 4, sum, sizeof(sum));
+            }
+        }
+    });
+
+    // 縦方向の縮小.
+    jobs.clear();
+    for(auto i=0u; i<uint32_t(levels.size()); ++i)
+    {
+        auto& level = levels[i];
+        level.Pixels.resize(size_t(level.Width) * level.Height * 4);
+        AddRowJobs(jobs, i, level.Height, level.Width);
+    }
+
+    RunJobs(jobs, [&](const ROW_JOB& job)
+    {
+        auto& level = levels[job.Index];
+        const auto& table = *level.pFilterY;
+        const auto rowSize = size_t(level.Width) * 4;
+
+        for(auto y=job.Begin; y<job.End; ++y)
+        {
+            auto pDst     = level.Pixels.data() + rowSize * y;
+            auto pWeights = table.Weights.data() + table.Offset[y];
+            auto pRow     = level.Temp.data() + rowSize * table.Begin[y];
+
+            memset(pDst, 0, sizeof(float) * rowSize);
+            for(auto k=0u; k<table.Count[y]; ++k)
+            {
+                auto w = pWeights[k];
+                for(size_t x=0; x<rowSize; ++x)
+                { pDst[x] += pRow[x] * w; }
+                pRow += rowSize;
+            }
+        }
+    });
+
+    for(auto& level : levels)
+    {
+        level.Temp.clear();
+        level.Temp.shrink_to_fit();
+    }
+
+    // アルファカバレッジを最上位レベルに合わせる.
+    if (info.HasAlpha && alphaCutoff > 0.0f)
+    {
+        std::vector<float> coverages(surfaceCount);
+        for(auto i=0u; i<surfaceCount; ++i)
+        { coverages[i] = CalcAlphaCoverage(tops[i].data(), size_t(width) * height, alphaCutoff, 1.0f); }
+
+        auto pLevels = levels.data();
+        ParallelFor(uint32_t(levels.size()), 1, [&, pLevels](uint32_t begin, uint32_t end)
+        {
+            for(auto i=begin; i<end; ++i)
+            {
+                auto& level = pLevels[i];
+                level.AlphaScale = FindAlphaScale(
+                    level.Pixels.data(),
+                    size_t(level.Width) * level.Height,
+                    alphaCutoff,
+                    coverages[level.Surface]);
+            }
+        });
+    }
+
+    // 出力先を確保する.
+    ResTexture result;
+    result.Width        = width;
+    result.Height       = height;
+    result.Depth        = 1;
+    result.Format       = src.Format;
+    result.MipMapCount  = mipCount;
+    result.SurfaceCount = surfaceCount;
+    result.Option       = src.Option;
+
+    // サブリソースとピクセルデータをまとめて確保する(ピクセルは詰めて並ぶ).
+    if (!AllocateResTexture(result))
+    { return false; }
+
+    if (result.pResources[0].Pitch != width * pixelSize)
+    {
+        ELOG("Error : Pitch Mismatch. format = %u", result.Format);
+        result.Release();
+        return false;
+    }
+
+    // 最上位レベルは元データをそのままコピーする.
+    for(auto i=0u; i<surfaceCount; ++i)
+    {
+        const auto& srcRes = src.pResources[i * src.MipMapCount];
+        auto& dstRes = result.pResources[i * mipCount];
+        for(auto y=0u; y<height; ++y)
+        {
+            memcpy(dstRes.pPixels + size_t(dstRes.Pitch) * y,
+                   srcRes.pPixels + size_t(srcRes.Pitch) * y,
+                   dstRes.Pitch);
+        }
+    }
+
+    // 縮小結果を出力フォーマットに変換する.
+    jobs.clear();
+    for(auto i=0u; i<uint32_t(levels.size()); ++i)
+    { AddRowJobs(jobs, i, levels[i].Height, levels[i].Width); }
+
+    RunJobs(jobs, [&](const ROW_JOB& job)
+    {
+        const auto& level = levels[job.Index];
+        auto& res = result.pResources[level.Surface * mipCount + level.Mip];
+
+        for(auto y=job.Begin; y<job.End; ++y)
+        {
+            StoreRow(info,
+                level.Pixels.data() + size_t(level.Width) * y * 4,
+                level.Width,
+                level.AlphaScale,
+                res.pPixels + size_t(res.Pitch) * y);
+        }
+    });
+
+    dst = result;
+    return true;
+}
+
+} // namespace asdx
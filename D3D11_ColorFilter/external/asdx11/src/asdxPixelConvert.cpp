@@ -0,0 +1,1308 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxPixelConvert.cpp
+// Desc : Pixel Format Conversion Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxPixelConvert.h>
+#include <asdxPixelKernel.h>
+#include <asdxMath.h>
+#include <asdxParallelFor.h>
+#include <asdxLogger.h>
+#include <dxgiformat.h>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define ASDX_KERNEL_X86     (1)
+    #include <emmintrin.h>
+#else
+    #define ASDX_KERNEL_X86     (0)
+#endif
+
+// MSVCは命令セットの指定なしでイントリンジックを使用できるが，GCC/Clangは関数単位で指定が必要.
+#if defined(__GNUC__) || defined(__clang__)
+    #define ASDX_TARGET_SSE2    __attribute__((target("sse2")))
+#else
+    #define ASDX_TARGET_SSE2
+#endif
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kChunkPixels    = 256;                              // 中間形式で一度に変換するピクセル数です.
+static const uint32_t   kParallelPixels = 64 * 1024;                        // 1スレッドあたりの最小ピクセル数です.
+static const size_t     kFormatCount    = asdx::PIXEL_FORMAT_COUNT - 1;     // UNKNOWN を除いたフォーマット数です.
+static const float      kRGB9E5Max      = 65408.0f;                         // R9G9B9E5 の最大値(511/512 * 2^16)です.
+static const float      kRGB9E5Min      = 1.0f / 65536.0f;                  // R9G9B9E5 の最小の指数で表す値(2^-16)です.
+
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      1行分のピクセルを変換する関数です.
+//!
+//! @param[in]      pSrc        変換元ピクセルです.
+//! @param[out]     pDst        変換先ピクセルです.
+//! @param[in]      count       ピクセル数です.
+//-------------------------------------------------------------------------------------------------
+typedef void (*ConvertRowFunc)(const uint8_t* pSrc, uint8_t* pDst, uint32_t count);
+
+
+//-------------------------------------------------------------------------------------------------
+//      [0, 1] の値を8bitに変換します.
+//-------------------------------------------------------------------------------------------------
+inline uint8_t ToUnorm8(float value)
+{
+    // NaN も 0 にする.
+    if (!(value > 0.0f)) { return 0; }
+    if (value >= 1.0f)   { return 255; }
+    return uint8_t(value * 255.0f + 0.5f);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      [0, 1] の値を16bitに変換します.
+//-------------------------------------------------------------------------------------------------
+inline uint16_t ToUnorm16(float value)
+{
+    if (!(value > 0.0f)) { return 0; }
+    if (value >= 1.0f)   { return 65535; }
+    return uint16_t(value * 65535.0f + 0.5f);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      nビットの値を8bitに引き伸ばします(上位ビットを下位に複製します).
+//-------------------------------------------------------------------------------------------------
+template<uint32_t Bits>
+inline uint8_t ExpandBits(uint32_t value)
+{
+    switch(Bits)
+    {
+    case 0:  return 255;
+    case 1:  return value ? 255 : 0;
+    case 4:  return uint8_t((value << 4) | value);
+    case 5:  return uint8_t((value << 3) | (value >> 2));
+    case 6:  return uint8_t((value << 2) | (value >> 4));
+    default: return uint8_t(value);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8bitの値をnビットに縮めます.
+//-------------------------------------------------------------------------------------------------
+template<uint32_t Bits>
+inline uint32_t ReduceBits(uint8_t value)
+{
+    const uint32_t maxValue = (1u << Bits) - 1;
+    return (value * maxValue + 127) / 255;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SRGB_TABLE structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct SRGB_TABLE
+{
+    uint8_t     ToLinear8   [256];      //!< sRGB(8bit) から線形(8bit) への変換テーブルです.
+    uint8_t     ToSRGB8     [256];      //!< 線形(8bit) から sRGB(8bit) への変換テーブルです.
+    float       ToLinearF   [256];      //!< sRGB(8bit) から線形(float) への変換テーブルです.
+    uint8_t     FromLinearF [65536];    //!< 線形(16bitに量子化) から sRGB(8bit) への変換テーブルです.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    SRGB_TABLE()
+    {
+        for(auto i=0; i<256; ++i)
+        {
+            auto value = float(i) / 255.0f;
+            ToLinearF[i] = ToLinear(value);
+            ToLinear8[i] = ToUnorm8(ToLinearF[i]);
+            ToSRGB8  [i] = ToUnorm8(ToSRGB(value));
+        }
+
+        for(auto i=0; i<65536; ++i)
+        { FromLinearF[i] = ToUnorm8(ToSRGB(float(i) / 65535.0f)); }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      線形の値を sRGB(8bit) に変換します.
+    //---------------------------------------------------------------------------------------------
+    uint8_t Encode(float value) const
+    { return FromLinearF[ToUnorm16(value)]; }
+
+    static float ToLinear(float value)
+    { return (value <= 0.04045f) ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f); }
+
+    static float ToSRGB(float value)
+    { return (value <= 0.0031308f) ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f; }
+};
+
+//-------------------------------------------------------------------------------------------------
+//      sRGB変換テーブルを取得します.
+//-------------------------------------------------------------------------------------------------
+const SRGB_TABLE& GetSRGBTable()
+{
+    static const SRGB_TABLE s_Table;
+    return s_Table;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FormatTraits structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  各フォーマットは以下を定義します.
+//      Size    : 1ピクセルあたりのバイト数.
+//      Wide    : 8bitを超える精度を持つかどうか. true なら中間形式を float4(RGBA) にします.
+//      SRGB    : sRGBフォーマットかどうか.
+//      Decode  : 中間形式(Wide なら float4, それ以外は RGBA8)への変換.
+//      Encode  : 中間形式からの変換.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<asdx::PIXEL_FORMAT Format>
+struct FormatTraits;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Unorm8Traits structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<uint32_t PixelSize, uint32_t R, uint32_t G, uint32_t B, uint32_t A, bool IsSRGB>
+struct Unorm8Traits
+{
+    static const uint32_t   Size = PixelSize;
+    static const bool       Wide = false;
+    static const bool       SRGB = IsSRGB;
+    static const bool       HasAlpha = (A < PixelSize);
+
+    static void Decode(const uint8_t* pSrc, uint8_t* pRGBA, uint32_t count)
+    {
+        // よく使う並びは SIMD 版のスウィズルを使う.
+        if (Size == 4 && R == 0 && G == 1 && B == 2 && HasAlpha)
+        { memcpy(pRGBA, pSrc, count * 4); return; }
+
+        if (Size == 4 && R == 2 && G == 1 && B == 0 && HasAlpha)
+        { asdx::SwizzleBGRAToRGBA(pSrc, pRGBA, count); return; }
+
+        if (Size == 3 && R == 2 && G == 1 && B == 0)
+        { asdx::SwizzleBGRToRGBA(pSrc, pRGBA, count); return; }
+
+        for(uint32_t i=0; i<count; ++i, pSrc+=Size, pRGBA+=4)
+        {
+            pRGBA[0] = pSrc[R];
+            pRGBA[1] = pSrc[G];
+            pRGBA[2] = pSrc[B];
+            pRGBA[3] = HasAlpha ? pSrc[A % Size] : 255;
+        }
+    }
+
+    static void Encode(const uint8_t* pRGBA, uint8_t* pDst, uint32_t count)
+    {
+        if (Size == 4 && R == 0 && G == 1 && B == 2 && HasAlpha)
+        { memcpy(pDst, pRGBA, count * 4); return; }
+
+        if (Size == 4 && R == 2 && G == 1 && B == 0 && HasAlpha)
+        { asdx::SwizzleBGRAToRGBA(pRGBA, pDst, count); return; }
+
+        for(uint32_t i=0; i<count; ++i, pRGBA+=4, pDst+=Size)
+        {
+            pDst[R] = pRGBA[0];
+            pDst[G] = pRGBA[1];
+            pDst[B] = pRGBA[2];
+            if (Size == 4)
+            { pDst[3 % Size] = HasAlpha ? pRGBA[3] : 255; }
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Packed16Traits structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<uint32_t RShift, uint32_t RBits, uint32_t GShift, uint32_t GBits, uint32_t BShift, uint32_t BBits, uint32_t AShift, uint32_t ABits>
+struct Packed16Traits
+{
+    static const uint32_t   Size = 2;
+    static const bool       Wide = false;
+    static const bool       SRGB = false;
+
+    static void Decode(const uint8_t* pSrc, uint8_t* pRGBA, uint32_t count)
+    {
+        uint32_t i = 0;
+    #if ASDX_KERNEL_X86
+        if (asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_SSE2)
+        { i = DecodeSSE2(pSrc, pRGBA, count); }
+    #endif
+
+        for(; i<count; ++i)
+        {
+            uint32_t value = pSrc[i * 2] | (pSrc[i * 2 + 1] << 8);
+            pRGBA[i * 4 + 0] = ExpandBits<RBits>((value >> RShift) & ((1u << RBits) - 1));
+            pRGBA[i * 4 + 1] = ExpandBits<GBits>((value >> GShift) & ((1u << GBits) - 1));
+            pRGBA[i * 4 + 2] = ExpandBits<BBits>((value >> BShift) & ((1u << BBits) - 1));
+            pRGBA[i * 4 + 3] = ExpandBits<ABits>((value >> AShift) & ((1u << ABits) - 1));
+        }
+    }
+
+    static void Encode(const uint8_t* pRGBA, uint8_t* pDst, uint32_t count)
+    {
+        for(uint32_t i=0; i<count; ++i, pRGBA+=4, pDst+=2)
+        {
+            // アルファを持たない場合は最上位ビットを1にしておく.
+            uint32_t value = (ReduceBits<RBits>(pRGBA[0]) << RShift)
+                           | (ReduceBits<GBits>(pRGBA[1]) << GShift)
+                           | (ReduceBits<BBits>(pRGBA[2]) << BShift)
+                           | ((ABits > 0) ? (ReduceBits<ABits>(pRGBA[3]) << AShift) : (1u << AShift));
+            pDst[0] = uint8_t(value & 0xFF);
+            pDst[1] = uint8_t(value >> 8);
+        }
+    }
+
+#if ASDX_KERNEL_X86
+    template<uint32_t Bits>
+    ASDX_TARGET_SSE2
+    static __m128i ExpandSSE2(__m128i value)
+    {
+        switch(Bits)
+        {
+        case 0:  return _mm_set1_epi16(0xFF);
+        case 1:  return _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), value), _mm_set1_epi16(0xFF));
+        case 4:  return _mm_or_si128(_mm_slli_epi16(value, 4), value);
+        case 5:  return _mm_or_si128(_mm_slli_epi16(value, 3), _mm_srli_epi16(value, 2));
+        case 6:  return _mm_or_si128(_mm_slli_epi16(value, 2), _mm_srli_epi16(value, 4));
+        default: return value;
+        }
+    }
+
+    ASDX_TARGET_SSE2
+    static uint32_t DecodeSSE2(const uint8_t* pSrc, uint8_t* pRGBA, uint32_t count)
+    {
+        const __m128i maskR = _mm_set1_epi16(short((1u << RBits) - 1));
+        const __m128i maskG = _mm_set1_epi16(short((1u << GBits) - 1));
+        const __m128i maskB = _mm_set1_epi16(short((1u << BBits) - 1));
+        const __m128i maskA = _mm_set1_epi16(short((1u << ABits) - 1));
+
+        // 8ピクセルずつ各成分を16bitレーンに取り出し，RG と BA の組にしてから交互に並べる.
+        uint32_t i = 0;
+        for(; i + 8 <= count; i += 8, pSrc += 16, pRGBA += 32)
+        {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+            auto r = ExpandSSE2<RBits>(_mm_and_si128(_mm_srli_epi16(v, RShift), maskR));
+            auto g = ExpandSSE2<GBits>(_mm_and_si128(_mm_srli_epi16(v, GShift), maskG));
+            auto b = ExpandSSE2<BBits>(_mm_and_si128(_mm_srli_epi16(v, BShift), maskB));
+            auto a = ExpandSSE2<ABits>(_mm_and_si128(_mm_srli_epi16(v, AShift), maskA));
+
+            auto rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+            auto ba = _mm_or_si128(b, _mm_slli_epi16(a, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pRGBA),      _mm_unpacklo_epi16(rg, ba));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pRGBA + 16), _mm_unpackhi_epi16(rg, ba));
+        }
+
+        return i;
+    }
+#endif//ASDX_KERNEL_X86
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// GrayTraits structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<bool HasAlpha>
+struct GrayTraits
+{
+    static const uint32_t   Size = HasAlpha ? 2 : 1;
+    static const bool       Wide = false;
+    static const bool       SRGB = false;
+
+    static void Decode(const uint8_t* pSrc, uint8_t* pRGBA, uint32_t count)
+    {
+        uint32_t i = 0;
+    #if ASDX_KERNEL_X86
+        if (!HasAlpha && asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_SSE2)
+        { i = DecodeSSE2(pSrc, pRGBA, count); }
+    #endif
+
+        for(; i<count; ++i)
+        {
+            pRGBA[i * 4 + 0] = pSrc[i * Size];
+            pRGBA[i * 4 + 1] = pSrc[i * Size];
+            pRGBA[i * 4 + 2] = pSrc[i * Size];
+            pRGBA[i * 4 + 3] = HasAlpha ? pSrc[i * Size + 1] : 255;
+        }
+    }
+
+    static void Encode(const uint8_t* pRGBA, uint8_t* pDst, uint32_t count)
+    {
+        for(uint32_t i=0; i<count; ++i, pRGBA+=4, pDst+=Size)
+        {
+            pDst[0] = pRGBA[0];
+            if (HasAlpha)
+            { pDst[Size - 1] = pRGBA[3]; }
+        }
+    }
+
+#if ASDX_KERNEL_X86
+    ASDX_TARGET_SSE2
+    static uint32_t DecodeSSE2(const uint8_t* pSrc, uint8_t* pRGBA, uint32_t count)
+    {
+        const __m128i alpha = _mm_set1_epi8(char(0xFF));
+
+        // 16ピクセルずつ (L, L) と (L, A) の組を作ってから交互に並べる.
+        uint32_t i = 0;
+        for(; i + 16 <= count; i += 16, pSrc += 16, pRGBA += 64)
+        {
+            auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+            auto ll = _mm_unpacklo_epi8(v, v);
+            auto la = _mm_unpacklo_epi8(v, alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pRGBA +  0), _mm_unpacklo_epi16(ll, la));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pRGBA + 16), _mm_unpackhi_epi16(ll, la));
+
+            ll = _mm_unpackhi_epi8(v, v);
+            la = _mm_unpackhi_epi8(v, alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pRGBA + 32), _mm_unpacklo_epi16(ll, la));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pRGBA + 48), _mm_unpackhi_epi16(ll, la));
+        }
+
+        return i;
+    }
+#endif//ASDX_KERNEL_X86
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Unorm16Traits structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<uint32_t ChannelCount>
+struct Unorm16Traits
+{
+    static const uint32_t   Size = ChannelCount * 2;
+    static const bool       Wide = true;
+    static const bool       SRGB = false;
+
+    static void Decode(const uint8_t* pSrc, float* pRGBA, uint32_t count)
+    {
+        const float scale = 1.0f / 65535.0f;
+        for(uint32_t i=0; i<count; ++i, pSrc+=Size, pRGBA+=4)
+        {
+            uint16_t value[4];
+            memcpy(value, pSrc, Size);
+
+            if (ChannelCount == 1)
+            {
+                pRGBA[0] = pRGBA[1] = pRGBA[2] = value[0] * scale;
+                pRGBA[3] = 1.0f;
+            }
+            else
+            {
+                for(uint32_t c=0; c<4; ++c)
+                { pRGBA[c] = value[c] * scale; }
+            }
+        }
+    }
+
+    static void Encode(const float* pRGBA, uint8_t* pDst, uint32_t count)
+    {
+        for(uint32_t i=0; i<count; ++i, pRGBA+=4, pDst+=Size)
+        {
+            uint16_t value[4];
+            for(uint32_t c=0; c<ChannelCount; ++c)
+            { value[c] = ToUnorm16(pRGBA[c]); }
+            memcpy(pDst, value, Size);
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Float16Traits structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct Float16Traits
+{
+    static const uint32_t   Size = 8;
+    static const bool       Wide = true;
+    static const bool       SRGB = false;
+
+    static void Decode(const uint8_t* pSrc, float* pRGBA, uint32_t count)
+    { asdx::halfTofloat(reinterpret_cast<const asdx::half*>(pSrc), pRGBA, count * 4); }
+
+    static void Encode(const float* pRGBA, uint8_t* pDst, uint32_t count)
+    { asdx::floatTohalf(pRGBA, reinterpret_cast<asdx::half*>(pDst), count * 4); }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Float32Traits structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<uint32_t ChannelCount>
+struct Float32Traits
+{
+    static const uint32_t   Size = ChannelCount * 4;
+    static const bool       Wide = true;
+    static const bool       SRGB = false;
+
+    static void Decode(const uint8_t* pSrc, float* pRGBA, uint32_t count)
+    {
+        if (ChannelCount == 4)
+        { memcpy(pRGBA, pSrc, count * 16); return; }
+
+        for(uint32_t i=0; i<count; ++i, pSrc+=Size, pRGBA+=4)
+        {
+            memcpy(pRGBA, pSrc, Size);
+            pRGBA[3] = 1.0f;
+        }
+    }
+
+    static void Encode(const float* pRGBA, uint8_t* pDst, uint32_t count)
+    {
+        if (ChannelCount == 4)
+        { memcpy(pDst, pRGBA, count * 16); return; }
+
+        for(uint32_t i=0; i<count; ++i, pRGBA+=4, pDst+=Size)
+        { memcpy(pDst, pRGBA, Size); }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RGBETraits structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct RGBETraits
+{
+    static const uint32_t   Size = 4;
+    static const bool       Wide = true;
+    static const bool       SRGB = false;
+
+    static void Decode(const uint8_t* pSrc, float* pRGBA, uint32_t count)
+    {
+        uint32_t i = 0;
+    #if ASDX_KERNEL_X86
+        if (asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_SSE2)
+        { i = DecodeSSE2(pSrc, pRGBA, count); }
+    #endif
+
+        for(pSrc+=i * 4, pRGBA+=i * 4; i<count; ++i, pSrc+=4, pRGBA+=4)
+        {
+            // 指数が0なら黒.
+            auto scale = (pSrc[3] != 0) ? ldexpf(1.0f, int(pSrc[3]) - (128 + 8)) : 0.0f;
+            pRGBA[0] = pSrc[0] * scale;
+            pRGBA[1] = pSrc[1] * scale;
+            pRGBA[2] = pSrc[2] * scale;
+            pRGBA[3] = 1.0f;
+        }
+    }
+
+    static void Encode(const float* pRGBA, uint8_t* pDst, uint32_t count)
+    {
+        for(uint32_t i=0; i<count; ++i, pRGBA+=4, pDst+=4)
+        {
+            auto r = (pRGBA[0] > 0.0f) ? pRGBA[0] : 0.0f;
+            auto g = (pRGBA[1] > 0.0f) ? pRGBA[1] : 0.0f;
+            auto b = (pRGBA[2] > 0.0f) ? pRGBA[2] : 0.0f;
+            auto m = (r > g) ? ((r > b) ? r : b) : ((g > b) ? g : b);
+
+            if (m < 1e-32f)
+            {
+                pDst[0] = pDst[1] = pDst[2] = pDst[3] = 0;
+                continue;
+            }
+
+            int e;
+            auto scale = frexpf(m, &e) * 256.0f / m;
+            pDst[0] = uint8_t(r * scale);
+            pDst[1] = uint8_t(g * scale);
+            pDst[2] = uint8_t(b * scale);
+            pDst[3] = uint8_t(e + 128);
+        }
+    }
+
+#if ASDX_KERNEL_X86
+    ASDX_TARGET_SSE2
+    static uint32_t DecodeSSE2(const uint8_t* pSrc, float* pRGBA, uint32_t count)
+    {
+        const __m128i mask  = _mm_set1_epi32(0xFF);
+        const __m128i small = _mm_set1_epi32(10);
+        const __m128i bias  = _mm_set1_epi32(127 - 136);
+        const __m128i shift = _mm_set1_epi32(64);
+        const __m128  one   = _mm_set1_ps(1.0f);
+        const __m128  down  = _mm_castsi128_ps(_mm_set1_epi32((127 - 64) << 23));
+
+        // 指数が10未満だと 2^(e-136) が非正規化数になるので，2^(e-72) と 2^-64 の2回に分けて乗算する.
+        // 1回目は誤差なしで，丸めは2回目の1回だけなのでスカラー版と一致する.
+        uint32_t i = 0;
+        for(; i + 4 <= count; i += 4, pSrc += 16, pRGBA += 16)
+        {
+            auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+            auto e  = _mm_srli_epi32(v, 24);
+            auto lo = _mm_cmplt_epi32(e, small);
+            auto s  = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_add_epi32(e, bias), _mm_and_si128(lo, shift)), 23));
+            s = _mm_andnot_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(e, _mm_setzero_si128())), s);
+            auto scale = _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(lo), down), _mm_andnot_ps(_mm_castsi128_ps(lo), one));
+
+            auto r = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(v, mask)), s), scale);
+            auto g = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v,  8), mask)), s), scale);
+            auto b = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 16), mask)), s), scale);
+            auto a = _mm_set1_ps(1.0f);
+
+            _MM_TRANSPOSE4_PS(r, g, b, a);
+            _mm_storeu_ps(pRGBA +  0, r);
+            _mm_storeu_ps(pRGBA +  4, g);
+            _mm_storeu_ps(pRGBA +  8, b);
+            _mm_storeu_ps(pRGBA + 12, a);
+        }
+
+        return i;
+    }
+#endif//ASDX_KERNEL_X86
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RGB9E5Traits structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//  R9G9B9E5_SHAREDEXP は 9bit の仮数3つと 5bit の共有指数(バイアス15)です.
+//  表現できる最大値は 511/512 * 2^16 = 65408 で，負の値と NaN は 0 になります.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct RGB9E5Traits
+{
+    static const uint32_t   Size = 4;
+    static const bool       Wide = true;
+    static const bool       SRGB = false;
+
+    static void Decode(const uint8_t* pSrc, float* pRGBA, uint32_t count)
+    {
+        uint32_t i = 0;
+    #if ASDX_KERNEL_X86
+        if (asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_SSE2)
+        { i = DecodeSSE2(pSrc, pRGBA, count); }
+    #endif
+
+        for(pSrc+=i * 4, pRGBA+=i * 4; i<count; ++i, pSrc+=4, pRGBA+=4)
+        {
+            uint32_t value;
+            memcpy(&value, pSrc, sizeof(value));
+
+            auto scale = ldexpf(1.0f, int(value >> 27) - (15 + 9));
+            pRGBA[0] = float((value >>  0) & 0x1FF) * scale;
+            pRGBA[1] = float((value >>  9) & 0x1FF) * scale;
+            pRGBA[2] = float((value >> 18) & 0x1FF) * scale;
+            pRGBA[3] = 1.0f;
+        }
+    }
+
+    static void Encode(const float* pRGBA, uint8_t* pDst, uint32_t count)
+    {
+        uint32_t i = 0;
+    #if ASDX_KERNEL_X86
+        if (asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_SSE2)
+        { i = EncodeSSE2(pRGBA, pDst, count); }
+    #endif
+
+        for(pRGBA+=i * 4, pDst+=i * 4; i<count; ++i, pRGBA+=4, pDst+=4)
+        {
+            auto value = Pack(pRGBA[0], pRGBA[1], pRGBA[2]);
+            memcpy(pDst, &value, sizeof(value));
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      RGB を R9G9B9E5 に変換します.
+    //---------------------------------------------------------------------------------------------
+    static uint32_t Pack(float r, float g, float b)
+    {
+        r = Clamp(r);
+        g = Clamp(g);
+        b = Clamp(b);
+        auto m = (r > g) ? ((r > b) ? r : b) : ((g > b) ? g : b);
+
+        // 共有指数は最大成分の指数から決める. 2^-16 未満は最小の指数にする.
+        auto n = (m > kRGB9E5Min) ? m : kRGB9E5Min;
+        uint32_t bits;
+        memcpy(&bits, &n, sizeof(bits));
+        auto e = int(bits >> 23) - 127 + 16;
+
+        // 丸めで仮数が512になったら指数を1つ上げる.
+        auto inv = ldexpf(1.0f, 24 - e);
+        if (uint32_t(m * inv + 0.5f) == 512)
+        {
+            e++;
+            inv *= 0.5f;
+        }
+
+        return (uint32_t(r * inv + 0.5f) <<  0)
+             | (uint32_t(g * inv + 0.5f) <<  9)
+             | (uint32_t(b * inv + 0.5f) << 18)
+             | (uint32_t(e) << 27);
+    }
+
+private:
+    static float Clamp(float value)
+    {
+        // NaN も 0 にする.
+        if (!(value > 0.0f))    { return 0.0f; }
+        if (value > kRGB9E5Max) { return kRGB9E5Max; }
+        return value;
+    }
+
+#if ASDX_KERNEL_X86
+    ASDX_TARGET_SSE2
+    static uint32_t DecodeSSE2(const uint8_t* pSrc, float* pRGBA, uint32_t count)
+    {
+        const __m128i mask = _mm_set1_epi32(0x1FF);
+
+        uint32_t i = 0;
+        for(; i + 4 <= count; i += 4, pSrc += 16, pRGBA += 16)
+        {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+
+            // 2^(e-24) は e = 0 でも正規化数なので，指数部を直接組み立てる.
+            auto s = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_srli_epi32(v, 27), _mm_set1_epi32(127 - 24)), 23));
+            auto r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(v, mask)), s);
+            auto g = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v,  9), mask)), s);
+            auto b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 18), mask)), s);
+            auto a = _mm_set1_ps(1.0f);
+
+            _MM_TRANSPOSE4_PS(r, g, b, a);
+            _mm_storeu_ps(pRGBA +  0, r);
+            _mm_storeu_ps(pRGBA +  4, g);
+            _mm_storeu_ps(pRGBA +  8, b);
+            _mm_storeu_ps(pRGBA + 12, a);
+        }
+
+        return i;
+    }
+
+    ASDX_TARGET_SSE2
+    static uint32_t EncodeSSE2(const float* pRGBA, uint8_t* pDst, uint32_t count)
+    {
+        const __m128  zero    = _mm_setzero_ps();
+        const __m128  maxVal  = _mm_set1_ps(kRGB9E5Max);
+        const __m128  minVal  = _mm_set1_ps(kRGB9E5Min);
+        const __m128  half    = _mm_set1_ps(0.5f);
+        const __m128i limit   = _mm_set1_epi32(512);
+
+        // 4ピクセルずつ成分ごとに並べ替えて，スカラー版と同じ手順で計算する.
+        uint32_t i = 0;
+        for(; i + 4 <= count; i += 4, pRGBA += 16, pDst += 16)
+        {
+            auto r = _mm_loadu_ps(pRGBA +  0);
+            auto g = _mm_loadu_ps(pRGBA +  4);
+            auto b = _mm_loadu_ps(pRGBA +  8);
+            auto a = _mm_loadu_ps(pRGBA + 12);
+            _MM_TRANSPOSE4_PS(r, g, b, a);
+
+            // max(x, 0) は NaN を 0 にする(第2引数が返るため).
+            r = _mm_min_ps(_mm_max_ps(r, zero), maxVal);
+            g = _mm_min_ps(_mm_max_ps(g, zero), maxVal);
+            b = _mm_min_ps(_mm_max_ps(b, zero), maxVal);
+            auto m = _mm_max_ps(_mm_max_ps(r, g), b);
+
+            auto e   = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(_mm_max_ps(m, minVal)), 23), _mm_set1_epi32(127 - 16));
+            auto inv = _mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(_mm_set1_epi32(127 + 24), e), 23));
+
+            // 丸めで仮数が512になったら指数を1つ上げる.
+            auto over = _mm_cmpeq_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(m, inv), half)), limit);
+            e   = _mm_sub_epi32(e, over);
+            inv = _mm_mul_ps(inv, _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(over), half), _mm_andnot_ps(_mm_castsi128_ps(over), _mm_set1_ps(1.0f))));
+
+            auto rm = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(r, inv), half));
+            auto gm = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(g, inv), half));
+            auto bm = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(b, inv), half));
+
+            auto v = _mm_or_si128(_mm_or_si128(rm, _mm_slli_epi32(gm, 9)), _mm_or_si128(_mm_slli_epi32(bm, 18), _mm_slli_epi32(e, 27)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst), v);
+        }
+
+        return i;
+    }
+#endif//ASDX_KERNEL_X86
+};
+
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R8_UNORM>             : GrayTraits<false> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R8G8_UNORM>           : GrayTraits<true> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R16_UNORM>            : Unorm16Traits<1> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R8G8B8_UNORM>         : Unorm8Traits<3, 0, 1, 2, 3, false> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_B8G8R8_UNORM>         : Unorm8Traits<3, 2, 1, 0, 3, false> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>       : Unorm8Traits<4, 0, 1, 2, 3, false> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R8G8B8A8_UNORM_SRGB>  : Unorm8Traits<4, 0, 1, 2, 3, true > {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_B8G8R8A8_UNORM>       : Unorm8Traits<4, 2, 1, 0, 3, false> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_B8G8R8A8_UNORM_SRGB>  : Unorm8Traits<4, 2, 1, 0, 3, true > {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_B8G8R8X8_UNORM>       : Unorm8Traits<4, 2, 1, 0, 4, false> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R16G16B16A16_UNORM>   : Unorm16Traits<4> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_B5G6R5_UNORM>         : Packed16Traits<11, 5, 5, 6, 0, 5,  0, 0> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_B5G5R5A1_UNORM>       : Packed16Traits<10, 5, 5, 5, 0, 5, 15, 1> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_B5G5R5X1_UNORM>       : Packed16Traits<10, 5, 5, 5, 0, 5, 15, 0> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_B4G4R4A4_UNORM>       : Packed16Traits< 8, 4, 4, 4, 0, 4, 12, 4> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R16G16B16A16_FLOAT>   : Float16Traits {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R32G32B32_FLOAT>      : Float32Traits<3> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R32G32B32A32_FLOAT>   : Float32Traits<4> {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R8G8B8E8_SHAREDEXP>   : RGBETraits {};
+template<> struct FormatTraits<asdx::PIXEL_FORMAT_R9G9B9E5_SHAREDEXP>   : RGB9E5Traits {};
+
+
+#if ASDX_KERNEL_X86
+//-------------------------------------------------------------------------------------------------
+//      RGBA8 を float4 に変換します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+uint32_t Unorm8ToFloatSSE2(const uint8_t* pSrc, float* pDst, uint32_t count)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128  scale = _mm_set1_ps(1.0f / 255.0f);
+
+    // 16byte(4ピクセル)を32bitに広げて変換する.
+    uint32_t i = 0;
+    for(; i + 16 <= count; i += 16, pSrc += 16, pDst += 16)
+    {
+        auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+        auto lo = _mm_unpacklo_epi8(v, zero);
+        auto hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(pDst +  0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+        _mm_storeu_ps(pDst +  4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+        _mm_storeu_ps(pDst +  8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+        _mm_storeu_ps(pDst + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+    }
+
+    return i;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      float4 を RGBA8 に変換します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+uint32_t FloatToUnorm8SSE2(const float* pSrc, uint8_t* pDst, uint32_t count)
+{
+    const __m128 zero  = _mm_setzero_ps();
+    const __m128 one   = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 half  = _mm_set1_ps(0.5f);
+
+    // max(x, 0) は NaN を 0 にする(第2引数が返るため).
+    uint32_t i = 0;
+    for(; i + 16 <= count; i += 16, pSrc += 16, pDst += 16)
+    {
+        __m128i v[4];
+        for(auto j=0; j<4; ++j)
+        {
+            auto x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pSrc + j * 4), zero), one);
+            v[j] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(x, scale), half));
+        }
+
+        auto lo = _mm_packs_epi32(v[0], v[1]);
+        auto hi = _mm_packs_epi32(v[2], v[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst), _mm_packus_epi16(lo, hi));
+    }
+
+    return i;
+}
+#endif//ASDX_KERNEL_X86
+
+//-------------------------------------------------------------------------------------------------
+//      float4 に変換します(8bitを超える精度のフォーマット).
+//-------------------------------------------------------------------------------------------------
+template<asdx::PIXEL_FORMAT Format>
+void DecodeFloat(const uint8_t* pSrc, float* pRGBA, uint32_t count, std::true_type)
+{ FormatTraits<Format>::Decode(pSrc, pRGBA, count); }
+
+//-------------------------------------------------------------------------------------------------
+//      float4 に変換します(8bit以下のフォーマット).
+//-------------------------------------------------------------------------------------------------
+template<asdx::PIXEL_FORMAT Format>
+void DecodeFloat(const uint8_t* pSrc, float* pRGBA, uint32_t count, std::false_type)
+{
+    typedef FormatTraits<Format> Traits;
+
+    uint8_t temp[kChunkPixels * 4];
+    Traits::Decode(pSrc, temp, count);
+
+    uint32_t i = 0;
+    if (Traits::SRGB)
+    {
+        auto pTable = GetSRGBTable().ToLinearF;
+        for(; i<count * 4; i+=4)
+        {
+            pRGBA[i + 0] = pTable[temp[i + 0]];
+            pRGBA[i + 1] = pTable[temp[i + 1]];
+            pRGBA[i + 2] = pTable[temp[i + 2]];
+            pRGBA[i + 3] = temp[i + 3] * (1.0f / 255.0f);
+        }
+        return;
+    }
+
+#if ASDX_KERNEL_X86
+    if (asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_SSE2)
+    { i = Unorm8ToFloatSSE2(temp, pRGBA, count * 4); }
+#endif
+
+    // SIMD版と結果を揃えるため逆数を乗算する.
+    for(; i<count * 4; ++i)
+    { pRGBA[i] = temp[i] * (1.0f / 255.0f); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      float4 から変換します(8bitを超える精度のフォーマット).
+//-------------------------------------------------------------------------------------------------
+template<asdx::PIXEL_FORMAT Format>
+void EncodeFloat(const float* pRGBA, uint8_t* pDst, uint32_t count, std::true_type)
+{ FormatTraits<Format>::Encode(pRGBA, pDst, count); }
+
+//-------------------------------------------------------------------------------------------------
+//      float4 から変換します(8bit以下のフォーマット).
+//-------------------------------------------------------------------------------------------------
+template<asdx::PIXEL_FORMAT Format>
+void EncodeFloat(const float* pRGBA, uint8_t* pDst, uint32_t count, std::false_type)
+{
+    typedef FormatTraits<Format> Traits;
+
+    uint8_t temp[kChunkPixels * 4];
+
+    uint32_t i = 0;
+    if (Traits::SRGB)
+    {
+        auto& table = GetSRGBTable();
+        for(; i<count * 4; i+=4)
+        {
+            temp[i + 0] = table.Encode(pRGBA[i + 0]);
+            temp[i + 1] = table.Encode(pRGBA[i + 1]);
+            temp[i + 2] = table.Encode(pRGBA[i + 2]);
+            temp[i + 3] = ToUnorm8(pRGBA[i + 3]);
+        }
+    }
+    else
+    {
+    #if ASDX_KERNEL_X86
+        if (asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_SSE2)
+        { i = FloatToUnorm8SSE2(pRGBA, temp, count * 4); }
+    #endif
+
+        for(; i<count * 4; ++i)
+        { temp[i] = ToUnorm8(pRGBA[i]); }
+    }
+
+    Traits::Encode(temp, pDst, count);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ConvertKernel structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<asdx::PIXEL_FORMAT Src, asdx::PIXEL_FORMAT Dst>
+struct ConvertKernel
+{
+    typedef FormatTraits<Src> SrcTraits;
+    typedef FormatTraits<Dst> DstTraits;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      1行分のピクセルを変換します.
+    //---------------------------------------------------------------------------------------------
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    {
+        // どちらかが8bitを超える精度を持つ場合は float4 を経由する.
+        typedef std::integral_constant<bool, SrcTraits::Wide || DstTraits::Wide> UseFloat;
+
+        while(count > 0)
+        {
+            auto n = (count < kChunkPixels) ? count : kChunkPixels;
+            RunChunk(pSrc, pDst, n, UseFloat());
+
+            pSrc  += n * SrcTraits::Size;
+            pDst  += n * DstTraits::Size;
+            count -= n;
+        }
+    }
+
+private:
+    //---------------------------------------------------------------------------------------------
+    //! @brief      RGBA8 を経由して変換します.
+    //---------------------------------------------------------------------------------------------
+    static void RunChunk(const uint8_t* pSrc, uint8_t* pDst, uint32_t count, std::false_type)
+    {
+        uint8_t temp[kChunkPixels * 4];
+        SrcTraits::Decode(pSrc, temp, count);
+
+        // 色空間が異なる場合はRGBだけテーブルで変換する.
+        if (SrcTraits::SRGB != DstTraits::SRGB)
+        {
+            auto& table  = GetSRGBTable();
+            auto  pTable = (DstTraits::SRGB) ? table.ToSRGB8 : table.ToLinear8;
+            for(uint32_t i=0; i<count * 4; i+=4)
+            {
+                temp[i + 0] = pTable[temp[i + 0]];
+                temp[i + 1] = pTable[temp[i + 1]];
+                temp[i + 2] = pTable[temp[i + 2]];
+            }
+        }
+
+        DstTraits::Encode(temp, pDst, count);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      float4 を経由して変換します.
+    //---------------------------------------------------------------------------------------------
+    static void RunChunk(const uint8_t* pSrc, uint8_t* pDst, uint32_t count, std::true_type)
+    {
+        float temp[kChunkPixels * 4];
+        DecodeFloat<Src>(pSrc, temp, count, std::integral_constant<bool, SrcTraits::Wide>());
+        EncodeFloat<Dst>(temp, pDst, count, std::integral_constant<bool, DstTraits::Wide>());
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+//  中間形式を経由せずにスウィズルだけで済む組み合わせです.
+//-------------------------------------------------------------------------------------------------
+template<>
+struct ConvertKernel<asdx::PIXEL_FORMAT_B8G8R8_UNORM, asdx::PIXEL_FORMAT_R8G8B8_UNORM>
+{
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    { asdx::SwizzleBGRToRGB(pSrc, pDst, count); }
+};
+
+template<>
+struct ConvertKernel<asdx::PIXEL_FORMAT_R8G8B8_UNORM, asdx::PIXEL_FORMAT_B8G8R8_UNORM>
+{
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    { asdx::SwizzleBGRToRGB(pSrc, pDst, count); }
+};
+
+template<>
+struct ConvertKernel<asdx::PIXEL_FORMAT_B8G8R8_UNORM, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>
+{
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    { asdx::SwizzleBGRToRGBA(pSrc, pDst, count); }
+};
+
+template<>
+struct ConvertKernel<asdx::PIXEL_FORMAT_B8G8R8A8_UNORM, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>
+{
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    { asdx::SwizzleBGRAToRGBA(pSrc, pDst, count); }
+};
+
+template<>
+struct ConvertKernel<asdx::PIXEL_FORMAT_R8G8B8A8_UNORM, asdx::PIXEL_FORMAT_B8G8R8A8_UNORM>
+{
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    { asdx::SwizzleBGRAToRGBA(pSrc, pDst, count); }
+};
+
+template<>
+struct ConvertKernel<asdx::PIXEL_FORMAT_B8G8R8A8_UNORM_SRGB, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM_SRGB>
+{
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    { asdx::SwizzleBGRAToRGBA(pSrc, pDst, count); }
+};
+
+template<>
+struct ConvertKernel<asdx::PIXEL_FORMAT_R8G8B8A8_UNORM_SRGB, asdx::PIXEL_FORMAT_B8G8R8A8_UNORM_SRGB>
+{
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    { asdx::SwizzleBGRAToRGBA(pSrc, pDst, count); }
+};
+
+template<>
+struct ConvertKernel<asdx::PIXEL_FORMAT_R8G8B8A8_UNORM, asdx::PIXEL_FORMAT_R32G32B32A32_FLOAT>
+{
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    {
+        auto pOut = reinterpret_cast<float*>(pDst);
+        uint32_t i = 0;
+    #if ASDX_KERNEL_X86
+        if (asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_SSE2)
+        { i = Unorm8ToFloatSSE2(pSrc, pOut, count * 4); }
+    #endif
+        for(; i<count * 4; ++i)
+        { pOut[i] = pSrc[i] * (1.0f / 255.0f); }
+    }
+};
+
+template<>
+struct ConvertKernel<asdx::PIXEL_FORMAT_R32G32B32A32_FLOAT, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>
+{
+    static void Run(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+    {
+        auto pIn = reinterpret_cast<const float*>(pSrc);
+        uint32_t i = 0;
+    #if ASDX_KERNEL_X86
+        if (asdx::GetSimdLevel() >= asdx::SIMD_LEVEL_SSE2)
+        { i = FloatToUnorm8SSE2(pIn, pDst, count * 4); }
+    #endif
+        for(; i<count * 4; ++i)
+        { pDst[i] = ToUnorm8(pIn[i]); }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CONVERT_TABLE structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CONVERT_TABLE
+{
+    ConvertRowFunc  Func[kFormatCount][kFormatCount];   //!< [変換元 - 1][変換先 - 1] の変換関数です.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    CONVERT_TABLE()
+    { FillTable(std::make_index_sequence<kFormatCount>()); }
+
+private:
+    template<size_t... S>
+    void FillTable(std::index_sequence<S...>)
+    {
+        const int dummy[] = { (FillRow<asdx::PIXEL_FORMAT(S + 1)>(Func[S], std::make_index_sequence<kFormatCount>()), 0)... };
+        (void)dummy;
+    }
+
+    template<asdx::PIXEL_FORMAT Src, size_t... D>
+    static void FillRow(ConvertRowFunc* pRow, std::index_sequence<D...>)
+    {
+        const ConvertRowFunc funcs[] = { &ConvertKernel<Src, asdx::PIXEL_FORMAT(D + 1)>::Run... };
+        for(size_t i=0; i<kFormatCount; ++i)
+        { pRow[i] = funcs[i]; }
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+//      変換関数テーブルを取得します.
+//-------------------------------------------------------------------------------------------------
+const CONVERT_TABLE& GetConvertTable()
+{
+    static const CONVERT_TABLE s_Table;
+    return s_Table;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      有効なフォーマットかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+inline bool IsValidFormat(asdx::PIXEL_FORMAT format)
+{ return asdx::PIXEL_FORMAT_UNKNOWN < format && format < asdx::PIXEL_FORMAT_COUNT; }
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//      1ピクセルあたりのバイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GetPixelFormatSize(PIXEL_FORMAT format)
+{
+    switch(format)
+    {
+    case PIXEL_FORMAT_R8_UNORM:             return FormatTraits<PIXEL_FORMAT_R8_UNORM>::Size;
+    case PIXEL_FORMAT_R8G8_UNORM:           return FormatTraits<PIXEL_FORMAT_R8G8_UNORM>::Size;
+    case PIXEL_FORMAT_R16_UNORM:            return FormatTraits<PIXEL_FORMAT_R16_UNORM>::Size;
+    case PIXEL_FORMAT_R8G8B8_UNORM:         return FormatTraits<PIXEL_FORMAT_R8G8B8_UNORM>::Size;
+    case PIXEL_FORMAT_B8G8R8_UNORM:         return FormatTraits<PIXEL_FORMAT_B8G8R8_UNORM>::Size;
+    case PIXEL_FORMAT_R8G8B8A8_UNORM:       return FormatTraits<PIXEL_FORMAT_R8G8B8A8_UNORM>::Size;
+    case PIXEL_FORMAT_R8G8B8A8_UNORM_SRGB:  return FormatTraits<PIXEL_FORMAT_R8G8B8A8_UNORM_SRGB>::Size;
+    case PIXEL_FORMAT_B8G8R8A8_UNORM:       return FormatTraits<PIXEL_FORMAT_B8G8R8A8_UNORM>::Size;
+    case PIXEL_FORMAT_B8G8R8A8_UNORM_SRGB:  return FormatTraits<PIXEL_FORMAT_B8G8R8A8_UNORM_SRGB>::Size;
+    case PIXEL_FORMAT_B8G8R8X8_UNORM:       return FormatTraits<PIXEL_FORMAT_B8G8R8X8_UNORM>::Size;
+    case PIXEL_FORMAT_R16G16B16A16_UNORM:   return FormatTraits<PIXEL_FORMAT_R16G16B16A16_UNORM>::Size;
+    case PIXEL_FORMAT_B5G6R5_UNORM:         return FormatTraits<PIXEL_FORMAT_B5G6R5_UNORM>::Size;
+    case PIXEL_FORMAT_B5G5R5A1_UNORM:       return FormatTraits<PIXEL_FORMAT_B5G5R5A1_UNORM>::Size;
+    case PIXEL_FORMAT_B5G5R5X1_UNORM:       return FormatTraits<PIXEL_FORMAT_B5G5R5X1_UNORM>::Size;
+    case PIXEL_FORMAT_B4G4R4A4_UNORM:       return FormatTraits<PIXEL_FORMAT_B4G4R4A4_UNORM>::Size;
+    case PIXEL_FORMAT_R16G16B16A16_FLOAT:   return FormatTraits<PIXEL_FORMAT_R16G16B16A16_FLOAT>::Size;
+    case PIXEL_FORMAT_R32G32B32_FLOAT:      return FormatTraits<PIXEL_FORMAT_R32G32B32_FLOAT>::Size;
+    case PIXEL_FORMAT_R32G32B32A32_FLOAT:   return FormatTraits<PIXEL_FORMAT_R32G32B32A32_FLOAT>::Size;
+    case PIXEL_FORMAT_R8G8B8E8_SHAREDEXP:   return FormatTraits<PIXEL_FORMAT_R8G8B8E8_SHAREDEXP>::Size;
+    case PIXEL_FORMAT_R9G9B9E5_SHAREDEXP:   return FormatTraits<PIXEL_FORMAT_R9G9B9E5_SHAREDEXP>::Size;
+    default:                                return 0;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DXGIフォーマットに対応するピクセルフォーマットを取得します.
+//-------------------------------------------------------------------------------------------------
+PIXEL_FORMAT GetPixelFormatFromDXGI(uint32_t dxgiFormat)
+{
+    switch(dxgiFormat)
+    {
+    case DXGI_FORMAT_R8_UNORM:              return PIXEL_FORMAT_R8_UNORM;
+    case DXGI_FORMAT_R8G8_UNORM:            return PIXEL_FORMAT_R8G8_UNORM;
+    case DXGI_FORMAT_R16_UNORM:             return PIXEL_FORMAT_R16_UNORM;
+    case DXGI_FORMAT_R8G8B8A8_UNORM:        return PIXEL_FORMAT_R8G8B8A8_UNORM;
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:   return PIXEL_FORMAT_R8G8B8A8_UNORM_SRGB;
+    case DXGI_FORMAT_B8G8R8A8_UNORM:        return PIXEL_FORMAT_B8G8R8A8_UNORM;
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:   return PIXEL_FORMAT_B8G8R8A8_UNORM_SRGB;
+    case DXGI_FORMAT_B8G8R8X8_UNORM:        return PIXEL_FORMAT_B8G8R8X8_UNORM;
+    case DXGI_FORMAT_R16G16B16A16_UNORM:    return PIXEL_FORMAT_R16G16B16A16_UNORM;
+    case DXGI_FORMAT_B5G6R5_UNORM:          return PIXEL_FORMAT_B5G6R5_UNORM;
+    case DXGI_FORMAT_B5G5R5A1_UNORM:        return PIXEL_FORMAT_B5G5R5A1_UNORM;
+    case DXGI_FORMAT_B4G4R4A4_UNORM:        return PIXEL_FORMAT_B4G4R4A4_UNORM;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:    return PIXEL_FORMAT_R16G16B16A16_FLOAT;
+    case DXGI_FORMAT_R32G32B32_FLOAT:       return PIXEL_FORMAT_R32G32B32_FLOAT;
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:    return PIXEL_FORMAT_R32G32B32A32_FLOAT;
+    case DXGI_FORMAT_R9G9B9E5_SHAREDEXP:    return PIXEL_FORMAT_R9G9B9E5_SHAREDEXP;
+    default:                                return PIXEL_FORMAT_UNKNOWN;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ピクセルフォーマットを変換します.
+//-------------------------------------------------------------------------------------------------
+bool ConvertPixels
+(
+    const void*     pSrc,
+    PIXEL_FORMAT    srcFormat,
+    void*           pDst,
+    PIXEL_FORMAT    dstFormat,
+    uint32_t        width,
+    uint32_t        height,
+    uint32_t        srcPitch,
+    uint32_t        dstPitch
+)
+{
+    if (pSrc == nullptr || pDst == nullptr || !IsValidFormat(srcFormat) || !IsValidFormat(dstFormat))
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto srcRowSize = width * GetPixelFormatSize(srcFormat);
+    auto dstRowSize = width * GetPixelFormatSize(dstFormat);
+
+    if (srcPitch == 0)
+    { srcPitch = srcRowSize; }
+
+    if (dstPitch == 0)
+    { dstPitch = dstRowSize; }
+
+    if (srcPitch < srcRowSize || dstPitch < dstRowSize)
+    {
+        ELOG("Error : Invalid Pitch. srcPitch = %u, dstPitch = %u", srcPitch, dstPitch);
+        return false;
+    }
+
+    if (width == 0 || height == 0)
+    { return true; }
+
+    auto pSrcBytes = static_cast<const uint8_t*>(pSrc);
+    auto pDstBytes = static_cast<uint8_t*>(pDst);
+
+    // 同じフォーマットならコピーするだけ.
+    if (srcFormat == dstFormat)
+    {
+        if (srcPitch == dstPitch)
+        {
+            if (pSrcBytes != pDstBytes)
+            { memmove(pDstBytes, pSrcBytes, size_t(srcPitch) * (height - 1) + srcRowSize); }
+            return true;
+        }
+
+        for(uint32_t y=0; y<height; ++y)
+        { memmove(pDstBytes + size_t(dstPitch) * y, pSrcBytes + size_t(srcPitch) * y, srcRowSize); }
+        return true;
+    }
+
+    auto func = GetConvertTable().Func[srcFormat - 1][dstFormat - 1];
+
+    auto convertRows = [=](uint32_t begin, uint32_t end)
+    {
+        for(auto y=begin; y<end; ++y)
+        { func(pSrcBytes + size_t(srcPitch) * y, pDstBytes + size_t(dstPitch) * y, width); }
+    };
+
+    // 小さな画像(ランレングスのパケットなど)はスレッドを起こさずに変換する.
+    if (uint64_t(width) * height < kParallelPixels)
+    {
+        convertRows(0, height);
+        return true;
+    }
+
+    auto minRows = kParallelPixels / width;
+    ParallelFor(height, (minRows > 0) ? minRows : 1, convertRows);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      変換による誤差を計測します.
+//-------------------------------------------------------------------------------------------------
+bool MeasureConversionError
+(
+    const void*         pReference,
+    PIXEL_FORMAT        referenceFormat,
+    const void*         pResult,
+    PIXEL_FORMAT        resultFormat,
+    uint32_t            width,
+    uint32_t            height,
+    CONVERSION_ERROR&   result,
+    uint32_t            referencePitch,
+    uint32_t            resultPitch
+)
+{
+    if (pReference == nullptr || pResult == nullptr || !IsValidFormat(referenceFormat) || !IsValidFormat(resultFormat))
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    if (referencePitch == 0)
+    { referencePitch = width * GetPixelFormatSize(referenceFormat); }
+
+    if (resultPitch == 0)
+    { resultPitch = width * GetPixelFormatSize(resultFormat); }
+
+    auto& table     = GetConvertTable();
+    auto  toFloat   = PIXEL_FORMAT_R32G32B32A32_FLOAT - 1;
+    auto  refFunc   = table.Func[referenceFormat - 1][toFloat];
+    auto  resFunc   = table.Func[resultFormat    - 1][toFloat];
+    auto  refSize   = GetPixelFormatSize(referenceFormat);
+    auto  resSize   = GetPixelFormatSize(resultFormat);
+
+    double   sumRel  = 0.0;
+    double   sumSq   = 0.0;
+    uint64_t samples = 0;
+
+    result.MaxAbsError = 0.0f;
+    result.MaxRelError = 0.0f;
+
+    float ref[kChunkPixels * 4];
+    float res[kChunkPixels * 4];
+
+    for(uint32_t y=0; y<height; ++y)
+    {
+        auto pRefRow = static_cast<const uint8_t*>(pReference) + size_t(referencePitch) * y;
+        auto pResRow = static_cast<const uint8_t*>(pResult)    + size_t(resultPitch)    * y;
+
+        for(uint32_t x=0; x<width; x+=kChunkPixels)
+        {
+            auto n = (width - x < kChunkPixels) ? width - x : kChunkPixels;
+
+            // 同じフォーマットは変換関数がないので直接コピーする.
+            if (referenceFormat == PIXEL_FORMAT_R32G32B32A32_FLOAT)
+            { memcpy(ref, pRefRow + x * refSize, n * 16); }
+            else
+            { refFunc(pRefRow + x * refSize, reinterpret_cast<uint8_t*>(ref), n); }
+
+            if (resultFormat == PIXEL_FORMAT_R32G32B32A32_FLOAT)
+            { memcpy(res, pResRow + x * resSize, n * 16); }
+            else
+            { resFunc(pResRow + x * resSize, reinterpret_cast<uint8_t*>(res), n); }
+
+            for(uint32_t i=0; i<n; ++i)
+            {
+                float maxAbs = 0.0f;
+                float maxRef = 0.0f;
+                for(uint32_t c=0; c<3; ++c)
+                {
+                    auto diff = fabsf(ref[i * 4 + c] - res[i * 4 + c]);
+                    auto mag  = fabsf(ref[i * 4 + c]);
+                    maxAbs = (diff > maxAbs) ? diff : maxAbs;
+                    maxRef = (mag  > maxRef) ? mag  : maxRef;
+                    sumSq += double(diff) * diff;
+                }
+
+                // 相対誤差はピクセルの最大成分を基準にする. 共有指数形式では小さい成分の精度は最大成分で決まるため.
+                auto rel = (maxRef > 0.0f) ? maxAbs / maxRef : ((maxAbs > 0.0f) ? 1.0f : 0.0f);
+
+                result.MaxAbsError = (maxAbs > result.MaxAbsError) ? maxAbs : result.MaxAbsError;
+                result.MaxRelError = (rel    > result.MaxRelError) ? rel    : result.MaxRelError;
+                sumRel += rel;
+                samples++;
+            }
+        }
+    }
+
+    result.MeanRelError = (samples > 0) ? float(sumRel / double(samples)) : 0.0f;
+    result.RMSError     = (samples > 0) ? float(sqrt(sumSq / double(samples * 3))) : 0.0f;
+
+    return true;
+}
+
+} // namespace asdx
@@ -9,12 +9,19 @@
 //-------------------------------------------------------------------------------------------------
 #include <asdxTexture.h>
 #include <asdxLogger.h>
+#include <asdxMappedFile.h>
+#include <asdxPixelKernel.h>
+#include <asdxPixelConvert.h>
+#include <asdxBCDecoder.h>
 #include <dxgiformat.h>
 #include <wincodec.h>
 #include <wrl/client.h>
 #include <cassert>
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <algorithm>
 
 
@@ -40,6 +47,7 @@ using Microsoft::WRL::ComPtr;
 //static const uint32_t MAX_TEXTURE_SIZE = 4096;   // D3D_FEATURE_LEVEL_9_3
 //static const uint32_t MAX_TEXTURE_SIZE = 8192;   // D3D_FEATURE_LEVEL_10_0, D3D_FEATURE_LEVEL_10_1
 static const uint32_t MAX_TEXTURE_SIZE = 16384;  // D3D_FEATURE_LEVEL_11_0
+static const uint32_t TGA_MAX_COLORMAP_ENTRY = 256;  // Targaカラーマップの最大エントリー数.
 
 // dwFlags Value
 static const unsigned int DDSD_CAPS         = 0x00000001;   // dwCaps/dwCaps2が有効.
@@ -101,6 +109,16 @@ static const unsigned int FOURCC_A32B32G32R32F  = 0x00000074;
 static const unsigned int FOURCC_CxV8U8         = 0x00000075;
 static const unsigned int FOURCC_Q8W8V8U8       = 0x0000003f;
 
+// DX10 Extended Header Value
+static const unsigned int DDS_DIMENSION_TEXTURE2D           = 3;            // 2次元テクスチャ(配列・キューブマップを含む).
+static const unsigned int DDS_DIMENSION_TEXTURE3D           = 4;            // 3次元テクスチャ.
+static const unsigned int DDS_RESOURCE_MISC_TEXTURECUBE     = 0x00000004;   // キューブマップの場合.
+static const unsigned int DDS_MAX_ARRAY_SIZE                = 2048;         // D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION
+
+// Cooked Texture Value
+static const uint32_t COOKED_TEXTURE_VERSION    = 1;        // クックドテクスチャのバージョン.
+static const uint32_t COOKED_TEXTURE_ALIGNMENT  = 256;      // サブリソースの配置アラインメント(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT).
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // NATIVE_TEXTURE_FORMAT enum
@@ -127,6 +145,8 @@ enum NATIVE_TEXTURE_FORMAT
     NATIVE_TEXTURE_FORMAT_R32_FLOAT,
     NATIVE_TEXTURE_FORMAT_G32R32_FLOAT,
     NATIVE_TEXTURE_FORMAT_A32B32G32R32_FLOAT,
+    NATIVE_TEXTURE_FORMAT_BC6H,
+    NATIVE_TEXTURE_FORMAT_BC7,
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -200,6 +220,56 @@ typedef struct __DDSurfaceDesc
 } DDSurfaceDesc;
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DDSHeaderDX10 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct __DDSHeaderDX10
+{
+    unsigned int    dxgiFormat;
+    unsigned int    resourceDimension;
+    unsigned int    miscFlag;
+    unsigned int    arraySize;
+    unsigned int    miscFlags2;
+} DDSHeaderDX10;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// COOKED_TEXTURE_HEADER structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct COOKED_TEXTURE_HEADER
+{
+    uint8_t     Magic[4];           //!< 'A', 'T', 'E', 'X' です.
+    uint32_t    Version;            //!< バージョンです.
+    uint32_t    Width;              //!< 横幅です.
+    uint32_t    Height;             //!< 縦幅です.
+    uint32_t    Depth;              //!< 奥行です.
+    uint32_t    Format;             //!< DXGIフォーマットです.
+    uint32_t    MipMapCount;        //!< ミップマップ数です.
+    uint32_t    SurfaceCount;       //!< サーフェイス数です.
+    uint32_t    Option;             //!< オプションフラグです.
+    uint32_t    SubResourceCount;   //!< サブリソース数です.
+    uint64_t    DataOffset;         //!< ピクセルデータの先頭までのオフセットです.
+    uint64_t    FileSize;           //!< ファイルサイズです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// COOKED_SUBRESOURCE structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct COOKED_SUBRESOURCE
+{
+    uint32_t    Width;              //!< 横幅です.
+    uint32_t    Height;             //!< 縦幅です.
+    uint32_t    Pitch;              //!< 1行当たりのバイト数です.
+    uint32_t    SlicePitch;         //!< 1スライス当たりのバイト数です.
+    uint32_t    Depth;              //!< スライス数です.
+    uint32_t    Reserved;           //!< 予約領域です.
+    uint64_t    Offset;             //!< ファイル先頭からのオフセットです(COOKED_TEXTURE_ALIGNMENT の倍数).
+};
+
+static_assert( sizeof(COOKED_TEXTURE_HEADER) == 56, "Invalid COOKED_TEXTURE_HEADER size." );
+static_assert( sizeof(COOKED_SUBRESOURCE)    == 32, "Invalid COOKED_SUBRESOURCE size." );
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // WIC Pixel Format Translation Data
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -401,12 +471,9 @@ static WICConvert g_WICCustomConvert[] = {
 #endif
 
 //-------------------------------------------------------------------------------------------------
-static IWICImagingFactory* GetWIC()
+static IWICImagingFactory* CreateWIC()
 {
-    static IWICImagingFactory* s_Factory = nullptr;
-
-    if ( s_Factory )
-        return s_Factory;
+    IWICImagingFactory* pFactory = nullptr;
 
   #if(_WIN32_WINNT >= _WIN32_WINNT_WIN8) || defined(_WIN7_PLATFORM_UPDATE)
     HRESULT hr = CoCreateInstance(
@@ -414,7 +481,7 @@ static IWICImagingFactory* GetWIC()
         nullptr,
         CLSCTX_INPROC_SERVER,
         __uuidof(IWICImagingFactory2),
-        (LPVOID*)&s_Factory
+        (LPVOID*)&pFactory
         );
 
     if ( SUCCEEDED(hr) )
@@ -429,12 +496,11 @@ static IWICImagingFactory* GetWIC()
             nullptr,
             CLSCTX_INPROC_SERVER,
             __uuidof(IWICImagingFactory),
-            (LPVOID*)&s_Factory
+            (LPVOID*)&pFactory
             );
 
         if ( FAILED(hr) )
         {
-            s_Factory = nullptr;
             return nullptr;
         }
     }
@@ -444,16 +510,23 @@ static IWICImagingFactory* GetWIC()
         nullptr,
         CLSCTX_INPROC_SERVER,
         __uuidof(IWICImagingFactory),
-        (LPVOID*)&s_Factory
+        (LPVOID*)&pFactory
         );
 
     if ( FAILED(hr) )
     {
-        s_Factory = nullptr;
         return nullptr;
     }
   #endif
 
+    return pFactory;
+}
+
+//-------------------------------------------------------------------------------------------------
+static IWICImagingFactory* GetWIC()
+{
+    // 読み込みキューのワーカーから同時に呼ばれても一度だけ生成されるように，関数内静的変数の初期化で生成する.
+    static IWICImagingFactory* s_Factory = CreateWIC();
     return s_Factory;
 }
 
@@ -539,6 +612,101 @@ static DXGI_FORMAT MakeSRGB( _In_ DXGI_FORMAT format )
 }
 
 
+//-------------------------------------------------------------------------------------------------
+//! @brief      WICのピクセルフォーマットから，変換先のピクセルフォーマットとDXGIフォーマットを決定します.
+//!
+//! @param[in]      pixelFormat     デコーダのピクセルフォーマットです.
+//! @param[out]     convertGUID     変換先のピクセルフォーマットです. 変換が不要な場合は pixelFormat と同じになります.
+//! @param[out]     format          DXGIフォーマットです.
+//! @param[out]     bpp             変換先の1ピクセルあたりのビット数です.
+//! @retval true    決定に成功.
+//! @retval false   対応しないピクセルフォーマットです.
+//-------------------------------------------------------------------------------------------------
+static bool ResolveWICFormat
+(
+    const WICPixelFormatGUID&   pixelFormat,
+    WICPixelFormatGUID&         convertGUID,
+    DXGI_FORMAT&                format,
+    size_t&                     bpp
+)
+{
+    memcpy( &convertGUID, &pixelFormat, sizeof(WICPixelFormatGUID) );
+
+    bpp    = 0;
+    format = WICToDXGI( pixelFormat );
+    if ( format == DXGI_FORMAT_UNKNOWN )
+    {
+        if ( memcmp( &GUID_WICPixelFormat96bppRGBFixedPoint, &pixelFormat, sizeof(WICPixelFormatGUID) ) == 0 )
+        {
+        #if (_WIN32_WINNT >= _WIN32_WINNT_WIN8) || defined(_WIN7_PLATFORM_UPDATE)
+            if ( g_WIC2 )
+            {
+                memcpy( &convertGUID, &GUID_WICPixelFormat96bppRGBFloat, sizeof(WICPixelFormatGUID) );
+                format = DXGI_FORMAT_R32G32B32_FLOAT;
+            }
+            else
+        #endif
+            {
+                memcpy( &convertGUID, &GUID_WICPixelFormat128bppRGBAFloat, sizeof(WICPixelFormatGUID) );
+                format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+            }
+        }
+        else
+        {
+            for( size_t i=0; i < _countof(g_WICConvert); ++i )
+            {
+                if ( memcmp( &g_WICConvert[i].source, &pixelFormat, sizeof(WICPixelFormatGUID) ) == 0 )
+                {
+                    memcpy( &convertGUID, &g_WICConvert[i].target, sizeof(WICPixelFormatGUID) );
+
+                    format = WICToDXGI( g_WICConvert[i].target );
+                    assert( format != DXGI_FORMAT_UNKNOWN );
+                    bpp = WICBitsPerPixel( convertGUID );
+                    break;
+                }
+            }
+        }
+
+        if ( format == DXGI_FORMAT_UNKNOWN )
+        { return false; }
+    }
+#if 1
+    // Viewerアプリ用の専用処理.
+    //  テクスチャフェッチをした結果が正しくなるようにチャンネル数を4チャンネルにする.
+    else if ( format == DXGI_FORMAT_R8_UNORM
+           || format == DXGI_FORMAT_A8_UNORM
+           || format == DXGI_FORMAT_R16_UNORM
+           || format == DXGI_FORMAT_R16_FLOAT
+           || format == DXGI_FORMAT_R32_FLOAT )
+    {
+        for( size_t i=0; i < _countof(g_WICCustomConvert); ++i )
+        {
+            if ( memcmp( &g_WICCustomConvert[i].source, &pixelFormat, sizeof(WICPixelFormatGUID) ) == 0 )
+            {
+                memcpy( &convertGUID, &g_WICCustomConvert[i].target, sizeof(WICPixelFormatGUID) );
+
+                format = WICToDXGI( g_WICCustomConvert[i].target );
+                assert( format != DXGI_FORMAT_UNKNOWN );
+                bpp = WICBitsPerPixel( convertGUID );
+                break;
+            }
+        }
+
+        if ( format == DXGI_FORMAT_UNKNOWN )
+        { return false; }
+    }
+#endif
+    else
+    {
+        bpp = WICBitsPerPixel( pixelFormat );
+    }
+
+    if ( !bpp )
+    { return false; }
+
+    return true;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      マスクをチェックします.
 //-------------------------------------------------------------------------------------------------
@@ -583,6 +751,8 @@ size_t GetBitPerPixel( unsigned int format )
     case NATIVE_TEXTURE_FORMAT_BC3:
     case NATIVE_TEXTURE_FORMAT_BC5U:
     case NATIVE_TEXTURE_FORMAT_BC5S:
+    case NATIVE_TEXTURE_FORMAT_BC6H:
+    case NATIVE_TEXTURE_FORMAT_BC7:
         { return 8; }
 
     case NATIVE_TEXTURE_FORMAT_R16_FLOAT:
@@ -632,1283 +802,858 @@ std::wstring ToStringW( const std::string& value )
 }
 
 //-------------------------------------------------------------------------------------------------
-//      ファイルパスから拡張子を取得します.
+//! @brief      ピクセル変換関数です.
+//!
+//! @param[in]      pSrc        変換元ピクセルです.
+//! @param[in]      pColorMap   RGBA形式に展開済みのカラーマップです.
+//! @param[out]     pDst        変換先ピクセルです.
+//! @param[in]      count       ピクセル数です.
 //-------------------------------------------------------------------------------------------------
-std::wstring GetExtW( const wchar_t* filePath )
-{
-    std::wstring path = filePath;
-    size_t idx = path.find_last_of( L"." );
-    if ( idx != std::wstring::npos )
-    {
-        std::wstring result = path.substr( idx + 1 );
-
-        // 小文字化.
-        std::transform( result.begin(), result.end(), result.begin(), tolower );
-
-        return result;
-    }
-
-    return std::wstring();
-}
+typedef void (*ConvertPixelFunc)( const uint8_t* pSrc, const uint32_t* pColorMap, uint8_t* pDst, uint32_t count );
 
 //-------------------------------------------------------------------------------------------------
-//      ファイルパスから拡張子を取得します.
+//! @brief      8Bitインデックスカラーを変換します.
 //-------------------------------------------------------------------------------------------------
-std::string GetExtA( const char* filePath )
-{
-    std::string path = filePath;
-    size_t idx = path.find_last_of( "." );
-    if ( idx != std::string::npos )
-    {
-        std::string result = path.substr( idx + 1 );
-
-        // 小文字化.
-        std::transform( result.begin(), result.end(), result.begin(), tolower );
-
-        return result;
-    }
-
-    return std::string();
-}
+void Convert8Bits( const uint8_t* pSrc, const uint32_t* pColorMap, uint8_t* pDst, uint32_t count )
+{ asdx::ExpandPaletteRGBA( pSrc, pColorMap, pDst, count ); }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      8Bitインデックスカラー形式を解析します.
-//!
-//! @param[in]      pColorMap       カラーマップです.
+//! @brief      ピクセルフォーマットを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse8Bits( FILE* pFile, uint32_t size, uint8_t* pColorMap, uint8_t* pPixels )
-{
-    uint8_t color = 0;
-    for( uint32_t i=0; i<size; ++i )
-    {
-        color = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 2 ] = pColorMap[ color * 3 + 0 ];
-        pPixels[ i * 4 + 1 ] = pColorMap[ color * 3 + 1 ];
-        pPixels[ i * 4 + 0 ] = pColorMap[ color * 3 + 2 ];
-        pPixels[ i * 4 + 3 ] = 255;
-    }
-}
+template<asdx::PIXEL_FORMAT SrcFormat, asdx::PIXEL_FORMAT DstFormat>
+void ConvertFormat( const uint8_t* pSrc, const uint32_t*, uint8_t* pDst, uint32_t count )
+{ asdx::ConvertPixels( pSrc, SrcFormat, pDst, DstFormat, count, 1 ); }
 
-//-------------------------------------------------------------------------------------------------
-//! @brief      16Bitフルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TGA_RLE_STATE structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TGA_RLE_STATE
 {
-    for( uint32_t i=0; i<size; ++i )
-    {
-        uint16_t color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
-        pPixels[ i * 4 + 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-        pPixels[ i * 4 + 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-        pPixels[ i * 4 + 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-        pPixels[ i * 4 + 3 ] = 255;
-    }
-}
+    uint32_t    Remain;         //!< 展開途中のパケットの残りピクセル数です.
+    bool        Repeat;         //!< 展開途中のパケットがランかどうか.
+    uint8_t     Value[ 4 ];     //!< ランの変換済みピクセルです.
+};
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      24Bitフルカラー形式を解析します.
+//! @brief      Targaのピクセルデータ解析関数です.
+//!
+//! @param[in,out]  pSrc        読み込み位置です. 解析後は消費したバイト数だけ進みます.
+//! @param[in]      pEnd        読み込み可能な終端です.
+//! @param[in]      count       ピクセル数です.
+//! @param[in]      pColorMap   RGBA形式に展開済みのカラーマップです.
+//! @param[out]     pDst        出力先です.
+//! @param[in,out]  state       RLEパケットの展開状態です. 分割して解析する場合は同じものを渡し続けます.
+//! @retval true    解析に成功.
+//! @retval false   データが不足しています.
 //-------------------------------------------------------------------------------------------------
-void Parse24Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    for( uint32_t i=0; i<size; ++i )
-    {
-        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = 255;
-    }
-}
+typedef bool (*TGAParseFunc)( const uint8_t*& pSrc, const uint8_t* pEnd, uint32_t count, const uint32_t* pColorMap, uint8_t* pDst, TGA_RLE_STATE& state );
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      32Bitフルカラー形式を解析します.
+//! @brief      非圧縮ピクセルデータを解析します.
 //-------------------------------------------------------------------------------------------------
-void Parse32Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
+template<uint32_t SrcBytes, uint32_t DstBytes, ConvertPixelFunc Convert>
+bool ParseRaw( const uint8_t*& pSrc, const uint8_t* pEnd, uint32_t count, const uint32_t* pColorMap, uint8_t* pDst, TGA_RLE_STATE& )
 {
-    for( uint32_t i=0; i<size; ++i )
-    {
-        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = (uint8_t)fgetc( pFile );
-    }
-}
+    if ( size_t( pEnd - pSrc ) < size_t( count ) * SrcBytes )
+    { return false; }
 
-//-------------------------------------------------------------------------------------------------
-//! @brief     8Bitグレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse8BitsGrayScale( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    for( uint32_t i=0; i<size; ++i )
-    {
-        pPixels[ i ] = (uint8_t)fgetc( pFile );
-    }
-}
+    Convert( pSrc, pColorMap, pDst, count );
+    pSrc += size_t( count ) * SrcBytes;
 
-//-------------------------------------------------------------------------------------------------
-//! @brief      16Bitグレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16BitsGrayScale( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    for( uint32_t i=0; i<size; ++i )
-    {
-        pPixels[ i * 2 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 2 + 1 ] = (uint8_t)fgetc( pFile );
-    }
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮インデックスカラー形式を解析します.
-//!
-//! @param[in]  pColorMap       カラーマップです.
+//! @brief      RLE圧縮ピクセルデータを解析します.
+//!             パケットは行をまたげるので，途中で止めた場合は展開状態に残りを記録して次の呼び出しで続きを展開します.
 //-------------------------------------------------------------------------------------------------
-void Parse8BitsRLE( FILE* pFile, uint8_t* pColorMap, uint32_t size, uint8_t* pPixels )
+template<uint32_t SrcBytes, uint32_t DstBytes, ConvertPixelFunc Convert>
+bool ParseRLE( const uint8_t*& pSrc, const uint8_t* pEnd, uint32_t count, const uint32_t* pColorMap, uint8_t* pDst, TGA_RLE_STATE& state )
 {
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixels;
+    static_assert( DstBytes <= sizeof(state.Value), "Invalid Pixel Size." );
 
-    while( ptr < pPixels + size )   // size = width * height * 3.
+    uint32_t i = 0;
+    while( i < count )
     {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
+        if ( state.Remain == 0 )
         {
-            color = (uint8_t)fgetc( pFile );
+            if ( pSrc >= pEnd )
+            { return false; }
 
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-                ptr[ 3 ] = 255;
-            }
-        }
-        else
-        {
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
+            uint8_t header = *pSrc++;
+            state.Remain = 1 + ( header & 0x7F );
+            state.Repeat = ( header & 0x80 ) != 0;
+
+            if ( state.Repeat )
             {
-                color = (uint8_t)fgetc( pFile );
+                if ( size_t( pEnd - pSrc ) < SrcBytes )
+                { return false; }
 
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-                ptr[ 3 ] = 255;
+                // 1ピクセルだけ変換しておき，ランを展開する.
+                Convert( pSrc, pColorMap, state.Value, 1 );
+                pSrc += SrcBytes;
             }
         }
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮フルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    uint32_t count  = 0;
-    uint16_t color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixels;
 
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+        // 出力先を越えないようにする. 残りは次の呼び出しで展開する.
+        uint32_t length = state.Remain;
+        if ( length > count - i )
+        { length = count - i; }
 
-        if ( header & 0x80 )
+        if ( state.Repeat )
         {
-            color = fgetc( pFile ) + ( fgetc( pFile ) << 8 ); 
-
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-                ptr[ 3 ] = 255;
-            }
+            asdx::FillPixels( pDst, state.Value, DstBytes, length );
         }
         else
         {
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
+            if ( size_t( pEnd - pSrc ) < size_t( length ) * SrcBytes )
+            { return false; }
 
-                ptr[ 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-                ptr[ 3 ] = 255;
-            }
+            Convert( pSrc, pColorMap, pDst, length );
+            pSrc += length * SrcBytes;
         }
+
+        pDst         += length * DstBytes;
+        i            += length;
+        state.Remain -= length;
     }
+
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      24BitRLE圧縮フルカラー形式を解析します.
+//! @brief      カラーマップをRGBA形式に展開します.
+//!
+//! @param[in]      header      ヘッダです.
+//! @param[in]      pSrc        カラーマップの先頭です.
+//! @param[out]     pColorMap   展開先(TGA_MAX_COLORMAP_ENTRY エントリー)です.
+//! @retval true    展開に成功.
+//! @retval false   未対応のエントリーサイズです.
 //-------------------------------------------------------------------------------------------------
-void Parse24BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
+bool ExpandColorMap( const TGA_HEADER& header, const uint8_t* pSrc, uint32_t* pColorMap )
 {
-    uint32_t count    = 0;
-    uint8_t  color[3] = { 0, 0, 0 };
-    uint8_t  header   = 0;
-    uint8_t* ptr      = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 3.
+    asdx::PIXEL_FORMAT format = asdx::PIXEL_FORMAT_UNKNOWN;
+    switch( header.ColorMapEntrySize )
     {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+    case 15:
+    case 16: { format = asdx::PIXEL_FORMAT_B5G5R5X1_UNORM; } break;
+    case 24: { format = asdx::PIXEL_FORMAT_B8G8R8_UNORM; } break;
+    case 32: { format = asdx::PIXEL_FORMAT_B8G8R8A8_UNORM; } break;
+    default: { return false; }
+    }
 
-        if ( header & 0x80 )
-        {
-            fread( color, sizeof(uint8_t), 3, pFile );
+    auto first = uint32_t( header.ColorMapEntry );
+    if ( first >= TGA_MAX_COLORMAP_ENTRY )
+    { return true; }
 
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-                ptr[ 3 ] = 255;
-            }
-        }
-        else
-        {
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 2 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 3 ] = 255;
-            }
-        }
-    }
+    auto count = uint32_t( header.ColorMapLength );
+    if ( count > TGA_MAX_COLORMAP_ENTRY - first )
+    { count = TGA_MAX_COLORMAP_ENTRY - first; }
+
+    return asdx::ConvertPixels( pSrc, format, pColorMap + first, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM, count, 1 );
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      32BitRLE圧縮フルカラー形式を解析します.
+//! @brief      Targaファイルかどうかチェックします.
+//!
+//! @param[in]      pBinary         バイナリデータです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @retval true    Targaファイルです.
+//! @retval false   Targaファイルではありません.
 //-------------------------------------------------------------------------------------------------
-void Parse32BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
+bool IsTGA( const uint8_t* pBinary, size_t bufferSize )
 {
-    uint32_t count    = 0;
-    uint8_t  color[4] = { 0, 0, 0, 0 };
-    uint8_t  header   = 0;
-    uint8_t* ptr      = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 4.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+    if ( pBinary == nullptr || bufferSize < sizeof(TGA_HEADER) + sizeof(TGA_FOOTER) )
+    { return false; }
 
-        if ( header & 0x80 )
-        {
-            fread( color, sizeof(uint8_t), 4, pFile );
+    TGA_FOOTER footer;
+    memcpy( &footer, pBinary + bufferSize - sizeof(footer), sizeof(footer) );
 
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-                ptr[ 3 ] = color[ 3 ];
-            }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 2 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 3 ] = (uint8_t)fgetc( pFile );
-            }
-        }
-    }
+    return memcmp( footer.Tag, "TRUEVISION-XFILE.", sizeof(footer.Tag) ) == 0;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TGA_DECODER structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TGA_DECODER
+{
+    uint32_t        Width;                                  //!< 横幅です.
+    uint32_t        Height;                                 //!< 縦幅です.
+    DXGI_FORMAT     Format;                                 //!< 展開後のフォーマットです.
+    uint32_t        BytePerPixel;                           //!< 展開後の1ピクセルあたりのバイト数です.
+    const uint8_t*  pSrc;                                   //!< ピクセルデータの先頭です.
+    const uint8_t*  pEnd;                                   //!< ピクセルデータの読み込み可能な終端です.
+    TGAParseFunc    Parse;                                  //!< ピクセルデータの解析関数です.
+    uint32_t        ColorMap[ TGA_MAX_COLORMAP_ENTRY ];     //!< RGBA形式に展開済みのカラーマップです.
+};
+
 //-------------------------------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮グレースケール形式を解析します.
+//! @brief      Targaファイルのヘッダとカラーマップを解析して，ピクセルデータの展開方法を決定します.
+//!
+//! @param[in]      pBinary         Targaファイルのバイナリです. IsTGA() で確認済みである必要があります.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @param[out]     decoder         展開方法の設定先です.
+//! @retval true    解析に成功.
+//! @retval false   解析に失敗.
 //-------------------------------------------------------------------------------------------------
-void Parse8BitsGrayScaleRLE( FILE* pFile, uint32_t size, uint8_t* pPixles )
+bool SetupTGADecoder( const uint8_t* pBinary, size_t bufferSize, TGA_DECODER& decoder )
 {
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixles;
+    // 拡張データ・ディベロッパーエリアは使用しない.
+    /* NOT IMPLEMENT */
 
-    while( ptr < pPixles + size ) // size = width * height
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+    // フッター手前までを読み込み範囲とする.
+    const uint8_t* pEnd = pBinary + bufferSize - sizeof(TGA_FOOTER);
 
-        if ( header & 0x80 )
-        {
-            color = (uint8_t)fgetc( pFile );
+    // ヘッダデータを読み込む.
+    TGA_HEADER header;
+    memcpy( &header, pBinary, sizeof(header) );
 
-            for( uint32_t i=0; i<count; ++i, ptr++ )
-            { (*ptr) = color; }
-        }
-        else
+    // フォーマット判定.
+    switch( header.Format )
+    {
+    // 該当なし.
+    case TGA_FORMAT_NONE:
         {
-            for( uint32_t i=0; i<count; ++i, ptr++ )
-            { (*ptr) = (uint8_t)fgetc( pFile ); }
+            ELOG( "Error : Invalid Format." );
+            return false;
         }
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮グレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16BitsGrayScaleRLE( FILE* pFile, uint32_t size, uint8_t* pPixles )
-{
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  alpha  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixles;
-
-    while( ptr < pPixles + size ) // size = width * height * 2
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+        break;
 
-        if ( header & 0x80 )
+    // グレースケール
+    case TGA_FORMAT_GRAYSCALE:
+    case TGA_FORMAT_RLE_GRAYSCALE:
         {
-            color = (uint8_t)fgetc( pFile );
-            alpha = (uint8_t)fgetc( pFile );
-
-            for( uint32_t i=0; i<count; ++i, ptr+=2 )
+            if ( header.BitPerPixel == 8 )
             {
-                ptr[ 0 ] = color;
-                ptr[ 1 ] = alpha;
+                decoder.BytePerPixel = 1;
+                decoder.Format       = DXGI_FORMAT_R8_UNORM;
             }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr+=2 )
+            else
             {
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
+                // 輝度 + アルファ.
+                decoder.BytePerPixel = 2;
+                decoder.Format       = DXGI_FORMAT_R8G8_UNORM;
             }
         }
-    }
-}
-
-} // namespace /* anonymous */
-
-
-namespace asdx {
+        break;
 
-//-------------------------------------------------------------------------------------------------
-//      ダミーのリソーステクスチャを生成します.
-//-------------------------------------------------------------------------------------------------
-bool CreateDummyResTexture( asdx::ResTexture& resTexture )
-{
-    resTexture.pResources = new(std::nothrow) asdx::SubResource[1];
-    if ( !resTexture.pResources )
-    { return false; }
+    // カラー.
+    // RGBのみはテクスチャがサポートされないので，強制的にRGBAにする.
+    case TGA_FORMAT_INDEXCOLOR:
+    case TGA_FORMAT_FULLCOLOR:
+    case TGA_FORMAT_RLE_INDEXCOLOR:
+    case TGA_FORMAT_RLE_FULLCOLOR:
+        {
+            decoder.BytePerPixel = 4;
+            decoder.Format       = DXGI_FORMAT_R8G8B8A8_UNORM;
+        }
+        break;
 
-    resTexture.pResources[0].pPixels = new (std::nothrow) uint8_t [ 4096 ];
-    if ( !resTexture.pResources[0].pPixels )
-    {
-        SafeDeleteArray( resTexture.pResources );
-        return false;
+    // 上記以外.
+    default:
+        {
+            ELOG( "Error : Unsupported Format." );
+            return false;
+        }
+        break;
     }
 
-    // リソーステクスチャの設定.
-    resTexture.Width        = 32;
-    resTexture.Height       = 32;
-    resTexture.Depth        = 0;
-    resTexture.Format       = uint32_t( DXGI_FORMAT_R8G8B8A8_UNORM );
-    resTexture.MipMapCount  = 1;
-    resTexture.SurfaceCount = 1;
-
-    // サブリソースの設定.
-    resTexture.pResources[0].Width      = 32;
-    resTexture.pResources[0].Height     = 32;
-    resTexture.pResources[0].Pitch      = 128;
-    resTexture.pResources[0].SlicePitch = 4096;
-    memset( resTexture.pResources[0].pPixels, 255, sizeof(uint8_t) * 4096 );
-
-    return true;
-}
-
-//-------------------------------------------------------------------------------------------------
-//      WICからリソーステクスチャを生成します.
-//      (BMP, JPEG, PNG, TIFF, GIF, HD Photoファイルからリソーステクスチャを生成します).
-//-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromWICFileW( const wchar_t* filename, asdx::ResTexture& resTexture )
-{
-    bool forceSRGB = true;
-
-    if ( filename == nullptr )
-    { return false; }
-
-    IWICImagingFactory* pWIC = GetWIC();
-    if ( !pWIC )
-    { return false; }
-
-    // WICの初期化.
-    ComPtr<IWICBitmapDecoder> decoder;
-    HRESULT hr = pWIC->CreateDecoderFromFilename( filename, 0, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf() );
-    if ( FAILED( hr ) )
-    { return false; }
-
-    ComPtr<IWICBitmapFrameDecode> frame;
-    hr = decoder->GetFrame( 0, frame.GetAddressOf() );
-    if ( FAILED( hr ) )
-    { return false; }
-
-    uint32_t width  = 0;
-    uint32_t height = 0;
-    hr = frame->GetSize( &width, &height );
-    if ( FAILED( hr ) )
-    { return false; }
-
-    assert( width > 0 && height > 0 );
-
-    uint32_t origWidth  = width;
-    uint32_t origHeight = height;
+    // IDフィールドサイズ分だけオフセットを移動させる.
+    const uint8_t* pSrc = pBinary + sizeof(header) + header.IdFieldLength;
 
-    if ( width  > MAX_TEXTURE_SIZE
-      || height > MAX_TEXTURE_SIZE )
+    // カラーマップを持つかチェック.
+    memset( decoder.ColorMap, 0, sizeof(decoder.ColorMap) );
+    if ( header.HasColorMap )
     {
-        float ar = float( height ) / float( width );
-        if ( width > height )
+        // カラーマップサイズを算出.
+        size_t colorMapSize = header.ColorMapLength * ( ( header.ColorMapEntrySize + 7 ) >> 3 );
+        if ( pSrc > pEnd || size_t( pEnd - pSrc ) < colorMapSize )
         {
-            width  = MAX_TEXTURE_SIZE;
-            height = uint32_t( float( MAX_TEXTURE_SIZE ) * ar );
+            ELOG( "Error : Invalid File Format." );
+            return false;
         }
-        else
+
+        // RGBA形式に展開しておく.
+        if ( !ExpandColorMap( header, pSrc, decoder.ColorMap ) )
         {
-            width = uint32_t( float( MAX_TEXTURE_SIZE ) / ar );
-            height = MAX_TEXTURE_SIZE;
+            ELOG( "Error : Unsupported ColorMap Entry Size. size = %u", header.ColorMapEntrySize );
+            return false;
         }
-    }
 
-    WICPixelFormatGUID pixelFormat;
-    hr = frame->GetPixelFormat( &pixelFormat );
-    if ( FAILED( hr ) )
-    { return false; }
+        pSrc += colorMapSize;
+    }
 
-    WICPixelFormatGUID convertGUID;
-    memcpy( &convertGUID, &pixelFormat, sizeof(WICPixelFormatGUID) );
+    if ( pSrc > pEnd )
+    {
+        ELOG( "Error : Invalid File Format." );
+        return false;
+    }
 
-    size_t bpp = 0;
-    DXGI_FORMAT format = WICToDXGI( pixelFormat );
-    if ( format == DXGI_FORMAT_UNKNOWN )
+    // フォーマットに合わせて解析関数を決定する.
+    TGAParseFunc parse = nullptr;
+    switch( header.Format )
     {
-        if ( memcmp( &GUID_WICPixelFormat96bppRGBFixedPoint, &pixelFormat, sizeof(WICPixelFormatGUID) ) == 0 )
+    // パレット.
+    case TGA_FORMAT_INDEXCOLOR:
         {
-        #if (_WIN32_WINNT >= _WIN32_WINNT_WIN8) || defined(_WIN7_PLATFORM_UPDATE)
-            if ( g_WIC2 )
+            if ( header.BitPerPixel == 8 )
+            { parse = ParseRaw<1, 4, Convert8Bits>; }
+        }
+        break;
+
+    // フルカラー.
+    case TGA_FORMAT_FULLCOLOR:
+        {
+            switch( header.BitPerPixel )
             {
-                memcpy( &convertGUID, &GUID_WICPixelFormat96bppRGBFloat, sizeof(WICPixelFormatGUID) );
-                format = DXGI_FORMAT_R32G32B32_FLOAT;
+            case 16: { parse = ParseRaw<2, 4, ConvertFormat<asdx::PIXEL_FORMAT_B5G5R5X1_UNORM, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>>; } break;
+            case 24: { parse = ParseRaw<3, 4, ConvertFormat<asdx::PIXEL_FORMAT_B8G8R8_UNORM, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>>; } break;
+            case 32: { parse = ParseRaw<4, 4, ConvertFormat<asdx::PIXEL_FORMAT_B8G8R8A8_UNORM, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>>; } break;
             }
-            else
-        #endif
+        }
+        break;
+
+    // グレースケール.
+    case TGA_FORMAT_GRAYSCALE:
+        {
+            switch( header.BitPerPixel )
             {
-                memcpy( &convertGUID, &GUID_WICPixelFormat128bppRGBAFloat, sizeof(WICPixelFormatGUID) );
-                format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+            case 8:  { parse = ParseRaw<1, 1, ConvertFormat<asdx::PIXEL_FORMAT_R8_UNORM, asdx::PIXEL_FORMAT_R8_UNORM>>;  } break;
+            case 16: { parse = ParseRaw<2, 2, ConvertFormat<asdx::PIXEL_FORMAT_R8G8_UNORM, asdx::PIXEL_FORMAT_R8G8_UNORM>>; } break;
             }
         }
-        else
+        break;
+
+    // パレットRLE圧縮.
+    case TGA_FORMAT_RLE_INDEXCOLOR:
         {
-            for( size_t i=0; i < _countof(g_WICConvert); ++i )
-            {
-                if ( memcmp( &g_WICConvert[i].source, &pixelFormat, sizeof(WICPixelFormatGUID) ) == 0 )
-                {
-                    memcpy( &convertGUID, &g_WICConvert[i].target, sizeof(WICPixelFormatGUID) );
+            if ( header.BitPerPixel == 8 )
+            { parse = ParseRLE<1, 4, Convert8Bits>; }
+        }
+        break;
 
-                    format = WICToDXGI( g_WICConvert[i].target );
-                    assert( format != DXGI_FORMAT_UNKNOWN );
-                    bpp = WICBitsPerPixel( convertGUID );
-                    break;
-                }
+    // フルカラーRLE圧縮.
+    case TGA_FORMAT_RLE_FULLCOLOR:
+        {
+            switch( header.BitPerPixel )
+            {
+            case 16: { parse = ParseRLE<2, 4, ConvertFormat<asdx::PIXEL_FORMAT_B5G5R5X1_UNORM, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>>; } break;
+            case 24: { parse = ParseRLE<3, 4, ConvertFormat<asdx::PIXEL_FORMAT_B8G8R8_UNORM, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>>; } break;
+            case 32: { parse = ParseRLE<4, 4, ConvertFormat<asdx::PIXEL_FORMAT_B8G8R8A8_UNORM, asdx::PIXEL_FORMAT_R8G8B8A8_UNORM>>; } break;
             }
         }
+        break;
 
-        if ( format == DXGI_FORMAT_UNKNOWN )
-        { return false; }
-    }
-#if 1
-    // Viewerアプリ用の専用処理.
-    //  テクスチャフェッチをした結果が正しくなるようにチャンネル数を4チャンネルにする.
-    else if ( format == DXGI_FORMAT_R8_UNORM
-           || format == DXGI_FORMAT_A8_UNORM
-           || format == DXGI_FORMAT_R16_UNORM
-           || format == DXGI_FORMAT_R16_FLOAT
-           || format == DXGI_FORMAT_R32_FLOAT )
-    {
-        for( size_t i=0; i < _countof(g_WICCustomConvert); ++i )
+    // グレースケールRLE圧縮.
+    case TGA_FORMAT_RLE_GRAYSCALE:
         {
-            if ( memcmp( &g_WICCustomConvert[i].source, &pixelFormat, sizeof(WICPixelFormatGUID) ) == 0 )
+            switch( header.BitPerPixel )
             {
-                memcpy( &convertGUID, &g_WICCustomConvert[i].target, sizeof(WICPixelFormatGUID) );
-
-                format = WICToDXGI( g_WICCustomConvert[i].target );
-                assert( format != DXGI_FORMAT_UNKNOWN );
-                bpp = WICBitsPerPixel( convertGUID );
-                break;
+            case 8:  { parse = ParseRLE<1, 1, ConvertFormat<asdx::PIXEL_FORMAT_R8_UNORM, asdx::PIXEL_FORMAT_R8_UNORM>>;  } break;
+            case 16: { parse = ParseRLE<2, 2, ConvertFormat<asdx::PIXEL_FORMAT_R8G8_UNORM, asdx::PIXEL_FORMAT_R8G8_UNORM>>; } break;
             }
         }
+        break;
+    }
 
-        if ( format == DXGI_FORMAT_UNKNOWN )
+    if ( parse == nullptr )
+    {
+        ELOG( "Error : Unsupported Bit Per Pixel. bitPerPixel = %u", header.BitPerPixel );
+        return false;
+    }
+
+    decoder.Width  = header.Width;
+    decoder.Height = header.Height;
+    decoder.pSrc   = pSrc;
+    decoder.pEnd   = pEnd;
+    decoder.Parse  = parse;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      DDSファイルかどうかチェックします.
+//!
+//! @param[in]      pBinary         バイナリデータです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @retval true    DDSファイルです.
+//! @retval false   DDSファイルではありません.
+//-------------------------------------------------------------------------------------------------
+bool IsDDS( const uint8_t* pBinary, size_t bufferSize )
+{
+    return ( pBinary != nullptr )
+        && ( bufferSize >= 4 )
+        && ( pBinary[0] == 'D' )
+        && ( pBinary[1] == 'D' )
+        && ( pBinary[2] == 'S' )
+        && ( pBinary[3] == ' ' );
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ブロック圧縮フォーマットかどうかチェックします.
+//!
+//! @param[in]      nativeFormat    ネイティブフォーマットです.
+//! @retval true    ブロック圧縮フォーマットです.
+//! @retval false   ブロック圧縮フォーマットではありません.
+//-------------------------------------------------------------------------------------------------
+bool IsBlockCompression( uint32_t nativeFormat )
+{
+    switch( nativeFormat )
+    {
+    case NATIVE_TEXTURE_FORMAT_BC1:
+    case NATIVE_TEXTURE_FORMAT_BC2:
+    case NATIVE_TEXTURE_FORMAT_BC3:
+    case NATIVE_TEXTURE_FORMAT_BC4U:
+    case NATIVE_TEXTURE_FORMAT_BC4S:
+    case NATIVE_TEXTURE_FORMAT_BC5U:
+    case NATIVE_TEXTURE_FORMAT_BC5S:
+    case NATIVE_TEXTURE_FORMAT_BC6H:
+    case NATIVE_TEXTURE_FORMAT_BC7:
+        { return true; }
+
+    default:
         { return false; }
     }
-#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      サーフェイスのサイズ情報を取得します.
+//!
+//! @param[in]      w               横幅です.
+//! @param[in]      h               縦幅です.
+//! @param[in]      nativeFormat    ネイティブフォーマットです.
+//! @param[out]     rowBytes        1行当たりのバイト数です.
+//! @param[out]     numRows         行数です.
+//-------------------------------------------------------------------------------------------------
+void GetSurfaceInfo( size_t w, size_t h, uint32_t nativeFormat, size_t& rowBytes, size_t& numRows )
+{
+    // ブロック圧縮フォーマットの場合.
+    if ( IsBlockCompression( nativeFormat ) )
+    {
+        // BC1, BC4 は8byte/block, それ以外は16byte/block.
+        size_t bcPerBlock = ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC1
+                           || nativeFormat == NATIVE_TEXTURE_FORMAT_BC4U
+                           || nativeFormat == NATIVE_TEXTURE_FORMAT_BC4S ) ? 8 : 16;
+
+        rowBytes = Max< size_t >( 1, ( w + 3 ) / 4 ) * bcPerBlock;
+        numRows  = Max< size_t >( 1, ( h + 3 ) / 4 );
+    }
+    // ブロック圧縮フォーマット以外の場合.
     else
     {
-        bpp = WICBitsPerPixel( pixelFormat );
+        rowBytes = ( w * GetBitPerPixel( nativeFormat ) + 7 ) / 8;
+        numRows  = h;
     }
+}
 
-    if ( !bpp )
-    { return false; }
+//-------------------------------------------------------------------------------------------------
+//! @brief      ミップレベルの奥行を取得します.
+//!
+//! @param[in]      depth           最上位ミップレベルの奥行です.
+//! @param[in]      mip             ミップレベルです.
+//! @return     ミップレベルの奥行を返却します(最低1).
+//-------------------------------------------------------------------------------------------------
+uint32_t GetMipDepth( uint32_t depth, uint32_t mip )
+{ return ( mip < 32 ) ? Max< uint32_t >( 1, depth >> mip ) : 1; }
 
-    // Handle sRGB formats
-    if ( forceSRGB )
+//-------------------------------------------------------------------------------------------------
+//! @brief      ミップマップ数の上限を取得します.
+//!
+//! @param[in]      width           最上位ミップレベルの横幅です.
+//! @param[in]      height          最上位ミップレベルの縦幅です.
+//! @param[in]      depth           最上位ミップレベルの奥行です(ボリュームテクスチャ以外は0).
+//! @return     1x1x1 になるまでのミップレベル数(log2(最大辺)+1)を返却します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GetMaxMipMapCount( uint32_t width, uint32_t height, uint32_t depth )
+{
+    auto size  = Max< uint32_t >( Max< uint32_t >( width, height ), depth );
+    auto count = 1u;
+    while( size > 1 )
     {
-        format = MakeSRGB( format );
+        size >>= 1;
+        count++;
     }
-    else
+    return count;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      DXGIフォーマットに対応するネイティブフォーマットを取得します.
+//!
+//! @param[in]      format          DXGIフォーマットです.
+//! @param[out]     nativeFormat    ネイティブフォーマットです.
+//! @retval true    DX10拡張ヘッダで読み書きできるフォーマットです.
+//! @retval false   未対応のフォーマットです.
+//! @note       ピクセルデータはDXGIフォーマットの並びのまま扱うので，並び替えが不要なものを返却します.
+//-------------------------------------------------------------------------------------------------
+bool GetNativeFormatFromDXGI( uint32_t format, uint32_t& nativeFormat )
+{
+    switch( format )
     {
-        ComPtr<IWICMetadataQueryReader> metareader;
-        if ( SUCCEEDED( frame->GetMetadataQueryReader( metareader.GetAddressOf() ) ) )
-        {
-            GUID containerFormat;
-            if ( SUCCEEDED( metareader->GetContainerFormat( &containerFormat ) ) )
-            {
-                // Check for sRGB colorspace metadata
-                bool sRGB = false;
+    case DXGI_FORMAT_R8G8B8A8_TYPELESS:
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8A8_TYPELESS:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_ABGR_8888; }
+        break;
 
-                PROPVARIANT value;
-                PropVariantInit( &value );
+    case DXGI_FORMAT_R8_TYPELESS:
+    case DXGI_FORMAT_R8_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_R8; }
+        break;
 
-                if ( memcmp( &containerFormat, &GUID_ContainerFormatPng, sizeof(GUID) ) == 0 )
-                {
-                    // Check for sRGB chunk
-                    if ( SUCCEEDED( metareader->GetMetadataByName( L"/sRGB/RenderingIntent", &value ) ) && value.vt == VT_UI1 )
-                    {
-                        sRGB = true;
-                    }
-                }
-                else if ( SUCCEEDED( metareader->GetMetadataByName( L"System.Image.ColorSpace", &value ) ) && value.vt == VT_UI2 && value.uiVal == 1 )
-                {
-                    sRGB = true;
-                }
-
-                PropVariantClear( &value );
+    case DXGI_FORMAT_A8_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_A8; }
+        break;
 
-                if ( sRGB )
-                { format = MakeSRGB( format ); }
-            }
-        }
-    }
+    case DXGI_FORMAT_BC1_TYPELESS:
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC1; }
+        break;
 
-    // １行当たりのバイト数.
-    size_t rowPitch = ( width * bpp + 7 ) / 8;
+    case DXGI_FORMAT_BC2_TYPELESS:
+    case DXGI_FORMAT_BC2_UNORM:
+    case DXGI_FORMAT_BC2_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC2; }
+        break;
 
-    // ピクセルデータのサイズ.
-    size_t imageSize = rowPitch * height;
+    case DXGI_FORMAT_BC3_TYPELESS:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC3; }
+        break;
 
-    // ピクセルデータのメモリを確保.
-    uint8_t* pPixels = new (std::nothrow) uint8_t [ imageSize ];
-    if ( !pPixels )
-    { return false; }
+    case DXGI_FORMAT_BC4_TYPELESS:
+    case DXGI_FORMAT_BC4_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC4U; }
+        break;
 
-    // 元サイズと同じ場合.
-    if ( 0 == memcmp( &convertGUID, &pixelFormat, sizeof(GUID) )
-      && width  == origWidth
-      && height == origHeight )
-    {
-        hr = frame->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
-    }
-    else if ( width != origWidth
-          || height != origHeight )
-    {
-        // リサイズ処理.
+    case DXGI_FORMAT_BC4_SNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC4S; }
+        break;
 
-        ComPtr<IWICBitmapScaler> scaler;
-        hr = pWIC->CreateBitmapScaler( scaler.GetAddressOf() );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
+    case DXGI_FORMAT_BC5_TYPELESS:
+    case DXGI_FORMAT_BC5_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC5U; }
+        break;
 
-        hr = scaler->Initialize( frame.Get(), width, height, WICBitmapInterpolationModeFant );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
+    case DXGI_FORMAT_BC5_SNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC5S; }
+        break;
 
-        WICPixelFormatGUID pfScalar;
-        hr = scaler->GetPixelFormat( &pfScalar );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
+    case DXGI_FORMAT_BC6H_TYPELESS:
+    case DXGI_FORMAT_BC6H_UF16:
+    case DXGI_FORMAT_BC6H_SF16:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC6H; }
+        break;
 
-        if ( 0 == memcmp( &convertGUID, &pfScalar, sizeof(GUID) ) )
-        {
-            hr = scaler->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
-            if ( FAILED( hr ) )
-            {
-                SafeDeleteArray( pPixels );
-                return false;
-            }
-        }
-        else
-        {
-            ComPtr<IWICFormatConverter> conv;
-            hr =  pWIC->CreateFormatConverter( conv.GetAddressOf() );
-            if ( FAILED( hr ) )
-            {
-                SafeDeleteArray( pPixels );
-                return false;
-            }
+    case DXGI_FORMAT_BC7_TYPELESS:
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC7; }
+        break;
 
-            hr = conv->Initialize( scaler.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom );
-            if ( FAILED( hr ) )
-            {
-                SafeDeleteArray( pPixels );
-                return false;
-            }
+    case DXGI_FORMAT_R16_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_R16_FLOAT; }
+        break;
 
-            hr = conv->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
-            if ( FAILED( hr ) )
-            {
-                SafeDeleteArray( pPixels );
-                return false;
-            }
-        }
-    }
-    else
-    {
-        // フォーマットのみが違う場合.
+    case DXGI_FORMAT_R16G16_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_G16R16_FLOAT; }
+        break;
 
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_A16B16G16R16_FLOAT; }
+        break;
 
-        ComPtr<IWICFormatConverter> conv;
-        hr = pWIC->CreateFormatConverter( conv.GetAddressOf() );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
+    case DXGI_FORMAT_R32_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_R32_FLOAT; }
+        break;
 
-        hr = conv->Initialize( frame.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
+    case DXGI_FORMAT_R32G32_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_G32R32_FLOAT; }
+        break;
 
-        hr = conv->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
-    }
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_A32B32G32R32_FLOAT; }
+        break;
 
-    // サブリソースのメモリを確保.
-    asdx::SubResource* pRes = new (std::nothrow) asdx::SubResource();
-    if ( !pRes )
-    {
-        SafeDeleteArray( pPixels );
-        return false;
+    default:
+        { return false; }
     }
 
-    // サブリソースを設定.
-    pRes->Width      = width;
-    pRes->Height     = height;
-    pRes->Pitch      = uint32_t( rowPitch );
-    pRes->SlicePitch = uint32_t( imageSize );
-    pRes->pPixels    = pPixels;
-
-    // リソーステクスチャを設定.
-    resTexture.Width        = width;
-    resTexture.Height       = height;
-    resTexture.Depth        = 0;
-    resTexture.Format       = uint32_t( format );
-    resTexture.MipMapCount  = 1;
-    resTexture.SurfaceCount = 1;
-    resTexture.pResources   = pRes;
-
-    // 正常終了.
     return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-//      WICからリソーステクスチャを生成します.
-//      (BMP, JPEG, PNG, TIFF, GIF, HD Photoファイルからリソーステクスチャを生成します).
-//-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromWICFileA( const char* filename, asdx::ResTexture& resTexture )
-{
-    auto path = ToStringW(filename);
-    return CreateResTextureFromWICFileW(path.c_str(), resTexture);
-}
-
-//-------------------------------------------------------------------------------------------------
-//      WICからリソーステクスチャを生成します.
-//      (BMP, JPEG, PNG, TIFF, GIF, HD Photoファイルからリソーステクスチャを生成します).
+//! @brief      DDSファイルのヘッダを解析します.
+//!
+//! @param[in]      pBinary         DDSファイルのバイナリです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @param[out]     resTexture      テクスチャの情報の設定先です. サブリソースは設定しません.
+//! @param[out]     nativeFormat    ネイティブフォーマットです.
+//! @param[out]     dataOffset      ピクセルデータまでのオフセットです.
+//! @retval true    解析に成功.
+//! @retval false   解析に失敗.
 //-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromWICMemory( const uint8_t* pBinary, const uint32_t bufferSize, asdx::ResTexture& resTexture )
+bool ParseDDSHeader
+(
+    const uint8_t*      pBinary,
+    size_t              bufferSize,
+    asdx::ResTexture&   resTexture,
+    uint32_t&           nativeFormat,
+    size_t&             dataOffset
+)
 {
-    bool forceSRGB = true;
+    uint32_t width  = 0;
+    uint32_t height = 0;
+    uint32_t depth  = 0;
 
-    if ( pBinary == nullptr )
-    { return false; }
+    if ( pBinary == nullptr || bufferSize < 4 + sizeof(DDSurfaceDesc) )
+    {
+        ELOG( "Error : Out of Range." );
+        return false;
+    }
 
-    IWICImagingFactory* pWIC = GetWIC();
-    if ( !pWIC )
-    { return false; }
+    // マジックをチェック.
+    if ( ( pBinary[0] != 'D' )
+      || ( pBinary[1] != 'D' )
+      || ( pBinary[2] != 'S' )
+      || ( pBinary[3] != ' ' ) )
+    {
+        ELOG( "Error : Invalid File. " );
+        return false;
+    }
 
-    ComPtr<IWICStream> pStream;
-    HRESULT hr = pWIC->CreateStream( &pStream );
-    if ( FAILED( hr ) )
-    { return false; }
+    // アライメントが揃っているとは限らないのでコピーしておく.
+    DDSurfaceDesc ddsd;
+    memcpy( &ddsd, pBinary + 4, sizeof(ddsd) );
+    dataOffset = 4 + sizeof(ddsd);
 
-    hr = pStream->InitializeFromMemory( (BYTE*)pBinary, bufferSize );
-    if ( FAILED( hr ) )
-    { return false; }
+    // 高さ有効.
+    if ( ddsd.flags & DDSD_HEIGHT )
+    { height = ddsd.height; }
 
-    // WICの初期化.
-    ComPtr<IWICBitmapDecoder> decoder;
-    hr = pWIC->CreateDecoderFromStream( pStream.Get(), 0, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf() );
-    if ( FAILED( hr ) )
-    { return false; }
+    // 幅有効.
+    if ( ddsd.flags & DDSD_WIDTH )
+    { width = ddsd.width; }
 
-    ComPtr<IWICBitmapFrameDecode> frame;
-    hr = decoder->GetFrame( 0, frame.GetAddressOf() );
-    if ( FAILED( hr ) )
-    { return false; }
+    // 奥行有効.
+    if ( ddsd.flags & DDSD_DEPTH )
+    { depth = ddsd.depth; }
 
-    uint32_t width  = 0;
-    uint32_t height = 0;
-    hr = frame->GetSize( &width, &height );
-    if ( FAILED( hr ) )
-    { return false; }
+    resTexture.Width        = width;
+    resTexture.Height       = height;
+    resTexture.Depth        = 0;
+    resTexture.SurfaceCount = 1;
+    resTexture.MipMapCount  = 1;
+    resTexture.Option       = 0;
 
-    assert( width > 0 && height > 0 );
+    // ミップマップ数.有効
+    if ( ddsd.flags & DDSD_MIPMAPCOUNT )
+    { resTexture.MipMapCount = ddsd.mipMapLevels; }
 
-    uint32_t origWidth  = width;
-    uint32_t origHeight = height;
+    // 0が入っているファイルもあるので最低1にしておく.
+    if ( resTexture.MipMapCount == 0 )
+    { resTexture.MipMapCount = 1; }
 
-    if ( width  > MAX_TEXTURE_SIZE
-      || height > MAX_TEXTURE_SIZE )
+    // キューブマップとボリュームテクスチャのチェック.
+    if ( ddsd.caps & DDSCAPS_COMPLEX )
     {
-        float ar = float( height ) / float( width );
-        if ( width > height )
+        // キューブマップの場合.
+        if ( ddsd.caps2 & DDSCAPS2_CUBEMAP )
         {
-            width  = MAX_TEXTURE_SIZE;
-            height = uint32_t( float( MAX_TEXTURE_SIZE ) * ar );
+            unsigned int surfaceCount = 0;
+
+            // サーフェイス数をチェック.
+            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_POSITIVE_X ) { surfaceCount++; }
+            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_NEGATIVE_X ) { surfaceCount++; }
+            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_POSITIVE_Y ) { surfaceCount++; }
+            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_NEGATIVE_Y ) { surfaceCount++; }
+            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_POSITIVE_Z ) { surfaceCount++; }
+            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_NEGATIVE_Z ) { surfaceCount++; }
+
+            // 一応チェック.
+            assert( surfaceCount == 6 );
+
+            // サーフェイス数を設定.
+            resTexture.SurfaceCount = surfaceCount;
+            resTexture.Option |= SUBRESOURCE_OPTION_CUBEMAP;
         }
-        else
+        // ボリュームテクスチャの場合.
+        else if ( ddsd.caps2 & DDSCAPS2_VOLUME )
         {
-            width = uint32_t( float( MAX_TEXTURE_SIZE ) / ar );
-            height = MAX_TEXTURE_SIZE;
+            // 奥行の値を設定.
+            resTexture.Depth = depth;
+            resTexture.Option |= SUBRESOURCE_OPTION_VOLUME;
         }
     }
 
-    WICPixelFormatGUID pixelFormat;
-    hr = frame->GetPixelFormat( &pixelFormat );
-    if ( FAILED( hr ) )
-    { return false; }
-
-    WICPixelFormatGUID convertGUID;
-    memcpy( &convertGUID, &pixelFormat, sizeof(WICPixelFormatGUID) );
+    // サポートフォーマットのチェックフラグ.
+    bool isSupportFormat = false;
 
-    size_t bpp = 0;
-    DXGI_FORMAT format = WICToDXGI( pixelFormat );
-    if ( format == DXGI_FORMAT_UNKNOWN )
+    // ピクセルフォーマット有効.
+    if ( ddsd.flags & DDSD_PIXELFORMAT )
     {
-        if ( memcmp( &GUID_WICPixelFormat96bppRGBFixedPoint, &pixelFormat, sizeof(WICPixelFormatGUID) ) == 0 )
-        {
-        #if (_WIN32_WINNT >= _WIN32_WINNT_WIN8) || defined(_WIN7_PLATFORM_UPDATE)
-            if ( g_WIC2 )
-            {
-                memcpy( &convertGUID, &GUID_WICPixelFormat96bppRGBFloat, sizeof(WICPixelFormatGUID) );
-                format = DXGI_FORMAT_R32G32B32_FLOAT;
-            }
-            else
-        #endif
-            {
-                memcpy( &convertGUID, &GUID_WICPixelFormat128bppRGBAFloat, sizeof(WICPixelFormatGUID) );
-                format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-            }
-        }
-        else
+        // dwFourCC有効
+        if ( ddsd.pixelFormat.flags & DDPF_FOURCC )
         {
-            for( size_t i=0; i < _countof(g_WICConvert); ++i )
+            switch( ddsd.pixelFormat.fourCC )
             {
-                if ( memcmp( &g_WICConvert[i].source, &pixelFormat, sizeof(WICPixelFormatGUID) ) == 0 )
+            case FOURCC_DXT1:
                 {
-                    memcpy( &convertGUID, &g_WICConvert[i].target, sizeof(WICPixelFormatGUID) );
-
-                    format = WICToDXGI( g_WICConvert[i].target );
-                    assert( format != DXGI_FORMAT_UNKNOWN );
-                    bpp = WICBitsPerPixel( convertGUID );
-                    break;
+                    resTexture.Format = DXGI_FORMAT_BC1_UNORM_SRGB;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC1;
+                    isSupportFormat   = true;
                 }
-            }
-        }
+                break;
 
-        if ( format == DXGI_FORMAT_UNKNOWN )
-        { return false; }
-    }
-#if 1
-    // Viewerアプリ用の専用処理.
-    //  テクスチャフェッチをした結果が正しくなるようにチャンネル数を4チャンネルにする.
-    else if ( format == DXGI_FORMAT_R8_UNORM
-           || format == DXGI_FORMAT_A8_UNORM
-           || format == DXGI_FORMAT_R16_UNORM
-           || format == DXGI_FORMAT_R16_FLOAT
-           || format == DXGI_FORMAT_R32_FLOAT )
-    {
-        for( size_t i=0; i < _countof(g_WICCustomConvert); ++i )
-        {
-            if ( memcmp( &g_WICCustomConvert[i].source, &pixelFormat, sizeof(WICPixelFormatGUID) ) == 0 )
-            {
-                memcpy( &convertGUID, &g_WICCustomConvert[i].target, sizeof(WICPixelFormatGUID) );
+            case FOURCC_DXT2:
+                {
+                    resTexture.Format = DXGI_FORMAT_BC2_UNORM_SRGB;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC2;
+                    isSupportFormat   = true;
+                }
+                break;
 
-                format = WICToDXGI( g_WICCustomConvert[i].target );
-                assert( format != DXGI_FORMAT_UNKNOWN );
-                bpp = WICBitsPerPixel( convertGUID );
+            case FOURCC_DXT3:
+                {
+                    resTexture.Format = DXGI_FORMAT_BC2_UNORM_SRGB;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC2;
+                    isSupportFormat   = true;
+                }
                 break;
-            }
-        }
 
-        if ( format == DXGI_FORMAT_UNKNOWN )
-        { return false; }
-    }
-#endif
-    else
-    {
-        bpp = WICBitsPerPixel( pixelFormat );
-    }
+            case FOURCC_DXT4:
+                {
+                    resTexture.Format = DXGI_FORMAT_BC3_UNORM_SRGB;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC3;
+                    isSupportFormat   = true;
+                }
+                break;
 
-    if ( !bpp )
-    { return false; }
+            case FOURCC_DXT5:
+                {
+                    resTexture.Format = DXGI_FORMAT_BC3_UNORM_SRGB;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC3;
+                    isSupportFormat   = true;
+                }
+                break;
 
-    // Handle sRGB formats
-    if ( forceSRGB )
-    {
-        format = MakeSRGB( format );
-    }
-    else
-    {
-        ComPtr<IWICMetadataQueryReader> metareader;
-        if ( SUCCEEDED( frame->GetMetadataQueryReader( metareader.GetAddressOf() ) ) )
-        {
-            GUID containerFormat;
-            if ( SUCCEEDED( metareader->GetContainerFormat( &containerFormat ) ) )
-            {
-                // Check for sRGB colorspace metadata
-                bool sRGB = false;
+            case FOURCC_ATI1:
+            case FOURCC_BC4U:
+                {
+                    resTexture.Format = DXGI_FORMAT_BC4_UNORM;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC4U;
+                    isSupportFormat   = true;
+                }
+                break;
 
-                PROPVARIANT value;
-                PropVariantInit( &value );
+            case FOURCC_BC4S:
+                {
+                    resTexture.Format = DXGI_FORMAT_BC4_SNORM;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC4S;
+                    isSupportFormat   = true;
+                }
+                break;
 
-                if ( memcmp( &containerFormat, &GUID_ContainerFormatPng, sizeof(GUID) ) == 0 )
+            case FOURCC_ATI2:
+            case FOURCC_BC5U:
                 {
-                    // Check for sRGB chunk
-                    if ( SUCCEEDED( metareader->GetMetadataByName( L"/sRGB/RenderingIntent", &value ) ) && value.vt == VT_UI1 )
-                    {
-                        sRGB = true;
-                    }
+                    resTexture.Format = DXGI_FORMAT_BC5_UNORM;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC5U;
+                    isSupportFormat   = true;
                 }
-                else if ( SUCCEEDED( metareader->GetMetadataByName( L"System.Image.ColorSpace", &value ) ) && value.vt == VT_UI2 && value.uiVal == 1 )
+                break;
+
+            case FOURCC_BC5S:
                 {
-                    sRGB = true;
+                    resTexture.Format = DXGI_FORMAT_BC5_SNORM;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC5S;
+                    isSupportFormat   = true;
                 }
+                break;
 
-                PropVariantClear( &value );
+            case FOURCC_DX10:
+                {
+                    if ( bufferSize < dataOffset + sizeof(DDSHeaderDX10) )
+                    {
+                        ELOG( "Error : Out of Range." );
+                        return false;
+                    }
 
-                if ( sRGB )
-                { format = MakeSRGB( format ); }
-            }
-        }
-    }
+                    DDSHeaderDX10 ext;
+                    memcpy( &ext, pBinary + dataOffset, sizeof(ext) );
+                    dataOffset += sizeof(ext);
 
-    // １行当たりのバイト数.
-    size_t rowPitch = ( width * bpp + 7 ) / 8;
+                    if ( ext.arraySize > DDS_MAX_ARRAY_SIZE )
+                    {
+                        ELOG( "Error : Invalid Array Size. arraySize = %u", ext.arraySize );
+                        return false;
+                    }
 
-    // ピクセルデータのサイズ.
-    size_t imageSize = rowPitch * height;
+                    resTexture.Format = ext.dxgiFormat;
+                    isSupportFormat   = GetNativeFormatFromDXGI( ext.dxgiFormat, nativeFormat );
 
-    // ピクセルデータのメモリを確保.
-    uint8_t* pPixels = new (std::nothrow) uint8_t [ imageSize ];
-    if ( !pPixels )
-    { return false; }
+                    // 配列数とキューブマップ・ボリュームテクスチャの判定は拡張ヘッダの値を優先する.
+                    auto arraySize = Max< uint32_t >( 1, ext.arraySize );
+                    resTexture.Depth        = 0;
+                    resTexture.SurfaceCount = arraySize;
+                    resTexture.Option       = 0;
 
-    // 元サイズと同じ場合.
-    if ( 0 == memcmp( &convertGUID, &pixelFormat, sizeof(GUID) )
-      && width  == origWidth
-      && height == origHeight )
-    {
-        hr = frame->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
-    }
-    else if ( width != origWidth
-          || height != origHeight )
-    {
-        // リサイズ処理.
+                    if ( ext.resourceDimension == DDS_DIMENSION_TEXTURE3D )
+                    {
+                        resTexture.Depth        = depth;
+                        resTexture.SurfaceCount = 1;
+                        resTexture.Option       = SUBRESOURCE_OPTION_VOLUME;
+                    }
+                    else if ( ext.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE )
+                    {
+                        resTexture.SurfaceCount = arraySize * 6;
+                        resTexture.Option       = SUBRESOURCE_OPTION_CUBEMAP;
+                    }
+                }
+                break;
 
-        ComPtr<IWICBitmapScaler> scaler;
-        hr = pWIC->CreateBitmapScaler( scaler.GetAddressOf() );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
+            case 36: // D3DFMT_A16B16G16R16
+                {
+                    // DXGI_FORMAT_R16G61B16A16_UNORM
+                }
+                break;
 
-        hr = scaler->Initialize( frame.Get(), width, height, WICBitmapInterpolationModeFant );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
+            case 110: // D3DFMT_W16W16V16U16
+                {
+                    // DXGI_FORMAT_R16G16B16A16_SNORM;
+                }
+                break;
 
-        WICPixelFormatGUID pfScalar;
-        hr = scaler->GetPixelFormat( &pfScalar );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
+            case 111: // D3DFMT_R16F
+                {
+                    // DXGI_FORMAT_R16_FLOAT
+                    resTexture.Format = DXGI_FORMAT_R16_FLOAT;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_R16_FLOAT;
+                    isSupportFormat   = true;
+                }
+                break;
 
-        if ( 0 == memcmp( &convertGUID, &pfScalar, sizeof(GUID) ) )
-        {
-            hr = scaler->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
-            if ( FAILED( hr ) )
-            {
-                SafeDeleteArray( pPixels );
-                return false;
-            }
-        }
-        else
-        {
-            ComPtr<IWICFormatConverter> conv;
-            hr =  pWIC->CreateFormatConverter( conv.GetAddressOf() );
-            if ( FAILED( hr ) )
-            {
-                SafeDeleteArray( pPixels );
-                return false;
-            }
+            case 112: // D3DFMT_G16R16F
+                {
+                    // DXGI_FORMAT_R16G16_FLOAT
+                    resTexture.Format = DXGI_FORMAT_R16G16_FLOAT;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_G16R16_FLOAT;
+                    isSupportFormat   = true;
+                }
+                break;
 
-            hr = conv->Initialize( scaler.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom );
-            if ( FAILED( hr ) )
-            {
-                SafeDeleteArray( pPixels );
-                return false;
-            }
-
-            hr = conv->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
-            if ( FAILED( hr ) )
-            {
-                SafeDeleteArray( pPixels );
-                return false;
-            }
-        }
-    }
-    else
-    {
-        // フォーマットのみが違う場合.
-
-        ComPtr<IWICFormatConverter> conv;
-        hr = pWIC->CreateFormatConverter( conv.GetAddressOf() );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
-
-        hr = conv->Initialize( frame.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
-
-        hr = conv->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
-        if ( FAILED( hr ) )
-        {
-            SafeDeleteArray( pPixels );
-            return false;
-        }
-    }
-
-    // サブリソースのメモリを確保.
-    asdx::SubResource* pRes = new (std::nothrow) asdx::SubResource();
-    if ( !pRes )
-    {
-        SafeDeleteArray( pPixels );
-        return false;
-    }
-
-    // サブリソースを設定.
-    pRes->Width      = width;
-    pRes->Height     = height;
-    pRes->Pitch      = uint32_t( rowPitch );
-    pRes->SlicePitch = uint32_t( imageSize );
-    pRes->pPixels    = pPixels;
-
-    // リソーステクスチャを設定.
-    resTexture.Width        = width;
-    resTexture.Height       = height;
-    resTexture.Depth        = 0;
-    resTexture.Format       = uint32_t( format );
-    resTexture.MipMapCount  = 1;
-    resTexture.SurfaceCount = 1;
-    resTexture.pResources   = pRes;
-
-    // 正常終了.
-    return true;
-}
-
-//-------------------------------------------------------------------------------------------------
-//      DDSからリソーステクスチャを生成します.
-//-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromDDSFileW( const wchar_t* filename, asdx::ResTexture& resTexture )
-{
-    FILE*           pFile;
-    DDSurfaceDesc   ddsd;
-    char            magic[ 4 ];
-    uint32_t             width  = 0;
-    uint32_t             height = 0;
-    uint32_t             depth  = 0;
-    uint32_t             nativeFormat = 0;
-
-
-    // ファイルを開きます.
-    errno_t err = _wfopen_s( &pFile, filename, L"rb" );
-
-    // ファイルオープンチェック.
-    if ( err != 0 )
-    {
-        ELOGW( "Error : File Open Failed. filename = %s", filename );
-        return false;
-    }
-
-   // マジックを読み込む.
-    fread( magic, sizeof(char), 4, pFile);
-
-    // マジックをチェック.
-    if ( ( magic[0] != 'D' )
-      || ( magic[1] != 'D' )
-      || ( magic[2] != 'S' )
-      || ( magic[3] != ' ' ) )
-    {
-        // エラーログ出力.
-        ELOGW( "Error : Invalid File. filename = %s", filename );
-
-        // ファイルを閉じる.
-        fclose( pFile );
-
-        // 異常終了.
-        return false;
-    }
-
-
-    // サーフェイスデスクリプションを読み込み.
-    fread( &ddsd, sizeof( DDSurfaceDesc ), 1, pFile );
-
-    // 高さ有効.
-    if ( ddsd.flags & DDSD_HEIGHT )
-    { height = ddsd.height; }
-
-    // 幅有効.
-    if ( ddsd.flags & DDSD_WIDTH )
-    { width = ddsd.width; }
-
-    // 奥行有効.
-    if ( ddsd.flags & DDSD_DEPTH )
-    { depth = ddsd.depth; }
-
-    resTexture.Width        = width;
-    resTexture.Height       = height;
-    resTexture.Depth        = 0;
-    resTexture.SurfaceCount = 1;
-    resTexture.MipMapCount  = 1;
-
-    // ミップマップ数.有効
-    if ( ddsd.flags & DDSD_MIPMAPCOUNT )
-    { resTexture.MipMapCount = ddsd.mipMapLevels; }
-
-    // キューブマップとボリュームテクスチャのチェック.
-    if ( ddsd.caps & DDSCAPS_COMPLEX )
-    {
-        // キューブマップの場合.
-        if ( ddsd.caps2 & DDSCAPS2_CUBEMAP )
-        {
-            unsigned int surfaceCount = 0;
-
-            // サーフェイス数をチェック.
-            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_POSITIVE_X ) { surfaceCount++; }
-            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_NEGATIVE_X ) { surfaceCount++; }
-            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_POSITIVE_Y ) { surfaceCount++; }
-            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_NEGATIVE_Y ) { surfaceCount++; }
-            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_POSITIVE_Z ) { surfaceCount++; }
-            if ( ddsd.caps2 & DDSCAPS2_CUBEMAP_NEGATIVE_Z ) { surfaceCount++; }
-
-            // 一応チェック.
-            assert( surfaceCount == 6 );
-
-            // サーフェイス数を設定.
-            resTexture.SurfaceCount = surfaceCount;
-            resTexture.Option |= SUBRESOURCE_OPTION_CUBEMAP;
-        }
-        // ボリュームテクスチャの場合.
-        else if ( ddsd.caps2 & DDSCAPS2_VOLUME )
-        {
-            // 奥行の値を設定.
-            resTexture.Depth = depth;
-            resTexture.Option |= SUBRESOURCE_OPTION_VOLUME;
-        }
-    }
-
-    // サポートフォーマットのチェックフラグ.
-    bool isSupportFormat = false;
-
-    // ピクセルフォーマット有効.
-    if ( ddsd.flags & DDSD_PIXELFORMAT )
-    {
-        // dwFourCC有効
-        if ( ddsd.pixelFormat.flags & DDPF_FOURCC )
-        {
-            switch( ddsd.pixelFormat.fourCC )
-            {
-            case FOURCC_DXT1:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC1_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC1;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case FOURCC_DXT2:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC2_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC2;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case FOURCC_DXT3:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC2_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC2;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case FOURCC_DXT4:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC3_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC3;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case FOURCC_DXT5:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC3_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC3;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case FOURCC_ATI1:
-            case FOURCC_BC4U:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC4_UNORM;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC4U;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case FOURCC_BC4S:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC5_SNORM;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC4S;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case FOURCC_ATI2:
-            case FOURCC_BC5U:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC5_UNORM;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC5U;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case FOURCC_BC5S:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC5_SNORM;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC5S;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case FOURCC_DX10:
-                {
-                }
-                break;
-
-            case 36: // D3DFMT_A16B16G16R16
-                {
-                    // DXGI_FORMAT_R16G61B16A16_UNORM
-                }
-                break;
-
-            case 110: // D3DFMT_W16W16V16U16
-                {
-                    // DXGI_FORMAT_R16G16B16A16_SNORM;
-                }
-                break;
-
-            case 111: // D3DFMT_R16F
-                {
-                    // DXGI_FORMAT_R16_FLOAT
-                    resTexture.Format = DXGI_FORMAT_R16_FLOAT;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_R16_FLOAT;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case 112: // D3DFMT_G16R16F
-                {
-                    // DXGI_FORMAT_R16G16_FLOAT
-                    resTexture.Format = DXGI_FORMAT_R16G16_FLOAT;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_G16R16_FLOAT;
-                    isSupportFormat   = true;
-                }
-                break;
-
-            case 113: // D3DFMT_A16B16G16R16F
-                {
-                    // DXGI_FORMAT_R16G16B16A16_FLOAT
-                    resTexture.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_A16B16G16R16_FLOAT;
-                    isSupportFormat   = true;
-                }
-                break;
+            case 113: // D3DFMT_A16B16G16R16F
+                {
+                    // DXGI_FORMAT_R16G16B16A16_FLOAT
+                    resTexture.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+                    nativeFormat      = NATIVE_TEXTURE_FORMAT_A16B16G16R16_FLOAT;
+                    isSupportFormat   = true;
+                }
+                break;
 
             case 114: // D3DFMT_R32F
                 {
@@ -2003,1218 +1748,3071 @@ bool CreateResTextureFromDDSFileW( const wchar_t* filename, asdx::ResTexture& re
                 }
                 break;
 
-            case 24:
-                {
-                #if 0
-                    /* NOT_SUPPORT */
-                #endif
-                }
-                break;
+            case 24:
+                {
+                #if 0
+                    /* NOT_SUPPORT */
+                #endif
+                }
+                break;
+
+            case 16:
+                {
+                #if 0
+                    //if ( CheckMask( ddsd.pixelFormat, 0x7c00, 0x03e0, 0x001f, 0x8000 ) )
+                    //{
+                    //    // B5 G5 R5 A1
+                    //    /* NOT_SUPPORT */
+                    //}
+
+                    //if ( CheckMask( ddsd.pixelFormat, 0xf800, 0x07e0, 0x001f, 0x0000 ) )
+                    //{
+                    //    // B5 G6 R5
+                    //    /* NOT_SUPPORT */
+                    //}
+                #endif
+                }
+                break;
+            }
+        }
+        else if ( ddsd.pixelFormat.flags & DDPF_LUMINANCE )
+        {
+            switch( ddsd.pixelFormat.bpp )
+            {
+            case 8:
+                {
+                    if ( CheckMask( ddsd.pixelFormat, 0x000000ff, 0x00000000, 0x00000000, 0x00000000 ) )
+                    {
+                        // R8
+                        isSupportFormat   = true;
+                        nativeFormat      = NATIVE_TEXTURE_FORMAT_R8;
+                        resTexture.Format = DXGI_FORMAT_R8_UNORM;
+                    }
+                }
+                break;
+
+            case 16:
+                {
+                #if 0
+                    //if ( CheckMask( ddsd.pixelFormat, 0x0000ffff, 0x00000000, 0x00000000, 0x00000000 ) )
+                    //{
+                    //    // R16
+                    //    /* NOT_SUPPORT */
+                    //}
+
+                    //if ( CheckMask( ddsd.pixelFormat, 0x000000ff, 0x00000000, 0x00000000, 0x0000ff00 ) )
+                    //{
+                    //    // R8 G8
+                    //    /* NOT_SUPPORT */
+                    //}
+                #endif
+                }
+                break;
+            }
+        }
+        else if ( ddsd.pixelFormat.flags & DDPF_ALPHA )
+        {
+            if ( 8 == ddsd.pixelFormat.bpp )
+            {
+                // A8
+                isSupportFormat   = true;
+                nativeFormat      = NATIVE_TEXTURE_FORMAT_A8;
+                resTexture.Format = DXGI_FORMAT_R8_UNORM;
+            }
+        }
+    }
+
+    // サポートフォーマットがあったかチェック.
+    if ( !isSupportFormat )
+    {
+        // エラーログ出力.
+        ELOG( "Error : Unsupported Format." );
+
+        // 異常終了.
+        return false;
+    }
+
+    // サブリソース数の計算が桁あふれしないように，ミップマップ数をミップチェインの長さまでに制限する.
+    auto maxMipCount = GetMaxMipMapCount( resTexture.Width, resTexture.Height, resTexture.Depth );
+    if ( resTexture.MipMapCount > maxMipCount )
+    {
+        ELOG( "Error : Invalid MipMap Count. mipMapCount = %u, max = %u", resTexture.MipMapCount, maxMipCount );
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ピクセルの並びの補正が必要かどうかチェックします.
+//!
+//! @param[in]      nativeFormat    ネイティブフォーマットです.
+//! @retval true    BGRA から RGBA への並び替えが必要です.
+//! @retval false   そのまま使用できます.
+//-------------------------------------------------------------------------------------------------
+bool NeedSwizzle( uint32_t nativeFormat )
+{
+    return ( nativeFormat == NATIVE_TEXTURE_FORMAT_ARGB_8888 )
+        || ( nativeFormat == NATIVE_TEXTURE_FORMAT_XRGB_8888 );
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      DDSのピクセルデータを指すサブリソースを設定します.
+//!
+//! @param[in,out]  resTexture      ヘッダ解析済みのリソーステクスチャです.
+//! @param[in]      nativeFormat    ネイティブフォーマットです.
+//! @param[in]      pPixels         ピクセルデータです. 解放は呼び出し側で管理します.
+//! @param[in]      pixelSize       ピクセルデータのバイト数です.
+//! @retval true    設定に成功.
+//! @retval false   設定に失敗.
+//! @note       サブリソースはピクセルデータを直接指し，コピーや並び替えは行いません.
+//-------------------------------------------------------------------------------------------------
+bool SetupDDSSubResources
+(
+    asdx::ResTexture&   resTexture,
+    uint32_t            nativeFormat,
+    uint8_t*            pPixels,
+    size_t              pixelSize
+)
+{
+    auto count = uint64_t( resTexture.MipMapCount ) * resTexture.SurfaceCount;
+    if ( count == 0 || count > uint64_t( DDS_MAX_ARRAY_SIZE ) * 6 * 32 )
+    {
+        ELOG( "Error : Invalid SubResource Count. count = %llu", count );
+        return false;
+    }
+
+    auto pResources = new (std::nothrow) asdx::SubResource[ size_t( count ) ];
+    if ( pResources == nullptr )
+    {
+        ELOG( "Error : Out of Memory." );
+        return false;
+    }
+
+    size_t offset = 0;
+    size_t idx    = 0;
+
+    // DDSはサーフェイスごとに全ミップレベルが並んでいるので，その順にサブリソースを割り当てる.
+    for( size_t i=0; i<resTexture.SurfaceCount; ++i )
+    {
+        size_t w = resTexture.Width;
+        size_t h = resTexture.Height;
+        size_t d = Max< size_t >( 1, resTexture.Depth );
+
+        for( size_t j=0; j<resTexture.MipMapCount; ++j, ++idx )
+        {
+            size_t rowBytes = 0;
+            size_t numRows  = 0;
+            GetSurfaceInfo( w, h, nativeFormat, rowBytes, numRows );
+
+            // データ数 = (1行当たりのバイト数) * 行数. ボリュームテクスチャは奥行分だけ並ぶ.
+            size_t remain = pixelSize - offset;
+            if ( numRows > 0 && ( rowBytes > remain / numRows || rowBytes * numRows > remain / d ) )
+            {
+                ELOG( "Error : Out of Range." );
+                delete [] pResources;
+                return false;
+            }
+
+            size_t numBytes = rowBytes * numRows;
+
+            // リソースデータを設定.
+            pResources[ idx ].Width      = uint32_t( w );
+            pResources[ idx ].Height     = uint32_t( h );
+            pResources[ idx ].Pitch      = uint32_t( rowBytes );
+            pResources[ idx ].SlicePitch = uint32_t( numBytes );
+            pResources[ idx ].pPixels    = pPixels + offset;
+
+            // オフセットをカウントアップ.
+            offset += numBytes * d;
+
+            // 横幅，縦幅，奥行を更新.
+            w = Max< size_t >( 1, w >> 1 );
+            h = Max< size_t >( 1, h >> 1 );
+            d = Max< size_t >( 1, d >> 1 );
+        }
+    }
+
+    resTexture.pResources = pResources;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      アラインメントに切り上げます.
+//-------------------------------------------------------------------------------------------------
+inline uint64_t AlignCooked( uint64_t value )
+{ return ( value + COOKED_TEXTURE_ALIGNMENT - 1 ) & ~uint64_t( COOKED_TEXTURE_ALIGNMENT - 1 ); }
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      クックドテクスチャかどうかチェックします.
+//!
+//! @param[in]      pBinary         バイナリです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @retval true    クックドテクスチャです.
+//! @retval false   クックドテクスチャではありません.
+//-------------------------------------------------------------------------------------------------
+bool IsCookedTexture( const uint8_t* pBinary, size_t bufferSize )
+{
+    return ( pBinary != nullptr )
+        && ( bufferSize >= sizeof(COOKED_TEXTURE_HEADER) )
+        && ( pBinary[0] == 'A' )
+        && ( pBinary[1] == 'T' )
+        && ( pBinary[2] == 'E' )
+        && ( pBinary[3] == 'X' );
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      クックドテクスチャのヘッダとサブリソーステーブルを検証します.
+//!
+//! @param[in]      pBinary         クックドテクスチャのバイナリです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @param[out]     resTexture      テクスチャの情報の設定先です. サブリソースは設定しません.
+//! @param[out]     dataOffset      ピクセルデータの先頭までのオフセットです.
+//! @retval true    検証に成功.
+//! @retval false   検証に失敗.
+//-------------------------------------------------------------------------------------------------
+bool ParseCookedTextureHeader
+(
+    const uint8_t*      pBinary,
+    size_t              bufferSize,
+    asdx::ResTexture&   resTexture,
+    size_t&             dataOffset
+)
+{
+    if ( !IsCookedTexture( pBinary, bufferSize ) )
+    {
+        ELOG( "Error : Invalid File." );
+        return false;
+    }
+
+    // アライメントが揃っているとは限らないのでコピーしておく.
+    COOKED_TEXTURE_HEADER header;
+    memcpy( &header, pBinary, sizeof(header) );
+
+    if ( header.Version != COOKED_TEXTURE_VERSION )
+    {
+        ELOG( "Error : Version Mismatch. version = %u", header.Version );
+        return false;
+    }
+
+    if ( header.MipMapCount == 0
+      || header.SurfaceCount == 0
+      || header.MipMapCount > 32
+      || header.SurfaceCount > DDS_MAX_ARRAY_SIZE * 6
+      || header.SubResourceCount != header.MipMapCount * header.SurfaceCount
+      || header.FileSize > bufferSize
+      || header.DataOffset > header.FileSize
+      || header.DataOffset < sizeof(header) + sizeof(COOKED_SUBRESOURCE) * header.SubResourceCount )
+    {
+        ELOG( "Error : Invalid Header." );
+        return false;
+    }
+
+    // 利用側は Pitch * 行数 を読むので，各サブリソースのサイズがヘッダのミップチェインと一致し，行がスライスに収まることを確認する.
+    asdx::ResTexture desc;
+    desc.Width        = header.Width;
+    desc.Height       = header.Height;
+    desc.Depth        = header.Depth;
+    desc.Format       = header.Format;
+    desc.MipMapCount  = header.MipMapCount;
+    desc.SurfaceCount = header.SurfaceCount;
+    desc.Option       = header.Option;
+
+    size_t blockSize = 0;
+    std::vector<asdx::SubResourceLayout> layouts( header.SubResourceCount );
+    if ( !asdx::PlanResTextureLayout( desc, layouts.data(), blockSize ) )
+    {
+        ELOG( "Error : Invalid Header." );
+        return false;
+    }
+
+    // 各サブリソースがファイルに収まっているかチェック.
+    auto pTable = pBinary + sizeof(header);
+    for( uint32_t i=0; i<header.SubResourceCount; ++i )
+    {
+        COOKED_SUBRESOURCE entry;
+        memcpy( &entry, pTable + sizeof(entry) * i, sizeof(entry) );
+
+        const auto& layout = layouts[ i ];
+        auto numRows = layout.SlicePitch / layout.Pitch;
+        if ( entry.Width  != layout.Width
+          || entry.Height != layout.Height
+          || entry.Pitch  <  layout.Pitch
+          || uint64_t( entry.Pitch ) * numRows > entry.SlicePitch )
+        {
+            ELOG( "Error : Invalid SubResource. index = %u", i );
+            return false;
+        }
+
+        auto size = uint64_t( entry.SlicePitch ) * entry.Depth;
+        if ( entry.Depth != layout.Depth
+          || entry.Offset < header.DataOffset
+          || ( entry.Offset % COOKED_TEXTURE_ALIGNMENT ) != 0
+          || entry.Offset > header.FileSize
+          || size > header.FileSize - entry.Offset )
+        {
+            ELOG( "Error : Out of Range. index = %u", i );
+            return false;
+        }
+    }
+
+    resTexture.Width        = header.Width;
+    resTexture.Height       = header.Height;
+    resTexture.Depth        = header.Depth;
+    resTexture.Format       = header.Format;
+    resTexture.MipMapCount  = header.MipMapCount;
+    resTexture.SurfaceCount = header.SurfaceCount;
+    resTexture.Option       = header.Option;
+
+    dataOffset = size_t( header.DataOffset );
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      クックドテクスチャのピクセルデータを指すサブリソースを設定します.
+//!
+//! @param[in]      pBinary         検証済みのクックドテクスチャのバイナリです.
+//! @param[in]      dataOffset      ピクセルデータの先頭までのオフセットです.
+//! @param[in]      pData           ファイル上の dataOffset の位置に対応するピクセルデータです.
+//! @param[in,out]  resTexture      ヘッダ解析済みのリソーステクスチャです.
+//! @retval true    設定に成功.
+//! @retval false   設定に失敗.
+//! @note       ピクセルデータは最終的なレイアウトで格納されているので，ポインタの設定のみを行います.
+//-------------------------------------------------------------------------------------------------
+bool SetupCookedSubResources
+(
+    const uint8_t*      pBinary,
+    size_t              dataOffset,
+    uint8_t*            pData,
+    asdx::ResTexture&   resTexture
+)
+{
+    auto count = resTexture.MipMapCount * resTexture.SurfaceCount;
+
+    auto pResources = new (std::nothrow) asdx::SubResource[ count ];
+    if ( pResources == nullptr )
+    {
+        ELOG( "Error : Out of Memory." );
+        return false;
+    }
+
+    auto pTable = pBinary + sizeof(COOKED_TEXTURE_HEADER);
+    for( uint32_t i=0; i<count; ++i )
+    {
+        COOKED_SUBRESOURCE entry;
+        memcpy( &entry, pTable + sizeof(entry) * i, sizeof(entry) );
+
+        pResources[ i ].Width      = entry.Width;
+        pResources[ i ].Height     = entry.Height;
+        pResources[ i ].Pitch      = entry.Pitch;
+        pResources[ i ].SlicePitch = entry.SlicePitch;
+        pResources[ i ].pPixels    = pData + size_t( entry.Offset - dataOffset );
+    }
+
+    resTexture.pResources = pResources;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      Radiance HDRファイルかどうかチェックします.
+//!
+//! @param[in]      pBinary         バイナリデータです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @retval true    Radiance HDRファイルです.
+//! @retval false   Radiance HDRファイルではありません.
+//-------------------------------------------------------------------------------------------------
+bool IsHDR( const uint8_t* pBinary, size_t bufferSize )
+{
+    if ( pBinary == nullptr )
+    { return false; }
+
+    return ( bufferSize >= 10 && memcmp( pBinary, "#?RADIANCE", 10 ) == 0 )
+        || ( bufferSize >= 6  && memcmp( pBinary, "#?RGBE", 6 ) == 0 );
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      Radiance HDRの解像度文字列から軸を1つ解析します.
+//!
+//! @param[in,out]  pText           解析位置です. 成功時は軸の直後に進みます.
+//! @param[in]      pEnd            行末です.
+//! @param[in]      axis            軸の名前です('X' または 'Y').
+//! @param[out]     sign            軸の符号です('+' または '-').
+//! @param[out]     value           画素数です.
+//! @retval true    解析に成功.
+//! @retval false   解析に失敗.
+//-------------------------------------------------------------------------------------------------
+bool ParseHDRAxis( const char*& pText, const char* pEnd, char axis, char& sign, uint32_t& value )
+{
+    while( pText < pEnd && *pText == ' ' )
+    { pText++; }
+
+    if ( pEnd - pText < 2 || ( pText[0] != '+' && pText[0] != '-' ) || pText[1] != axis )
+    { return false; }
+
+    sign   = pText[0];
+    pText += 2;
+
+    while( pText < pEnd && *pText == ' ' )
+    { pText++; }
+
+    value = 0;
+    auto pDigits = pText;
+    while( pText < pEnd && '0' <= *pText && *pText <= '9' && value <= MAX_TEXTURE_SIZE )
+    {
+        value = value * 10 + uint32_t( *pText - '0' );
+        pText++;
+    }
+
+    return ( pText != pDigits );
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      Radiance HDRファイルのヘッダを解析します.
+//!
+//! @param[in]      pBinary         バイナリデータです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @param[out]     width           横幅です.
+//! @param[out]     height          縦幅です.
+//! @param[out]     bottomUp        スキャンラインが下から上に並んでいる場合は true です.
+//! @param[out]     dataOffset      スキャンラインの先頭までのオフセットです.
+//! @retval true    解析に成功.
+//! @retval false   解析に失敗.
+//! @note       解像度は "-Y h +X w" と "+Y h +X w" のみ対応します. EXPOSURE 等は適用せず，格納値をそのまま使います.
+//-------------------------------------------------------------------------------------------------
+bool ParseHDRHeader
+(
+    const uint8_t*  pBinary,
+    size_t          bufferSize,
+    uint32_t&       width,
+    uint32_t&       height,
+    bool&           bottomUp,
+    size_t&         dataOffset
+)
+{
+    auto pText = reinterpret_cast<const char*>( pBinary );
+    auto pEnd  = pText + bufferSize;
+
+    // 空行までが情報行. 先頭行はマジックなので飛ばす.
+    auto pLine = pText;
+    auto first = true;
+    for( ;; )
+    {
+        auto pNext = static_cast<const char*>( memchr( pLine, '\n', size_t( pEnd - pLine ) ) );
+        if ( pNext == nullptr )
+        {
+            ELOG( "Error : Invalid File Format." );
+            return false;
+        }
+
+        auto length = size_t( pNext - pLine );
+        if ( !first && length == 0 )
+        {
+            pLine = pNext + 1;
+            break;
+        }
+
+        // XYZE は色空間が異なるので対応しない.
+        static const char kFormat[] = "FORMAT=";
+        if ( length > sizeof(kFormat) - 1 && memcmp( pLine, kFormat, sizeof(kFormat) - 1 ) == 0 )
+        {
+            static const char kRGBE[] = "32-bit_rle_rgbe";
+            if ( length - ( sizeof(kFormat) - 1 ) != sizeof(kRGBE) - 1
+              || memcmp( pLine + sizeof(kFormat) - 1, kRGBE, sizeof(kRGBE) - 1 ) != 0 )
+            {
+                ELOG( "Error : Unsupported HDR Format." );
+                return false;
+            }
+        }
+
+        first = false;
+        pLine = pNext + 1;
+    }
+
+    // 解像度行.
+    auto pNext = static_cast<const char*>( memchr( pLine, '\n', size_t( pEnd - pLine ) ) );
+    if ( pNext == nullptr )
+    {
+        ELOG( "Error : Invalid File Format." );
+        return false;
+    }
+
+    char signY, signX;
+    auto pCursor = pLine;
+    if ( !ParseHDRAxis( pCursor, pNext, 'Y', signY, height )
+      || !ParseHDRAxis( pCursor, pNext, 'X', signX, width )
+      || signX != '+' )
+    {
+        ELOG( "Error : Unsupported HDR Orientation." );
+        return false;
+    }
+
+    if ( width == 0 || height == 0 || width > MAX_TEXTURE_SIZE || height > MAX_TEXTURE_SIZE )
+    {
+        ELOG( "Error : Invalid Texture Size. width = %u, height = %u", width, height );
+        return false;
+    }
+
+    bottomUp   = ( signY == '+' );
+    dataOffset = size_t( pNext + 1 - pText );
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      Radiance HDRのスキャンラインを1行分RGBEに展開します.
+//!
+//! @param[in,out]  pSrc            読み込み位置です. 成功時は次のスキャンラインの先頭に進みます.
+//! @param[in]      pEnd            データの終端です.
+//! @param[in]      width           横幅です.
+//! @param[out]     pDst            展開先です(width * 4 バイト).
+//! @retval true    展開に成功.
+//! @retval false   データが壊れています.
+//! @note       非圧縮, 旧RLE((1, 1, 1, n) による繰り返し), 新RLE(チャンネルごとのランレングス)に対応します.
+//-------------------------------------------------------------------------------------------------
+bool DecodeHDRScanline( const uint8_t*& pSrc, const uint8_t* pEnd, uint32_t width, uint8_t* pDst )
+{
+    // 新RLEは (2, 2, 横幅の上位, 横幅の下位) で始まる.
+    if ( 8 <= width && width < 0x8000 && pEnd - pSrc >= 4
+      && pSrc[0] == 2 && pSrc[1] == 2 && ( pSrc[2] & 0x80 ) == 0 )
+    {
+        if ( ( uint32_t( pSrc[2] ) << 8 | pSrc[3] ) != width )
+        { return false; }
+
+        pSrc += 4;
+
+        for( uint32_t c=0; c<4; ++c )
+        {
+            uint32_t x = 0;
+            while( x < width )
+            {
+                if ( pSrc >= pEnd )
+                { return false; }
+
+                uint32_t count = *pSrc++;
+                if ( count > 128 )
+                {
+                    // 同じ値の繰り返し.
+                    count -= 128;
+                    if ( count > width - x || pSrc >= pEnd )
+                    { return false; }
+
+                    auto value = *pSrc++;
+                    for( uint32_t i=0; i<count; ++i )
+                    { pDst[ ( x + i ) * 4 + c ] = value; }
+                }
+                else
+                {
+                    // 非圧縮.
+                    if ( count == 0 || count > width - x || size_t( pEnd - pSrc ) < count )
+                    { return false; }
+
+                    for( uint32_t i=0; i<count; ++i )
+                    { pDst[ ( x + i ) * 4 + c ] = pSrc[ i ]; }
+
+                    pSrc += count;
+                }
+
+                x += count;
+            }
+        }
+
+        return true;
+    }
+
+    // 非圧縮か旧RLE. 繰り返しが連続する場合は回数を8bitずつ上位にずらして連結する.
+    uint32_t x     = 0;
+    uint32_t shift = 0;
+    while( x < width )
+    {
+        if ( pEnd - pSrc < 4 )
+        { return false; }
+
+        if ( pSrc[0] == 1 && pSrc[1] == 1 && pSrc[2] == 1 )
+        {
+            if ( x == 0 || shift > 16 )
+            { return false; }
+
+            auto count = uint32_t( pSrc[3] ) << shift;
+            if ( count > width - x )
+            { return false; }
+
+            for( uint32_t i=0; i<count; ++i )
+            { memcpy( pDst + ( x + i ) * 4, pDst + ( x - 1 ) * 4, 4 ); }
+
+            x     += count;
+            shift += 8;
+        }
+        else
+        {
+            memcpy( pDst + x * 4, pSrc, 4 );
+            x++;
+            shift = 0;
+        }
+
+        pSrc += 4;
+    }
+
+    return true;
+}
+
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//      ダミーのリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateDummyResTexture( asdx::ResTexture& resTexture )
+{
+    // リソーステクスチャの設定.
+    resTexture.Width        = 32;
+    resTexture.Height       = 32;
+    resTexture.Depth        = 0;
+    resTexture.Format       = uint32_t( DXGI_FORMAT_R8G8B8A8_UNORM );
+    resTexture.MipMapCount  = 1;
+    resTexture.SurfaceCount = 1;
+    resTexture.Option       = 0;
+
+    // サブリソースとピクセルデータをまとめて確保.
+    if ( !AllocateResTexture( resTexture ) )
+    { return false; }
+
+    memset( resTexture.pResources[0].pPixels, 255, sizeof(uint8_t) * 4096 );
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      WICからリソーステクスチャを生成します.
+//      (BMP, JPEG, PNG, TIFF, GIF, HD Photoファイルからリソーステクスチャを生成します).
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromWICFileW( const wchar_t* filename, asdx::ResTexture& resTexture )
+{
+    bool forceSRGB = true;
+
+    if ( filename == nullptr )
+    { return false; }
+
+    IWICImagingFactory* pWIC = GetWIC();
+    if ( !pWIC )
+    { return false; }
+
+    // WICの初期化.
+    ComPtr<IWICBitmapDecoder> decoder;
+    HRESULT hr = pWIC->CreateDecoderFromFilename( filename, 0, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf() );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    ComPtr<IWICBitmapFrameDecode> frame;
+    hr = decoder->GetFrame( 0, frame.GetAddressOf() );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    uint32_t width  = 0;
+    uint32_t height = 0;
+    hr = frame->GetSize( &width, &height );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    assert( width > 0 && height > 0 );
+
+    uint32_t origWidth  = width;
+    uint32_t origHeight = height;
+
+    if ( width  > MAX_TEXTURE_SIZE
+      || height > MAX_TEXTURE_SIZE )
+    {
+        float ar = float( height ) / float( width );
+        if ( width > height )
+        {
+            width  = MAX_TEXTURE_SIZE;
+            height = uint32_t( float( MAX_TEXTURE_SIZE ) * ar );
+        }
+        else
+        {
+            width = uint32_t( float( MAX_TEXTURE_SIZE ) / ar );
+            height = MAX_TEXTURE_SIZE;
+        }
+    }
+
+    WICPixelFormatGUID pixelFormat;
+    hr = frame->GetPixelFormat( &pixelFormat );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    WICPixelFormatGUID convertGUID;
+    DXGI_FORMAT        format = DXGI_FORMAT_UNKNOWN;
+    size_t             bpp    = 0;
+    if ( !ResolveWICFormat( pixelFormat, convertGUID, format, bpp ) )
+    { return false; }
+
+    // Handle sRGB formats
+    if ( forceSRGB )
+    {
+        format = MakeSRGB( format );
+    }
+    else
+    {
+        ComPtr<IWICMetadataQueryReader> metareader;
+        if ( SUCCEEDED( frame->GetMetadataQueryReader( metareader.GetAddressOf() ) ) )
+        {
+            GUID containerFormat;
+            if ( SUCCEEDED( metareader->GetContainerFormat( &containerFormat ) ) )
+            {
+                // Check for sRGB colorspace metadata
+                bool sRGB = false;
+
+                PROPVARIANT value;
+                PropVariantInit( &value );
+
+                if ( memcmp( &containerFormat, &GUID_ContainerFormatPng, sizeof(GUID) ) == 0 )
+                {
+                    // Check for sRGB chunk
+                    if ( SUCCEEDED( metareader->GetMetadataByName( L"/sRGB/RenderingIntent", &value ) ) && value.vt == VT_UI1 )
+                    {
+                        sRGB = true;
+                    }
+                }
+                else if ( SUCCEEDED( metareader->GetMetadataByName( L"System.Image.ColorSpace", &value ) ) && value.vt == VT_UI2 && value.uiVal == 1 )
+                {
+                    sRGB = true;
+                }
+
+                PropVariantClear( &value );
+
+                if ( sRGB )
+                { format = MakeSRGB( format ); }
+            }
+        }
+    }
+
+    // １行当たりのバイト数.
+    size_t rowPitch = ( width * bpp + 7 ) / 8;
+
+    // ピクセルデータのサイズ.
+    size_t imageSize = rowPitch * height;
+
+    // リソーステクスチャを設定.
+    resTexture.Width        = width;
+    resTexture.Height       = height;
+    resTexture.Depth        = 0;
+    resTexture.Format       = uint32_t( format );
+    resTexture.MipMapCount  = 1;
+    resTexture.SurfaceCount = 1;
+    resTexture.Option       = 0;
+
+    // サブリソースとピクセルデータをまとめて確保し，WICから直接書き込む.
+    if ( !AllocateResTexture( resTexture ) )
+    { return false; }
+
+    if ( resTexture.pResources[0].Pitch != rowPitch )
+    {
+        ELOG( "Error : Pitch Mismatch. format = %u", resTexture.Format );
+        resTexture.Release();
+        return false;
+    }
+
+    uint8_t* pPixels = resTexture.pResources[0].pPixels;
+
+    // 元サイズと同じ場合.
+    if ( 0 == memcmp( &convertGUID, &pixelFormat, sizeof(GUID) )
+      && width  == origWidth
+      && height == origHeight )
+    {
+        hr = frame->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+    }
+    else if ( width != origWidth
+          || height != origHeight )
+    {
+        // リサイズ処理.
+
+        ComPtr<IWICBitmapScaler> scaler;
+        hr = pWIC->CreateBitmapScaler( scaler.GetAddressOf() );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        hr = scaler->Initialize( frame.Get(), width, height, WICBitmapInterpolationModeFant );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        WICPixelFormatGUID pfScalar;
+        hr = scaler->GetPixelFormat( &pfScalar );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        if ( 0 == memcmp( &convertGUID, &pfScalar, sizeof(GUID) ) )
+        {
+            hr = scaler->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
+            if ( FAILED( hr ) )
+            {
+                resTexture.Release();
+                return false;
+            }
+        }
+        else
+        {
+            ComPtr<IWICFormatConverter> conv;
+            hr =  pWIC->CreateFormatConverter( conv.GetAddressOf() );
+            if ( FAILED( hr ) )
+            {
+                resTexture.Release();
+                return false;
+            }
+
+            hr = conv->Initialize( scaler.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom );
+            if ( FAILED( hr ) )
+            {
+                resTexture.Release();
+                return false;
+            }
+
+            hr = conv->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
+            if ( FAILED( hr ) )
+            {
+                resTexture.Release();
+                return false;
+            }
+        }
+    }
+    else
+    {
+        // フォーマットのみが違う場合.
+
+
+        ComPtr<IWICFormatConverter> conv;
+        hr = pWIC->CreateFormatConverter( conv.GetAddressOf() );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        hr = conv->Initialize( frame.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        hr = conv->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+    }
+
+    // 正常終了.
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      WICからリソーステクスチャを生成します.
+//      (BMP, JPEG, PNG, TIFF, GIF, HD Photoファイルからリソーステクスチャを生成します).
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromWICFileA( const char* filename, asdx::ResTexture& resTexture )
+{
+    auto path = ToStringW(filename);
+    return CreateResTextureFromWICFileW(path.c_str(), resTexture);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      WICからリソーステクスチャを生成します.
+//      (BMP, JPEG, PNG, TIFF, GIF, HD Photoファイルからリソーステクスチャを生成します).
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromWICMemory( const uint8_t* pBinary, const uint32_t bufferSize, asdx::ResTexture& resTexture )
+{
+    bool forceSRGB = true;
+
+    if ( pBinary == nullptr )
+    { return false; }
+
+    IWICImagingFactory* pWIC = GetWIC();
+    if ( !pWIC )
+    { return false; }
+
+    ComPtr<IWICStream> pStream;
+    HRESULT hr = pWIC->CreateStream( &pStream );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    hr = pStream->InitializeFromMemory( (BYTE*)pBinary, bufferSize );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    // WICの初期化.
+    ComPtr<IWICBitmapDecoder> decoder;
+    hr = pWIC->CreateDecoderFromStream( pStream.Get(), 0, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf() );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    ComPtr<IWICBitmapFrameDecode> frame;
+    hr = decoder->GetFrame( 0, frame.GetAddressOf() );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    uint32_t width  = 0;
+    uint32_t height = 0;
+    hr = frame->GetSize( &width, &height );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    assert( width > 0 && height > 0 );
+
+    uint32_t origWidth  = width;
+    uint32_t origHeight = height;
+
+    if ( width  > MAX_TEXTURE_SIZE
+      || height > MAX_TEXTURE_SIZE )
+    {
+        float ar = float( height ) / float( width );
+        if ( width > height )
+        {
+            width  = MAX_TEXTURE_SIZE;
+            height = uint32_t( float( MAX_TEXTURE_SIZE ) * ar );
+        }
+        else
+        {
+            width = uint32_t( float( MAX_TEXTURE_SIZE ) / ar );
+            height = MAX_TEXTURE_SIZE;
+        }
+    }
+
+    WICPixelFormatGUID pixelFormat;
+    hr = frame->GetPixelFormat( &pixelFormat );
+    if ( FAILED( hr ) )
+    { return false; }
+
+    WICPixelFormatGUID convertGUID;
+    DXGI_FORMAT        format = DXGI_FORMAT_UNKNOWN;
+    size_t             bpp    = 0;
+    if ( !ResolveWICFormat( pixelFormat, convertGUID, format, bpp ) )
+    { return false; }
+
+    // Handle sRGB formats
+    if ( forceSRGB )
+    {
+        format = MakeSRGB( format );
+    }
+    else
+    {
+        ComPtr<IWICMetadataQueryReader> metareader;
+        if ( SUCCEEDED( frame->GetMetadataQueryReader( metareader.GetAddressOf() ) ) )
+        {
+            GUID containerFormat;
+            if ( SUCCEEDED( metareader->GetContainerFormat( &containerFormat ) ) )
+            {
+                // Check for sRGB colorspace metadata
+                bool sRGB = false;
+
+                PROPVARIANT value;
+                PropVariantInit( &value );
+
+                if ( memcmp( &containerFormat, &GUID_ContainerFormatPng, sizeof(GUID) ) == 0 )
+                {
+                    // Check for sRGB chunk
+                    if ( SUCCEEDED( metareader->GetMetadataByName( L"/sRGB/RenderingIntent", &value ) ) && value.vt == VT_UI1 )
+                    {
+                        sRGB = true;
+                    }
+                }
+                else if ( SUCCEEDED( metareader->GetMetadataByName( L"System.Image.ColorSpace", &value ) ) && value.vt == VT_UI2 && value.uiVal == 1 )
+                {
+                    sRGB = true;
+                }
+
+                PropVariantClear( &value );
+
+                if ( sRGB )
+                { format = MakeSRGB( format ); }
+            }
+        }
+    }
+
+    // １行当たりのバイト数.
+    size_t rowPitch = ( width * bpp + 7 ) / 8;
+
+    // ピクセルデータのサイズ.
+    size_t imageSize = rowPitch * height;
+
+    // リソーステクスチャを設定.
+    resTexture.Width        = width;
+    resTexture.Height       = height;
+    resTexture.Depth        = 0;
+    resTexture.Format       = uint32_t( format );
+    resTexture.MipMapCount  = 1;
+    resTexture.SurfaceCount = 1;
+    resTexture.Option       = 0;
+
+    // サブリソースとピクセルデータをまとめて確保し，WICから直接書き込む.
+    if ( !AllocateResTexture( resTexture ) )
+    { return false; }
+
+    if ( resTexture.pResources[0].Pitch != rowPitch )
+    {
+        ELOG( "Error : Pitch Mismatch. format = %u", resTexture.Format );
+        resTexture.Release();
+        return false;
+    }
+
+    uint8_t* pPixels = resTexture.pResources[0].pPixels;
+
+    // 元サイズと同じ場合.
+    if ( 0 == memcmp( &convertGUID, &pixelFormat, sizeof(GUID) )
+      && width  == origWidth
+      && height == origHeight )
+    {
+        hr = frame->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+    }
+    else if ( width != origWidth
+          || height != origHeight )
+    {
+        // リサイズ処理.
+
+        ComPtr<IWICBitmapScaler> scaler;
+        hr = pWIC->CreateBitmapScaler( scaler.GetAddressOf() );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        hr = scaler->Initialize( frame.Get(), width, height, WICBitmapInterpolationModeFant );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        WICPixelFormatGUID pfScalar;
+        hr = scaler->GetPixelFormat( &pfScalar );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        if ( 0 == memcmp( &convertGUID, &pfScalar, sizeof(GUID) ) )
+        {
+            hr = scaler->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
+            if ( FAILED( hr ) )
+            {
+                resTexture.Release();
+                return false;
+            }
+        }
+        else
+        {
+            ComPtr<IWICFormatConverter> conv;
+            hr =  pWIC->CreateFormatConverter( conv.GetAddressOf() );
+            if ( FAILED( hr ) )
+            {
+                resTexture.Release();
+                return false;
+            }
+
+            hr = conv->Initialize( scaler.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom );
+            if ( FAILED( hr ) )
+            {
+                resTexture.Release();
+                return false;
+            }
+
+            hr = conv->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
+            if ( FAILED( hr ) )
+            {
+                resTexture.Release();
+                return false;
+            }
+        }
+    }
+    else
+    {
+        // フォーマットのみが違う場合.
+
+        ComPtr<IWICFormatConverter> conv;
+        hr = pWIC->CreateFormatConverter( conv.GetAddressOf() );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        hr = conv->Initialize( frame.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+
+        hr = conv->CopyPixels( 0, uint32_t( rowPitch ), uint32_t( imageSize ), pPixels );
+        if ( FAILED( hr ) )
+        {
+            resTexture.Release();
+            return false;
+        }
+    }
+
+    // 正常終了.
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DDSからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromDDSMemory( const uint8_t* pBinary, const uint32_t bufferSize, asdx::ResTexture& resTexture )
+{
+    uint32_t nativeFormat = 0;
+    size_t   dataOffset   = 0;
+
+    if ( pBinary == nullptr || bufferSize == 0 )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    if ( !ParseDDSHeader( pBinary, bufferSize, resTexture, nativeFormat, dataOffset ) )
+    { return false; }
+
+    // サブリソースとピクセルデータをまとめて確保し，サブリソースごとにファイルから直接コピーする.
+    if ( !AllocateResTexture( resTexture ) )
+    { return false; }
+
+    auto   swizzle   = NeedSwizzle( nativeFormat );
+    auto   isVolume  = ( resTexture.Option & SUBRESOURCE_OPTION_VOLUME ) != 0;
+    auto   pSrc      = pBinary + dataOffset;
+    size_t remain    = bufferSize - dataOffset;
+    size_t idx       = 0;
+
+    // DDSはサーフェイスごとに全ミップレベルが詰めて並んでいるので，その順に読み進める.
+    for( uint32_t i=0; i<resTexture.SurfaceCount; ++i )
+    {
+        for( uint32_t j=0; j<resTexture.MipMapCount; ++j, ++idx )
+        {
+            auto& res = resTexture.pResources[ idx ];
+
+            size_t rowBytes = 0;
+            size_t numRows  = 0;
+            GetSurfaceInfo( res.Width, res.Height, nativeFormat, rowBytes, numRows );
+
+            // ファイル上の並びと確保した配置が一致しない場合は読み込めない.
+            if ( rowBytes != res.Pitch || rowBytes * numRows != res.SlicePitch )
+            {
+                ELOG( "Error : Pitch Mismatch. format = %u", resTexture.Format );
+                resTexture.Release();
+                return false;
+            }
+
+            size_t depth    = ( isVolume ) ? GetMipDepth( resTexture.Depth, j ) : 1;
+            size_t numBytes = size_t( res.SlicePitch ) * depth;
+            if ( numBytes > remain )
+            {
+                ELOG( "Error : Out of Range." );
+                resTexture.Release();
+                return false;
+            }
+
+            // リトルエンディアンなのでピクセルの並びを補正.
+            if ( swizzle )
+            { SwizzleBGRAToRGBA( pSrc, res.pPixels, uint32_t( numBytes / 4 ) ); }
+            else
+            { memcpy( res.pPixels, pSrc, numBytes ); }
+
+            pSrc   += numBytes;
+            remain -= numBytes;
+        }
+    }
+
+    // 正常終了.
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DDSからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromDDSFileW( const wchar_t* filename, asdx::ResTexture& resTexture )
+{
+    // 引数チェック.
+    if ( filename == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    // ファイル全体をマップして，メモリからの読み込みと同じ経路で処理する.
+    MappedFile file;
+    if ( !file.Open( filename ) )
+    {
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        return false;
+    }
+
+    if ( file.GetSize() > UINT32_MAX )
+    {
+        ELOGW( "Error : File Size Too Large. filename = %s", filename );
+        return false;
+    }
+
+    return CreateResTextureFromDDSMemory( file.GetData(), uint32_t( file.GetSize() ), resTexture );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromDDSFileA( const char* filename, asdx::ResTexture& resTexture )
+{
+    auto path = ToStringW(filename);
+    return CreateResTextureFromDDSFileW(path.c_str(), resTexture);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      マップしたDDSファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool MapResTextureFromDDS( MappedFile* pFile, asdx::ResTexture& resTexture )
+{
+    // 以降はリソーステクスチャの解放でマップも解除される.
+    resTexture.pMappedFile = pFile;
+
+    uint32_t nativeFormat = 0;
+    size_t   dataOffset   = 0;
+    if ( !ParseDDSHeader( pFile->GetData(), pFile->GetSize(), resTexture, nativeFormat, dataOffset ) )
+    {
+        resTexture.Release();
+        return false;
+    }
+
+    // リトルエンディアンなのでピクセルの並びを補正. 書き換えたページだけが複製される.
+    auto pPixels = pFile->GetWritableData() + dataOffset;
+    if ( NeedSwizzle( nativeFormat ) )
+    { SwizzleBGRAToRGBA( pPixels, pPixels, uint32_t( ( pFile->GetSize() - dataOffset ) / 4 ) ); }
+
+    if ( !SetupDDSSubResources( resTexture, nativeFormat, pPixels, pFile->GetSize() - dataOffset ) )
+    {
+        resTexture.Release();
+        return false;
+    }
+
+    // 正常終了.
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルをマップしてリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool MapResTextureFromDDSFileW( const wchar_t* filename, asdx::ResTexture& resTexture )
+{
+    // 引数チェック.
+    if ( filename == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto pFile = new (std::nothrow) MappedFile();
+    if ( pFile == nullptr )
+    {
+        ELOG( "Error : Out of Memory." );
+        return false;
+    }
+
+    // RGBの並び替えでファイルを書き換えないように書き込み時コピーでマップする.
+    if ( !pFile->Open( filename, true ) )
+    {
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        delete pFile;
+        return false;
+    }
+
+    return MapResTextureFromDDS( pFile, resTexture );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルをマップしてリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool MapResTextureFromDDSFileA( const char* filename, asdx::ResTexture& resTexture )
+{
+    auto path = ToStringW(filename);
+    return MapResTextureFromDDSFileW(path.c_str(), resTexture);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      リソーステクスチャをDDSファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool SaveResTextureToDDSFileW( const wchar_t* filename, const asdx::ResTexture& resTexture )
+{
+    // 引数チェック.
+    if ( filename == nullptr || resTexture.pResources == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    uint32_t nativeFormat = 0;
+    if ( !GetNativeFormatFromDXGI( resTexture.Format, nativeFormat ) )
+    {
+        ELOG( "Error : Unsupported Format. format = %u", resTexture.Format );
+        return false;
+    }
+
+    auto isCube       = ( resTexture.Option & SUBRESOURCE_OPTION_CUBEMAP ) != 0;
+    auto isVolume     = ( resTexture.Option & SUBRESOURCE_OPTION_VOLUME  ) != 0;
+    auto mipCount     = Max< uint32_t >( 1, resTexture.MipMapCount );
+    auto surfaceCount = Max< uint32_t >( 1, resTexture.SurfaceCount );
+
+    if ( ( isCube && ( surfaceCount % 6 ) != 0 ) || ( isVolume && surfaceCount != 1 ) )
+    {
+        ELOG( "Error : Invalid Surface Count. surfaceCount = %u", surfaceCount );
+        return false;
+    }
+
+    DDSurfaceDesc ddsd;
+    memset( &ddsd, 0, sizeof(ddsd) );
+    ddsd.size               = sizeof(ddsd);
+    ddsd.flags              = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT;
+    ddsd.height             = resTexture.Height;
+    ddsd.width              = resTexture.Width;
+    ddsd.mipMapLevels       = mipCount;
+    ddsd.pixelFormat.size   = sizeof(DDPixelFormat);
+    ddsd.pixelFormat.flags  = DDPF_FOURCC;
+    ddsd.pixelFormat.fourCC = FOURCC_DX10;
+    ddsd.caps               = DDSCAPS_TEXTURE;
+
+    if ( mipCount > 1 )
+    { ddsd.caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP; }
+
+    // 配列とキューブマップは旧形式のヘッダでは表現できないので，常にDX10拡張ヘッダを付ける.
+    DDSHeaderDX10 ext;
+    memset( &ext, 0, sizeof(ext) );
+    ext.dxgiFormat        = resTexture.Format;
+    ext.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+    ext.arraySize         = surfaceCount;
+
+    if ( isVolume )
+    {
+        ddsd.flags |= DDSD_DEPTH;
+        ddsd.depth  = Max< uint32_t >( 1, resTexture.Depth );
+        ddsd.caps  |= DDSCAPS_COMPLEX;
+        ddsd.caps2  = DDSCAPS2_VOLUME;
+
+        ext.resourceDimension = DDS_DIMENSION_TEXTURE3D;
+    }
+    else if ( isCube )
+    {
+        ddsd.caps  |= DDSCAPS_COMPLEX;
+        ddsd.caps2  = DDSCAPS2_CUBEMAP
+                    | DDSCAPS2_CUBEMAP_POSITIVE_X | DDSCAPS2_CUBEMAP_NEGATIVE_X
+                    | DDSCAPS2_CUBEMAP_POSITIVE_Y | DDSCAPS2_CUBEMAP_NEGATIVE_Y
+                    | DDSCAPS2_CUBEMAP_POSITIVE_Z | DDSCAPS2_CUBEMAP_NEGATIVE_Z;
+
+        ext.miscFlag  = DDS_RESOURCE_MISC_TEXTURECUBE;
+        ext.arraySize = surfaceCount / 6;
+    }
+    else if ( surfaceCount > 1 )
+    { ddsd.caps |= DDSCAPS_COMPLEX; }
+
+    FILE* pFile = nullptr;
+    auto err = _wfopen_s( &pFile, filename, L"wb" );
+    if ( err != 0 || pFile == nullptr )
+    {
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        return false;
+    }
+
+    static const char kMagic[4] = { 'D', 'D', 'S', ' ' };
+
+    auto result = ( fwrite( kMagic, sizeof(kMagic), 1, pFile ) == 1 )
+               && ( fwrite( &ddsd,  sizeof(ddsd),   1, pFile ) == 1 )
+               && ( fwrite( &ext,   sizeof(ext),    1, pFile ) == 1 );
+
+    // サーフェイスごとに全ミップレベルを並べる. 行間の余白は詰めて書き出す.
+    for( uint32_t i=0; i<surfaceCount && result; ++i )
+    {
+        for( uint32_t j=0; j<mipCount && result; ++j )
+        {
+            const auto& res = resTexture.pResources[ i * mipCount + j ];
+
+            size_t rowBytes = 0;
+            size_t numRows  = 0;
+            GetSurfaceInfo( res.Width, res.Height, nativeFormat, rowBytes, numRows );
+
+            if ( res.pPixels == nullptr || rowBytes > res.Pitch )
+            {
+                ELOG( "Error : Invalid SubResource. index = %u", i * mipCount + j );
+                result = false;
+                break;
+            }
+
+            auto depth = ( isVolume ) ? GetMipDepth( resTexture.Depth, j ) : 1;
+            for( uint32_t z=0; z<depth && result; ++z )
+            {
+                auto pSlice = res.pPixels + size_t( res.SlicePitch ) * z;
+                if ( rowBytes == res.Pitch )
+                {
+                    result = ( fwrite( pSlice, rowBytes * numRows, 1, pFile ) == 1 );
+                    continue;
+                }
+
+                for( size_t r=0; r<numRows && result; ++r )
+                { result = ( fwrite( pSlice + res.Pitch * r, rowBytes, 1, pFile ) == 1 ); }
+            }
+        }
+    }
+
+    fclose( pFile );
+
+    if ( !result )
+    { ELOGW( "Error : File Write Failed. filename = %s", filename ); }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      リソーステクスチャをDDSファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool SaveResTextureToDDSFileA( const char* filename, const asdx::ResTexture& resTexture )
+{
+    if ( filename == nullptr )
+    {
+        ELOGA( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto path = ToStringW(filename);
+    return SaveResTextureToDDSFileW(path.c_str(), resTexture);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      クックドテクスチャからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromCookedMemory( const uint8_t* pBinary, size_t bufferSize, asdx::ResTexture& resTexture )
+{
+    size_t dataOffset = 0;
+    if ( !ParseCookedTextureHeader( pBinary, bufferSize, resTexture, dataOffset ) )
+    { return false; }
+
+    // ピクセルデータは最終的な形式で並んでいるので，1回のコピーで済ませる.
+    auto dataSize = bufferSize - dataOffset;
+    auto pBlock   = new (std::nothrow) uint8_t [ ( dataSize > 0 ) ? dataSize : 1 ];
+    if ( pBlock == nullptr )
+    {
+        ELOG( "Error : Out of Memory." );
+        return false;
+    }
+
+    memcpy( pBlock, pBinary + dataOffset, dataSize );
+    resTexture.pBlock = pBlock;
+
+    if ( !SetupCookedSubResources( pBinary, dataOffset, pBlock, resTexture ) )
+    {
+        resTexture.Release();
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      クックドテクスチャファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromCookedFileW( const wchar_t* filename, asdx::ResTexture& resTexture )
+{
+    if ( filename == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    MappedFile file;
+    if ( !file.Open( filename ) )
+    {
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        return false;
+    }
+
+    return CreateResTextureFromCookedMemory( file.GetData(), file.GetSize(), resTexture );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      クックドテクスチャファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromCookedFileA( const char* filename, asdx::ResTexture& resTexture )
+{
+    auto path = ToStringW(filename);
+    return CreateResTextureFromCookedFileW(path.c_str(), resTexture);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      マップしたクックドテクスチャファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool MapResTextureFromCooked( MappedFile* pFile, asdx::ResTexture& resTexture )
+{
+    // 以降はリソーステクスチャの解放でマップも解除される.
+    resTexture.pMappedFile = pFile;
+
+    size_t dataOffset = 0;
+    if ( !ParseCookedTextureHeader( pFile->GetData(), pFile->GetSize(), resTexture, dataOffset )
+      || !SetupCookedSubResources( pFile->GetData(), dataOffset, pFile->GetWritableData() + dataOffset, resTexture ) )
+    {
+        resTexture.Release();
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      クックドテクスチャファイルをマップしてリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool MapResTextureFromCookedFileW( const wchar_t* filename, asdx::ResTexture& resTexture )
+{
+    if ( filename == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto pFile = new (std::nothrow) MappedFile();
+    if ( pFile == nullptr )
+    {
+        ELOG( "Error : Out of Memory." );
+        return false;
+    }
+
+    // 呼び出し側でピクセルを書き換えてもファイルが変わらないように書き込み時コピーでマップする.
+    if ( !pFile->Open( filename, true ) )
+    {
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        delete pFile;
+        return false;
+    }
+
+    return MapResTextureFromCooked( pFile, resTexture );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      クックドテクスチャファイルをマップしてリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool MapResTextureFromCookedFileA( const char* filename, asdx::ResTexture& resTexture )
+{
+    auto path = ToStringW(filename);
+    return MapResTextureFromCookedFileW(path.c_str(), resTexture);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      リソーステクスチャをクックドテクスチャファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool SaveResTextureToCookedFileW( const wchar_t* filename, const asdx::ResTexture& resTexture )
+{
+    if ( filename == nullptr || resTexture.pResources == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto isVolume = ( resTexture.Option & SUBRESOURCE_OPTION_VOLUME ) != 0;
+    auto mipCount = Max< uint32_t >( 1, resTexture.MipMapCount );
+    auto count    = mipCount * Max< uint32_t >( 1, resTexture.SurfaceCount );
+
+    COOKED_TEXTURE_HEADER header;
+    memset( &header, 0, sizeof(header) );
+    header.Magic[0]         = 'A';
+    header.Magic[1]         = 'T';
+    header.Magic[2]         = 'E';
+    header.Magic[3]         = 'X';
+    header.Version          = COOKED_TEXTURE_VERSION;
+    header.Width            = resTexture.Width;
+    header.Height           = resTexture.Height;
+    header.Depth            = resTexture.Depth;
+    header.Format           = resTexture.Format;
+    header.MipMapCount      = mipCount;
+    header.SurfaceCount     = Max< uint32_t >( 1, resTexture.SurfaceCount );
+    header.Option           = resTexture.Option;
+    header.SubResourceCount = count;
+    header.DataOffset       = AlignCooked( sizeof(header) + sizeof(COOKED_SUBRESOURCE) * count );
+
+    // サブリソーステーブルを作成. 各サブリソースの先頭をアラインメントに揃える.
+    std::vector<COOKED_SUBRESOURCE> table( count );
+    auto offset = header.DataOffset;
+    for( uint32_t i=0; i<count; ++i )
+    {
+        const auto& res = resTexture.pResources[ i ];
+        if ( res.pPixels == nullptr )
+        {
+            ELOG( "Error : SubResource is not resident. index = %u", i );
+            return false;
+        }
+
+        auto& entry = table[ i ];
+        memset( &entry, 0, sizeof(entry) );
+        entry.Width      = res.Width;
+        entry.Height     = res.Height;
+        entry.Pitch      = res.Pitch;
+        entry.SlicePitch = res.SlicePitch;
+        entry.Depth      = ( isVolume ) ? GetMipDepth( resTexture.Depth, i % mipCount ) : 1;
+        entry.Offset     = offset;
+
+        offset = AlignCooked( offset + uint64_t( entry.SlicePitch ) * entry.Depth );
+    }
+    header.FileSize = offset;
+
+    FILE* pFile = nullptr;
+    auto err = _wfopen_s( &pFile, filename, L"wb" );
+    if ( err != 0 || pFile == nullptr )
+    {
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        return false;
+    }
+
+    static const uint8_t kPadding[ COOKED_TEXTURE_ALIGNMENT ] = {};
+
+    auto result = ( fwrite( &header, sizeof(header), 1, pFile ) == 1 )
+               && ( fwrite( table.data(), sizeof(COOKED_SUBRESOURCE), count, pFile ) == count );
+
+    auto written = uint64_t( sizeof(header) + sizeof(COOKED_SUBRESOURCE) * count );
+    for( uint32_t i=0; i<count && result; ++i )
+    {
+        const auto& entry = table[ i ];
+
+        auto padding = size_t( entry.Offset - written );
+        auto size    = size_t( entry.SlicePitch ) * entry.Depth;
+
+        result = ( padding == 0 || fwrite( kPadding, padding, 1, pFile ) == 1 )
+              && ( size    == 0 || fwrite( resTexture.pResources[ i ].pPixels, size, 1, pFile ) == 1 );
+
+        written = entry.Offset + size;
+    }
+
+    // ファイルサイズもアラインメントに揃えておく.
+    if ( result && written < header.FileSize )
+    { result = ( fwrite( kPadding, size_t( header.FileSize - written ), 1, pFile ) == 1 ); }
+
+    fclose( pFile );
+
+    if ( !result )
+    { ELOGW( "Error : File Write Failed. filename = %s", filename ); }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      リソーステクスチャをクックドテクスチャファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool SaveResTextureToCookedFileA( const char* filename, const asdx::ResTexture& resTexture )
+{
+    if ( filename == nullptr )
+    {
+        ELOGA( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto path = ToStringW(filename);
+    return SaveResTextureToCookedFileW(path.c_str(), resTexture);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Targaファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromTGAMemory(const uint8_t* pBinary, const uint32_t bufferSize, asdx::ResTexture& resTexture)
+{
+    // ファイルマジックをチェック.
+    if ( !IsTGA( pBinary, bufferSize ) )
+    {
+        ELOG( "Error : Invalid File Format." );
+        return false;
+    }
+
+    // ヘッダを解析して展開方法を決める.
+    TGA_DECODER decoder;
+    if ( !SetupTGADecoder( pBinary, bufferSize, decoder ) )
+    { return false; }
+
+    auto pSrc         = decoder.pSrc;
+    auto format       = decoder.Format;
+    auto bytePerPixel = decoder.BytePerPixel;
+
+    // サブリソースとピクセルデータをまとめて確保.
+    uint32_t width  = decoder.Width;
+    uint32_t height = decoder.Height;
+
+    resTexture.Width        = width;
+    resTexture.Height       = height;
+    resTexture.Depth        = 1;
+    resTexture.Format       = format;
+    resTexture.SurfaceCount = 1;
+    resTexture.MipMapCount  = 1;
+    resTexture.Option       = 0;
+
+    if ( !AllocateResTexture( resTexture ) )
+    { return false; }
+
+    // ピクセルデータを確保先に直接展開する(1ピクセル当たりのバイト数で詰めて並ぶ).
+    assert( resTexture.pResources[0].Pitch == width * bytePerPixel );
+    TGA_RLE_STATE state = {};
+    if ( !decoder.Parse( pSrc, decoder.pEnd, width * height, decoder.ColorMap, resTexture.pResources[0].pPixels, state ) )
+    {
+        ELOG( "Error : Unexpected End Of Data." );
+        resTexture.Release();
+        return false;
+    }
+
+    // 正常終了.
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Targaファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromTGAFileW(const wchar_t* filename, asdx::ResTexture& resTexture)
+{
+    // 引数チェック.
+    if ( filename == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    // 1ピクセルずつ読むと遅いので，ファイル全体をマップして解析する.
+    MappedFile file;
+    if ( !file.Open( filename ) )
+    {
+        ELOG( "Error : File Open Failed. Filename = %s", filename );
+        return false;
+    }
+
+    if ( file.GetSize() > UINT32_MAX )
+    {
+        ELOG( "Error : File Size Too Large. Filename = %s", filename );
+        return false;
+    }
+
+    return CreateResTextureFromTGAMemory( file.GetData(), uint32_t( file.GetSize() ), resTexture );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Targaファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromTGAFileA(const char* filename, asdx::ResTexture& resTexture)
+{
+    auto path = ToStringW(filename);
+    return CreateResTextureFromTGAFileW(path.c_str(), resTexture);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Radiance HDRファイルから生成できるテクスチャのフォーマットかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsSupportedHdrFormat( uint32_t format )
+{
+    switch( format )
+    {
+    case DXGI_FORMAT_R9G9B9E5_SHAREDEXP:
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R32G32B32_FLOAT:
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Radiance HDRファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromHDRMemory
+(
+    const uint8_t*              pBinary,
+    size_t                      bufferSize,
+    const TextureLoadOptions&   options,
+    asdx::ResTexture&           resTexture
+)
+{
+    if ( !IsSupportedHdrFormat( options.HdrFormat ) )
+    {
+        ELOG( "Error : Unsupported Format. format = %u", options.HdrFormat );
+        return false;
+    }
+
+    // ファイルマジックをチェック.
+    if ( !IsHDR( pBinary, bufferSize ) )
+    {
+        ELOG( "Error : Invalid File Format." );
+        return false;
+    }
+
+    uint32_t width    = 0;
+    uint32_t height   = 0;
+    bool     bottomUp = false;
+    size_t   offset   = 0;
+    if ( !ParseHDRHeader( pBinary, bufferSize, width, height, bottomUp, offset ) )
+    { return false; }
+
+    auto format      = DXGI_FORMAT( options.HdrFormat );
+    auto pixelFormat = asdx::GetPixelFormatFromDXGI( format );
+    auto pixelSize   = asdx::GetPixelFormatSize( pixelFormat );
+
+    auto sliceSize = uint64_t( width ) * height * pixelSize;
+    if ( sliceSize > UINT32_MAX )
+    {
+        ELOG( "Error : Texture Size Too Large. width = %u, height = %u", width, height );
+        return false;
+    }
+
+    // 全スキャンラインをRGBEに展開してから，まとめて変換する(大きな画像は並列に変換される).
+    std::unique_ptr<uint8_t[]> rgbe( new (std::nothrow) uint8_t [ size_t( width ) * height * 4 ] );
+    if ( !rgbe )
+    {
+        ELOG( "Error : Out Of Memory." );
+        return false;
+    }
+
+    auto pSrc = pBinary + offset;
+    auto pEnd = pBinary + bufferSize;
+    for( uint32_t y=0; y<height; ++y )
+    {
+        auto row = ( bottomUp ) ? height - 1 - y : y;
+        if ( !DecodeHDRScanline( pSrc, pEnd, width, rgbe.get() + size_t( row ) * width * 4 ) )
+        {
+            ELOG( "Error : Invalid Scanline. y = %u", y );
+            return false;
+        }
+    }
+
+    // サブリソースとピクセルデータをまとめて確保し，確保先に直接変換する.
+    resTexture.Width        = width;
+    resTexture.Height       = height;
+    resTexture.Depth        = 1;
+    resTexture.Format       = format;
+    resTexture.SurfaceCount = 1;
+    resTexture.MipMapCount  = 1;
+    resTexture.Option       = 0;
+
+    if ( !AllocateResTexture( resTexture ) )
+    { return false; }
+
+    assert( resTexture.pResources[0].Pitch == width * pixelSize );
+    if ( !asdx::ConvertPixels( rgbe.get(), asdx::PIXEL_FORMAT_R8G8B8E8_SHAREDEXP, resTexture.pResources[0].pPixels, pixelFormat, width, height ) )
+    {
+        resTexture.Release();
+        return false;
+    }
+
+    // 正常終了.
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Texture Codec Registry
+///////////////////////////////////////////////////////////////////////////////////////////////////
+namespace /* anonymous */ {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CodecRegistry structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CodecRegistry
+{
+    std::mutex                  Mutex;      //!< 登録と判定の排他制御です.
+    std::vector<TextureCodec>   Codecs;     //!< 登録されたコーデックです.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      読み込み設定を取得します. nullptrの場合は既定値を返却します.
+//-------------------------------------------------------------------------------------------------
+const TextureLoadOptions& GetLoadOptions( const TextureLoadOptions* pOptions )
+{
+    static const TextureLoadOptions s_Default;
+    return ( pOptions != nullptr ) ? *pOptions : s_Default;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      サイズが32bitに収まることを確認してからメモリデコーダを呼び出します.
+//-------------------------------------------------------------------------------------------------
+template<bool (*Decode)( const uint8_t*, const uint32_t, asdx::ResTexture& )>
+bool DecodeWithinUInt32( const uint8_t* pBinary, size_t bufferSize, const TextureLoadOptions&, asdx::ResTexture& resTexture )
+{
+    if ( bufferSize > UINT32_MAX )
+    {
+        ELOG( "Error : File Size Too Large." );
+        return false;
+    }
+
+    return Decode( pBinary, uint32_t( bufferSize ), resTexture );
+}
 
-            case 16:
-                {
-                #if 0
-                    //if ( CheckMask( ddsd.pixelFormat, 0x7c00, 0x03e0, 0x001f, 0x8000 ) )
-                    //{
-                    //    // B5 G5 R5 A1
-                    //    /* NOT_SUPPORT */
-                    //}
+//-------------------------------------------------------------------------------------------------
+//! @brief      読み込み設定を使わないメモリデコーダを呼び出します.
+//-------------------------------------------------------------------------------------------------
+template<bool (*Decode)( const uint8_t*, size_t, asdx::ResTexture& )>
+bool DecodeWithoutOptions( const uint8_t* pBinary, size_t bufferSize, const TextureLoadOptions&, asdx::ResTexture& resTexture )
+{ return Decode( pBinary, bufferSize, resTexture ); }
 
-                    //if ( CheckMask( ddsd.pixelFormat, 0xf800, 0x07e0, 0x001f, 0x0000 ) )
-                    //{
-                    //    // B5 G6 R5
-                    //    /* NOT_SUPPORT */
-                    //}
-                #endif
-                }
-                break;
-            }
-        }
-        else if ( ddsd.pixelFormat.flags & DDPF_LUMINANCE )
-        {
-            switch( ddsd.pixelFormat.bpp )
-            {
-            case 8:
-                {
-                    if ( CheckMask( ddsd.pixelFormat, 0x000000ff, 0x00000000, 0x00000000, 0x00000000 ) )
-                    {
-                        // R8
-                        isSupportFormat   = true;
-                        nativeFormat      = NATIVE_TEXTURE_FORMAT_R8;
-                        resTexture.Format = DXGI_FORMAT_R8_UNORM;
-                    }
-                }
-                break;
+//-------------------------------------------------------------------------------------------------
+//! @brief      読み込み設定を使わないマップ用の生成関数を呼び出します.
+//-------------------------------------------------------------------------------------------------
+template<bool (*Map)( MappedFile*, asdx::ResTexture& )>
+bool MapWithoutOptions( MappedFile* pFile, const TextureLoadOptions&, asdx::ResTexture& resTexture )
+{ return Map( pFile, resTexture ); }
 
-            case 16:
-                {
-                #if 0
-                    //if ( CheckMask( ddsd.pixelFormat, 0x0000ffff, 0x00000000, 0x00000000, 0x00000000 ) )
-                    //{
-                    //    // R16
-                    //    /* NOT_SUPPORT */
-                    //}
+//-------------------------------------------------------------------------------------------------
+// 組み込みのコーデックです. 登録されたコーデックで判定できなかった場合に上から順に判定します.
+//-------------------------------------------------------------------------------------------------
+const TextureCodec BUILTIN_TEXTURE_CODECS[] = {
+    { "dds",  IsDDS,            DecodeWithinUInt32<CreateResTextureFromDDSMemory>,      MapWithoutOptions<MapResTextureFromDDS>     },
+    { "atex", IsCookedTexture,  DecodeWithoutOptions<CreateResTextureFromCookedMemory>, MapWithoutOptions<MapResTextureFromCooked>  },
+    { "tga",  IsTGA,            DecodeWithinUInt32<CreateResTextureFromTGAMemory>,      nullptr                                     },
+    { "hdr",  IsHDR,            CreateResTextureFromHDRMemory,                          nullptr                                     },
+};
 
-                    //if ( CheckMask( ddsd.pixelFormat, 0x000000ff, 0x00000000, 0x00000000, 0x0000ff00 ) )
-                    //{
-                    //    // R8 G8
-                    //    /* NOT_SUPPORT */
-                    //}
-                #endif
-                }
-                break;
-            }
-        }
-        else if ( ddsd.pixelFormat.flags & DDPF_ALPHA )
+//-------------------------------------------------------------------------------------------------
+//! @brief      コーデックの登録先を取得します.
+//-------------------------------------------------------------------------------------------------
+CodecRegistry& GetCodecRegistry()
+{
+    static CodecRegistry s_Registry;
+    return s_Registry;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      バイナリの内容からコーデックを検索します.
+//!
+//! @param[in]      pBinary         バイナリデータです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @param[out]     result          見つかったコーデックです.
+//! @retval true    コーデックが見つかりました.
+//! @retval false   対応するコーデックがありません.
+//-------------------------------------------------------------------------------------------------
+bool FindTextureCodec( const uint8_t* pBinary, size_t bufferSize, TextureCodec& result )
+{
+    // 登録されたコーデックを優先して，組み込みのコーデックを置き換えられるようにする.
+    {
+        auto& registry = GetCodecRegistry();
+        std::lock_guard<std::mutex> locker( registry.Mutex );
+
+        for( const auto& codec : registry.Codecs )
         {
-            if ( 8 == ddsd.pixelFormat.bpp )
+            if ( codec.pSniff( pBinary, bufferSize ) )
             {
-                // A8
-                isSupportFormat   = true;
-                nativeFormat      = NATIVE_TEXTURE_FORMAT_A8;
-                resTexture.Format = DXGI_FORMAT_R8_UNORM;
+                result = codec;
+                return true;
             }
         }
     }
 
-    // サポートフォーマットがあったかチェック.
-    if ( !isSupportFormat )
+    for( const auto& codec : BUILTIN_TEXTURE_CODECS )
     {
-        // ファイルを閉じる.
-        fclose( pFile );
+        if ( codec.pSniff( pBinary, bufferSize ) )
+        {
+            result = codec;
+            return true;
+        }
+    }
 
-        // エラーログ出力.
-        ELOG( "Error : Unsupported Format." );
+    return false;
+}
 
-        // 異常終了.
+//-------------------------------------------------------------------------------------------------
+//! @brief      コーデックでリソーステクスチャを生成します.
+//!
+//! @param[in]      pCodec          コーデックです. nullptrの場合はWICで生成します.
+//! @param[in]      pBinary         バイナリデータです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @param[in]      options         読み込み設定です.
+//! @param[out]     resTexture      リソーステクスチャです.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//-------------------------------------------------------------------------------------------------
+bool DecodeResTexture
+(
+    const TextureCodec*         pCodec,
+    const uint8_t*              pBinary,
+    size_t                      bufferSize,
+    const TextureLoadOptions&   options,
+    asdx::ResTexture&           resTexture
+)
+{
+    if ( pCodec != nullptr )
+    { return pCodec->pDecode( pBinary, bufferSize, options, resTexture ); }
+
+    // BMP, JPEG, PNG等はWICが内容から判定する.
+    return DecodeWithinUInt32<CreateResTextureFromWICMemory>( pBinary, bufferSize, options, resTexture );
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      内容からコーデックを判定してリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool DecodeResTexture
+(
+    const uint8_t*              pBinary,
+    size_t                      bufferSize,
+    const TextureLoadOptions&   options,
+    asdx::ResTexture&           resTexture
+)
+{
+    TextureCodec codec;
+    auto found = FindTextureCodec( pBinary, bufferSize, codec );
+    return DecodeResTexture( ( found ) ? &codec : nullptr, pBinary, bufferSize, options, resTexture );
+}
+
+} // namespace /* anonymous */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureLoadOptions structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+TextureLoadOptions::TextureLoadOptions()
+: HdrFormat( DXGI_FORMAT_R9G9B9E5_SHAREDEXP )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャコーデックを登録します.
+//-------------------------------------------------------------------------------------------------
+bool RegisterTextureCodec( const TextureCodec& codec )
+{
+    if ( codec.Name == nullptr || codec.pSniff == nullptr || codec.pDecode == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
         return false;
     }
 
-    // 現在のファイル位置を記憶.
-    long curr = ftell( pFile );
+    auto& registry = GetCodecRegistry();
+    std::lock_guard<std::mutex> locker( registry.Mutex );
+
+    for( const auto& item : registry.Codecs )
+    {
+        if ( strcmp( item.Name, codec.Name ) == 0 )
+        {
+            ELOGA( "Error : Codec Already Registered. name = %s", codec.Name );
+            return false;
+        }
+    }
 
-    // ファイル末端に移動.
-    fseek( pFile, 0, SEEK_END );
+    registry.Codecs.push_back( codec );
+    return true;
+}
 
-    // ファイル末端位置を記憶.
-    long end = ftell( pFile );
+//-------------------------------------------------------------------------------------------------
+//      ファイルからテクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromFileW( const wchar_t* filename, const TextureLoadOptions& options, asdx::ResTexture& resTexture )
+{
+    if ( filename == nullptr )
+    {
+        ELOGW( "Error : Invalid Argument." );
+        return false;
+    }
 
-    // ファイル位置を元に戻す.
-    fseek( pFile, curr, SEEK_SET );
+    // ファイルを開くのは1回だけにして，形式の判定とデコードは同じマップから行う.
+    MappedFile file;
+    if ( !file.Open( filename ) )
+    {
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        return false;
+    }
 
-    // ピクセルデータのサイズを算出.
-    size_t pixelSize = end - curr;
+    return DecodeResTexture( file.GetData(), file.GetSize(), options, resTexture );
+}
 
-    // ピクセルデータのメモリを確保.
-    unsigned char* pPixelData = new unsigned char [pixelSize];
 
-    // NULLチェック.
-    if ( pPixelData == nullptr )
+//-------------------------------------------------------------------------------------------------
+//      ファイルからテクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromFileA( const char* filename, const TextureLoadOptions& options, asdx::ResTexture& resTexture )
+{
+    if ( filename == nullptr )
     {
-        // ファイルを閉じる.
-        fclose( pFile );
+        ELOGA( "Error : Invalid Argument." );
+        return false;
+    }
 
-        // エラーログ出力.
-        ELOG( "Error : Memory Allocate Failed." );
+    auto path = ToStringW(filename);
+    return CreateResTextureFromFileW( path.c_str(), options, resTexture );
+}
 
-        // 異常終了.
+
+//-------------------------------------------------------------------------------------------------
+//      メモリストリームからテクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromMemory
+(
+    const uint8_t*              pBinary,
+    const uint32_t              bufferSize,
+    const TextureLoadOptions&   options,
+    asdx::ResTexture&           resTexture
+)
+{
+    if ( pBinary == nullptr || bufferSize < 4 )
+    {
+        ELOG( "Error : Invalid Argument." );
         return false;
     }
 
-    // ピクセルデータ読み込み.
-    fread( pPixelData, sizeof( unsigned char ), pixelSize, pFile );
+    return DecodeResTexture( pBinary, bufferSize, options, resTexture );
+}
 
-    // ファイルを閉じる.
-    fclose( pFile );
+//-------------------------------------------------------------------------------------------------
+//      ファイルをマップしてテクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool MapResTextureFromFileW( const wchar_t* filename, const TextureLoadOptions& options, asdx::ResTexture& resTexture )
+{
+    if ( filename == nullptr )
+    {
+        ELOGW( "Error : Invalid Argument." );
+        return false;
+    }
 
-    // リトルエンディアンなのでピクセルの並びを補正.
-    switch( nativeFormat )
+    auto pFile = new (std::nothrow) MappedFile();
+    if ( pFile == nullptr )
     {
-        // 一括読み込みでくるっているので修正.
-        case NATIVE_TEXTURE_FORMAT_ARGB_8888:
-        case NATIVE_TEXTURE_FORMAT_XRGB_8888:
-        {
-            for( size_t i=0; i<pixelSize; i+=4 )
-            {
-                // BGRA -> RGBA
-                unsigned char R = pPixelData[ i + 0 ];
-                unsigned char B = pPixelData[ i + 2 ];
-                pPixelData[ i + 0 ] = B;
-                pPixelData[ i + 2 ] = R;
-            }
-        }
-        break;
+        ELOG( "Error : Out of Memory." );
+        return false;
+    }
+
+    // ピクセルの並び替えでファイルを書き換えないように書き込み時コピーでマップする.
+    if ( !pFile->Open( filename, true ) )
+    {
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        delete pFile;
+        return false;
     }
 
-    size_t offset  = 0;
-    size_t idx     = 0;
-    size_t skipMip = 0;
+    // マップを直接参照できる形式はマップの所有権ごと渡す.
+    TextureCodec codec;
+    auto found = FindTextureCodec( pFile->GetData(), pFile->GetSize(), codec );
+    if ( found && codec.pMap != nullptr )
+    { return codec.pMap( pFile, options, resTexture ); }
 
-    // リソースデータのメモリを確保.
-    resTexture.pResources = new SubResource[ resTexture.MipMapCount * resTexture.SurfaceCount ];
+    // それ以外は同じマップからデコードして，マップは解除する.
+    auto result = DecodeResTexture( ( found ) ? &codec : nullptr, pFile->GetData(), pFile->GetSize(), options, resTexture );
+    delete pFile;
+
+    return result;
+}
 
-    // 各ミップレベルごとに処理.
-    for ( size_t j=0; j<resTexture.MipMapCount; ++j )
+//-------------------------------------------------------------------------------------------------
+//      ファイルをマップしてテクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool MapResTextureFromFileA( const char* filename, const TextureLoadOptions& options, asdx::ResTexture& resTexture )
+{
+    if ( filename == nullptr )
     {
-        size_t w = width;
-        size_t h = height;
-        size_t d = depth;
+        ELOGA( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto path = ToStringW(filename);
+    return MapResTextureFromFileW( path.c_str(), options, resTexture );
+}
 
-        for( size_t i=0; i<resTexture.SurfaceCount; ++i )
-        {
-            size_t rowBytes = 0;
-            size_t numRows  = 0;
-            size_t numBytes = 0;
-
-            // ブロック圧縮フォーマットの場合.
-            if ( ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC1 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC2 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC3 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4U )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4S )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC5U )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC5S ) )
-            {
-                size_t bcPerBlock = 0;
-                size_t blockWide  = 0;
-                size_t blockHigh  = 0;
-
-                // BC1, BC4の場合.
-                if ( ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC1 )
-                  || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4S )
-                  || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4U ) )
-                { bcPerBlock = 8; }
-                // BC2, BC3, BC5, BC6H, BC7の場合.
-                else
-                { bcPerBlock = 16; }
 
-                // 横幅が1以上の場合.
-                if ( w > 0 )
-                { blockWide = Max< size_t >( 1, ( w + 3 ) / 4 ); }
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Image Streaming
+///////////////////////////////////////////////////////////////////////////////////////////////////
+namespace /* anonymous */ {
 
-                // 縦幅が異常の場合.
-                if ( h > 0 )
-                { blockHigh = Max< size_t >( 1, ( h + 3 ) / 4 ); }
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t DEFAULT_BAND_HEIGHT = 64;     // 帯の既定の行数です.
 
-                // 一行のバイト数.
-                rowBytes = blockWide * bcPerBlock;
+//-------------------------------------------------------------------------------------------------
+//! @brief      1つの帯の行数を決定します.
+//!
+//! @param[in]      bandHeight      指定された行数です. 0の場合は既定値を使います.
+//! @param[in]      height          画像の縦幅です.
+//! @param[in]      blockCompressed ブロック圧縮フォーマットかどうか.
+//! @return     帯の行数を返却します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GetBandHeight( uint32_t bandHeight, uint32_t height, bool blockCompressed )
+{
+    if ( bandHeight == 0 )
+    { bandHeight = DEFAULT_BAND_HEIGHT; }
 
-                // 行数.
-                numRows  = blockHigh;
-            }
-            // ブロック圧縮フォーマット以外の場合.
-            else
-            {
-                // 1ピクセル当たりのビット数.
-                size_t bpp = GetBitPerPixel( nativeFormat );
+    // ブロック圧縮フォーマットはブロック行の途中で分割しない.
+    if ( blockCompressed )
+    { bandHeight = ( bandHeight + 3 ) & ~3u; }
 
-                // 一行のバイト数.
-                rowBytes = ( w * bpp + 7 ) / 8;
+    return ( bandHeight < height ) ? bandHeight : height;
+}
 
-                // 行数.
-                numRows  = h;
-            }
+//-------------------------------------------------------------------------------------------------
+//! @brief      サブリソースを帯に分けてシンクに渡します.
+//!
+//! @param[in]      res             サブリソースです.
+//! @param[in]      format          DXGIフォーマットです.
+//! @param[in]      swizzle         BGRA から RGBA に並び替えて渡す場合は true です.
+//! @param[in]      pSink           シンクです.
+//! @param[in]      bandHeight      帯の行数です.
+//! @retval true    全ての帯を渡し終えました.
+//! @retval false   失敗したか，シンクが中断しました.
+//! @note       並び替えが不要な場合はサブリソースを直接指して渡すので，コピーは行いません.
+//-------------------------------------------------------------------------------------------------
+bool StreamSubResource
+(
+    const asdx::SubResource&    res,
+    uint32_t                    format,
+    bool                        swizzle,
+    asdx::IImageSink*           pSink,
+    uint32_t                    bandHeight
+)
+{
+    auto blockCompressed = asdx::IsBlockCompressedFormat( format );
+    auto band            = GetBandHeight( bandHeight, res.Height, blockCompressed );
+    auto rowsPerBlock    = ( blockCompressed ) ? 4u : 1u;
 
-            // データ数 = (1行当たりのバイト数) * 行数.
-            numBytes = rowBytes * numRows;
+    std::unique_ptr<uint8_t[]> buffer;
+    if ( swizzle )
+    {
+        buffer.reset( new (std::nothrow) uint8_t [ size_t( res.Pitch ) * band ] );
+        if ( !buffer )
+        {
+            ELOG( "Error : Out Of Memory." );
+            return false;
+        }
+    }
 
-            // リソースデータを設定.
-            resTexture.pResources[ idx ].Width      = uint32_t( w );
-            resTexture.pResources[ idx ].Height     = uint32_t( h );
-            resTexture.pResources[ idx ].Pitch      = uint32_t( rowBytes );
-            resTexture.pResources[ idx ].SlicePitch = uint32_t( numBytes );
-            resTexture.pResources[ idx ].pPixels    = new uint8_t [ numBytes ];
-
-            // NULLチェック.
-            if ( resTexture.pResources[ i ].pPixels == nullptr )
-            {
-                // エラーログ出力.
-                ELOG( "Error : Memory Allocate Failed." );
+    asdx::ImageStreamInfo info = { res.Width, res.Height, format };
+    if ( !pSink->OnBegin( info ) )
+    { return false; }
 
-                // 異常終了.
-                return false;
-            }
+    for( uint32_t y=0; y<res.Height; y+=band )
+    {
+        auto count   = ( res.Height - y < band ) ? res.Height - y : band;
+        auto rows    = ( count + rowsPerBlock - 1 ) / rowsPerBlock;
+        auto pPixels = res.pPixels + size_t( y / rowsPerBlock ) * res.Pitch;
 
-            // ピクセルデータをコピー.
-            std::memcpy( resTexture.pResources[ idx ].pPixels, pPixelData + offset, numBytes );
+        if ( swizzle )
+        {
+            asdx::SwizzleBGRAToRGBA( pPixels, buffer.get(), uint32_t( size_t( res.Pitch ) * rows / 4 ) );
+            pPixels = buffer.get();
+        }
 
-            // オフセットをカウントアップ.
-            offset += numBytes;
+        if ( !pSink->OnBand( y, count, pPixels, res.Pitch ) )
+        { return false; }
+    }
+
+    return pSink->OnEnd();
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      DDSファイルの最初のサーフェイスの最上位ミップレベルを帯ごとに渡します.
+//-------------------------------------------------------------------------------------------------
+bool StreamDDS( const uint8_t* pBinary, size_t bufferSize, asdx::IImageSink* pSink, uint32_t bandHeight )
+{
+    asdx::ResTexture header;
+    uint32_t nativeFormat = 0;
+    size_t   dataOffset   = 0;
+    if ( !ParseDDSHeader( pBinary, bufferSize, header, nativeFormat, dataOffset ) )
+    { return false; }
+
+    if ( header.Option & asdx::SUBRESOURCE_OPTION_VOLUME )
+    {
+        ELOG( "Error : Volume Texture Not Supported." );
+        return false;
+    }
 
-            // インデックスをカウントアップ.
-            idx++;
-        }
+    if ( header.Width == 0 || header.Height == 0 )
+    {
+        ELOG( "Error : Invalid Size." );
+        return false;
+    }
 
-        // 横幅，縦幅を更新.
-        w = w >> 1;
-        h = h >> 1;
-        d = d >> 1;
+    size_t rowBytes = 0;
+    size_t numRows  = 0;
+    GetSurfaceInfo( header.Width, header.Height, nativeFormat, rowBytes, numRows );
 
-        // クランプ処理.
-        if ( w == 0 ) { w = 1; }
-        if ( h == 0 ) { h = 1; }
-        if ( d == 0 ) { d = 1; }
+    // DDSはサーフェイスごとに全ミップレベルが並ぶので，最初のサーフェイスの最上位ミップレベルはヘッダの直後にある.
+    auto remain = bufferSize - dataOffset;
+    if ( rowBytes > UINT32_MAX || ( numRows > 0 && rowBytes > remain / numRows ) )
+    {
+        ELOG( "Error : Out of Range." );
+        return false;
     }
 
-    // 不要になったメモリを解放.
-    delete [] pPixelData;
-    pPixelData = nullptr;
-
-    // 正常終了.
-    return true;
-}
+    asdx::SubResource res;
+    res.Width      = header.Width;
+    res.Height     = header.Height;
+    res.Pitch      = uint32_t( rowBytes );
+    res.SlicePitch = uint32_t( rowBytes * numRows );
+    res.pPixels    = const_cast<uint8_t*>( pBinary + dataOffset );
 
-//-------------------------------------------------------------------------------------------------
-//      DDSファイルからリソーステクスチャを生成します.
-//-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromDDSFileA( const char* filename, asdx::ResTexture& resTexture )
-{
-    auto path = ToStringW(filename);
-    return CreateResTextureFromDDSFileW(path.c_str(), resTexture);
+    return StreamSubResource( res, header.Format, NeedSwizzle( nativeFormat ), pSink, bandHeight );
 }
 
 //-------------------------------------------------------------------------------------------------
-//      DDSからリソーステクスチャを生成します.
+//! @brief      Targaファイルを帯ごとに展開して渡します.
+//!             行の並びは読み込み時と同じく，ファイルに格納された順になります.
 //-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromDDSMemory( const uint8_t* pBinary, const uint32_t bufferSize, asdx::ResTexture& resTexture )
+bool StreamTGA( const uint8_t* pBinary, size_t bufferSize, asdx::IImageSink* pSink, uint32_t bandHeight )
 {
-    uint32_t             width  = 0;
-    uint32_t             height = 0;
-    uint32_t             depth  = 0;
-    uint32_t             nativeFormat = 0;
-
-    if ( pBinary == nullptr || bufferSize == 0 )
+    if ( !IsTGA( pBinary, bufferSize ) )
     {
-        ELOG( "Error : Invalid Argument." );
+        ELOG( "Error : Invalid File Format." );
         return false;
     }
 
-    // マジックをチェック.
-    if ( ( pBinary[0] != 'D' )
-      || ( pBinary[1] != 'D' )
-      || ( pBinary[2] != 'S' )
-      || ( pBinary[3] != ' ' ) )
-    {
-        // エラーログ出力.
-        ELOG( "Error : Invalid File. " );
+    TGA_DECODER decoder;
+    if ( !SetupTGADecoder( pBinary, bufferSize, decoder ) )
+    { return false; }
 
-        // 異常終了.
+    if ( decoder.Width == 0 || decoder.Height == 0 )
+    {
+        ELOG( "Error : Invalid Size." );
         return false;
     }
 
-    uint8_t* pCur = (uint8_t*)pBinary + sizeof(char) * 4;
-    uint32_t offset = sizeof(char) * 4;
-    if ( offset > bufferSize )
+    auto band  = GetBandHeight( bandHeight, decoder.Height, false );
+    auto pitch = decoder.Width * decoder.BytePerPixel;
+
+    std::unique_ptr<uint8_t[]> pixels( new (std::nothrow) uint8_t [ size_t( pitch ) * band ] );
+    if ( !pixels )
     {
-        ELOG( "Error : Out of Range." );
+        ELOG( "Error : Out Of Memory." );
         return false;
     }
-    DDSurfaceDesc* ddsd = (DDSurfaceDesc*)pCur;
-    offset += sizeof(DDSurfaceDesc);
-    if ( offset > bufferSize )
+
+    asdx::ImageStreamInfo info = { decoder.Width, decoder.Height, uint32_t( decoder.Format ) };
+    if ( !pSink->OnBegin( info ) )
+    { return false; }
+
+    // RLEパケットは行をまたげるので，展開状態を帯の間で引き継ぐ.
+    TGA_RLE_STATE state = {};
+    auto pSrc = decoder.pSrc;
+
+    for( uint32_t y=0; y<decoder.Height; y+=band )
     {
-        ELOG( "Error : Out of Range." );
-        return false;
+        auto count = ( decoder.Height - y < band ) ? decoder.Height - y : band;
+        if ( !decoder.Parse( pSrc, decoder.pEnd, count * decoder.Width, decoder.ColorMap, pixels.get(), state ) )
+        {
+            ELOG( "Error : Unexpected End Of Data." );
+            return false;
+        }
+
+        if ( !pSink->OnBand( y, count, pixels.get(), pitch ) )
+        { return false; }
     }
-    pCur += sizeof(DDSurfaceDesc);
 
-    // 高さ有効.
-    if ( ddsd->flags & DDSD_HEIGHT )
-    { height = ddsd->height; }
+    return pSink->OnEnd();
+}
 
-    // 幅有効.
-    if ( ddsd->flags & DDSD_WIDTH )
-    { width = ddsd->width; }
+//-------------------------------------------------------------------------------------------------
+//! @brief      Radiance HDRファイルを帯ごとに展開して渡します.
+//!             読み込み設定のフォーマットに変換し，上の行から順に渡します.
+//-------------------------------------------------------------------------------------------------
+bool StreamHDR
+(
+    const uint8_t*              pBinary,
+    size_t                      bufferSize,
+    const TextureLoadOptions&   options,
+    asdx::IImageSink*           pSink,
+    uint32_t                    bandHeight
+)
+{
+    if ( !IsSupportedHdrFormat( options.HdrFormat ) )
+    {
+        ELOG( "Error : Unsupported Format. format = %u", options.HdrFormat );
+        return false;
+    }
 
-    // 奥行有効.
-    if ( ddsd->flags & DDSD_DEPTH )
-    { depth = ddsd->depth; }
+    if ( !IsHDR( pBinary, bufferSize ) )
+    {
+        ELOG( "Error : Invalid File Format." );
+        return false;
+    }
 
-    resTexture.Width        = width;
-    resTexture.Height       = height;
-    resTexture.Depth        = 0;
-    resTexture.SurfaceCount = 1;
-    resTexture.MipMapCount  = 1;
+    uint32_t width    = 0;
+    uint32_t height   = 0;
+    bool     bottomUp = false;
+    size_t   offset   = 0;
+    if ( !ParseHDRHeader( pBinary, bufferSize, width, height, bottomUp, offset ) )
+    { return false; }
 
-    // ミップマップ数.有効
-    if ( ddsd->flags & DDSD_MIPMAPCOUNT )
-    { resTexture.MipMapCount = ddsd->mipMapLevels; }
+    auto format      = options.HdrFormat;
+    auto pixelFormat = asdx::GetPixelFormatFromDXGI( format );
+    auto pitch       = width * asdx::GetPixelFormatSize( pixelFormat );
+    auto band        = GetBandHeight( bandHeight, height, false );
 
-    // キューブマップとボリュームテクスチャのチェック.
-    if ( ddsd->caps & DDSCAPS_COMPLEX )
+    std::unique_ptr<uint8_t[]> rgbe  ( new (std::nothrow) uint8_t [ size_t( width ) * band * 4 ] );
+    std::unique_ptr<uint8_t[]> pixels( new (std::nothrow) uint8_t [ size_t( pitch ) * band ] );
+    if ( !rgbe || !pixels )
     {
-        // キューブマップの場合.
-        if ( ddsd->caps2 & DDSCAPS2_CUBEMAP )
-        {
-            unsigned int surfaceCount = 0;
-
-            // サーフェイス数をチェック.
-            if ( ddsd->caps2 & DDSCAPS2_CUBEMAP_POSITIVE_X ) { surfaceCount++; }
-            if ( ddsd->caps2 & DDSCAPS2_CUBEMAP_NEGATIVE_X ) { surfaceCount++; }
-            if ( ddsd->caps2 & DDSCAPS2_CUBEMAP_POSITIVE_Y ) { surfaceCount++; }
-            if ( ddsd->caps2 & DDSCAPS2_CUBEMAP_NEGATIVE_Y ) { surfaceCount++; }
-            if ( ddsd->caps2 & DDSCAPS2_CUBEMAP_POSITIVE_Z ) { surfaceCount++; }
-            if ( ddsd->caps2 & DDSCAPS2_CUBEMAP_NEGATIVE_Z ) { surfaceCount++; }
+        ELOG( "Error : Out Of Memory." );
+        return false;
+    }
 
-            // 一応チェック.
-            assert( surfaceCount == 6 );
+    auto pSrc = pBinary + offset;
+    auto pEnd = pBinary + bufferSize;
 
-            // サーフェイス数を設定.
-            resTexture.SurfaceCount = surfaceCount;
-            resTexture.Option |= SUBRESOURCE_OPTION_CUBEMAP;
-        }
-        // ボリュームテクスチャの場合.
-        else if ( ddsd->caps2 & DDSCAPS2_VOLUME )
+    // 下の行から格納されている場合は上の行から渡せるように，先に各行の開始位置を調べておく.
+    // スキャンラインはRLE圧縮されていて長さが分からないので，1行分の領域に展開しながら進める.
+    std::vector<size_t> rowOffsets;
+    if ( bottomUp )
+    {
+        rowOffsets.resize( height );
+        for( uint32_t y=0; y<height; ++y )
         {
-            // 奥行の値を設定.
-            resTexture.Depth = depth;
-            resTexture.Option |= SUBRESOURCE_OPTION_VOLUME;
+            rowOffsets[ height - 1 - y ] = size_t( pSrc - pBinary );
+            if ( !DecodeHDRScanline( pSrc, pEnd, width, rgbe.get() ) )
+            {
+                ELOG( "Error : Invalid Scanline. y = %u", y );
+                return false;
+            }
         }
     }
 
-    // サポートフォーマットのチェックフラグ.
-    bool isSupportFormat = false;
+    asdx::ImageStreamInfo info = { width, height, format };
+    if ( !pSink->OnBegin( info ) )
+    { return false; }
 
-    // ピクセルフォーマット有効.
-    if ( ddsd->flags & DDSD_PIXELFORMAT )
+    for( uint32_t y=0; y<height; y+=band )
     {
-        // dwFourCC有効
-        if ( ddsd->pixelFormat.flags & DDPF_FOURCC )
+        auto count = ( height - y < band ) ? height - y : band;
+        for( uint32_t i=0; i<count; ++i )
         {
-            switch( ddsd->pixelFormat.fourCC )
+            if ( bottomUp )
+            { pSrc = pBinary + rowOffsets[ y + i ]; }
+
+            if ( !DecodeHDRScanline( pSrc, pEnd, width, rgbe.get() + size_t( i ) * width * 4 ) )
             {
-            case FOURCC_DXT1:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC1_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC1;
-                    isSupportFormat   = true;
-                }
-                break;
+                ELOG( "Error : Invalid Scanline. y = %u", y + i );
+                return false;
+            }
+        }
 
-            case FOURCC_DXT2:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC2_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC2;
-                    isSupportFormat   = true;
-                }
-                break;
+        if ( !asdx::ConvertPixels( rgbe.get(), asdx::PIXEL_FORMAT_R8G8B8E8_SHAREDEXP, pixels.get(), pixelFormat, width, count ) )
+        { return false; }
 
-            case FOURCC_DXT3:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC2_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC2;
-                    isSupportFormat   = true;
-                }
-                break;
+        if ( !pSink->OnBand( y, count, pixels.get(), pitch ) )
+        { return false; }
+    }
 
-            case FOURCC_DXT4:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC3_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC3;
-                    isSupportFormat   = true;
-                }
-                break;
+    return pSink->OnEnd();
+}
 
-            case FOURCC_DXT5:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC3_UNORM_SRGB;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC3;
-                    isSupportFormat   = true;
-                }
-                break;
+//-------------------------------------------------------------------------------------------------
+//! @brief      WICで読める画像を帯ごとに展開して渡します.
+//!             フォーマットは読み込み時と同じ規則で決定しますが，最大サイズへの縮小は行いません.
+//! @note       デコーダ内部のバッファはWICの実装に依存します.
+//-------------------------------------------------------------------------------------------------
+bool StreamWIC( const uint8_t* pBinary, size_t bufferSize, asdx::IImageSink* pSink, uint32_t bandHeight )
+{
+    if ( bufferSize > UINT32_MAX )
+    {
+        ELOG( "Error : File Size Too Large." );
+        return false;
+    }
 
-            case FOURCC_ATI1:
-            case FOURCC_BC4U:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC4_UNORM;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC4U;
-                    isSupportFormat   = true;
-                }
-                break;
+    IWICImagingFactory* pWIC = GetWIC();
+    if ( !pWIC )
+    { return false; }
 
-            case FOURCC_BC4S:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC5_SNORM;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC4S;
-                    isSupportFormat   = true;
-                }
-                break;
+    ComPtr<IWICStream> pStream;
+    HRESULT hr = pWIC->CreateStream( &pStream );
+    if ( FAILED( hr ) )
+    { return false; }
 
-            case FOURCC_ATI2:
-            case FOURCC_BC5U:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC5_UNORM;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC5U;
-                    isSupportFormat   = true;
-                }
-                break;
+    hr = pStream->InitializeFromMemory( (BYTE*)pBinary, uint32_t( bufferSize ) );
+    if ( FAILED( hr ) )
+    { return false; }
 
-            case FOURCC_BC5S:
-                {
-                    resTexture.Format = DXGI_FORMAT_BC5_SNORM;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_BC5S;
-                    isSupportFormat   = true;
-                }
-                break;
+    ComPtr<IWICBitmapDecoder> decoder;
+    hr = pWIC->CreateDecoderFromStream( pStream.Get(), 0, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf() );
+    if ( FAILED( hr ) )
+    {
+        ELOG( "Error : Unsupported File Format." );
+        return false;
+    }
 
-            case FOURCC_DX10:
-                {
-                }
-                break;
+    ComPtr<IWICBitmapFrameDecode> frame;
+    hr = decoder->GetFrame( 0, frame.GetAddressOf() );
+    if ( FAILED( hr ) )
+    { return false; }
 
-            case 36: // D3DFMT_A16B16G16R16
-                {
-                    // DXGI_FORMAT_R16G61B16A16_UNORM
-                }
-                break;
+    uint32_t width  = 0;
+    uint32_t height = 0;
+    hr = frame->GetSize( &width, &height );
+    if ( FAILED( hr ) || width == 0 || height == 0 )
+    { return false; }
 
-            case 110: // D3DFMT_W16W16V16U16
-                {
-                    // DXGI_FORMAT_R16G16B16A16_SNORM;
-                }
-                break;
+    WICPixelFormatGUID pixelFormat;
+    hr = frame->GetPixelFormat( &pixelFormat );
+    if ( FAILED( hr ) )
+    { return false; }
 
-            case 111: // D3DFMT_R16F
-                {
-                    // DXGI_FORMAT_R16_FLOAT
-                    resTexture.Format = DXGI_FORMAT_R16_FLOAT;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_R16_FLOAT;
-                    isSupportFormat   = true;
-                }
-                break;
+    WICPixelFormatGUID convertGUID;
+    DXGI_FORMAT        format = DXGI_FORMAT_UNKNOWN;
+    size_t             bpp    = 0;
+    if ( !ResolveWICFormat( pixelFormat, convertGUID, format, bpp ) )
+    {
+        ELOG( "Error : Unsupported Pixel Format." );
+        return false;
+    }
 
-            case 112: // D3DFMT_G16R16F
-                {
-                    // DXGI_FORMAT_R16G16_FLOAT
-                    resTexture.Format = DXGI_FORMAT_R16G16_FLOAT;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_G16R16_FLOAT;
-                    isSupportFormat   = true;
-                }
-                break;
+    // 読み込み時と同じくsRGBとして扱う.
+    format = MakeSRGB( format );
 
-            case 113: // D3DFMT_A16B16G16R16F
-                {
-                    // DXGI_FORMAT_R16G16B16A16_FLOAT
-                    resTexture.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_A16B16G16R16_FLOAT;
-                    isSupportFormat   = true;
-                }
-                break;
+    ComPtr<IWICBitmapSource> source( frame );
+    if ( memcmp( &convertGUID, &pixelFormat, sizeof(GUID) ) != 0 )
+    {
+        ComPtr<IWICFormatConverter> conv;
+        hr = pWIC->CreateFormatConverter( conv.GetAddressOf() );
+        if ( FAILED( hr ) )
+        { return false; }
+
+        hr = conv->Initialize( frame.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom );
+        if ( FAILED( hr ) )
+        { return false; }
 
-            case 114: // D3DFMT_R32F
-                {
-                    // DXGI_FORMAT_R32_FLOAT
-                    resTexture.Format = DXGI_FORMAT_R32_FLOAT;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_R32_FLOAT;
-                    isSupportFormat   = true;
-                }
-                break;
+        source = conv;
+    }
 
-            case 115: // D3DFMT_G32R32F
-                {
-                    // DXGI_FORMAT_R32G32_FLOAT
-                    resTexture.Format = DXGI_FORMAT_R32G32_FLOAT;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_G32R32_FLOAT;
-                    isSupportFormat   = true;
-                }
-                break;
+    auto rowPitch = ( size_t( width ) * bpp + 7 ) / 8;
+    if ( rowPitch > UINT32_MAX )
+    {
+        ELOG( "Error : Texture Size Too Large. width = %u", width );
+        return false;
+    }
 
-            case 116: // D3DFMT_A32B32G32R32F
-                {
-                    // DXGI_FORMAT_R32G32B32A32_FLOAT
-                    resTexture.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-                    nativeFormat      = NATIVE_TEXTURE_FORMAT_A32B32G32R32_FLOAT;
-                    isSupportFormat   = true;
-                }
-                break;
+    auto band = GetBandHeight( bandHeight, height, false );
+    std::unique_ptr<uint8_t[]> pixels( new (std::nothrow) uint8_t [ rowPitch * band ] );
+    if ( !pixels )
+    {
+        ELOG( "Error : Out Of Memory." );
+        return false;
+    }
 
-            default:
-                {
-                    isSupportFormat = false;
-                }
-                break;
-            }
-        }
-        else if ( ddsd->pixelFormat.flags & DDPF_RGB )
+    asdx::ImageStreamInfo info = { width, height, uint32_t( format ) };
+    if ( !pSink->OnBegin( info ) )
+    { return false; }
+
+    for( uint32_t y=0; y<height; y+=band )
+    {
+        auto count = ( height - y < band ) ? height - y : band;
+
+        WICRect rect = { 0, INT( y ), INT( width ), INT( count ) };
+        hr = source->CopyPixels( &rect, uint32_t( rowPitch ), uint32_t( rowPitch * count ), pixels.get() );
+        if ( FAILED( hr ) )
         {
-            switch( ddsd->pixelFormat.bpp )
-            {
-            case 32:
-                {
-                    if ( CheckMask( ddsd->pixelFormat, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000 ) )
-                    {
-                        // A8 R8 G8 B8
-                        isSupportFormat   = true;
-                        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-                        nativeFormat      = NATIVE_TEXTURE_FORMAT_ARGB_8888;
-                    }
+            ELOG( "Error : CopyPixels() Failed. y = %u", y );
+            return false;
+        }
 
-                    if ( CheckMask( ddsd->pixelFormat, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 ) )
-                    {
-                        // A8 B8 G8 R8
-                        isSupportFormat   = true;
-                        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-                        nativeFormat      = NATIVE_TEXTURE_FORMAT_ABGR_8888;
-                    }
+        if ( !pSink->OnBand( y, count, pixels.get(), uint32_t( rowPitch ) ) )
+        { return false; }
+    }
 
-                    if ( CheckMask( ddsd->pixelFormat, 0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000 ) )
-                    {
-                        // X8 R8 G8 B8
-                        isSupportFormat   = true;
-                        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-                        nativeFormat      = NATIVE_TEXTURE_FORMAT_XRGB_8888;
-                    }
+    return pSink->OnEnd();
+}
 
-                    if ( CheckMask( ddsd->pixelFormat, 0x000000ff, 0x0000ff00, 0x00ff0000, 0x00000000 ) )
-                    {
-                        // X8 B8 G8 R8
-                        isSupportFormat = true;
-                        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-                        nativeFormat = NATIVE_TEXTURE_FORMAT_XBGR_8888;
-                    }
+//-------------------------------------------------------------------------------------------------
+//! @brief      帯ごとに展開できない形式を，全体をデコードしてから帯に分けて渡します.
+//-------------------------------------------------------------------------------------------------
+bool StreamDecoded
+(
+    const TextureCodec&         codec,
+    const uint8_t*              pBinary,
+    size_t                      bufferSize,
+    const TextureLoadOptions&   options,
+    asdx::IImageSink*           pSink,
+    uint32_t                    bandHeight
+)
+{
+    asdx::ResTexture texture;
+    if ( !codec.pDecode( pBinary, bufferSize, options, texture ) )
+    { return false; }
 
-                #if 0
-                    //if ( CheckMask( ddsd->pixelFormat, 0x3ff00000, 0x000ffc00, 0x000003ff, 0xc0000000 ) )
-                    //{
-                    //    // R10 G10 B10 A2
-                    //    /* NOT_SUPPORT */
-                    //}
+    auto result = false;
+    if ( texture.pResources == nullptr || ( texture.Option & asdx::SUBRESOURCE_OPTION_VOLUME ) )
+    { ELOG( "Error : Unsupported Texture." ); }
+    else
+    { result = StreamSubResource( texture.pResources[0], texture.Format, false, pSink, bandHeight ); }
 
-                    //if ( CheckMask( ddsd->pixelFormat, 0x0000ffff, 0xffff0000, 0x00000000, 0x00000000 ) )
-                    //{
-                    //    // R16 G16
-                    //    /* NOT_SUPPORT */
-                    //}
-                    //if ( CheckMask( ddsd->pixelFormat, 0xffffffff, 0x00000000,0x00000000,0x00000000 ) )
-                    //{
-                    //    // R32
-                    //    /* NOT_SUPPORT */
-                    //}
-                #endif
-                }
-                break;
+    texture.Release();
+    return result;
+}
 
-            case 24:
-                {
-                #if 0
-                    /* NOT_SUPPORT */
-                #endif
-                }
-                break;
+} // namespace /* anonymous */
 
-            case 16:
-                {
-                #if 0
-                    //if ( CheckMask( ddsd->pixelFormat, 0x7c00, 0x03e0, 0x001f, 0x8000 ) )
-                    //{
-                    //    // B5 G5 R5 A1
-                    //    /* NOT_SUPPORT */
-                    //}
+//-------------------------------------------------------------------------------------------------
+//      メモリ上のファイルイメージを帯ごとにデコードしてシンクに渡します.
+//-------------------------------------------------------------------------------------------------
+bool StreamImageFromMemory
+(
+    const uint8_t*              pBinary,
+    size_t                      bufferSize,
+    IImageSink*                 pSink,
+    uint32_t                    bandHeight,
+    const TextureLoadOptions*   pOptions
+)
+{
+    if ( pBinary == nullptr || bufferSize < 4 || pSink == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
 
-                    //if ( CheckMask( ddsd->pixelFormat, 0xf800, 0x07e0, 0x001f, 0x0000 ) )
-                    //{
-                    //    // B5 G6 R5
-                    //    /* NOT_SUPPORT */
-                    //}
-                #endif
-                }
-                break;
-            }
-        }
-        else if ( ddsd->pixelFormat.flags & DDPF_LUMINANCE )
-        {
-            switch( ddsd->pixelFormat.bpp )
-            {
-            case 8:
-                {
-                    if ( CheckMask( ddsd->pixelFormat, 0x000000ff, 0x00000000, 0x00000000, 0x00000000 ) )
-                    {
-                        // R8
-                        isSupportFormat   = true;
-                        nativeFormat      = NATIVE_TEXTURE_FORMAT_R8;
-                        resTexture.Format = DXGI_FORMAT_R8_UNORM;
-                    }
-                }
-                break;
+    TextureCodec codec;
+    if ( !FindTextureCodec( pBinary, bufferSize, codec ) )
+    { return StreamWIC( pBinary, bufferSize, pSink, bandHeight ); }
 
-            case 16:
-                {
-                #if 0
-                    //if ( CheckMask( ddsd->pixelFormat, 0x0000ffff, 0x00000000, 0x00000000, 0x00000000 ) )
-                    //{
-                    //    // R16
-                    //    /* NOT_SUPPORT */
-                    //}
+    // 組み込みのコーデックと同じ関数で判定された場合のみ，帯ごとに展開する.
+    if ( codec.pSniff == IsDDS )
+    { return StreamDDS( pBinary, bufferSize, pSink, bandHeight ); }
 
-                    //if ( CheckMask( ddsd->pixelFormat, 0x000000ff, 0x00000000, 0x00000000, 0x0000ff00 ) )
-                    //{
-                    //    // R8 G8
-                    //    /* NOT_SUPPORT */
-                    //}
-                #endif
-                }
-                break;
-            }
-        }
-        else if ( ddsd->pixelFormat.flags & DDPF_ALPHA )
-        {
-            if ( 8 == ddsd->pixelFormat.bpp )
-            {
-                // A8
-                isSupportFormat   = true;
-                nativeFormat      = NATIVE_TEXTURE_FORMAT_A8;
-                resTexture.Format = DXGI_FORMAT_R8_UNORM;
-            }
-        }
+    if ( codec.pSniff == IsTGA )
+    { return StreamTGA( pBinary, bufferSize, pSink, bandHeight ); }
+
+    if ( codec.pSniff == IsHDR )
+    { return StreamHDR( pBinary, bufferSize, GetLoadOptions( pOptions ), pSink, bandHeight ); }
+
+    return StreamDecoded( codec, pBinary, bufferSize, GetLoadOptions( pOptions ), pSink, bandHeight );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルを帯ごとにデコードしてシンクに渡します.
+//-------------------------------------------------------------------------------------------------
+bool StreamImageFromFileW( const wchar_t* filename, IImageSink* pSink, uint32_t bandHeight, const TextureLoadOptions* pOptions )
+{
+    if ( filename == nullptr || pSink == nullptr )
+    {
+        ELOGW( "Error : Invalid Argument." );
+        return false;
     }
 
-    // サポートフォーマットがあったかチェック.
-    if ( !isSupportFormat )
+    // 読み込み専用でマップして，必要なページだけを読み込む.
+    MappedFile file;
+    if ( !file.Open( filename ) )
     {
-        // エラーログ出力.
-        ELOG( "Error : Unsupported Format." );
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        return false;
+    }
 
-        // 異常終了.
+    return StreamImageFromMemory( file.GetData(), file.GetSize(), pSink, bandHeight, pOptions );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルを帯ごとにデコードしてシンクに渡します.
+//-------------------------------------------------------------------------------------------------
+bool StreamImageFromFileA( const char* filename, IImageSink* pSink, uint32_t bandHeight, const TextureLoadOptions* pOptions )
+{
+    if ( filename == nullptr )
+    {
+        ELOGA( "Error : Invalid Argument." );
         return false;
     }
 
-    // ピクセルデータのサイズを算出.
-    size_t pixelSize = bufferSize - offset;
+    auto path = ToStringW(filename);
+    return StreamImageFromFileW( path.c_str(), pSink, bandHeight, pOptions );
+}
+
 
-    // ピクセルデータのメモリを確保.
-    unsigned char* pPixelData = new unsigned char [pixelSize];
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ResTexture class
+///////////////////////////////////////////////////////////////////////////////////////////////////
 
-    // NULLチェック.
-    if ( pPixelData == nullptr )
+//-------------------------------------------------------------------------------------------------
+//      解放処理を行います.
+//-------------------------------------------------------------------------------------------------
+void ResTexture::Release()
+{
+    // アロケータで1つのブロックとして確保した場合は，先頭のサブリソースの配列ごと返却する(pBlock は使っていない).
+    if ( pAllocator != nullptr )
     {
-        // エラーログ出力.
-        ELOG( "Error : Memory Allocate Failed." );
+        pAllocator->Free( pResources );
+        pAllocator = nullptr;
+        pResources = nullptr;
+        return;
+    }
 
-        // 異常終了.
-        return false;
+    // ピクセルデータを共有していない場合のみ，サブリソースごとに解放する.
+    if ( pBlock == nullptr && pMappedFile == nullptr && pResources != nullptr )
+    {
+        uint32_t mipCount = ( MipMapCount > 0 ) ? MipMapCount : 1;
+
+        for( uint32_t i=0; i<SurfaceCount * mipCount; ++i )
+        { pResources[i].Release(); }
     }
 
-    memcpy( pPixelData, pCur, sizeof(unsigned char) * pixelSize );
+    SafeDeleteArray( pResources );
+    SafeDeleteArray( pBlock );
 
-    // リトルエンディアンなのでピクセルの並びを補正.
-    switch( nativeFormat )
+    if ( pMappedFile != nullptr )
     {
-        // 一括読み込みでくるっているので修正.
-        case NATIVE_TEXTURE_FORMAT_ARGB_8888:
-        case NATIVE_TEXTURE_FORMAT_XRGB_8888:
-        {
-            for( size_t i=0; i<pixelSize; i+=4 )
-            {
-                // BGRA -> RGBA
-                unsigned char R = pPixelData[ i + 0 ];
-                unsigned char B = pPixelData[ i + 2 ];
-                pPixelData[ i + 0 ] = B;
-                pPixelData[ i + 2 ] = R;
-            }
-        }
-        break;
+        delete pMappedFile;
+        pMappedFile = nullptr;
     }
+}
 
-    size_t byteOffset = 0;
-    size_t idx    = 0;
-    size_t skipMip = 0;
+//-------------------------------------------------------------------------------------------------
+//      ファイルからテクスチャリソースを生成します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::LoadFromFileA( const char* filename, const TextureLoadOptions* pOptions )
+{ return CreateResTextureFromFileA( filename, GetLoadOptions( pOptions ), (*this) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルからテクスチャリソースを生成します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::LoadFromFileW( const wchar_t* filename, const TextureLoadOptions* pOptions )
+{ return CreateResTextureFromFileW( filename, GetLoadOptions( pOptions ), (*this) ); }
 
-    // リソースデータのメモリを確保.
-    resTexture.pResources = new SubResource[ resTexture.MipMapCount * resTexture.SurfaceCount ];
+//-------------------------------------------------------------------------------------------------
+//      メモリストリームからテクスチャリソースを生成します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::LoadFromMemory( const uint8_t* pBuffer, const uint32_t bufferSize, const TextureLoadOptions* pOptions )
+{ return CreateResTextureFromMemory( pBuffer, bufferSize, GetLoadOptions( pOptions ), (*this) ); }
 
-    size_t w = width;
-    size_t h = height;
-    size_t d = depth;
+//-------------------------------------------------------------------------------------------------
+//      ファイルをマップしてテクスチャリソースを生成します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::MapFromFileA( const char* filename, const TextureLoadOptions* pOptions )
+{ return MapResTextureFromFileA( filename, GetLoadOptions( pOptions ), (*this) ); }
 
-    // 各ミップレベルごとに処理.
-    for ( size_t j=0; j<resTexture.MipMapCount; ++j )
-    {
-        for( size_t i=0; i<resTexture.SurfaceCount; ++i )
-        {
-            size_t rowBytes = 0;
-            size_t numRows  = 0;
-            size_t numBytes = 0;
-
-            // ブロック圧縮フォーマットの場合.
-            if ( ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC1 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC2 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC3 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4U )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4S )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC5U )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC5S ) )
-            {
-                size_t bcPerBlock = 0;
-                size_t blockWide  = 0;
-                size_t blockHigh  = 0;
-
-                // BC1, BC4の場合.
-                if ( ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC1 )
-                  || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4S )
-                  || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4U ) )
-                { bcPerBlock = 8; }
-                // BC2, BC3, BC5, BC6H, BC7の場合.
-                else
-                { bcPerBlock = 16; }
+//-------------------------------------------------------------------------------------------------
+//      ファイルをマップしてテクスチャリソースを生成します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::MapFromFileW( const wchar_t* filename, const TextureLoadOptions* pOptions )
+{ return MapResTextureFromFileW( filename, GetLoadOptions( pOptions ), (*this) ); }
 
-                blockWide = Max< size_t >( 1, ( w + 3 ) / 4 );
-                blockHigh = Max< size_t >( 1, ( h + 3 ) / 4 );
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::SaveToDDSA( const char* filename ) const
+{ return SaveResTextureToDDSFileA( filename, (*this) ); }
 
-                // 一行のバイト数.
-                rowBytes = blockWide * bcPerBlock;
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::SaveToDDSW( const wchar_t* filename ) const
+{ return SaveResTextureToDDSFileW( filename, (*this) ); }
 
-                // 行数.
-                numRows  = blockHigh;
-            }
-            // ブロック圧縮フォーマット以外の場合.
-            else
-            {
-                // 1ピクセル当たりのビット数.
-                size_t bpp = GetBitPerPixel( nativeFormat );
+//-------------------------------------------------------------------------------------------------
+//      クックドテクスチャファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::SaveToCookedA( const char* filename ) const
+{ return SaveResTextureToCookedFileA( filename, (*this) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      クックドテクスチャファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::SaveToCookedW( const wchar_t* filename ) const
+{ return SaveResTextureToCookedFileW( filename, (*this) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャファイルをクックドテクスチャに変換します.
+//-------------------------------------------------------------------------------------------------
+bool CookTextureA( const char* srcFilename, const char* dstFilename )
+{
+    if ( srcFilename == nullptr || dstFilename == nullptr )
+    {
+        ELOGA( "Error : Invalid Argument." );
+        return false;
+    }
 
-                // 一行のバイト数.
-                rowBytes = ( w * bpp + 7 ) / 8;
+    auto src = ToStringW(srcFilename);
+    auto dst = ToStringW(dstFilename);
+    return CookTextureW( src.c_str(), dst.c_str() );
+}
 
-                // 行数.
-                numRows  = h;
-            }
+//-------------------------------------------------------------------------------------------------
+//      テクスチャファイルをクックドテクスチャに変換します.
+//-------------------------------------------------------------------------------------------------
+bool CookTextureW( const wchar_t* srcFilename, const wchar_t* dstFilename )
+{
+    ResTexture texture;
+    if ( !texture.LoadFromFileW( srcFilename ) )
+    { return false; }
 
-            // データ数 = (1行当たりのバイト数) * 行数.
-            numBytes = rowBytes * numRows;
+    auto result = texture.SaveToCookedW( dstFilename );
+    texture.Release();
 
-            // リソースデータを設定.
-            resTexture.pResources[ idx ].Width      = uint32_t( w );
-            resTexture.pResources[ idx ].Height     = uint32_t( h );
-            resTexture.pResources[ idx ].Pitch      = uint32_t( rowBytes );
-            resTexture.pResources[ idx ].SlicePitch = uint32_t( numBytes );
-            resTexture.pResources[ idx ].pPixels    = pPixelData + byteOffset;
+    return result;
+}
 
-            // オフセットをカウントアップ.
-            byteOffset += numBytes;
 
-            // インデックスをカウントアップ.
-            idx++;
-        }
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ResTextureStream class
+///////////////////////////////////////////////////////////////////////////////////////////////////
 
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ResTextureStream::ResTextureStream()
+: m_Source          ()
+, m_Resource        ()
+, m_pOffsets        ( nullptr )
+, m_SkipMipCount    ( 0 )
+, m_MostDetailedMip ( 0 )
+, m_Swizzle         ( false )
+{ /* DO_NOTHING */ }
 
-        // 横幅，縦幅を更新.
-        w = w >> 1;
-        h = h >> 1;
-        d = d >> 1;
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+ResTextureStream::~ResTextureStream()
+{ Close(); }
 
-        // クランプ処理.
-        if ( w == 0 ) { w = 1; }
-        if ( h == 0 ) { h = 1; }
-        if ( d == 0 ) { d = 1; }
+//-------------------------------------------------------------------------------------------------
+//      ファイルを開いて段階的な読み込みを開始します.
+//-------------------------------------------------------------------------------------------------
+bool ResTextureStream::OpenA( const char* filename, uint32_t maxSize, const TextureLoadOptions* pOptions )
+{
+    if ( filename == nullptr )
+    {
+        ELOGA( "Error : Invalid Argument." );
+        return false;
     }
 
-    // 正常終了.
-    return true;
+    auto path = ToStringW(filename);
+    return OpenW( path.c_str(), maxSize, pOptions );
 }
 
 //-------------------------------------------------------------------------------------------------
-//      Targaファイルからリソーステクスチャを生成します.
+//      ファイルを開いて段階的な読み込みを開始します.
 //-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromTGAFileW(const wchar_t* filename, asdx::ResTexture& resTexture)
+bool ResTextureStream::OpenW( const wchar_t* filename, uint32_t maxSize, const TextureLoadOptions* pOptions )
 {
-   // 引数チェック.
+    Close();
+
     if ( filename == nullptr )
     {
-        ELOG( "Error : Invalid Argument." );
+        ELOGW( "Error : Invalid Argument." );
         return false;
     }
 
-    FILE* pFile;
-
-    // ファイルを開く.
-    auto err = _wfopen_s( &pFile, filename, L"rb" );
-    if ( err != 0 )
+    auto pFile = new (std::nothrow) MappedFile();
+    if ( pFile == nullptr )
     {
-        ELOG( "Error : File Open Failed. Filename = %s", filename );
+        ELOG( "Error : Out of Memory." );
         return false;
     }
 
-    // フッターを読み込み.
-    TGA_FOOTER footer;
-    long offset = sizeof(footer);
-    fseek( pFile, -offset, SEEK_END );
-    fread( &footer, sizeof(footer), 1, pFile );
-
-    // ファイルマジックをチェック.
-    if ( strcmp( footer.Tag, "TRUEVISION-XFILE." ) != 0 )
+    // 読み込むまではページに触れないので，小さいミップレベルの分だけが読み込まれる.
+    if ( !pFile->Open( filename ) )
     {
-        ELOG( "Error : Invalid File Format." );
-        fclose( pFile );
+        ELOGW( "Error : File Open Failed. filename = %s", filename );
+        delete pFile;
         return false;
     }
 
-    // 拡張データがある場合は読み込み.
-    if ( footer.OffsetExt != 0 )
-    {
-        TGA_EXTENSION extension;
-
-        fseek( pFile, footer.OffsetExt, SEEK_SET );
-        fread( &extension, sizeof(extension), 1, pFile );
-    }
+    m_Source.pMappedFile = pFile;
 
-    // ディベロッパーエリアがある場合.
-    if ( footer.OffsetDev != 0 )
+    // DDS以外はミップレベル単位で読み込めないので，開いたファイルから一括で読み込む.
+    if ( !IsDDS( pFile->GetData(), pFile->GetSize() ) )
     {
-        /* NOT IMPLEMENT */
-    }
-
-    // ファイル先頭に戻す.
-    fseek( pFile, 0, SEEK_SET );
+        auto result = DecodeResTexture( pFile->GetData(), pFile->GetSize(), GetLoadOptions( pOptions ), m_Resource );
+        m_Source.Release();
 
-    // ヘッダデータを読み込む.
-    TGA_HEADER header;
-    fread( &header, sizeof(header), 1, pFile );
-
-    // フォーマット判定.
-    uint32_t bytePerPixel = 0;
-    switch( header.Format )
-    {
-    // 該当なし.
-    case TGA_FORMAT_NONE:
+        if ( !result )
         {
-            ELOG( "Error : Invalid Format." );
-            fclose( pFile );
+            Close();
             return false;
         }
-        break;
-
-    // グレースケール
-    case TGA_FORMAT_GRAYSCALE:
-    case TGA_FORMAT_RLE_GRAYSCALE:
-        { 
-            if ( header.BitPerPixel == 8 )
-            { bytePerPixel = 1; }
-            else
-            { bytePerPixel = 2; }
-        }
-        break;
-
-    // カラー.
-    case TGA_FORMAT_INDEXCOLOR:
-    case TGA_FORMAT_FULLCOLOR:
-    case TGA_FORMAT_RLE_INDEXCOLOR:
-    case TGA_FORMAT_RLE_FULLCOLOR:
-        {
-            if ( header.BitPerPixel <= 24 )
-            { bytePerPixel = 3; }
-            else
-            { bytePerPixel = 4; }
-        }
-        break;
 
-    // 上記以外.
-    default:
-        {
-            ELOG( "Error : Unsupported Format." );
-            fclose( pFile );
-            return false;
-        }
-        break;
+        m_MostDetailedMip = 0;
+        return true;
     }
 
-    // IDフィールドサイズ分だけオフセットを移動させる.
-    fseek( pFile, header.IdFieldLength, SEEK_CUR );
-
-    // RGBのみはテクスチャがサポートされないので，強制的にRGBAにする.
-    auto bpp = (bytePerPixel == 3) ? 4 : bytePerPixel;
-
-    // ピクセルサイズを決定してメモリを確保.
-    auto size = header.Width * header.Height * bpp;
-    auto pPixels = new (std::nothrow) uint8_t [ size ];
-    if ( pPixels == nullptr )
+    uint32_t nativeFormat = 0;
+    size_t   dataOffset   = 0;
+    if ( !ParseDDSHeader( pFile->GetData(), pFile->GetSize(), m_Source, nativeFormat, dataOffset ) )
     {
-        ELOG( "Error : Out Of Memory." );
-        fclose( pFile );
+        Close();
         return false;
     }
 
-    // カラーマップを持つかチェック.
-    uint8_t* pColorMap = nullptr;
-    if ( header.HasColorMap )
+    // 読み込み元は読み取り専用のまま参照するだけで，書き込みは行わない.
+    auto pPixels = const_cast<uint8_t*>( pFile->GetData() ) + dataOffset;
+    if ( !SetupDDSSubResources( m_Source, nativeFormat, pPixels, pFile->GetSize() - dataOffset ) )
     {
-        // カラーマップサイズを算出.
-        uint32_t colorMapSize = header.ColorMapEntry * ( header.ColorMapEntrySize >> 3 );
-
-        // メモリを確保.
-        pColorMap = new (std::nothrow) uint8_t [ colorMapSize ];
-        if ( pColorMap == nullptr )
-        {
-            ELOG( "Error : Out Of Memory." );
-            delete[] pPixels;
-            pPixels = nullptr;
-            fclose( pFile );
-            return false;
-        }
-
-        // がばっと読み込む.
-        fread( pColorMap, sizeof(uint8_t), colorMapSize, pFile );
+        Close();
+        return false;
     }
 
-    // 幅・高さ・ビットの深さ・ハッシュキーを設定.
-    auto width       = header.Width;
-    auto height      = header.Height;
-    auto format      = static_cast<TGA_FORMAT_TYPE>( header.Format );
-   
-    // フォーマットに合わせてピクセルデータを解析する.
-    switch( header.Format )
-    {
-    // パレット.
-    case TGA_FORMAT_INDEXCOLOR:
-        { Parse8Bits( pFile, width * height, pColorMap, pPixels ); }
-        break;
-
-    // フルカラー.
-    case TGA_FORMAT_FULLCOLOR:
-        {
-            switch( header.BitPerPixel )
-            {
-            case 16:
-                { Parse16Bits( pFile, width * height, pPixels ); }
-                break;
-
-            case 24:
-                { Parse24Bits( pFile, width * height, pPixels ); }
-                break;
-
-            case 32:
-                { Parse32Bits( pFile, width * height, pPixels ); }
-                break;
-            }
-        }
-        break;
-
-    // グレースケール.
-    case TGA_FORMAT_GRAYSCALE:
-        {
-            if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScale( pFile, width * height, pPixels ); }
-            else
-            { Parse16BitsGrayScale( pFile, width * height, pPixels ); }
-        }
-        break;
-
-    // パレットRLE圧縮.
-    case TGA_FORMAT_RLE_INDEXCOLOR:
-        { Parse8BitsRLE( pFile, pColorMap, width * height * 3, pPixels ); }
-        break;
-
-    // フルカラーRLE圧縮.
-    case TGA_FORMAT_RLE_FULLCOLOR:
-        {
-            switch( header.BitPerPixel )
-            {
-            case 16:
-                { Parse16BitsRLE( pFile, width * height * 3, pPixels ); }
-                break;
-
-            case 24:
-                { Parse24BitsRLE( pFile, width * height * 3, pPixels ); }
-                break;
-
-            case 32:
-                { Parse32BitsRLE( pFile, width * height * 4, pPixels ); }
-                break;
-            }
-        }
-        break;
-
-    // グレースケールRLE圧縮.
-    case TGA_FORMAT_RLE_GRAYSCALE:
-        {
-            if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScaleRLE( pFile, width * height, pPixels ); }
-            else
-            { Parse16BitsGrayScaleRLE( pFile, width * height * 2, pPixels ); }
-        }
-        break;
-    }
+    m_Swizzle = NeedSwizzle( nativeFormat );
 
-    // 不要なメモリを解放.
-    if (pColorMap != nullptr)
+    // 最大解像度を超えるミップレベルは読み込まない. 最も小さいミップレベルは必ず残す.
+    uint32_t skip = 0;
+    if ( maxSize > 0 )
     {
-        delete[] pColorMap;
-        pColorMap = nullptr;
+        while( skip + 1 < m_Source.MipMapCount
+            && ( m_Source.pResources[ skip ].Width > maxSize || m_Source.pResources[ skip ].Height > maxSize ) )
+        { skip++; }
     }
 
-    // ファイルを閉じる.
-    fclose( pFile );
+    auto mipCount = m_Source.MipMapCount - skip;
+    auto count    = mipCount * m_Source.SurfaceCount;
 
-    auto surface = new SubResource();
-    if (surface == nullptr)
+    m_pOffsets            = new (std::nothrow) size_t [ count ];
+    m_Resource.pResources = new (std::nothrow) SubResource [ count ];
+    if ( m_pOffsets == nullptr || m_Resource.pResources == nullptr )
     {
-        ELOG("Error : Out of Memory.");
+        ELOG( "Error : Out of Memory." );
+        Close();
         return false;
     }
 
-    surface->Width      = width;
-    surface->Height     = height;
-    surface->Pitch      = width * bpp;
-    surface->SlicePitch = width * height * bpp;
-    surface->pPixels    = pPixels;
-
-    resTexture.Width        = width;
-    resTexture.Height       = height;
-    resTexture.Depth        = 1;
-    resTexture.SurfaceCount = 1;
-    resTexture.MipMapCount  = 1;
-    resTexture.pResources   = surface;
-
-    switch(format)
+    // 読み込み先もDDSと同じくサーフェイスごとに全ミップレベルを並べる.
+    // ピクセルデータは読み込み済みになるまで設定しない.
+    size_t blockSize = 0;
+    size_t idx       = 0;
+    for( uint32_t i=0; i<m_Source.SurfaceCount; ++i )
     {
-    case TGA_FORMAT_NONE:
-        resTexture.Format = DXGI_FORMAT_UNKNOWN;
-        break;
-
-    case TGA_FORMAT_FULLCOLOR:
-        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        break;
-
-    case TGA_FORMAT_GRAYSCALE:
-        resTexture.Format = DXGI_FORMAT_R8_UNORM;
-        break;
-
-    case TGA_FORMAT_RLE_FULLCOLOR:
-        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        break;
-
-    case TGA_FORMAT_RLE_GRAYSCALE:
-        resTexture.Format = DXGI_FORMAT_R8_UNORM;
-        break;
-
-    case TGA_FORMAT_INDEXCOLOR:
-    case TGA_FORMAT_RLE_INDEXCOLOR:
+        for( uint32_t j=0; j<mipCount; ++j, ++idx )
         {
-            switch (bytePerPixel)
-            {
-            case 1:
-                { resTexture.Format = DXGI_FORMAT_R8_UNORM; }
-                break;
+            const auto& src = m_Source.pResources[ i * m_Source.MipMapCount + skip + j ];
+            auto depth = GetMipDepth( m_Source.Depth, skip + j );
 
-            case 2:
-                { resTexture.Format = DXGI_FORMAT_B5G5R5A1_UNORM; }
-                break;
+            m_Resource.pResources[ idx ].Width      = src.Width;
+            m_Resource.pResources[ idx ].Height     = src.Height;
+            m_Resource.pResources[ idx ].Pitch      = src.Pitch;
+            m_Resource.pResources[ idx ].SlicePitch = src.SlicePitch;
 
-            default:
-                {
-                    ELOG("Error : Unknown Format. bytePerPixel = %u", bytePerPixel );
-                    assert(false);
-                    return false;
-                }
-            }
+            m_pOffsets[ idx ] = blockSize;
+            blockSize += size_t( src.SlicePitch ) * depth;
         }
-        break;
     }
 
-    // 正常終了.
-    return true;
-}
-
-//-------------------------------------------------------------------------------------------------
-//      Targaファイルからリソーステクスチャを生成します.
-//-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromTGAFileA(const char* filename, asdx::ResTexture& resTexture)
-{
-    auto path = ToStringW(filename);
-    return CreateResTextureFromTGAFileW(path.c_str(), resTexture);
-}
-
-//-------------------------------------------------------------------------------------------------
-//      ファイルからテクスチャを生成します.
-//-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromFileW( const wchar_t* filename, asdx::ResTexture& resTexture )
-{
-    if ( filename == nullptr )
+    m_Resource.pBlock = new (std::nothrow) uint8_t [ blockSize ];
+    if ( m_Resource.pBlock == nullptr )
     {
-        ELOGW( "Error : Invalid Argument." );
+        ELOG( "Error : Out of Memory." );
+        Close();
         return false;
     }
 
-    auto ext = GetExtW(filename);
+    m_Resource.Width        = m_Resource.pResources[ 0 ].Width;
+    m_Resource.Height       = m_Resource.pResources[ 0 ].Height;
+    m_Resource.Depth        = ( m_Source.Depth > 0 ) ? GetMipDepth( m_Source.Depth, skip ) : 0;
+    m_Resource.Format       = m_Source.Format;
+    m_Resource.MipMapCount  = mipCount;
+    m_Resource.SurfaceCount = m_Source.SurfaceCount;
+    m_Resource.Option       = m_Source.Option;
 
-    if (ext == L"dds")
-    { return CreateResTextureFromDDSFileW( filename, resTexture ); }
-    else if (ext == L"tga")
-    { return CreateResTextureFromTGAFileW( filename, resTexture );  }
+    m_SkipMipCount    = skip;
+    m_MostDetailedMip = mipCount;
 
-    return CreateResTextureFromWICFileW( filename, resTexture );
+    return true;
 }
 
-
 //-------------------------------------------------------------------------------------------------
-//      ファイルからテクスチャを生成します.
+//      ファイルを閉じて，読み込んだデータを解放します.
 //-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromFileA( const char* filename, asdx::ResTexture& resTexture )
+void ResTextureStream::Close()
 {
-    if ( filename == nullptr )
-    {
-        ELOGA( "Error : Invalid Argument." );
-        return false;
-    }
-
-    auto ext = GetExtA(filename);
-
-    if (ext == "dds")
-    { return CreateResTextureFromDDSFileA( filename, resTexture ); }
-    else if (ext == "tga")
-    { return CreateResTextureFromTGAFileA( filename, resTexture ); }
-
-    return CreateResTextureFromWICFileA( filename, resTexture );
+    m_Source  .Release();
+    m_Resource.Release();
+    SafeDeleteArray( m_pOffsets );
+
+    m_Source          = ResTexture();
+    m_Resource        = ResTexture();
+    m_SkipMipCount    = 0;
+    m_MostDetailedMip = 0;
+    m_Swizzle         = false;
 }
 
-
 //-------------------------------------------------------------------------------------------------
-//      メモリストリームからテクスチャを生成します.
+//      次のミップレベルを読み込みます.
 //-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromMemory( const uint8_t* pBinary, const uint32_t bufferSize, asdx::ResTexture& resTexture )
+bool ResTextureStream::LoadNext()
 {
-    if ( pBinary == nullptr || bufferSize < 4 )
+    if ( m_Source.pResources == nullptr || m_MostDetailedMip == 0 )
+    { return false; }
+
+    auto mip      = m_MostDetailedMip - 1;
+    auto mipCount = m_Resource.MipMapCount;
+    auto depth    = GetMipDepth( m_Source.Depth, m_SkipMipCount + mip );
+
+    for( uint32_t i=0; i<m_Resource.SurfaceCount; ++i )
     {
-        ELOG( "Error : Invalid Argument." );
-        return false;
+        const auto& src = m_Source.pResources[ i * m_Source.MipMapCount + m_SkipMipCount + mip ];
+        auto& dst = m_Resource.pResources[ i * mipCount + mip ];
+
+        auto pDst = m_Resource.pBlock + m_pOffsets[ i * mipCount + mip ];
+        auto size = size_t( src.SlicePitch ) * depth;
+
+        // リトルエンディアンなのでピクセルの並びを補正.
+        if ( m_Swizzle )
+        { SwizzleBGRAToRGBA( src.pPixels, pDst, uint32_t( size / 4 ) ); }
+        else
+        { memcpy( pDst, src.pPixels, size ); }
+
+        dst.pPixels = pDst;
     }
 
-    bool isDDS = true;
-    if ( ( pBinary[0] != 'D' )
-      || ( pBinary[1] != 'D' )
-      || ( pBinary[2] != 'S' )
-      || ( pBinary[3] != ' ' ) )
+    m_MostDetailedMip = mip;
+
+    // 全て読み込んだらファイルは不要.
+    if ( mip == 0 )
     {
-        isDDS = false;
+        m_Source.Release();
+        m_Source = ResTexture();
     }
 
-    if ( isDDS )
-    { return CreateResTextureFromDDSMemory( pBinary, bufferSize, resTexture ); }
-
-    return CreateResTextureFromWICMemory( pBinary, bufferSize, resTexture );
+    return true;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      全てのミップレベルを読み込んだかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool ResTextureStream::IsCompleted() const
+{ return ( m_Resource.pResources != nullptr ) && ( m_MostDetailedMip == 0 ); }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////
-// ResTexture class
-///////////////////////////////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------------------------------
+//      読み込み済みの最も詳細なミップレベルを取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t ResTextureStream::GetMostDetailedMip() const
+{ return m_MostDetailedMip; }
 
 //-------------------------------------------------------------------------------------------------
-//      ファイルからテクスチャリソースを生成します.
+//      読み込み済みのミップレベル数を取得します.
 //-------------------------------------------------------------------------------------------------
-bool ResTexture::LoadFromFileA( const char* filename )
-{ return CreateResTextureFromFileA( filename, (*this) ); }
+uint32_t ResTextureStream::GetResidentMipCount() const
+{ return ( m_Resource.pResources != nullptr ) ? m_Resource.MipMapCount - m_MostDetailedMip : 0; }
 
 //-------------------------------------------------------------------------------------------------
-//      ファイルからテクスチャリソースを生成します.
+//      読み込み先のリソーステクスチャを取得します.
 //-------------------------------------------------------------------------------------------------
-bool ResTexture::LoadFromFileW( const wchar_t* filename )
-{ return CreateResTextureFromFileW( filename, (*this) ); }
+const ResTexture& ResTextureStream::GetResource() const
+{ return m_Resource; }
 
 //-------------------------------------------------------------------------------------------------
-//      メモリストリームからテクスチャリソースを生成します.
+//      読み込みが完了したリソーステクスチャの所有権を移します.
 //-------------------------------------------------------------------------------------------------
-bool ResTexture::LoadFromMemory( const uint8_t* pBuffer, const uint32_t bufferSize )
-{ return CreateResTextureFromMemory( pBuffer, bufferSize, (*this) ); }
+bool ResTextureStream::Detach( ResTexture& result )
+{
+    if ( !IsCompleted() )
+    { return false; }
+
+    result     = m_Resource;
+    m_Resource = ResTexture();
+    Close();
+
+    return true;
+}
 
 
 } // namespace asdx
@@ -0,0 +1,551 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxResTextureAllocator.cpp
+// Desc : Resource Texture Allocator Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxResTextureAllocator.h>
+#include <asdxBCDecoder.h>
+#include <asdxMisc.h>
+#include <asdxLogger.h>
+#include <atomic>
+#include <new>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const size_t kResTextureAlignment = 16;      // ピクセルデータの配置アラインメントです(SIMDでの読み書き用).
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// HeapResTextureAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class HeapResTextureAllocator : public asdx::IResTextureAllocator
+{
+public:
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリを確保します.
+    //---------------------------------------------------------------------------------------------
+    void* Allocate(size_t size, size_t alignment) override
+    {
+        // 先頭をずらした量を直前の1byteに記録しておき，解放時に元のアドレスへ戻す.
+        if (alignment == 0 || alignment > 128 || (alignment & (alignment - 1)) != 0 || size > SIZE_MAX - alignment)
+        { return nullptr; }
+
+        auto pBase = new (std::nothrow) uint8_t[size + alignment];
+        if (pBase == nullptr)
+        { return nullptr; }
+
+        auto shift = alignment - (reinterpret_cast<uintptr_t>(pBase) & (alignment - 1));
+        auto pHead = pBase + shift;
+        pHead[-1] = uint8_t(shift);
+        return pHead;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリを解放します.
+    //---------------------------------------------------------------------------------------------
+    void Free(void* ptr) override
+    {
+        if (ptr == nullptr)
+        { return; }
+
+        auto pHead = static_cast<uint8_t*>(ptr);
+        delete[] (pHead - pHead[-1]);
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+// Global Variables.
+//-------------------------------------------------------------------------------------------------
+static HeapResTextureAllocator                  g_HeapAllocator;                // 既定のヒープアロケータです.
+static std::atomic<asdx::IResTextureAllocator*> g_pAllocator(nullptr);          // 設定されたアロケータです.
+
+//-------------------------------------------------------------------------------------------------
+//      配置アラインメントに切り上げます.
+//-------------------------------------------------------------------------------------------------
+inline size_t AlignResTexture(size_t value)
+{ return (value + kResTextureAlignment - 1) & ~(kResTextureAlignment - 1); }
+
+//-------------------------------------------------------------------------------------------------
+//      ミップレベルのサイズを取得します(最低1).
+//-------------------------------------------------------------------------------------------------
+inline uint32_t GetMipSize(uint32_t size, uint32_t mip)
+{
+    auto result = (mip < 32) ? (size >> mip) : 0;
+    return (result > 0) ? result : 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブリソースの1行当たりのバイト数と行数を求めます.
+//-------------------------------------------------------------------------------------------------
+bool GetSurfaceInfo(uint32_t width, uint32_t height, uint32_t format, size_t& rowBytes, size_t& numRows)
+{
+    auto bpp = asdx::GetBitsPerPixel(int(format));
+    if (bpp <= 0)
+    { return false; }
+
+    // ブロック圧縮フォーマットは4x4ピクセルで1ブロック(4bppは8byte/block, 8bppは16byte/block).
+    if (asdx::IsBlockCompressedFormat(format))
+    {
+        rowBytes = size_t((width  + 3) / 4) * size_t(bpp) * 2;
+        numRows  = size_t((height + 3) / 4);
+    }
+    else
+    {
+        rowBytes = (size_t(width) * size_t(bpp) + 7) / 8;
+        numRows  = height;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブリソースごとに配置を求めて visit に渡します.
+//-------------------------------------------------------------------------------------------------
+template<typename VisitFunc>
+bool PlanLayout(const asdx::ResTexture& desc, VisitFunc visit, size_t& blockSize)
+{
+    auto count = uint64_t(desc.MipMapCount) * desc.SurfaceCount;
+    if (desc.Width == 0 || desc.Height == 0 || count == 0 || count > UINT32_MAX)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    // 先頭にサブリソースの配列を置き，その後ろにピクセルデータを並べる.
+    auto isVolume = (desc.Option & asdx::SUBRESOURCE_OPTION_VOLUME) != 0;
+    auto offset   = AlignResTexture(size_t(count) * sizeof(asdx::SubResource));
+    auto index    = 0u;
+
+    for(auto i=0u; i<desc.SurfaceCount; ++i)
+    {
+        for(auto m=0u; m<desc.MipMapCount; ++m, ++index)
+        {
+            asdx::SubResourceLayout layout;
+            layout.Offset = offset;
+            layout.Width  = GetMipSize(desc.Width,  m);
+            layout.Height = GetMipSize(desc.Height, m);
+            layout.Depth  = (isVolume) ? GetMipSize(desc.Depth, m) : 1;
+
+            size_t rowBytes = 0;
+            size_t numRows  = 0;
+            if (!GetSurfaceInfo(layout.Width, layout.Height, desc.Format, rowBytes, numRows))
+            {
+                ELOG("Error : Unsupported Format. format = %u", desc.Format);
+                return false;
+            }
+
+            // ピッチは32bitで保持するので，収まらない場合と全体のサイズが溢れる場合はエラー.
+            if (rowBytes == 0 || rowBytes > UINT32_MAX || numRows > UINT32_MAX / rowBytes)
+            {
+                ELOG("Error : Texture Size Too Large. width = %u, height = %u", desc.Width, desc.Height);
+                return false;
+            }
+
+            auto sliceSize = uint64_t(rowBytes) * numRows;
+            auto dataSize  = sliceSize * layout.Depth;
+            if (dataSize > SIZE_MAX - kResTextureAlignment - offset)
+            {
+                ELOG("Error : Texture Size Too Large. width = %u, height = %u", desc.Width, desc.Height);
+                return false;
+            }
+
+            layout.Pitch      = uint32_t(rowBytes);
+            layout.SlicePitch = uint32_t(sliceSize);
+            visit(index, layout);
+
+            offset = AlignResTexture(offset + size_t(dataSize));
+        }
+    }
+
+    blockSize = offset;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アドレスをアラインメントに揃えるために必要な余白を求めます.
+//-------------------------------------------------------------------------------------------------
+inline size_t GetAlignPadding(const uint8_t* ptr, size_t alignment)
+{ return (alignment - (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1))) & (alignment - 1); }
+
+//-------------------------------------------------------------------------------------------------
+//      アラインメントが有効かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+inline bool IsValidAlignment(size_t alignment)
+{ return alignment != 0 && (alignment & (alignment - 1)) == 0; }
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//      リソーステクスチャを1回の確保で格納するための配置を求めます.
+//-------------------------------------------------------------------------------------------------
+bool PlanResTextureLayout(const ResTexture& desc, SubResourceLayout* pLayouts, size_t& blockSize)
+{
+    return PlanLayout(desc, [pLayouts](uint32_t index, const SubResourceLayout& layout)
+    {
+        if (pLayouts != nullptr)
+        { pLayouts[index] = layout; }
+    }, blockSize);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブリソースの配列と全てのピクセルデータを1つのブロックとして確保します.
+//-------------------------------------------------------------------------------------------------
+bool AllocateResTexture(ResTexture& texture, IResTextureAllocator* pAllocator)
+{
+    // 配置の計算だけ先に行い，確保は1回で済ませる.
+    size_t blockSize = 0;
+    if (!PlanResTextureLayout(texture, nullptr, blockSize))
+    { return false; }
+
+    if (pAllocator == nullptr)
+    { pAllocator = GetResTextureAllocator(); }
+
+    auto pHead = static_cast<uint8_t*>(pAllocator->Allocate(blockSize, kResTextureAlignment));
+    if (pHead == nullptr)
+    {
+        ELOG("Error : Out of Memory.");
+        return false;
+    }
+
+    // 2回目は同じ配置をサブリソースに書き込む(1回目で成功しているので失敗しない).
+    auto pResources = reinterpret_cast<SubResource*>(pHead);
+    PlanLayout(texture, [pHead, pResources](uint32_t index, const SubResourceLayout& layout)
+    {
+        auto& res = *new (pResources + index) SubResource();
+        res.Width      = layout.Width;
+        res.Height     = layout.Height;
+        res.Pitch      = layout.Pitch;
+        res.SlicePitch = layout.SlicePitch;
+        res.pPixels    = pHead + layout.Offset;
+    }, blockSize);
+
+    // 所有するのはアロケータのブロックだけなので，pBlock は使わない.
+    texture.pResources  = pResources;
+    texture.pBlock      = nullptr;
+    texture.pMappedFile = nullptr;
+    texture.pAllocator  = pAllocator;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      リソーステクスチャの確保に使うアロケータを設定します.
+//-------------------------------------------------------------------------------------------------
+void SetResTextureAllocator(IResTextureAllocator* pAllocator)
+{ g_pAllocator.store(pAllocator); }
+
+//-------------------------------------------------------------------------------------------------
+//      リソーステクスチャの確保に使うアロケータを取得します.
+//-------------------------------------------------------------------------------------------------
+IResTextureAllocator* GetResTextureAllocator()
+{
+    auto pAllocator = g_pAllocator.load();
+    return (pAllocator != nullptr) ? pAllocator : &g_HeapAllocator;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ArenaResTextureAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ArenaResTextureAllocator::ArenaResTextureAllocator()
+: m_pHead       (nullptr)
+, m_ChunkSize   (kDefaultChunkSize)
+, m_UsedSize    (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+ArenaResTextureAllocator::~ArenaResTextureAllocator()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool ArenaResTextureAllocator::Init(size_t chunkSize)
+{
+    if (chunkSize == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    Term();
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    m_ChunkSize = chunkSize;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void ArenaResTextureAllocator::Term()
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    DestroyChunks(m_pHead);
+    m_pHead    = nullptr;
+    m_UsedSize = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      チャンクの末尾から切り出してメモリを確保します.
+//-------------------------------------------------------------------------------------------------
+void* ArenaResTextureAllocator::Allocate(size_t size, size_t alignment)
+{
+    if (!IsValidAlignment(alignment) || size > SIZE_MAX - sizeof(Chunk) - alignment)
+    { return nullptr; }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    // 現在のチャンクに収まる場合は切り出すだけ.
+    if (m_pHead != nullptr)
+    {
+        auto pData    = reinterpret_cast<uint8_t*>(m_pHead + 1) + m_pHead->Offset;
+        auto padding  = GetAlignPadding(pData, alignment);
+        auto remain   = m_pHead->Size - m_pHead->Offset;
+        if (padding <= remain && size <= remain - padding)
+        {
+            m_pHead->Offset += padding + size;
+            m_UsedSize      += padding + size;
+            return pData + padding;
+        }
+    }
+
+    // 収まらない場合は新しいチャンクを確保する.
+    // チャンクより大きな要求は専用のチャンクにして，現在のチャンクの残りを使い続ける.
+    auto dedicated = (size + alignment > m_ChunkSize);
+    auto pChunk    = CreateChunk(dedicated ? size + alignment : m_ChunkSize);
+    if (pChunk == nullptr)
+    { return nullptr; }
+
+    if (dedicated && m_pHead != nullptr)
+    {
+        pChunk->pNext   = m_pHead->pNext;
+        m_pHead->pNext  = pChunk;
+    }
+    else
+    {
+        pChunk->pNext = m_pHead;
+        m_pHead       = pChunk;
+    }
+
+    auto pData   = reinterpret_cast<uint8_t*>(pChunk + 1);
+    auto padding = GetAlignPadding(pData, alignment);
+    pChunk->Offset = padding + size;
+    m_UsedSize    += padding + size;
+    return pData + padding;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリを解放します.
+//-------------------------------------------------------------------------------------------------
+void ArenaResTextureAllocator::Free(void*)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      確保したメモリをまとめて破棄します.
+//-------------------------------------------------------------------------------------------------
+void ArenaResTextureAllocator::Reset()
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    // 通常サイズのチャンクを1つだけ残して使い回す.
+    Chunk* pKeep = nullptr;
+    Chunk* pFree = nullptr;
+    auto pChunk = m_pHead;
+    while(pChunk != nullptr)
+    {
+        auto pNext = pChunk->pNext;
+        if (pKeep == nullptr && pChunk->Size == m_ChunkSize)
+        {
+            pKeep = pChunk;
+        }
+        else
+        {
+            pChunk->pNext = pFree;
+            pFree = pChunk;
+        }
+        pChunk = pNext;
+    }
+    DestroyChunks(pFree);
+
+    if (pKeep != nullptr)
+    {
+        pKeep->pNext  = nullptr;
+        pKeep->Offset = 0;
+    }
+
+    m_pHead    = pKeep;
+    m_UsedSize = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      切り出したバイト数の合計を取得します.
+//-------------------------------------------------------------------------------------------------
+size_t ArenaResTextureAllocator::GetUsedSize() const
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    return m_UsedSize;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      確保しているチャンクの合計サイズを取得します.
+//-------------------------------------------------------------------------------------------------
+size_t ArenaResTextureAllocator::GetReservedSize() const
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    size_t result = 0;
+    for(auto pChunk = m_pHead; pChunk != nullptr; pChunk = pChunk->pNext)
+    { result += pChunk->Size; }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      チャンクを生成します.
+//-------------------------------------------------------------------------------------------------
+ArenaResTextureAllocator::Chunk* ArenaResTextureAllocator::CreateChunk(size_t size)
+{
+    // ヘッダの直後をデータ部にする.
+    auto pMemory = new (std::nothrow) uint8_t[sizeof(Chunk) + size];
+    if (pMemory == nullptr)
+    {
+        ELOG("Error : Out of Memory.");
+        return nullptr;
+    }
+
+    auto pChunk = new (pMemory) Chunk();
+    pChunk->pNext  = nullptr;
+    pChunk->Size   = size;
+    pChunk->Offset = 0;
+    return pChunk;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      チャンクを連結された順に全て破棄します.
+//-------------------------------------------------------------------------------------------------
+void ArenaResTextureAllocator::DestroyChunks(Chunk* pChunk)
+{
+    while(pChunk != nullptr)
+    {
+        auto pNext = pChunk->pNext;
+        delete[] reinterpret_cast<uint8_t*>(pChunk);
+        pChunk = pNext;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BufferResTextureAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+BufferResTextureAllocator::BufferResTextureAllocator()
+: m_pBuffer (nullptr)
+, m_Size    (0)
+, m_Offset  (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+BufferResTextureAllocator::~BufferResTextureAllocator()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool BufferResTextureAllocator::Init(void* pBuffer, size_t size)
+{
+    if (pBuffer == nullptr || size == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    m_pBuffer = static_cast<uint8_t*>(pBuffer);
+    m_Size    = size;
+    m_Offset  = 0;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void BufferResTextureAllocator::Term()
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    m_pBuffer = nullptr;
+    m_Size    = 0;
+    m_Offset  = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッファの先頭から順に切り出してメモリを確保します.
+//-------------------------------------------------------------------------------------------------
+void* BufferResTextureAllocator::Allocate(size_t size, size_t alignment)
+{
+    if (!IsValidAlignment(alignment))
+    { return nullptr; }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    if (m_pBuffer == nullptr)
+    { return nullptr; }
+
+    auto pData   = m_pBuffer + m_Offset;
+    auto padding = GetAlignPadding(pData, alignment);
+    auto remain  = m_Size - m_Offset;
+    if (padding > remain || size > remain - padding)
+    {
+        ELOG("Error : Buffer Overflow. size = %u, remain = %u", uint32_t(size), uint32_t(remain));
+        return nullptr;
+    }
+
+    m_Offset += padding + size;
+    return pData + padding;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリを解放します.
+//-------------------------------------------------------------------------------------------------
+void BufferResTextureAllocator::Free(void*)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      切り出したメモリをまとめて破棄します.
+//-------------------------------------------------------------------------------------------------
+void BufferResTextureAllocator::Reset()
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    m_Offset = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      切り出したバイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+size_t BufferResTextureAllocator::GetUsedSize() const
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    return m_Offset;
+}
+
+} // namespace asdx
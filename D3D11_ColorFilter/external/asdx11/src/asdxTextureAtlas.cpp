@@ -0,0 +1,1074 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxTextureAtlas.cpp
+// Desc : Texture Atlas Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxTextureAtlas.h>
+#include <asdxResTexture.h>
+#include <asdxPixelConvert.h>
+#include <asdxBCDecoder.h>
+#include <asdxParallelFor.h>
+#include <asdxLogger.h>
+#include <dxgiformat.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AtlasPacker class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class AtlasPacker
+{
+public:
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    virtual ~AtlasPacker()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全ての配置を破棄して，指定サイズの空の領域にします.
+    //---------------------------------------------------------------------------------------------
+    virtual void Reset(uint32_t width, uint32_t height) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      配置を保ったまま右方向と下方向に領域を広げます.
+    //---------------------------------------------------------------------------------------------
+    virtual void Grow(uint32_t width, uint32_t height) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      矩形を配置します. 回転した場合は width と height を入れ替えた矩形を配置します.
+    //---------------------------------------------------------------------------------------------
+    virtual bool Insert(
+        uint32_t    width,
+        uint32_t    height,
+        bool        allowRotation,
+        uint32_t&   x,
+        uint32_t&   y,
+        bool&       rotated) = 0;
+};
+
+} // namespace asdx
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t   kMaxTextureSize     = 16384;    // D3D11で扱える2次元テクスチャの最大サイズです.
+static const uint32_t   kDefaultSize        = 256;      // Insert() で最初に確保するサイズです.
+static const uint32_t   kMaxMipCount        = 15;       // 最大サイズに対するミップレベル数です.
+static const uint32_t   kBlitJobCount       = 64;       // 1スレッドあたりの最小書き込み数です.
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Rect structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct Rect
+{
+    uint32_t    X;
+    uint32_t    Y;
+    uint32_t    W;
+    uint32_t    H;
+
+    bool Contains(const Rect& value) const
+    {
+        return value.X >= X && value.Y >= Y
+            && value.X + value.W <= X + W
+            && value.Y + value.H <= Y + H;
+    }
+
+    bool Intersects(const Rect& value) const
+    {
+        return value.X < X + W && X < value.X + value.W
+            && value.Y < Y + H && Y < value.Y + value.H;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MaxRectsPacker class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class MaxRectsPacker : public asdx::AtlasPacker
+{
+public:
+    //---------------------------------------------------------------------------------------------
+    //      全ての配置を破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Reset(uint32_t width, uint32_t height) override
+    {
+        m_Width  = width;
+        m_Height = height;
+        m_Free.clear();
+        m_Free.push_back({ 0, 0, width, height });
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //      領域を広げます.
+    //---------------------------------------------------------------------------------------------
+    void Grow(uint32_t width, uint32_t height) override
+    {
+        // 右端(下端)に接する空き矩形はそのまま伸ばせば極大のまま保たれる.
+        if (width > m_Width)
+        {
+            for(auto& rect : m_Free)
+            {
+                if (rect.X + rect.W == m_Width)
+                { rect.W = width - rect.X; }
+            }
+            AddFree({ m_Width, 0, width - m_Width, m_Height });
+            m_Width = width;
+        }
+
+        if (height > m_Height)
+        {
+            for(auto& rect : m_Free)
+            {
+                if (rect.Y + rect.H == m_Height)
+                { rect.H = height - rect.Y; }
+            }
+            AddFree({ 0, m_Height, m_Width, height - m_Height });
+            m_Height = height;
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //      矩形を配置します.
+    //---------------------------------------------------------------------------------------------
+    bool Insert(uint32_t width, uint32_t height, bool allowRotation, uint32_t& x, uint32_t& y, bool& rotated) override
+    {
+        // Best Short Side Fit: 残りの短い辺が最小になる空き矩形を選ぶ.
+        auto bestShort = UINT32_MAX;
+        auto bestLong  = UINT32_MAX;
+        auto found     = false;
+
+        for(auto& rect : m_Free)
+        {
+            if (width <= rect.W && height <= rect.H)
+            {
+                auto dw = rect.W - width;
+                auto dh = rect.H - height;
+                auto s  = std::min(dw, dh);
+                auto l  = std::max(dw, dh);
+                if (s < bestShort || (s == bestShort && l < bestLong))
+                {
+                    bestShort = s;
+                    bestLong  = l;
+                    x = rect.X;
+                    y = rect.Y;
+                    rotated = false;
+                    found   = true;
+                }
+            }
+
+            if (allowRotation && height <= rect.W && width <= rect.H)
+            {
+                auto dw = rect.W - height;
+                auto dh = rect.H - width;
+                auto s  = std::min(dw, dh);
+                auto l  = std::max(dw, dh);
+                if (s < bestShort || (s == bestShort && l < bestLong))
+                {
+                    bestShort = s;
+                    bestLong  = l;
+                    x = rect.X;
+                    y = rect.Y;
+                    rotated = true;
+                    found   = true;
+                }
+            }
+        }
+
+        if (!found)
+        { return false; }
+
+        Rect used = { x, y, rotated ? height : width, rotated ? width : height };
+
+        // 配置した矩形と重なる空き矩形を分割する.
+        m_Split.clear();
+        for(size_t i=0; i<m_Free.size();)
+        {
+            if (!m_Free[i].Intersects(used))
+            {
+                ++i;
+                continue;
+            }
+
+            Split(m_Free[i], used);
+            m_Free[i] = m_Free.back();
+            m_Free.pop_back();
+        }
+
+        // 分割で生じた矩形のうち，他に含まれるものを除く.
+        // 分割されなかった矩形は互いに含まれないので，新しい矩形だけを調べればよい.
+        for(size_t i=0; i<m_Split.size(); ++i)
+        {
+            for(size_t j=0; j<m_Split.size(); ++j)
+            {
+                if (i == j || m_Split[j].W == 0)
+                { continue; }
+
+                if (m_Split[j].Contains(m_Split[i]))
+                {
+                    m_Split[i].W = 0;
+                    break;
+                }
+            }
+        }
+
+        auto oldCount = m_Free.size();
+        for(auto& rect : m_Split)
+        {
+            if (rect.W == 0)
+            { continue; }
+
+            auto contained = false;
+            for(size_t i=0; i<oldCount; ++i)
+            {
+                if (m_Free[i].Contains(rect))
+                {
+                    contained = true;
+                    break;
+                }
+            }
+
+            if (!contained)
+            { m_Free.push_back(rect); }
+        }
+
+        return true;
+    }
+
+private:
+    uint32_t            m_Width  = 0;   //!< 横幅です.
+    uint32_t            m_Height = 0;   //!< 縦幅です.
+    std::vector<Rect>   m_Free;         //!< 極大な空き矩形です.
+    std::vector<Rect>   m_Split;        //!< 分割で生じた空き矩形です.
+
+    //---------------------------------------------------------------------------------------------
+    //      空き矩形から配置した矩形を除いた残りを最大4つの矩形として追加します.
+    //---------------------------------------------------------------------------------------------
+    void Split(const Rect& rect, const Rect& used)
+    {
+        if (used.Y > rect.Y)
+        { m_Split.push_back({ rect.X, rect.Y, rect.W, used.Y - rect.Y }); }
+
+        if (used.Y + used.H < rect.Y + rect.H)
+        { m_Split.push_back({ rect.X, used.Y + used.H, rect.W, rect.Y + rect.H - used.Y - used.H }); }
+
+        if (used.X > rect.X)
+        { m_Split.push_back({ rect.X, rect.Y, used.X - rect.X, rect.H }); }
+
+        if (used.X + used.W < rect.X + rect.W)
+        { m_Split.push_back({ used.X + used.W, rect.Y, rect.X + rect.W - used.X - used.W, rect.H }); }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //      他の空き矩形に含まれない場合のみ追加します.
+    //---------------------------------------------------------------------------------------------
+    void AddFree(const Rect& value)
+    {
+        for(auto& rect : m_Free)
+        {
+            if (rect.Contains(value))
+            { return; }
+        }
+
+        m_Free.push_back(value);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SkylinePacker class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class SkylinePacker : public asdx::AtlasPacker
+{
+public:
+    //---------------------------------------------------------------------------------------------
+    //      全ての配置を破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Reset(uint32_t width, uint32_t height) override
+    {
+        m_Width  = width;
+        m_Height = height;
+        m_Nodes.clear();
+        m_Nodes.push_back({ 0, 0, width });
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //      領域を広げます.
+    //---------------------------------------------------------------------------------------------
+    void Grow(uint32_t width, uint32_t height) override
+    {
+        if (width > m_Width)
+        {
+            auto& last = m_Nodes.back();
+            if (last.Y == 0)
+            { last.W += width - m_Width; }
+            else
+            { m_Nodes.push_back({ m_Width, 0, width - m_Width }); }
+            m_Width = width;
+        }
+
+        if (height > m_Height)
+        { m_Height = height; }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //      矩形を配置します.
+    //---------------------------------------------------------------------------------------------
+    bool Insert(uint32_t width, uint32_t height, bool allowRotation, uint32_t& x, uint32_t& y, bool& rotated) override
+    {
+        // Bottom Left: 上端が最も低くなる位置を選び，同じ場合は左を優先する.
+        auto bestTop   = UINT32_MAX;
+        auto bestIndex = size_t(0);
+        auto found     = false;
+
+        for(size_t i=0; i<m_Nodes.size(); ++i)
+        {
+            uint32_t top;
+            if (Fit(i, width, height, top) && top < bestTop)
+            {
+                bestTop   = top;
+                bestIndex = i;
+                rotated   = false;
+                found     = true;
+            }
+
+            if (allowRotation && Fit(i, height, width, top) && top < bestTop)
+            {
+                bestTop   = top;
+                bestIndex = i;
+                rotated   = true;
+                found     = true;
+            }
+        }
+
+        if (!found)
+        { return false; }
+
+        auto w = rotated ? height : width;
+        auto h = rotated ? width  : height;
+        x = m_Nodes[bestIndex].X;
+        y = bestTop - h;
+        AddNode(bestIndex, x, bestTop, w);
+        return true;
+    }
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Node structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Node
+    {
+        uint32_t    X;      //!< 左端です.
+        uint32_t    Y;      //!< 高さです.
+        uint32_t    W;      //!< 横幅です.
+    };
+
+    uint32_t            m_Width  = 0;   //!< 横幅です.
+    uint32_t            m_Height = 0;   //!< 縦幅です.
+    std::vector<Node>   m_Nodes;        //!< 左から並んだスカイラインです.
+
+    //---------------------------------------------------------------------------------------------
+    //      ノードの左端に置いた場合の上端を求めます.
+    //---------------------------------------------------------------------------------------------
+    bool Fit(size_t index, uint32_t width, uint32_t height, uint32_t& top) const
+    {
+        auto x = m_Nodes[index].X;
+        if (x + width > m_Width)
+        { return false; }
+
+        uint32_t y    = 0;
+        auto     left = width;
+        for(auto i=index; left > 0; ++i)
+        {
+            y = std::max(y, m_Nodes[i].Y);
+            if (y + height > m_Height)
+            { return false; }
+
+            left -= std::min(left, m_Nodes[i].W);
+        }
+
+        top = y + height;
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //      配置した矩形の上端をスカイラインに加えます.
+    //---------------------------------------------------------------------------------------------
+    void AddNode(size_t index, uint32_t x, uint32_t top, uint32_t width)
+    {
+        m_Nodes.insert(m_Nodes.begin() + index, Node{ x, top, width });
+
+        // 新しいノードに隠れた部分を削る.
+        auto right = x + width;
+        auto i     = index + 1;
+        while(i < m_Nodes.size() && m_Nodes[i].X < right)
+        {
+            auto& node = m_Nodes[i];
+            auto  end  = node.X + node.W;
+            if (end <= right)
+            {
+                m_Nodes.erase(m_Nodes.begin() + i);
+                continue;
+            }
+
+            node.W = end - right;
+            node.X = right;
+            break;
+        }
+
+        // 同じ高さの隣接ノードをまとめる. 変化するのは追加したノードの前後のみ.
+        auto j = (index > 0) ? index - 1 : 0;
+        while(j + 1 < m_Nodes.size() && j <= index)
+        {
+            if (m_Nodes[j].Y == m_Nodes[j + 1].Y)
+            {
+                m_Nodes[j].W += m_Nodes[j + 1].W;
+                m_Nodes.erase(m_Nodes.begin() + j + 1);
+            }
+            else
+            { ++j; }
+        }
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+//      2のべき乗に切り上げます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t NextPow2(uint32_t value)
+{
+    uint32_t result = 1;
+    while(result < value)
+    { result <<= 1; }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      境界に切り上げます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t AlignUp(uint32_t value, uint32_t alignment)
+{ return (value + alignment - 1) / alignment * alignment; }
+
+//-------------------------------------------------------------------------------------------------
+//      アトラスの入力として使えるかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsValidInput(const asdx::ResTexture& texture)
+{
+    if (texture.pResources == nullptr || texture.pResources[0].pPixels == nullptr)
+    { return false; }
+
+    if (texture.Width == 0 || texture.Height == 0)
+    { return false; }
+
+    if (asdx::IsBlockCompressedFormat(texture.Format))
+    { return asdx::GetPixelFormatFromDXGI(asdx::GetDecodedFormat(texture.Format)) != asdx::PIXEL_FORMAT_UNKNOWN; }
+
+    return asdx::GetPixelFormatFromDXGI(texture.Format) != asdx::PIXEL_FORMAT_UNKNOWN;
+}
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureAtlas class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+TextureAtlas::TextureAtlas()
+: m_Desc        ()
+, m_pPacker     (nullptr)
+, m_Width       (0)
+, m_Height      (0)
+, m_PixelSize   (0)
+, m_UsedPixels  (0)
+, m_SlotPixels  (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+TextureAtlas::~TextureAtlas()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool TextureAtlas::Init(const Desc& desc)
+{
+    Term();
+
+    auto format = GetPixelFormatFromDXGI(desc.Format);
+    if (format == PIXEL_FORMAT_UNKNOWN)
+    {
+        ELOG("Error : Unsupported Atlas Format. format = %u", desc.Format);
+        return false;
+    }
+
+    m_Desc = desc;
+    if (m_Desc.MaxWidth == 0 || m_Desc.MaxWidth > kMaxTextureSize)
+    { m_Desc.MaxWidth = kMaxTextureSize; }
+    if (m_Desc.MaxHeight == 0 || m_Desc.MaxHeight > kMaxTextureSize)
+    { m_Desc.MaxHeight = kMaxTextureSize; }
+    if (m_Desc.MipCount == 0)
+    { m_Desc.MipCount = 1; }
+    if (m_Desc.MipCount > kMaxMipCount)
+    { m_Desc.MipCount = kMaxMipCount; }
+
+    if (m_Desc.Width > m_Desc.MaxWidth || m_Desc.Height > m_Desc.MaxHeight)
+    {
+        ELOG("Error : Invalid Atlas Size. width = %u, height = %u", desc.Width, desc.Height);
+        return false;
+    }
+
+    if (m_Desc.Packer == ATLAS_PACKER_SKYLINE)
+    { m_pPacker = new (std::nothrow) SkylinePacker(); }
+    else
+    { m_pPacker = new (std::nothrow) MaxRectsPacker(); }
+
+    if (m_pPacker == nullptr)
+    {
+        ELOG("Error : Out of memory.");
+        return false;
+    }
+
+    m_PixelSize = GetPixelFormatSize(format);
+    Clear();
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void TextureAtlas::Term()
+{
+    if (m_pPacker != nullptr)
+    {
+        delete m_pPacker;
+        m_pPacker = nullptr;
+    }
+
+    m_Pixels.clear();
+    m_Pixels.shrink_to_fit();
+    m_Regions.clear();
+    m_Width      = 0;
+    m_Height     = 0;
+    m_PixelSize  = 0;
+    m_UsedPixels = 0;
+    m_SlotPixels = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      入力をまとめて配置し直してアトラスを構築します.
+//-------------------------------------------------------------------------------------------------
+bool TextureAtlas::Build(const Input* pInputs, uint32_t count)
+{
+    if (m_pPacker == nullptr || (pInputs == nullptr && count > 0))
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    Clear();
+
+    std::vector<Slot>     slots(count);
+    std::vector<uint32_t> order(count);
+    uint64_t area    = 0;
+    uint32_t minW    = 1;
+    uint32_t minH    = 1;
+
+    m_Regions.reserve(count);
+    for(auto i=0u; i<count; ++i)
+    {
+        auto& input = pInputs[i];
+        if (input.Name == nullptr || input.pTexture == nullptr || !IsValidInput(*input.pTexture))
+        {
+            ELOGA("Error : Invalid Atlas Input. index = %u", i);
+            Clear();
+            return false;
+        }
+
+        if (!m_Regions.emplace(input.Name, Region()).second)
+        {
+            ELOGA("Error : Duplicate Atlas Name. name = %s", input.Name);
+            Clear();
+            return false;
+        }
+
+        slots[i] = CalcSlot(input.pTexture->Width, input.pTexture->Height);
+        order[i] = i;
+        area += uint64_t(slots[i].Width) * slots[i].Height;
+
+        // 回転を許す場合は短い辺だけ収まればよい.
+        auto shortSide = std::min(slots[i].Width, slots[i].Height);
+        minW = std::max(minW, m_Desc.AllowRotation ? shortSide : slots[i].Width);
+        minH = std::max(minH, m_Desc.AllowRotation ? shortSide : slots[i].Height);
+    }
+
+    // スカイラインは高さ順，MaxRectsは長い辺の順に並べると充填率が上がる.
+    if (m_Desc.Packer == ATLAS_PACKER_SKYLINE && !m_Desc.AllowRotation)
+    {
+        std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs)
+        {
+            if (slots[lhs].Height != slots[rhs].Height)
+            { return slots[lhs].Height > slots[rhs].Height; }
+            return slots[lhs].Width > slots[rhs].Width;
+        });
+    }
+    else
+    {
+        std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs)
+        {
+            auto l0 = std::max(slots[lhs].Width, slots[lhs].Height);
+            auto r0 = std::max(slots[rhs].Width, slots[rhs].Height);
+            if (l0 != r0)
+            { return l0 > r0; }
+            return std::min(slots[lhs].Width, slots[lhs].Height) > std::min(slots[rhs].Width, slots[rhs].Height);
+        });
+    }
+
+    // 初期サイズは総面積を満たす最小の2のべき乗にする.
+    auto width  = m_Desc.Width;
+    auto height = m_Desc.Height;
+    if (width == 0 || height == 0)
+    {
+        width  = std::min(NextPow2(minW), m_Desc.MaxWidth);
+        height = std::min(NextPow2(minH), m_Desc.MaxHeight);
+        while(uint64_t(width) * height < area)
+        {
+            if (width <= height && width < m_Desc.MaxWidth)
+            { width = std::min(width * 2, m_Desc.MaxWidth); }
+            else if (height < m_Desc.MaxHeight)
+            { height = std::min(height * 2, m_Desc.MaxHeight); }
+            else
+            { break; }
+        }
+    }
+
+    // 収まらない場合は拡張して最初から配置し直す.
+    std::vector<Region> placed(count);
+    for(;;)
+    {
+        m_Width  = width;
+        m_Height = height;
+        m_pPacker->Reset(width, height);
+
+        auto success = true;
+        for(auto index : order)
+        {
+            uint32_t x, y;
+            bool rotated;
+            if (!Place(slots[index], x, y, rotated))
+            {
+                success = false;
+                break;
+            }
+
+            auto& texture = *pInputs[index].pTexture;
+            auto& region  = placed[index];
+            region.X       = x + m_Desc.Gutter;
+            region.Y       = y + m_Desc.Gutter;
+            region.Width   = rotated ? texture.Height : texture.Width;
+            region.Height  = rotated ? texture.Width  : texture.Height;
+            region.Rotated = rotated;
+        }
+
+        if (success)
+        { break; }
+
+        if (!Grow())
+        {
+            ELOG("Error : Atlas Overflow. maxWidth = %u, maxHeight = %u", m_Desc.MaxWidth, m_Desc.MaxHeight);
+            Clear();
+            return false;
+        }
+
+        width  = m_Width;
+        height = m_Height;
+    }
+
+    m_Pixels.assign(size_t(m_Width) * m_Height * m_PixelSize, 0);
+
+    // 領域は重ならないので並列に書き込める.
+    std::atomic<bool> result(true);
+    ParallelFor(count, kBlitJobCount, [&](uint32_t begin, uint32_t end)
+    {
+        for(auto i=begin; i<end; ++i)
+        {
+            if (!Blit(*pInputs[i].pTexture, placed[i]))
+            { result = false; }
+        }
+    });
+
+    if (!result)
+    {
+        Clear();
+        return false;
+    }
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto& texture = *pInputs[i].pTexture;
+        m_Regions[pInputs[i].Name] = placed[i];
+        m_UsedPixels += uint64_t(texture.Width) * texture.Height;
+        m_SlotPixels += uint64_t(slots[i].Width) * slots[i].Height;
+    }
+
+    UpdateUV();
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      配置済みの領域を動かさずに1つ追加します.
+//-------------------------------------------------------------------------------------------------
+bool TextureAtlas::Insert(const char* name, const ResTexture& texture)
+{
+    if (m_pPacker == nullptr || name == nullptr || !IsValidInput(texture))
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    if (m_Regions.find(name) != m_Regions.end())
+    {
+        ELOGA("Error : Duplicate Atlas Name. name = %s", name);
+        return false;
+    }
+
+    auto slot = CalcSlot(texture.Width, texture.Height);
+
+    if (m_Width == 0 || m_Height == 0)
+    {
+        auto width  = (m_Desc.Width  != 0) ? m_Desc.Width  : std::max(kDefaultSize, NextPow2(slot.Width));
+        auto height = (m_Desc.Height != 0) ? m_Desc.Height : std::max(kDefaultSize, NextPow2(slot.Height));
+        Resize(std::min(width, m_Desc.MaxWidth), std::min(height, m_Desc.MaxHeight));
+        m_pPacker->Reset(m_Width, m_Height);
+    }
+
+    uint32_t x, y;
+    bool rotated;
+    auto grown = false;
+    while(!Place(slot, x, y, rotated))
+    {
+        if (!Grow())
+        {
+            ELOGA("Error : Atlas Overflow. name = %s", name);
+            return false;
+        }
+
+        grown = true;
+    }
+
+    Region region;
+    region.X       = x + m_Desc.Gutter;
+    region.Y       = y + m_Desc.Gutter;
+    region.Width   = rotated ? texture.Height : texture.Width;
+    region.Height  = rotated ? texture.Width  : texture.Height;
+    region.Rotated = rotated;
+
+    if (!Blit(texture, region))
+    { return false; }
+
+    auto invW = 1.0f / float(m_Width);
+    auto invH = 1.0f / float(m_Height);
+    region.UV0 = Vector2(float(region.X) * invW, float(region.Y) * invH);
+    region.UV1 = Vector2(float(region.X + region.Width) * invW, float(region.Y + region.Height) * invH);
+
+    m_Regions.emplace(name, region);
+    m_UsedPixels += uint64_t(texture.Width) * texture.Height;
+    m_SlotPixels += uint64_t(slot.Width) * slot.Height;
+
+    // 拡張した場合は配置済みの領域のテクスチャ座標も変わる.
+    if (grown)
+    { UpdateUV(); }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      名前から領域を検索します.
+//-------------------------------------------------------------------------------------------------
+bool TextureAtlas::Find(const char* name, Region& result) const
+{
+    if (name == nullptr)
+    { return false; }
+
+    auto itr = m_Regions.find(name);
+    if (itr == m_Regions.end())
+    { return false; }
+
+    result = itr->second;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      名前から領域へのテーブルを取得します.
+//-------------------------------------------------------------------------------------------------
+const std::unordered_map<std::string, TextureAtlas::Region>& TextureAtlas::GetRegions() const
+{ return m_Regions; }
+
+//-------------------------------------------------------------------------------------------------
+//      アトラスをリソーステクスチャとして取得します.
+//-------------------------------------------------------------------------------------------------
+bool TextureAtlas::GetTexture(ResTexture& result) const
+{
+    if (m_Pixels.empty())
+    {
+        ELOG("Error : Atlas is empty.");
+        return false;
+    }
+
+    result.Width        = m_Width;
+    result.Height       = m_Height;
+    result.Depth        = 1;
+    result.Format       = m_Desc.Format;
+    result.MipMapCount  = 1;
+    result.SurfaceCount = 1;
+    result.Option       = 0;
+
+    // サブリソースとピクセルデータをまとめて確保する.
+    if (!AllocateResTexture(result))
+    { return false; }
+
+    const auto& res = result.pResources[0];
+    if (size_t(res.SlicePitch) != m_Pixels.size())
+    {
+        ELOG("Error : Pitch Mismatch. format = %u", m_Desc.Format);
+        result.Release();
+        return false;
+    }
+
+    memcpy(res.pPixels, m_Pixels.data(), m_Pixels.size());
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アトラスの横幅を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t TextureAtlas::GetWidth() const
+{ return m_Width; }
+
+//-------------------------------------------------------------------------------------------------
+//      アトラスの縦幅を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t TextureAtlas::GetHeight() const
+{ return m_Height; }
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+TextureAtlas::Stats TextureAtlas::GetStats() const
+{
+    Stats result = {};
+    result.RegionCount = uint32_t(m_Regions.size());
+    result.UsedPixels  = m_UsedPixels;
+    result.SlotPixels  = m_SlotPixels;
+
+    auto total = uint64_t(m_Width) * m_Height;
+    if (total > 0)
+    { result.Occupancy = float(double(m_UsedPixels) / double(total)); }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ガター, 余白, 境界揃えを含めた配置サイズを求めます.
+//-------------------------------------------------------------------------------------------------
+TextureAtlas::Slot TextureAtlas::CalcSlot(uint32_t width, uint32_t height) const
+{
+    // ミップレベル MipCount-1 の1テクセルが2つの領域にまたがらないように揃える.
+    auto alignment = 1u << (m_Desc.MipCount - 1);
+    auto extra     = m_Desc.Gutter * 2 + m_Desc.Padding;
+
+    Slot result;
+    result.Width  = AlignUp(width  + extra, alignment);
+    result.Height = AlignUp(height + extra, alignment);
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      配置サイズの矩形を配置します.
+//-------------------------------------------------------------------------------------------------
+bool TextureAtlas::Place(const Slot& slot, uint32_t& x, uint32_t& y, bool& rotated)
+{
+    rotated = false;
+
+    // 正方形は回転しても同じなので試さない.
+    auto allowRotation = m_Desc.AllowRotation && slot.Width != slot.Height;
+    return m_pPacker->Insert(slot.Width, slot.Height, allowRotation, x, y, rotated);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      短い辺を2倍に拡張します.
+//-------------------------------------------------------------------------------------------------
+bool TextureAtlas::Grow()
+{
+    auto width  = m_Width;
+    auto height = m_Height;
+
+    if (width <= height && width < m_Desc.MaxWidth)
+    { width = std::min(width * 2, m_Desc.MaxWidth); }
+    else if (height < m_Desc.MaxHeight)
+    { height = std::min(height * 2, m_Desc.MaxHeight); }
+    else if (width < m_Desc.MaxWidth)
+    { width = std::min(width * 2, m_Desc.MaxWidth); }
+    else
+    { return false; }
+
+    m_pPacker->Grow(width, height);
+    Resize(width, height);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ピクセルデータを保ったままサイズを変更します.
+//-------------------------------------------------------------------------------------------------
+void TextureAtlas::Resize(uint32_t width, uint32_t height)
+{
+    // Build() の配置中はピクセルデータを確保していないので，サイズだけ更新する.
+    if (!m_Pixels.empty() || m_Width == 0)
+    {
+        std::vector<uint8_t> pixels(size_t(width) * height * m_PixelSize, 0);
+
+        auto srcPitch = size_t(m_Width) * m_PixelSize;
+        auto dstPitch = size_t(width)   * m_PixelSize;
+        for(auto y=0u; y<m_Height; ++y)
+        { memcpy(pixels.data() + dstPitch * y, m_Pixels.data() + srcPitch * y, srcPitch); }
+
+        m_Pixels.swap(pixels);
+    }
+
+    m_Width  = width;
+    m_Height = height;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      入力テクスチャを領域に書き込み，ガターを埋めます.
+//-------------------------------------------------------------------------------------------------
+bool TextureAtlas::Blit(const ResTexture& texture, const Region& region)
+{
+    auto& src       = texture.pResources[0];
+    auto  srcFormat = GetPixelFormatFromDXGI(texture.Format);
+    auto  dstFormat = GetPixelFormatFromDXGI(m_Desc.Format);
+    auto  pSrc      = static_cast<const uint8_t*>(src.pPixels);
+    auto  srcPitch  = src.Pitch;
+    auto  width     = texture.Width;
+    auto  height    = texture.Height;
+
+    // ブロック圧縮は最上位レベルだけ展開する.
+    std::vector<uint8_t> decoded;
+    if (IsBlockCompressedFormat(texture.Format))
+    {
+        auto decodedFormat = GetDecodedFormat(texture.Format);
+        srcFormat = GetPixelFormatFromDXGI(decodedFormat);
+        srcPitch  = width * GetPixelFormatSize(srcFormat);
+        decoded.resize(size_t(srcPitch) * height);
+        if (!DecodeBlocks(texture.Format, pSrc, src.Pitch, width, height, decoded.data(), srcPitch))
+        {
+            ELOG("Error : DecodeBlocks() Failed. format = %u", texture.Format);
+            return false;
+        }
+        pSrc = decoded.data();
+    }
+
+    auto pitch = size_t(m_Width) * m_PixelSize;
+    auto pDst  = m_Pixels.data() + pitch * region.Y + size_t(region.X) * m_PixelSize;
+
+    if (!region.Rotated)
+    {
+        if (!ConvertPixels(pSrc, srcFormat, pDst, dstFormat, width, height, srcPitch, uint32_t(pitch)))
+        {
+            ELOG("Error : ConvertPixels() Failed.");
+            return false;
+        }
+    }
+    else
+    {
+        std::vector<uint8_t> temp(size_t(width) * height * m_PixelSize);
+        if (!ConvertPixels(pSrc, srcFormat, temp.data(), dstFormat, width, height, srcPitch, 0))
+        {
+            ELOG("Error : ConvertPixels() Failed.");
+            return false;
+        }
+
+        // 時計回りに90度回転: 元の(x, y)を(height - 1 - y, x)に置く.
+        for(auto y=0u; y<height; ++y)
+        {
+            auto pRow = temp.data() + size_t(y) * width * m_PixelSize;
+            auto col  = height - 1 - y;
+            for(auto x=0u; x<width; ++x)
+            { memcpy(pDst + pitch * x + size_t(col) * m_PixelSize, pRow + size_t(x) * m_PixelSize, m_PixelSize); }
+        }
+    }
+
+    // 上下の行を複製してから，角を含めて左右の列を複製する.
+    auto gutter   = m_Desc.Gutter;
+    auto rowBytes = size_t(region.Width) * m_PixelSize;
+    auto pTop     = pDst;
+    auto pBottom  = pDst + pitch * (region.Height - 1);
+    for(auto g=1u; g<=gutter; ++g)
+    {
+        memcpy(pTop    - pitch * g, pTop,    rowBytes);
+        memcpy(pBottom + pitch * g, pBottom, rowBytes);
+    }
+
+    auto pRight = (region.Width - 1) * size_t(m_PixelSize);
+    for(auto y=0u; y<region.Height + gutter * 2; ++y)
+    {
+        auto pRow = pDst + pitch * y - pitch * gutter;
+        for(auto g=1u; g<=gutter; ++g)
+        {
+            memcpy(pRow - size_t(g) * m_PixelSize,      pRow,          m_PixelSize);
+            memcpy(pRow + pRight + size_t(g) * m_PixelSize, pRow + pRight, m_PixelSize);
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全ての領域のテクスチャ座標を更新します.
+//-------------------------------------------------------------------------------------------------
+void TextureAtlas::UpdateUV()
+{
+    auto invW = 1.0f / float(m_Width);
+    auto invH = 1.0f / float(m_Height);
+
+    for(auto& itr : m_Regions)
+    {
+        auto& region = itr.second;
+        region.UV0 = Vector2(float(region.X) * invW, float(region.Y) * invH);
+        region.UV1 = Vector2(float(region.X + region.Width) * invW, float(region.Y + region.Height) * invH);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      配置とピクセルデータを破棄します.
+//-------------------------------------------------------------------------------------------------
+void TextureAtlas::Clear()
+{
+    m_Pixels.clear();
+    m_Regions.clear();
+    m_Width      = 0;
+    m_Height     = 0;
+    m_UsedPixels = 0;
+    m_SlotPixels = 0;
+
+    if (m_pPacker != nullptr)
+    { m_pPacker->Reset(0, 0); }
+}
+
+} // namespace asdx
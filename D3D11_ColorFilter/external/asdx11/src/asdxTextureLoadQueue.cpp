@@ -0,0 +1,551 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxTextureLoadQueue.cpp
+// Desc : Asynchronous Texture Load Queue Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxTextureLoadQueue.h>
+#include <asdxLogger.h>
+#include <objbase.h>
+#include <chrono>
+#include <new>
+#include <string>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Type Definitions.
+//-------------------------------------------------------------------------------------------------
+using Clock     = std::chrono::steady_clock;
+using TimePoint = Clock::time_point;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SOURCE_TYPE enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum SOURCE_TYPE
+{
+    SOURCE_TYPE_FILE_A = 0,     //!< マルチバイト文字列のファイル名です.
+    SOURCE_TYPE_FILE_W,         //!< ワイド文字列のファイル名です.
+    SOURCE_TYPE_MEMORY,         //!< メモリストリームです.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      経過時間をミリ秒単位で求めます.
+//-------------------------------------------------------------------------------------------------
+inline double ElapsedMsec(const TimePoint& begin, const TimePoint& end)
+{ return std::chrono::duration<double, std::milli>(end - begin).count(); }
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureLoadQueue::Request structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TextureLoadQueue::Request
+{
+    SOURCE_TYPE             Type;           //!< 読み込み元の種類です.
+    std::string             PathA;          //!< ファイル名です.
+    std::wstring            PathW;          //!< ファイル名です.
+    std::vector<uint8_t>    Buffer;         //!< メモリストリームのコピーです.
+    TextureLoadOptions      Options;        //!< 読み込み設定のコピーです.
+    int                     Priority;       //!< 優先度です.
+    TextureLoadCallback     Callback;       //!< 完了時のコールバックです.
+    void*                   pUser;          //!< ユーザーデータです.
+    TimePoint               SubmitTime;     //!< 要求した時刻です.
+    bool                    Running;        //!< 読み込み中かどうか.
+    bool                    Canceled;       //!< 読み込み中にキャンセルされたかどうか.
+
+    Request()
+    : Type      (SOURCE_TYPE_FILE_A)
+    , Priority  (0)
+    , Callback  (nullptr)
+    , pUser     (nullptr)
+    , Running   (false)
+    , Canceled  (false)
+    { /* DO_NOTHING */ }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TextureLoadQueue class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+TextureLoadQueue::TextureLoadQueue()
+: m_NextHandle      (1)
+, m_RunningCount    (0)
+, m_Finish          (false)
+, m_CompletedCount  (0)
+, m_FailedCount     (0)
+, m_CanceledCount   (0)
+, m_TotalWaitMsec   (0.0)
+, m_MaxWaitMsec     (0.0)
+, m_TotalDecodeMsec (0.0)
+, m_MaxDecodeMsec   (0.0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+TextureLoadQueue::~TextureLoadQueue()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool TextureLoadQueue::Init(const Desc& desc)
+{
+    if (!m_Workers.empty())
+    {
+        ELOG("Error : TextureLoadQueue is already initialized.");
+        return false;
+    }
+
+    auto workerCount = desc.WorkerCount;
+    if (workerCount == 0)
+    {
+        auto threadCount = uint32_t(std::thread::hardware_concurrency());
+        workerCount = (threadCount > 1) ? threadCount - 1 : 1;
+    }
+
+    m_Finish = false;
+
+    m_Workers.reserve(workerCount);
+    for(auto i=0u; i<workerCount; ++i)
+    { m_Workers.emplace_back(&TextureLoadQueue::WorkerMain, this); }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void TextureLoadQueue::Term()
+{
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        m_Finish = true;
+
+        // 待機中の要求は破棄する.
+        for(auto& key : m_Pending)
+        {
+            auto itr = m_Requests.find(key.Handle);
+            delete itr->second;
+            m_Requests.erase(itr);
+            m_CanceledCount++;
+        }
+        m_Pending.clear();
+    }
+
+    m_WorkCond.notify_all();
+
+    for(auto& worker : m_Workers)
+    { worker.join(); }
+    m_Workers.clear();
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    for(auto& result : m_Ready)
+    { result.Texture.Release(); }
+    m_Ready.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルの読み込みを要求します.
+//-------------------------------------------------------------------------------------------------
+TextureLoadHandle TextureLoadQueue::RequestA
+(
+    const char*                 filename,
+    int                         priority,
+    TextureLoadCallback         callback,
+    void*                       pUser,
+    const TextureLoadOptions*   pOptions
+)
+{
+    if (filename == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return 0;
+    }
+
+    auto pRequest = new (std::nothrow) Request();
+    if (pRequest == nullptr)
+    {
+        ELOG("Error : Out of memory.");
+        return 0;
+    }
+
+    pRequest->Type     = SOURCE_TYPE_FILE_A;
+    pRequest->PathA    = filename;
+    pRequest->Callback = callback;
+    pRequest->pUser    = pUser;
+
+    if (pOptions != nullptr)
+    { pRequest->Options = *pOptions; }
+
+    return Push(pRequest, priority);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルの読み込みを要求します.
+//-------------------------------------------------------------------------------------------------
+TextureLoadHandle TextureLoadQueue::RequestW
+(
+    const wchar_t*              filename,
+    int                         priority,
+    TextureLoadCallback         callback,
+    void*                       pUser,
+    const TextureLoadOptions*   pOptions
+)
+{
+    if (filename == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return 0;
+    }
+
+    auto pRequest = new (std::nothrow) Request();
+    if (pRequest == nullptr)
+    {
+        ELOG("Error : Out of memory.");
+        return 0;
+    }
+
+    pRequest->Type     = SOURCE_TYPE_FILE_W;
+    pRequest->PathW    = filename;
+    pRequest->Callback = callback;
+    pRequest->pUser    = pUser;
+
+    if (pOptions != nullptr)
+    { pRequest->Options = *pOptions; }
+
+    return Push(pRequest, priority);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリストリームの読み込みを要求します.
+//-------------------------------------------------------------------------------------------------
+TextureLoadHandle TextureLoadQueue::RequestMemory
+(
+    const uint8_t*              pBuffer,
+    uint32_t                    bufferSize,
+    int                         priority,
+    TextureLoadCallback         callback,
+    void*                       pUser,
+    const TextureLoadOptions*   pOptions
+)
+{
+    if (pBuffer == nullptr || bufferSize == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return 0;
+    }
+
+    auto pRequest = new (std::nothrow) Request();
+    if (pRequest == nullptr)
+    {
+        ELOG("Error : Out of memory.");
+        return 0;
+    }
+
+    pRequest->Type     = SOURCE_TYPE_MEMORY;
+    pRequest->Buffer.assign(pBuffer, pBuffer + bufferSize);
+    pRequest->Callback = callback;
+    pRequest->pUser    = pUser;
+
+    if (pOptions != nullptr)
+    { pRequest->Options = *pOptions; }
+
+    return Push(pRequest, priority);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      読み込み要求をキャンセルします.
+//-------------------------------------------------------------------------------------------------
+bool TextureLoadQueue::Cancel(TextureLoadHandle handle)
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto itr = m_Requests.find(handle);
+    if (itr == m_Requests.end())
+    { return false; }
+
+    auto pRequest = itr->second;
+    if (pRequest->Canceled)
+    { return false; }
+
+    m_CanceledCount++;
+
+    // 読み込み中の要求は完了後にワーカーが破棄する.
+    if (pRequest->Running)
+    {
+        pRequest->Canceled = true;
+        return true;
+    }
+
+    m_Pending.erase(OrderKey{ pRequest->Priority, handle });
+    m_Requests.erase(itr);
+    delete pRequest;
+
+    if (m_Pending.empty() && m_RunningCount == 0)
+    { m_IdleCond.notify_all(); }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      待機中の要求の優先度を変更します.
+//-------------------------------------------------------------------------------------------------
+bool TextureLoadQueue::SetPriority(TextureLoadHandle handle, int priority)
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto itr = m_Requests.find(handle);
+    if (itr == m_Requests.end() || itr->second->Running)
+    { return false; }
+
+    auto pRequest = itr->second;
+    if (pRequest->Priority != priority)
+    {
+        m_Pending.erase (OrderKey{ pRequest->Priority, handle });
+        m_Pending.insert(OrderKey{ priority, handle });
+        pRequest->Priority = priority;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      読み込み要求の状態を取得します.
+//-------------------------------------------------------------------------------------------------
+TEXTURE_LOAD_STATE TextureLoadQueue::GetState(TextureLoadHandle handle) const
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto itr = m_Requests.find(handle);
+    if (itr != m_Requests.end())
+    {
+        if (itr->second->Canceled)
+        { return TEXTURE_LOAD_STATE_INVALID; }
+
+        return (itr->second->Running) ? TEXTURE_LOAD_STATE_RUNNING : TEXTURE_LOAD_STATE_PENDING;
+    }
+
+    for(auto& result : m_Ready)
+    {
+        if (result.Handle == handle)
+        { return TEXTURE_LOAD_STATE_COMPLETED; }
+    }
+
+    return TEXTURE_LOAD_STATE_INVALID;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      完了した読み込み結果を受け取ります.
+//-------------------------------------------------------------------------------------------------
+uint32_t TextureLoadQueue::Poll(TextureLoadResult* pResults, uint32_t maxCount)
+{
+    if (pResults == nullptr || maxCount == 0)
+    { return 0; }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto count = uint32_t(m_Ready.size());
+    if (count > maxCount)
+    { count = maxCount; }
+
+    for(auto i=0u; i<count; ++i)
+    { pResults[i] = m_Ready[i]; }
+
+    m_Ready.erase(m_Ready.begin(), m_Ready.begin() + count);
+    return count;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      待機中と読み込み中の要求が全て完了するまで待ちます.
+//-------------------------------------------------------------------------------------------------
+void TextureLoadQueue::WaitIdle()
+{
+    std::unique_lock<std::mutex> locker(m_Mutex);
+    if (m_Workers.empty())
+    { return; }
+
+    m_IdleCond.wait(locker, [this]()
+    { return m_Pending.empty() && m_RunningCount == 0; });
+}
+
+//-------------------------------------------------------------------------------------------------
+//      待機中の要求数(キューの深さ)を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t TextureLoadQueue::GetQueueDepth() const
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    return uint32_t(m_Pending.size());
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+TextureLoadStats TextureLoadQueue::GetStats() const
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    TextureLoadStats stats;
+    stats.PendingCount      = uint32_t(m_Pending.size());
+    stats.RunningCount      = m_RunningCount;
+    stats.ReadyCount        = uint32_t(m_Ready.size());
+    stats.CompletedCount    = m_CompletedCount;
+    stats.FailedCount       = m_FailedCount;
+    stats.CanceledCount     = m_CanceledCount;
+    stats.MaxWaitMsec       = m_MaxWaitMsec;
+    stats.MaxDecodeMsec     = m_MaxDecodeMsec;
+
+    auto count = m_CompletedCount + m_FailedCount;
+    stats.AverageWaitMsec   = (count > 0) ? m_TotalWaitMsec   / double(count) : 0.0;
+    stats.AverageDecodeMsec = (count > 0) ? m_TotalDecodeMsec / double(count) : 0.0;
+
+    return stats;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要求をキューに追加します.
+//-------------------------------------------------------------------------------------------------
+TextureLoadHandle TextureLoadQueue::Push(Request* pRequest, int priority)
+{
+    pRequest->Priority   = priority;
+    pRequest->SubmitTime = Clock::now();
+
+    TextureLoadHandle handle = 0;
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        if (m_Workers.empty() || m_Finish)
+        {
+            ELOG("Error : TextureLoadQueue is not initialized.");
+            delete pRequest;
+            return 0;
+        }
+
+        handle = m_NextHandle++;
+        m_Requests[handle] = pRequest;
+        m_Pending.insert(OrderKey{ priority, handle });
+    }
+
+    m_WorkCond.notify_one();
+    return handle;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ワーカースレッドのメイン処理です.
+//-------------------------------------------------------------------------------------------------
+void TextureLoadQueue::WorkerMain()
+{
+    // WIC でデコードできるように，ワーカースレッドをマルチスレッドアパートメントに参加させる.
+    auto hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    if (FAILED(hr))
+    { ELOG("Error : CoInitializeEx() Failed. errcode = 0x%x", hr); }
+
+    ProcessRequests();
+
+    if (SUCCEEDED(hr))
+    { CoUninitialize(); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了が要求されるまで読み込み要求を処理します.
+//-------------------------------------------------------------------------------------------------
+void TextureLoadQueue::ProcessRequests()
+{
+    std::unique_lock<std::mutex> locker(m_Mutex);
+
+    for(;;)
+    {
+        m_WorkCond.wait(locker, [this]()
+        { return m_Finish || !m_Pending.empty(); });
+
+        if (m_Pending.empty())
+        { break; }
+
+        auto handle = m_Pending.begin()->Handle;
+        m_Pending.erase(m_Pending.begin());
+
+        auto pRequest = m_Requests[handle];
+        pRequest->Running = true;
+        m_RunningCount++;
+
+        locker.unlock();
+
+        // ロックを外してデコードする.
+        auto startTime = Clock::now();
+
+        TextureLoadResult result;
+        result.Handle = handle;
+        result.pUser  = pRequest->pUser;
+
+        switch(pRequest->Type)
+        {
+        case SOURCE_TYPE_FILE_A:
+            { result.Success = result.Texture.LoadFromFileA(pRequest->PathA.c_str(), &pRequest->Options); }
+            break;
+
+        case SOURCE_TYPE_FILE_W:
+            { result.Success = result.Texture.LoadFromFileW(pRequest->PathW.c_str(), &pRequest->Options); }
+            break;
+
+        case SOURCE_TYPE_MEMORY:
+            {
+                result.Success = result.Texture.LoadFromMemory(
+                    pRequest->Buffer.data(), uint32_t(pRequest->Buffer.size()), &pRequest->Options);
+            }
+            break;
+        }
+
+        auto endTime = Clock::now();
+        result.WaitMsec   = ElapsedMsec(pRequest->SubmitTime, startTime);
+        result.DecodeMsec = ElapsedMsec(startTime, endTime);
+
+        locker.lock();
+
+        m_Requests.erase(handle);
+
+        if (!pRequest->Canceled)
+        {
+            if (result.Success)
+            { m_CompletedCount++; }
+            else
+            { m_FailedCount++; }
+
+            m_TotalWaitMsec   += result.WaitMsec;
+            m_TotalDecodeMsec += result.DecodeMsec;
+            if (result.WaitMsec > m_MaxWaitMsec)
+            { m_MaxWaitMsec = result.WaitMsec; }
+            if (result.DecodeMsec > m_MaxDecodeMsec)
+            { m_MaxDecodeMsec = result.DecodeMsec; }
+        }
+
+        if (pRequest->Canceled)
+        { result.Texture.Release(); }
+        else if (pRequest->Callback != nullptr)
+        {
+            // コールバック中は他の要求を処理できるようにロックを外す.
+            locker.unlock();
+            pRequest->Callback(result);
+            locker.lock();
+        }
+        else
+        { m_Ready.push_back(result); }
+
+        delete pRequest;
+
+        m_RunningCount--;
+        if (m_Pending.empty() && m_RunningCount == 0)
+        { m_IdleCond.notify_all(); }
+    }
+}
+
+} // namespace asdx
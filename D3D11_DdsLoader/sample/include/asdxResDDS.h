@@ -227,7 +227,7 @@ struct Surface
     u32     Height;         //!< 高さです.
     u32     Pitch;          //!< ピッチです.
     u32     SlicePitch;     //!< スライスピッチです.
-    u8*     pPixels;        //!< ピクセルデータです.
+    u8*     pPixels;        //!< ピクセルデータです(ResDDSが保持するピクセルデータの一部を指します).
 
     void Release();
     Surface& operator = ( const Surface& value );
@@ -397,12 +397,20 @@ private:
     DDS_RESOURCE_DIMENSION  m_Dimension;            //!< 次元数です.
     bool                    m_IsCubeMap;            //!< キューブマップかどうか?
     Surface*                m_pSurfaces;            //!< サーフェイスです.
+    u8*                     m_pPixels;              //!< 全サーフェイスで共有するピクセルデータです.
+    u32                     m_PixelSize;            //!< ピクセルデータのバイト数です.
     u32                     m_HashKey;              //!< ハッシュキーです.
 
     //=============================================================================================
     // private methods.
     //=============================================================================================
-    /* NOTHING */
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ピクセルデータとサーフェイスを複製します.
+    //!
+    //! @param[in]      value       コピー元の値です.
+    //---------------------------------------------------------------------------------------------
+    void CopySurfaces( const ResDDS& value );
 };
 
 
@@ -12,6 +12,7 @@
 #include <asdxMath.h>
 #include <asdxHash.h>
 #include <cstdio>
+#include <cstring>
 #include <cassert>
 #include <new>
 
@@ -233,7 +234,8 @@ namespace asdx {
 //-------------------------------------------------------------------------------------------------
 void Surface::Release()
 {
-    ASDX_DELETE_ARRAY( pPixels );
+    // ピクセルデータはResDDSが保持しているので，参照を外すだけにする.
+    pPixels    = nullptr;
     Width      = 0;
     Height     = 0;
     Pitch      = 0;
@@ -249,13 +251,7 @@ Surface& Surface::operator = ( const Surface& value )
     Height     = value.Height;
     Pitch      = value.Pitch;
     SlicePitch = value.SlicePitch;
-    ASDX_DELETE_ARRAY( pPixels );
-
-    pPixels = new (std::nothrow) u8 [ SlicePitch ];
-    assert( pPixels != nullptr );
-
-    if ( pPixels )
-    { memcpy( pPixels, value.pPixels, SlicePitch * sizeof(u8) ); }
+    pPixels    = value.pPixels;
 
     return (*this);
 }
@@ -277,6 +273,8 @@ ResDDS::ResDDS()
 , m_Dimension   ( DDS_RESOURCE_DIMENSION_TEXTURE2D )
 , m_IsCubeMap   ( false )
 , m_pSurfaces   ( nullptr )
+, m_pPixels     ( nullptr )
+, m_PixelSize   ( 0 )
 , m_HashKey     ( 0 )
 { /* DO_NOTHING */ }
 
@@ -293,18 +291,10 @@ ResDDS::ResDDS( const ResDDS& value )
 , m_Dimension   ( value.m_Dimension )
 , m_IsCubeMap   ( value.m_IsCubeMap )
 , m_pSurfaces   ( nullptr )
+, m_pPixels     ( nullptr )
+, m_PixelSize   ( 0 )
 , m_HashKey     ( value.m_HashKey )
-{
-    auto size = m_SurfaceCount * m_MipMapCount;
-    m_pSurfaces = new (std::nothrow) Surface [ size ];
-    assert( m_pSurfaces != nullptr );
-
-    if ( m_pSurfaces )
-    {
-        for( u32 i=0; i<size; ++i )
-        { m_pSurfaces[i] = value.m_pSurfaces[i]; }
-    }
-}
+{ CopySurfaces( value ); }
 
 //-------------------------------------------------------------------------------------------------
 //      デストラクタです.
@@ -630,6 +620,7 @@ bool ResDDS::Load( const char16* filename )
     if ( format == DDS_FORMAT_UNKNOWN )
     {
         ELOG( "Error : Unsupported Format." );
+        fclose( pFile );
         return false;
     }
 
@@ -637,8 +628,9 @@ bool ResDDS::Load( const char16* filename )
     fseek( pFile, 0, SEEK_END );
     auto end = ftell( pFile );
     fseek( pFile, cur, SEEK_SET );
-    auto pixelSize = end - cur;
+    auto pixelSize = u32( end - cur );
 
+    // ピクセルデータは一括で読み込み，各サーフェイスはその中を指すようにする.
     auto pPixels = new (std::nothrow) u8 [ pixelSize ];
     assert( pPixels != nullptr );
     if ( pPixels == nullptr )
@@ -648,9 +640,16 @@ bool ResDDS::Load( const char16* filename )
         return false;
     }
 
-    fread( pPixels, sizeof(u8), pixelSize, pFile );
+    auto readSize = fread( pPixels, sizeof(u8), pixelSize, pFile );
     fclose( pFile );
 
+    if ( readSize != pixelSize )
+    {
+        ELOG( "Error : File Read Failed." );
+        ASDX_DELETE_ARRAY( pPixels );
+        return false;
+    }
+
     auto pSurfaces = new (std::nothrow) Surface[ mipMapCount * surfaceCount ];
     assert( pSurfaces != nullptr );
     if ( pSurfaces == nullptr )
@@ -660,13 +659,15 @@ bool ResDDS::Load( const char16* filename )
         return false;
     }
 
-    u32 w = width;
-    u32 h = height;
-    u32 d = depth;
     u32 offset = 0;
 
     for( auto j=0; j<surfaceCount; ++j )
     {
+        // DDSはサーフェイスごとに全ミップレベルが並んでいるので，サーフェイス毎にサイズを戻す.
+        u32 w = width;
+        u32 h = height;
+        u32 d = depth;
+
         for( auto i=0; i<mipMapCount; ++i )
         {
             auto idx = ( mipMapCount * j ) + i;
@@ -680,22 +681,18 @@ bool ResDDS::Load( const char16* filename )
             pSurfaces[ idx ].Height     = h;
             pSurfaces[ idx ].Pitch      = rowBytes;
             pSurfaces[ idx ].SlicePitch = numBytes;
-            pSurfaces[ idx ].pPixels    = new (std::nothrow) u8 [ numBytes ];
-            assert( pSurfaces[ idx ].pPixels != nullptr );
+            pSurfaces[ idx ].pPixels    = pPixels + offset;
 
-            if ( pSurfaces[ idx ].pPixels == nullptr )
+            // ボリュームテクスチャは奥行分のスライスが並ぶ.
+            u64 totalBytes = ( depth != 0 ) ? u64( numBytes ) * d : numBytes;
+            if ( u64( offset ) + totalBytes > pixelSize )
             {
-                ELOG( "Error : Out of Memory." );
-                for( auto k=0; k<idx; ++k )
-                { pSurfaces[k].Release(); }
-
+                ELOG( "Error : Out of Range." );
                 ASDX_DELETE_ARRAY( pPixels );
                 ASDX_DELETE_ARRAY( pSurfaces );
                 return false;
             }
 
-            memcpy( pSurfaces[ idx ].pPixels, pPixels + offset, numBytes );
-
             if ( depth != 0 )
             { offset += numBytes * d; }
             else
@@ -711,8 +708,6 @@ bool ResDDS::Load( const char16* filename )
         }
     }
 
-    ASDX_DELETE_ARRAY( pPixels );
-
     m_Width         = width;
     m_Height        = height;
     m_Depth         = depth;
@@ -722,6 +717,8 @@ bool ResDDS::Load( const char16* filename )
     m_MipMapCount   = mipMapCount;
     m_IsCubeMap     = isCubeMap;
     m_pSurfaces     = pSurfaces;
+    m_pPixels       = pPixels;
+    m_PixelSize     = pixelSize;
     m_HashKey       = CRC32( filename ).GetHash();
 
     return true;
@@ -732,11 +729,9 @@ bool ResDDS::Load( const char16* filename )
 //-------------------------------------------------------------------------------------------------
 void ResDDS::Release()
 {
-    auto size = m_SurfaceCount * m_MipMapCount;
-    for( u32 i=0; i<size; ++i )
-    { m_pSurfaces[i].Release(); }
-
     ASDX_DELETE_ARRAY( m_pSurfaces );
+    ASDX_DELETE_ARRAY( m_pPixels );
+    m_PixelSize     = 0;
     m_Width         = 0;
     m_Height        = 0;
     m_Depth         = 0;
@@ -806,6 +801,9 @@ const Surface* ResDDS::GetSurfaces() const
 //-------------------------------------------------------------------------------------------------
 ResDDS& ResDDS::operator = ( const ResDDS& value )
 {
+    if ( &value == this )
+    { return (*this); }
+
     m_Width         = value.m_Width;
     m_Height        = value.m_Height;
     m_Depth         = value.m_Depth;
@@ -817,15 +815,9 @@ ResDDS& ResDDS::operator = ( const ResDDS& value )
     m_HashKey       = value.m_HashKey;
 
     ASDX_DELETE_ARRAY( m_pSurfaces );
-    auto size = m_SurfaceCount * m_MipMapCount;
-    m_pSurfaces = new (std::nothrow) Surface[ size ];
-    assert( m_pSurfaces != nullptr );
-
-    if ( m_pSurfaces )
-    {
-        for( u32 i=0; i<size; ++i )
-        { m_pSurfaces[i] = value.m_pSurfaces[i]; }
-    }
+    ASDX_DELETE_ARRAY( m_pPixels );
+    m_PixelSize = 0;
+    CopySurfaces( value );
 
     return (*this);
 }
@@ -852,6 +844,39 @@ bool ResDDS::operator != ( const ResDDS& value ) const
     return ( m_HashKey != value.m_HashKey );
 }
 
+//-------------------------------------------------------------------------------------------------
+//      ピクセルデータとサーフェイスを複製します.
+//-------------------------------------------------------------------------------------------------
+void ResDDS::CopySurfaces( const ResDDS& value )
+{
+    if ( value.m_pSurfaces == nullptr || value.m_pPixels == nullptr )
+    { return; }
+
+    auto size = m_SurfaceCount * m_MipMapCount;
+    m_pSurfaces = new (std::nothrow) Surface[ size ];
+    assert( m_pSurfaces != nullptr );
+
+    m_pPixels = new (std::nothrow) u8 [ value.m_PixelSize ];
+    assert( m_pPixels != nullptr );
+
+    if ( m_pSurfaces == nullptr || m_pPixels == nullptr )
+    {
+        ASDX_DELETE_ARRAY( m_pSurfaces );
+        ASDX_DELETE_ARRAY( m_pPixels );
+        return;
+    }
+
+    // ピクセルデータは1回でコピーし，サーフェイスは同じオフセットを指し直す.
+    memcpy( m_pPixels, value.m_pPixels, value.m_PixelSize );
+    m_PixelSize = value.m_PixelSize;
+
+    for( u32 i=0; i<size; ++i )
+    {
+        m_pSurfaces[i] = value.m_pSurfaces[i];
+        m_pSurfaces[i].pPixels = m_pPixels + ( value.m_pSurfaces[i].pPixels - value.m_pPixels );
+    }
+}
+
 
 } // namespace asdx
 
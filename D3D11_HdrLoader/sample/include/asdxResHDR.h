@@ -34,6 +34,16 @@ class ResHDR : public ILoadable
     /* NOTHING */
 
 public:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // FloatFormat
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    enum FloatFormat
+    {
+        FloatFormat_RGB32F = 0,     // R32G32B32_FLOAT`.
+        FloatFormat_RGBA32F,        // R32G32B32A32_FLOAT`. At@1.0.
+        FloatFormat_RGBA16F,        // R16G16B16A16_FLOAT`. At@1.0.
+    };
+
     //=============================================================================================
     // public variables.
     //=============================================================================================
@@ -69,6 +79,18 @@ public:
     //---------------------------------------------------------------------------------------------
     bool Load( const char16* filename ) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ǂݍ݂܂.
+    //!
+    //! @param[in]      pBuffer         HDRt@C̃oCił.
+    //! @param[in]      bufferSize      obt@TCYł.
+    //! @retval true    ǂݍ݂ɐ.
+    //! @retval false   ǂݍ݂Ɏs.
+    //! @note       V`̃XLC͐擪ʒu߂ĂɃfR[h܂.
+    //!             `RLE܂܂ꍇ, ̍sȍ~𒀎fR[h܂.
+    //---------------------------------------------------------------------------------------------
+    bool LoadFromMemory( const u8* pBuffer, const u32 bufferSize );
+
     //---------------------------------------------------------------------------------------------
     //! @brief      ܂.
     //---------------------------------------------------------------------------------------------
@@ -109,6 +131,28 @@ public:
     //---------------------------------------------------------------------------------------------
     void GetFloatPixels( f32** ppResults ) const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      fR[hꂽsNZf[^wobt@ɏ݂܂.
+    //!
+    //! @param[out]     pResults        ݐł. rowPitch * c oCgȏKvł.
+    //! @param[in]      rowPitch        ݐ1s̃oCgł. 0̏ꍇ͋l߂ď݂܂.
+    //! @param[in]      format          ݌`ł.
+    //! @param[in]      applyGamma      t@CɋL^ꂽK}lŕ␳ꍇ true w肵܂.
+    //! @retval true    ݂ɐ.
+    //! @retval false   ݂Ɏs.
+    //! @note       K}␳͋ߎpowŌvZ܂(Ό덷 1e-5 ).
+    //!             ␳O 2^-125 x菬Ȃl0ƂĈ܂.
+    //---------------------------------------------------------------------------------------------
+    bool GetFloatPixels( void* pResults, u32 rowPitch, FloatFormat format, bool applyGamma = true ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ݌`1sNZ̃oCg擾܂.
+    //!
+    //! @param[in]      format          ݌`ł.
+    //! @return     1sNZ̃oCgԋp܂.
+    //---------------------------------------------------------------------------------------------
+    static u32 GetFloatPixelSize( FloatFormat format );
+
     //---------------------------------------------------------------------------------------------
     //! @brief      Zqł.
     //!
@@ -12,6 +12,17 @@
 #include <asdxLogger.h>
 #include <new>
 #include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ASDX_HDR_SIMD   1
+#else
+#define ASDX_HDR_SIMD   0
+#endif
 
 
 
@@ -50,51 +61,83 @@ enum SCANLINE_TYPE
 //-------------------------------------------------------------------------------------------------
 void RemoveEndline( char* pBuf )
 {
-    for( auto i = strlen(pBuf) -1; 0 <= i; i-- )
+    for( auto i = strlen(pBuf); 0 < i; i-- )
     {
-        if ( pBuf[ i ] != '\r' && pBuf[ i ] != '\n')
+        if ( pBuf[ i - 1 ] != '\r' && pBuf[ i - 1 ] != '\n')
             break;
 
-        pBuf[ i ] = '\0';
+        pBuf[ i - 1 ] = '\0';
     }
 }
 
+//-------------------------------------------------------------------------------------------------
+//      1sǂݎ܂.
+//-------------------------------------------------------------------------------------------------
+//      fgets() Ɠs܂Ŋi[܂. obt@Ɏ܂Ȃ͓ǂݎ̂Ă܂.
+//-------------------------------------------------------------------------------------------------
+bool ReadLine( const u8*& pSrc, const u8* pEnd, char* pBuf, u32 bufferSize )
+{
+    if ( pSrc >= pEnd )
+    { return false; }
+
+    u32 i = 0;
+    while( pSrc < pEnd )
+    {
+        auto c = char( *pSrc++ );
+        if ( i + 1 < bufferSize )
+        { pBuf[ i++ ] = c; }
+
+        if ( c == '\n' )
+        { break; }
+    }
+
+    pBuf[ i ] = '\0';
+    return true;
+}
 
 //-------------------------------------------------------------------------------------------------
 //      `̃J[ǂݎ܂.
 //-------------------------------------------------------------------------------------------------
-bool ReadOldColors( FILE* pFile, RGBE* pLine, s32 count )
+//      (1, 1, 1, n) ͒ÕsNŽJԂ\܂. s̏ꍇ pPrev JԂ܂.
+//-------------------------------------------------------------------------------------------------
+bool ReadOldColors( const u8*& pSrc, const u8* pEnd, RGBE* pLine, s32 count, const RGBE* pPrev )
 {
     auto shift = 0;
-    while( 0 < count )
+    auto x     = 0;
+    while( x < count )
     {
-        pLine[0].r = getc( pFile );
-        pLine[0].g = getc( pFile );
-        pLine[0].b = getc( pFile );
-        pLine[0].e = getc( pFile );
-
-        if ( feof( pFile ) || ferror( pFile ) )
+        if ( pEnd - pSrc < 4 )
             return false;
 
-        if ( pLine[0].r == 1
-          && pLine[0].g == 1
-          && pLine[0].b == 1 )
+        RGBE color;
+        memcpy( &color, pSrc, sizeof(color) );
+        pSrc += sizeof(color);
+
+        if ( color.r == 1
+          && color.g == 1
+          && color.b == 1 )
         {
-            for( auto i=pLine[0].e << shift; i > 0; i-- )
-            {
-                pLine[0].r = pLine[-1].r;
-                pLine[0].g = pLine[-1].g;
-                pLine[0].b = pLine[-1].b;
-                pLine[0].e = pLine[-1].e;
-                pLine++;
-                count--;
-            }
+            if ( x == 0 && pPrev == nullptr )
+                return false;
+
+            if ( shift >= 24 )
+                return false;
+
+            auto prev   = ( x > 0 ) ? pLine[ x - 1 ] : *pPrev;
+            auto repeat = s32( color.e ) << shift;
+
+            // ꂽf[^ŏo͐zȂ悤ɂ.
+            if ( repeat > count - x )
+            { repeat = count - x; }
+
+            for( auto i=0; i<repeat; ++i )
+            { pLine[ x++ ] = prev; }
+
             shift += 8;
         }
         else
         {
-            pLine++;
-            count--;
+            pLine[ x++ ] = color;
             shift = 0;
         }
     }
@@ -103,70 +146,418 @@ bool ReadOldColors( FILE* pFile, RGBE* pLine, s32 count )
 }
 
 //-------------------------------------------------------------------------------------------------
-//      J[ǂݎ܂.
+//      V`(KIRLE)̃XLCǂ`FbN܂.
 //-------------------------------------------------------------------------------------------------
-bool ReadColor( FILE* pFile, RGBE* pLine, s32 count )
+bool IsNewScanline( const u8* pSrc, const u8* pEnd, s32 count )
 {
     if ( count < 8 || 0x7fff < count )
-    { return ReadOldColors( pFile, pLine, count ); }
-
-    auto pHead = pLine;
-
-    auto j = 0;
-    auto i = getc( pFile );
-    if ( i == EOF )
         return false;
 
-    if ( i != 2 )
-    {
-        ungetc( i, pFile );
-        return ReadOldColors( pFile, pLine, count );
-    }
-
-    pLine[0].g = getc( pFile );
-    pLine[0].b = getc( pFile );
-
-    if ( ( i = getc( pFile ) ) == EOF )
+    if ( pEnd - pSrc < 4 )
         return false;
 
-    if ( pLine[0].g != 2 || pLine[0].b & 128 )
-    {
-        pLine[0].r = 2;
-        pLine[0].e = i;
-        return ReadOldColors( pFile, pLine + 1, count -1 );
-    }
+    return ( pSrc[0] == 2 && pSrc[1] == 2 && ( pSrc[2] & 128 ) == 0 );
+}
 
-    if ( ( pLine[0].b << 8 | i ) != count )
+//-------------------------------------------------------------------------------------------------
+//      V`(KIRLE)̃XLCfR[h܂.
+//-------------------------------------------------------------------------------------------------
+//      V`̃XLC͎ȊĂ̂, pLine  nullptr n
+//      ݂Ɏ̃XLC̐擪܂œǂݔ΂܂.
+//-------------------------------------------------------------------------------------------------
+bool DecodeNewScanline( const u8*& pSrc, const u8* pEnd, RGBE* pLine, s32 count )
+{
+    if ( ( pSrc[2] << 8 | pSrc[3] ) != count )
         return false;
 
-    for( i=0; i<4; ++i )
+    pSrc += 4;
+
+    for( auto i=0; i<4; ++i )
     {
-        for( j=0; j<count; )
+        for( auto j=0; j<count; )
         {
-            auto code = getc( pFile );
-            if ( code == EOF )
+            if ( pSrc >= pEnd )
                 return false;
 
+            s32 code = *pSrc++;
             if ( 128 < code )
             {
                 code &= 127;
-                auto val = getc( pFile );
-                while( code-- )
-                { 
-                    pLine[j++].v[i] = val;
+                if ( pSrc >= pEnd || count - j < code )
+                    return false;
+
+                auto val = *pSrc++;
+                if ( pLine != nullptr )
+                {
+                    for( auto k=0; k<code; ++k )
+                    { pLine[ j + k ].v[i] = val; }
                 }
             }
             else
             {
-                while( code-- )
-                { 
-                    pLine[j++].v[i] = getc( pFile );
+                if ( pEnd - pSrc < code || count - j < code )
+                    return false;
+
+                if ( pLine != nullptr )
+                {
+                    for( auto k=0; k<code; ++k )
+                    { pLine[ j + k ].v[i] = pSrc[ k ]; }
                 }
+
+                pSrc += code;
             }
+
+            j += code;
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      J[ǂݎ܂.
+//-------------------------------------------------------------------------------------------------
+bool ReadColor( const u8*& pSrc, const u8* pEnd, RGBE* pLine, s32 count, const RGBE* pPrev )
+{
+    if ( IsNewScanline( pSrc, pEnd, count ) )
+    { return DecodeNewScanline( pSrc, pEnd, pLine, count ); }
+
+    return ReadOldColors( pSrc, pEnd, pLine, count, pPrev );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ExponentTable structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ExponentTable
+{
+    f32     Scale[ 256 ];   //!< 2^(e - (128 + 8)) ̃e[uł. e = 0  0 ɂȂ܂.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      RXgN^ł.
+    //---------------------------------------------------------------------------------------------
+    ExponentTable()
+    {
+        Scale[ 0 ] = 0.0f;
+        for( s32 e=1; e<256; ++e )
+        { Scale[ e ] = ldexpf( 1.0f, e - s32(128+8) ); }
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+//      we[u擾܂.
+//-------------------------------------------------------------------------------------------------
+const f32* GetExponentTable()
+{
+    static const ExponentTable s_Table;
+    return s_Table.Scale;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+const f32 LOG2_C1       = 2.8853900817779268f;      // 2 / ln(2)
+const f32 LOG2_C3       = 0.9617966939259756f;      // 2 / (3 * ln(2))
+const f32 LOG2_C5       = 0.5770780163555854f;      // 2 / (5 * ln(2))
+const f32 LOG2_C7       = 0.4121985831111325f;      // 2 / (7 * ln(2))
+const f32 EXP2_C1       = 0.6931471805599453f;      // ln(2)
+const f32 EXP2_C2       = 0.2402265069591007f;      // ln(2)^2 / 2!
+const f32 EXP2_C3       = 0.0555041086648216f;      // ln(2)^3 / 3!
+const f32 EXP2_C4       = 0.0096181291076285f;      // ln(2)^4 / 4!
+const f32 EXP2_C5       = 0.0013333558146428f;      // ln(2)^5 / 5!
+const f32 EXP2_C6       = 0.0001540353039338f;      // ln(2)^6 / 6!
+const f32 SQRT2         = 1.4142135623730951f;
+const f32 FLT_NORM_MIN  = 1.17549435e-38f;          // K̍ŏl.
+const f32 HALF_MAX      = 65504.0f;                 // f16̍ől.
+const u32 PARALLEL_MIN_PIXELS = 64 * 1024;          // 1Xbh̍ŏsNZ.
+
+//-------------------------------------------------------------------------------------------------
+//      pow( x, y ) ̋ߎl߂܂.
+//-------------------------------------------------------------------------------------------------
+//      log2 ͉ [sqrt(1/2), sqrt(2)) Ɋ񂹂 atanh 7܂,
+//      exp2 ͏ [-0.5, 0.5] ̃eC[WJ6܂łŌvZ܂.
+//      ł؂덷͂ǂ 1.3e-7 xȂ̂, Ό덷 log2(x) * y ̊ۂߌ덷xzI,
+//      ʂLlɂȂ͈͂ł 1e-5 Ɏ܂܂.
+//-------------------------------------------------------------------------------------------------
+inline f32 FastPow( f32 x, f32 y )
+{
+    if ( x < FLT_NORM_MIN )
+    { return 0.0f; }
+
+    u32 bits;
+    memcpy( &bits, &x, sizeof(bits) );
+
+    auto e = s32( bits >> 23 ) - 127;
+    bits = ( bits & 0x007FFFFFU ) | 0x3F800000U;
+
+    f32 m;
+    memcpy( &m, &bits, sizeof(m) );
+    if ( m > SQRT2 )
+    {
+        m *= 0.5f;
+        e++;
+    }
+
+    auto t  = ( m - 1.0f ) / ( m + 1.0f );
+    auto t2 = t * t;
+    auto l  = f32( e ) + t * ( LOG2_C1 + t2 * ( LOG2_C3 + t2 * ( LOG2_C5 + t2 * LOG2_C7 ) ) );
+
+    auto v = l * y;
+    if ( v < -126.0f ) { v = -126.0f; }
+    if ( v >  129.0f ) { v =  129.0f; }
+
+    auto i = floorf( v + 0.5f );
+    auto f = v - i;
+    auto p = 1.0f + f * ( EXP2_C1 + f * ( EXP2_C2 + f * ( EXP2_C3 + f * ( EXP2_C4 + f * ( EXP2_C5 + f * EXP2_C6 ) ) ) ) );
+
+    // 2^(i-1) ̎w𒼐ڑgݗĂ 2p |. i = 128 ł p < 1 ȂLlɂȂ.
+    // i = -126  0, i = 129 ͖ɂȂ.
+    u32 scale = u32( s32( i ) + 126 ) << 23;
+    f32 s;
+    memcpy( &s, &scale, sizeof(s) );
+
+    return ( p + p ) * s;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      f16ɕϊ܂.
+//-------------------------------------------------------------------------------------------------
+inline f16 ToF16( f32 value )
+{
+    // F32ToF16() ͔͈͊O 0x7FFF(NaN) ɂ̂, ɍőlŃNvĂ.
+    return asdx::F32ToF16( ( value < HALF_MAX ) ? value : HALF_MAX );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1sNZ݂܂.
+//-------------------------------------------------------------------------------------------------
+inline void StorePixel( f32 r, f32 g, f32 b, asdx::ResHDR::FloatFormat format, u8* pDst )
+{
+    switch( format )
+    {
+    case asdx::ResHDR::FloatFormat_RGB32F:
+        {
+            const f32 value[3] = { r, g, b };
+            memcpy( pDst, value, sizeof(value) );
+        }
+        break;
+
+    case asdx::ResHDR::FloatFormat_RGBA32F:
+        {
+            const f32 value[4] = { r, g, b, 1.0f };
+            memcpy( pDst, value, sizeof(value) );
+        }
+        break;
+
+    case asdx::ResHDR::FloatFormat_RGBA16F:
+        {
+            const f16 value[4] = { ToF16( r ), ToF16( g ), ToF16( b ), ToF16( 1.0f ) };
+            memcpy( pDst, value, sizeof(value) );
+        }
+        break;
+    }
+}
+
+#if ASDX_HDR_SIMD
+//-------------------------------------------------------------------------------------------------
+//      pow( x, y ) ̋ߎl4vf܂Ƃ߂ċ߂܂.
+//-------------------------------------------------------------------------------------------------
+inline __m128 FastPow4( __m128 x, __m128 y )
+{
+    const auto one  = _mm_set1_ps( 1.0f );
+    const auto half = _mm_set1_ps( 0.5f );
+
+    auto zero = _mm_cmplt_ps( x, _mm_set1_ps( FLT_NORM_MIN ) );
+
+    auto bits = _mm_castps_si128( x );
+    auto e    = _mm_sub_epi32( _mm_srli_epi32( bits, 23 ), _mm_set1_epi32( 127 ) );
+    auto m    = _mm_castsi128_ps( _mm_or_si128(
+                    _mm_and_si128( bits, _mm_set1_epi32( 0x007FFFFF ) ),
+                    _mm_set1_epi32( 0x3F800000 ) ) );
+
+    // m > sqrt(2) Ȃ甼ɂĎw1₷(}XN-1Ȃ̂ŌZŉZɂȂ).
+    auto over = _mm_cmpgt_ps( m, _mm_set1_ps( SQRT2 ) );
+    m = _mm_mul_ps( m, _mm_or_ps( _mm_and_ps( over, half ), _mm_andnot_ps( over, one ) ) );
+    e = _mm_sub_epi32( e, _mm_castps_si128( over ) );
+
+    auto t  = _mm_div_ps( _mm_sub_ps( m, one ), _mm_add_ps( m, one ) );
+    auto t2 = _mm_mul_ps( t, t );
+    auto l  = _mm_add_ps( _mm_set1_ps( LOG2_C5 ), _mm_mul_ps( t2, _mm_set1_ps( LOG2_C7 ) ) );
+    l = _mm_add_ps( _mm_set1_ps( LOG2_C3 ), _mm_mul_ps( t2, l ) );
+    l = _mm_add_ps( _mm_set1_ps( LOG2_C1 ), _mm_mul_ps( t2, l ) );
+    l = _mm_add_ps( _mm_cvtepi32_ps( e ), _mm_mul_ps( t, l ) );
+
+    auto v = _mm_mul_ps( l, y );
+    v = _mm_min_ps( _mm_max_ps( v, _mm_set1_ps( -126.0f ) ), _mm_set1_ps( 129.0f ) );
+
+    auto i = _mm_cvtps_epi32( v );
+    auto f = _mm_sub_ps( v, _mm_cvtepi32_ps( i ) );
+    auto p = _mm_add_ps( _mm_set1_ps( EXP2_C5 ), _mm_mul_ps( f, _mm_set1_ps( EXP2_C6 ) ) );
+    p = _mm_add_ps( _mm_set1_ps( EXP2_C4 ), _mm_mul_ps( f, p ) );
+    p = _mm_add_ps( _mm_set1_ps( EXP2_C3 ), _mm_mul_ps( f, p ) );
+    p = _mm_add_ps( _mm_set1_ps( EXP2_C2 ), _mm_mul_ps( f, p ) );
+    p = _mm_add_ps( _mm_set1_ps( EXP2_C1 ), _mm_mul_ps( f, p ) );
+    p = _mm_add_ps( one, _mm_mul_ps( f, p ) );
+
+    auto s = _mm_castsi128_ps( _mm_slli_epi32( _mm_add_epi32( i, _mm_set1_epi32( 126 ) ), 23 ) );
+
+    return _mm_andnot_ps( zero, _mm_mul_ps( _mm_add_ps( p, p ), s ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      4sNZ݂܂.
+//-------------------------------------------------------------------------------------------------
+inline void StorePixels4( __m128 r, __m128 g, __m128 b, asdx::ResHDR::FloatFormat format, u8* pDst )
+{
+    // SoA  AoS ɕёւ. ]u r, g, b, a ꂼ1sNZɂȂ.
+    auto a = _mm_set1_ps( 1.0f );
+    _MM_TRANSPOSE4_PS( r, g, b, a );
+
+    auto pOut = reinterpret_cast<f32*>( pDst );
+    switch( format )
+    {
+    case asdx::ResHDR::FloatFormat_RGB32F:
+        {
+            // 4vfڂ͎̃sNZŏ㏑. Ō̃sNZ3vfŏ.
+            _mm_storeu_ps( pOut + 0, r );
+            _mm_storeu_ps( pOut + 3, g );
+            _mm_storeu_ps( pOut + 6, b );
+            _mm_storel_pi( reinterpret_cast<__m64*>( pOut + 9 ), a );
+            _mm_store_ss ( pOut + 11, _mm_movehl_ps( a, a ) );
+        }
+        break;
+
+    case asdx::ResHDR::FloatFormat_RGBA32F:
+        {
+            _mm_storeu_ps( pOut +  0, r );
+            _mm_storeu_ps( pOut +  4, g );
+            _mm_storeu_ps( pOut +  8, b );
+            _mm_storeu_ps( pOut + 12, a );
+        }
+        break;
+
+    case asdx::ResHDR::FloatFormat_RGBA16F:
+        {
+            f32 value[ 16 ];
+            _mm_storeu_ps( value +  0, r );
+            _mm_storeu_ps( value +  4, g );
+            _mm_storeu_ps( value +  8, b );
+            _mm_storeu_ps( value + 12, a );
+
+            auto pHalf = reinterpret_cast<f16*>( pDst );
+            for( auto i=0; i<16; ++i )
+            { pHalf[ i ] = ToF16( value[ i ] ); }
+        }
+        break;
+    }
+}
+#endif//ASDX_HDR_SIMD
+
+//-------------------------------------------------------------------------------------------------
+//      1sRGBE𕂓ɕϊ܂.
+//-------------------------------------------------------------------------------------------------
+void ConvertRow
+(
+    const RGBE*                 pSrc,
+    u32                         count,
+    const f32*                  pScale,
+    bool                        applyGamma,
+    f32                         deGamma,
+    asdx::ResHDR::FloatFormat   format,
+    u32                         pixelSize,
+    u8*                         pDst
+)
+{
+    u32 x = 0;
+
+#if ASDX_HDR_SIMD
+    const auto mask = _mm_set1_epi32( 0xFF );
+    const auto y    = _mm_set1_ps( deGamma );
+
+    for( ; x + 4 <= count; x += 4 )
+    {
+        // 1sNZ = 32bit Ȃ̂, 4sNZ܂Ƃ߂ēǂŐƂɎo.
+        auto v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc + x ) );
+        auto r = _mm_cvtepi32_ps( _mm_and_si128( v, mask ) );
+        auto g = _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( v,  8 ), mask ) );
+        auto b = _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( v, 16 ), mask ) );
+        auto s = _mm_setr_ps(
+            pScale[ pSrc[ x + 0 ].e ],
+            pScale[ pSrc[ x + 1 ].e ],
+            pScale[ pSrc[ x + 2 ].e ],
+            pScale[ pSrc[ x + 3 ].e ] );
+
+        r = _mm_mul_ps( r, s );
+        g = _mm_mul_ps( g, s );
+        b = _mm_mul_ps( b, s );
+
+        if ( applyGamma )
+        {
+            r = FastPow4( r, y );
+            g = FastPow4( g, y );
+            b = FastPow4( b, y );
+        }
+
+        StorePixels4( r, g, b, format, pDst + x * pixelSize );
+    }
+#endif//ASDX_HDR_SIMD
+
+    for( ; x < count; ++x )
+    {
+        auto s = pScale[ pSrc[ x ].e ];
+        auto r = pSrc[ x ].r * s;
+        auto g = pSrc[ x ].g * s;
+        auto b = pSrc[ x ].b * s;
+
+        if ( applyGamma )
+        {
+            r = FastPow( r, deGamma );
+            g = FastPow( g, deGamma );
+            b = FastPow( b, deGamma );
         }
+
+        StorePixel( r, g, b, format, pDst + x * pixelSize );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      sPʂŕs܂.
+//-------------------------------------------------------------------------------------------------
+//      func( begin, end )  [0, count) 𕪊͈͂ŌĂяo܂.
+//      1Xbh minCount ɂȂꍇ͕炵, 1ȉȂĂяoŎs܂.
+//-------------------------------------------------------------------------------------------------
+template<typename Func>
+void ParallelFor( u32 count, u32 minCount, Func func )
+{
+    if ( minCount == 0 )
+    { minCount = 1; }
+
+    auto threadCount = u32( std::thread::hardware_concurrency() );
+    auto maxCount    = ( count + minCount - 1 ) / minCount;
+    if ( threadCount > maxCount )
+    { threadCount = maxCount; }
+
+    if ( threadCount <= 1 )
+    {
+        func( 0, count );
+        return;
     }
 
-    return ( feof( pFile ) ? false : true );
+    auto chunk = ( count + threadCount - 1 ) / threadCount;
+
+    std::vector<std::thread> threads;
+    threads.reserve( threadCount - 1 );
+
+    for( u32 begin = chunk; begin < count; begin += chunk )
+    {
+        auto end = ( begin + chunk < count ) ? begin + chunk : count;
+        threads.emplace_back( func, begin, end );
+    }
+
+    // 擪͈̔͂͌ĂяoXbhŏ.
+    func( 0, ( chunk < count ) ? chunk : count );
+
+    for( auto& thread : threads )
+    { thread.join(); }
 }
 
 
@@ -235,16 +626,79 @@ bool ResHDR::Load( const char16* filename )
         return false;
     }
 
+    // t@CTCY擾.
+    fseek( pFile, 0, SEEK_END );
+    auto fileSize = ftell( pFile );
+    fseek( pFile, 0, SEEK_SET );
+
+    if ( fileSize <= 0 )
+    {
+        ELOG( "Error : Invalid File Size. filename = %s", filename );
+        fclose( pFile );
+        return false;
+    }
+
+    // XLCɃfR[ĥŁCt@CŜ΂Ɠǂݍ.
+    auto pBuffer = new (std::nothrow) u8 [ fileSize ];
+    if ( pBuffer == nullptr )
+    {
+        ELOG( "Error : Out of Memory." );
+        fclose( pFile );
+        return false;
+    }
+
+    auto readSize = fread( pBuffer, sizeof(u8), fileSize, pFile );
+
+    // t@C.
+    fclose( pFile );
+
+    if ( readSize != size_t( fileSize ) )
+    {
+        ELOG( "Error : File Read Failed. filename = %s", filename );
+        ASDX_DELETE_ARRAY( pBuffer );
+        return false;
+    }
+
+    auto ret = LoadFromMemory( pBuffer, u32( fileSize ) );
+
+    // svȃ.
+    ASDX_DELETE_ARRAY( pBuffer );
+
+    if ( !ret )
+    { return false; }
+
+    // nbVL[̓t@C쐬.
+    m_HashKey = CRC32( filename ).GetHash();
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ǂݍ݂܂.
+//-------------------------------------------------------------------------------------------------
+bool ResHDR::LoadFromMemory( const u8* pBuffer, const u32 bufferSize )
+{
+    if ( pBuffer == nullptr || bufferSize == 0 )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    // ̃f[^͔jĂ.
+    Release();
+
+    const u8* pSrc = pBuffer;
+    const u8* pEnd = pBuffer + bufferSize;
+
     const u32 BUFFER_SIZE = 256;
     char buf[ BUFFER_SIZE ];
-    fgets( buf, BUFFER_SIZE, pFile );
+    ReadLine( pSrc, pEnd, buf, BUFFER_SIZE );
     RemoveEndline( buf );
 
     // }WbN`FbN.
     if ( strcmp( buf, "#?RADIANCE") != 0 )
     {
         ELOG( "Error : Invalid File." );
-        fclose( pFile );
         return false;
     }
 
@@ -252,21 +706,13 @@ bool ResHDR::Load( const char16* filename )
 
     while( 1 )
     {
-        if ( feof( pFile ) )
+        if ( !ReadLine( pSrc, pEnd, buf, BUFFER_SIZE ) )
         {
-             fclose( pFile );
              ELOG( "Error : End Of File.");
              Release();
              return false;
         }
 
-        if ( fgets( buf, BUFFER_SIZE, pFile ) == nullptr )
-        {
-            fclose( pFile );
-            Release();
-            return false;
-        }
-
         // CRLF폜.
         RemoveEndline( buf );
 
@@ -282,8 +728,8 @@ bool ResHDR::Load( const char16* filename )
             if ( strcmp( format, "32-bit_rle_rgbe" ) != 0
               && strcmp( format, "32-bit_rle_xyze" ) != 0 )
             {
-                fclose( pFile );
                 ELOG( "Error : Invalid Format." );
+                Release();
                 return false;
             }
         }
@@ -390,12 +836,16 @@ bool ResHDR::Load( const char16* filename )
          scanlineType != SCANLINE_PY_PX )
     {
         ELOG( "Error : Unsupported Scanline Format" );
-        fclose( pFile );
+        Release();
         return false;
     }
 
-    // Ă.
-    ASDX_DELETE_ARRAY( m_pPixels );
+    if ( m_Width == 0 || m_Height == 0 )
+    {
+        ELOG( "Error : Invalid Image Size." );
+        Release();
+        return false;
+    }
 
     // m.
     m_pPixels = new (std::nothrow) RGBE [ m_Width * m_Height ];
@@ -403,41 +853,69 @@ bool ResHDR::Load( const char16* filename )
     if ( m_pPixels == nullptr )
     {
         ELOG( "Error : Out of Memory.");
-        fclose( pFile );
         Release();
         return false;
     }
 
-    if ( scanlineType == SCANLINE_NY_PX )
+    auto ppScanlines = new (std::nothrow) const u8* [ m_Height ];
+    if ( ppScanlines == nullptr )
     {
-        // Direct3D̃eNX`Wnɍ킹̂ŁCY͋tǂݍ.
-        for( int y = (s32)m_Height - 1; y >= 0; y-- )
+        ELOG( "Error : Out of Memory.");
+        Release();
+        return false;
+    }
+
+    // Direct3D̃eNX`Wnɍ킹̂ŁC-Y ̏ꍇY͋ti[.
+    auto width   = s32( m_Width );
+    auto height  = m_Height;
+    auto pPixels = m_pPixels;
+    auto flip    = ( scanlineType == SCANLINE_NY_PX );
+    auto getLine = [=]( u32 index )
+    { return pPixels + size_t( flip ? height - 1 - index : index ) * width; };
+
+    // 1pX : V`̃XLC͓ǂݔ΂Đ擪ʒuL^.
+    u32 indexed = 0;
+    for( ; indexed < height; ++indexed )
+    {
+        if ( !IsNewScanline( pSrc, pEnd, width ) )
+        { break; }
+
+        ppScanlines[ indexed ] = pSrc;
+        if ( !DecodeNewScanline( pSrc, pEnd, nullptr, width ) )
         {
-            if ( !ReadColor( pFile, &m_pPixels[y * m_Width], m_Width ) )
-            {
-                fclose( pFile );
-                Release();
-                return false;
-            }
+            ELOG( "Error : Invalid Scanline. index = %u", indexed );
+            ASDX_DELETE_ARRAY( ppScanlines );
+            Release();
+            return false;
         }
     }
-    else if ( scanlineType == SCANLINE_PY_PX )
+
+    // 2pX : L^ʒuɃfR[h. 1pXڂŌ؍ς݂Ȃ̂ŎsȂ.
+    auto minRows = PARALLEL_MIN_PIXELS / m_Width;
+    ParallelFor( indexed, minRows, [=]( u32 begin, u32 end )
     {
-        // Direct3D̃eNX`Wnɍ킹̂ŁCY͋tǂݍ.
-        for( int y = 0; y < (s32)m_Height; y++ )
+        for( auto i=begin; i<end; ++i )
         {
-            if ( !ReadColor( pFile, &m_pPixels[y * m_Width], m_Width ) )
-            {
-                fclose( pFile );
-                Release();
-                return false;
-            }
+            auto pScanline = ppScanlines[ i ];
+            DecodeNewScanline( pScanline, pEnd, getLine( i ), width );
         }
-    }
+    });
 
-    m_HashKey = CRC32( filename ).GetHash();
+    ASDX_DELETE_ARRAY( ppScanlines );
 
-    fclose( pFile );
+    // `RLE͒ÕsNZQƂ̂ŁCc͒fR[h.
+    for( auto i = indexed; i < height; ++i )
+    {
+        const RGBE* pPrev = ( i > 0 ) ? getLine( i - 1 ) + width - 1 : nullptr;
+        if ( !ReadColor( pSrc, pEnd, getLine( i ), width, pPrev ) )
+        {
+            ELOG( "Error : Invalid Scanline. index = %u", i );
+            Release();
+            return false;
+        }
+    }
+
+    m_HashKey = CRC32( bufferSize, pBuffer ).GetHash();
 
     return true;
 }
@@ -506,29 +984,79 @@ void ResHDR::GetFloatPixels( f32** ppPixels ) const
         return;
     }
 
-    f32 deGamma = 1.0f / m_Gamma;
+    if ( !GetFloatPixels( pPixels, 0, FloatFormat_RGB32F ) )
+    {
+        delete [] pPixels;
+        return;
+    }
 
-    for( u32 i=0; i<m_Width*m_Height; ++i )
+    (*ppPixels) = pPixels;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      fR[hsNZwobt@ɏ݂܂.
+//-------------------------------------------------------------------------------------------------
+bool ResHDR::GetFloatPixels( void* pResults, u32 rowPitch, FloatFormat format, bool applyGamma ) const
+{
+    auto pixelSize = GetFloatPixelSize( format );
+    if ( pResults == nullptr || pixelSize == 0 )
     {
-        if ( m_pPixels[ i ].e )
-        {
-            // ldexpf( x, exp ) = x * (2 ^ exp).
-            auto val = ldexpf( 1.0f, m_pPixels[ i ].e - s32(128+8) );
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
 
-            // K}␳Ȃi[.
-            pPixels[ i * count + 0 ] = powf( m_pPixels[ i ].r * val, deGamma );
-            pPixels[ i * count + 1 ] = powf( m_pPixels[ i ].g * val, deGamma );
-            pPixels[ i * count + 2 ] = powf( m_pPixels[ i ].b * val, deGamma );
-        }
-        else
+    if ( rowPitch == 0 )
+    { rowPitch = m_Width * pixelSize; }
+
+    if ( rowPitch < m_Width * pixelSize )
+    {
+        ELOG( "Error : Invalid Row Pitch. rowPitch = %u", rowPitch );
+        return false;
+    }
+
+    // K}l1Ȃpow͍PϊȂ̂ŏȗ.
+    applyGamma = applyGamma && ( m_Gamma != 1.0f );
+
+    auto pScale  = GetExponentTable();
+    auto deGamma = 1.0f / m_Gamma;
+    auto pDst    = static_cast<u8*>( pResults );
+    auto width   = m_Width;
+    auto pPixels = m_pPixels;
+
+    auto minRows = ( width > 0 ) ? PARALLEL_MIN_PIXELS / width : 0;
+
+    ParallelFor( m_Height, minRows, [=]( u32 begin, u32 end )
+    {
+        for( auto y=begin; y<end; ++y )
         {
-            pPixels[ i * count + 0 ] = 0.0f;
-            pPixels[ i * count + 1 ] = 0.0f;
-            pPixels[ i * count + 2 ] = 0.0f;
+            ConvertRow(
+                pPixels + y * width,
+                width,
+                pScale,
+                applyGamma,
+                deGamma,
+                format,
+                pixelSize,
+                pDst + size_t( y ) * rowPitch );
         }
+    });
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ݌`1sNZ̃oCg擾܂.
+//-------------------------------------------------------------------------------------------------
+u32 ResHDR::GetFloatPixelSize( FloatFormat format )
+{
+    switch( format )
+    {
+    case FloatFormat_RGB32F:  { return sizeof(f32) * 3; }
+    case FloatFormat_RGBA32F: { return sizeof(f32) * 4; }
+    case FloatFormat_RGBA16F: { return sizeof(f16) * 4; }
     }
 
-    (*ppPixels) = pPixels;
+    return 0;
 }
 
 //-------------------------------------------------------------------------------------------------
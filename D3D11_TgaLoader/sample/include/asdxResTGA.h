@@ -148,6 +148,16 @@ public:
     //----------------------------------------------------------------------------------------------
     bool Load( const char16* filename ) override;
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      メモリから読み込みします.
+    //!
+    //! @param[in]      pBuffer         TGAファイルのバイナリです.
+    //! @param[in]      bufferSize      バッファサイズです.
+    //! @retval true    読み込み成功.
+    //! @retval false   読み込み失敗.
+    //----------------------------------------------------------------------------------------------
+    bool LoadFromMemory( const u8* pBuffer, const u32 bufferSize );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      メモリを解放します.
     //----------------------------------------------------------------------------------------------
@@ -0,0 +1,833 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asdxPixelKernel.cpp
+// Desc : Pixel Kernel Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asdxPixelKernel.h>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define ASDX_KERNEL_X86     (1)
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#else
+    #define ASDX_KERNEL_X86     (0)
+#endif
+
+// MSVCは命令セットの指定なしでイントリンジックを使用できるが，GCC/Clangは関数単位で指定が必要.
+#if defined(__GNUC__) || defined(__clang__)
+    #define ASDX_TARGET_SSE2    __attribute__((target("sse2")))
+    #define ASDX_TARGET_AVX2    __attribute__((target("avx2")))
+#else
+    #define ASDX_TARGET_SSE2
+    #define ASDX_TARGET_AVX2
+#endif
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+//      CPUIDからSIMDレベルを判定します.
+//-------------------------------------------------------------------------------------------------
+asdx::SIMD_LEVEL DetectSimdLevel()
+{
+#if ASDX_KERNEL_X86
+    int info[4] = {};
+    #if defined(_MSC_VER)
+        __cpuid(info, 0);
+    #else
+        __cpuid(0, info[0], info[1], info[2], info[3]);
+    #endif
+    auto maxId = info[0];
+
+    #if defined(_MSC_VER)
+        __cpuid(info, 1);
+    #else
+        __cpuid(1, info[0], info[1], info[2], info[3]);
+    #endif
+
+    auto hasSSE2    = (info[3] & (1 << 26)) != 0;
+    auto hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+    auto hasAVX     = (info[2] & (1 << 28)) != 0;
+
+    if (!hasSSE2)
+    { return asdx::SIMD_LEVEL_SCALAR; }
+
+    // OSがYMMレジスタを保存するかチェック.
+    if (!hasOSXSAVE || !hasAVX || maxId < 7)
+    { return asdx::SIMD_LEVEL_SSE2; }
+
+    #if defined(_MSC_VER)
+        auto xcr0 = _xgetbv(0);
+    #else
+        uint32_t lo, hi;
+        __asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        auto xcr0 = (uint64_t(hi) << 32) | lo;
+    #endif
+    if ((xcr0 & 0x6) != 0x6)
+    { return asdx::SIMD_LEVEL_SSE2; }
+
+    #if defined(_MSC_VER)
+        __cpuidex(info, 7, 0);
+    #else
+        __cpuid_count(7, 0, info[0], info[1], info[2], info[3]);
+    #endif
+
+    return ((info[1] & (1 << 5)) != 0) ? asdx::SIMD_LEVEL_AVX2 : asdx::SIMD_LEVEL_SSE2;
+#else
+    return asdx::SIMD_LEVEL_SCALAR;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+// Global Variables.
+//-------------------------------------------------------------------------------------------------
+static const asdx::SIMD_LEVEL g_SupportedLevel = DetectSimdLevel();
+static asdx::SIMD_LEVEL       g_SimdLevel      = g_SupportedLevel;
+
+
+//-------------------------------------------------------------------------------------------------
+//      同じピクセル値で埋めます(スカラー版).
+//-------------------------------------------------------------------------------------------------
+void FillPixelsScalar(uint8_t* pDst, const uint8_t* pValue, uint32_t bytePerPixel, uint32_t count)
+{
+    if (count == 0)
+    { return; }
+
+    switch(bytePerPixel)
+    {
+    case 1:
+        { memset(pDst, pValue[0], count); }
+        break;
+
+    case 3:
+        {
+            for(uint32_t i=0; i<count; ++i, pDst+=3)
+            {
+                pDst[0] = pValue[0];
+                pDst[1] = pValue[1];
+                pDst[2] = pValue[2];
+            }
+        }
+        break;
+
+    case 4:
+        {
+            for(uint32_t i=0; i<count; ++i, pDst+=4)
+            { memcpy(pDst, pValue, 4); }
+        }
+        break;
+
+    default:
+        {
+            // 書き込み済みの領域を倍々にコピーしていく.
+            auto total  = size_t(bytePerPixel) * count;
+            auto filled = size_t(bytePerPixel);
+            memcpy(pDst, pValue, bytePerPixel);
+            while(filled < total)
+            {
+                auto size = (filled < total - filled) ? filled : total - filled;
+                memcpy(pDst + filled, pDst, size);
+                filled += size;
+            }
+        }
+        break;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGR形式をRGB形式に変換します(スカラー版).
+//-------------------------------------------------------------------------------------------------
+void SwizzleBGRToRGBScalar(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+    for(uint32_t i=0; i<count; ++i, pSrc+=3, pDst+=3)
+    {
+        pDst[0] = pSrc[2];
+        pDst[1] = pSrc[1];
+        pDst[2] = pSrc[0];
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGR形式をRGBA形式に変換します(スカラー版).
+//-------------------------------------------------------------------------------------------------
+void SwizzleBGRToRGBAScalar(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+    for(uint32_t i=0; i<count; ++i, pSrc+=3, pDst+=4)
+    {
+        pDst[0] = pSrc[2];
+        pDst[1] = pSrc[1];
+        pDst[2] = pSrc[0];
+        pDst[3] = 255;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGRA形式をRGBA形式に変換します(スカラー版).
+//-------------------------------------------------------------------------------------------------
+void SwizzleBGRAToRGBAScalar(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+    for(uint32_t i=0; i<count; ++i, pSrc+=4, pDst+=4)
+    {
+        auto b = pSrc[0];
+        auto g = pSrc[1];
+        auto r = pSrc[2];
+        auto a = pSrc[3];
+        pDst[0] = r;
+        pDst[1] = g;
+        pDst[2] = b;
+        pDst[3] = a;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8bitインデックスをRGBA形式に展開します(スカラー版).
+//-------------------------------------------------------------------------------------------------
+void ExpandPaletteRGBAScalar(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, uint32_t count)
+{
+    for(uint32_t i=0; i<count; ++i, pDst+=4)
+    { memcpy(pDst, &pPalette[pIndices[i]], 4); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8bitインデックスをRGB形式に展開します(スカラー版).
+//-------------------------------------------------------------------------------------------------
+void ExpandPaletteRGBScalar(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, uint32_t count)
+{
+    for(uint32_t i=0; i<count; ++i, pDst+=3)
+    { memcpy(pDst, &pPalette[pIndices[i]], 3); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1bitインデックスを展開します(スカラー版).
+//-------------------------------------------------------------------------------------------------
+void UnpackBits1Scalar(const uint8_t* pSrc, uint8_t* pIndices, uint32_t count)
+{
+    for(uint32_t i=0; i<count; ++pSrc)
+    {
+        auto value = *pSrc;
+        for(uint32_t j=0; j<8 && i<count; ++j, ++i)
+        { pIndices[i] = (value >> (7 - j)) & 0x1; }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      4bitインデックスを展開します(スカラー版).
+//-------------------------------------------------------------------------------------------------
+void UnpackBits4Scalar(const uint8_t* pSrc, uint8_t* pIndices, uint32_t count)
+{
+    uint32_t i = 0;
+    for(; i + 2 <= count; i += 2, ++pSrc)
+    {
+        pIndices[i + 0] = *pSrc >> 4;
+        pIndices[i + 1] = *pSrc & 0x0f;
+    }
+
+    if (i < count)
+    { pIndices[i] = *pSrc >> 4; }
+}
+
+#if ASDX_KERNEL_X86
+//-------------------------------------------------------------------------------------------------
+//      3byteピクセルを繰り返した16byteパターンを作成します.
+//-------------------------------------------------------------------------------------------------
+inline void MakePattern3(const uint8_t* pValue, uint8_t* pPattern, uint32_t size)
+{
+    for(uint32_t i=0; i<size; ++i)
+    { pPattern[i] = pValue[i % 3]; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      同じピクセル値で埋めます(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+void FillPixelsSSE2(uint8_t* pDst, const uint8_t* pValue, uint32_t bytePerPixel, uint32_t count)
+{
+    auto total = size_t(bytePerPixel) * count;
+    if (total < 16)
+    {
+        FillPixelsScalar(pDst, pValue, bytePerPixel, count);
+        return;
+    }
+
+    __m128i v;
+    size_t  step;
+    switch(bytePerPixel)
+    {
+    case 1:
+        { v = _mm_set1_epi8(char(pValue[0])); step = 16; }
+        break;
+
+    case 2:
+        {
+            uint16_t value;
+            memcpy(&value, pValue, sizeof(value));
+            v = _mm_set1_epi16(short(value));
+            step = 16;
+        }
+        break;
+
+    case 3:
+        {
+            // 5ピクセル+1byteのパターンを15byteずつずらして書き込む.
+            uint8_t pattern[16];
+            MakePattern3(pValue, pattern, 16);
+            v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+            step = 15;
+        }
+        break;
+
+    case 4:
+        {
+            uint32_t value;
+            memcpy(&value, pValue, sizeof(value));
+            v = _mm_set1_epi32(int(value));
+            step = 16;
+        }
+        break;
+
+    default:
+        {
+            FillPixelsScalar(pDst, pValue, bytePerPixel, count);
+            return;
+        }
+    }
+
+    size_t offset = 0;
+    for(; offset + 16 <= total; offset += step)
+    { _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + offset), v); }
+
+    // 書き込み位置は常にピクセル境界なので，残りはスカラー版で埋める.
+    if (offset < total)
+    {
+        auto pixels = offset / bytePerPixel;
+        FillPixelsScalar(pDst + offset, pValue, bytePerPixel, uint32_t(count - pixels));
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGR形式をRGB形式に変換します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+void SwizzleBGRToRGBSSE2(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+    const __m128i mask0 = _mm_setr_epi8(-1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, 0);
+    const __m128i mask1 = _mm_slli_si128(mask0, 1);
+    const __m128i mask2 = _mm_slli_si128(mask0, 2);
+
+    // 16byte読み込んで5ピクセル分を変換する.
+    uint32_t i = 0;
+    for(; i + 6 <= count; i += 5, pSrc += 15, pDst += 15)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+        auto r = _mm_and_si128(_mm_srli_si128(v, 2), mask0);
+        auto g = _mm_and_si128(v, mask1);
+        auto b = _mm_and_si128(_mm_slli_si128(v, 2), mask2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst), _mm_or_si128(_mm_or_si128(r, g), b));
+    }
+
+    SwizzleBGRToRGBScalar(pSrc, pDst, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGR形式をRGBA形式に変換します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+void SwizzleBGRToRGBASSE2(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+    const __m128i maskRB = _mm_set1_epi32(0x000000FF);
+    const __m128i maskG  = _mm_set1_epi32(0x0000FF00);
+    const __m128i alpha  = _mm_set1_epi32(int(0xFF000000));
+
+    uint32_t i = 0;
+    for(; i + 5 <= count; i += 4, pSrc += 12, pDst += 16)
+    {
+        int p[4];
+        memcpy(&p[0], pSrc + 0, 4);
+        memcpy(&p[1], pSrc + 3, 4);
+        memcpy(&p[2], pSrc + 6, 4);
+        memcpy(&p[3], pSrc + 9, 4);
+
+        auto v = _mm_setr_epi32(p[0], p[1], p[2], p[3]);
+        auto r = _mm_and_si128(_mm_srli_epi32(v, 16), maskRB);
+        auto g = _mm_and_si128(v, maskG);
+        auto b = _mm_slli_epi32(_mm_and_si128(v, maskRB), 16);
+        auto c = _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, alpha));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst), c);
+    }
+
+    SwizzleBGRToRGBAScalar(pSrc, pDst, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGRA形式をRGBA形式に変換します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+void SwizzleBGRAToRGBASSE2(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+    const __m128i maskRB = _mm_set1_epi32(0x000000FF);
+    const __m128i maskGA = _mm_set1_epi32(int(0xFF00FF00));
+
+    uint32_t i = 0;
+    for(; i + 4 <= count; i += 4, pSrc += 16, pDst += 16)
+    {
+        auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+        auto r  = _mm_and_si128(_mm_srli_epi32(v, 16), maskRB);
+        auto b  = _mm_slli_epi32(_mm_and_si128(v, maskRB), 16);
+        auto ga = _mm_and_si128(v, maskGA);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst), _mm_or_si128(_mm_or_si128(r, b), ga));
+    }
+
+    SwizzleBGRAToRGBAScalar(pSrc, pDst, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1bitインデックスを展開します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+void UnpackBits1SSE2(const uint8_t* pSrc, uint8_t* pIndices, uint32_t count)
+{
+    const __m128i bits = _mm_setr_epi8(
+        char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m128i one = _mm_set1_epi8(1);
+
+    // 各バイトを8回並べてからビットを取り出す. 16byteから128ピクセル分を展開する.
+    uint32_t i = 0;
+    for(; i + 128 <= count; i += 128, pSrc += 16, pIndices += 128)
+    {
+        auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+        __m128i half[2] = { _mm_unpacklo_epi8(v, v), _mm_unpackhi_epi8(v, v) };
+
+        for(auto j=0; j<2; ++j)
+        {
+            auto lo = _mm_unpacklo_epi16(half[j], half[j]);
+            auto hi = _mm_unpackhi_epi16(half[j], half[j]);
+            __m128i x[4] = {
+                _mm_unpacklo_epi32(lo, lo), _mm_unpackhi_epi32(lo, lo),
+                _mm_unpacklo_epi32(hi, hi), _mm_unpackhi_epi32(hi, hi)
+            };
+
+            for(auto k=0; k<4; ++k)
+            {
+                auto r = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(x[k], bits), bits), one);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pIndices + j * 64 + k * 16), r);
+            }
+        }
+    }
+
+    UnpackBits1Scalar(pSrc, pIndices, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      4bitインデックスを展開します(SSE2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_SSE2
+void UnpackBits4SSE2(const uint8_t* pSrc, uint8_t* pIndices, uint32_t count)
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+
+    // 上位4bitと下位4bitを交互に並べる.
+    uint32_t i = 0;
+    for(; i + 32 <= count; i += 32, pSrc += 16, pIndices += 32)
+    {
+        auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+        auto hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        auto lo = _mm_and_si128(v, mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pIndices),      _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pIndices + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+
+    UnpackBits4Scalar(pSrc, pIndices, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      同じピクセル値で埋めます(AVX2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_AVX2
+void FillPixelsAVX2(uint8_t* pDst, const uint8_t* pValue, uint32_t bytePerPixel, uint32_t count)
+{
+    auto total = size_t(bytePerPixel) * count;
+    if (total < 32)
+    {
+        FillPixelsSSE2(pDst, pValue, bytePerPixel, count);
+        return;
+    }
+
+    __m256i v;
+    size_t  step;
+    switch(bytePerPixel)
+    {
+    case 1:
+        { v = _mm256_set1_epi8(char(pValue[0])); step = 32; }
+        break;
+
+    case 2:
+        {
+            uint16_t value;
+            memcpy(&value, pValue, sizeof(value));
+            v = _mm256_set1_epi16(short(value));
+            step = 32;
+        }
+        break;
+
+    case 3:
+        {
+            // 10ピクセル+2byteのパターンを30byteずつずらして書き込む.
+            uint8_t pattern[32];
+            MakePattern3(pValue, pattern, 32);
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern));
+            step = 30;
+        }
+        break;
+
+    case 4:
+        {
+            uint32_t value;
+            memcpy(&value, pValue, sizeof(value));
+            v = _mm256_set1_epi32(int(value));
+            step = 32;
+        }
+        break;
+
+    default:
+        {
+            FillPixelsScalar(pDst, pValue, bytePerPixel, count);
+            return;
+        }
+    }
+
+    size_t offset = 0;
+    for(; offset + 32 <= total; offset += step)
+    { _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + offset), v); }
+
+    if (offset < total)
+    {
+        auto pixels = offset / bytePerPixel;
+        FillPixelsSSE2(pDst + offset, pValue, bytePerPixel, uint32_t(count - pixels));
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGR形式をRGB形式に変換します(AVX2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_AVX2
+void SwizzleBGRToRGBAVX2(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15,
+        2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+
+    // 各レーンで5ピクセルずつ変換する.
+    uint32_t i = 0;
+    for(; i + 11 <= count; i += 10, pSrc += 30, pDst += 30)
+    {
+        auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+        auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 15));
+        auto v  = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst),      _mm256_castsi256_si128(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + 15), _mm256_extracti128_si256(v, 1));
+    }
+
+    SwizzleBGRToRGBSSE2(pSrc, pDst, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGR形式をRGBA形式に変換します(AVX2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_AVX2
+void SwizzleBGRToRGBAAVX2(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+        2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m256i alpha = _mm256_set1_epi32(int(0xFF000000));
+
+    // 各レーンで4ピクセルずつ変換する.
+    uint32_t i = 0;
+    for(; i + 10 <= count; i += 8, pSrc += 24, pDst += 32)
+    {
+        auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+        auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 12));
+        auto v  = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), alpha);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst), v);
+    }
+
+    SwizzleBGRToRGBASSE2(pSrc, pDst, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGRA形式をRGBA形式に変換します(AVX2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_AVX2
+void SwizzleBGRAToRGBAAVX2(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    uint32_t i = 0;
+    for(; i + 8 <= count; i += 8, pSrc += 32, pDst += 32)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst), _mm256_shuffle_epi8(v, shuffle));
+    }
+
+    SwizzleBGRAToRGBASSE2(pSrc, pDst, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8bitインデックスをRGBA形式に展開します(AVX2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_AVX2
+void ExpandPaletteRGBAAVX2(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, uint32_t count)
+{
+    auto pTable = reinterpret_cast<const int*>(pPalette);
+
+    uint32_t i = 0;
+    for(; i + 8 <= count; i += 8, pDst += 32)
+    {
+        auto idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pIndices + i)));
+        auto v   = _mm256_i32gather_epi32(pTable, idx, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst), v);
+    }
+
+    ExpandPaletteRGBAScalar(pIndices + i, pPalette, pDst, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8bitインデックスをRGB形式に展開します(AVX2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_AVX2
+void ExpandPaletteRGBAVX2(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, uint32_t count)
+{
+    auto pTable = reinterpret_cast<const int*>(pPalette);
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    // 各レーンの12byteを詰めて書き込む. 後ろのレーンで前のレーンの余り4byteを上書きする.
+    uint32_t i = 0;
+    for(; i + 10 <= count; i += 8, pDst += 24)
+    {
+        auto idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pIndices + i)));
+        auto v   = _mm256_shuffle_epi8(_mm256_i32gather_epi32(pTable, idx, 4), shuffle);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst),      _mm256_castsi256_si128(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + 12), _mm256_extracti128_si256(v, 1));
+    }
+
+    ExpandPaletteRGBScalar(pIndices + i, pPalette, pDst, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1bitインデックスを展開します(AVX2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_AVX2
+void UnpackBits1AVX2(const uint8_t* pSrc, uint8_t* pIndices, uint32_t count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+        2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i bits = _mm256_setr_epi8(
+        char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m256i one = _mm256_set1_epi8(1);
+
+    // 4byteを各レーンに配り，シャッフルで各バイトを8回並べてからビットを取り出す.
+    uint32_t i = 0;
+    for(; i + 32 <= count; i += 32, pSrc += 4, pIndices += 32)
+    {
+        int value;
+        memcpy(&value, pSrc, sizeof(value));
+
+        auto v = _mm256_shuffle_epi8(_mm256_set1_epi32(value), shuffle);
+        auto r = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(v, bits), bits), one);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pIndices), r);
+    }
+
+    UnpackBits1SSE2(pSrc, pIndices, count - i);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      4bitインデックスを展開します(AVX2版).
+//-------------------------------------------------------------------------------------------------
+ASDX_TARGET_AVX2
+void UnpackBits4AVX2(const uint8_t* pSrc, uint8_t* pIndices, uint32_t count)
+{
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+
+    // アンパックはレーン単位なので，最後にレーンを入れ替えて並びを戻す.
+    uint32_t i = 0;
+    for(; i + 64 <= count; i += 64, pSrc += 32, pIndices += 64)
+    {
+        auto v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc));
+        auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), mask);
+        auto lo = _mm256_and_si256(v, mask);
+        auto a  = _mm256_unpacklo_epi8(hi, lo);
+        auto b  = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pIndices),      _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pIndices + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+
+    UnpackBits4SSE2(pSrc, pIndices, count - i);
+}
+#endif//ASDX_KERNEL_X86
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//      ピクセルカーネルで使用するSIMDレベルを取得します.
+//-------------------------------------------------------------------------------------------------
+SIMD_LEVEL GetSimdLevel()
+{ return g_SimdLevel; }
+
+//-------------------------------------------------------------------------------------------------
+//      ピクセルカーネルで使用するSIMDレベルを設定します.
+//-------------------------------------------------------------------------------------------------
+void SetSimdLevel(SIMD_LEVEL level)
+{ g_SimdLevel = (level < g_SupportedLevel) ? level : g_SupportedLevel; }
+
+//-------------------------------------------------------------------------------------------------
+//      同じピクセル値で埋めます.
+//-------------------------------------------------------------------------------------------------
+void FillPixels(uint8_t* pDst, const uint8_t* pValue, uint32_t bytePerPixel, uint32_t count)
+{
+#if ASDX_KERNEL_X86
+    switch(g_SimdLevel)
+    {
+    case SIMD_LEVEL_AVX2: { FillPixelsAVX2(pDst, pValue, bytePerPixel, count); } return;
+    case SIMD_LEVEL_SSE2: { FillPixelsSSE2(pDst, pValue, bytePerPixel, count); } return;
+    default: break;
+    }
+#endif
+    FillPixelsScalar(pDst, pValue, bytePerPixel, count);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGR形式をRGB形式に変換します.
+//-------------------------------------------------------------------------------------------------
+void SwizzleBGRToRGB(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+#if ASDX_KERNEL_X86
+    switch(g_SimdLevel)
+    {
+    case SIMD_LEVEL_AVX2: { SwizzleBGRToRGBAVX2(pSrc, pDst, count); } return;
+    case SIMD_LEVEL_SSE2: { SwizzleBGRToRGBSSE2(pSrc, pDst, count); } return;
+    default: break;
+    }
+#endif
+    SwizzleBGRToRGBScalar(pSrc, pDst, count);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGR形式をRGBA形式に変換します.
+//-------------------------------------------------------------------------------------------------
+void SwizzleBGRToRGBA(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+#if ASDX_KERNEL_X86
+    switch(g_SimdLevel)
+    {
+    case SIMD_LEVEL_AVX2: { SwizzleBGRToRGBAAVX2(pSrc, pDst, count); } return;
+    case SIMD_LEVEL_SSE2: { SwizzleBGRToRGBASSE2(pSrc, pDst, count); } return;
+    default: break;
+    }
+#endif
+    SwizzleBGRToRGBAScalar(pSrc, pDst, count);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BGRA形式をRGBA形式に変換します.
+//-------------------------------------------------------------------------------------------------
+void SwizzleBGRAToRGBA(const uint8_t* pSrc, uint8_t* pDst, uint32_t count)
+{
+#if ASDX_KERNEL_X86
+    switch(g_SimdLevel)
+    {
+    case SIMD_LEVEL_AVX2: { SwizzleBGRAToRGBAAVX2(pSrc, pDst, count); } return;
+    case SIMD_LEVEL_SSE2: { SwizzleBGRAToRGBASSE2(pSrc, pDst, count); } return;
+    default: break;
+    }
+#endif
+    SwizzleBGRAToRGBAScalar(pSrc, pDst, count);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8bitインデックスをカラーマップでRGBA形式に展開します.
+//-------------------------------------------------------------------------------------------------
+void ExpandPaletteRGBA(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, uint32_t count)
+{
+    // SSE2にはギャザー命令が無いのでスカラー版で処理する.
+#if ASDX_KERNEL_X86
+    if (g_SimdLevel == SIMD_LEVEL_AVX2)
+    {
+        ExpandPaletteRGBAAVX2(pIndices, pPalette, pDst, count);
+        return;
+    }
+#endif
+    ExpandPaletteRGBAScalar(pIndices, pPalette, pDst, count);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8bitインデックスをカラーマップでRGB形式に展開します.
+//-------------------------------------------------------------------------------------------------
+void ExpandPaletteRGB(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, uint32_t count)
+{
+    // SSE2にはギャザー命令が無いのでスカラー版で処理する.
+#if ASDX_KERNEL_X86
+    if (g_SimdLevel == SIMD_LEVEL_AVX2)
+    {
+        ExpandPaletteRGBAVX2(pIndices, pPalette, pDst, count);
+        return;
+    }
+#endif
+    ExpandPaletteRGBScalar(pIndices, pPalette, pDst, count);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1bit/pixelのインデックスを8bitインデックスに展開します.
+//-------------------------------------------------------------------------------------------------
+void UnpackBits1(const uint8_t* pSrc, uint8_t* pIndices, uint32_t count)
+{
+#if ASDX_KERNEL_X86
+    switch(g_SimdLevel)
+    {
+    case SIMD_LEVEL_AVX2: { UnpackBits1AVX2(pSrc, pIndices, count); } return;
+    case SIMD_LEVEL_SSE2: { UnpackBits1SSE2(pSrc, pIndices, count); } return;
+    default: break;
+    }
+#endif
+    UnpackBits1Scalar(pSrc, pIndices, count);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      4bit/pixelのインデックスを8bitインデックスに展開します.
+//-------------------------------------------------------------------------------------------------
+void UnpackBits4(const uint8_t* pSrc, uint8_t* pIndices, uint32_t count)
+{
+#if ASDX_KERNEL_X86
+    switch(g_SimdLevel)
+    {
+    case SIMD_LEVEL_AVX2: { UnpackBits4AVX2(pSrc, pIndices, count); } return;
+    case SIMD_LEVEL_SSE2: { UnpackBits4SSE2(pSrc, pIndices, count); } return;
+    default: break;
+    }
+#endif
+    UnpackBits4Scalar(pSrc, pIndices, count);
+}
+
+} // namespace asdx
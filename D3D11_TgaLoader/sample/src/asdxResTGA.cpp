@@ -10,7 +10,9 @@
 #include <asdxResTGA.h>
 #include <asdxLogger.h>
 #include <asdxHash.h>
+#include <asdxPixelKernel.h>
 #include <cstdio>
+#include <cstring>
 #include <cassert>
 #include <new>
 
@@ -18,316 +20,180 @@
 namespace /* anonymous */ {
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      8Bitインデックスカラー形式を解析します.
-//!
-//! @param[in]      pColorMap       カラーマップです.
+// Constant Values.
 //-------------------------------------------------------------------------------------------------
-void Parse8Bits( FILE* pFile, u32 size, u8* pColorMap, u8* pPixels )
-{
-    u8 color = 0;
-    for( u32 i=0; i<size; ++i )
-    {
-        color = (u8)fgetc( pFile );
-        pPixels[ i * 3 + 2 ] = pColorMap[ color * 3 + 0 ];
-        pPixels[ i * 3 + 1 ] = pColorMap[ color * 3 + 1 ];
-        pPixels[ i * 3 + 0 ] = pColorMap[ color * 3 + 2 ];
-    }
-}
+static const u32 TGA_MAX_COLORMAP_ENTRY = 256;     //!< カラーマップの最大エントリー数です.
+
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      16Bitフルカラー形式を解析します.
+//! @brief      ピクセル変換関数です.
+//!
+//! @param[in]      pSrc        変換元ピクセルです.
+//! @param[in]      pColorMap   RGB形式に展開済みのカラーマップです.
+//! @param[out]     pDst        変換先ピクセルです.
+//! @param[in]      count       ピクセル数です.
 //-------------------------------------------------------------------------------------------------
-void Parse16Bits( FILE* pFile, u32 size, u8* pPixels )
-{
-    for( u32 i=0; i<size; ++i )
-    {
-        u16 color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
-        pPixels[ i * 3 + 0 ] = (u8)(( ( color & 0x7C00 ) >> 10 ) << 3);
-        pPixels[ i * 3 + 1 ] = (u8)(( ( color & 0x03E0 ) >>  5 ) << 3);
-        pPixels[ i * 3 + 2 ] = (u8)(( ( color & 0x001F ) >>  0 ) << 3);
-    }
-}
+typedef void (*ConvertPixelFunc)( const u8* pSrc, const u32* pColorMap, u8* pDst, u32 count );
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      24Bitフルカラー形式を解析します.
+//! @brief      8Bitインデックスカラーを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse24Bits( FILE* pFile, u32 size, u8* pPixels )
-{
-    for( u32 i=0; i<size; ++i )
-    {
-        pPixels[ i * 4 + 2 ] = (u8)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (u8)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (u8)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = 255;
-    }
-}
+void Convert8Bits( const u8* pSrc, const u32* pColorMap, u8* pDst, u32 count )
+{ asdx::ExpandPaletteRGB( pSrc, pColorMap, pDst, count ); }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      32Bitフルカラー形式を解析します.
+//! @brief      16Bitフルカラーを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse32Bits( FILE* pFile, u32 size, u8* pPixels )
+void Convert16Bits( const u8* pSrc, const u32*, u8* pDst, u32 count )
 {
-    for( u32 i=0; i<size; ++i )
+    for( u32 i=0; i<count; ++i, pSrc+=2, pDst+=3 )
     {
-        pPixels[ i * 4 + 2 ] = (u8)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (u8)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (u8)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = (u8)fgetc( pFile );
+        u16 color = pSrc[ 0 ] | ( pSrc[ 1 ] << 8 );
+        pDst[ 0 ] = (u8)(( ( color & 0x7C00 ) >> 10 ) << 3);
+        pDst[ 1 ] = (u8)(( ( color & 0x03E0 ) >>  5 ) << 3);
+        pDst[ 2 ] = (u8)(( ( color & 0x001F ) >>  0 ) << 3);
     }
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief     8Bitグレースケール形式を解析します.
+//! @brief      24Bitフルカラーを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse8BitsGrayScale( FILE* pFile, u32 size, u8* pPixels )
-{
-    for( u32 i=0; i<size; ++i )
-    {
-        pPixels[ i ] = (u8)fgetc( pFile );
-    }
-}
+void Convert24Bits( const u8* pSrc, const u32*, u8* pDst, u32 count )
+{ asdx::SwizzleBGRToRGB( pSrc, pDst, count ); }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      16Bitグレースケール形式を解析します.
+//! @brief      32Bitフルカラーを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse16BitsGrayScale( FILE* pFile, u32 size, u8* pPixels )
-{
-    for( u32 i=0; i<size; ++i )
-    {
-        pPixels[ i * 2 + 0 ] = (u8)fgetc( pFile );
-        pPixels[ i * 2 + 1 ] = (u8)fgetc( pFile );
-    }
-}
+void Convert32Bits( const u8* pSrc, const u32*, u8* pDst, u32 count )
+{ asdx::SwizzleBGRAToRGBA( pSrc, pDst, count ); }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮インデックスカラー形式を解析します.
-//!
-//! @param[in]  pColorMap       カラーマップです.
+//! @brief      8Bitグレースケールを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse8BitsRLE( FILE* pFile, u8* pColorMap, u32 size, u8* pPixels )
-{
-    u32 count  = 0;
-    u8  color  = 0;
-    u8  header = 0;
-    u8* ptr    = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (u8)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            color = (u8)fgetc( pFile );
-
-            for( u32 i=0; i<count; ++i, ptr+=3 )
-            {
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-            }
-        }
-        else
-        {
-            for( u32 i=0; i<count; ++i, ptr+=3 )
-            {
-                color = (u8)fgetc( pFile );
-
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-            }
-        }
-    }
-}
+void Convert8BitsGrayScale( const u8* pSrc, const u32*, u8* pDst, u32 count )
+{ memcpy( pDst, pSrc, count ); }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮フルカラー形式を解析します.
+//! @brief      16Bitグレースケールを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse16BitsRLE( FILE* pFile, u32 size, u8* pPixels )
-{
-    u32 count  = 0;
-    u16 color  = 0;
-    u8  header = 0;
-    u8* ptr    = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (u8)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            color = fgetc( pFile ) + ( fgetc( pFile ) << 8 ); 
-
-            for( u32 i=0; i<count; ++i, ptr+=3 )
-            {
-                ptr[ 0 ] = (u8)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (u8)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (u8)(( ( color & 0x001F ) >>  0 ) << 3);
-            }
-        }
-        else
-        {
-            for( u32 i=0; i<count; ++i, ptr+=3 )
-            {
-                color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
-
-                ptr[ 0 ] = (u8)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (u8)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (u8)(( ( color & 0x001F ) >>  0 ) << 3);
-            }
-        }
-    }
-}
+void Convert16BitsGrayScale( const u8* pSrc, const u32*, u8* pDst, u32 count )
+{ memcpy( pDst, pSrc, count * 2 ); }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      24BitRLE圧縮フルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse24BitsRLE( FILE* pFile, u32 size, u8* pPixels )
+//! @brief      非圧縮ピクセルデータを解析します.
+//!
+//! @param[in,out]  pSrc        読み込み位置です. 解析後は消費したバイト数だけ進みます.
+//! @param[in]      pEnd        読み込み可能な終端です.
+//! @param[in]      count       ピクセル数です.
+//! @param[in]      pColorMap   RGB形式に展開済みのカラーマップです.
+//! @param[out]     pDst        出力先です.
+//! @retval true    解析に成功.
+//! @retval false   データが不足しています.
+//-------------------------------------------------------------------------------------------------
+template<u32 SrcBytes, u32 DstBytes, ConvertPixelFunc Convert>
+bool ParseRaw( const u8*& pSrc, const u8* pEnd, u32 count, const u32* pColorMap, u8* pDst )
 {
-    u32 count    = 0;
-    u8  color[3] = { 0, 0, 0 };
-    u8  header   = 0;
-    u8* ptr      = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (u8)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+    if ( size_t( pEnd - pSrc ) < size_t( count ) * SrcBytes )
+    { return false; }
 
-        if ( header & 0x80 )
-        {
-            fread( color, sizeof(u8), 3, pFile );
+    Convert( pSrc, pColorMap, pDst, count );
+    pSrc += size_t( count ) * SrcBytes;
 
-            for( u32 i=0; i<count; ++i, ptr+=3 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-            }
-        }
-        else
-        {
-            for( u32 i=0; i<count; ++i, ptr+=3 )
-            {
-                ptr[ 2 ] = (u8)fgetc( pFile );
-                ptr[ 1 ] = (u8)fgetc( pFile );
-                ptr[ 0 ] = (u8)fgetc( pFile );
-            }
-        }
-    }
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      32BitRLE圧縮フルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse32BitsRLE( FILE* pFile, u32 size, u8* pPixels )
+//! @brief      RLE圧縮ピクセルデータを解析します.
+//!
+//! @param[in,out]  pSrc        読み込み位置です. 解析後は消費したバイト数だけ進みます.
+//! @param[in]      pEnd        読み込み可能な終端です.
+//! @param[in]      count       ピクセル数です.
+//! @param[in]      pColorMap   RGB形式に展開済みのカラーマップです.
+//! @param[out]     pDst        出力先です.
+//! @retval true    解析に成功.
+//! @retval false   データが不足しています.
+//-------------------------------------------------------------------------------------------------
+template<u32 SrcBytes, u32 DstBytes, ConvertPixelFunc Convert>
+bool ParseRLE( const u8*& pSrc, const u8* pEnd, u32 count, const u32* pColorMap, u8* pDst )
 {
-    u32 count    = 0;
-    u8  color[4] = { 0, 0, 0, 0 };
-    u8  header   = 0;
-    u8* ptr      = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 4.
+    u32 i = 0;
+    while( i < count )
     {
-        header = (u8)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+        if ( pSrc >= pEnd )
+        { return false; }
+
+        u8  header = *pSrc++;
+        u32 length = 1 + ( header & 0x7F );
+
+        // 壊れたデータで出力先を越えないようにする.
+        if ( length > count - i )
+        { length = count - i; }
 
         if ( header & 0x80 )
         {
-            fread( color, sizeof(u8), 4, pFile );
+            if ( size_t( pEnd - pSrc ) < SrcBytes )
+            { return false; }
 
-            for( u32 i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-                ptr[ 3 ] = color[ 3 ];
-            }
+            // 1ピクセルだけ変換してランを展開する.
+            u8 value[ DstBytes ];
+            Convert( pSrc, pColorMap, value, 1 );
+            asdx::FillPixels( pDst, value, DstBytes, length );
+
+            pSrc += SrcBytes;
         }
         else
         {
-            for( u32 i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 2 ] = (u8)fgetc( pFile );
-                ptr[ 1 ] = (u8)fgetc( pFile );
-                ptr[ 0 ] = (u8)fgetc( pFile );
-                ptr[ 3 ] = (u8)fgetc( pFile );
-            }
+            if ( size_t( pEnd - pSrc ) < size_t( length ) * SrcBytes )
+            { return false; }
+
+            Convert( pSrc, pColorMap, pDst, length );
+            pSrc += length * SrcBytes;
         }
+
+        pDst += length * DstBytes;
+        i    += length;
     }
+
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮グレースケール形式を解析します.
+//! @brief      カラーマップをRGB形式に展開します.
+//!
+//! @param[in]      header      ヘッダです.
+//! @param[in]      pSrc        カラーマップの先頭です.
+//! @param[out]     pColorMap   展開先(TGA_MAX_COLORMAP_ENTRY エントリー)です.
+//! @retval true    展開に成功.
+//! @retval false   未対応のエントリーサイズです.
 //-------------------------------------------------------------------------------------------------
-void Parse8BitsGrayScaleRLE( FILE* pFile, u32 size, u8* pPixles )
+bool ExpandColorMap( const asdx::TGA_HEADER& header, const u8* pSrc, u32* pColorMap )
 {
-    u32 count  = 0;
-    u8  color  = 0;
-    u8  header = 0;
-    u8* ptr    = pPixles;
-
-    while( ptr < pPixles + size ) // size = width * height
+    auto stride = u32( ( header.ColorMapEntrySize + 7 ) >> 3 );
+    ConvertPixelFunc convert = nullptr;
+    switch( header.ColorMapEntrySize )
     {
-        header = (u8)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            color = (u8)fgetc( pFile );
-
-            for( u32 i=0; i<count; ++i, ptr++ )
-            { (*ptr) = color; }
-        }
-        else
-        {
-            for( u32 i=0; i<count; ++i, ptr++ )
-            { (*ptr) = (u8)fgetc( pFile ); }
-        }
+    case 15:
+    case 16: { convert = Convert16Bits; } break;
+    case 24:
+    case 32: { convert = Convert24Bits; } break;
+    default: { return false; }
     }
-}
 
-//-------------------------------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮グレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16BitsGrayScaleRLE( FILE* pFile, u32 size, u8* pPixles )
-{
-    u32 count  = 0;
-    u8  color  = 0;
-    u8  alpha  = 0;
-    u8  header = 0;
-    u8* ptr    = pPixles;
+    auto first = u32( header.ColorMapEntry );
+    if ( first >= TGA_MAX_COLORMAP_ENTRY )
+    { return true; }
 
-    while( ptr < pPixles + size ) // size = width * height * 2
-    {
-        header = (u8)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+    auto count = u32( header.ColorMapLength );
+    if ( count > TGA_MAX_COLORMAP_ENTRY - first )
+    { count = TGA_MAX_COLORMAP_ENTRY - first; }
 
-        if ( header & 0x80 )
-        {
-            color = (u8)fgetc( pFile );
-            alpha = (u8)fgetc( pFile );
+    // 1エントリー4byteのテーブルにRGBを格納する(アルファは使用しない).
+    for( u32 i=0; i<count; ++i )
+    { convert( pSrc + i * stride, nullptr, reinterpret_cast<u8*>( pColorMap + first + i ), 1 ); }
 
-            for( u32 i=0; i<count; ++i, ptr+=2 )
-            {
-                ptr[ 0 ] = color;
-                ptr[ 1 ] = alpha;
-            }
-        }
-        else
-        {
-            for( u32 i=0; i<count; ++i, ptr+=2 )
-            {
-                ptr[ 0 ] = (u8)fgetc( pFile );
-                ptr[ 1 ] = (u8)fgetc( pFile );
-            }
-        }
-    }
+    return true;
 }
 
-
 } // namespace /* anonymous */
 
 namespace asdx {
@@ -393,42 +259,89 @@ bool ResTGA::Load( const char16* filename )
         return false;
     }
 
-    // フッターを読み込み.
-    TGA_FOOTER footer;
-    long offset = sizeof(footer);
-    fseek( pFile, -offset, SEEK_END );
-    fread( &footer, sizeof(footer), 1, pFile );
+    // ファイルサイズを取得.
+    fseek( pFile, 0, SEEK_END );
+    auto fileSize = ftell( pFile );
+    fseek( pFile, 0, SEEK_SET );
 
-    // ファイルマジックをチェック.
-    if ( strcmp( footer.Tag, "TRUEVISION-XFILE." ) != 0 &&
-         strcmp( footer.Tag, "TRUEVISION-TARGA." ) != 0 )
+    if ( fileSize <= 0 )
     {
-        ELOG( "Error : Invalid File Format." );
+        ELOG( "Error : Invalid File Size. Filename = %s", filename );
+        fclose( pFile );
+        return false;
+    }
+
+    // 1ピクセルずつ読むと遅いので，ファイル全体をがばっと読み込む.
+    auto pBuffer = new (std::nothrow) u8 [ fileSize ];
+    if ( pBuffer == nullptr )
+    {
+        ELOG( "Error : Out Of Memory." );
         fclose( pFile );
         return false;
     }
 
-    // 拡張データがある場合は読み込み.
-    if ( footer.OffsetExt != 0 )
+    auto readSize = fread( pBuffer, sizeof(u8), fileSize, pFile );
+
+    // ファイルを閉じる.
+    fclose( pFile );
+
+    if ( readSize != size_t( fileSize ) )
     {
-        TGA_EXTENSION extension;
+        ELOG( "Error : File Read Failed. Filename = %s", filename );
+        ASDX_DELETE_ARRAY( pBuffer );
+        return false;
+    }
+
+    auto ret = LoadFromMemory( pBuffer, u32( fileSize ) );
+
+    // 不要なメモリを解放.
+    ASDX_DELETE_ARRAY( pBuffer );
+
+    if ( !ret )
+    { return false; }
+
+    // ハッシュキーはファイル名から作成する.
+    m_HashKey = CRC32( filename ).GetHash();
 
-        fseek( pFile, footer.OffsetExt, SEEK_SET );
-        fread( &extension, sizeof(extension), 1, pFile );
+    // 正常終了.
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリから読み込みします.
+//-------------------------------------------------------------------------------------------------
+bool ResTGA::LoadFromMemory( const u8* pBuffer, const u32 bufferSize )
+{
+    // 引数チェック.
+    if ( pBuffer == nullptr || bufferSize < sizeof(TGA_HEADER) + sizeof(TGA_FOOTER) )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
     }
 
-    // ディベロッパーエリアがある場合.
-    if ( footer.OffsetDev != 0 )
+    // 既存のデータは破棄しておく.
+    Release();
+
+    const u8* pEnd = pBuffer + bufferSize;
+
+    // フッターを読み込み.
+    TGA_FOOTER footer;
+    memcpy( &footer, pEnd - sizeof(footer), sizeof(footer) );
+
+    // ファイルマジックをチェック.
+    if ( memcmp( footer.Tag, "TRUEVISION-XFILE.", sizeof(footer.Tag) ) != 0 &&
+         memcmp( footer.Tag, "TRUEVISION-TARGA.", sizeof(footer.Tag) ) != 0 )
     {
-        /* NOT IMPLEMENT */
+        ELOG( "Error : Invalid File Format." );
+        return false;
     }
 
-    // ファイル先頭に戻す.
-    fseek( pFile, 0, SEEK_SET );
+    // 拡張データ・ディベロッパーエリアは使用しない.
+    /* NOT IMPLEMENT */
 
     // ヘッダデータを読み込む.
     TGA_HEADER header;
-    fread( &header, sizeof(header), 1, pFile );
+    memcpy( &header, pBuffer, sizeof(header) );
 
     // フォーマット判定.
     u32 bytePerPixel;
@@ -438,7 +351,6 @@ bool ResTGA::Load( const char16* filename )
     case TGA_FORMAT_NONE:
         {
             ELOG( "Error : Invalid Format." );
-            fclose( pFile );
             return false;
         }
         break;
@@ -446,7 +358,7 @@ bool ResTGA::Load( const char16* filename )
     // グレースケール
     case TGA_FORMAT_GRAYSCALE:
     case TGA_FORMAT_RLE_GRAYSCALE:
-        { 
+        {
             if ( header.BitPerPixel == 8 )
             { bytePerPixel = 1; }
             else
@@ -471,59 +383,56 @@ bool ResTGA::Load( const char16* filename )
     default:
         {
             ELOG( "Error : Unsupported Format." );
-            fclose( pFile );
             return false;
         }
         break;
     }
 
-    // IDフィールドサイズ分だけオフセットを移動させる.
-    fseek( pFile, header.IdFieldLength, SEEK_CUR );
+    // フッター手前までを読み込み範囲とする.
+    pEnd -= sizeof(footer);
 
-    // ピクセルサイズを決定してメモリを確保.
-    auto size = header.Width * header.Height * bytePerPixel;
-    m_pPixels = new (std::nothrow) u8 [ size ];
-    if ( m_pPixels == nullptr )
-    {
-        ELOG( "Error : Out Of Memory." );
-        fclose( pFile );
-        return false;
-    }
+    // IDフィールドサイズ分だけオフセットを移動させる.
+    const u8* pSrc = pBuffer + sizeof(header) + header.IdFieldLength;
 
     // カラーマップを持つかチェック.
-    u8* pColorMap = nullptr;
+    u32 colorMap[ TGA_MAX_COLORMAP_ENTRY ] = {};
     if ( header.HasColorMap )
     {
         // カラーマップサイズを算出.
-        u32 colorMapSize = header.ColorMapEntry * ( header.ColorMapEntrySize >> 3 );
+        size_t colorMapSize = header.ColorMapLength * ( ( header.ColorMapEntrySize + 7 ) >> 3 );
+        if ( pSrc > pEnd || size_t( pEnd - pSrc ) < colorMapSize )
+        {
+            ELOG( "Error : Invalid File Format." );
+            return false;
+        }
 
-        // メモリを確保.
-        pColorMap = new (std::nothrow) u8 [ colorMapSize ];
-        if ( pColorMap == nullptr )
+        // RGB形式に展開しておく.
+        if ( !ExpandColorMap( header, pSrc, colorMap ) )
         {
-            ELOG( "Error : Out Of Memory." );
-            ASDX_DELETE_ARRAY( m_pPixels );
-            fclose( pFile );
+            ELOG( "Error : Unsupported ColorMap Entry Size. size = %u", header.ColorMapEntrySize );
             return false;
         }
 
-        // がばっと読み込む.
-        fread( pColorMap, sizeof(u8), colorMapSize, pFile );
+        pSrc += colorMapSize;
     }
 
-    // 幅・高さ・ビットの深さ・ハッシュキーを設定.
-    m_Width       = header.Width;
-    m_Height      = header.Height;
-    m_BitPerPixel = bytePerPixel * 8;
-    m_Format      = static_cast<TGA_FORMAT_TYPE>( header.Format );
-    m_HashKey     = CRC32( filename ).GetHash();
+    if ( pSrc > pEnd )
+    {
+        ELOG( "Error : Invalid File Format." );
+        return false;
+    }
 
-    // フォーマットに合わせてピクセルデータを解析する.
+    // フォーマットに合わせて解析関数を決定する.
+    typedef bool (*ParseFunc)( const u8*&, const u8*, u32, const u32*, u8* );
+    ParseFunc parse = nullptr;
     switch( header.Format )
     {
     // パレット.
     case TGA_FORMAT_INDEXCOLOR:
-        { Parse8Bits( pFile, m_Width * m_Height, pColorMap, m_pPixels ); }
+        {
+            if ( header.BitPerPixel == 8 )
+            { parse = ParseRaw<1, 3, Convert8Bits>; }
+        }
         break;
 
     // フルカラー.
@@ -531,17 +440,9 @@ bool ResTGA::Load( const char16* filename )
         {
             switch( header.BitPerPixel )
             {
-            case 16:
-                { Parse16Bits( pFile, m_Width * m_Height, m_pPixels ); }
-                break;
-
-            case 24:
-                { Parse24Bits( pFile, m_Width * m_Height, m_pPixels ); }
-                break;
-
-            case 32:
-                { Parse32Bits( pFile, m_Width * m_Height, m_pPixels ); }
-                break;
+            case 16: { parse = ParseRaw<2, 3, Convert16Bits>; } break;
+            case 24: { parse = ParseRaw<3, 3, Convert24Bits>; } break;
+            case 32: { parse = ParseRaw<4, 4, Convert32Bits>; } break;
             }
         }
         break;
@@ -549,16 +450,20 @@ bool ResTGA::Load( const char16* filename )
     // グレースケール.
     case TGA_FORMAT_GRAYSCALE:
         {
-            if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScale( pFile, m_Width * m_Height, m_pPixels ); }
-            else
-            { Parse16BitsGrayScale( pFile, m_Width * m_Height, m_pPixels ); }
+            switch( header.BitPerPixel )
+            {
+            case 8:  { parse = ParseRaw<1, 1, Convert8BitsGrayScale>;  } break;
+            case 16: { parse = ParseRaw<2, 2, Convert16BitsGrayScale>; } break;
+            }
         }
         break;
 
     // パレットRLE圧縮.
     case TGA_FORMAT_RLE_INDEXCOLOR:
-        { Parse8BitsRLE( pFile, pColorMap, m_Width * m_Height * 3, m_pPixels ); }
+        {
+            if ( header.BitPerPixel == 8 )
+            { parse = ParseRLE<1, 3, Convert8Bits>; }
+        }
         break;
 
     // フルカラーRLE圧縮.
@@ -566,17 +471,9 @@ bool ResTGA::Load( const char16* filename )
         {
             switch( header.BitPerPixel )
             {
-            case 16:
-                { Parse16BitsRLE( pFile, m_Width * m_Height * 3, m_pPixels ); }
-                break;
-
-            case 24:
-                { Parse24BitsRLE( pFile, m_Width * m_Height * 3, m_pPixels ); }
-                break;
-
-            case 32:
-                { Parse32BitsRLE( pFile, m_Width * m_Height * 4, m_pPixels ); }
-                break;
+            case 16: { parse = ParseRLE<2, 3, Convert16Bits>; } break;
+            case 24: { parse = ParseRLE<3, 3, Convert24Bits>; } break;
+            case 32: { parse = ParseRLE<4, 4, Convert32Bits>; } break;
             }
         }
         break;
@@ -584,19 +481,44 @@ bool ResTGA::Load( const char16* filename )
     // グレースケールRLE圧縮.
     case TGA_FORMAT_RLE_GRAYSCALE:
         {
-            if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScaleRLE( pFile, m_Width * m_Height, m_pPixels ); }
-            else
-            { Parse16BitsGrayScaleRLE( pFile, m_Width * m_Height * 2, m_pPixels ); }
+            switch( header.BitPerPixel )
+            {
+            case 8:  { parse = ParseRLE<1, 1, Convert8BitsGrayScale>;  } break;
+            case 16: { parse = ParseRLE<2, 2, Convert16BitsGrayScale>; } break;
+            }
         }
         break;
     }
 
-    // 不要なメモリを解放.
-    ASDX_DELETE_ARRAY( pColorMap );
+    if ( parse == nullptr )
+    {
+        ELOG( "Error : Unsupported Bit Per Pixel. bitPerPixel = %u", header.BitPerPixel );
+        return false;
+    }
 
-    // ファイルを閉じる.
-    fclose( pFile );
+    // ピクセルサイズを決定してメモリを確保.
+    auto count = u32( header.Width ) * u32( header.Height );
+    m_pPixels = new (std::nothrow) u8 [ count * bytePerPixel ];
+    if ( m_pPixels == nullptr )
+    {
+        ELOG( "Error : Out Of Memory." );
+        return false;
+    }
+
+    // ピクセルデータを解析する.
+    if ( !parse( pSrc, pEnd, count, colorMap, m_pPixels ) )
+    {
+        ELOG( "Error : Unexpected End Of Data." );
+        ASDX_DELETE_ARRAY( m_pPixels );
+        return false;
+    }
+
+    // 幅・高さ・ビットの深さ・ハッシュキーを設定.
+    m_Width       = header.Width;
+    m_Height      = header.Height;
+    m_BitPerPixel = u8( bytePerPixel * 8 );
+    m_Format      = static_cast<TGA_FORMAT_TYPE>( header.Format );
+    m_HashKey     = CRC32( bufferSize, pBuffer ).GetHash();
 
     // 正常終了.
     return true;